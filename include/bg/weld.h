@@ -0,0 +1,93 @@
+/*                          W E L D . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+
+/*----------------------------------------------------------------------*/
+/** @addtogroup bg_weld
+ *
+ * Batch welding of coincident vertices.
+ *
+ * Where bg_vert_tree merges vertices one at a time as they are read,
+ * these routines take every vertex of a mesh at once, bin them in a
+ * uniform grid hash and compare each only against the handful of cells
+ * that can hold a vertex within tolerance.  The result is the same no
+ * matter how the vertices fall on the grid.
+ */
+/** @{ */
+/** @file weld.h */
+
+#ifndef BG_WELD_H
+#define BG_WELD_H
+
+#include "common.h"
+
+#include "vmath.h"
+
+#include "bg/defines.h"
+
+__BEGIN_DECLS
+
+/**
+ *@brief
+ *	Weld the npnts points in pnts (packed x, y, z triples) that lie
+ *	within tol of one another.
+ *
+ *	Points are taken in order and each one joins the first earlier
+ *	point it lies within tol of that was kept, otherwise it is kept
+ *	itself.  A tol of zero or less only welds exact duplicates.
+ *
+ *	remap must hold npnts entries and is filled with the index of
+ *	each point's weld in the output.  When verts is non-NULL it is
+ *	set to a bu_malloc'd array of the kept points, in input order,
+ *	which the caller must bu_free.
+ *
+ *	Returns the number of points kept.
+ */
+BG_EXPORT extern size_t bg_weld_pnts(fastf_t **verts,
+				     size_t *remap,
+				     const fastf_t *pnts,
+				     size_t npnts,
+				     fastf_t tol);
+
+/**
+ *@brief
+ *	Remap the nfaces triangles in faces (three vertex indices each)
+ *	through remap, as filled in by bg_weld_pnts(), and drop the ones
+ *	the weld collapsed onto an edge or a point.
+ *
+ *	The surviving faces are packed to the front of faces in their
+ *	original order.  Returns how many there are.
+ */
+BG_EXPORT extern size_t bg_weld_faces(int *faces,
+				      size_t nfaces,
+				      const size_t *remap);
+
+__END_DECLS
+
+#endif  /* BG_WELD_H */
+/** @} */
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
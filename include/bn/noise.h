@@ -157,6 +157,46 @@ BN_EXPORT extern double bn_noise_ridged(point_t point,
 					double octaves,
 					double offset);
 
+/**
+ * @brief
+ * Batch versions of the noise functions above.
+ *
+ * Each evaluates the n points in pnts (packed x, y, z triples) and
+ * writes the n results to values.  The spectral weights are looked up
+ * once per call and the points are interpolated in blocks, but every
+ * result is bit for bit what the single point function returns for
+ * the same point and parameters.
+ */
+BN_EXPORT extern void bn_noise_perlin_n(double *values,
+					const fastf_t *pnts,
+					size_t n);
+BN_EXPORT extern void bn_noise_fbm_n(double *values,
+				     const fastf_t *pnts,
+				     size_t n,
+				     double h_val,
+				     double lacunarity,
+				     double octaves);
+BN_EXPORT extern void bn_noise_turb_n(double *values,
+				      const fastf_t *pnts,
+				      size_t n,
+				      double h_val,
+				      double lacunarity,
+				      double octaves);
+BN_EXPORT extern void bn_noise_mf_n(double *values,
+				    const fastf_t *pnts,
+				    size_t n,
+				    double h_val,
+				    double lacunarity,
+				    double octaves,
+				    double offset);
+BN_EXPORT extern void bn_noise_ridged_n(double *values,
+					const fastf_t *pnts,
+					size_t n,
+					double h_val,
+					double lacunarity,
+					double octaves,
+					double offset);
+
 __END_DECLS
 
 #endif  /* BN_NOISE_H */
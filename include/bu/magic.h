@@ -206,6 +206,7 @@ __BEGIN_DECLS
 #define FB_STK_MAGIC			0x53544642 /**< STFB */
 #define FB_MEMORY_MAGIC			0x4d454642 /**< MEFB */
 #define FB_REMOTE_MAGIC			0x524d4642 /**< MEFB */
+#define FB_SHM_MAGIC			0x53484642 /**< SHFB */
 #define FB_NULL_MAGIC			0x4e554642 /**< NUFB */
 #define FB_SWFB_MAGIC			0x51474642 /**< SWFB */
 
@@ -234,6 +235,7 @@ __BEGIN_DECLS
 #define WDB_PIPESEG_MAGIC		0x9723ffef /**< ?\#?? */
 #define WMEMBER_MAGIC			0x43128912 /**< C??? */
 #define ICV_IMAGE_MAGIC			0x6269666d /**< bifm */
+#define ICV_STREAM_MAGIC		0x69637673 /**< icvs */
 
 /** @brief Routines involved with handling "magic numbers" used to identify various in-memory data structures. */
 
@@ -229,6 +229,7 @@ struct bv_scene_obj  {
     int s_dlist_mode;		/**< @brief  drawing mode in which display list was generated (if it doesn't match s_os.s_dmode, dlist is out of date.) */
     int s_dlist_stale;		/**< @brief  set by client codes when dlist is out of date - dm must update. */
     void (*s_dlist_free_callback)(struct bv_scene_obj *);  /**< @brief free any dlist specific data */
+    void *s_dlist_data;		/**< @brief  dm specific retained drawing data (e.g. packed vertex arrays), freed by s_dlist_free_callback */
 
     /* 3D geometry metadata */
     fastf_t s_size;		/**< @brief  Distance across solid, in model space */
@@ -496,6 +497,10 @@ struct bview_objs {
 
     /* Container for reusing bv_scene_obj allocations */
     struct bv_scene_obj *free_scene_obj;
+
+    /* Bounding volume hierarchy over the db objects, maintained by libbv
+     * for selection and culling */
+    void *bvh;
 };
 
 // Data for managing "knob" manipulation of views.  One historical hardware
@@ -60,6 +60,20 @@ bv_view_objs_select(struct bu_ptbl *sset, struct bview *v, int x, int y);
 BV_EXPORT int
 bv_view_objs_rect_select(struct bu_ptbl *sset, struct bview *v, int x1, int y1, int x2, int y2);
 
+/* Classify the scene objects of an orthographic view as inside or outside the
+ * volume projected by its window, so drawing can skip the ones that cannot
+ * appear.  Objects whose display depends on the view (adaptive plotting) or
+ * whose vlist holds display coordinates are never classified as outside.
+ * Returns the number of objects outside the view - perspective views are not
+ * culled and always return 0. */
+BV_EXPORT extern size_t
+bv_view_cull(struct bview *v);
+
+/* Returns 1 if the last bv_view_cull call on v found s to be outside the
+ * view, 0 otherwise. */
+BV_EXPORT extern int
+bv_view_obj_culled(struct bview *v, struct bv_scene_obj *s);
+
 /* Storing and reading from a lot of small, individual files doesn't work very
  * well on some platforms.  We provide a "context" to manage bookkeeping of data
  * across objects. The details are implementation internal - the application
@@ -450,6 +450,23 @@ DM_EXPORT extern int fb_is_set_fd(struct fb *ifp, fd_set *infds);
 DM_EXPORT extern int fb_set_fd(struct fb *ifp, fd_set *select_list);
 DM_EXPORT extern int fb_clear_fd(struct fb *ifp, fd_set *select_list);
 
+/* Consumer side of the /dev/shmem shared memory tile framebuffer.  A
+ * process writing with fb_write() to "/dev/shmemN" publishes dirty
+ * tiles that another process on the same host can take in place. */
+struct fb_shm_tiles;
+/* Attach to unit N of an open /dev/shmem framebuffer, NULL if none */
+DM_EXPORT extern struct fb_shm_tiles *fb_shm_attach(int unit);
+DM_EXPORT extern void fb_shm_detach(struct fb_shm_tiles *st);
+DM_EXPORT extern void fb_shm_getsize(const struct fb_shm_tiles *st, int *width, int *height);
+/* Claim the next dirty tile.  On return of 1, pixels points at the
+ * w*h RGB tile, bottom-to-top, whose lower left is at x,y.  Returns 0
+ * when nothing is dirty, -1 when the writer has closed and nothing is
+ * left. */
+DM_EXPORT extern int fb_shm_next_tile(struct fb_shm_tiles *st, int *x, int *y, int *w, int *h, const unsigned char **pixels);
+/* Write all dirty tiles to dest.  Returns the number of tiles written,
+ * or -1 when the writer has closed and nothing was left. */
+DM_EXPORT extern int fb_shm_drain(struct fb_shm_tiles *st, struct fb *dest);
+
 /* color mapping */
 DM_EXPORT extern int fb_is_linear_cmap(const ColorMap *cmap);
 DM_EXPORT extern void fb_make_linear_cmap(ColorMap *cmap);
@@ -199,6 +199,16 @@ ICV_EXPORT extern int icv_rot(size_t argc, const char *argv[]);
  */
 ICV_EXPORT extern int icv_diff(int *matching, int *off_by_1, int *off_by_many, icv_image_t *img1, icv_image_t *img2);
 
+/**
+ * The filter, resize, conversion and diff routines have vectorized
+ * inner loops that are used when bu_simd_level() reports SSE2 or
+ * better, and which give bitwise-identical results to the scalar
+ * loops.  Pass a BU_SIMD_* level to force a particular set of loops
+ * (BU_SIMD_NONE for scalar, e.g. for benchmarking), or -1 to return
+ * to autodetection.  Returns the level now in use.
+ */
+ICV_EXPORT extern int icv_simd_level(int level);
+
 /**
  * Generate a visual representation of the differences between two images.
  * (At least for now, images must be the same size.)
@@ -0,0 +1,168 @@
+/*                        S T R E A M . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup icv_stream
+ *
+ * @brief
+ * Out-of-core, band-at-a-time image processing.
+ *
+ * The routines in icv/io.h and icv/ops.h hold the whole image in
+ * memory as doubles, which for very large renders is prohibitive
+ * (a 16k x 16k RGB image needs about 6GB).  An icv_stream_t instead
+ * describes a pipeline: a source file, followed by zero or more
+ * filter, resize and arithmetic stages.  Nothing is read until
+ * icv_stream_write() is called, at which point the output is
+ * produced in horizontal bands of rows.  Each stage only keeps the
+ * window of input rows it needs to produce the current band, the
+ * rows of a band are computed in parallel, and finished bands are
+ * written to the output file as they complete.  Memory use is thus
+ * bounded by the band size rather than the image size.
+ *
+ * Rows are numbered bottom-up, as in icv_image_t.  Sources and
+ * sinks whose files are stored top-down (PNG) are spooled through an
+ * 8-bit temporary file rather than memory.
+ *
+ * Example - low pass filter and halve a large pix file:
+ * @code
+ * icv_stream_t *s = icv_stream_open("big.pix", BU_MIME_IMAGE_PIX, 16384, 16384);
+ * icv_stream_filter(s, ICV_FILTER_LOW_PASS);
+ * icv_stream_resize(s, ICV_RESIZE_SHRINK, 0, 0, 2);
+ * icv_stream_write(s, "small.png", BU_MIME_IMAGE_PNG, 0, 0);
+ * icv_stream_close(s);
+ * @endcode
+ */
+
+#ifndef ICV_STREAM_H
+#define ICV_STREAM_H
+
+#include "common.h"
+#include <stddef.h> /* for size_t */
+#include "bu/mime.h"
+#include "icv/defines.h"
+#include "icv/filters.h"
+#include "icv/ops.h"
+
+__BEGIN_DECLS
+
+/** @{ */
+/** @file icv/stream.h */
+
+typedef struct icv_stream icv_stream_t;
+
+typedef enum {
+    ICV_STREAM_OP_ADD,
+    ICV_STREAM_OP_SUB,
+    ICV_STREAM_OP_MULTIPLY,
+    ICV_STREAM_OP_DIVIDE,
+    ICV_STREAM_OP_POW
+} ICV_STREAM_OP;
+
+/**
+ * Open an image file as the source of a streaming pipeline.  Only
+ * the header (if any) is examined; pixel data is read lazily while
+ * the pipeline is written.
+ *
+ * Supported formats are BU_MIME_IMAGE_PIX, BU_MIME_IMAGE_BW and
+ * BU_MIME_IMAGE_PNG.  BU_MIME_IMAGE_AUTO guesses from the file name
+ * the same way icv_read() does.  For pix and bw files a width and
+ * height must be given, or be deducible from the file size with
+ * icv_image_size().  Pass a NULL filename to stream from stdin (pix
+ * and bw only).
+ *
+ * @return the new stream, or NULL on failure.
+ */
+ICV_EXPORT extern icv_stream_t *icv_stream_open(const char *filename, bu_mime_image_t format, size_t width, size_t height);
+
+/**
+ * Report the dimensions the stream's output will have with the
+ * stages added so far.
+ */
+ICV_EXPORT extern size_t icv_stream_width(const icv_stream_t *s);
+ICV_EXPORT extern size_t icv_stream_height(const icv_stream_t *s);
+ICV_EXPORT extern size_t icv_stream_channels(const icv_stream_t *s);
+
+/**
+ * Append a 3x3 convolution stage using the same kernels as
+ * icv_filter().  Pixels outside the image are treated as zero, and
+ * the edge columns are filtered like all others.
+ *
+ * @return 0 on success and -1 on failure.
+ */
+ICV_EXPORT extern int icv_stream_filter(icv_stream_t *s, ICV_FILTER filter_type);
+
+/**
+ * Append a resize stage.  Arguments and results are the same as for
+ * icv_resize().
+ *
+ * @return 0 on success and -1 on failure.
+ */
+ICV_EXPORT extern int icv_stream_resize(icv_stream_t *s, ICV_RESIZE_METHOD method, size_t out_width, size_t out_height, size_t factor);
+
+/**
+ * Append a stage applying a constant to every pixel, analogous to
+ * icv_add_val(), icv_multiply_val(), icv_divide_val() and
+ * icv_pow_val().  ICV_STREAM_OP_SUB subtracts the value.  The result
+ * is sanitized to [0, 1].
+ *
+ * @return 0 on success and -1 on failure.
+ */
+ICV_EXPORT extern int icv_stream_val(icv_stream_t *s, ICV_STREAM_OP op, double val);
+
+/**
+ * Append a stage combining the stream pixel-wise with a second
+ * stream of the same dimensions and channel count, analogous to
+ * icv_add(), icv_sub(), icv_multiply() and icv_divide().  The result
+ * is sanitized to [0, 1].  On success, 'other' becomes part of 's'
+ * and must not be written or closed separately.
+ *
+ * @return 0 on success and -1 on failure.
+ */
+ICV_EXPORT extern int icv_stream_combine(icv_stream_t *s, icv_stream_t *other, ICV_STREAM_OP op);
+
+/**
+ * Run the pipeline, writing the result to filename (stdout if NULL)
+ * in the given format (pix, bw or png; BU_MIME_IMAGE_AUTO guesses
+ * from the name).  A stream can be written only once.
+ *
+ * @param band_rows Output rows produced per band, 0 for a default.
+ * @param ncpu Number of threads to use, 0 for all available.
+ * @return 0 on success and -1 on failure.
+ */
+ICV_EXPORT extern int icv_stream_write(icv_stream_t *s, const char *filename, bu_mime_image_t format, size_t band_rows, size_t ncpu);
+
+/**
+ * Release the stream, any streams combined into it, and their files.
+ */
+ICV_EXPORT extern int icv_stream_close(icv_stream_t *s);
+
+/** @} */
+
+__END_DECLS
+
+#endif /* ICV_STREAM_H */
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -79,6 +79,14 @@ struct light_specific {
 /* defined in sh_light.c */
 OPTICAL_EXPORT extern struct light_specific	LightHead;
 
+/**
+ * How many lights light_obs() draws at each shading point, weighted
+ * by how much each can light it, with one shadow ray per draw.  Zero
+ * tests every light, or draws SW_NLIGHTS of them when there are more
+ * than that.  Fewer samples are faster and noisier.
+ */
+OPTICAL_EXPORT extern int light_samples;
+
 OPTICAL_EXPORT extern void light_cleanup(void);
 OPTICAL_EXPORT extern void light_maker(int num, mat_t v2m);
 OPTICAL_EXPORT extern int light_init(struct application *ap);
@@ -206,6 +206,11 @@ db_diff3_dp(const struct db_i *left,
  * but is unchanged, unch_func() is called.  NULL may be
  * passed to skip any callback.
  *
+ * Objects are compared in parallel.  Objects that serialize to the
+ * same bytes in both databases are only imported once and reported
+ * unchanged without comparing their parameters.  Results are added
+ * to diff_results in the same order regardless of threading.
+ *
  * Returns an int with bit flags set according to the above
  * four diff categories.
  *
@@ -224,7 +229,9 @@ db_diff(const struct db_i *dbip_left,
  *
  * This does a "3-way" diff to identify changes in the left and
  * right databases relative to the ancestor database, and provides
- * functional hooks for the various cases.
+ * functional hooks for the various cases.  As with db_diff(),
+ * objects are compared in parallel and identical serialized objects
+ * are only imported once.
  *
  * Returns an int with bit flags set according to the above
  * diff3 categories.
@@ -105,6 +105,11 @@ __BEGIN_DECLS
  * it will assume you wanted a tops list, which has a good chance of returning
  * unwanted results.
  *
+ * The paths below the starting objects are listed and filtered in
+ * parallel, but the results come back in the order a serial search
+ * would produce them.  Filters are run serially when the plan uses
+ * -exec.
+ *
  */
 RT_EXPORT extern int db_search(struct bu_ptbl *results,
 			       int flags,
@@ -37,7 +37,51 @@ __BEGIN_DECLS
 
 
 /* Routines for managing the mesh LoD cache */
+
+/**
+ * Make sure the LoD cache holds data for every BoT in the database,
+ * blocking until it does.  Generation is spread over background
+ * workers, and only objects whose content changed since they were
+ * cached are regenerated.
+ */
 RT_EXPORT extern void db_mesh_lod_init(struct db_i *dbip, int verbose);
+
+/**
+ * Start the same processing as db_mesh_lod_init() on background
+ * workers and return immediately.  Objects may be edited, renamed or
+ * removed while generation is running; an object modified after it was
+ * processed keeps its old LoD data until db_mesh_lod_update() is called
+ * for it.
+ */
+RT_EXPORT extern void db_mesh_lod_start(struct db_i *dbip, int verbose);
+
+/**
+ * Move the named object to the front of the background queue, e.g. because
+ * it is being drawn.  Returns 1 if the object was still waiting to be
+ * processed, else 0.
+ */
+RT_EXPORT extern int db_mesh_lod_prioritize(struct db_i *dbip, const char *name);
+
+/**
+ * Report how many BoTs have been processed out of how many.  Returns 1 while
+ * background generation is running, else 0.
+ */
+RT_EXPORT extern int db_mesh_lod_progress(struct db_i *dbip, int *completed, int *target);
+
+/* Block until background generation is finished */
+RT_EXPORT extern void db_mesh_lod_wait(struct db_i *dbip);
+
+/* Stop background generation, abandoning objects not yet processed */
+RT_EXPORT extern void db_mesh_lod_cancel(struct db_i *dbip);
+
+/**
+ * Use a context opened by the application for this database's file, rather
+ * than having librt open its own - an LMDB environment may only be open once
+ * per process.  The caller retains ownership of c.
+ */
+struct bv_mesh_lod_context;
+RT_EXPORT extern void db_mesh_lod_context_set(struct db_i *dbip, struct bv_mesh_lod_context *c);
+
 RT_EXPORT extern void db_mesh_lod_clear(struct db_i *dbip);
 RT_EXPORT extern int db_mesh_lod_update(struct db_i *dbip, const char *name);
 RT_EXPORT extern struct bv_mesh_lod *db_mesh_lod_get(struct db_i *dbip, const char *name);
@@ -0,0 +1,152 @@
+#!/bin/sh
+#                    A D A P T I V E . S H
+# BRL-CAD
+#
+# Copyright (c) 2025 United States Government as represented by
+# the U.S. Army Research Laboratory.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following
+# disclaimer in the documentation and/or other materials provided
+# with the distribution.
+#
+# 3. The name of the author may not be used to endorse or promote
+# products derived from this software without specific prior written
+# permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+# Ensure /bin/sh
+export PATH || (echo "This isn't sh."; sh $0 $*; kill $$)
+
+# source common library functionality, setting ARGS, NAME_OF_THIS,
+# PATH_TO_THIS, and THIS.
+. "$1/regress/library.sh"
+
+if test "x$LOGFILE" = "x" ; then
+    LOGFILE=`pwd`/adaptive.log
+    rm -f $LOGFILE
+fi
+log "=== TESTING rt adaptive hypersampling ==="
+
+RT="`ensearch rt`"
+if test ! -f "$RT" ; then
+    log "Unable to find rt, aborting"
+    exit 1
+fi
+A2G="`ensearch asc2g`"
+if test ! -f "$A2G" ; then
+    log "Unable to find asc2g, aborting"
+    exit 1
+fi
+PIXDIFF="`ensearch pixdiff`"
+if test ! -f "$PIXDIFF" ; then
+    log "Unable to find pixdiff, aborting"
+    exit 1
+fi
+
+# mostly flat faces, whose pixels settle after their first samples,
+# with a ball and shadows for edges that need every sample
+rm -f adaptive.asc
+cat > adaptive.asc <<EOF
+title {Untitled BRL-CAD Database}
+units mm
+put {sun} ell V {-200 -100 300} A {5 0 0} B {0 5 0} C {0 0 5}
+put {plate.s} arb8 V1 {-50 -50 -2} V2 {50 -50 -2} V3 {50 50 -2} V4 {-50 50 -2} V5 {-50 -50 0} V6 {50 -50 0} V7 {50 50 0} V8 {-50 50 0}
+put {box.s} arb8 V1 {-30 -30 0} V2 {-5 -30 0} V3 {-5 -5 0} V4 {-30 -5 0} V5 {-30 -30 25} V6 {-5 -30 25} V7 {-5 -5 25} V8 {-30 -5 25}
+put {ball.s} ell V {20 15 12} A {12 0 0} B {0 12 0} C {0 0 12}
+put {plate.r} comb region yes tree {l plate.s}
+attr set {plate.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1000} {oshader} {plastic {sp 0}} {rgb} {200/200/200}
+put {box.r} comb region yes tree {l box.s}
+attr set {box.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1001} {oshader} {plastic {sp 0}} {rgb} {200/80/60}
+put {ball.r} comb region yes tree {l ball.s}
+attr set {ball.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1002} {oshader} {plastic} {rgb} {60/80/200}
+put {sun.r} comb region yes tree {l sun}
+attr set {sun.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1003} {oshader} {light {i 1 v 0}} {rgb} {255/255/255}
+put {all.g} comb region no tree {u {u {l plate.r} {l box.r}} {u {l ball.r} {l sun.r}}}
+EOF
+
+run $A2G adaptive.asc adaptive.g
+
+HYPER=15
+PIXELS=16384
+
+render () {
+    rm -f $1
+    $RT -M -B -s128 -H$HYPER -c "set adaptive=$2" -o $1 adaptive.g 'all.g' >> $LOGFILE 2>&1 <<EOF
+viewsize 1.600000000000000e+02;
+eye_pt 1.000000000000000e+02 -1.200000000000000e+02 9.000000000000000e+01;
+lookat_pt 0.000000000000000e+00 0.000000000000000e+00 0.000000000000000e+00;
+start 0; clean;
+end;
+EOF
+}
+
+log rendering with every sample...
+render adaptive.ref.pix 0
+log rendering with adaptive sampling...
+render adaptive.pix 0.01
+
+FAILED=0
+
+# every pixel gets its first few samples and only some get the rest,
+# out of a budget of all of them
+SAMPLES=`grep "^Frame  0: .*samples of" $LOGFILE | awk '{print $3}'`
+BUDGET=`grep "^Frame  0: .*samples of" $LOGFILE | awk '{print $6}'`
+log "adaptive sampling shot $SAMPLES samples of $BUDGET"
+
+if test "x$SAMPLES" = "x" || test "x$BUDGET" = "x" ; then
+    log "no sample budget reported"
+    FAILED=`expr $FAILED + 1`
+elif test $BUDGET -ne `expr $PIXELS \* \( $HYPER + 1 \)` \
+    || test $SAMPLES -ge $BUDGET \
+    || test $SAMPLES -lt `expr $PIXELS \* 2` ; then
+    log "expected fewer than the $PIXELS x `expr $HYPER + 1` samples of plain -H$HYPER and at least 2 per pixel"
+    FAILED=`expr $FAILED + 1`
+fi
+
+# settled pixels are only off by a little from their full mean
+log "... running $PIXDIFF adaptive.pix adaptive.ref.pix > adaptive.diff.pix"
+rm -f adaptive.diff.pix
+$PIXDIFF adaptive.pix adaptive.ref.pix > adaptive.diff.pix 2>> $LOGFILE
+NUMBER_WRONG=`tail -n1 "$LOGFILE" | tr , '\012' | awk '/many/ {print $1}'`
+log "adaptive.pix $NUMBER_WRONG off by many"
+if test "x$NUMBER_WRONG" = "x" || test $NUMBER_WRONG -gt 500 ; then
+    FAILED=`expr $FAILED + 1`
+fi
+
+if test $FAILED -eq 0 ; then
+    log "-> adaptive.sh succeeded"
+else
+    log "-> adaptive.sh FAILED, see $LOGFILE"
+    cat "$LOGFILE"
+fi
+
+exit $FAILED
+
+# Local Variables:
+# mode: sh
+# tab-width: 8
+# sh-indentation: 4
+# sh-basic-offset: 4
+# indent-tabs-mode: t
+# End:
+# ex: shiftwidth=4 tabstop=8
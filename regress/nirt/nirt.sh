@@ -575,6 +575,44 @@ EOF
 run cmp nirt.ref nirt.out
 STATUS=$?
 
+# batch shoots in parallel with its own hit and overlap handlers, so
+# check its CSV against the same rays fired one at a time with s,
+# partition for partition, through geometry full of overlaps.
+log "*** Test 12 - batch against s ***"
+rm -f nirt_batch.rays nirt_batch.csv nirt_batch.s nirt_batch.out
+cat > nirt_batch.rays <<EOF
+-3000 0 0 1 0 0
+0 -3000 0 0 1 0
+0 0 -3000 0 0 1
+3000 100 50 -1 0 0
+0 3000 400 0 -1 0
+-3000 700 -200 1 0 0
+-3000 -3000 -3000 1 1 1
+3000 3000 3000 1 1 1
+EOF
+SHOTS=""
+while read x y z dx dy dz ; do
+    SHOTS="$SHOTS xyz $x $y $z; dir $dx $dy $dz; s;"
+done < nirt_batch.rays
+FMTS="fmt r \"\"; fmt h \"\"; fmt g \"\"; fmt m \"\"; fmt o \"\"; fmt f \"\";"
+FMTS="$FMTS fmt p \"%s,%d,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%d\\n\" reg_name reg_id x_in y_in z_in x_out y_out z_out d_in d_out los obliq_in obliq_out claimant_count;"
+$NIRT -s -H 0 -e "backout 0; $FMTS $SHOTS q" "$1/regress/nirt/ovlps.g" ovlps 2>> $LOGFILE | awk -F, 'NF == 14' > nirt_batch.s
+$NIRT -s -H 0 -e "backout 0; batch -o nirt_batch.csv nirt_batch.rays; q" "$1/regress/nirt/ovlps.g" ovlps >> $LOGFILE 2>&1
+if test -f nirt_batch.csv ; then
+    awk -F, '$1 != "ray" && $2 != 0 { s = $3; for (i = 4; i <= 16; i++) s = s "," $i; print s }' nirt_batch.csv > nirt_batch.out
+fi
+if test ! -s nirt_batch.s || test ! -s nirt_batch.out ; then
+    log "-> batch test FAILED, no partitions reported"
+    STATUS=1
+elif cmp nirt_batch.s nirt_batch.out >> $LOGFILE 2>&1 ; then
+    log "-> batch partitions match s"
+    rm -f nirt_batch.rays nirt_batch.csv nirt_batch.s nirt_batch.out
+else
+    log "-> batch test FAILED, batch and s partitions differ"
+    diff nirt_batch.s nirt_batch.out >> $LOGFILE 2>&1
+    STATUS=1
+fi
+
 if [ X$STATUS = X0 ] ; then
     log "-> nirt.sh succeeded"
 else
@@ -0,0 +1,160 @@
+#!/bin/sh
+#                   R E P R O J E C T . S H
+# BRL-CAD
+#
+# Copyright (c) 2025 United States Government as represented by
+# the U.S. Army Research Laboratory.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above
+# copyright notice, this list of conditions and the following
+# disclaimer in the documentation and/or other materials provided
+# with the distribution.
+#
+# 3. The name of the author may not be used to endorse or promote
+# products derived from this software without specific prior written
+# permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS
+# OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY
+# DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+# DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+# GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+# WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+# NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+# SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#
+
+# Ensure /bin/sh
+export PATH || (echo "This isn't sh."; sh $0 $*; kill $$)
+
+# source common library functionality, setting ARGS, NAME_OF_THIS,
+# PATH_TO_THIS, and THIS.
+. "$1/regress/library.sh"
+
+if test "x$LOGFILE" = "x" ; then
+    LOGFILE=`pwd`/reproject.log
+    rm -f $LOGFILE
+fi
+log "=== TESTING rt frame reprojection ==="
+
+RT="`ensearch rt`"
+if test ! -f "$RT" ; then
+    log "Unable to find rt, aborting"
+    exit 1
+fi
+A2G="`ensearch asc2g`"
+if test ! -f "$A2G" ; then
+    log "Unable to find asc2g, aborting"
+    exit 1
+fi
+PIXDIFF="`ensearch pixdiff`"
+if test ! -f "$PIXDIFF" ; then
+    log "Unable to find pixdiff, aborting"
+    exit 1
+fi
+
+# flat faces, no highlights and an infinite light, so a reused pixel
+# has the color a shot one would get from the new eye point
+rm -f reproject.asc
+cat > reproject.asc <<EOF
+title {Untitled BRL-CAD Database}
+units mm
+put {sun} ell V {-200 -100 300} A {5 0 0} B {0 5 0} C {0 0 5}
+put {plate.s} arb8 V1 {-50 -50 -2} V2 {50 -50 -2} V3 {50 50 -2} V4 {-50 50 -2} V5 {-50 -50 0} V6 {50 -50 0} V7 {50 50 0} V8 {-50 50 0}
+put {box1.s} arb8 V1 {-30 -30 0} V2 {-5 -30 0} V3 {-5 -5 0} V4 {-30 -5 0} V5 {-30 -30 25} V6 {-5 -30 25} V7 {-5 -5 25} V8 {-30 -5 25}
+put {box2.s} arb8 V1 {10 0 0} V2 {35 0 0} V3 {35 30 0} V4 {10 30 0} V5 {10 0 15} V6 {35 0 15} V7 {35 30 15} V8 {10 30 15}
+put {plate.r} comb region yes tree {l plate.s}
+attr set {plate.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1000} {oshader} {plastic {sp 0}} {rgb} {200/200/200}
+put {boxes.r} comb region yes tree {u {l box1.s} {l box2.s}}
+attr set {boxes.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1001} {oshader} {plastic {sp 0}} {rgb} {200/80/60}
+put {sun.r} comb region yes tree {l sun}
+attr set {sun.r} {region} {R} {los} {100} {material_id} {1} {region_id} {1002} {oshader} {light {i 1 v 0}} {rgb} {255/255/255}
+put {all.g} comb region no tree {u {u {l plate.r} {l boxes.r}} {l sun.r}}
+EOF
+
+run $A2G reproject.asc reproject.g
+
+# two frames, the second with the eye moved 1mm sideways and looking
+# the same way
+frames () {
+    rm -f $1 $1.1
+    $RT -M -B -s128 -c "set reproject=$2" -o $1 reproject.g 'all.g' >> $LOGFILE 2>&1 <<EOF
+viewsize 1.600000000000000e+02;
+eye_pt 1.000000000000000e+02 -1.200000000000000e+02 9.000000000000000e+01;
+lookat_pt 0.000000000000000e+00 0.000000000000000e+00 0.000000000000000e+00;
+start 0; clean;
+end;
+viewsize 1.600000000000000e+02;
+eye_pt 1.010000000000000e+02 -1.200000000000000e+02 9.000000000000000e+01;
+lookat_pt 1.000000000000000e+00 0.000000000000000e+00 0.000000000000000e+00;
+start 1; clean;
+end;
+EOF
+}
+
+log rendering frames shot in full...
+frames reproject.ref.pix 0
+log rendering frames with reprojection...
+frames reproject.pix 4
+
+FAILED=0
+PIXELS=16384
+
+# the first frame has nothing to reuse, the second most of it
+REUSED0=`grep "^Frame  0: .*reused from" $LOGFILE | awk '{print $3}'`
+SHOT0=`grep "^Frame  0: .*reused from" $LOGFILE | awk '{print $10}'`
+REUSED1=`grep "^Frame  1: .*reused from" $LOGFILE | awk '{print $3}'`
+SHOT1=`grep "^Frame  1: .*reused from" $LOGFILE | awk '{print $10}'`
+log "frame 0: $REUSED0 reused, $SHOT0 shot"
+log "frame 1: $REUSED1 reused, $SHOT1 shot"
+
+if test "x$REUSED0" != "x0" || test "x$SHOT0" != "x$PIXELS" ; then
+    log "frame 0 should shoot all $PIXELS pixels"
+    FAILED=`expr $FAILED + 1`
+fi
+if test "x$REUSED1" = "x" || test "x$SHOT1" = "x" \
+    || test `expr $REUSED1 + $SHOT1` -ne $PIXELS \
+    || test `expr $REUSED1 \* 2` -lt $PIXELS ; then
+    log "frame 1 should reuse at least half of the $PIXELS pixels and shoot the rest"
+    FAILED=`expr $FAILED + 1`
+fi
+
+# reused pixels may only differ along shadow and silhouette edges
+for f in reproject.pix reproject.pix.1 ; do
+    log "... running $PIXDIFF $f `echo $f | sed 's/reproject/reproject.ref/'`"
+    rm -f reproject.diff.pix
+    $PIXDIFF $f `echo $f | sed 's/reproject/reproject.ref/'` > reproject.diff.pix 2>> $LOGFILE
+    NUMBER_WRONG=`tail -n1 "$LOGFILE" | tr , '\012' | awk '/many/ {print $1}'`
+    log "$f $NUMBER_WRONG off by many"
+    if test "x$NUMBER_WRONG" = "x" || test $NUMBER_WRONG -gt 500 ; then
+	FAILED=`expr $FAILED + 1`
+    fi
+done
+
+if test $FAILED -eq 0 ; then
+    log "-> reproject.sh succeeded"
+else
+    log "-> reproject.sh FAILED, see $LOGFILE"
+    cat "$LOGFILE"
+fi
+
+exit $FAILED
+
+# Local Variables:
+# mode: sh
+# tab-width: 8
+# sh-indentation: 4
+# sh-basic-offset: 4
+# indent-tabs-mode: t
+# End:
+# ex: shiftwidth=4 tabstop=8
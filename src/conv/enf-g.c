@@ -41,6 +41,7 @@
 #include "bu/getopt.h"
 #include "rt/db4.h"
 #include "vmath.h"
+#include "bg/weld.h"
 #include "nmg.h"
 #include "rt/geom.h"
 #include "raytrace.h"
@@ -53,7 +54,6 @@
 static FILE *fd_in;
 static struct rt_wdb *fd_out;
 static fastf_t local_tol;
-static fastf_t local_tol_sq;
 static int ident;
 static char *part_name_file=NULL;
 static int use_part_name_hash=0;
@@ -63,8 +63,6 @@ static int name_not_converted=0;
 static int indent_level=0;
 static int indent_delta=4;
 
-static struct bg_vert_tree *tree;
-
 #define DO_INDENT { int _i; \
 	for (_i=0; _i<indent_level; _i++) {\
 	    bu_log(" "); \
@@ -91,12 +89,13 @@ struct obj_info {
 #define PART_TYPE 1
 #define ASSEMBLY_TYPE 2
 
+static fastf_t *part_pnts=NULL;		/* corners of the current part's triangles as read */
 static int *part_tris=NULL;		/* list of triangles for current part */
 static size_t max_tri=0;		/* number of triangles currently malloced */
 static size_t curr_tri=0;		/* number of triangles currently being used */
 static char progname[]="enf-g";
 
-#define TRI_BLOCK 512			/* number of triangles to malloc per call */
+#define TRI_BLOCK 512			/* number of triangles to malloc at first */
 
 void
 lower_case(char *name)
@@ -192,18 +191,20 @@ bad_triangle(int v[3], fastf_t *vertices)
 }
 
 
-/* routine to add a new triangle to the current part */
+/* routine to add a new triangle to the current part, given its three
+ * corners, they are welded once the whole part is read */
 void
-add_triangle(int v[3])
+add_triangle(const fastf_t v[9])
 {
     if (curr_tri >= max_tri) {
 	/* allocate more memory for triangles */
-	max_tri += TRI_BLOCK;
+	max_tri = (max_tri) ? max_tri * 2 : TRI_BLOCK;
+	part_pnts = (fastf_t *)bu_realloc(part_pnts, sizeof(fastf_t) * max_tri * 9, "part_pnts");
 	part_tris = (int *)bu_realloc(part_tris, sizeof(int) * max_tri * 3, "part_tris");
     }
 
     /* fill in triangle info */
-    VMOVE(&part_tris[curr_tri*3], v);
+    memcpy(&part_pnts[curr_tri*9], v, sizeof(fastf_t) * 9);
 
     /* increment count */
     curr_tri++;
@@ -381,10 +382,10 @@ Part_import(int id_start)
     int id_end;
     int last_surf=0;
     int i;
-    int tri[3];
+    fastf_t tri[9];
     int corner_index=-1;
-
-    bg_vert_tree_clean(tree);
+    fastf_t *verts=NULL;
+    size_t nverts=0;
 
     VSETALL(rgb, 128);
 
@@ -422,7 +423,6 @@ Part_import(int id_start)
 	    }
 	} else if (!bu_strncmp(line, "Facet", 5)) {
 	    /* read a triangle */
-	    VSETALL(tri, -1);
 	    corner_index = -1;
 	} else if (!bu_strncmp(line, "Face", 4)) {
 	    /* start of a surface */
@@ -449,11 +449,11 @@ Part_import(int id_start)
 		v[i] = atof(ptr);
 		ptr = strtok((char *)NULL, " \t");
 	    }
-	    tri[++corner_index] = (int)bg_vert_tree_add(tree, V3ARGS(v), local_tol_sq);
-	    if (corner_index == 2) {
-		if (!bad_triangle(tri, tree->the_array)) {
+	    if (corner_index < 2) {
+		corner_index++;
+		VMOVE(&tri[corner_index*3], v);
+		if (corner_index == 2)
 		    add_triangle(tri);
-		}
 	    }
 	} else if (!bu_strncmp(line, "Normal", 6)) {
 	    /* get a vertex normal */
@@ -463,6 +463,27 @@ Part_import(int id_start)
 	    bu_exit(1, "%s: ERROR: unrecognized line encountered while processing part id %d:\n%s\n", progname, id_start, line);
     }
 
+    if (curr_tri) {
+	/* weld the corners, then drop the triangles that collapse */
+	size_t *remap;
+	size_t j, k, ntri;
+
+	remap = (size_t *)bu_malloc(sizeof(size_t) * curr_tri * 3, "remap");
+	nverts = bg_weld_pnts(&verts, remap, part_pnts, curr_tri * 3, local_tol);
+	for (j=0; j<curr_tri*3; j++)
+	    part_tris[j] = (int)j;
+	ntri = bg_weld_faces(part_tris, curr_tri, remap);
+	bu_free(remap, "remap");
+
+	for (j=0, k=0; j<ntri; j++) {
+	    if (!bad_triangle(&part_tris[j*3], verts)) {
+		VMOVE(&part_tris[k*3], &part_tris[j*3]);
+		k++;
+	    }
+	}
+	curr_tri = k;
+    }
+
     if (curr_tri == 0) {
 	/* no facets in this part, so ignore it */
 	bu_free((char *)part, "part");
@@ -471,7 +492,7 @@ Part_import(int id_start)
 
 	/* write this part to database, first make a primitive solid */
 	if (mk_bot(fd_out, part->brlcad_solid, RT_BOT_SOLID, RT_BOT_UNORIENTED, 0,
-		   tree->curr_vert, curr_tri, tree->the_array, part_tris, NULL, NULL))
+		   nverts, curr_tri, verts, part_tris, NULL, NULL))
 	    bu_exit(1, "%s: Failed to write primitive %s (%s) to database\n", progname, part->brlcad_solid, part->obj_name);
 	if (verbose) {
 	    DO_INDENT;
@@ -500,11 +521,16 @@ Part_import(int id_start)
     }
 
     /* free some memory */
+    if (verts) {
+	bu_free((char *)verts, "verts");
+    }
     if (part_tris) {
+	bu_free((char *)part_pnts, "part_pnts");
 	bu_free((char *)part_tris, "part_tris");
     }
     max_tri = 0;
     curr_tri = 0;
+    part_pnts = NULL;
     part_tris = NULL;
 
     return part;
@@ -612,7 +638,6 @@ main(int argc, char *argv[])
     bu_setprogname(argv[0]);
 
     local_tol = BN_TOL_DIST;
-    local_tol_sq = local_tol * local_tol;
     ident = 1000;
 
     while ((c=bu_getopt(argc, argv, "vi:t:n:l:h?")) != -1) {
@@ -675,8 +700,6 @@ main(int argc, char *argv[])
 	create_name_hash(fd_parts);
     }
 
-    tree = bg_vert_tree_create();
-
     /* finally, start processing the input */
     while (bu_fgets(line, MAX_LINE_SIZE, fd_in)) {
 	if (!bu_strncmp(line, "FileName", 8)) {
@@ -43,12 +43,12 @@
 #include "bu/path.h"
 #include "bu/units.h"
 #include "vmath.h"
+#include "bg/weld.h"
 #include "nmg.h"
 #include "rt/geom.h"
 #include "raytrace.h"
 #include "wdb.h"
 
-static struct bg_vert_tree *tree;
 static struct wmember all_head;
 static char *input_file;	/* name of the input file */
 static char *brlcad_file;	/* name of output file */
@@ -63,11 +63,14 @@ static int binary=0;		/* flag indicating input is binary format */
 static FILE *fd_in;		/* input file */
 static struct rt_wdb *fd_out;	/* Resulting BRL-CAD file */
 static float conv_factor=1.0;	/* conversion factor from model units to mm */
-static int *bot_faces=NULL;	 /* array of ints (indices into tree->the_array array) three per face */
+static fastf_t *bot_pnts=NULL;	/* the part's face corners as read, nine per face */
+static int *bot_faces=NULL;	 /* array of ints (indices into bot_verts array) three per face */
 static int bot_fsize=0;		/* current size of the bot_faces array */
 static int bot_fcurr=0;		/* current bot face */
+static fastf_t *bot_verts=NULL;	/* the part's welded vertices */
+static size_t bot_nverts=0;	/* number of welded vertices */
 
-/* Size of blocks of faces to malloc */
+/* Initial number of faces to malloc */
 #define BOT_FBLOCK 128
 
 #define MAX_LINE_SIZE 512
@@ -92,21 +95,57 @@ usage(const char *argv0)
 
 
 void
-Add_face(int face[3])
+Add_face(const fastf_t pnts[9])
 {
     if (!bot_faces) {
-	bot_faces = (int *)bu_malloc(3 * BOT_FBLOCK * sizeof(int), "bot_faces");
 	bot_fsize = BOT_FBLOCK;
+	bot_pnts = (fastf_t *)bu_malloc(9 * bot_fsize * sizeof(fastf_t), "bot_pnts");
+	bot_faces = (int *)bu_malloc(3 * bot_fsize * sizeof(int), "bot_faces");
 	bot_fcurr = 0;
     } else if (bot_fcurr >= bot_fsize) {
-	bot_fsize += BOT_FBLOCK;
+	bot_fsize *= 2;
+	bot_pnts = (fastf_t *)bu_realloc((void *)bot_pnts, 9 * bot_fsize * sizeof(fastf_t), "bot_pnts increase");
 	bot_faces = (int *)bu_realloc((void *)bot_faces, 3 * bot_fsize * sizeof(int), "bot_faces increase");
     }
 
-    VMOVE(&bot_faces[3*bot_fcurr], face);
+    memcpy(&bot_pnts[9*bot_fcurr], pnts, 9 * sizeof(fastf_t));
     bot_fcurr++;
 }
 
+
+/* Weld the corners of the part's faces into bot_verts and drop the faces
+ * that collapse, leaving the rest in bot_faces.  Returns how many faces
+ * were dropped.
+ */
+static int
+Weld_faces(void)
+{
+    size_t *remap;
+    size_t i, npnts, nfaces, dropped;
+
+    bot_verts = NULL;
+    bot_nverts = 0;
+    if (!bot_fcurr)
+	return 0;
+
+    npnts = 3 * (size_t)bot_fcurr;
+    remap = (size_t *)bu_malloc(npnts * sizeof(size_t), "remap");
+    bot_nverts = bg_weld_pnts(&bot_verts, remap, bot_pnts, npnts, tol.dist);
+    for (i = 0; i < npnts; i++)
+	bot_faces[i] = (int)i;
+    nfaces = bg_weld_faces(bot_faces, bot_fcurr, remap);
+    bu_free(remap, "remap");
+
+    dropped = bot_fcurr - nfaces;
+    bot_fcurr = (int)nfaces;
+    if (!nfaces) {
+	bu_free(bot_verts, "bot_verts");
+	bot_verts = NULL;
+	bot_nverts = 0;
+    }
+    return (int)dropped;
+}
+
 static int
 _db_uniq_test(struct bu_vls *n, void *data)
 {
@@ -249,7 +288,7 @@ Convert_part_ascii(char line[MAX_LINE_SIZE])
 	} else if (!bu_strncmp(&line1[start], "outer loop", 10) || !bu_strncmp(&line1[start], "OUTER LOOP", 10)) {
 	    int endloop=0;
 	    int vert_no=0;
-	    int tmp_face[3] = {0, 0, 0};
+	    fastf_t tmp_face[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
 
 	    while (!endloop) {
 		if (bu_fgets(line1, MAX_LINE_SIZE, fd_in) == NULL)
@@ -270,49 +309,38 @@ Convert_part_ascii(char line[MAX_LINE_SIZE])
 
 			bu_log("Non-triangular loop:\n");
 			for (n=0; n<3; n++)
-			    bu_log("\t(%g %g %g)\n", V3ARGS(&tree->the_array[tmp_face[n]]));
+			    bu_log("\t(%g %g %g)\n", V3ARGS(&tmp_face[3*n]));
 
 			bu_log("\t(%g %g %g)\n", x, y, z);
+			continue;
 		    }
 		    x *= conv_factor;
 		    y *= conv_factor;
 		    z *= conv_factor;
-		    tmp_face[vert_no++] = bg_vert_tree_add(tree, x, y, z, tol.dist_sq);
+		    VSET(&tmp_face[3*vert_no], x, y, z);
+		    vert_no++;
 		} else {
 		    bu_log("Unrecognized line: %s\n", line1);
 		}
 	    }
 
-	    /* check for degenerate faces */
-	    if (tmp_face[0] == tmp_face[1]) {
-		degenerate_count++;
-		continue;
-	    }
-
-	    if (tmp_face[0] == tmp_face[2]) {
-		degenerate_count++;
-		continue;
-	    }
-
-	    if (tmp_face[1] == tmp_face[2]) {
-		degenerate_count++;
-		continue;
-	    }
-
 	    if (debug) {
 		int n;
 
 		bu_log("Making Face:\n");
 		for (n=0; n<3; n++)
-		    bu_log("\tvertex #%d: (%g %g %g)\n", tmp_face[n], V3ARGS(&tree->the_array[3*tmp_face[n]]));
+		    bu_log("\tvertex #%d: (%g %g %g)\n", n, V3ARGS(&tmp_face[3*n]));
 		VPRINT(" normal", normal);
 	    }
 
 	    Add_face(tmp_face);
-	    face_count++;
 	}
     }
 
+    /* weld the vertices, dropping the faces that turn out degenerate */
+    degenerate_count = Weld_faces();
+    face_count = bot_fcurr;
+
     /* Check if this part has any solid parts */
     if (face_count == 0) {
 	bu_log("\t%s has no solid parts, ignoring\n", bu_vls_cstr(&region_name));
@@ -327,9 +355,10 @@ Convert_part_ascii(char line[MAX_LINE_SIZE])
 	    bu_log("\t%d faces were degenerate\n", degenerate_count);
     }
 
-    mk_bot(fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, tree->curr_vert, bot_fcurr,
-	   tree->the_array, bot_faces, NULL, NULL);
-    bg_vert_tree_clean(tree);
+    mk_bot(fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, bot_nverts, bot_fcurr,
+	   bot_verts, bot_faces, NULL, NULL);
+    bu_free(bot_verts, "bot_verts");
+    bot_verts = NULL;
 
     if (db5_update_attribute(bu_vls_cstr(&solid_name), "importer", "stl-g", fd_out->dbip))
 	bu_bomb("db5_update_attribute() failed");
@@ -376,7 +405,7 @@ Convert_part_binary(void)
     unsigned long num_facets=0;
     float flts[12];
     vect_t normal;
-    int tmp_face[3];
+    fastf_t tmp_face[9];
     struct wmember head;
     struct bu_vls solid_name = BU_VLS_INIT_ZERO;
     struct bu_vls region_name = BU_VLS_INIT_ZERO;
@@ -384,6 +413,7 @@ Convert_part_binary(void)
     int degenerate_count=0;
     size_t ret;
 
+    bot_fcurr = 0;
     solid_count++;
     if (forced_name) {
 	bu_vls_sprintf(&solid_name, "%s.s", forced_name);
@@ -408,7 +438,6 @@ Convert_part_binary(void)
     bu_log("\t%ld facets\n", num_facets);
     while (fread(buf, 48, 1, fd_in)) {
 	int i;
-	double pt[3];
 
 	/* swap bytes to convert from Little-endian to network order (big-endian) */
 	for (i=0; i<12; i++) {
@@ -424,42 +453,26 @@ Convert_part_binary(void)
 	    perror("fread");
 
 	VMOVE(normal, flts);
-	VSCALE(pt, &flts[3], conv_factor);
-	tmp_face[0] = bg_vert_tree_add(tree, V3ARGS(pt), tol.dist_sq);
-	VSCALE(pt, &flts[6], conv_factor);
-	tmp_face[1] = bg_vert_tree_add(tree, V3ARGS(pt), tol.dist_sq);
-	VSCALE(pt, &flts[9], conv_factor);
-	tmp_face[2] = bg_vert_tree_add(tree, V3ARGS(pt), tol.dist_sq);
-
-	/* check for degenerate faces */
-	if (tmp_face[0] == tmp_face[1]) {
-	    degenerate_count++;
-	    continue;
-	}
-
-	if (tmp_face[0] == tmp_face[2]) {
-	    degenerate_count++;
-	    continue;
-	}
-
-	if (tmp_face[1] == tmp_face[2]) {
-	    degenerate_count++;
-	    continue;
-	}
+	VSCALE(&tmp_face[0], &flts[3], conv_factor);
+	VSCALE(&tmp_face[3], &flts[6], conv_factor);
+	VSCALE(&tmp_face[6], &flts[9], conv_factor);
 
 	if (debug) {
 	    int n;
 
 	    bu_log("Making Face:\n");
 	    for (n=0; n<3; n++)
-		bu_log("\tvertex #%d: (%g %g %g)\n", tmp_face[n], V3ARGS(&tree->the_array[3*tmp_face[n]]));
+		bu_log("\tvertex #%d: (%g %g %g)\n", n, V3ARGS(&tmp_face[3*n]));
 	    VPRINT(" normal", normal);
 	}
 
 	Add_face(tmp_face);
-	face_count++;
     }
 
+    /* weld the vertices, dropping the faces that turn out degenerate */
+    degenerate_count = Weld_faces();
+    face_count = bot_fcurr;
+
     /* Check if this part has any solid parts */
     if (face_count == 0) {
 	bu_log("\tpart has no solid parts, ignoring\n");
@@ -472,8 +485,9 @@ Convert_part_binary(void)
     }
 
     mk_bot(fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0,
-	   tree->curr_vert, bot_fcurr, tree->the_array, bot_faces, NULL, NULL);
-    bg_vert_tree_clean(tree);
+	   bot_nverts, bot_fcurr, bot_verts, bot_faces, NULL, NULL);
+    bu_free(bot_verts, "bot_verts");
+    bot_verts = NULL;
 
     if (db5_update_attribute(bu_vls_cstr(&solid_name), "importer", "stl-g", fd_out->dbip))
 	bu_bomb("db5_update_attribute() failed");
@@ -638,11 +652,13 @@ main(int argc, char *argv[])
 
     BU_LIST_INIT(&all_head.l);
 
-    /* create a tree structure to hold the input vertices */
-    tree = bg_vert_tree_create();
-
     Convert_input();
 
+    if (bot_faces) {
+	bu_free(bot_pnts, "bot_pnts");
+	bu_free(bot_faces, "bot_faces");
+    }
+
     /* make a top level group */
     mk_lcomb(fd_out, "all", &all_head, 0, (char *)NULL, (char *)NULL, (unsigned char *)NULL, 0);
 
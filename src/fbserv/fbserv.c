@@ -101,6 +101,8 @@ static int port = 0;
 static int port_set = 0;		/* !0 if user supplied port num */
 static int once_only = 0;
 static int netfd;
+static int shm_unit = -1;		/* /dev/shmem unit to mirror, if any */
+static struct fb_shm_tiles *shm_tiles = NULL;
 
 
 #define MAX_CLIENTS 32
@@ -123,8 +125,9 @@ static char usage[] = "\
 Usage: fbserv port_num\n\
 	  (for a stand-alone daemon)\n\
    or  fbserv [-v] [-{sS} squaresize]\n\
-	  [-{wW} width] [-{nN} height] -p port_num -F frame_buffer\n\
-	  (for a single-frame-buffer server)\n\
+	  [-{wW} width] [-{nN} height] [-T shmem_unit] -p port_num -F frame_buffer\n\
+	  (for a single-frame-buffer server, optionally also showing\n\
+	   tiles written locally to /dev/shmem<shmem_unit>)\n\
           (if '-p' and '-F' are both omitted, port_num and frame_buffer\n\
            must appear in that order)\n\
 ";
@@ -134,7 +137,7 @@ get_args(int argc, char **argv)
 {
     int c;
 
-    while ((c = bu_getopt(argc, argv, "vF:s:w:n:S:W:N:p:h?")) != -1) {
+    while ((c = bu_getopt(argc, argv, "vF:s:w:n:S:W:N:p:T:h?")) != -1) {
 	switch (c) {
 	    case 'v':
 		verbose = 1;
@@ -158,6 +161,9 @@ get_args(int argc, char **argv)
 		port = atoi(bu_optarg);
 		port_set = 1;
 		break;
+	    case 'T':
+		shm_unit = atoi(bu_optarg);
+		break;
 
 	    default:		/* '?' */
 		return 0;
@@ -293,6 +299,35 @@ fbserv_new_client(struct pkg_conn *pcp)
 
 
 
+/*
+ * Copy any tiles written to the /dev/shmem framebuffer being mirrored
+ * into our framebuffer.  The writer may come and go; attach whenever
+ * one is present, and let go when it has closed and been drained.
+ */
+static void
+fbserv_shm_update(void)
+{
+    if (shm_unit < 0 || !fb_server_fbp)
+	return;
+
+    if (!shm_tiles) {
+	if ((shm_tiles = fb_shm_attach(shm_unit)) == NULL)
+	    return;
+	if (verbose)
+	    fprintf(stderr, "fbserv: attached to /dev/shmem%d\n", shm_unit);
+    }
+
+    if (fb_shm_drain(shm_tiles, fb_server_fbp) < 0) {
+	fb_shm_detach(shm_tiles);
+	shm_tiles = NULL;
+	if (verbose)
+	    fprintf(stderr, "fbserv: /dev/shmem%d closed\n", shm_unit);
+    } else {
+	fb_flush(fb_server_fbp);
+    }
+}
+
+
 /*
  * Loop forever handling clients as they come and go.
  * Access to the framebuffer may be interleaved, if the user
@@ -315,6 +350,9 @@ main_loop(void)
 	    if (fb_poll_rate(fb_server_fbp) > 0)
 		refresh_rate = fb_poll_rate(fb_server_fbp);
 	}
+	if (shm_unit >= 0 && refresh_rate > 20000)
+	    refresh_rate = 20000;	/* check for new tiles at 50Hz */
+	fbserv_shm_update();
 
 	infds = select_list;	/* struct copy */
 
@@ -425,7 +463,7 @@ main(int argc, char **argv)
 #endif
 
     /* for now, make them set a port_num, for usage message */
-    if (!get_args(argc, argv) || !port_set) {
+    if (!get_args(argc, argv) || !port_set || (shm_unit >= 0 && framebuffer == NULL)) {
 	(void)fputs(usage, stderr);
 	return 1;
     }
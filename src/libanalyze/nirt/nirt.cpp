@@ -360,19 +360,13 @@ static void _nirt_ae2dir(struct nirt_state *nss)
 }
 
 
-static double _nirt_backout(struct nirt_state *nss)
+static double _nirt_backout_ray(struct rt_i *rtip, const point_t ray_point, const vect_t ray_dir)
 {
     double bov;
-    point_t ray_point;
-    vect_t diag, dvec, ray_dir, center_bsphere;
+    vect_t diag, dvec, center_bsphere;
     fastf_t bsphere_diameter, dist_to_target, delta;
 
-    if (!nss || !nss->i->backout) return 0.0;
-
-    VMOVE(ray_point, nss->i->vals->orig);
-    VMOVE(ray_dir, nss->i->vals->dir);
-
-    VSUB2(diag, nss->i->ap->a_rt_i->mdl_max, nss->i->ap->a_rt_i->mdl_min);
+    VSUB2(diag, rtip->mdl_max, rtip->mdl_min);
     bsphere_diameter = MAGNITUDE(diag);
 
     /*
@@ -380,7 +374,7 @@ static double _nirt_backout(struct nirt_state *nss)
      * through the center of the bounding sphere and a plane normal to
      * the ray direction through the aim point.
      */
-    VADD2SCALE(center_bsphere, nss->i->ap->a_rt_i->mdl_max, nss->i->ap->a_rt_i->mdl_min, 0.5);
+    VADD2SCALE(center_bsphere, rtip->mdl_max, rtip->mdl_min, 0.5);
 
     dist_to_target = DIST_PNT_PNT(center_bsphere, ray_point);
 
@@ -398,6 +392,14 @@ static double _nirt_backout(struct nirt_state *nss)
 }
 
 
+static double _nirt_backout(struct nirt_state *nss)
+{
+    if (!nss || !nss->i->backout) return 0.0;
+
+    return _nirt_backout_ray(nss->i->ap->a_rt_i, nss->i->vals->orig, nss->i->vals->dir);
+}
+
+
 static fastf_t
 _nirt_get_obliq(fastf_t *ray, fastf_t *normal)
 {
@@ -1549,6 +1551,7 @@ static const struct nirt_cmd_desc nirt_descs[] = {
     { "hv",             "set/query gridplane coordinates",               "horz vert [dist]" },
     { "xyz",            "set/query target coordinates",                  "X Y Z" },
     { "s",              "shoot a ray at the target",                     NULL },
+    { "batch",          "shoot every ray in a file, in parallel",        "[-P ncpu] [-i csv|bin] [-f csv|bin|fmt] [-o file] ray_file" },
     { "backout",        "back out of model",                             NULL },
     { "useair",         "set/query use of air",                          "<0|1|2|...>" },
     { "units",          "set/query local units",                         "<mm|cm|m|in|ft>" },
@@ -1875,6 +1878,548 @@ _nirt_cmd_shoot(void *ns, int argc, const char **UNUSED(argv))
 }
 
 
+/*****************
+ * Batch queries *
+ *****************/
+
+/* Rays read, shot and written per pass - bounds memory use while
+ * keeping enough work queued to occupy every processor */
+#define NIRT_BATCH_BLOCK 16384
+
+/* Rays claimed by a processor at a time */
+#define NIRT_BATCH_CHUNK 32
+
+#define NIRT_BATCH_CSV 0
+#define NIRT_BATCH_BIN 1
+#define NIRT_BATCH_FMT 2
+
+#define NIRT_BATCH_MAGIC "nirtbat1"
+
+/* One partition along a batch ray, in base units */
+struct nirt_batch_part {
+    point_t in;
+    point_t out;
+    fastf_t d_in;		/* distances from the ray's given origin */
+    fastf_t d_out;
+    fastf_t obliq_in;
+    fastf_t obliq_out;
+    int reg_id;
+    int claimant_count;
+    const char *reg_name;	/* owned by the prepped rt_i */
+};
+
+struct nirt_batch_state {
+    struct rt_i *rtip;
+    struct resource **resp;	/* one per processor */
+    int overlap_claims;
+    int backout;
+    const fastf_t *rays;	/* origin and unit direction per ray */
+    size_t ray_cnt;
+    size_t next;		/* next unclaimed ray, under RT_SEM_WORKER */
+    std::vector<std::vector<struct nirt_batch_part> > *results;
+};
+
+/* What the hit routine needs to know about the ray being shot */
+struct nirt_batch_ray {
+    struct nirt_batch_state *s;
+    size_t ind;
+    fastf_t bov;
+};
+
+
+extern "C" int
+_nirt_batch_hit(struct application *ap, struct partition *part_head, struct seg *UNUSED(finished_segs))
+{
+    struct nirt_batch_ray *r = (struct nirt_batch_ray *)ap->a_uptr;
+    std::vector<struct nirt_batch_part> &parts = (*r->s->results)[r->ind];
+    struct partition *part;
+
+    if (r->s->overlap_claims == NIRT_OVLP_REBUILD_FASTGEN) {
+	rt_rebuild_overlaps(part_head, ap, 1);
+    } else if (r->s->overlap_claims == NIRT_OVLP_REBUILD_ALL) {
+	rt_rebuild_overlaps(part_head, ap, 0);
+    }
+
+    for (part = part_head->pt_forw; part != part_head; part = part->pt_forw) {
+	struct nirt_batch_part p;
+	vect_t nm_in, nm_out;
+
+	RT_HIT_NORMAL(nm_in, part->pt_inhit, part->pt_inseg->seg_stp,
+		&ap->a_ray, part->pt_inflip);
+	RT_HIT_NORMAL(nm_out, part->pt_outhit, part->pt_outseg->seg_stp,
+		&ap->a_ray, part->pt_outflip);
+	VMOVE(p.in, part->pt_inhit->hit_point);
+	VMOVE(p.out, part->pt_outhit->hit_point);
+	p.d_in = part->pt_inhit->hit_dist - r->bov;
+	p.d_out = part->pt_outhit->hit_dist - r->bov;
+	p.obliq_in = _nirt_get_obliq(ap->a_ray.r_dir, nm_in);
+	p.obliq_out = _nirt_get_obliq(ap->a_ray.r_dir, nm_out);
+	p.reg_id = part->pt_regionp->reg_regionid;
+	p.reg_name = part->pt_regionp->reg_name;
+	p.claimant_count = 1;
+	if (part->pt_overlap_reg) {
+	    struct region **rpp;
+	    p.claimant_count = 0;
+	    for (rpp = part->pt_overlap_reg; *rpp != REGION_NULL; ++rpp)
+		p.claimant_count++;
+	}
+	parts.push_back(p);
+    }
+
+    return HIT;
+}
+
+
+extern "C" int
+_nirt_batch_miss(struct application *UNUSED(ap))
+{
+    return MISS;
+}
+
+
+extern "C" int
+_nirt_batch_overlap(struct application *ap, struct partition *pp, struct region *reg1, struct region *reg2, struct partition *InputHdp)
+{
+    /* Same resolution as _nirt_if_overlap, minus its list of
+     * overlaps in the shared state, which no worker may touch. */
+    return rt_defoverlap(ap, pp, reg1, reg2, InputHdp);
+}
+
+
+static void
+_nirt_batch_worker(int cpu, void *ptr)
+{
+    struct nirt_batch_state *s = (struct nirt_batch_state *)ptr;
+    struct nirt_batch_ray r;
+    struct application ap;
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = s->rtip;
+    ap.a_resource = s->resp[cpu];
+    ap.a_hit = _nirt_batch_hit;
+    ap.a_miss = _nirt_batch_miss;
+    ap.a_overlap = _nirt_batch_overlap;
+    ap.a_logoverlap = rt_silent_logoverlap;
+    ap.a_onehit = 0;
+    ap.a_uptr = (void *)&r;
+    r.s = s;
+
+    while (1) {
+	size_t start, end, i;
+
+	bu_semaphore_acquire(RT_SEM_WORKER);
+	start = s->next;
+	s->next += NIRT_BATCH_CHUNK;
+	bu_semaphore_release(RT_SEM_WORKER);
+
+	if (start >= s->ray_cnt)
+	    break;
+	end = std::min(start + NIRT_BATCH_CHUNK, s->ray_cnt);
+
+	for (i = start; i < end; i++) {
+	    const fastf_t *ray = &s->rays[6*i];
+	    r.ind = i;
+	    r.bov = (s->backout) ? _nirt_backout_ray(s->rtip, ray, &ray[3]) : 0.0;
+	    VJOIN1(ap.a_ray.r_pt, ray, -r.bov, &ray[3]);
+	    VMOVE(ap.a_ray.r_dir, &ray[3]);
+	    (void)rt_shootray(&ap);
+	}
+    }
+}
+
+
+/* Read up to max rays (origin in local units, then direction) into
+ * rays, converting to base units and unitizing the directions.
+ * Returns the number read, or -1 on a malformed ray. */
+static long
+_nirt_batch_read(struct nirt_state *nss, FILE *fp, int ifmt, size_t max, std::vector<fastf_t> &rays, size_t *lineno)
+{
+    struct bu_vls line = BU_VLS_INIT_ZERO;
+    size_t cnt = 0;
+
+    rays.clear();
+    while (cnt < max) {
+	double v[6];
+	vect_t dir;
+
+	if (ifmt == NIRT_BATCH_BIN) {
+	    size_t got = fread(v, sizeof(double), 6, fp);
+	    if (got == 0)
+		break;
+	    if (got != 6) {
+		nerr(nss, "Error: batch: truncated ray %zu in binary ray file\n", *lineno + 1);
+		bu_vls_free(&line);
+		return -1;
+	    }
+	    (*lineno)++;
+	} else {
+	    char *c;
+	    bu_vls_trunc(&line, 0);
+	    if (bu_vls_gets(&line, fp) < 0)
+		break;
+	    (*lineno)++;
+	    if ((c = strchr(bu_vls_addr(&line), '#')) != NULL)
+		*c = '\0';
+	    for (c = bu_vls_addr(&line); *c; c++) {
+		if (*c == ',')
+		    *c = ' ';
+	    }
+	    bu_vls_trimspace(&line);
+	    if (!bu_vls_strlen(&line))
+		continue;
+	    if (sscanf(bu_vls_cstr(&line), "%lf %lf %lf %lf %lf %lf", &v[0], &v[1], &v[2], &v[3], &v[4], &v[5]) != 6) {
+		nerr(nss, "Error: batch: line %zu does not hold a ray (x y z dx dy dz)\n", *lineno);
+		bu_vls_free(&line);
+		return -1;
+	    }
+	}
+
+	VSET(dir, v[3], v[4], v[5]);
+	if (MAGNITUDE(dir) < SMALL_FASTF) {
+	    nerr(nss, "Error: batch: ray %zu has no direction\n", *lineno);
+	    bu_vls_free(&line);
+	    return -1;
+	}
+	VUNITIZE(dir);
+	rays.push_back(v[0] * nss->i->local2base);
+	rays.push_back(v[1] * nss->i->local2base);
+	rays.push_back(v[2] * nss->i->local2base);
+	rays.push_back(dir[X]);
+	rays.push_back(dir[Y]);
+	rays.push_back(dir[Z]);
+	cnt++;
+    }
+
+    bu_vls_free(&line);
+    return (long)cnt;
+}
+
+
+static void
+_nirt_batch_csv_str(struct bu_vls *o, const char *str)
+{
+    const char *c;
+
+    if (!strpbrk(str, ",\"\n")) {
+	bu_vls_strcat(o, str);
+	return;
+    }
+    bu_vls_putc(o, '"');
+    for (c = str; *c; c++) {
+	if (*c == '"')
+	    bu_vls_putc(o, '"');
+	bu_vls_putc(o, *c);
+    }
+    bu_vls_putc(o, '"');
+}
+
+
+/* Write one block of results, in ray order, starting at ray number
+ * first.  CSV goes to fp or, without one, to the nirt output. */
+static int
+_nirt_batch_write(struct nirt_state *nss, FILE *fp, int ofmt, size_t first, std::vector<std::vector<struct nirt_batch_part> > &results, size_t *part_cnt)
+{
+    double b2l = nss->i->base2local;
+    size_t i, j;
+
+    if (ofmt == NIRT_BATCH_BIN) {
+	for (i = 0; i < results.size(); i++) {
+	    uint64_t ray = first + i;
+	    uint32_t npart = (uint32_t)results[i].size();
+	    if (fwrite(&ray, sizeof(ray), 1, fp) != 1 || fwrite(&npart, sizeof(npart), 1, fp) != 1)
+		return -1;
+	    for (j = 0; j < results[i].size(); j++) {
+		struct nirt_batch_part &p = results[i][j];
+		int32_t ids[2] = {(int32_t)p.reg_id, (int32_t)p.claimant_count};
+		double vals[11] = {
+		    p.in[X] * b2l, p.in[Y] * b2l, p.in[Z] * b2l,
+		    p.out[X] * b2l, p.out[Y] * b2l, p.out[Z] * b2l,
+		    p.d_in * b2l, p.d_out * b2l, (p.d_out - p.d_in) * b2l,
+		    p.obliq_in, p.obliq_out
+		};
+		uint32_t nlen = (uint32_t)strlen(p.reg_name);
+		if (fwrite(ids, sizeof(int32_t), 2, fp) != 2 || fwrite(vals, sizeof(double), 11, fp) != 11
+			|| fwrite(&nlen, sizeof(nlen), 1, fp) != 1 || fwrite(p.reg_name, 1, nlen, fp) != nlen)
+		    return -1;
+	    }
+	    *part_cnt += results[i].size();
+	}
+	return 0;
+    }
+
+    struct bu_vls o = BU_VLS_INIT_ZERO;
+    for (i = 0; i < results.size(); i++) {
+	if (!results[i].size()) {
+	    bu_vls_printf(&o, "%zu,0,,,,,,,,,,,,,,\n", first + i);
+	    continue;
+	}
+	for (j = 0; j < results[i].size(); j++) {
+	    struct nirt_batch_part &p = results[i][j];
+	    bu_vls_printf(&o, "%zu,%zu,", first + i, j + 1);
+	    _nirt_batch_csv_str(&o, p.reg_name);
+	    bu_vls_printf(&o, ",%d,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%.10g,%d\n",
+		    p.reg_id, p.in[X] * b2l, p.in[Y] * b2l, p.in[Z] * b2l,
+		    p.out[X] * b2l, p.out[Y] * b2l, p.out[Z] * b2l,
+		    p.d_in * b2l, p.d_out * b2l, (p.d_out - p.d_in) * b2l,
+		    p.obliq_in, p.obliq_out, p.claimant_count);
+	}
+	*part_cnt += results[i].size();
+    }
+    if (fp) {
+	size_t len = bu_vls_strlen(&o);
+	if (fwrite(bu_vls_cstr(&o), 1, len, fp) != len) {
+	    bu_vls_free(&o);
+	    return -1;
+	}
+    } else {
+	nout(nss, "%s", bu_vls_cstr(&o));
+    }
+    bu_vls_free(&o);
+    return 0;
+}
+
+
+/* The compatibility path: each ray goes through the regular shot
+ * and its fmt-driven reports, one at a time. */
+static int
+_nirt_batch_fmt(struct nirt_state *nss, FILE *ifp, int ifmt, size_t *ray_cnt)
+{
+    struct nirt_output_record *vals = nss->i->vals;
+    struct nirt_output_record saved = *vals;
+    std::vector<fastf_t> rays;
+    const char *s_argv[2] = {"s", NULL};
+    size_t lineno = 0;
+    long cnt = 0;
+    int ret = 0;
+
+    while (!ret && (cnt = _nirt_batch_read(nss, ifp, ifmt, NIRT_BATCH_BLOCK, rays, &lineno)) > 0) {
+	for (long i = 0; i < cnt; i++) {
+	    VMOVE(vals->orig, &rays[6*i]);
+	    VMOVE(vals->dir, &rays[6*i+3]);
+	    _nirt_targ2grid(nss);
+	    _nirt_dir2ae(nss);
+	    if (_nirt_cmd_shoot(nss, 1, s_argv)) {
+		ret = -1;
+		break;
+	    }
+	}
+	*ray_cnt += (size_t)cnt;
+    }
+    if (cnt < 0)
+	ret = -1;
+
+    /* put the interactive target back the way it was */
+    VMOVE(vals->orig, saved.orig);
+    VMOVE(vals->dir, saved.dir);
+    vals->h = saved.h;
+    vals->v = saved.v;
+    vals->d_orig = saved.d_orig;
+    vals->a = saved.a;
+    vals->e = saved.e;
+
+    return ret;
+}
+
+
+extern "C" int
+_nirt_cmd_batch(void *ns, int argc, const char **argv)
+{
+    struct nirt_state *nss = (struct nirt_state *)ns;
+    if (!ns || !nss->i->ap) return -1;
+
+    int ac = 0;
+    int ret = 0;
+    int print_help = 0;
+    int ncpu = 0;
+    int ifmt = NIRT_BATCH_CSV;
+    int ofmt = NIRT_BATCH_CSV;
+    size_t ray_cnt = 0;
+    size_t part_cnt = 0;
+    FILE *ifp = NULL;
+    FILE *ofp = NULL;
+    int64_t start = 0;
+    struct bu_vls ifmt_str = BU_VLS_INIT_ZERO;
+    struct bu_vls ofmt_str = BU_VLS_INIT_ZERO;
+    struct bu_vls ofile = BU_VLS_INIT_ZERO;
+    struct bu_vls optparse_msg = BU_VLS_INIT_ZERO;
+    struct bu_opt_desc d[6];
+    BU_OPT(d[0],  "h", "help",   "",         NULL,         &print_help, "print help and exit");
+    BU_OPT(d[1],  "P", "cpus",   "#",        &bu_opt_int,  &ncpu,       "number of processors to shoot with (default: all)");
+    BU_OPT(d[2],  "i", "input",  "csv|bin",  &bu_opt_vls,  &ifmt_str,   "ray file format: text columns, or 6 native doubles per ray");
+    BU_OPT(d[3],  "f", "format", "csv|bin|fmt", &bu_opt_vls, &ofmt_str, "result format: CSV, binary records, or the current fmt strings");
+    BU_OPT(d[4],  "o", "output", "file",     &bu_opt_vls,  &ofile,      "write results to file rather than the nirt output");
+    BU_OPT_NULL(d[5]);
+    const char *ustr = "Usage: batch <opts> ray_file\nShoots every ray (x y z dx dy dz, in local units) in ray_file, or standard input if ray_file is \"-\".\nOptions:";
+
+    argv++; argc--;
+
+    if ((ac = bu_opt_parse(&optparse_msg, argc, (const char **)argv, d)) == -1) {
+	char *help = bu_opt_describe(d, NULL);
+	nerr(nss, "Error: bu_opt value read failure: %s\n\n%s\n%s\n", bu_vls_cstr(&optparse_msg), ustr, help);
+	if (help) bu_free(help, "help str");
+	ret = -1;
+	goto batch_done;
+    }
+
+    if (print_help || ac != 1) {
+	char *help = bu_opt_describe(d, NULL);
+	nerr(nss, "%s\n%s", ustr, help);
+	if (help) bu_free(help, "help str");
+	ret = -1;
+	goto batch_done;
+    }
+
+    if (bu_vls_strlen(&ifmt_str)) {
+	if (BU_STR_EQUAL(bu_vls_cstr(&ifmt_str), "bin")) {
+	    ifmt = NIRT_BATCH_BIN;
+	} else if (!BU_STR_EQUAL(bu_vls_cstr(&ifmt_str), "csv")) {
+	    nerr(nss, "Error: batch: unknown ray file format \"%s\"\n", bu_vls_cstr(&ifmt_str));
+	    ret = -1;
+	    goto batch_done;
+	}
+    }
+    if (bu_vls_strlen(&ofmt_str)) {
+	if (BU_STR_EQUAL(bu_vls_cstr(&ofmt_str), "bin")) {
+	    ofmt = NIRT_BATCH_BIN;
+	} else if (BU_STR_EQUAL(bu_vls_cstr(&ofmt_str), "fmt")) {
+	    ofmt = NIRT_BATCH_FMT;
+	} else if (!BU_STR_EQUAL(bu_vls_cstr(&ofmt_str), "csv")) {
+	    nerr(nss, "Error: batch: unknown result format \"%s\"\n", bu_vls_cstr(&ofmt_str));
+	    ret = -1;
+	    goto batch_done;
+	}
+    }
+    if (ofmt == NIRT_BATCH_BIN && !bu_vls_strlen(&ofile)) {
+	nerr(nss, "Error: batch: binary results need an output file (-o)\n");
+	ret = -1;
+	goto batch_done;
+    }
+    if (ofmt == NIRT_BATCH_FMT && bu_vls_strlen(&ofile)) {
+	nerr(nss, "Error: batch: fmt results go to the nirt output, -o is not supported\n");
+	ret = -1;
+	goto batch_done;
+    }
+
+    /* Same preparation as a single shot */
+    if (!_nirt_get_rtip(nss)) {
+	nerr(nss, "Error: batch: no active objects to shoot at\n");
+	ret = -1;
+	goto batch_done;
+    }
+    if (nss->i->need_reprep) {
+	if (_nirt_raytrace_prep(nss)) {
+	    nerr(nss, "Error: raytrace prep failed!\n");
+	    ret = -1;
+	    goto batch_done;
+	}
+    } else {
+	nss->i->ap->a_rt_i = _nirt_get_rtip(nss);
+	nss->i->ap->a_resource = _nirt_get_resource(nss);
+    }
+
+    if (BU_STR_EQUAL(argv[0], "-")) {
+	ifp = stdin;
+    } else if ((ifp = fopen(argv[0], (ifmt == NIRT_BATCH_BIN) ? "rb" : "r")) == NULL) {
+	nerr(nss, "Error: batch: cannot open ray file %s\n", argv[0]);
+	ret = -1;
+	goto batch_done;
+    }
+
+    start = bu_gettime();
+
+    if (ofmt == NIRT_BATCH_FMT) {
+	ret = _nirt_batch_fmt(nss, ifp, ifmt, &ray_cnt);
+	goto batch_done;
+    }
+
+    if (bu_vls_strlen(&ofile) && (ofp = fopen(bu_vls_cstr(&ofile), (ofmt == NIRT_BATCH_BIN) ? "wb" : "w")) == NULL) {
+	nerr(nss, "Error: batch: cannot open output file %s\n", bu_vls_cstr(&ofile));
+	ret = -1;
+	goto batch_done;
+    }
+
+    if (ofmt == NIRT_BATCH_BIN) {
+	if (fwrite(NIRT_BATCH_MAGIC, 1, 8, ofp) != 8)
+	    ret = -1;
+    } else {
+	const char *hdr = "ray,partition,region,region_id,x_in,y_in,z_in,x_out,y_out,z_out,d_in,d_out,los,obliq_in,obliq_out,claimants\n";
+	if (ofp) {
+	    if (fputs(hdr, ofp) < 0)
+		ret = -1;
+	} else {
+	    nout(nss, "%s", hdr);
+	}
+    }
+
+    {
+	struct nirt_batch_state s;
+	std::vector<fastf_t> rays;
+	std::vector<std::vector<struct nirt_batch_part> > results;
+	size_t lineno = 0;
+	long cnt = 0;
+	int i;
+
+	if (ncpu <= 0)
+	    ncpu = (int)bu_avail_cpus();
+	if (ncpu > MAX_PSW)
+	    ncpu = MAX_PSW;
+
+	/* The interactive resource serves processor 0 */
+	s.rtip = nss->i->ap->a_rt_i;
+	s.resp = (struct resource **)bu_calloc(ncpu, sizeof(struct resource *), "batch resources");
+	s.resp[0] = nss->i->ap->a_resource;
+	for (i = 1; i < ncpu; i++) {
+	    BU_GET(s.resp[i], struct resource);
+	    rt_init_resource(s.resp[i], i, s.rtip);
+	}
+	s.overlap_claims = nss->i->overlap_claims;
+	s.backout = nss->i->backout;
+	s.results = &results;
+
+	while (!ret && (cnt = _nirt_batch_read(nss, ifp, ifmt, NIRT_BATCH_BLOCK, rays, &lineno)) > 0) {
+	    results.clear();
+	    results.resize((size_t)cnt);
+	    s.rays = rays.data();
+	    s.ray_cnt = (size_t)cnt;
+	    s.next = 0;
+	    bu_parallel(_nirt_batch_worker, (size_t)ncpu, (void *)&s);
+
+	    if (_nirt_batch_write(nss, ofp, ofmt, ray_cnt, results, &part_cnt) < 0) {
+		nerr(nss, "Error: batch: failed writing results to %s\n", bu_vls_cstr(&ofile));
+		ret = -1;
+	    }
+	    ray_cnt += (size_t)cnt;
+	}
+	if (cnt < 0)
+	    ret = -1;
+
+	/* The extra resources must not outlive this command in the
+	 * rt_i's table, or the next rt_clean() would visit them. */
+	for (i = 1; i < ncpu; i++) {
+	    rt_clean_resource_complete(s.rtip, s.resp[i]);
+	    BU_PTBL_SET(&s.rtip->rti_resources, i, NULL);
+	    BU_PUT(s.resp[i], struct resource);
+	}
+	bu_free(s.resp, "batch resources");
+    }
+
+batch_done:
+    if (!ret && ifp)
+	nmsg(nss, "batch: %zu rays, %zu partitions in %.3f s\n", ray_cnt, part_cnt, (double)(bu_gettime() - start) / 1.0e6);
+    if (ifp && ifp != stdin)
+	fclose(ifp);
+    if (ofp && fclose(ofp) && !ret) {
+	nerr(nss, "Error: batch: failed writing results to %s\n", bu_vls_cstr(&ofile));
+	ret = -1;
+    }
+    bu_vls_free(&ifmt_str);
+    bu_vls_free(&ofmt_str);
+    bu_vls_free(&ofile);
+    bu_vls_free(&optparse_msg);
+    return ret;
+}
+
+
 extern "C" int
 _nirt_cmd_backout(void *ns, int argc, const char *argv[])
 {
@@ -2601,6 +3146,7 @@ const struct bu_cmdtab _libanalyze_nirt_cmds[] = {
     { "ae",             _nirt_cmd_az_el},
     { "attr",           _nirt_cmd_attr},
     { "backout",        _nirt_cmd_backout},
+    { "batch",          _nirt_cmd_batch},
     { "center",         _nirt_cmd_target_coor},
     { "color",          _nirt_cmd_color_plot},
     { "debug",          _nirt_cmd_debug},
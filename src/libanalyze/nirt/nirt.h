@@ -53,9 +53,11 @@ extern "C" b_off_t ftello(FILE *);
 #include "bu/app.h"
 #include "bu/cmd.h"
 #include "bu/malloc.h"
+#include "bu/parallel.h"
 #include "bu/path.h"
 #include "bu/units.h"
 #include "bu/str.h"
+#include "bu/time.h"
 #include "bu/vls.h"
 #include "analyze.h"
 
@@ -0,0 +1,267 @@
+/*                          W E L D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file weld.c
+ *
+ * Welds clusters of jittered points, some of them straddling grid cells
+ * and some close enough to chain into their neighbours, and fails unless
+ * bg_weld_pnts() keeps and maps them exactly as welding them one at a
+ * time to the first kept point within tolerance does.  A larger count,
+ * enough for bg_weld_pnts() to merge its buckets in parallel, is checked
+ * the same way and also welded through a bg_vert_tree for a timing
+ * comparison.
+ *
+ * Usage: bg_weld [points]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/exit.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/time.h"
+#include "vmath.h"
+#include "bn/randmt.h"
+#include "bg/vert_tree.h"
+#include "bg/weld.h"
+
+
+/* n points in clusters of up to four around random centres */
+static fastf_t *
+weld_test_pnts(size_t n, fastf_t tol)
+{
+    fastf_t *pnts = (fastf_t *)bu_malloc(n * 3 * sizeof(fastf_t), "points");
+    size_t i = 0;
+
+    while (i < n) {
+	point_t c;
+	int k, copies = 1 + (int)(bn_randmt() * 4);
+
+	VSET(c, bn_randmt() * 100.0, bn_randmt() * 100.0, bn_randmt() * 100.0);
+	/* a few land right on a grid plane */
+	if (bn_randmt() < 0.1)
+	    c[X] = floor(c[X] / tol) * tol;
+	for (k = 0; k < copies && i < n; k++, i++) {
+	    fastf_t *p = &pnts[3*i];
+	    /* spread of up to 1.5 tol, so a cluster can split or chain */
+	    VSET(p, c[X] + (bn_randmt() - 0.5) * 1.5 * tol,
+		 c[Y] + (bn_randmt() - 0.5) * 1.5 * tol,
+		 c[Z] + (bn_randmt() - 0.5) * 1.5 * tol);
+	    if (k & 1)
+		VMOVE(p, c);
+	}
+    }
+
+    /* shuffle so clusters are not contiguous */
+    for (i = n - 1; i > 0; i--) {
+	size_t j = (size_t)(bn_randmt() * (i + 1)) % (i + 1);
+	point_t t;
+	VMOVE(t, &pnts[3*i]);
+	VMOVE(&pnts[3*i], &pnts[3*j]);
+	VMOVE(&pnts[3*j], t);
+    }
+    return pnts;
+}
+
+
+/* hash of the reference grid cell holding p */
+static size_t
+weld_test_cell(const fastf_t *p, fastf_t cell, const int64_t *off, size_t nbuckets)
+{
+    uint64_t h = 0;
+    int k;
+
+    for (k = 0; k < 3; k++)
+	h = h * 1000003 + (uint64_t)((int64_t)floor(p[k] / cell) + off[k]);
+    return (size_t)(h % nbuckets);
+}
+
+
+/* Check against welding each point, in order, to the first kept point
+ * within tol.  Kept points are hashed by grid cells tol across, so
+ * only the neighbouring cells are searched and the check stays cheap
+ * enough for point counts that bg_weld_pnts() threads. */
+static int
+weld_test_check(const fastf_t *pnts, size_t n, fastf_t tol)
+{
+    size_t *remap = (size_t *)bu_malloc(n * sizeof(size_t), "remap");
+    size_t *kept = (size_t *)bu_malloc(n * sizeof(size_t), "kept");
+    size_t nbuckets = 2 * n + 1;
+    size_t *head = (size_t *)bu_malloc(nbuckets * sizeof(size_t), "cell heads");
+    size_t *next = (size_t *)bu_malloc(n * sizeof(size_t), "cell chains");
+    fastf_t cell = (tol > 0.0) ? tol : 1.0;
+    fastf_t *verts;
+    size_t i, k, count, nkept = 0;
+    int bad = 0;
+
+    count = bg_weld_pnts(&verts, remap, pnts, n, tol);
+
+    for (k = 0; k < nbuckets; k++)
+	head[k] = SIZE_MAX;
+
+    for (i = 0; i < n; i++) {
+	size_t to = nkept;
+	int64_t off[3];
+
+	/* the lowest kept index within tol across the 27 cells around
+	 * the point, buckets shared by other cells only cost time */
+	for (off[X] = -1; off[X] <= 1; off[X]++) {
+	    for (off[Y] = -1; off[Y] <= 1; off[Y]++) {
+		for (off[Z] = -1; off[Z] <= 1; off[Z]++) {
+		    for (k = head[weld_test_cell(&pnts[3*i], cell, off, nbuckets)]; k != SIZE_MAX; k = next[k]) {
+			vect_t d;
+			if (k >= to)
+			    continue;
+			VSUB2(d, &pnts[3*i], &pnts[3*kept[k]]);
+			if ((tol > 0.0) ? (MAGSQ(d) <= tol * tol) : (d[X] == 0.0 && d[Y] == 0.0 && d[Z] == 0.0))
+			    to = k;
+		    }
+		}
+	    }
+	}
+	if (to == nkept) {
+	    size_t h;
+	    VSETALL(off, 0);
+	    h = weld_test_cell(&pnts[3*i], cell, off, nbuckets);
+	    next[nkept] = head[h];
+	    head[h] = nkept;
+	    kept[nkept++] = i;
+	}
+	if (remap[i] != to && bad++ < 10)
+	    bu_log("point %zu welded to %zu, expected %zu\n", i, remap[i], to);
+    }
+
+    if (count != nkept) {
+	bu_log("%zu points kept, expected %zu\n", count, nkept);
+	bad++;
+    } else {
+	for (k = 0; k < nkept; k++) {
+	    if (!VNEAR_EQUAL(&verts[3*k], &pnts[3*kept[k]], SMALL_FASTF)) {
+		bu_log("kept point %zu differs\n", k);
+		bad++;
+		break;
+	    }
+	}
+    }
+
+    bu_log("tol %g: %zu points, %zu kept\n", tol, n, count);
+
+    bu_free(verts, "welded points");
+    bu_free(next, "cell chains");
+    bu_free(head, "cell heads");
+    bu_free(kept, "kept");
+    bu_free(remap, "remap");
+    return bad;
+}
+
+
+static int
+weld_test_faces(void)
+{
+    int faces[12] = {0, 1, 2, 0, 1, 3, 2, 3, 4, 4, 5, 6};
+    size_t remap[7] = {0, 1, 2, 2, 3, 4, 4};
+    int expect[6] = {0, 1, 2, 0, 1, 2};
+    size_t i, n;
+
+    /* the second face survives as a copy of the first, the last two
+     * collapse onto an edge */
+    n = bg_weld_faces(faces, 4, remap);
+    for (i = 0; n == 2 && i < 6; i++) {
+	if (faces[i] != expect[i])
+	    n = 0;
+    }
+    if (n != 2) {
+	bu_log("bg_weld_faces kept the wrong faces\n");
+	return 1;
+    }
+    return 0;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct bg_vert_tree *tree;
+    fastf_t tol = 0.005;
+    fastf_t *pnts;
+    size_t *remap;
+    size_t i, n = 200000;
+    int64_t start;
+    double tweld, ttree;
+    size_t count;
+    int bad = 0;
+
+    bu_setprogname(argv[0]);
+    if (argc > 2)
+	bu_exit(1, "Usage: %s [points]\n", argv[0]);
+    if (argc == 2)
+	n = (size_t)atol(argv[1]);
+    if (n < 1)
+	bu_exit(1, "Usage: %s [points]\n", argv[0]);
+
+    bn_randmt_seed(5489);
+
+    pnts = weld_test_pnts(3000, tol);
+    bad += weld_test_check(pnts, 3000, tol);
+    bad += weld_test_check(pnts, 3000, 0.0);
+    bad += weld_test_check(pnts, 3000, 10.0);
+    bu_free(pnts, "points");
+    bad += weld_test_faces();
+
+    /* the default count is enough for the buckets to be merged in
+     * parallel, check that against the serial reference too */
+    pnts = weld_test_pnts(n, tol);
+    bad += weld_test_check(pnts, n, tol);
+    remap = (size_t *)bu_malloc(n * sizeof(size_t), "remap");
+
+    start = bu_gettime();
+    count = bg_weld_pnts(NULL, remap, pnts, n, tol);
+    tweld = (bu_gettime() - start) / 1000000.0;
+
+    tree = bg_vert_tree_create();
+    start = bu_gettime();
+    for (i = 0; i < n; i++)
+	(void)bg_vert_tree_add(tree, pnts[3*i], pnts[3*i+1], pnts[3*i+2], tol * tol);
+    ttree = (bu_gettime() - start) / 1000000.0;
+
+    bu_log("%zu points: weld %.3fs keeps %zu, vertex tree %.3fs keeps %zu\n",
+	   n, tweld, count, ttree, tree->curr_vert);
+
+    bg_vert_tree_destroy(tree);
+    bu_free(remap, "remap");
+    bu_free(pnts, "points");
+
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,373 @@
+/*                          W E L D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup bg_weld */
+/** @{ */
+/** @file libbg/weld.c
+ *
+ * @brief
+ * Batch welding of coincident vertices through a uniform grid hash.
+ *
+ * The grid cells are several times the tolerance across, so most points
+ * only need their own cell searched and the rest reach into at most the
+ * one neighbour per axis whose face they sit within tolerance of.  The
+ * cells are hashed into a table of about as many buckets as points and
+ * the points are counting sorted into the buckets in input order.
+ *
+ * Finding the first earlier point within tolerance of every point is
+ * independent work and runs in parallel.  When that point was itself
+ * kept, it is also the first kept point within tolerance, which covers
+ * nearly every weld; only points whose first neighbour was welded away
+ * are searched again, in order, for the first kept one.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "vmath.h"
+#include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "bg/weld.h"
+
+
+/* points handed to a thread at a time, and the fewest worth threading */
+#define WELD_CHUNK 65536
+#define WELD_PARALLEL_MIN 200000
+
+/* cells are WELD_CELL tolerances across, and a point only reaches into
+ * the next cell along an axis within WELD_REACH of a cell face, with a
+ * little slack for rounding */
+#define WELD_CELL 8.0
+#define WELD_REACH (1.01 / WELD_CELL)
+
+/* cell coordinates are clamped well inside int64_t, points that far out
+ * are only ever within tolerance of exact duplicates anyway */
+#define WELD_CELL_LIMIT 1.0e15
+
+/* a point and its index, sorted into its bucket */
+struct weld_pnt {
+    point_t p;
+    size_t i;
+};
+
+struct weld_state {
+    const fastf_t *pnts;
+    size_t npnts;
+    fastf_t tol_sq;
+    fastf_t inv_cell;		/* 1 / cell width */
+    int exact;			/* only weld exact duplicates */
+    uint64_t mask;		/* buckets - 1 */
+    uint32_t *bucket;		/* home bucket of each point */
+    size_t *start;		/* where each bucket's points start in sorted */
+    struct weld_pnt *sorted;	/* points by bucket, in input order in each */
+    size_t *first;		/* first earlier point within tolerance */
+    size_t next;		/* next chunk to hand out */
+    int pass;
+};
+
+
+static uint64_t
+weld_hash(int64_t x, int64_t y, int64_t z)
+{
+    uint64_t k = (uint64_t)x * 0x9E3779B97F4A7C15ULL
+	^ (uint64_t)y * 0xC2B2AE3D27D4EB4FULL
+	^ (uint64_t)z * 0x165667B19E3779F9ULL;
+    return k ^ (k >> 29);
+}
+
+
+/* the bucket of an exact point, -0.0 hashes with 0.0 */
+static uint64_t
+weld_exact_hash(const fastf_t *p)
+{
+    int64_t b[3];
+    int k;
+
+    for (k = 0; k < 3; k++) {
+	double v = p[k] + 0.0;
+	memcpy(&b[k], &v, sizeof(int64_t));
+    }
+    return weld_hash(b[0], b[1], b[2]);
+}
+
+
+/* the cell p is in, and for each axis the neighbour within tolerance
+ * of it, if any */
+static void
+weld_cell(const struct weld_state *st, const fastf_t *p, int64_t *cell, int *side)
+{
+    int k;
+
+    for (k = 0; k < 3; k++) {
+	fastf_t c = p[k] * st->inv_cell;
+	fastf_t f = floor(c);
+
+	/* NaN lands in the low corner and never welds */
+	if (!(f > -WELD_CELL_LIMIT))
+	    f = -WELD_CELL_LIMIT;
+	else if (!(f < WELD_CELL_LIMIT))
+	    f = WELD_CELL_LIMIT;
+	cell[k] = (int64_t)f;
+
+	c -= f;
+	if (c <= WELD_REACH)
+	    side[k] = -1;
+	else if (c >= 1.0 - WELD_REACH)
+	    side[k] = 1;
+	else
+	    side[k] = 0;
+    }
+}
+
+
+static uint64_t
+weld_home(const struct weld_state *st, const fastf_t *p)
+{
+    int64_t cell[3];
+    int side[3];
+
+    if (st->exact)
+	return weld_exact_hash(p) & st->mask;
+
+    weld_cell(st, p, cell, side);
+    return weld_hash(cell[X], cell[Y], cell[Z]) & st->mask;
+}
+
+
+/* the buckets that can hold a point within tolerance of p, returns how
+ * many there are */
+static int
+weld_buckets(const struct weld_state *st, const fastf_t *p, uint64_t *buckets)
+{
+    int64_t cell[3];
+    int side[3];
+    int n, nb = 0;
+
+    if (st->exact) {
+	buckets[0] = weld_exact_hash(p) & st->mask;
+	return 1;
+    }
+
+    weld_cell(st, p, cell, side);
+    for (n = 0; n < 8; n++) {
+	if (((n & 1) && !side[X]) || ((n & 2) && !side[Y]) || ((n & 4) && !side[Z]))
+	    continue;
+	buckets[nb++] = weld_hash(cell[X] + ((n & 1) ? side[X] : 0),
+				  cell[Y] + ((n & 2) ? side[Y] : 0),
+				  cell[Z] + ((n & 4) ? side[Z] : 0)) & st->mask;
+    }
+    return nb;
+}
+
+
+static int
+weld_near(const struct weld_state *st, const fastf_t *a, const fastf_t *b)
+{
+    vect_t d;
+
+    if (st->exact)
+	return (a[X] == b[X] && a[Y] == b[Y] && a[Z] == b[Z]);
+    VSUB2(d, a, b);
+    return MAGSQ(d) <= st->tol_sq;
+}
+
+
+/* the first point before point i at p within tolerance of it, or i
+ * itself if there is none; with keep, only points flagged in it count */
+static size_t
+weld_first(const struct weld_state *st, const fastf_t *p, size_t i, const unsigned char *keep)
+{
+    uint64_t buckets[8];
+    size_t best = i;
+    int n, nb;
+
+    nb = weld_buckets(st, p, buckets);
+    for (n = 0; n < nb; n++) {
+	size_t s;
+	for (s = st->start[buckets[n]]; s < st->start[buckets[n] + 1]; s++) {
+	    size_t j = st->sorted[s].i;
+	    if (j >= best)
+		break;
+	    if (keep && !keep[j])
+		continue;
+	    if (weld_near(st, p, st->sorted[s].p)) {
+		best = j;
+		break;
+	    }
+	}
+    }
+    return best;
+}
+
+
+static void
+weld_worker(int UNUSED(cpu), void *data)
+{
+    struct weld_state *st = (struct weld_state *)data;
+
+    while (1) {
+	size_t i, s, e;
+
+	bu_semaphore_acquire(BU_SEM_GENERAL);
+	s = st->next;
+	st->next += WELD_CHUNK;
+	bu_semaphore_release(BU_SEM_GENERAL);
+	if (s >= st->npnts)
+	    return;
+	e = (s + WELD_CHUNK < st->npnts) ? s + WELD_CHUNK : st->npnts;
+
+	if (st->pass == 0) {
+	    for (i = s; i < e; i++)
+		st->bucket[i] = (uint32_t)weld_home(st, &st->pnts[3*i]);
+	} else {
+	    /* in bucket order, so each point's own cell is at hand */
+	    for (i = s; i < e; i++) {
+		const struct weld_pnt *w = &st->sorted[i];
+		st->first[w->i] = weld_first(st, w->p, w->i, NULL);
+	    }
+	}
+    }
+}
+
+
+static void
+weld_run(struct weld_state *st, int pass)
+{
+    st->pass = pass;
+    st->next = 0;
+    bu_parallel(weld_worker, (st->npnts < WELD_PARALLEL_MIN) ? 1 : 0, st);
+}
+
+
+size_t
+bg_weld_pnts(fastf_t **verts, size_t *remap, const fastf_t *pnts, size_t npnts, fastf_t tol)
+{
+    struct weld_state st;
+    unsigned char *keep;
+    size_t nbuckets, b, i, count;
+
+    if (verts)
+	*verts = NULL;
+    if (!remap || !pnts || npnts == 0)
+	return 0;
+
+    st.pnts = pnts;
+    st.npnts = npnts;
+    st.tol_sq = (tol > 0.0) ? tol * tol : 0.0;
+    st.inv_cell = (tol > 0.0) ? 1.0 / (WELD_CELL * tol) : 0.0;
+    st.exact = !(st.tol_sq > 0.0) || !(st.inv_cell < INFINITY);
+
+    nbuckets = 1;
+    while (nbuckets < npnts && nbuckets < ((size_t)1 << 31))
+	nbuckets <<= 1;
+    st.mask = nbuckets - 1;
+
+    st.bucket = (uint32_t *)bu_malloc(npnts * sizeof(uint32_t), "weld buckets");
+    weld_run(&st, 0);
+
+    /* counting sort the points into their home buckets, leaving each
+     * bucket's start in the slot after it and then shifting them down */
+    st.start = (size_t *)bu_calloc(nbuckets + 1, sizeof(size_t), "weld bucket starts");
+    st.sorted = (struct weld_pnt *)bu_malloc(npnts * sizeof(struct weld_pnt), "weld sorted points");
+    for (i = 0; i < npnts; i++)
+	st.start[st.bucket[i] + 1]++;
+    for (b = 1; b <= nbuckets; b++)
+	st.start[b] += st.start[b - 1];
+    for (i = 0; i < npnts; i++) {
+	struct weld_pnt *w = &st.sorted[st.start[st.bucket[i]]++];
+	VMOVE(w->p, &pnts[3*i]);
+	w->i = i;
+    }
+    for (b = nbuckets; b > 0; b--)
+	st.start[b] = st.start[b - 1];
+    st.start[0] = 0;
+    bu_free(st.bucket, "weld buckets");
+    st.bucket = NULL;
+
+    st.first = remap;
+    weld_run(&st, 1);
+
+    /* in order, keep each point with nothing kept near it and send the
+     * rest to the output index of the first kept point near them */
+    keep = (unsigned char *)bu_calloc(npnts, 1, "weld kept points");
+    count = 0;
+    for (i = 0; i < npnts; i++) {
+	size_t j = remap[i];
+	if (j != i && !keep[j])
+	    j = weld_first(&st, &pnts[3*i], i, keep);
+	if (j == i) {
+	    keep[i] = 1;
+	    remap[i] = count++;
+	} else {
+	    remap[i] = remap[j];
+	}
+    }
+
+    if (verts) {
+	*verts = (fastf_t *)bu_malloc(count * 3 * sizeof(fastf_t), "welded points");
+	for (i = 0; i < npnts; i++) {
+	    if (keep[i])
+		VMOVE(&(*verts)[3*remap[i]], &pnts[3*i]);
+	}
+    }
+
+    bu_free(keep, "weld kept points");
+    bu_free(st.sorted, "weld sorted points");
+    bu_free(st.start, "weld bucket starts");
+
+    return count;
+}
+
+
+size_t
+bg_weld_faces(int *faces, size_t nfaces, const size_t *remap)
+{
+    size_t i, n = 0;
+
+    if (!faces || !remap)
+	return 0;
+
+    for (i = 0; i < nfaces; i++) {
+	size_t a = remap[faces[3*i]];
+	size_t b = remap[faces[3*i+1]];
+	size_t c = remap[faces[3*i+2]];
+
+	if (a == b || a == c || b == c)
+	    continue;
+	faces[3*n] = (int)a;
+	faces[3*n+1] = (int)b;
+	faces[3*n+2] = (int)c;
+	n++;
+    }
+    return n;
+}
+
+/** @} */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -403,6 +403,162 @@ bn_noise_vec(point_t point, point_t result)
 }
 
 
+/* points evaluated together, small enough for the stack */
+#define NOISE_BLOCK 64
+
+/* coordinates below this need no folding and convert to int exactly */
+#define NOISE_FAST_MAX 2147483647.0
+
+
+/* the RTable entries INCRSUM() reads for lattice hash m */
+#define NOISE_GATHER(_g, _m, _k) {		\
+	(_g)[0][_k] = RTable[_m];		\
+	(_g)[1][_k] = RTable[(_m)+1];		\
+	(_g)[2][_k] = RTable[(_m)+2];		\
+	(_g)[3][_k] = RTable[(_m)+3];		\
+    }
+
+/* INCRSUM() on gathered entries */
+#define GATHERSUM(_g, _k, s, x, y, z)	((s)*((_g)[0][_k]*0.5		\
+					      + (_g)[1][_k]*(x)		\
+					      + (_g)[2][_k]*(y)		\
+					      + (_g)[3][_k]*(z)))
+
+
+/**
+ * bn_noise_perlin() of n <= NOISE_BLOCK points held as separate x, y
+ * and z arrays.  The lattice hashing and table lookups go a point at a
+ * time, then the interpolation runs as straight loops over the block
+ * the compiler can vectorize.  The arithmetic is bn_noise_perlin()'s
+ * term for term, so the results are identical.
+ */
+static void
+noise_perlin_block(double *values, const fastf_t *xs, const fastf_t *ys, const fastf_t *zs, size_t n)
+{
+    double x[NOISE_BLOCK], y[NOISE_BLOCK], z[NOISE_BLOCK];
+    double fx[NOISE_BLOCK], fy[NOISE_BLOCK], fz[NOISE_BLOCK];
+    double ix[NOISE_BLOCK], iy[NOISE_BLOCK], iz[NOISE_BLOCK];
+    double jx[NOISE_BLOCK], jy[NOISE_BLOCK], jz[NOISE_BLOCK];
+    double g[8][4][NOISE_BLOCK];
+    size_t k;
+
+    for (k = 0; k < n; k++) {
+	point_t src, p, f;
+	int ip[3];
+	int m;
+
+	VSET(src, xs[k], ys[k], zs[k]);
+	if (fabs(src[X]) < NOISE_FAST_MAX && fabs(src[Y]) < NOISE_FAST_MAX && fabs(src[Z]) < NOISE_FAST_MAX) {
+	    /* what filter_args() comes to well inside the domain, where
+	     * nothing is folded and truncating is floor() */
+	    VSET(p, fabs(src[X]), fabs(src[Y]), fabs(src[Z]));
+	    VSET(ip, (int)p[X], (int)p[Y], (int)p[Z]);
+	    VSET(f, p[X] - ip[X], p[Y] - ip[Y], p[Z] - ip[Z]);
+	} else {
+	    filter_args(src, p, f, ip);
+	}
+
+	x[k] = p[X];
+	y[k] = p[Y];
+	z[k] = p[Z];
+	fx[k] = f[X];
+	fy[k] = f[Y];
+	fz[k] = f[Z];
+	ix[k] = ip[X];
+	iy[k] = ip[Y];
+	iz[k] = ip[Z];
+	jx[k] = ip[X] + 1;
+	jy[k] = ip[Y] + 1;
+	jz[k] = ip[Z] + 1;
+
+	/* in bn_noise_perlin()'s corner order */
+	m = Hash3d(ip[X], ip[Y], ip[Z]) & 0xFF;
+	NOISE_GATHER(g[0], m, k);
+	m = Hash3d(ip[X] + 1, ip[Y], ip[Z]) & 0xFF;
+	NOISE_GATHER(g[1], m, k);
+	m = Hash3d(ip[X], ip[Y] + 1, ip[Z]) & 0xFF;
+	NOISE_GATHER(g[2], m, k);
+	m = Hash3d(ip[X] + 1, ip[Y] + 1, ip[Z]) & 0xFF;
+	NOISE_GATHER(g[3], m, k);
+	m = Hash3d(ip[X], ip[Y], ip[Z] + 1) & 0xFF;
+	NOISE_GATHER(g[4], m, k);
+	m = Hash3d(ip[X] + 1, ip[Y], ip[Z] + 1) & 0xFF;
+	NOISE_GATHER(g[5], m, k);
+	m = Hash3d(ip[X], ip[Y] + 1, ip[Z] + 1) & 0xFF;
+	NOISE_GATHER(g[6], m, k);
+	m = Hash3d(ip[X] + 1, ip[Y] + 1, ip[Z] + 1) & 0xFF;
+	NOISE_GATHER(g[7], m, k);
+    }
+
+    for (k = 0; k < n; k++) {
+	double sx = SMOOTHSTEP(fx[k]);
+	double sy = SMOOTHSTEP(fy[k]);
+	double sz = SMOOTHSTEP(fz[k]);
+	double tx = 1.0 - sx;
+	double ty = 1.0 - sy;
+	double tz = 1.0 - sz;
+	double sum;
+
+	sum = GATHERSUM(g[0], k, (tx*ty*tz), (x[k]-ix[k]), (y[k]-iy[k]), (z[k]-iz[k]));
+	sum += GATHERSUM(g[1], k, (sx*ty*tz), (x[k]-jx[k]), (y[k]-iy[k]), (z[k]-iz[k]));
+	sum += GATHERSUM(g[2], k, (tx*sy*tz), (x[k]-ix[k]), (y[k]-jy[k]), (z[k]-iz[k]));
+	sum += GATHERSUM(g[3], k, (sx*sy*tz), (x[k]-jx[k]), (y[k]-jy[k]), (z[k]-iz[k]));
+	sum += GATHERSUM(g[4], k, (tx*ty*sz), (x[k]-ix[k]), (y[k]-iy[k]), (z[k]-jz[k]));
+	sum += GATHERSUM(g[5], k, (sx*ty*sz), (x[k]-jx[k]), (y[k]-iy[k]), (z[k]-jz[k]));
+	sum += GATHERSUM(g[6], k, (tx*sy*sz), (x[k]-ix[k]), (y[k]-jy[k]), (z[k]-jz[k]));
+	sum += GATHERSUM(g[7], k, (sx*sy*sz), (x[k]-jx[k]), (y[k]-jy[k]), (z[k]-jz[k]));
+	values[k] = sum;
+    }
+}
+
+
+/* copy up to NOISE_BLOCK packed points starting at s into xs, ys and
+ * zs, returning how many */
+static size_t
+noise_load_block(fastf_t *xs, fastf_t *ys, fastf_t *zs, const fastf_t *pnts, size_t s, size_t n)
+{
+    size_t k, b = (n - s < NOISE_BLOCK) ? n - s : NOISE_BLOCK;
+
+    for (k = 0; k < b; k++) {
+	xs[k] = pnts[3*(s+k)];
+	ys[k] = pnts[3*(s+k)+1];
+	zs[k] = pnts[3*(s+k)+2];
+    }
+    return b;
+}
+
+
+static void
+noise_scale_block(fastf_t *xs, fastf_t *ys, fastf_t *zs, size_t b, double s)
+{
+    size_t k;
+
+    for (k = 0; k < b; k++) {
+	xs[k] *= s;
+	ys[k] *= s;
+	zs[k] *= s;
+    }
+}
+
+
+void
+bn_noise_perlin_n(double *values, const fastf_t *pnts, size_t n)
+{
+    fastf_t xs[NOISE_BLOCK], ys[NOISE_BLOCK], zs[NOISE_BLOCK];
+    size_t s;
+
+    if (!values || !pnts)
+	return;
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    for (s = 0; s < n; s += NOISE_BLOCK) {
+	size_t b = noise_load_block(xs, ys, zs, pnts, s, n);
+	noise_perlin_block(&values[s], xs, ys, zs, b);
+    }
+}
+
+
 /**
  * Spectral Noise functions
  *
@@ -422,10 +578,25 @@ struct fbm_spec {
 };
 #define MAGIC_fbm_spec_wgt 0x837592
 
-static struct fbm_spec *etbl = (struct fbm_spec *)NULL;
+/* the tables are allocated one at a time and never move, so a
+ * thread can hold on to one while another adds to etbl */
+static struct fbm_spec **etbl = (struct fbm_spec **)NULL;
 static int etbl_next = 0;
 static int etbl_size = 0;
 
+/* Each thread remembers the tables it was last handed, keyed on the
+ * exact parameters asked for, so repeat lookups neither search etbl
+ * nor wait on sem_noise. */
+#define SPEC_CACHE 4
+struct spec_cache_entry {
+    double h_val;
+    double lacunarity;
+    double octaves;
+    struct fbm_spec *ep;
+};
+static THREADLOCAL struct spec_cache_entry spec_cache[SPEC_CACHE];
+static THREADLOCAL int spec_cache_next = 0;
+
 #define PSCALE(_p, _s) _p[0] *= _s; _p[1] *= _s; _p[2] *= _s
 #define PCOPY(_d, _s) _d[0] = _s[0]; _d[1] = _s[1]; _d[2] = _s[2]
 
@@ -447,19 +618,19 @@ build_spec_tbl(double h_val, double lacunarity, double octaves)
     if (etbl_next >= etbl_size) {
 	if (etbl_size) {
 	    etbl_size *= 2;
-	    etbl = (struct fbm_spec *)bu_realloc((void *)etbl,
-						 etbl_size*sizeof(struct fbm_spec),
-						 "spectral weights table");
+	    etbl = (struct fbm_spec **)bu_realloc((void *)etbl,
+						  etbl_size*sizeof(struct fbm_spec *),
+						  "spectral weights table");
 	} else {
 	    etbl_size = 128;
-	    etbl = (struct fbm_spec *)bu_calloc(etbl_size,
-						sizeof(struct fbm_spec),
-						"spectral weights table");
+	    etbl = (struct fbm_spec **)bu_calloc(etbl_size,
+						 sizeof(struct fbm_spec *),
+						 "spectral weights table");
 	}
     }
 
     /* set up the next available table */
-    ep = &etbl[etbl_next];
+    BU_ALLOC(ep, struct fbm_spec);
     ep->h_val = h_val;
     ep->lacunarity = lacunarity;
     ep->octaves = octaves;
@@ -473,7 +644,8 @@ build_spec_tbl(double h_val, double lacunarity, double octaves)
 	frequency *= lacunarity;
     }
 
-    etbl_next++; /* saved for last in case we're running multi-threaded */
+    etbl[etbl_next] = ep;
+    etbl_next++;
     return ep;
 }
 
@@ -490,29 +662,25 @@ find_spec_wgt(double h, double l, double o)
     struct fbm_spec *ep = NULL;
     int i;
 
-    for (i=0; i < etbl_next; i++) {
-	ep = &etbl[i];
-	if (ep->magic != MAGIC_fbm_spec_wgt)
-	    bu_bomb("find_spec_wgt");
-	if (EQUAL(ep->lacunarity, l)
-	    && EQUAL(ep->h_val, h)
-	    && (ep->octaves > o || EQUAL(ep->octaves, o)))
-	{
-	    return ep;
-	}
+    /* This thread asked for exactly these before, and tables are only
+     * ever added after the ones already there, so the search below
+     * would find the same one again */
+    for (i = 0; i < SPEC_CACHE; i++) {
+	struct spec_cache_entry *ce = &spec_cache[i];
+	if (ce->ep && ce->h_val == h && ce->lacunarity == l && ce->octaves == o)
+	    return ce->ep;
     }
 
-    /* we didn't find the table we wanted so we've got to semaphore on
-     * the list to wait our turn to add what we want to the table.
+    /* The table list may be growing in another thread, so search it
+     * while we hold the semaphore and add what we want if it isn't
+     * there.
      */
-
+    if (!sem_noise)
+	bn_noise_init();
     bu_semaphore_acquire(sem_noise);
 
-    /* We search the list one more time in case the last process to
-     * hold the semaphore just created the table we were about to add
-     */
     for (i=0; i < etbl_next; i++) {
-	ep = &etbl[i];
+	ep = etbl[i];
 	if (ep->magic != MAGIC_fbm_spec_wgt)
 	    bu_bomb("find_spec_wgt");
 	if (EQUAL(ep->lacunarity, l)
@@ -528,6 +696,12 @@ find_spec_wgt(double h, double l, double o)
 
     bu_semaphore_release(sem_noise);
 
+    spec_cache[spec_cache_next].h_val = h;
+    spec_cache[spec_cache_next].lacunarity = l;
+    spec_cache[spec_cache_next].octaves = o;
+    spec_cache[spec_cache_next].ep = ep;
+    spec_cache_next = (spec_cache_next + 1) % SPEC_CACHE;
+
     return ep;
 }
 
@@ -733,6 +907,154 @@ bn_noise_mf(point_t point, double h_val, double lacunarity, double octaves, doub
     return result;
 }
 
+
+void
+bn_noise_fbm_n(double *values, const fastf_t *pnts, size_t n, double h_val, double lacunarity, double octaves)
+{
+    fastf_t xs[NOISE_BLOCK], ys[NOISE_BLOCK], zs[NOISE_BLOCK];
+    double nv[NOISE_BLOCK];
+    double noise_remainder, *spec_wgts;
+    size_t s, k;
+    int i, oct;
+
+    if (!values || !pnts || !n)
+	return;
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    /* one table lookup for all the points */
+    spec_wgts = find_spec_wgt(h_val, lacunarity, octaves)->spec_wgts;
+    oct = (int)octaves;
+    noise_remainder = octaves - (int)octaves;
+
+    for (s = 0; s < n; s += NOISE_BLOCK) {
+	size_t b = noise_load_block(xs, ys, zs, pnts, s, n);
+	double *value = &values[s];
+
+	for (k = 0; k < b; k++)
+	    value[k] = 0.0;
+
+	/* inner loop of spectral construction, as bn_noise_fbm() */
+	for (i = 0; i < oct; i++) {
+	    noise_perlin_block(nv, xs, ys, zs, b);
+	    for (k = 0; k < b; k++)
+		value[k] += nv[k] * spec_wgts[i];
+	    noise_scale_block(xs, ys, zs, b, lacunarity);
+	}
+
+	if (!ZERO(noise_remainder)) {
+	    noise_perlin_block(nv, xs, ys, zs, b);
+	    for (k = 0; k < b; k++)
+		value[k] += noise_remainder * nv[k] * spec_wgts[i];
+	}
+    }
+}
+
+
+void
+bn_noise_turb_n(double *values, const fastf_t *pnts, size_t n, double h_val, double lacunarity, double octaves)
+{
+    fastf_t xs[NOISE_BLOCK], ys[NOISE_BLOCK], zs[NOISE_BLOCK];
+    double nv[NOISE_BLOCK];
+    double noise_remainder, *spec_wgts;
+    size_t s, k;
+    int i, oct;
+
+    if (!values || !pnts || !n)
+	return;
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    spec_wgts = find_spec_wgt(h_val, lacunarity, octaves)->spec_wgts;
+    oct = (int)octaves;
+    noise_remainder = octaves - (int)octaves;
+
+    for (s = 0; s < n; s += NOISE_BLOCK) {
+	size_t b = noise_load_block(xs, ys, zs, pnts, s, n);
+	double *value = &values[s];
+
+	for (k = 0; k < b; k++)
+	    value[k] = 0.0;
+
+	for (i = 0; i < oct; i++) {
+	    noise_perlin_block(nv, xs, ys, zs, b);
+	    for (k = 0; k < b; k++)
+		value[k] += fabs(nv[k]) * spec_wgts[i];
+	    noise_scale_block(xs, ys, zs, b, lacunarity);
+	}
+
+	/* bn_noise_turb() adds the remainder octave without fabs() */
+	if (!ZERO(noise_remainder)) {
+	    noise_perlin_block(nv, xs, ys, zs, b);
+	    for (k = 0; k < b; k++)
+		value[k] += noise_remainder * nv[k] * spec_wgts[i];
+	}
+    }
+}
+
+
+void
+bn_noise_ridged_n(double *values, const fastf_t *pnts, size_t n, double h_val, double lacunarity, double octaves, double offset)
+{
+    fastf_t xs[NOISE_BLOCK], ys[NOISE_BLOCK], zs[NOISE_BLOCK];
+    double nv[NOISE_BLOCK];
+    double *spec_wgts;
+    size_t s, k;
+    int i;
+
+    if (!values || !pnts || !n)
+	return;
+    if (!ht.hashTableValid)
+	bn_noise_init();
+
+    spec_wgts = find_spec_wgt(h_val, lacunarity, octaves)->spec_wgts;
+
+    for (s = 0; s < n; s += NOISE_BLOCK) {
+	size_t b = noise_load_block(xs, ys, zs, pnts, s, n);
+	double *result = &values[s];
+
+	/* first octave, squared to sharpen the ridges */
+	noise_perlin_block(nv, xs, ys, zs, b);
+	for (k = 0; k < b; k++) {
+	    double noise_signal = nv[k];
+	    if (noise_signal < 0.0) noise_signal = -noise_signal;
+	    noise_signal = offset - noise_signal;
+	    noise_signal *= noise_signal;
+	    result[k] = noise_signal;
+	}
+
+	/* bn_noise_ridged()'s weight stays 1.0, so it is left out */
+	for (i = 1; i < octaves; i++) {
+	    noise_scale_block(xs, ys, zs, b, lacunarity);
+	    noise_perlin_block(nv, xs, ys, zs, b);
+	    for (k = 0; k < b; k++) {
+		double noise_signal = nv[k];
+		if (noise_signal < 0.0) noise_signal = - noise_signal;
+		noise_signal = offset - noise_signal;
+		result[k] += noise_signal * spec_wgts[i];
+	    }
+	}
+    }
+}
+
+
+void
+bn_noise_mf_n(double *values, const fastf_t *pnts, size_t n, double h_val, double lacunarity, double octaves, double UNUSED(offset))
+{
+    double *spec_wgts;
+    size_t k;
+
+    if (!values || !pnts || !n)
+	return;
+
+    spec_wgts = find_spec_wgt(h_val, lacunarity, octaves)->spec_wgts;
+
+    /* only the first octave contributes, see bn_noise_mf() */
+    bn_noise_perlin_n(values, pnts, n);
+    for (k = 0; k < n; k++)
+	values[k] = (values[k] + 1.0) * spec_wgts[0];
+}
+
 /** @} */
 /*
  * Local Variables:
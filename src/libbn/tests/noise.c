@@ -0,0 +1,208 @@
+/*                         N O I S E . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file noise.c
+ *
+ * Evaluates the batch noise functions over random points, some of
+ * them negative, huge or sitting on lattice planes, and fails unless
+ * every result is bit for bit what the single point function returns.
+ * A larger batch is also timed against a loop of single point calls.
+ *
+ * Usage: bn_noise [points]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/exit.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/time.h"
+#include "vmath.h"
+#include "bn/noise.h"
+#include "bn/randmt.h"
+
+#define NOISE_PERLIN 0
+#define NOISE_FBM 1
+#define NOISE_TURB 2
+#define NOISE_MF 3
+#define NOISE_RIDGED 4
+
+static const char *noise_names[] = {"perlin", "fbm", "turb", "mf", "ridged"};
+
+/* h_val, lacunarity and octaves, fractional octaves included */
+static const double noise_params[][3] = {
+    {1.0, 2.1753974, 4.0},
+    {0.5, 2.0, 6.5},
+    {1.2, 1.7, 1.25}
+};
+
+
+static void
+noise_test_pnts(fastf_t *pnts, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+	fastf_t *p = &pnts[3*i];
+	VSET(p, (bn_randmt() - 0.5) * 200.0, (bn_randmt() - 0.5) * 200.0, (bn_randmt() - 0.5) * 200.0);
+	if (i % 17 == 0)
+	    p[X] = floor(p[X]);
+	if (i % 29 == 0)
+	    p[Y] *= 1.0e9;
+    }
+}
+
+
+static double
+noise_one(int f, fastf_t *p, const double *prm)
+{
+    switch (f) {
+	case NOISE_PERLIN:
+	    return bn_noise_perlin(p);
+	case NOISE_FBM:
+	    return bn_noise_fbm(p, prm[0], prm[1], prm[2]);
+	case NOISE_TURB:
+	    return bn_noise_turb(p, prm[0], prm[1], prm[2]);
+	case NOISE_MF:
+	    return bn_noise_mf(p, prm[0], prm[1], prm[2], 1.0);
+	default:
+	    return bn_noise_ridged(p, prm[0], prm[1], prm[2], 1.0);
+    }
+}
+
+
+static void
+noise_batch(int f, double *values, const fastf_t *pnts, size_t n, const double *prm)
+{
+    switch (f) {
+	case NOISE_PERLIN:
+	    bn_noise_perlin_n(values, pnts, n);
+	    break;
+	case NOISE_FBM:
+	    bn_noise_fbm_n(values, pnts, n, prm[0], prm[1], prm[2]);
+	    break;
+	case NOISE_TURB:
+	    bn_noise_turb_n(values, pnts, n, prm[0], prm[1], prm[2]);
+	    break;
+	case NOISE_MF:
+	    bn_noise_mf_n(values, pnts, n, prm[0], prm[1], prm[2], 1.0);
+	    break;
+	default:
+	    bn_noise_ridged_n(values, pnts, n, prm[0], prm[1], prm[2], 1.0);
+	    break;
+    }
+}
+
+
+/* compare the batch against single point calls, bit for bit */
+static int
+noise_test_check(int f, const fastf_t *pnts, size_t n, const double *prm)
+{
+    double *values = (double *)bu_malloc(n * sizeof(double), "batch values");
+    size_t i;
+    int bad = 0;
+
+    noise_batch(f, values, pnts, n, prm);
+    for (i = 0; i < n; i++) {
+	point_t p;
+	double v;
+
+	VMOVE(p, &pnts[3*i]);
+	v = noise_one(f, p, prm);
+	if (memcmp(&v, &values[i], sizeof(double)) && bad++ < 10)
+	    bu_log("%s point %zu: batch %.17g, expected %.17g\n", noise_names[f], i, values[i], v);
+    }
+
+    bu_free(values, "batch values");
+    return bad;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    fastf_t *pnts;
+    double *values;
+    size_t i, n = 200000;
+    int f, k, bad = 0;
+
+    bu_setprogname(argv[0]);
+    if (argc > 2)
+	bu_exit(1, "Usage: %s [points]\n", argv[0]);
+    if (argc == 2)
+	n = (size_t)atol(argv[1]);
+    if (n < 1)
+	bu_exit(1, "Usage: %s [points]\n", argv[0]);
+
+    bn_randmt_seed(5489);
+
+    /* odd counts so the last block is partial */
+    pnts = (fastf_t *)bu_malloc(1001 * 3 * sizeof(fastf_t), "points");
+    noise_test_pnts(pnts, 1001);
+    for (f = NOISE_PERLIN; f <= NOISE_RIDGED; f++) {
+	for (k = 0; k < (int)(sizeof(noise_params)/sizeof(noise_params[0])); k++)
+	    bad += noise_test_check(f, pnts, 1001, noise_params[k]);
+    }
+    bu_free(pnts, "points");
+
+    pnts = (fastf_t *)bu_malloc(n * 3 * sizeof(fastf_t), "points");
+    values = (double *)bu_malloc(n * sizeof(double), "values");
+    noise_test_pnts(pnts, n);
+    for (f = NOISE_PERLIN; f <= NOISE_RIDGED; f++) {
+	int64_t start;
+	double tone, tbatch;
+
+	start = bu_gettime();
+	for (i = 0; i < n; i++) {
+	    point_t p;
+	    VMOVE(p, &pnts[3*i]);
+	    values[i] = noise_one(f, p, noise_params[0]);
+	}
+	tone = (bu_gettime() - start) / 1000000.0;
+
+	start = bu_gettime();
+	noise_batch(f, values, pnts, n, noise_params[0]);
+	tbatch = (bu_gettime() - start) / 1000000.0;
+
+	bu_log("%s, %zu points: single %.3fs, batch %.3fs, %.2fx\n", noise_names[f], n,
+	       tone, tbatch, (tbatch > 0) ? tone / tbatch : 0.0);
+    }
+    bu_free(values, "values");
+    bu_free(pnts, "points");
+
+    if (bad)
+	bu_log("%d results differ\n", bad);
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
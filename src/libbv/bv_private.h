@@ -28,6 +28,7 @@
 #include "bu/ptbl.h"
 #include "bv/defines.h"
 #include <unordered_map>
+#include <vector>
 
 struct bview_set_internal {
     struct bu_ptbl views;
@@ -40,8 +41,17 @@ struct bview_set_internal {
 
 struct bv_scene_obj_internal {
     std::unordered_map<struct bview *, struct bv_scene_obj *> vobjs;
+    // Incremented when the object is reset or marked stale, so the scene
+    // BVH knows to recompute its bounds
+    size_t gen = 0;
 };
 
+/* Scene BVH (scene_bvh.cpp) queries used by the selection and bounding
+ * routines */
+extern int bv_scene_bvh_bounds(struct bview *v, point_t *min, point_t *max);
+extern size_t bv_scene_bvh_select(std::vector<struct bv_scene_obj *> &active, struct bview *v, point_t obb_c, vect_t obb_e1, vect_t obb_e2, vect_t obb_e3);
+extern void bv_scene_bvh_free(struct bview *v);
+
 // Local Variables:
 // tab-width: 8
 // mode: C++
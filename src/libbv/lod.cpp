@@ -93,6 +93,7 @@ extern "C" {
 #include "bv/lod.h"
 #include "bv/util.h"
 #include "bv/view_sets.h"
+#include "./bv_private.h"
 
 // Number of levels of detail to define
 #define POP_MAXLEVEL 16
@@ -129,27 +130,6 @@ extern "C" {
 
 typedef int (*full_detail_clbk_t)(struct bv_mesh_lod *, void *);
 
-static void
-obj_bb(int *have_objs, vect_t *min, vect_t *max, struct bv_scene_obj *s, struct bview *v)
-{
-    vect_t minus, plus;
-    if (bv_scene_obj_bound(s, v)) {
-	*have_objs = 1;
-	minus[X] = s->s_center[X] - s->s_size;
-	minus[Y] = s->s_center[Y] - s->s_size;
-	minus[Z] = s->s_center[Z] - s->s_size;
-	VMIN(*min, minus);
-	plus[X] = s->s_center[X] + s->s_size;
-	plus[Y] = s->s_center[Y] + s->s_size;
-	plus[Z] = s->s_center[Z] + s->s_size;
-	VMAX(*max, plus);
-    }
-    for (size_t i = 0; i < BU_PTBL_LEN(&s->children); i++) {
-	struct bv_scene_obj *sc = (struct bv_scene_obj *)BU_PTBL_GET(&s->children, i);
-	obj_bb(have_objs, min, max, sc, v);
-    }
-}
-
 // Debugging function to see constructed arb
 #define ARB_MAX_STRLEN 400
 const char *
@@ -242,24 +222,9 @@ _scene_radius(point_t *sbbc, fastf_t *radius, struct bview *v)
     VSET(*sbbc, 0, 0, 0);
     *radius = 1.0;
     vect_t min, max, work;
-    VSETALL(min,  INFINITY);
-    VSETALL(max, -INFINITY);
-    int have_objs = 0;
-    struct bu_ptbl *so = bv_view_objs(v, BV_DB_OBJS);
-    if (!so)
-	return;
-    for (size_t i = 0; i < BU_PTBL_LEN(so); i++) {
-	struct bv_scene_obj *g = (struct bv_scene_obj *)BU_PTBL_GET(so, i);
-	obj_bb(&have_objs, &min, &max, g, v);
-    }
-    struct bu_ptbl *sol = bv_view_objs(v, BV_DB_OBJS | BV_LOCAL_OBJS);
-    if (sol) {
-	for (size_t i = 0; i < BU_PTBL_LEN(sol); i++) {
-	    struct bv_scene_obj *g = (struct bv_scene_obj *)BU_PTBL_GET(sol, i);
-	    obj_bb(&have_objs, &min, &max, g, v);
-	}
-    }
-    if (have_objs) {
+    // The scene BVH keeps the bounds of every object, recomputing only
+    // those of objects that changed since the last query
+    if (bv_scene_bvh_bounds(v, &min, &max)) {
 	VADD2SCALE(*sbbc, max, min, 0.5);
 	VSUB2SCALE(work, max, min, 0.5);
 	(*radius) = MAGNITUDE(work);
@@ -339,21 +304,6 @@ bv_view_bounds(struct bview *v)
     v->radius = radius;
 }
 
-static void
-_find_active_objs(std::set<struct bv_scene_obj *> &active, struct bv_scene_obj *s, struct bview *v, point_t obb_c, point_t obb_e1, point_t obb_e2, point_t obb_e3)
-{
-    if (BU_PTBL_LEN(&s->children)) {
-	for (size_t i = 0; i < BU_PTBL_LEN(&s->children); i++) {
-	    struct bv_scene_obj *sc = (struct bv_scene_obj *)BU_PTBL_GET(&s->children, i);
-	    _find_active_objs(active, sc, v, obb_c, obb_e1, obb_e2, obb_e3);
-	}
-    } else {
-	bv_scene_obj_bound(s, v);
-	if (bg_sat_aabb_obb(s->bmin, s->bmax, obb_c, obb_e1, obb_e2, obb_e3))
-	    active.insert(s);
-    }
-}
-
 int
 bv_view_objs_select(struct bu_ptbl *sset, struct bview *v, int x, int y)
 {
@@ -419,29 +369,11 @@ bv_view_objs_select(struct bu_ptbl *sset, struct bview *v, int x, int y)
     VSUB2(obb_e2, ep1, ec);
     VSUB2(obb_e3, ep2, ec);
 
-    // Having constructed the box, test the scene objects against it.  Any that intersect,
-    // add them to the set
-    std::set<struct bv_scene_obj *> active;
-    struct bu_ptbl *so = bv_view_objs(v, BV_DB_OBJS);
-    if (so) {
-	for (size_t i = 0; i < BU_PTBL_LEN(so); i++) {
-	    struct bv_scene_obj *s = (struct bv_scene_obj *)BU_PTBL_GET(so, i);
-	    _find_active_objs(active, s, v, obb_c, obb_e1, obb_e2, obb_e3);
-	}
-    }
-    struct bu_ptbl *sol = bv_view_objs(v, BV_DB_OBJS | BV_LOCAL_OBJS);
-    if (sol) {
-	for (size_t i = 0; i < BU_PTBL_LEN(sol); i++) {
-	    struct bv_scene_obj *s = (struct bv_scene_obj *)BU_PTBL_GET(sol, i);
-	    _find_active_objs(active, s, v, obb_c, obb_e1, obb_e2, obb_e3);
-	}
-    }
-    if (active.size()) {
-	std::set<struct bv_scene_obj *>::iterator a_it;
-	for (a_it = active.begin(); a_it != active.end(); a_it++) {
-	    bu_ptbl_ins(sset, (long *)*a_it);
-	}
-    }
+    // Having constructed the box, find the scene objects intersecting it.
+    std::vector<struct bv_scene_obj *> active;
+    bv_scene_bvh_select(active, v, obb_c, obb_e1, obb_e2, obb_e3);
+    for (size_t i = 0; i < active.size(); i++)
+	bu_ptbl_ins(sset, (long *)active[i]);
 
     return active.size();
 }
@@ -517,29 +449,11 @@ bv_view_objs_rect_select(struct bu_ptbl *sset, struct bview *v, int x1, int y1,
     bu_log("%s", obb_arb(obb_c, obb_e1, obb_e2, obb_e3));
 #endif
 
-    // Having constructed the box, test the scene objects against it.  Any that intersect,
-    // add them to the set
-    std::set<struct bv_scene_obj *> active;
-    struct bu_ptbl *so = bv_view_objs(v, BV_DB_OBJS);
-    if (so) {
-	for (size_t i = 0; i < BU_PTBL_LEN(so); i++) {
-	    struct bv_scene_obj *s = (struct bv_scene_obj *)BU_PTBL_GET(so, i);
-	    _find_active_objs(active, s, v, obb_c, obb_e1, obb_e2, obb_e3);
-	}
-    }
-    struct bu_ptbl *sol = bv_view_objs(v, BV_DB_OBJS | BV_LOCAL_OBJS);
-    if (sol) {
-	for (size_t i = 0; i < BU_PTBL_LEN(sol); i++) {
-	    struct bv_scene_obj *s = (struct bv_scene_obj *)BU_PTBL_GET(sol, i);
-	    _find_active_objs(active, s, v, obb_c, obb_e1, obb_e2, obb_e3);
-	}
-    }
-    if (active.size()) {
-	std::set<struct bv_scene_obj *>::iterator a_it;
-	for (a_it = active.begin(); a_it != active.end(); a_it++) {
-	    bu_ptbl_ins(sset, (long *)*a_it);
-	}
-    }
+    // Having constructed the box, find the scene objects intersecting it.
+    std::vector<struct bv_scene_obj *> active;
+    bv_scene_bvh_select(active, v, obb_c, obb_e1, obb_e2, obb_e3);
+    for (size_t i = 0; i < active.size(); i++)
+	bu_ptbl_ins(sset, (long *)active[i]);
 
     return active.size();
 }
@@ -595,13 +509,10 @@ _obj_visible(struct bv_scene_obj *s, struct bview *v)
 }
 
 struct bv_mesh_lod_context_internal {
+    // Transactions are per call rather than per context, so several
+    // threads may generate and read LoD data through one context
     MDB_env *lod_env;
-    MDB_txn *lod_txn;
-    MDB_dbi lod_dbi;
-
     MDB_env *name_env;
-    MDB_txn *name_txn;
-    MDB_dbi name_dbi;
 
     struct bu_vls *fname;
 };
@@ -748,6 +659,8 @@ bv_mesh_lod_key_get(struct bv_mesh_lod_context *c, const char *name)
     if (!c || !name)
 	return 0;
 
+    MDB_txn *txn;
+    MDB_dbi dbi;
     MDB_val mdb_key, mdb_data;
 
     // Database object names may be of arbitrary length - hash
@@ -762,18 +675,23 @@ bv_mesh_lod_key_get(struct bv_mesh_lod_context *c, const char *name)
     unsigned long long hash = bu_data_hash(bu_vls_cstr(&keystr), bu_vls_strlen(&keystr)*sizeof(char));
     bu_vls_sprintf(&keystr, "%llu", hash);
 
-    mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-    mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
+    // A read-only transaction, so lookups don't wait on LoD writers
+    if (mdb_txn_begin(c->i->name_env, NULL, MDB_RDONLY, &txn)) {
+	bu_vls_free(&keystr);
+	return 0;
+    }
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = bu_vls_strlen(&keystr)*sizeof(char);
     mdb_key.mv_data = (void *)bu_vls_cstr(&keystr);
-    int rc = mdb_get(c->i->name_txn, c->i->name_dbi, &mdb_key, &mdb_data);
+    int rc = mdb_get(txn, dbi, &mdb_key, &mdb_data);
     if (rc) {
-	mdb_txn_commit(c->i->name_txn);
+	mdb_txn_abort(txn);
+	bu_vls_free(&keystr);
 	return 0;
     }
     unsigned long long *fkeyp = (unsigned long long *)mdb_data.mv_data;
     unsigned long long fkey = *fkeyp;
-    mdb_txn_commit(c->i->name_txn);
+    mdb_txn_abort(txn);
 
     bu_vls_free(&keystr);
     //bu_log("GOT %s: %llu\n", name, fkey);
@@ -798,18 +716,20 @@ bv_mesh_lod_key_put(struct bv_mesh_lod_context *c, const char *name, unsigned lo
     unsigned long long hash = bu_data_hash(bu_vls_cstr(&keystr), bu_vls_strlen(&keystr)*sizeof(char));
     bu_vls_sprintf(&keystr, "%llu", hash);
 
+    MDB_txn *txn;
+    MDB_dbi dbi;
     MDB_val mdb_key;
     MDB_val mdb_data[2];
-    mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-    mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
+    mdb_txn_begin(c->i->name_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = bu_vls_strlen(&keystr)*sizeof(char);
     mdb_key.mv_data = (void *)bu_vls_cstr(&keystr);
     mdb_data[0].mv_size = sizeof(key);
     mdb_data[0].mv_data = (void *)&key;
     mdb_data[1].mv_size = 0;
     mdb_data[1].mv_data = NULL;
-    int rc = mdb_put(c->i->name_txn, c->i->name_dbi, &mdb_key, mdb_data, 0);
-    mdb_txn_commit(c->i->name_txn);
+    int rc = mdb_put(txn, dbi, &mdb_key, mdb_data, 0);
+    mdb_txn_commit(txn);
 
     bu_vls_free(&keystr);
     //bu_log("PUT %s: %llu\n", name, key);
@@ -930,6 +850,8 @@ class POPState {
 	size_t cache_get(void **data, const char *component);
 	void cache_done();
 	void cache_del(const char *component);
+	MDB_txn *txn = NULL;
+	MDB_dbi dbi;
 	MDB_val mdb_key, mdb_data[2];
 
 	// Specific loading and unloading methods
@@ -1544,16 +1466,16 @@ POPState::cache_write(const char *component, std::stringstream &s)
     char *keycstr = bu_strdup(keystr.c_str());
     void *bdata = bu_calloc(buffer.length()+1, sizeof(char), "bdata");
     memcpy(bdata, buffer.data(), buffer.length()*sizeof(char));
-    mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-    mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
+    mdb_txn_begin(c->i->lod_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = keystr.length()*sizeof(char);
     mdb_key.mv_data = (void *)keycstr;
     mdb_data[0].mv_size = buffer.length()*sizeof(char);
     mdb_data[0].mv_data = bdata;
     mdb_data[1].mv_size = 0;
     mdb_data[1].mv_data = NULL;
-    int rc = mdb_put(c->i->lod_txn, c->i->lod_dbi, &mdb_key, mdb_data, 0);
-    mdb_txn_commit(c->i->lod_txn);
+    int rc = mdb_put(txn, dbi, &mdb_key, mdb_data, 0);
+    mdb_txn_commit(txn);
     bu_free(keycstr, "keycstr");
     bu_free(bdata, "buffer data");
 
@@ -1574,12 +1496,18 @@ POPState::cache_get(void **data, const char *component)
     // the default size limit (511)
     //if (keystr.length()*sizeof(char) > mdb_env_get_maxkeysize(c->i->lod_env))
     //	return 0;
+    // Read-only, so several threads can load LoD data at once without
+    // waiting on each other or on a writer
+    if (mdb_txn_begin(c->i->lod_env, NULL, MDB_RDONLY, &txn)) {
+	txn = NULL;
+	(*data) = NULL;
+	return 0;
+    }
     char *keycstr = bu_strdup(keystr.c_str());
-    mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-    mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = keystr.length()*sizeof(char);
     mdb_key.mv_data = (void *)keycstr;
-    int rc = mdb_get(c->i->lod_txn, c->i->lod_dbi, &mdb_key, &mdb_data[0]);
+    int rc = mdb_get(txn, dbi, &mdb_key, &mdb_data[0]);
     if (rc) {
 	bu_free(keycstr, "keycstr");
 	(*data) = NULL;
@@ -1594,7 +1522,9 @@ POPState::cache_get(void **data, const char *component)
 void
 POPState::cache_done()
 {
-    mdb_txn_commit(c->i->lod_txn);
+    if (txn)
+	mdb_txn_abort(txn);
+    txn = NULL;
 }
 
 bool
@@ -2067,15 +1997,17 @@ static void
 cache_del(struct bv_mesh_lod_context *c, unsigned long long hash, const char *component)
 {
     // Construct lookup key
+    MDB_txn *txn;
+    MDB_dbi dbi;
     MDB_val mdb_key;
     std::string keystr = std::to_string(hash) + std::string(":") + std::string(component);
 
-    mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-    mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
+    mdb_txn_begin(c->i->lod_env, NULL, 0, &txn);
+    mdb_dbi_open(txn, NULL, 0, &dbi);
     mdb_key.mv_size = keystr.length()*sizeof(char);
     mdb_key.mv_data = (void *)keystr.c_str();
-    mdb_del(c->i->lod_txn, c->i->lod_dbi, &mdb_key, NULL);
-    mdb_txn_commit(c->i->lod_txn);
+    mdb_del(txn, dbi, &mdb_key, NULL);
+    mdb_txn_commit(txn);
 }
 
 
@@ -2083,6 +2015,8 @@ extern "C" void
 bv_mesh_lod_clear_cache(struct bv_mesh_lod_context *c, unsigned long long key)
 {
     char dir[MAXPATHLEN];
+    MDB_txn *txn;
+    MDB_dbi dbi;
 
     if (c && key) {
 	// For this case, we're clearing the data associated with a
@@ -2102,17 +2036,17 @@ bv_mesh_lod_clear_cache(struct bv_mesh_lod_context *c, unsigned long long key)
 	MDB_val mdb_key, mdb_data;
 	unsigned long long *fkeyp = NULL;
 	unsigned long long fkey = 0;
-	mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-	mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
+	mdb_txn_begin(c->i->name_env, NULL, 0, &txn);
+	mdb_dbi_open(txn, NULL, 0, &dbi);
 	MDB_cursor *cursor;
-	int rc = mdb_cursor_open(c->i->name_txn, c->i->name_dbi, &cursor);
+	int rc = mdb_cursor_open(txn, dbi, &cursor);
 	if (rc) {
-	    mdb_txn_commit(c->i->name_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	rc = mdb_cursor_get(cursor, &mdb_key, &mdb_data, MDB_FIRST);
 	if (rc) {
-	    mdb_txn_commit(c->i->name_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	fkeyp = (unsigned long long *)mdb_data.mv_data;
@@ -2125,7 +2059,7 @@ bv_mesh_lod_clear_cache(struct bv_mesh_lod_context *c, unsigned long long key)
 	    if (fkey == key)
 		mdb_cursor_del(cursor, 0);
 	}
-	mdb_txn_commit(c->i->name_txn);
+	mdb_txn_commit(txn);
 	return;
     }
 
@@ -2136,41 +2070,41 @@ bv_mesh_lod_clear_cache(struct bv_mesh_lod_context *c, unsigned long long key)
 	int rc;
 
 	// Clear the actual LoD data
-	mdb_txn_begin(c->i->lod_env, NULL, 0, &c->i->lod_txn);
-	mdb_dbi_open(c->i->lod_txn, NULL, 0, &c->i->lod_dbi);
-	rc = mdb_cursor_open(c->i->lod_txn, c->i->lod_dbi, &cursor);
+	mdb_txn_begin(c->i->lod_env, NULL, 0, &txn);
+	mdb_dbi_open(txn, NULL, 0, &dbi);
+	rc = mdb_cursor_open(txn, dbi, &cursor);
 	if (rc) {
-	    mdb_txn_commit(c->i->lod_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	rc = mdb_cursor_get(cursor, &mdb_key, &mdb_data, MDB_FIRST);
 	if (rc) {
-	    mdb_txn_commit(c->i->lod_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	mdb_cursor_del(cursor, 0);
 	while (!mdb_cursor_get(cursor, &mdb_key, &mdb_data, MDB_NEXT))
 	    mdb_cursor_del(cursor, 0);
-	mdb_txn_commit(c->i->lod_txn);
+	mdb_txn_commit(txn);
 
 	// Iterate over the name/key mapper, removing anything with a value
 	// of key
-	mdb_txn_begin(c->i->name_env, NULL, 0, &c->i->name_txn);
-	mdb_dbi_open(c->i->name_txn, NULL, 0, &c->i->name_dbi);
-	rc = mdb_cursor_open(c->i->name_txn, c->i->name_dbi, &cursor);
+	mdb_txn_begin(c->i->name_env, NULL, 0, &txn);
+	mdb_dbi_open(txn, NULL, 0, &dbi);
+	rc = mdb_cursor_open(txn, dbi, &cursor);
 	if (rc) {
-	    mdb_txn_commit(c->i->name_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	rc = mdb_cursor_get(cursor, &mdb_key, &mdb_data, MDB_FIRST);
 	if (rc) {
-	    mdb_txn_commit(c->i->name_txn);
+	    mdb_txn_commit(txn);
 	    return;
 	}
 	mdb_cursor_del(cursor, 0);
 	while (!mdb_cursor_get(cursor, &mdb_key, &mdb_data, MDB_NEXT))
 	    mdb_cursor_del(cursor, 0);
-	mdb_txn_commit(c->i->name_txn);
+	mdb_txn_commit(txn);
 
 	return;
     }
@@ -0,0 +1,565 @@
+/*                   S C E N E _ B V H . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file scene_bvh.cpp
+ *
+ * Per-view bounding volume hierarchy over the scene objects, used for
+ * point and rectangle selection and for view culling.
+ *
+ * The hierarchy is brought up to date lazily, at the start of each
+ * query, by walking the view's object tables.  That walk only compares
+ * a cheap per-object signature (the vlist chunk layout, the matrix,
+ * the draw data and the change counters) against what was recorded
+ * last time - bounding boxes are recomputed only for objects whose
+ * signature changed, which then refit the tree.  Objects that appear
+ * are kept in a short pending list and objects that disappear are
+ * dropped from their leaves; the tree is rebuilt only once enough of
+ * either has accumulated.
+ */
+
+#include "common.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "vmath.h"
+#include "bu/list.h"
+#include "bu/log.h"
+#include "bu/ptbl.h"
+#include "bg/plane.h"
+#include "bg/sat.h"
+#include "bv/defines.h"
+#include "bv/lod.h"
+#include "bv/util.h"
+#include "bv/vlist.h"
+#include "./bv_private.h"
+
+// Maximum number of objects in a tree leaf
+#define BVH_LEAF_SIZE 4
+
+// Pixels added around the window when culling, so wide lines and
+// points right at the edge are not lost
+#define BVH_CULL_PAD 4
+
+// Factor by which to bump out the scene depth of the culling volume
+#define BVH_MBUMP 1.01
+
+/* What an object looked like when its bounds were last computed.  Any
+ * difference means the bounds must be recomputed. */
+struct bvh_sig {
+    struct bv_scene_obj *vo;
+    size_t gen;
+    size_t vgen;
+    int changed;
+    int leaf;
+    void *first;
+    void *last;
+    size_t nchunks;
+    size_t ncmds;
+    void *draw_data;
+    mat_t mat;
+};
+
+struct bvh_rec {
+    struct bv_scene_obj *s;	// NULL once the object has left the scene
+    struct bvh_sig sig;
+    size_t pass;		// last sync that saw this object
+    int valid;			// have bounds
+    int display;		// vlist holds display space coordinates
+    int in_tree;
+    int culled;
+    point_t bmin, bmax;		// AABB
+    point_t cmin, cmax;		// s_center +/- s_size cube, for the scene bounds
+};
+
+struct bvh_node {
+    point_t bmin, bmax;
+    size_t first, count;	// range of the order array under this node
+    size_t skip;		// next node after this subtree
+};
+
+struct bv_scene_bvh {
+    std::vector<struct bvh_rec> recs;
+    std::unordered_map<struct bv_scene_obj *, size_t> idx;
+    std::vector<size_t> order;		// tree leaf records
+    std::vector<size_t> pending;	// leaf records added since the build
+    std::vector<struct bvh_node> nodes;
+    size_t pass = 0;
+    size_t ndead = 0;
+    size_t nmoved = 0;
+    int refit = 0;
+    int culled = 0;			// the culled flags are current
+    int have_scene = 0;
+    point_t smin, smax;
+};
+
+
+static void
+bvh_sig_get(struct bvh_sig *sig, struct bv_scene_obj *s, struct bview *v)
+{
+    struct bv_scene_obj *vo = bv_obj_for_view(s, v);
+    struct bv_scene_obj *d = (vo) ? vo : s;
+    struct bv_vlist *vp;
+
+    memset(sig, 0, sizeof(struct bvh_sig));
+    sig->vo = vo;
+    sig->gen = (s->i) ? s->i->gen : 0;
+    sig->vgen = (vo && vo->i) ? vo->i->gen : 0;
+    sig->changed = d->s_changed;
+    sig->leaf = (BU_PTBL_LEN(&s->children)) ? 0 : 1;
+    sig->draw_data = d->draw_data;
+    MAT_COPY(sig->mat, d->s_mat);
+    if (!BU_LIST_IS_INITIALIZED(&d->s_vlist) || BU_LIST_IS_EMPTY(&d->s_vlist))
+	return;
+    sig->first = (void *)BU_LIST_FIRST(bu_list, &d->s_vlist);
+    sig->last = (void *)BU_LIST_LAST(bu_list, &d->s_vlist);
+    for (BU_LIST_FOR(vp, bv_vlist, &d->s_vlist)) {
+	sig->nchunks++;
+	sig->ncmds += vp->nused;
+    }
+}
+
+
+static void
+bvh_rec_bound(struct bvh_rec *r, struct bview *v)
+{
+    struct bv_scene_obj *s = r->s;
+    struct bv_scene_obj *d = (r->sig.vo) ? r->sig.vo : s;
+
+    r->valid = bv_scene_obj_bound(s, v);
+    r->display = (r->valid) ? d->s_displayobj : 0;
+    if (!r->valid)
+	return;
+    VMOVE(r->bmin, s->bmin);
+    VMOVE(r->bmax, s->bmax);
+    VSETALL(r->cmin, -s->s_size);
+    VSETALL(r->cmax, s->s_size);
+    VADD2(r->cmin, r->cmin, s->s_center);
+    VADD2(r->cmax, r->cmax, s->s_center);
+}
+
+
+/* record s and its children as present in this pass */
+static void
+bvh_visit(struct bv_scene_bvh *t, struct bv_scene_obj *s, struct bview *v)
+{
+    for (size_t i = 0; i < BU_PTBL_LEN(&s->children); i++)
+	bvh_visit(t, (struct bv_scene_obj *)BU_PTBL_GET(&s->children, i), v);
+
+    struct bvh_sig sig;
+    bvh_sig_get(&sig, s, v);
+
+    std::unordered_map<struct bv_scene_obj *, size_t>::iterator i_it = t->idx.find(s);
+    if (i_it == t->idx.end()) {
+	struct bvh_rec r;
+	memset(&r, 0, sizeof(struct bvh_rec));
+	r.s = s;
+	memcpy(&r.sig, &sig, sizeof(struct bvh_sig));
+	r.pass = t->pass;
+	bvh_rec_bound(&r, v);
+	t->idx[s] = t->recs.size();
+	if (sig.leaf)
+	    t->pending.push_back(t->recs.size());
+	t->recs.push_back(r);
+	t->have_scene = -1;
+	return;
+    }
+
+    struct bvh_rec *r = &t->recs[i_it->second];
+    if (r->pass == t->pass)
+	return;
+    r->pass = t->pass;
+    if (!memcmp(&r->sig, &sig, sizeof(struct bvh_sig)))
+	return;
+
+    if (r->sig.leaf != sig.leaf) {
+	// gained or lost children - simplest to treat it as a new object
+	r->s = NULL;
+	t->ndead++;
+	t->refit = (r->in_tree) ? 1 : t->refit;
+	t->idx.erase(i_it);
+	bvh_visit(t, s, v);
+	return;
+    }
+
+    memcpy(&r->sig, &sig, sizeof(struct bvh_sig));
+    bvh_rec_bound(r, v);
+    if (r->in_tree) {
+	t->nmoved++;
+	t->refit = 1;
+    }
+    t->have_scene = -1;
+}
+
+
+static void
+bvh_node_bound(struct bv_scene_bvh *t, size_t ni)
+{
+    struct bvh_node *n = &t->nodes[ni];
+    VSETALL(n->bmin, INFINITY);
+    VSETALL(n->bmax, -INFINITY);
+    if (n->skip == ni + 1) {
+	for (size_t i = n->first; i < n->first + n->count; i++) {
+	    struct bvh_rec *r = &t->recs[t->order[i]];
+	    if (!r->s || !r->valid)
+		continue;
+	    VMIN(n->bmin, r->bmin);
+	    VMAX(n->bmax, r->bmax);
+	}
+	return;
+    }
+    struct bvh_node *l = &t->nodes[ni + 1];
+    struct bvh_node *rn = &t->nodes[l->skip];
+    VMIN(n->bmin, l->bmin);
+    VMAX(n->bmax, l->bmax);
+    VMIN(n->bmin, rn->bmin);
+    VMAX(n->bmax, rn->bmax);
+}
+
+
+static void
+bvh_build_node(struct bv_scene_bvh *t, size_t first, size_t count)
+{
+    size_t ni = t->nodes.size();
+    struct bvh_node n;
+    n.first = first;
+    n.count = count;
+    n.skip = ni + 1;
+    t->nodes.push_back(n);
+
+    if (count > BVH_LEAF_SIZE) {
+	// Split at the median centroid along the longest axis of the
+	// centroid bounds.  Records without bounds sort as if centered
+	// on the origin.
+	point_t cmin, cmax, c;
+	VSETALL(cmin, INFINITY);
+	VSETALL(cmax, -INFINITY);
+	for (size_t i = first; i < first + count; i++) {
+	    struct bvh_rec *r = &t->recs[t->order[i]];
+	    if (!r->valid)
+		continue;
+	    VADD2SCALE(c, r->bmin, r->bmax, 0.5);
+	    VMINMAX(cmin, cmax, c);
+	}
+	int axis = X;
+	if (cmin[X] <= cmax[X]) {
+	    vect_t ext;
+	    VSUB2(ext, cmax, cmin);
+	    if (ext[Y] > ext[axis])
+		axis = Y;
+	    if (ext[Z] > ext[axis])
+		axis = Z;
+	}
+	std::vector<struct bvh_rec> &recs = t->recs;
+	std::vector<size_t>::iterator b = t->order.begin() + first;
+	std::nth_element(b, b + count/2, b + count, [&recs, axis](size_t i1, size_t i2) {
+		fastf_t c1 = (recs[i1].valid) ? recs[i1].bmin[axis] + recs[i1].bmax[axis] : 0.0;
+		fastf_t c2 = (recs[i2].valid) ? recs[i2].bmin[axis] + recs[i2].bmax[axis] : 0.0;
+		return c1 < c2;
+		});
+	bvh_build_node(t, first, count/2);
+	bvh_build_node(t, first + count/2, count - count/2);
+	t->nodes[ni].skip = t->nodes.size();
+    }
+
+    bvh_node_bound(t, ni);
+}
+
+
+static void
+bvh_build(struct bv_scene_bvh *t)
+{
+    // compact away the records of objects that left the scene
+    std::vector<struct bvh_rec> live;
+    live.reserve(t->recs.size() - t->ndead);
+    t->idx.clear();
+    t->order.clear();
+    for (size_t i = 0; i < t->recs.size(); i++) {
+	struct bvh_rec *r = &t->recs[i];
+	if (!r->s)
+	    continue;
+	r->in_tree = r->sig.leaf;
+	t->idx[r->s] = live.size();
+	if (r->in_tree)
+	    t->order.push_back(live.size());
+	live.push_back(*r);
+    }
+    t->recs.swap(live);
+    t->pending.clear();
+    t->nodes.clear();
+    t->ndead = 0;
+    t->nmoved = 0;
+    t->refit = 0;
+    if (t->order.size())
+	bvh_build_node(t, 0, t->order.size());
+}
+
+
+static struct bv_scene_bvh *
+bvh_sync(struct bview *v)
+{
+    if (!v)
+	return NULL;
+
+    struct bv_scene_bvh *t = (struct bv_scene_bvh *)v->gv_objs.bvh;
+    if (!t) {
+	t = new bv_scene_bvh;
+	v->gv_objs.bvh = (void *)t;
+    }
+    t->pass++;
+    t->culled = 0;
+
+    struct bu_ptbl *so = bv_view_objs(v, BV_DB_OBJS);
+    struct bu_ptbl *sol = bv_view_objs(v, BV_DB_OBJS | BV_LOCAL_OBJS);
+    for (size_t i = 0; so && i < BU_PTBL_LEN(so); i++)
+	bvh_visit(t, (struct bv_scene_obj *)BU_PTBL_GET(so, i), v);
+    for (size_t i = 0; sol && i < BU_PTBL_LEN(sol); i++)
+	bvh_visit(t, (struct bv_scene_obj *)BU_PTBL_GET(sol, i), v);
+
+    // Anything not seen this time has been removed from the scene
+    for (size_t i = 0; i < t->recs.size(); i++) {
+	struct bvh_rec *r = &t->recs[i];
+	if (!r->s || r->pass == t->pass)
+	    continue;
+	t->idx.erase(r->s);
+	r->s = NULL;
+	t->ndead++;
+	t->have_scene = -1;
+	if (r->in_tree)
+	    t->refit = 1;
+    }
+
+    // Rebuild once the pending list would make queries noticeably
+    // slower or the refitted tree has drifted too far from the one
+    // that was built; otherwise just refit.
+    size_t nleaf = t->order.size();
+    if (t->pending.size() > 32 + nleaf/8 || t->ndead > nleaf/4 || t->nmoved > nleaf/4) {
+	bvh_build(t);
+    } else if (t->refit) {
+	// Children follow their parents, so a reverse walk sees them first
+	for (size_t i = t->nodes.size(); i > 0; i--)
+	    bvh_node_bound(t, i - 1);
+	t->refit = 0;
+    }
+
+    if (t->have_scene < 0) {
+	t->have_scene = 0;
+	VSETALL(t->smin, INFINITY);
+	VSETALL(t->smax, -INFINITY);
+	for (size_t i = 0; i < t->recs.size(); i++) {
+	    struct bvh_rec *r = &t->recs[i];
+	    if (!r->s || !r->valid)
+		continue;
+	    VMIN(t->smin, r->cmin);
+	    VMAX(t->smax, r->cmax);
+	    t->have_scene = 1;
+	}
+    }
+
+    return t;
+}
+
+
+/* Report every leaf record with bounds to either hit or miss,
+ * depending on whether its bounds intersect the box. */
+template <typename Hit, typename Miss>
+static void
+bvh_obb_walk(struct bv_scene_bvh *t, point_t obb_c, vect_t obb_e1, vect_t obb_e2, vect_t obb_e3, Hit hit, Miss miss)
+{
+    size_t ni = 0;
+    while (ni < t->nodes.size()) {
+	struct bvh_node *n = &t->nodes[ni];
+	if (n->bmin[X] > n->bmax[X] || !bg_sat_aabb_obb(n->bmin, n->bmax, obb_c, obb_e1, obb_e2, obb_e3)) {
+	    for (size_t i = n->first; i < n->first + n->count; i++) {
+		struct bvh_rec *r = &t->recs[t->order[i]];
+		if (r->s && r->valid)
+		    miss(r);
+	    }
+	    ni = n->skip;
+	    continue;
+	}
+	if (n->skip == ni + 1) {
+	    for (size_t i = n->first; i < n->first + n->count; i++) {
+		struct bvh_rec *r = &t->recs[t->order[i]];
+		if (!r->s || !r->valid)
+		    continue;
+		if (bg_sat_aabb_obb(r->bmin, r->bmax, obb_c, obb_e1, obb_e2, obb_e3))
+		    hit(r);
+		else
+		    miss(r);
+	    }
+	}
+	ni++;
+    }
+    for (size_t i = 0; i < t->pending.size(); i++) {
+	struct bvh_rec *r = &t->recs[t->pending[i]];
+	if (!r->s || !r->valid)
+	    continue;
+	if (bg_sat_aabb_obb(r->bmin, r->bmax, obb_c, obb_e1, obb_e2, obb_e3))
+	    hit(r);
+	else
+	    miss(r);
+    }
+}
+
+
+int
+bv_scene_bvh_bounds(struct bview *v, point_t *min, point_t *max)
+{
+    struct bv_scene_bvh *t = bvh_sync(v);
+    if (!t || !t->have_scene)
+	return 0;
+    VMOVE(*min, t->smin);
+    VMOVE(*max, t->smax);
+    return 1;
+}
+
+
+size_t
+bv_scene_bvh_select(std::vector<struct bv_scene_obj *> &active, struct bview *v, point_t obb_c, vect_t obb_e1, vect_t obb_e2, vect_t obb_e3)
+{
+    struct bv_scene_bvh *t = bvh_sync(v);
+    active.clear();
+    if (!t)
+	return 0;
+
+    bvh_obb_walk(t, obb_c, obb_e1, obb_e2, obb_e3,
+	    [&active](struct bvh_rec *r) { active.push_back(r->s); },
+	    [](struct bvh_rec *) {});
+
+    // Report in the same (pointer) order the old std::set based search did
+    std::sort(active.begin(), active.end());
+    return active.size();
+}
+
+
+void
+bv_scene_bvh_free(struct bview *v)
+{
+    if (!v || !v->gv_objs.bvh)
+	return;
+    struct bv_scene_bvh *t = (struct bv_scene_bvh *)v->gv_objs.bvh;
+    delete t;
+    v->gv_objs.bvh = NULL;
+}
+
+
+/* Can drawing the record be skipped when it is out of view?  View
+ * dependent vlists (adaptive plotting) may not match the recorded
+ * bounds and display space coordinates do not move with the view, so
+ * only plain vlists and LoD meshes qualify. */
+static int
+bvh_cullable(struct bvh_rec *r)
+{
+    struct bv_scene_obj *d = (r->sig.vo) ? r->sig.vo : r->s;
+    if (!r->s || !r->valid || r->display)
+	return 0;
+    return (!d->s_update_callback || d->s_update_callback == &bv_mesh_lod_view);
+}
+
+
+size_t
+bv_view_cull(struct bview *v)
+{
+    struct bv_scene_bvh *t = bvh_sync(v);
+    if (!t || !t->have_scene || !t->nodes.size())
+	return 0;
+
+    // Perspective views are left to the LoD logic
+    if (SMALL_FASTF < v->gv_perspective || !v->gv_width || !v->gv_height)
+	return 0;
+
+    for (size_t i = 0; i < t->recs.size(); i++)
+	t->recs[i].culled = 0;
+
+    // The culling volume is the window, plus a margin, pushed through
+    // the whole scene along the view direction.
+    fastf_t x0 = 0.0, y0 = 0.0, x1 = 0.0, y1 = 0.0;
+    bv_screen_to_view(v, &x0, &y0, -BVH_CULL_PAD, v->gv_height + BVH_CULL_PAD);
+    bv_screen_to_view(v, &x1, &y1, v->gv_width + BVH_CULL_PAD, -BVH_CULL_PAD);
+
+    point_t vc, vp1, vp2, ec, ep1, ep2;
+    VSET(vc, 0.5 * (x0 + x1), 0.5 * (y0 + y1), 0);
+    VSET(vp1, x1, vc[Y], 0);
+    VSET(vp2, vc[X], y1, 0);
+    MAT4X3PNT(ec, v->gv_view2model, vc);
+    MAT4X3PNT(ep1, v->gv_view2model, vp1);
+    MAT4X3PNT(ep2, v->gv_view2model, vp2);
+
+    vect_t dir, work;
+    VMOVEN(dir, v->gv_rotation + 8, 3);
+    VUNITIZE(dir);
+    VSCALE(dir, dir, -1.0);
+
+    point_t sbbc, obb_c;
+    vect_t obb_e1, obb_e2, obb_e3;
+    VADD2SCALE(sbbc, t->smax, t->smin, 0.5);
+    VSUB2SCALE(work, t->smax, t->smin, 0.5);
+    plane_t p;
+    fastf_t pu, pv;
+    bg_plane_pt_nrml(&p, sbbc, dir);
+    bg_plane_closest_pt(&pu, &pv, &p, &ec);
+    bg_plane_pt_at(&obb_c, &p, pu, pv);
+    VSCALE(obb_e1, dir, MAGNITUDE(work) * BVH_MBUMP);
+    VSUB2(obb_e2, ep1, ec);
+    VSUB2(obb_e3, ep2, ec);
+
+    size_t ncull = 0;
+    bvh_obb_walk(t, obb_c, obb_e1, obb_e2, obb_e3,
+	    [](struct bvh_rec *) {},
+	    [](struct bvh_rec *r) { r->culled = 1; });
+    for (size_t i = 0; i < t->recs.size(); i++) {
+	struct bvh_rec *r = &t->recs[i];
+	if (r->culled && !bvh_cullable(r))
+	    r->culled = 0;
+	ncull += (r->culled) ? 1 : 0;
+    }
+    t->culled = 1;
+
+    bv_log(2, "bv_view_cull[%s]: %zd of %zd objects outside the view", bu_vls_cstr(&v->gv_name), ncull, t->recs.size());
+
+    return ncull;
+}
+
+
+int
+bv_view_obj_culled(struct bview *v, struct bv_scene_obj *s)
+{
+    if (!v || !s || !v->gv_objs.bvh)
+	return 0;
+    struct bv_scene_bvh *t = (struct bv_scene_bvh *)v->gv_objs.bvh;
+    if (!t->culled)
+	return 0;
+    std::unordered_map<struct bv_scene_obj *, size_t>::iterator i_it = t->idx.find(s);
+    if (i_it == t->idx.end())
+	return 0;
+    return t->recs[i_it->second].culled;
+}
+
+
+// Local Variables:
+// tab-width: 8
+// mode: C++
+// c-basic-offset: 4
+// indent-tabs-mode: t
+// c-file-style: "stroustrup"
+// End:
+// ex: shiftwidth=4 tabstop=8
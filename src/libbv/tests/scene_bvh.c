@@ -0,0 +1,195 @@
+/*                   S C E N E _ B V H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/* Checks selection and culling through the scene BVH: a grid of <n> x <n>
+ * squares is drawn into a view, and every square must be picked at its
+ * own pixel, be picked at its new location after it is moved, stop being
+ * picked once erased, and be culled exactly when it is out of view.
+ * The <args> format is: n
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include "bu.h"
+#include "bv.h"
+
+#define SCENE_BVH_WIDTH 512
+#define SCENE_BVH_HEIGHT 384
+
+
+static void
+scene_bvh_square(struct bv_scene_obj *s, fastf_t x, fastf_t y)
+{
+    point_t p;
+
+    if (BU_LIST_IS_INITIALIZED(&s->s_vlist))
+	BV_FREE_VLIST(s->vlfree, &s->s_vlist);
+    BU_LIST_INIT(&s->s_vlist);
+    VSET(p, x - 1, y - 1, 0);
+    BV_ADD_VLIST(s->vlfree, &s->s_vlist, p, BV_VLIST_LINE_MOVE);
+    VSET(p, x + 1, y - 1, 0);
+    BV_ADD_VLIST(s->vlfree, &s->s_vlist, p, BV_VLIST_LINE_DRAW);
+    VSET(p, x + 1, y + 1, 0);
+    BV_ADD_VLIST(s->vlfree, &s->s_vlist, p, BV_VLIST_LINE_DRAW);
+    VSET(p, x - 1, y + 1, 0);
+    BV_ADD_VLIST(s->vlfree, &s->s_vlist, p, BV_VLIST_LINE_DRAW);
+    bv_obj_stale(s);
+}
+
+
+/* the pixel a model point projects to */
+static void
+scene_bvh_pixel(struct bview *v, int *px, int *py, fastf_t x, fastf_t y)
+{
+    point_t p, vp;
+    fastf_t aspect = (fastf_t)v->gv_width / (fastf_t)v->gv_height;
+
+    VSET(p, x, y, 0);
+    MAT4X3PNT(vp, v->gv_model2view, p);
+    *px = (int)((vp[X] + 1.0) * 0.5 * v->gv_width);
+    *py = (int)((1.0 - vp[Y] * aspect) * 0.5 * v->gv_height);
+}
+
+
+static int
+scene_bvh_picks(struct bview *v, struct bv_scene_obj *s, fastf_t x, fastf_t y)
+{
+    struct bu_ptbl sset = BU_PTBL_INIT_ZERO;
+    int px, py, found;
+
+    bu_ptbl_init(&sset, 8, "selection");
+    scene_bvh_pixel(v, &px, &py, x, y);
+    (void)bv_view_objs_select(&sset, v, px, py);
+    found = (bu_ptbl_locate(&sset, (long *)s) != -1);
+    bu_ptbl_free(&sset);
+    return found;
+}
+
+
+int
+scene_bvh_main(int argc, char *argv[])
+{
+    struct bview *v;
+    struct bv_scene_obj **objs;
+    int n = 0;
+    int i, j;
+    int ret = 0;
+
+    if (argc < 2)
+	bu_exit(1, "ERROR: input format is test_args [%s]\n", argv[0]);
+    sscanf(argv[1], "%d", &n);
+    if (n < 2)
+	bu_exit(1, "ERROR: grid size must be at least 2\n");
+
+    BU_GET(v, struct bview);
+    bv_init(v, NULL);
+    v->gv_width = SCENE_BVH_WIDTH;
+    v->gv_height = SCENE_BVH_HEIGHT;
+
+    /* an n x n grid of 2x2 squares, 4 apart */
+    objs = (struct bv_scene_obj **)bu_calloc(n * n, sizeof(struct bv_scene_obj *), "objs");
+    for (i = 0; i < n * n; i++) {
+	objs[i] = bv_obj_get(v, BV_DB_OBJS);
+	scene_bvh_square(objs[i], 4.0 * (i % n), 4.0 * (i / n));
+    }
+    /* fit it into the window's shorter, vertical, extent too */
+    bv_autoview(v, BV_AUTOVIEW_SCALE_DEFAULT, 0);
+    v->gv_scale *= 1.5;
+    v->gv_size = 2.0 * v->gv_scale;
+    v->gv_isize = 1.0 / v->gv_size;
+    bv_update(v);
+
+    /* every square is picked at its center */
+    for (i = 0; i < n * n; i++) {
+	if (!scene_bvh_picks(v, objs[i], 4.0 * (i % n), 4.0 * (i / n))) {
+	    bu_log("square %d not selected\n", i);
+	    ret = 1;
+	}
+    }
+
+    /* moved onto the opposite corner, it is picked there and not at the
+     * old location */
+    scene_bvh_square(objs[0], 4.0 * (n - 1), 4.0 * (n - 1));
+    if (!scene_bvh_picks(v, objs[0], 4.0 * (n - 1), 4.0 * (n - 1)) || scene_bvh_picks(v, objs[0], 0.0, 0.0)) {
+	bu_log("moved square selected at the wrong location\n");
+	ret = 1;
+    }
+    scene_bvh_square(objs[0], 0.0, 0.0);
+
+    /* erased, it is not picked at all */
+    bv_obj_put(objs[n + 1]);
+    if (scene_bvh_picks(v, objs[n + 1], 4.0, 4.0)) {
+	bu_log("erased square still selected\n");
+	ret = 1;
+    }
+    objs[n + 1] = NULL;
+
+    /* everything is in view after autoview */
+    if (bv_view_cull(v)) {
+	bu_log("squares culled in a view showing all of them\n");
+	ret = 1;
+    }
+
+    /* zoomed in on the first square, only its neighborhood is kept */
+    v->gv_scale = 4.0;
+    v->gv_size = 2.0 * v->gv_scale;
+    v->gv_isize = 1.0 / v->gv_size;
+    MAT_IDN(v->gv_center);
+    bv_update(v);
+    (void)bv_view_cull(v);
+    for (i = 0; i < n * n; i++) {
+	int px0, py0, px1, py1, out;
+	if (!objs[i])
+	    continue;
+	scene_bvh_pixel(v, &px0, &py1, 4.0 * (i % n) - 1, 4.0 * (i / n) - 1);
+	scene_bvh_pixel(v, &px1, &py0, 4.0 * (i % n) + 1, 4.0 * (i / n) + 1);
+	out = (px1 < 0 || py1 < 0 || px0 > v->gv_width || py0 > v->gv_height);
+	/* squares just at the window edge may go either way */
+	if (abs(px1) < 8 || abs(py1) < 8 || abs(px0 - v->gv_width) < 8 || abs(py0 - v->gv_height) < 8)
+	    continue;
+	j = bv_view_obj_culled(v, objs[i]);
+	if (j != out) {
+	    bu_log("square %d %s\n", i, (j) ? "culled while in view" : "drawn while out of view");
+	    ret = 1;
+	}
+    }
+
+    for (i = 0; i < n * n; i++) {
+	if (objs[i])
+	    bv_obj_put(objs[i]);
+    }
+    bu_free(objs, "objs");
+    bv_free(v);
+    BU_PUT(v, struct bview);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
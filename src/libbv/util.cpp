@@ -293,6 +293,7 @@ bv_init(struct bview *gvp, struct bview_set *s)
     BU_GET(gvp->gv_objs.free_scene_obj, struct bv_scene_obj);
     BU_LIST_INIT(&gvp->gv_objs.free_scene_obj->l);
     BU_LIST_INIT(&gvp->gv_objs.gv_vlfree);
+    gvp->gv_objs.bvh = NULL;
 
     // Out of the gate we don't have callbacks
     gvp->callbacks = NULL;
@@ -357,6 +358,7 @@ bv_free(struct bview *gvp)
 	sp = nsp;
     }
     BU_PUT(gvp->gv_objs.free_scene_obj, struct bv_scene_obj);
+    bv_scene_bvh_free(gvp);
     if (gvp->gv_s)
 	bu_ptbl_free(&gvp->gv_s->gv_snap_objs);
     if (gvp->gv_s != &gvp->gv_ls)
@@ -1052,6 +1054,8 @@ void
 bv_obj_stale(struct bv_scene_obj *s)
 {
     s->s_dlist_stale = 1;
+    if (s->i)
+	s->i->gen++;
 
     if (BU_PTBL_IS_INITIALIZED(&s->children)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&s->children); i++) {
@@ -1131,6 +1135,7 @@ bv_obj_create(struct bview *v, int type)
     s->s_type_flags = 0;
     s->s_free_callback = NULL;
     s->s_dlist_free_callback = NULL;
+    s->s_dlist_data = NULL;
 
     // Use reset to do most of the initialization
     bv_obj_reset(s);
@@ -1224,8 +1229,10 @@ bv_obj_reset(struct bv_scene_obj *s)
     }
     bu_ptbl_reset(&s->children);
 
-    if (s->i)
+    if (s->i) {
 	s->i->vobjs.clear();
+	s->i->gen++;
+    }
 
     // If we have a callback for the internal data, use it
     if (s->s_free_callback)
@@ -1236,6 +1243,7 @@ bv_obj_reset(struct bv_scene_obj *s)
     if (s->s_dlist_free_callback)
 	(*s->s_dlist_free_callback)(s);
     s->s_dlist_free_callback = NULL;
+    s->s_dlist_data = NULL;
 
     // If we have a label, do the label freeing steps
     // TODO - this should be using the free callback rather
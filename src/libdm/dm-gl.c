@@ -136,10 +136,15 @@ void glvars_init(struct dm *dmp)
     /* Unless the app tells us different, assume OpenGL based
      * displays are capable of transparency */
     mvars->transparency_on = 1;
+
+    /* draw scene object vlists from retained vertex arrays */
+    mvars->retained = 1;
 }
 
 void gl_fogHint(struct dm *dmp, int fastfog)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_fogHint", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -181,6 +186,8 @@ int gl_setBGColor(struct dm *dmp,
 	unsigned char r2, unsigned char g2, unsigned char b2
 	)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setBGColor", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -221,6 +228,8 @@ int gl_reshape(struct dm *dmp, int width, int height)
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
 
+    gl_flush_batch(dmp);
+
     dmp->i->dm_height = height;
     dmp->i->dm_width = width;
     dmp->i->dm_aspect = (fastf_t)dmp->i->dm_width / (fastf_t)dmp->i->dm_height;
@@ -253,6 +262,8 @@ int gl_reshape(struct dm *dmp, int width, int height)
 
 int gl_setLight(struct dm *dmp, int lighting_on)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setLight", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -297,6 +308,8 @@ int gl_getLight(struct dm *dmp)
  */
 int gl_drawBegin(struct dm *dmp)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_drawBegin", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -333,6 +346,8 @@ int gl_drawBegin(struct dm *dmp)
 
 int gl_drawEnd(struct dm *dmp)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_drawEnd", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -376,6 +391,8 @@ int gl_loadMatrix(struct dm *dmp, fastf_t *mat, int which_eye)
     fastf_t *mptr;
     GLfloat gtmat[16];
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_loadMatrix", dmp->i->dm_debugLevel);
     if (dmp->i->dm_debugLevel == 3) {
 	struct bu_vls msg = BU_VLS_INIT_ZERO;
@@ -448,6 +465,8 @@ int gl_loadPMatrix(struct dm *dmp, const fastf_t *mat)
     const fastf_t *mptr;
     GLfloat gtmat[16];
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_loadPMatrix", dmp->i->dm_debugLevel);
 
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
@@ -492,8 +511,10 @@ int gl_loadPMatrix(struct dm *dmp, const fastf_t *mat)
     return BRLCAD_OK;
 }
 
-void gl_popPMatrix(struct dm *UNUSED(dmp))
+void gl_popPMatrix(struct dm *dmp)
 {
+    gl_flush_batch(dmp);
+
     glMatrixMode(GL_PROJECTION);
     glPopMatrix();
 }
@@ -505,6 +526,8 @@ int gl_drawVListHiddenLine(struct dm *dmp, register struct bv_vlist *vp)
     register struct bv_vlist *tvp;
     register int first;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_drawVListHiddenLine", dmp->i->dm_debugLevel);
 
     /* First, draw polygons using background color. */
@@ -678,6 +701,8 @@ int gl_drawVList(struct dm *dmp, struct bv_vlist *vp)
     GLdouble mt[16];
     GLdouble tlate[3];
 
+    gl_flush_batch(dmp);
+
     glGetFloatv(GL_POINT_SIZE, &originalPointSize);
     glGetFloatv(GL_LINE_WIDTH, &originalLineWidth);
 
@@ -860,12 +885,582 @@ int gl_drawVList(struct dm *dmp, struct bv_vlist *vp)
     return BRLCAD_OK;
 }
 
+/*
+ * Retained vlist drawing.
+ *
+ * A scene object's vlist is compiled once into packed float vertex
+ * (and, when it has surfaces, normal) arrays plus a short list of
+ * operations reproducing what gl_drawVList would issue, and is kept in
+ * s_dlist_data until the vlist changes.  The arrays are drawn with GL
+ * 1.1 client arrays - available in every backend without an extension
+ * loader, and not tied to a context, so one compiled object serves all
+ * of the views it appears in.
+ *
+ * Successive objects with the same color and line attributes are queued
+ * and drawn as one batch, setting up state once.  Everything else that
+ * draws or changes GL state calls gl_flush_batch first, so the order of
+ * drawing is the same as in immediate mode.
+ */
+
+/* operations that are not GL primitives */
+#define GL_VLIST_WIRE_MAT	-1
+#define GL_VLIST_SURF_MAT	-2
+#define GL_VLIST_LINE_WIDTH	-3
+#define GL_VLIST_POINT_SIZE	-4
+
+struct gl_vlist_op {
+    int type;		/* GL primitive, or one of the GL_VLIST_* values */
+    GLint first;	/* first vertex - for line strips, first strip */
+    GLsizei count;	/* vertex count - for line strips, strip count */
+    GLint ifirst;	/* line strips: first GL_LINES index */
+    GLsizei icount;	/* line strips: number of GL_LINES indices */
+    GLfloat val;	/* width or size, if positive */
+};
+
+struct gl_vlist_buf {
+    int immediate;	/* vlist uses matrix commands - draw with gl_drawVList */
+    int sized;		/* changes line width or point size */
+
+    /* the vlist the buffer was compiled from */
+    size_t nchunks;
+    size_t ncmds;
+    const void *chunk_first;
+    const void *chunk_last;
+    int changed;
+
+    GLfloat *v;		/* xyz per vertex */
+    GLfloat *n;		/* normal per vertex, NULL if none were given */
+    GLsizei nv;
+    GLuint *idx;	/* vertex pairs of all line strips, as GL_LINES */
+    GLsizei nidx;
+    GLint *strips;	/* first vertex and vertex count per line strip */
+    GLsizei nstrips;
+    struct gl_vlist_op *ops;
+    size_t nops;
+
+    int queued;		/* number of batch entries referencing this buffer */
+    int orphan;		/* freed while queued, release once drawn */
+};
+
+
+static void *
+gl_vlist_grow(void *p, size_t n, size_t *max, size_t esize)
+{
+    if (n < *max)
+	return p;
+    *max = (*max) ? *max * 2 : 64;
+    return bu_realloc(p, *max * esize, "gl_vlist_buf array");
+}
+
+
+static void
+gl_vlist_buf_release(struct gl_vlist_buf *buf)
+{
+    if (!buf)
+	return;
+    if (buf->queued) {
+	buf->orphan = 1;
+	return;
+    }
+    if (buf->v)
+	bu_free(buf->v, "vertices");
+    if (buf->n)
+	bu_free(buf->n, "normals");
+    if (buf->idx)
+	bu_free(buf->idx, "line indices");
+    if (buf->strips)
+	bu_free(buf->strips, "line strips");
+    if (buf->ops)
+	bu_free(buf->ops, "ops");
+    BU_PUT(buf, struct gl_vlist_buf);
+}
+
+
+void
+gl_vlist_buf_free(struct bv_scene_obj *s)
+{
+    if (!s)
+	return;
+    gl_vlist_buf_release((struct gl_vlist_buf *)s->s_dlist_data);
+    s->s_dlist_data = NULL;
+}
+
+
+static void
+gl_vlist_buf_free_callback(struct bv_scene_obj *s)
+{
+    gl_vlist_buf_free(s);
+}
+
+
+/* does buf still describe the vlist of s? */
+static int
+gl_vlist_buf_current(struct gl_vlist_buf *buf, struct bv_scene_obj *s)
+{
+    struct bv_vlist *tvp;
+    size_t nchunks = 0;
+    size_t ncmds = 0;
+
+    if (s->s_dlist_stale || buf->changed != s->s_changed)
+	return 0;
+    if (buf->chunk_first != (void *)BU_LIST_FIRST(bu_list, &s->s_vlist) || buf->chunk_last != (void *)BU_LIST_LAST(bu_list, &s->s_vlist))
+	return 0;
+    for (BU_LIST_FOR(tvp, bv_vlist, &s->s_vlist)) {
+	nchunks++;
+	ncmds += tvp->nused;
+    }
+    return (nchunks == buf->nchunks && ncmds == buf->ncmds);
+}
+
+
+/* add an operation, returning it */
+static struct gl_vlist_op *
+gl_vlist_op_add(struct gl_vlist_buf *buf, size_t *max, int type, GLfloat val)
+{
+    struct gl_vlist_op *op;
+    buf->ops = (struct gl_vlist_op *)gl_vlist_grow(buf->ops, buf->nops, max, sizeof(struct gl_vlist_op));
+    op = &buf->ops[buf->nops++];
+    op->type = type;
+    op->first = buf->nv;
+    op->count = 0;
+    op->ifirst = op->icount = 0;
+    op->val = val;
+    if (type != GL_VLIST_WIRE_MAT && type != GL_VLIST_SURF_MAT && val > 0.0)
+	buf->sized = 1;
+    return op;
+}
+
+
+/*
+ * Merge runs of line strips into single operations (drawn as GL_LINES
+ * index pairs when lines are solid), and neighboring point and
+ * triangle operations that drawing separately would not change.
+ */
+static void
+gl_vlist_buf_merge(struct gl_vlist_buf *buf)
+{
+    size_t i, j, nops = 0;
+    size_t idx_max = 0, strips_max = 0;
+
+    for (i = 0; i < buf->nops; i++) {
+	struct gl_vlist_op cur = buf->ops[i];
+	struct gl_vlist_op *op = &cur;
+	struct gl_vlist_op *prev = (nops) ? &buf->ops[nops - 1] : NULL;
+
+	if (op->type == GL_LINE_STRIP) {
+	    if (!prev || prev->type != GL_LINE_STRIP) {
+		prev = &buf->ops[nops++];
+		prev->type = GL_LINE_STRIP;
+		prev->first = buf->nstrips;
+		prev->count = 0;
+		prev->ifirst = buf->nidx;
+		prev->icount = 0;
+		prev->val = 0.0;
+	    }
+	    buf->strips = (GLint *)gl_vlist_grow(buf->strips, 2 * (size_t)buf->nstrips + 1, &strips_max, sizeof(GLint));
+	    buf->strips[2*buf->nstrips] = op->first;
+	    buf->strips[2*buf->nstrips+1] = op->count;
+	    buf->nstrips++;
+	    prev->count++;
+	    for (j = 1; j < (size_t)op->count; j++) {
+		buf->idx = (GLuint *)gl_vlist_grow(buf->idx, (size_t)buf->nidx + 1, &idx_max, sizeof(GLuint));
+		buf->idx[buf->nidx++] = (GLuint)(op->first + j - 1);
+		buf->idx[buf->nidx++] = (GLuint)(op->first + j);
+		prev->icount += 2;
+	    }
+	    continue;
+	}
+
+	if (prev && prev->type == op->type && prev->first + prev->count == op->first &&
+	    ((op->type == GL_POINTS && EQUAL(prev->val, op->val)) ||
+	     (op->type == GL_TRIANGLES && prev->count % 3 == 0))) {
+	    prev->count += op->count;
+	    continue;
+	}
+
+	buf->ops[nops++] = *op;
+    }
+    buf->nops = nops;
+}
+
+
+/*
+ * Compile a vlist, following the state gl_drawVList keeps as it walks
+ * the commands, so the result draws the same primitives.
+ */
+static struct gl_vlist_buf *
+gl_vlist_compile(struct bv_scene_obj *s)
+{
+    struct gl_vlist_buf *buf;
+    struct bv_vlist *tvp;
+    size_t v_max = 0, ops_max = 0;
+    int open = 0;		/* a glBegin would be in effect */
+    int mflag = 1;
+    int have_normals = 0;
+    GLfloat normal[3] = {0.0, 0.0, 1.0};
+    GLfloat pointSize = 0.0;	/* unset - gl_drawVList would use the current size */
+
+    BU_GET(buf, struct gl_vlist_buf);
+    buf->changed = s->s_changed;
+    buf->chunk_first = (void *)BU_LIST_FIRST(bu_list, &s->s_vlist);
+    buf->chunk_last = (void *)BU_LIST_LAST(bu_list, &s->s_vlist);
+
+    for (BU_LIST_FOR(tvp, bv_vlist, &s->s_vlist)) {
+	int i;
+	int nused = tvp->nused;
+	int *cmd = tvp->cmd;
+	point_t *pt = tvp->pt;
+
+	buf->nchunks++;
+	buf->ncmds += nused;
+
+	for (i = 0; i < nused; i++, cmd++, pt++) {
+	    int vert = 0;
+	    switch (*cmd) {
+		case BV_VLIST_LINE_MOVE:
+		    if (mflag) {
+			mflag = 0;
+			(void)gl_vlist_op_add(buf, &ops_max, GL_VLIST_WIRE_MAT, 0.0);
+		    }
+		    (void)gl_vlist_op_add(buf, &ops_max, GL_LINE_STRIP, 0.0);
+		    open = 1;
+		    vert = 1;
+		    break;
+		case BV_VLIST_MODEL_MAT:
+		case BV_VLIST_DISPLAY_MAT:
+		    buf->immediate = 1;
+		    break;
+		case BV_VLIST_POLY_START:
+		case BV_VLIST_TRI_START:
+		    if (mflag) {
+			mflag = 0;
+			(void)gl_vlist_op_add(buf, &ops_max, GL_VLIST_SURF_MAT, 0.0);
+			/* the material change lands inside an open point
+			 * primitive, which can just be split around it */
+			if (open && buf->nops > 1 && buf->ops[buf->nops - 2].type == GL_POINTS)
+			    (void)gl_vlist_op_add(buf, &ops_max, GL_POINTS, buf->ops[buf->nops - 2].val);
+		    }
+		    if (*cmd == BV_VLIST_POLY_START) {
+			(void)gl_vlist_op_add(buf, &ops_max, GL_POLYGON, 0.0);
+		    } else if (!open) {
+			(void)gl_vlist_op_add(buf, &ops_max, GL_TRIANGLES, 0.0);
+		    }
+		    open = 1;
+		    have_normals = 1;
+		    VMOVE(normal, *pt);
+		    break;
+		case BV_VLIST_LINE_DRAW:
+		case BV_VLIST_POLY_MOVE:
+		case BV_VLIST_POLY_DRAW:
+		case BV_VLIST_TRI_MOVE:
+		case BV_VLIST_TRI_DRAW:
+		    /* outside glBegin/glEnd a vertex draws nothing */
+		    vert = open;
+		    break;
+		case BV_VLIST_POLY_END:
+		    open = 0;
+		    break;
+		case BV_VLIST_TRI_END:
+		    break;
+		case BV_VLIST_POLY_VERTNORM:
+		case BV_VLIST_TRI_VERTNORM:
+		    have_normals = 1;
+		    VMOVE(normal, *pt);
+		    break;
+		case BV_VLIST_POINT_DRAW:
+		    (void)gl_vlist_op_add(buf, &ops_max, GL_POINTS, pointSize);
+		    open = 1;
+		    vert = 1;
+		    break;
+		case BV_VLIST_LINE_WIDTH:
+		    /* GL ignores width changes inside glBegin/glEnd */
+		    if (!open && (*pt)[0] > 0.0)
+			(void)gl_vlist_op_add(buf, &ops_max, GL_VLIST_LINE_WIDTH, (GLfloat)(*pt)[0]);
+		    break;
+		case BV_VLIST_POINT_SIZE:
+		    pointSize = (GLfloat)(*pt)[0];
+		    if (!open && pointSize > 0.0)
+			(void)gl_vlist_op_add(buf, &ops_max, GL_VLIST_POINT_SIZE, pointSize);
+		    break;
+	    }
+	    if (buf->immediate)
+		break;
+
+	    if (vert) {
+		size_t old_max = v_max;
+		buf->v = (GLfloat *)gl_vlist_grow(buf->v, 3 * (size_t)buf->nv + 2, &v_max, sizeof(GLfloat));
+		if (v_max != old_max)
+		    buf->n = (GLfloat *)bu_realloc(buf->n, v_max * sizeof(GLfloat), "normals");
+		VMOVE(&buf->v[3*buf->nv], *pt);
+		VMOVE(&buf->n[3*buf->nv], normal);
+		buf->nv++;
+		buf->ops[buf->nops - 1].count++;
+	    }
+	}
+	if (buf->immediate)
+	    break;
+    }
+
+    if (buf->immediate) {
+	/* keep only the signature */
+	if (buf->v)
+	    bu_free(buf->v, "vertices");
+	if (buf->n)
+	    bu_free(buf->n, "normals");
+	if (buf->ops)
+	    bu_free(buf->ops, "ops");
+	buf->v = buf->n = NULL;
+	buf->ops = NULL;
+	buf->nv = 0;
+	buf->nops = 0;
+	for (tvp = BU_LIST_PNEXT(bv_vlist, tvp); BU_LIST_NOT_HEAD(tvp, &s->s_vlist); tvp = BU_LIST_PNEXT(bv_vlist, tvp)) {
+	    buf->nchunks++;
+	    buf->ncmds += tvp->nused;
+	}
+	return buf;
+    }
+
+    if (!have_normals && buf->n) {
+	bu_free(buf->n, "normals");
+	buf->n = NULL;
+    }
+
+    gl_vlist_buf_merge(buf);
+
+    return buf;
+}
+
+
+/* draw one compiled vlist - client vertex arrays are enabled */
+static void
+gl_vlist_buf_draw(struct dm *dmp, struct gl_vlist_buf *buf, GLfloat *orig, int *have_orig)
+{
+    struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
+    static float black[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i;
+
+    if (buf->sized && !*have_orig) {
+	glGetFloatv(GL_POINT_SIZE, &orig[0]);
+	glGetFloatv(GL_LINE_WIDTH, &orig[1]);
+	*have_orig = 1;
+    }
+
+    glVertexPointer(3, GL_FLOAT, 0, buf->v);
+    if (buf->n) {
+	glEnableClientState(GL_NORMAL_ARRAY);
+	glNormalPointer(GL_FLOAT, 0, buf->n);
+    }
+
+    for (i = 0; i < buf->nops; i++) {
+	struct gl_vlist_op *op = &buf->ops[i];
+	switch (op->type) {
+	    case GL_VLIST_WIRE_MAT:
+		if (!mvars->lighting_on)
+		    break;
+		glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, mvars->i.wireColor);
+		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, black);
+		glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, black);
+		glMaterialfv(GL_FRONT_AND_BACK, GL_DIFFUSE, black);
+		if (mvars->transparency_on)
+		    glDisable(GL_BLEND);
+		break;
+	    case GL_VLIST_SURF_MAT:
+		if (!mvars->lighting_on)
+		    break;
+		glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, black);
+		glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT, mvars->i.ambientColor);
+		glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, mvars->i.specularColor);
+		glMaterialfv(GL_FRONT, GL_DIFFUSE, mvars->i.diffuseColor);
+		switch (mvars->lighting_on) {
+		    case 1:
+			break;
+		    case 2:
+			glMaterialfv(GL_BACK, GL_DIFFUSE, mvars->i.diffuseColor);
+			break;
+		    case 3:
+			glMaterialfv(GL_BACK, GL_DIFFUSE, mvars->i.backDiffuseColorDark);
+			break;
+		    default:
+			glMaterialfv(GL_BACK, GL_DIFFUSE, mvars->i.backDiffuseColorLight);
+			break;
+		}
+		if (mvars->transparency_on) {
+		    glEnable(GL_BLEND);
+		    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		break;
+	    case GL_VLIST_LINE_WIDTH:
+		glLineWidth(op->val);
+		break;
+	    case GL_VLIST_POINT_SIZE:
+		glPointSize(op->val);
+		break;
+	    case GL_LINE_STRIP:
+		if (dmp->i->dm_lineStyle != DM_DASHED_LINE) {
+		    /* without stippling, separate segments draw the same pixels */
+		    if (op->icount)
+			glDrawElements(GL_LINES, op->icount, GL_UNSIGNED_INT, buf->idx + op->ifirst);
+		} else {
+		    GLint j;
+		    for (j = op->first; j < op->first + op->count; j++)
+			glDrawArrays(GL_LINE_STRIP, buf->strips[2*j], buf->strips[2*j+1]);
+		}
+		break;
+	    case GL_POINTS:
+#if ENABLE_POINT_SMOOTH
+		glEnable(GL_POINT_SMOOTH);
+#endif
+		if (op->val > 0.0)
+		    glPointSize(op->val);
+		glDrawArrays(GL_POINTS, op->first, op->count);
+		break;
+	    default:
+		glDrawArrays((GLenum)op->type, op->first, op->count);
+		break;
+	}
+    }
+
+    if (buf->n)
+	glDisableClientState(GL_NORMAL_ARRAY);
+
+    if (mvars->lighting_on && mvars->transparency_on)
+	glDisable(GL_BLEND);
+
+    if (buf->sized) {
+	glPointSize(orig[0]);
+	glLineWidth(orig[1]);
+    }
+}
+
+
+/* are the dm's current color and line attributes those of the batch? */
+static int
+gl_batch_current(struct dm *dmp)
+{
+    struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
+    return (dmp->i->dm_fg[0] == mvars->i.batch_fg[0] &&
+	    dmp->i->dm_fg[1] == mvars->i.batch_fg[1] &&
+	    dmp->i->dm_fg[2] == mvars->i.batch_fg[2] &&
+	    mvars->i.fg_strict == mvars->i.batch_strict &&
+	    EQUAL(mvars->i.fg_transparency, mvars->i.batch_transparency) &&
+	    dmp->i->dm_lineWidth == mvars->i.batch_width &&
+	    dmp->i->dm_lineStyle == mvars->i.batch_style);
+}
+
+
+void
+gl_flush_batch(struct dm *dmp)
+{
+    struct gl_vars *mvars;
+    unsigned char fg[3];
+    int strict, width, style, restore;
+    fastf_t transparency;
+    GLfloat orig[2] = {1.0, 1.0};
+    int have_orig = 0;
+    size_t i;
+
+    if (!dmp || !dmp->i->m_vars)
+	return;
+    mvars = (struct gl_vars *)dmp->i->m_vars;
+    if (!BU_PTBL_IS_INITIALIZED(&mvars->i.batch) || !BU_PTBL_LEN(&mvars->i.batch))
+	return;
+
+    gl_debug_print(dmp, "gl_flush_batch", dmp->i->dm_debugLevel);
+
+    /* The objects were queued under the batch attributes - if the
+     * caller has since moved on to others, draw under the batch's and
+     * put the current ones back afterwards. */
+    restore = !gl_batch_current(dmp);
+    VMOVE(fg, dmp->i->dm_fg);
+    strict = mvars->i.fg_strict;
+    transparency = mvars->i.fg_transparency;
+    width = dmp->i->dm_lineWidth;
+    style = dmp->i->dm_lineStyle;
+    if (restore) {
+	gl_setFGColor(dmp, mvars->i.batch_fg[0], mvars->i.batch_fg[1], mvars->i.batch_fg[2], mvars->i.batch_strict, mvars->i.batch_transparency);
+	gl_setLineAttr(dmp, mvars->i.batch_width, mvars->i.batch_style);
+    }
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    for (i = 0; i < BU_PTBL_LEN(&mvars->i.batch); i++) {
+	struct gl_vlist_buf *buf = (struct gl_vlist_buf *)BU_PTBL_GET(&mvars->i.batch, i);
+	gl_vlist_buf_draw(dmp, buf, orig, &have_orig);
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    if (restore) {
+	gl_setFGColor(dmp, fg[0], fg[1], fg[2], strict, transparency);
+	gl_setLineAttr(dmp, width, style);
+    }
+
+    for (i = 0; i < BU_PTBL_LEN(&mvars->i.batch); i++) {
+	struct gl_vlist_buf *buf = (struct gl_vlist_buf *)BU_PTBL_GET(&mvars->i.batch, i);
+	buf->queued--;
+	if (!buf->queued && buf->orphan)
+	    gl_vlist_buf_release(buf);
+    }
+    bu_ptbl_reset(&mvars->i.batch);
+
+    if (dmp->i->dm_debugLevel > 3)
+	gl_debug_print(dmp, "gl_flush_batch after:", dmp->i->dm_debugLevel);
+}
+
+
+/*
+ * Draw the vlist of s from its retained buffer, compiling the buffer
+ * first if it is missing or out of date.  Returns BRLCAD_ERROR if the
+ * object has to be drawn in immediate mode instead.
+ */
+int
+gl_draw_vlist_retained(struct dm *dmp, struct bv_scene_obj *s)
+{
+    struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
+    struct gl_vlist_buf *buf;
+
+    if (!mvars->retained || !s || !(s->s_type_flags & BV_DB_OBJS))
+	return BRLCAD_ERROR;
+
+    /* some other dm specific data is attached */
+    if (s->s_dlist_free_callback && s->s_dlist_free_callback != &gl_vlist_buf_free_callback)
+	return BRLCAD_ERROR;
+
+    buf = (struct gl_vlist_buf *)s->s_dlist_data;
+    if (!buf || !gl_vlist_buf_current(buf, s)) {
+	gl_vlist_buf_release(buf);
+	buf = gl_vlist_compile(s);
+	s->s_dlist_data = (void *)buf;
+	s->s_dlist_free_callback = &gl_vlist_buf_free_callback;
+	s->s_dlist_stale = 0;
+    }
+
+    if (buf->immediate)
+	return BRLCAD_ERROR;
+
+    if (BU_PTBL_LEN(&mvars->i.batch) && !gl_batch_current(dmp))
+	gl_flush_batch(dmp);
+
+    if (!BU_PTBL_LEN(&mvars->i.batch)) {
+	VMOVE(mvars->i.batch_fg, dmp->i->dm_fg);
+	mvars->i.batch_strict = mvars->i.fg_strict;
+	mvars->i.batch_transparency = mvars->i.fg_transparency;
+	mvars->i.batch_width = dmp->i->dm_lineWidth;
+	mvars->i.batch_style = dmp->i->dm_lineStyle;
+    }
+    bu_ptbl_ins(&mvars->i.batch, (long *)buf);
+    buf->queued++;
+
+    return BRLCAD_OK;
+}
+
+
 int gl_draw_data_axes(struct dm *dmp,
                   fastf_t sf,
                   struct bv_data_axes_state *bndasp)
 {
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
     int npoints = bndasp->num_points * 6;
+    gl_flush_batch(dmp);
+
     if (npoints < 1)
         return 0;
 
@@ -941,6 +1536,8 @@ int gl_draw_data_axes(struct dm *dmp,
 int gl_draw(struct dm *dmp, struct bv_vlist *(*callback_function)(void *), void **data)
 {
     struct bv_vlist *vp;
+    gl_flush_batch(dmp);
+
     if (!callback_function) {
 	if (data) {
 	    vp = (struct bv_vlist *)data;
@@ -964,6 +1561,8 @@ int gl_hud_begin(struct dm *dmp)
 {
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_hud_begin", dmp->i->dm_debugLevel);
 
     if (!mvars->i.faceFlag) {
@@ -992,6 +1591,8 @@ int gl_hud_end(struct dm *dmp)
 
     GLfloat fogdepth;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_hud_end", dmp->i->dm_debugLevel);
     if (dmp->i->dm_debugLevel > 3) {
 	struct bu_vls msg = BU_VLS_INIT_ZERO;
@@ -1030,6 +1631,8 @@ int gl_hud_end(struct dm *dmp)
 int
 drawLine3D(struct dm *dmp, point_t pt1, point_t pt2, const char *log_bu, float *wireColor)
 {
+    gl_flush_batch(dmp);
+
     if (!dmp) {
 	return BRLCAD_ERROR;
     }
@@ -1074,6 +1677,8 @@ drawLine3D(struct dm *dmp, point_t pt1, point_t pt2, const char *log_bu, float *
 int
 drawLines3D(struct dm *dmp, int npoints, point_t *points, int lflag, const char *log_bu, float *wireColor)
 {
+    gl_flush_batch(dmp);
+
     if (!dmp) {
 	return BRLCAD_ERROR;
     }
@@ -1127,6 +1732,8 @@ drawLines3D(struct dm *dmp, int npoints, point_t *points, int lflag, const char
 int
 drawLine2D(struct dm *dmp, fastf_t X1, fastf_t Y1, fastf_t X2, fastf_t Y2, const char *log_bu)
 {
+    gl_flush_batch(dmp);
+
     if (!dmp) {
 	return BRLCAD_ERROR;
     }
@@ -1171,6 +1778,8 @@ int gl_drawLines3D(struct dm *dmp, int npoints, point_t *points, int sflag)
 
 int gl_drawPoint2D(struct dm *dmp, fastf_t x, fastf_t y)
 {
+    gl_flush_batch(dmp);
+
     if (dmp->i->dm_debugLevel) {
 	struct bu_vls msg = BU_VLS_INIT_ZERO;
 	bu_vls_sprintf(&msg, "gl_drawPoint2D: \tdmp: %p\tx - %lf\ty - %lf\n", (void *)dmp, x, y);
@@ -1193,6 +1802,8 @@ int gl_drawPoint3D(struct dm *dmp, point_t point)
 {
     GLdouble dpt[3];
 
+    gl_flush_batch(dmp);
+
     if (!dmp || !point)
 	return BRLCAD_ERROR;
 
@@ -1223,6 +1834,8 @@ int gl_drawPoints3D(struct dm *dmp, int npoints, point_t *points)
     GLdouble dpt[3];
     register int i;
 
+    gl_flush_batch(dmp);
+
     if (!dmp || npoints < 0 || !points)
 	return BRLCAD_ERROR;
 
@@ -1249,6 +1862,8 @@ int gl_setFGColor(struct dm *dmp, unsigned char r, unsigned char g, unsigned cha
     dmp->i->dm_fg[0] = r;
     dmp->i->dm_fg[1] = g;
     dmp->i->dm_fg[2] = b;
+    mvars->i.fg_strict = strict;
+    mvars->i.fg_transparency = transparency;
 
     gl_debug_print(dmp, "gl_setFGColor", dmp->i->dm_debugLevel);
 
@@ -1339,6 +1954,8 @@ int gl_setWinBounds(struct dm *dmp, fastf_t *w)
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
     GLint mm;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setWinBounds", dmp->i->dm_debugLevel);
 
     dmp->i->dm_clipmin[0] = w[0];
@@ -1368,6 +1985,8 @@ int gl_setTransparency(struct dm *dmp,
 {
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setTransparency", dmp->i->dm_debugLevel);
 
     mvars->transparency_on = transparency_on;
@@ -1395,6 +2014,8 @@ int gl_getTransparency(struct dm *dmp)
 
 int gl_setDepthMask(struct dm *dmp, int enable)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setDepthMask", dmp->i->dm_debugLevel);
 
     dmp->i->dm_depthMask = enable;
@@ -1412,6 +2033,8 @@ int gl_setZBuffer(struct dm *dmp, int zbuffer_on)
 {
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setZBuffer", dmp->i->dm_debugLevel);
 
     mvars->zbuffer_on = zbuffer_on;
@@ -1443,6 +2066,8 @@ int gl_setZClip(struct dm *dmp, int zclip)
 {
     struct gl_vars *mvars = (struct gl_vars *)dmp->i->m_vars;
 
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_setZClip", dmp->i->dm_debugLevel);
 
     mvars->zclipping_on = zclip;
@@ -1502,6 +2127,8 @@ int gl_getBoundFlag(struct dm *dmp)
 
 int gl_beginDList(struct dm *dmp, unsigned int list)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_beginDList", dmp->i->dm_debugLevel);
 
     glNewList((GLuint)list, GL_COMPILE);
@@ -1543,6 +2170,8 @@ int gl_genDLists(struct dm *dmp, size_t range)
 
 int gl_draw_display_list(struct dm *dmp, struct display_list *obj)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_draw_obj", dmp->i->dm_debugLevel);
 
     struct bv_scene_obj *sp;
@@ -1569,6 +2198,8 @@ int gl_draw_display_list(struct dm *dmp, struct display_list *obj)
 
 int gl_getDisplayImage(struct dm *dmp, unsigned char **image, int flip, int alpha)
 {
+    gl_flush_batch(dmp);
+
     gl_debug_print(dmp, "gl_getDisplayImage", dmp->i->dm_debugLevel);
 
     unsigned char *idata;
@@ -1606,6 +2237,7 @@ int gl_get_internal(struct dm *dmp)
 	mvars = (struct gl_vars *)dmp->i->m_vars;
 	mvars->this_dm = dmp;
 	bu_vls_init(&(mvars->log));
+	bu_ptbl_init(&mvars->i.batch, 64, "retained vlist batch");
     }
     return 0;
 }
@@ -1616,6 +2248,14 @@ int gl_put_internal(struct dm *dmp)
     if (dmp->i->m_vars) {
 	mvars = (struct gl_vars *)dmp->i->m_vars;
 	bu_vls_free(&(mvars->log));
+	/* the context is going away - drop anything not yet drawn */
+	for (size_t i = 0; i < BU_PTBL_LEN(&mvars->i.batch); i++) {
+	    struct gl_vlist_buf *buf = (struct gl_vlist_buf *)BU_PTBL_GET(&mvars->i.batch, i);
+	    buf->queued--;
+	    if (!buf->queued && buf->orphan)
+		gl_vlist_buf_release(buf);
+	}
+	bu_ptbl_free(&mvars->i.batch);
 	BU_PUT(dmp->i->m_vars, struct gl_vars);
     }
     return 0;
@@ -1628,6 +2268,7 @@ void gl_colorchange(const struct bu_structparse *sdp,
 	void *data)
 {
     struct gl_vars *mvars = (struct gl_vars *)base;
+    gl_flush_batch(mvars->this_dm);
     if (mvars->cueing_on) {
 	glEnable(GL_FOG);
     } else {
@@ -1775,6 +2416,7 @@ struct bu_structparse gl_vparse[] = {
     {"%V",  1, "log",              gl_MV_O(log),             gl_logfile_hook, NULL, NULL },
     {"%g",  1, "bound",            gl_MV_O(bound),           gl_bound_hook, NULL, NULL },
     {"%d",  1, "useBound",         gl_MV_O(boundFlag),       gl_bound_flag_hook, NULL, NULL },
+    {"%d",  1, "retained",         gl_MV_O(retained),        dm_generic_hook, NULL, NULL },
     {"",    0, (char *)0,          0,                        BU_STRUCTPARSE_FUNC_NULL, NULL, NULL }
 };
 
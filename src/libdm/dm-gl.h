@@ -106,6 +106,19 @@ struct gl_internal_vars {
     float diffuseColor[4];
     float backDiffuseColorDark[4];
     float backDiffuseColorLight[4];
+
+    /* last gl_setFGColor arguments not kept in dm_fg */
+    int fg_strict;
+    fastf_t fg_transparency;
+
+    /* retained vlist draws waiting to be issued, and the color and
+     * line attributes they were queued under */
+    struct bu_ptbl batch;
+    unsigned char batch_fg[3];
+    int batch_strict;
+    fastf_t batch_transparency;
+    int batch_width;
+    int batch_style;
 };
 
 struct gl_vars {
@@ -124,6 +137,7 @@ struct gl_vars {
     struct bu_vls log;
     double bound;
     int boundFlag;
+    int retained;
     struct gl_internal_vars i;
 };
 
@@ -156,6 +170,9 @@ DMGL_EXPORT extern int gl_drawPoints3D(struct dm *dmp, int npoints, point_t *poi
 DMGL_EXPORT extern int gl_drawVList(struct dm *dmp, struct bv_vlist *vp);
 DMGL_EXPORT extern int gl_drawVListHiddenLine(struct dm *dmp, struct bv_vlist *vp);
 DMGL_EXPORT extern int gl_draw_obj(struct dm *dmp, struct bv_scene_obj *s);
+DMGL_EXPORT extern int gl_draw_vlist_retained(struct dm *dmp, struct bv_scene_obj *s);
+DMGL_EXPORT extern void gl_flush_batch(struct dm *dmp);
+DMGL_EXPORT extern void gl_vlist_buf_free(struct bv_scene_obj *s);
 DMGL_EXPORT extern int gl_draw_data_axes(struct dm *dmp, fastf_t sf,  struct bv_data_axes_state *bndasp);
 DMGL_EXPORT extern int gl_draw_display_list(struct dm *dmp, struct display_list *obj);
 DMGL_EXPORT extern int gl_endDList(struct dm *dmp);
@@ -54,6 +54,7 @@ dlist_free_callback(struct bv_scene_obj *s)
 	glDeleteLists(s->s_dlist, 1);
 	s->s_dlist = 0;
     }
+    gl_vlist_buf_free(s);
     s->s_dlist_stale = 0;
     s->s_dlist_mode = 0;
 }
@@ -544,15 +545,21 @@ int gl_draw_obj(struct dm *dmp, struct bv_scene_obj *s)
 {
     if (s->s_type_flags & BV_MESH_LOD) {
 	struct bv_mesh_lod *lod = (struct bv_mesh_lod *)s->draw_data;
+	gl_flush_batch(dmp);
 	return gl_draw_tri(dmp, lod);
     }
 
     if (s->s_type_flags & BV_CSG_LOD) {
+	gl_flush_batch(dmp);
 	return gl_csg_lod(dmp, s);
     }
 
     // "Standard" vlist object drawing
     if (bu_list_len(&s->s_vlist)) {
+	// Database objects are drawn from cached vertex arrays when
+	// possible (the vlist is unchanged unless the object is stale)
+	if (s->s_os->s_dmode != 4 && gl_draw_vlist_retained(dmp, s) == BRLCAD_OK)
+	    return BRLCAD_OK;
 	if (s->s_os->s_dmode == 4) {
 	    dm_draw_vlist_hidden_line(dmp, (struct bv_vlist *)&s->s_vlist);
 	} else {
@@ -185,6 +185,8 @@ libdm_init(void)
     fb_map[debugkey] = &debug_interface;
     std::string memkey("/dev/mem");
     fb_map[memkey] = &memory_interface;
+    std::string shmkey("/dev/shmem");
+    fb_map[shmkey] = &shm_interface;
     std::string stackkey("/dev/stack");
     fb_map[stackkey] = &stk_interface;
 
@@ -1057,6 +1057,7 @@ ogl_drawString2D(struct dm *dmp, const char *str, fastf_t x, fastf_t y, int UNUS
 {
     struct pogl_vars *privars = (struct pogl_vars *)dmp->i->dm_vars.priv_vars;
     gl_debug_print(dmp, "ogl_drawString2D", dmp->i->dm_debugLevel);
+    gl_flush_batch(dmp);
 
     if (use_aspect)
 	glRasterPos2f(x, y * dmp->i->dm_aspect);
@@ -0,0 +1,807 @@
+/*                        I F _ S H M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @addtogroup libstruct fb */
+/** @{ */
+/** @file if_shm.c
+ *
+ * A Shared Memory Tile Frame Buffer Interface.
+ *
+ * Pixels are kept in a System V shared memory segment, stored as
+ * SHM_TILE_SIZE square tiles, each of which is a contiguous
+ * bottom-to-top RGB image.  Every write marks the tiles it touches in
+ * a dirty-tile bitmap, and the first write to a clean tile also pushes
+ * its index onto a ring so consumers see tiles in the order they were
+ * rendered.  Writers never wait on readers.
+ *
+ * A consumer in another process (see fb_shm_attach()) takes dirty
+ * tiles and uses the pixels in place, without copying them through a
+ * socket the way if_remote does.  A consumer clears a tile's dirty bit
+ * before it looks at the pixels, so a tile rewritten while it is being
+ * read is simply delivered again.
+ *
+ */
+/** @} */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+#include <string.h>
+#include <errno.h>
+
+#if defined(HAVE_SYS_SHM_H) && !defined(__STDC_NO_ATOMICS__)
+#  define FB_SHM_SUPPORTED 1
+#  include <sys/types.h>
+#  include <sys/ipc.h>
+#  include <sys/shm.h>
+#  include <stdatomic.h>
+#  define SHM_ATOMIC(_t) _Atomic _t
+#else
+#  define SHM_ATOMIC(_t) _t
+#endif
+
+#include "bu/color.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/str.h"
+#include "./include/private.h"
+#include "dm.h"
+
+
+#define SHM_TILE_SIZE	64		/* tile edge, in pixels */
+#define SHM_RING_SIZE	4096		/* must be a power of two */
+#define SHM_SEG_MAGIC	0x73686d74	/* shmt */
+
+#define SHM_STATE_OPEN		1	/* writer attached */
+#define SHM_STATE_CLOSED	2	/* writer gone, drain and detach */
+
+/* Layout of the start of the shared segment.  The dirty bitmap (one
+ * bit per tile) follows, and then the tiles themselves.
+ */
+struct shm_header {
+    uint32_t magic;
+    int32_t width;
+    int32_t height;
+    int32_t tile_size;
+    int32_t ntiles_x;
+    int32_t ntiles_y;
+    SHM_ATOMIC(uint32_t) state;
+    SHM_ATOMIC(uint32_t) ring_head;	/* count of tiles ever queued */
+    SHM_ATOMIC(uint32_t) ring[SHM_RING_SIZE];
+    ColorMap cmap;
+};
+
+
+/* Per connection private info */
+struct shmfb_info {
+    int shmid;
+    struct shm_header *hdr;
+    SHM_ATOMIC(uint32_t) *dirty;	/* dirty-tile bitmap */
+    unsigned char *pix;		/* start of tile storage */
+};
+#define SI(ptr) ((struct shmfb_info *)((ptr)->i->u1.p))
+#define SIL(ptr) ((ptr)->i->u1.p)		/* left hand side version */
+
+
+/* Consumer side view of a segment */
+struct fb_shm_tiles {
+    int shmid;
+    struct shm_header *hdr;
+    SHM_ATOMIC(uint32_t) *dirty;
+    unsigned char *pix;
+    uint32_t ring_tail;		/* next ring entry to look at */
+    int scan_word;		/* where the bitmap scan left off */
+};
+
+
+static uint32_t
+shm_fetch_or(SHM_ATOMIC(uint32_t) *p, uint32_t v)
+{
+#ifdef FB_SHM_SUPPORTED
+    return atomic_fetch_or(p, v);
+#else
+    uint32_t o = *p;
+    *p |= v;
+    return o;
+#endif
+}
+
+
+static uint32_t
+shm_fetch_and(SHM_ATOMIC(uint32_t) *p, uint32_t v)
+{
+#ifdef FB_SHM_SUPPORTED
+    return atomic_fetch_and(p, v);
+#else
+    uint32_t o = *p;
+    *p &= v;
+    return o;
+#endif
+}
+
+
+static uint32_t
+shm_fetch_add(SHM_ATOMIC(uint32_t) *p, uint32_t v)
+{
+#ifdef FB_SHM_SUPPORTED
+    return atomic_fetch_add(p, v);
+#else
+    uint32_t o = *p;
+    *p += v;
+    return o;
+#endif
+}
+
+
+static uint32_t
+shm_load(SHM_ATOMIC(uint32_t) *p)
+{
+#ifdef FB_SHM_SUPPORTED
+    return atomic_load(p);
+#else
+    return *p;
+#endif
+}
+
+
+static void
+shm_store(SHM_ATOMIC(uint32_t) *p, uint32_t v)
+{
+#ifdef FB_SHM_SUPPORTED
+    atomic_store(p, v);
+#else
+    *p = v;
+#endif
+}
+
+
+static size_t
+shm_bitmap_words(int ntiles_x, int ntiles_y)
+{
+    return ((size_t)ntiles_x * ntiles_y + 31) / 32;
+}
+
+
+static size_t
+shm_segment_size(int width, int height)
+{
+    int ntx = (width + SHM_TILE_SIZE - 1) / SHM_TILE_SIZE;
+    int nty = (height + SHM_TILE_SIZE - 1) / SHM_TILE_SIZE;
+
+    return sizeof(struct shm_header)
+	+ shm_bitmap_words(ntx, nty) * sizeof(uint32_t)
+	+ (size_t)width * height * 3;
+}
+
+
+/*
+ * Tiles are stored row of tiles by row of tiles, and within a row of
+ * tiles each tile is a contiguous tw*th image.  Tiles on the right
+ * and top edges are narrower or shorter, so no space is wasted and
+ * every tile can be handed to fb_writerect() as-is.
+ */
+static unsigned char *
+shm_tile(struct shm_header *hdr, unsigned char *pix, int tx, int ty, int *tw, int *th)
+{
+    int ts = hdr->tile_size;
+    int w = hdr->width - tx * ts;
+    int h = hdr->height - ty * ts;
+
+    if (w > ts) w = ts;
+    if (h > ts) h = ts;
+    if (tw) *tw = w;
+    if (th) *th = h;
+
+    return pix + 3 * ((size_t)ty * ts * hdr->width + (size_t)tx * ts * h);
+}
+
+
+static void
+shm_mark_dirty(struct shmfb_info *si, int tile)
+{
+    uint32_t mask = (uint32_t)1 << (tile & 31);
+    uint32_t old;
+    uint32_t slot;
+
+    old = shm_fetch_or(&si->dirty[tile >> 5], mask);
+    if (old & mask)
+	return;		/* already queued */
+
+    slot = shm_fetch_add(&si->hdr->ring_head, 1);
+    shm_store(&si->hdr->ring[slot & (SHM_RING_SIZE - 1)], (uint32_t)tile);
+}
+
+
+/*
+ * Attach to (creating if need be) the segment for shared memory
+ * unit 'unit'.  Returns NULL on failure.
+ */
+static char *
+shm_get_segment(int unit, size_t size, int *shmid)
+{
+#ifdef FB_SHM_SUPPORTED
+    char *sp = NULL;
+    int ret;
+
+    ret = bu_shmget(shmid, &sp, SHMEM_TILE_KEY + unit, size);
+    if (ret == 1)
+	return NULL;
+
+    return sp;
+#else
+    if (unit || size || shmid)
+	fb_log("if_shm: shared memory is not supported on this platform\n");
+    return NULL;
+#endif
+}
+
+
+static int
+shm_open_fb(struct fb *ifp, const char *file, int width, int height)
+{
+    struct shm_header *hdr;
+    char *sp;
+    size_t nwords;
+    int unit = 0;
+    int ntx, nty;
+    int shmid = -1;
+
+    FB_CK_FB(ifp->i);
+
+    if (file == NULL) return -1;
+
+    /* file = "/dev/shmem###", where ### is the unit number */
+    if (bu_strncmp(file, "/dev/shmem", 10) == 0 && isdigit((int)file[10]))
+	unit = atoi(&file[10]);
+
+    if (width > 0)
+	ifp->i->if_width = width;
+    if (height > 0)
+	ifp->i->if_height = height;
+    if (ifp->i->if_width > ifp->i->if_max_width)
+	ifp->i->if_width = ifp->i->if_max_width;
+    if (ifp->i->if_height > ifp->i->if_max_height)
+	ifp->i->if_height = ifp->i->if_max_height;
+
+    sp = shm_get_segment(unit, shm_segment_size(ifp->i->if_width, ifp->i->if_height), &shmid);
+    if (!sp) {
+	fb_log("shm_open:  unable to attach shared memory unit %d\n", unit);
+	return -1;
+    }
+
+    if ((SIL(ifp) = (char *)calloc(1, sizeof(struct shmfb_info))) == NULL) {
+	fb_log("shm_open:  shm_info malloc failed\n");
+#ifdef FB_SHM_SUPPORTED
+	(void)shmdt(sp);
+#endif
+	return -1;
+    }
+
+    ntx = (ifp->i->if_width + SHM_TILE_SIZE - 1) / SHM_TILE_SIZE;
+    nty = (ifp->i->if_height + SHM_TILE_SIZE - 1) / SHM_TILE_SIZE;
+    nwords = shm_bitmap_words(ntx, nty);
+
+    hdr = (struct shm_header *)sp;
+    SI(ifp)->shmid = shmid;
+    SI(ifp)->hdr = hdr;
+    SI(ifp)->dirty = (SHM_ATOMIC(uint32_t) *)(sp + sizeof(struct shm_header));
+    SI(ifp)->pix = (unsigned char *)(sp + sizeof(struct shm_header) + nwords * sizeof(uint32_t));
+
+    /* (Re)initialize the header; the magic number goes in last so a
+     * consumer never sees a half-described segment.
+     */
+    hdr->magic = 0;
+    hdr->width = ifp->i->if_width;
+    hdr->height = ifp->i->if_height;
+    hdr->tile_size = SHM_TILE_SIZE;
+    hdr->ntiles_x = ntx;
+    hdr->ntiles_y = nty;
+    shm_store(&hdr->ring_head, 0);
+    memset((void *)SI(ifp)->dirty, 0, nwords * sizeof(uint32_t));
+    fb_make_linear_cmap(&hdr->cmap);
+    shm_store(&hdr->state, SHM_STATE_OPEN);
+    hdr->magic = SHM_SEG_MAGIC;
+
+    return 0;
+}
+
+
+static struct fb_platform_specific *
+shm_get_fbps(uint32_t UNUSED(magic))
+{
+    return NULL;
+}
+
+
+static void
+shm_put_fbps(struct fb_platform_specific *UNUSED(fbps))
+{
+    return;
+}
+
+
+static int
+shm_open_existing(struct fb *UNUSED(ifp), int UNUSED(width), int UNUSED(height), struct fb_platform_specific *UNUSED(fb_p))
+{
+    return 0;
+}
+
+
+static int
+shm_close_existing(struct fb *UNUSED(ifp))
+{
+    return 0;
+}
+
+
+static int
+shm_configure_window(struct fb *UNUSED(ifp), int UNUSED(width), int UNUSED(height))
+{
+    return 0;
+}
+
+
+static int
+shm_refresh(struct fb *UNUSED(ifp), int UNUSED(x), int UNUSED(y), int UNUSED(w), int UNUSED(h))
+{
+    return 0;
+}
+
+
+static int
+shm_close(struct fb *ifp)
+{
+    if (!SIL(ifp))
+	return 0;
+
+    /* Let consumers drain what is left, and have the segment go away
+     * once the last of them detaches.
+     */
+    shm_store(&SI(ifp)->hdr->state, SHM_STATE_CLOSED);
+#ifdef FB_SHM_SUPPORTED
+    (void)shmctl(SI(ifp)->shmid, IPC_RMID, 0);
+    (void)shmdt((void *)SI(ifp)->hdr);
+#endif
+    (void)free((char *)SIL(ifp));
+    SIL(ifp) = NULL;
+
+    return 0;
+}
+
+
+static int
+shm_clear(struct fb *ifp, unsigned char *pp)
+{
+    struct shm_header *hdr = SI(ifp)->hdr;
+    unsigned char *cp;
+    RGBpixel v;
+    size_t n;
+    int t;
+
+    if (pp == RGBPIXEL_NULL) {
+	v[RED] = v[GRN] = v[BLU] = 0;
+    } else {
+	v[RED] = (pp)[RED];
+	v[GRN] = (pp)[GRN];
+	v[BLU] = (pp)[BLU];
+    }
+
+    /* Tiles are packed, so the whole image is one contiguous run */
+    cp = SI(ifp)->pix;
+    n = (size_t)hdr->width * hdr->height;
+    if (v[RED] == v[GRN] && v[RED] == v[BLU]) {
+	memset(cp, v[RED], n * 3);
+    } else {
+	for (; n; n--) {
+	    *cp++ = v[RED];
+	    *cp++ = v[GRN];
+	    *cp++ = v[BLU];
+	}
+    }
+
+    for (t = 0; t < hdr->ntiles_x * hdr->ntiles_y; t++)
+	shm_mark_dirty(SI(ifp), t);
+
+    return 0;
+}
+
+
+static ssize_t
+shm_read(struct fb *ifp, int x, int y, unsigned char *pixelp, size_t count)
+{
+    struct shm_header *hdr = SI(ifp)->hdr;
+    int ts = hdr->tile_size;
+    size_t done = 0;
+
+    if (x < 0 || x >= hdr->width || y < 0 || y >= hdr->height)
+	return -1;
+
+    while (done < count && y < hdr->height) {
+	int tx, tw, th, n;
+	unsigned char *tp;
+
+	tx = x / ts;
+	tp = shm_tile(hdr, SI(ifp)->pix, tx, y / ts, &tw, &th);
+	n = tw - (x - tx * ts);
+	if ((size_t)n > count - done)
+	    n = (int)(count - done);
+
+	memcpy(pixelp, tp + 3 * ((size_t)(y % ts) * tw + (x - tx * ts)), (size_t)n * 3);
+	pixelp += n * 3;
+	done += n;
+	x += n;
+	if (x >= hdr->width) {
+	    x = 0;
+	    y++;
+	}
+    }
+
+    return done;
+}
+
+
+static ssize_t
+shm_write(struct fb *ifp, int x, int y, const unsigned char *pixelp, size_t count)
+{
+    struct shm_header *hdr = SI(ifp)->hdr;
+    int ts = hdr->tile_size;
+    size_t done = 0;
+
+    if (x < 0 || x >= hdr->width || y < 0 || y >= hdr->height)
+	return -1;
+
+    while (done < count && y < hdr->height) {
+	int tx, ty, tw, th, n;
+	unsigned char *tp;
+
+	tx = x / ts;
+	ty = y / ts;
+	tp = shm_tile(hdr, SI(ifp)->pix, tx, ty, &tw, &th);
+	n = tw - (x - tx * ts);
+	if ((size_t)n > count - done)
+	    n = (int)(count - done);
+
+	memcpy(tp + 3 * ((size_t)(y % ts) * tw + (x - tx * ts)), pixelp, (size_t)n * 3);
+	shm_mark_dirty(SI(ifp), ty * hdr->ntiles_x + tx);
+
+	pixelp += n * 3;
+	done += n;
+	x += n;
+	if (x >= hdr->width) {
+	    x = 0;
+	    y++;
+	}
+    }
+
+    return done;
+}
+
+
+static int
+shm_rmap(struct fb *ifp, ColorMap *cmp)
+{
+    *cmp = SI(ifp)->hdr->cmap;		/* struct copy */
+    return 0;
+}
+
+
+static int
+shm_wmap(struct fb *ifp, const ColorMap *cmp)
+{
+    if (cmp == COLORMAP_NULL) {
+	fb_make_linear_cmap(&(SI(ifp)->hdr->cmap));
+    } else {
+	SI(ifp)->hdr->cmap = *cmp;		/* struct copy */
+    }
+    return 0;
+}
+
+
+static int
+shm_view(struct fb *ifp, int xcenter, int ycenter, int xzoom, int yzoom)
+{
+    fb_sim_view(ifp, xcenter, ycenter, xzoom, yzoom);
+    return 0;
+}
+
+
+static int
+shm_getview(struct fb *ifp, int *xcenter, int *ycenter, int *xzoom, int *yzoom)
+{
+    fb_sim_getview(ifp, xcenter, ycenter, xzoom, yzoom);
+    return 0;
+}
+
+
+static int
+shm_setcursor(struct fb *UNUSED(ifp), const unsigned char *UNUSED(bits), int UNUSED(xbits), int UNUSED(ybits), int UNUSED(xorig), int UNUSED(yorig))
+{
+    return 0;
+}
+
+
+static int
+shm_cursor(struct fb *ifp, int mode, int x, int y)
+{
+    fb_sim_cursor(ifp, mode, x, y);
+    return 0;
+}
+
+
+static int
+shm_getcursor(struct fb *ifp, int *mode, int *x, int *y)
+{
+    fb_sim_getcursor(ifp, mode, x, y);
+    return 0;
+}
+
+
+static int
+shm_poll(struct fb *UNUSED(ifp))
+{
+    return 0;
+}
+
+
+static int
+shm_flush(struct fb *UNUSED(ifp))
+{
+    /* Writes land in the segment immediately */
+    return 0;
+}
+
+
+static int
+shm_help(struct fb *ifp)
+{
+    fb_log("Description: %s\n", shm_interface.i->if_type);
+    fb_log("Device: %s\n", ifp->i->if_name);
+    fb_log("Max width/height: %d %d\n",
+	   shm_interface.i->if_max_width,
+	   shm_interface.i->if_max_height);
+    fb_log("Default width/height: %d %d\n",
+	   shm_interface.i->if_width,
+	   shm_interface.i->if_height);
+    fb_log("Usage: /dev/shmem[unit]\n");
+    fb_log("   pixels are shared in %dx%d tiles with consumers such as 'fbserv -T unit'\n",
+	   SHM_TILE_SIZE, SHM_TILE_SIZE);
+    return 0;
+}
+
+
+struct fb_shm_tiles *
+fb_shm_attach(int unit)
+{
+#ifdef FB_SHM_SUPPORTED
+    struct fb_shm_tiles *st;
+    struct shm_header *hdr;
+    char *sp;
+    int shmid;
+
+    if ((shmid = shmget(SHMEM_TILE_KEY + unit, 0, 0)) < 0)
+	return NULL;
+    if ((sp = (char *)shmat(shmid, 0, 0)) == (char *)(-1L))
+	return NULL;
+
+    hdr = (struct shm_header *)sp;
+    if (hdr->magic != SHM_SEG_MAGIC) {
+	(void)shmdt(sp);
+	return NULL;
+    }
+
+    BU_GET(st, struct fb_shm_tiles);
+    st->shmid = shmid;
+    st->hdr = hdr;
+    st->dirty = (SHM_ATOMIC(uint32_t) *)(sp + sizeof(struct shm_header));
+    st->pix = (unsigned char *)(sp + sizeof(struct shm_header)
+				+ shm_bitmap_words(hdr->ntiles_x, hdr->ntiles_y) * sizeof(uint32_t));
+    st->ring_tail = 0;
+    st->scan_word = 0;
+    return st;
+#else
+    if (unit)
+	fb_log("fb_shm_attach: shared memory is not supported on this platform\n");
+    return NULL;
+#endif
+}
+
+
+void
+fb_shm_detach(struct fb_shm_tiles *st)
+{
+    if (!st)
+	return;
+#ifdef FB_SHM_SUPPORTED
+    (void)shmdt((void *)st->hdr);
+#endif
+    BU_PUT(st, struct fb_shm_tiles);
+}
+
+
+void
+fb_shm_getsize(const struct fb_shm_tiles *st, int *width, int *height)
+{
+    if (!st)
+	return;
+    if (width) *width = st->hdr->width;
+    if (height) *height = st->hdr->height;
+}
+
+
+/* Claim tile t if it is dirty.  Returns 1 if the caller now owns it. */
+static int
+shm_claim(struct fb_shm_tiles *st, uint32_t t)
+{
+    uint32_t mask = (uint32_t)1 << (t & 31);
+
+    if (t >= (uint32_t)(st->hdr->ntiles_x * st->hdr->ntiles_y))
+	return 0;
+    return (shm_fetch_and(&st->dirty[t >> 5], ~mask) & mask) ? 1 : 0;
+}
+
+
+int
+fb_shm_next_tile(struct fb_shm_tiles *st, int *x, int *y, int *w, int *h, const unsigned char **pixels)
+{
+    struct shm_header *hdr;
+    uint32_t head;
+    uint32_t t = 0;
+    int found = 0;
+    int nwords;
+    int i;
+
+    if (!st)
+	return -1;
+    hdr = st->hdr;
+
+    /* Take tiles in the order they were first dirtied */
+    head = shm_load(&hdr->ring_head);
+    if (head - st->ring_tail > SHM_RING_SIZE)
+	st->ring_tail = head - SHM_RING_SIZE;	/* overrun, bitmap has the rest */
+    while (!found && st->ring_tail != head) {
+	t = shm_load(&hdr->ring[st->ring_tail & (SHM_RING_SIZE - 1)]);
+	st->ring_tail++;
+	found = shm_claim(st, t);
+    }
+
+    /* The bitmap is the authority; sweep it for anything the ring missed */
+    nwords = (int)shm_bitmap_words(hdr->ntiles_x, hdr->ntiles_y);
+    for (i = 0; !found && i < nwords; i++) {
+	int wd = (st->scan_word + i) % nwords;
+	uint32_t bits = shm_load(&st->dirty[wd]);
+	while (bits && !found) {
+	    int b = 0;
+	    while (!(bits & ((uint32_t)1 << b)))
+		b++;
+	    t = (uint32_t)(wd * 32 + b);
+	    found = shm_claim(st, t);
+	    bits &= ~((uint32_t)1 << b);
+	}
+	if (found)
+	    st->scan_word = wd;
+    }
+
+    if (!found)
+	return (shm_load(&hdr->state) == SHM_STATE_CLOSED) ? -1 : 0;
+
+    if (x) *x = (int)(t % hdr->ntiles_x) * hdr->tile_size;
+    if (y) *y = (int)(t / hdr->ntiles_x) * hdr->tile_size;
+    if (pixels)
+	*pixels = shm_tile(hdr, st->pix, (int)(t % hdr->ntiles_x), (int)(t / hdr->ntiles_x), w, h);
+    return 1;
+}
+
+
+int
+fb_shm_drain(struct fb_shm_tiles *st, struct fb *dest)
+{
+    const unsigned char *pp;
+    int x, y, w, h;
+    int ret;
+    int n = 0;
+
+    if (!st)
+	return -1;
+
+    while ((ret = fb_shm_next_tile(st, &x, &y, &w, &h, &pp)) > 0) {
+	if (dest)
+	    fb_writerect(dest, x, y, w, h, pp);
+	n++;
+    }
+    if (ret < 0 && n == 0)
+	return -1;
+    return n;
+}
+
+
+/* This is the ONLY thing that we normally "export" */
+struct fb_impl shm_interface_impl =  {
+    0,
+    FB_SHM_MAGIC,
+    shm_open_fb,	/* device_open */
+    shm_open_existing,	/* existing device_open */
+    shm_close_existing,	/* existing device_close */
+    shm_get_fbps,
+    shm_put_fbps,
+    shm_close,		/* device_close */
+    shm_clear,		/* device_clear */
+    shm_read,		/* buffer_read */
+    shm_write,		/* buffer_write */
+    shm_rmap,		/* colormap_read */
+    shm_wmap,		/* colormap_write */
+    shm_view,		/* set view */
+    shm_getview,	/* get view */
+    shm_setcursor,	/* define cursor */
+    shm_cursor,		/* set cursor */
+    shm_getcursor,	/* get cursor */
+    fb_sim_readrect,	/* rectangle read */
+    fb_sim_writerect,	/* rectangle write */
+    fb_sim_bwreadrect,
+    fb_sim_bwwriterect,
+    shm_configure_window,
+    shm_refresh,
+    shm_poll,		/* poll */
+    shm_flush,		/* flush */
+    shm_close,		/* free */
+    shm_help,		/* help message */
+    "Shared Memory Tiles",	/* device description */
+    FB_XMAXSCREEN,	/* max width */
+    FB_YMAXSCREEN,	/* max height */
+    "/dev/shmem",	/* short device name */
+    512,		/* default/current width */
+    512,		/* default/current height */
+    -1,			/* select fd */
+    -1,			/* file descriptor */
+    1, 1,		/* zoom */
+    256, 256,		/* window center */
+    0, 0, 0,		/* cursor */
+    PIXEL_NULL,		/* page_base */
+    PIXEL_NULL,		/* page_curp */
+    PIXEL_NULL,		/* page_endp */
+    -1,			/* page_no */
+    0,			/* page_dirty */
+    0L,			/* page_curpos */
+    0L,			/* page_pixels */
+    0,			/* debug */
+    0,			/* refresh rate */
+    NULL,
+    NULL,
+    0,
+    NULL,
+    {0}, /* u1 */
+    {0}, /* u2 */
+    {0}, /* u3 */
+    {0}, /* u4 */
+    {0}, /* u5 */
+    {0}  /* u6 */
+};
+
+struct fb shm_interface =  { &shm_interface_impl };
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
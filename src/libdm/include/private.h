@@ -105,11 +105,14 @@ DM_EXPORT extern struct fb remote_interface; /* not in list[] */
 
 /* Always included */
 extern struct fb debug_interface, disk_interface, stk_interface;
-extern struct fb memory_interface, fb_null_interface;
+extern struct fb memory_interface, fb_null_interface, shm_interface;
 
 /* Shared memory (shmget et. al.) key common to multiple framebuffers */
 #define SHMEM_KEY 42
 
+/* Base key for the /dev/shmem tile framebuffers, offset by unit number */
+#define SHMEM_TILE_KEY (SHMEM_KEY+1)
+
 /* Maximum memory buffer allocation.
  *
  * Care must be taken as this can result in a large default memory
@@ -340,6 +340,7 @@ qtgl_drawString2D(struct dm *dmp, const char *str, fastf_t ix, fastf_t iy, int U
     struct qtgl_vars *privars = (struct qtgl_vars *)dmp->i->dm_vars.priv_vars;
 
     gl_debug_print(dmp, "qtgl_drawString2D", dmp->i->dm_debugLevel);
+    gl_flush_batch(dmp);
 
     // If the positions are out of range on the positive side, just don't draw -
     // text will go to the right and not be visible
@@ -334,6 +334,8 @@ swrast_drawString2D(struct dm *dmp, const char *str, fastf_t ix, fastf_t iy, int
     if (dmp->i->dm_debugLevel)
 	bu_log("swrast_drawString2D()\n");
 
+    gl_flush_batch(dmp);
+
     // If the positions are out of range on the positive side, just don't draw -
     // text will go to the right and not be visible
     fastf_t x = ix;
@@ -578,6 +578,11 @@ draw_scene_obj(struct dm *dmp, struct bv_scene_obj *s, struct bview *v, int forc
     if (!s || !v || (s->s_flag == DOWN && !force_draw))
 	return;
 
+    // Leaves found to be out of view by bv_view_cull need no drawing - in
+    // particular, no view dependent LoD update.
+    if (!BU_PTBL_LEN(&s->children) && bv_view_obj_culled(v, s))
+	return;
+
     int do_force_draw = (force_draw || s->s_force_draw) ? 1 : 0;
 
     // Draw children. TODO - drawing children first may not
@@ -678,7 +683,8 @@ dm_draw_viewobjs(struct rt_wdb *wdbp, struct bview *v, struct dm_view_data *vd)
     }
 #endif
 
-    // Draw geometry view objects
+    // Draw geometry view objects, skipping those out of view
+    (void)bv_view_cull(v);
     struct bu_ptbl *db_objs = bv_view_objs(v, BV_DB_OBJS);
     if (db_objs) {
 	for (size_t i = 0; i < BU_PTBL_LEN(db_objs); i++) {
@@ -798,8 +804,9 @@ dm_draw_objs(struct bview *v, void (*dm_draw_custom)(struct bview *, void *), vo
     }
 
 
-    // Draw geometry view objects
+    // Draw geometry view objects, skipping those out of view
     // TODO - draw opaque, then transparent
+    (void)bv_view_cull(v);
     struct bu_ptbl *sobjs = bv_view_objs(v, BV_DB_OBJS);
     if (!v->independent && sobjs) {
 	for (size_t i = 0; i < BU_PTBL_LEN(sobjs); i++) {
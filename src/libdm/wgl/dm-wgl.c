@@ -299,6 +299,8 @@ wgl_drawString2D(struct dm *dmp, const char *str, fastf_t x, fastf_t y, int size
     if (dmp->i->dm_debugLevel)
 	bu_log("wgl_drawString2D()\n");
 
+    gl_flush_batch(dmp);
+
     if (use_aspect)
 	glRasterPos2f(x, y * dmp->i->dm_aspect);
     else
@@ -45,6 +45,7 @@
 #include "bu/vls.h"
 #include "gcv/api.h"
 #include "vmath.h"
+#include "bg/weld.h"
 #include "nmg.h"
 #include "rt/geom.h"
 #include "raytrace.h"
@@ -70,8 +71,10 @@ struct conversion_state
     struct rt_wdb *fd_out;	/* Resulting BRL-CAD file */
 
     struct wmember all_head;
-    struct bg_vert_tree *tree;
-    int *bot_faces;	        /* array of ints (indices into tree->the_array array) three per face */
+    fastf_t *bot_pnts;		/* the part's face corners as read, nine per face */
+    int *bot_faces;	        /* array of ints (indices into bot_verts array) three per face */
+    fastf_t *bot_verts;		/* the part's welded vertices */
+    size_t bot_nverts;		/* number of welded vertices */
 
     int id_no;	            	/* Ident numbers */
     int bot_fsize;		/* current size of the bot_faces array */
@@ -79,28 +82,65 @@ struct conversion_state
 };
 
 
-/* Size of blocks of faces to malloc */
+/* Initial number of faces to malloc */
 #define BOT_FBLOCK 128
 
 #define MAX_LINE_SIZE 512
 
 
 static void
-Add_face(struct conversion_state *pstate, int face[3])
+Add_face(struct conversion_state *pstate, const fastf_t pnts[9])
 {
     if (!pstate->bot_faces) {
-	pstate->bot_faces = (int *)bu_malloc(3 * BOT_FBLOCK * sizeof(int), "bot_faces");
 	pstate->bot_fsize = BOT_FBLOCK;
+	pstate->bot_pnts = (fastf_t *)bu_malloc(9 * pstate->bot_fsize * sizeof(fastf_t), "bot_pnts");
+	pstate->bot_faces = (int *)bu_malloc(3 * pstate->bot_fsize * sizeof(int), "bot_faces");
 	pstate->bot_fcurr = 0;
     } else if (pstate->bot_fcurr >= pstate->bot_fsize) {
-	pstate->bot_fsize += BOT_FBLOCK;
+	pstate->bot_fsize *= 2;
+	pstate->bot_pnts = (fastf_t *)bu_realloc((void *)pstate->bot_pnts, 9 * pstate->bot_fsize * sizeof(fastf_t), "bot_pnts increase");
 	pstate->bot_faces = (int *)bu_realloc((void *)pstate->bot_faces, 3 * pstate->bot_fsize * sizeof(int), "bot_faces increase");
     }
 
-    VMOVE(&pstate->bot_faces[3*pstate->bot_fcurr], face);
+    memcpy(&pstate->bot_pnts[9*pstate->bot_fcurr], pnts, 9 * sizeof(fastf_t));
     pstate->bot_fcurr++;
 }
 
+
+/* Weld the corners of the part's faces into bot_verts and drop the faces
+ * that collapse, leaving the rest in bot_faces.  Returns how many faces
+ * were dropped.
+ */
+static int
+Weld_faces(struct conversion_state *pstate)
+{
+    size_t *remap;
+    size_t i, npnts, nfaces, dropped;
+
+    pstate->bot_verts = NULL;
+    pstate->bot_nverts = 0;
+    if (!pstate->bot_fcurr)
+	return 0;
+
+    npnts = 3 * (size_t)pstate->bot_fcurr;
+    remap = (size_t *)bu_malloc(npnts * sizeof(size_t), "remap");
+    pstate->bot_nverts = bg_weld_pnts(&pstate->bot_verts, remap, pstate->bot_pnts, npnts,
+				      pstate->gcv_options->calculational_tolerance.dist);
+    for (i = 0; i < npnts; i++)
+	pstate->bot_faces[i] = (int)i;
+    nfaces = bg_weld_faces(pstate->bot_faces, pstate->bot_fcurr, remap);
+    bu_free(remap, "remap");
+
+    dropped = pstate->bot_fcurr - nfaces;
+    pstate->bot_fcurr = (int)nfaces;
+    if (!nfaces) {
+	bu_free(pstate->bot_verts, "bot_verts");
+	pstate->bot_verts = NULL;
+	pstate->bot_nverts = 0;
+    }
+    return (int)dropped;
+}
+
 static int
 _db_uniq_test(struct bu_vls *n, void *data)
 {
@@ -166,6 +206,7 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
     int solid_in_region=0;
 
     BU_LIST_INIT(&head.l);
+    pstate->bot_fcurr = 0;
 
 
     bu_vls_sprintf(&region_name, "%s", line);
@@ -238,7 +279,7 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
 	} else if (!bu_strncmp(&line1[start], "outer loop", 10) || !bu_strncmp(&line1[start], "OUTER LOOP", 10)) {
 	    int endloop=0;
 	    int vert_no=0;
-	    int tmp_face[3] = {0, 0, 0};
+	    fastf_t tmp_face[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
 
 	    while (!endloop) {
 		if (bu_fgets(line1, MAX_LINE_SIZE, pstate->fd_in) == NULL)
@@ -259,49 +300,38 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
 
 			bu_log("Non-triangular loop:\n");
 			for (n=0; n<3; n++)
-			    bu_log("\t(%g %g %g)\n", V3ARGS(&pstate->tree->the_array[tmp_face[n]]));
+			    bu_log("\t(%g %g %g)\n", V3ARGS(&tmp_face[3*n]));
 
 			bu_log("\t(%g %g %g)\n", x, y, z);
+			continue;
 		    }
 		    x *= pstate->gcv_options->scale_factor;
 		    y *= pstate->gcv_options->scale_factor;
 		    z *= pstate->gcv_options->scale_factor;
-		    tmp_face[vert_no++] = bg_vert_tree_add( pstate->tree,x, y, z, pstate->gcv_options->calculational_tolerance.dist_sq);
+		    VSET(&tmp_face[3*vert_no], x, y, z);
+		    vert_no++;
 		} else {
 		    bu_log("Unrecognized line: %s\n", line1);
 		}
 	    }
 
-	    /* check for degenerate faces */
-	    if (tmp_face[0] == tmp_face[1]) {
-		degenerate_count++;
-		continue;
-	    }
-
-	    if (tmp_face[0] == tmp_face[2]) {
-		degenerate_count++;
-		continue;
-	    }
-
-	    if (tmp_face[1] == tmp_face[2]) {
-		degenerate_count++;
-		continue;
-	    }
-
 	    if (pstate->gcv_options->debug_mode) {
 		int n;
 
 		bu_log("Making Face:\n");
 		for (n=0; n<3; n++)
-		    bu_log("\tvertex #%d: (%g %g %g)\n", tmp_face[n], V3ARGS(&pstate->tree->the_array[3*tmp_face[n]]));
+		    bu_log("\tvertex #%d: (%g %g %g)\n", n, V3ARGS(&tmp_face[3*n]));
 		VPRINT(" normal", normal);
 	    }
 
 	    Add_face(pstate, tmp_face);
-	    face_count++;
 	}
     }
 
+    /* weld the vertices, dropping the faces that turn out degenerate */
+    degenerate_count = Weld_faces(pstate);
+    face_count = pstate->bot_fcurr;
+
     /* Check if this part has any solid parts */
     if (face_count == 0) {
 	bu_log("\t%s has no solid parts, ignoring\n", bu_vls_cstr(&region_name));
@@ -316,9 +346,10 @@ Convert_part_ascii(struct conversion_state *pstate, char line[MAX_LINE_SIZE])
 	    bu_log("\t%d faces were degenerate\n", degenerate_count);
     }
 
-    mk_bot(pstate->fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, pstate->tree->curr_vert, pstate->bot_fcurr,
-	   pstate->tree->the_array, pstate->bot_faces, NULL, NULL);
-    bg_vert_tree_clean(pstate->tree);
+    mk_bot(pstate->fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, pstate->bot_nverts, pstate->bot_fcurr,
+	   pstate->bot_verts, pstate->bot_faces, NULL, NULL);
+    bu_free(pstate->bot_verts, "bot_verts");
+    pstate->bot_verts = NULL;
 
     if (db5_update_attribute(bu_vls_cstr(&solid_name), "importer", "gcv-stl", pstate->fd_out->dbip))
         bu_bomb("db5_update_attribute() failed");
@@ -366,7 +397,7 @@ Convert_part_binary(struct conversion_state *pstate)
     unsigned long num_facets=0;
     float flts[12];
     vect_t normal;
-    int tmp_face[3];
+    fastf_t tmp_face[9];
     struct wmember head;
     struct bu_vls solid_name = BU_VLS_INIT_ZERO;
     struct bu_vls region_name = BU_VLS_INIT_ZERO;
@@ -374,6 +405,8 @@ Convert_part_binary(struct conversion_state *pstate)
     int degenerate_count=0;
     size_t ret;
 
+    pstate->bot_fcurr = 0;
+
     bu_vls_strcat(&solid_name, "s.stl");
     bu_vls_strcat(&region_name, "r.stl");
     bu_log("\tUsing solid name: %s\n", bu_vls_cstr(&solid_name));
@@ -392,7 +425,6 @@ Convert_part_binary(struct conversion_state *pstate)
     bu_log("\t%ld facets\n", num_facets);
     while (fread(buf, 48, 1, pstate->fd_in)) {
 	int i;
-	double pt[3];
 
 	/* swap bytes to convert from Little-endian to network order (big-endian) */
 	for (i=0; i<12; i++) {
@@ -408,42 +440,26 @@ Convert_part_binary(struct conversion_state *pstate)
 	    perror("fread");
 
 	VMOVE(normal, flts);
-	VSCALE(pt, &flts[3], pstate->gcv_options->scale_factor);
-	tmp_face[0] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
-	VSCALE(pt, &flts[6], pstate->gcv_options->scale_factor);
-	tmp_face[1] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
-	VSCALE(pt, &flts[9], pstate->gcv_options->scale_factor);
-	tmp_face[2] = bg_vert_tree_add(pstate->tree, V3ARGS(pt), pstate->gcv_options->calculational_tolerance.dist_sq);
-
-	/* check for degenerate faces */
-	if (tmp_face[0] == tmp_face[1]) {
-	    degenerate_count++;
-	    continue;
-	}
-
-	if (tmp_face[0] == tmp_face[2]) {
-	    degenerate_count++;
-	    continue;
-	}
-
-	if (tmp_face[1] == tmp_face[2]) {
-	    degenerate_count++;
-	    continue;
-	}
+	VSCALE(&tmp_face[0], &flts[3], pstate->gcv_options->scale_factor);
+	VSCALE(&tmp_face[3], &flts[6], pstate->gcv_options->scale_factor);
+	VSCALE(&tmp_face[6], &flts[9], pstate->gcv_options->scale_factor);
 
 	if (pstate->gcv_options->debug_mode) {
 	    int n;
 
 	    bu_log("Making Face:\n");
 	    for (n=0; n<3; n++)
-		bu_log("\tvertex #%d: (%g %g %g)\n", tmp_face[n], V3ARGS(&pstate->tree->the_array[3*tmp_face[n]]));
+		bu_log("\tvertex #%d: (%g %g %g)\n", n, V3ARGS(&tmp_face[3*n]));
 	    VPRINT(" normal", normal);
 	}
 
 	Add_face(pstate, tmp_face);
-	face_count++;
     }
 
+    /* weld the vertices, dropping the faces that turn out degenerate */
+    degenerate_count = Weld_faces(pstate);
+    face_count = pstate->bot_fcurr;
+
     /* Check if this part has any solid parts */
     if (face_count == 0) {
 	bu_log("\tpart has no solid parts, ignoring\n");
@@ -456,8 +472,9 @@ Convert_part_binary(struct conversion_state *pstate)
     }
 
     mk_bot(pstate->fd_out, bu_vls_cstr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0,
-	   pstate->tree->curr_vert, pstate->bot_fcurr, pstate->tree->the_array, pstate->bot_faces, NULL, NULL);
-    bg_vert_tree_clean(pstate->tree);
+	   pstate->bot_nverts, pstate->bot_fcurr, pstate->bot_verts, pstate->bot_faces, NULL, NULL);
+    bu_free(pstate->bot_verts, "bot_verts");
+    pstate->bot_verts = NULL;
 
     if (db5_update_attribute(bu_vls_cstr(&solid_name), "importer", "gcv-stl", pstate->fd_out->dbip))
         bu_bomb("db5_update_attribute() failed");
@@ -585,11 +602,13 @@ stl_read(struct gcv_context *context, const struct gcv_opts *gcv_options, const
 
     BU_LIST_INIT(&state.all_head.l);
 
-    /* create a tree structure to hold the input vertices */
-    state.tree = bg_vert_tree_create();
-
     Convert_input(&state);
 
+    if (state.bot_faces) {
+	bu_free(state.bot_pnts, "bot_pnts");
+	bu_free(state.bot_faces, "bot_faces");
+    }
+
     /* make a top level group */
     mk_lcomb(wdbp, "all", &state.all_head, 0, (char *)NULL, (char *)NULL, (unsigned char *)NULL, 0);
 
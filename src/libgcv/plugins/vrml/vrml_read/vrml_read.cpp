@@ -37,6 +37,7 @@
 #include "bu/getopt.h"
 #include "gcv/api.h"
 #include "vmath.h"
+#include "bg/weld.h"
 #include "wdb.h"
 
 #define LEN 20
@@ -50,9 +51,8 @@ void formatString(char *instring);
 void get4vec(float *p);
 void get3vec(float *p);
 
-static struct bg_vert_tree *tree;
 static struct wmember all_head;
-static int *bot_faces=NULL;	 /* array of ints (indices into tree->the_array array) three per face */
+static int *bot_faces=NULL;	 /* array of ints (indices into the welded vertices) three per face */
 static int bot_fcurr=0;		/* current bot face */
 static double *allvert = NULL;
 static int vertsize;
@@ -65,21 +65,6 @@ unsigned char color[3]={ 128, 128, 128 };
 
 #define BOT_FBLOCK 128
 
-int
-Check_degenerate(int face[3])
-{
-    if (face[0] == face[1]) {
-	return 0;
-    }
-    if (face[0] == face[2]) {
-	return 0;
-    }
-    if (face[1] == face[2]) {
-	return 0;
-    }
-    return 1;
-}
-
 static void
 Convert_input(NODE *node)
 {
@@ -102,30 +87,28 @@ Convert_input(NODE *node)
     bu_vls_strcpy(&region_name, rname);
 
     if (node->ispoly) {
-	int tmp_face[3] = {0, 0, 0};
-	for (vert_no = 0; vert_no < vertsize; vert_no++) {
-	    double x, y, z;
-	    x = allvert[vert_no*3];
-	    y = allvert[vert_no*3+1];
-	    z = allvert[vert_no*3+2];
-
-	    tmp_face[vert_no%3] = bg_vert_tree_add( tree,x, y, z, 0.0);
-
-	    if (((vert_no+1)%3 == 0) && (vert_no != 0) ) {
-		if (Check_degenerate(tmp_face)) {
-		    VMOVE(&bot_faces[3*bot_fcurr], tmp_face);
-		    bot_fcurr++;
-		    face_count++;
-		}
-	    }
-	}
+	size_t *remap;
+	fastf_t *verts;
+	size_t nverts;
+
+	/* weld the triangle corners, dropping the triangles that collapse */
+	remap = (size_t *)bu_malloc((vertsize + 1) * sizeof(size_t), "remap");
+	nverts = bg_weld_pnts(&verts, remap, allvert, vertsize, 0.0);
+	for (vert_no = 0; vert_no < vertsize - vertsize % 3; vert_no++)
+	    bot_faces[vert_no] = vert_no;
+	bot_fcurr = (int)bg_weld_faces(bot_faces, vertsize / 3, remap);
+	face_count = bot_fcurr;
+	bu_free(remap, "remap");
+
 	if (face_count == 0) {
+	    if (verts)
+		bu_free(verts, "verts");
 	    objnumb--;
 	    return;
 	}
-	mk_bot(fd_out, bu_vls_addr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, tree->curr_vert, bot_fcurr,
-	tree->the_array, bot_faces, NULL, NULL);
-	bg_vert_tree_clean(tree);
+	mk_bot(fd_out, bu_vls_addr(&solid_name), RT_BOT_SOLID, RT_BOT_UNORIENTED, 0, nverts, bot_fcurr,
+	verts, bot_faces, NULL, NULL);
+	bu_free(verts, "verts");
     }else if (node->nnodetype == NODE_CONE) {
 	mk_tgc(fd_out,bu_vls_addr(&solid_name), &allvert[0], &allvert[3], &allvert[6], &allvert[9], &allvert[12], &allvert[15]);
     }else if (node->nnodetype == NODE_BOX) {
@@ -248,9 +231,6 @@ vrml_read(struct gcv_context *context, const struct gcv_opts *gcv_options, const
     }
 
     BU_LIST_INIT(&all_head.l);
-    /* create a tree structure to hold the input vertices */
-    tree = bg_vert_tree_create();
-
     Parse_input(childlist);
     fclose(fd_in);
 
@@ -53,8 +53,11 @@ ged_close_core(struct ged *gedp, int UNUSED(argc), const char **UNUSED(argv))
     ged_exec_zap(gedp, 1, (const char **)av);
 
     /* close current database */
-    if (gedp->dbip)
+    if (gedp->dbip) {
+	/* ged_lod is ours - detach it before it goes away */
+	db_mesh_lod_context_set(gedp->dbip, NULL);
 	db_close(gedp->dbip);
+    }
     gedp->dbip = NULL;
 
     /* Clean up any old acceleration states, if present */
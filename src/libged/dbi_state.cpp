@@ -1291,6 +1291,10 @@ DbiState::get_bbox(point_t *bbmin, point_t *bbmax, matp_t curr_mat, unsigned lon
 		    s.write(reinterpret_cast<const char *>(&bmax), sizeof(bmax));
 		    cache_write(dcache, hash, CACHE_OBJ_BOUNDS, s);
 		}
+	    } else {
+		// Being drawn without LoD data - if background generation
+		// is running, have it do this one next
+		(void)db_mesh_lod_prioritize(dbip, dp->d_namep);
 	    }
 	}
     }
@@ -38,13 +38,18 @@
 #include "./tessellate.h"
 
 int
-_brep_csg_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s)
+_brep_csg_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s, const char *ofile)
 {
     if (!gedp || !dp || !s)
 	return BRLCAD_ERROR;
 
+    // When we have an output file, the CSG tree is built there and left
+    // for the caller rather than being merged back into gedp
     char tmpfil[MAXPATHLEN];
-    bu_dir(tmpfil, MAXPATHLEN, BU_DIR_TEMP, bu_temp_file_name(NULL, 0), NULL);
+    if (ofile)
+	bu_strlcpy(tmpfil, ofile, MAXPATHLEN);
+    else
+	bu_dir(tmpfil, MAXPATHLEN, BU_DIR_TEMP, bu_temp_file_name(NULL, 0), NULL);
 
     const char *av[MAXPATHLEN];
     av[0] = "keep";
@@ -109,6 +114,9 @@ _brep_csg_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s)
     bu_vls_free(&comb_name);
     ged_close(wgedp);
 
+    if (ofile)
+	return BRLCAD_OK;
+
     std::string oname(dp->d_namep);
 
     av[0] = "dbconcat";
@@ -89,7 +89,7 @@ method_setup(tess_opts *s)
 }
 
 static int
-dp_tessellate(struct rt_bot_internal **obot, struct bu_vls *method_flag, struct ged *gedp, struct directory *dp, tess_opts *s)
+dp_tessellate(struct rt_bot_internal **obot, struct bu_vls *method_flag, struct ged *gedp, struct directory *dp, tess_opts *s, const char *ofile)
 {
     if (!s || !obot || !method_flag || !gedp || !dp)
 	return BRLCAD_ERROR;
@@ -207,7 +207,7 @@ dp_tessellate(struct rt_bot_internal **obot, struct bu_vls *method_flag, struct
     // For brep in particular, we have a cheat we can try.  Do a brep->csg
     // conversion and see if the resulting CSG tree can be facetized.
     if (intern.idb_minor_type == ID_BREP) {
-	ret = _brep_csg_tessellate(gedp, dp, s);
+	ret = _brep_csg_tessellate(gedp, dp, s, ofile);
     	if (ret == BRLCAD_OK) {
 	    bu_vls_sprintf(method_flag, "NMG_BREP_CSG");
 	    return BRLCAD_OK;
@@ -298,6 +298,86 @@ pnt_sampling_methods:
     return BRLCAD_ERROR;
 }
 
+/* Tessellate one object, writing the result either into the input database
+ * or, if ofile is set, into a new database file of its own */
+static int
+obj_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s, const char *ofile)
+{
+    // If this isn't a proper BRL-CAD object, tessellation is a no-op
+    if (dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	return BRLCAD_OK;
+
+    // Trigger the core tessellation routines
+    struct rt_bot_internal *obot = NULL;
+    struct bu_vls method_flag = BU_VLS_INIT_ZERO;
+    if (dp_tessellate(&obot, &method_flag, gedp, dp, s, ofile) != BRLCAD_OK) {
+	bu_vls_free(&method_flag);
+	return BRLCAD_ERROR;
+    }
+
+    // If we used a BRep CSG tree, we're already done.  If we didn't get
+    // anything and we had an OK code, there's nothing to write.
+    if (BU_STR_EQUAL(bu_vls_cstr(&method_flag), "NMG_BREP_CSG") || !obot) {
+	bu_vls_free(&method_flag);
+	return BRLCAD_OK;
+    }
+
+    // If we've got something to write, handle it
+    struct bu_vls obot_name = BU_VLS_INIT_ZERO;
+    if (s->overwrite_obj) {
+	bu_vls_sprintf(&obot_name, "%s", dp->d_namep);
+    } else {
+	bu_vls_sprintf(&obot_name, "%s_tess.bot", dp->d_namep);
+    }
+    struct db_i *odbip = (ofile) ? db_create(ofile, 5) : gedp->dbip;
+    if (!odbip) {
+	bu_vls_free(&method_flag);
+	bu_vls_free(&obot_name);
+	return BRLCAD_ERROR;
+    }
+    // NOTE: _tess_facetize_write_bot frees obot
+    int ret = _tess_facetize_write_bot(odbip, obot, bu_vls_cstr(&obot_name), bu_vls_cstr(&method_flag));
+    if (ofile)
+	db_close(odbip);
+    bu_vls_free(&method_flag);
+    bu_vls_free(&obot_name);
+
+    return ret;
+}
+
+/* Worker mode - rather than processing a fixed object list, take jobs of
+ * the form "output.g<TAB>object" from stdin, one per line, until stdin is
+ * closed.  Each result goes to its own output file, so the parent can merge
+ * it into the working database without any of our writes being able to
+ * damage that database, and completion is reported on stdout. */
+static int
+facetize_worker(struct ged *gedp, tess_opts *s)
+{
+    struct bu_vls line = BU_VLS_INIT_ZERO;
+    while (bu_vls_gets(&line, stdin) >= 0) {
+	const char *l = bu_vls_cstr(&line);
+	const char *tab = strchr(l, '\t');
+	if (!tab) {
+	    bu_vls_trunc(&line, 0);
+	    continue;
+	}
+	std::string ofile(l, tab - l);
+	std::string oname(tab + 1);
+	bu_vls_trunc(&line, 0);
+
+	int ret = BRLCAD_ERROR;
+	struct directory *dp = db_lookup(gedp->dbip, oname.c_str(), LOOKUP_NOISY);
+	if (dp)
+	    ret = obj_tessellate(gedp, dp, s, ofile.c_str());
+
+	fprintf(stdout, "%s %d\n", FACETIZE_WORKER_DONE, ret);
+	fflush(stdout);
+    }
+    bu_vls_free(&line);
+
+    return BRLCAD_OK;
+}
+
 void
 print_methods_info()
 {
@@ -331,16 +411,18 @@ facetize_process(int argc, const char **argv)
     // Done with prog name
     argc--; argv++;
 
-    static const char *usage = "Usage: ged_exec facetize_process [options] file.g input_obj [input_object_2 ...]\n";
+    static const char *usage = "Usage: ged_exec facetize_process [options] file.g input_obj [input_object_2 ...]\n"
+	"       ged_exec facetize_process --worker [options] file.g\n";
     int print_help = 0;
     struct bu_vls cache_dir = BU_VLS_INIT_ZERO;
     tess_opts s;
 
     int list_methods = 0;
+    int worker = 0;
     int max_time = 0;
     int max_pnts = 0;
 
-    struct bu_opt_desc d[ 9];
+    struct bu_opt_desc d[10];
     BU_OPT(d[ 0],  "h",         "help",                         "",                  NULL,           &print_help, "Print help and exit");
     BU_OPT(d[ 1],   "", "list-methods",                         "",                  NULL,         &list_methods, "List available tessellation methods.  When used with -h, print an informational summary of each method.");
     BU_OPT(d[ 2],  "O",    "overwrite",                         "",                  NULL,    &(s.overwrite_obj), "Replace original object with BoT");
@@ -349,7 +431,8 @@ facetize_process(int argc, const char **argv)
     BU_OPT(d[ 5],   "",     "max-time",                        "#",           &bu_opt_int,             &max_time, "Maximum number of seconds to allow for runtime (not supported by all methods).");
     BU_OPT(d[ 6],   "",     "max-pnts",                        "#",           &bu_opt_int,             &max_pnts, "Maximum number of pnts to use when applying ray sampling methods.");
     BU_OPT(d[ 7],   "",     "cache-dir",                     "dir",           &bu_opt_vls,            &cache_dir, "Directory to use for cached outputs (default is libbu cache directory).");
-    BU_OPT_NULL(d[ 8]);
+    BU_OPT(d[ 8],   "",       "worker",                         "",                  NULL,               &worker, "Process jobs read from stdin, writing each result to its own file, until stdin is closed");
+    BU_OPT_NULL(d[ 9]);
 
     /* parse options */
     struct bu_vls omsg = BU_VLS_INIT_ZERO;
@@ -405,6 +488,13 @@ facetize_process(int argc, const char **argv)
 	return BRLCAD_ERROR;
     }
 
+    if (worker) {
+	int wret = facetize_worker(gedp, &s);
+	ged_close(gedp);
+	bu_vls_free(&cache_dir);
+	return wret;
+    }
+
     // Translate specified object names to directory pointers
     struct bu_ptbl dps = BU_PTBL_INIT_ZERO;
     for (int i = 1; i < argc; i++) {
@@ -420,48 +510,11 @@ facetize_process(int argc, const char **argv)
     // than parallel because of the risks of high memory consumption and/or
     // CPU utilization for individual object operations.
     for (size_t i = 0; i < BU_PTBL_LEN(&dps); i++) {
-
-	// If this isn't a proper BRL-CAD object, tessellation is a no-op
 	struct directory *dp = (struct directory *)BU_PTBL_GET(&dps, i);
-	if (dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
-	    continue;
-
-	// Trigger the core tessellation routines
-	struct rt_bot_internal *obot = NULL;
-	struct bu_vls method_flag = BU_VLS_INIT_ZERO;
-	if (dp_tessellate(&obot, &method_flag, gedp, dp, &s) != BRLCAD_OK) {
-	    bu_vls_free(&method_flag);
-	    return BRLCAD_ERROR;
-	}
-
-	// If we used a BRep CSG tree, we're already done
-	if (BU_STR_EQUAL(bu_vls_cstr(&method_flag), "NMG_BREP_CSG")) {
-	    bu_vls_free(&method_flag);
-	    continue;
-	}
-
-	// If we didn't get anything and we had an OK code, just keep going
-	if (!obot) {
-	    bu_vls_free(&method_flag);
-	    continue;
-	}
-
-	// If we've got something to write, handle it
-	struct bu_vls obot_name = BU_VLS_INIT_ZERO;
-	if (s.overwrite_obj) {
-	    bu_vls_sprintf(&obot_name, "%s", dp->d_namep);
-	} else {
-	    bu_vls_sprintf(&obot_name, "%s_tess.bot", dp->d_namep);
-	}
-	// NOTE: _tess_facetize_write_bot frees obot
-	int ret = _tess_facetize_write_bot(gedp->dbip, obot, bu_vls_cstr(&obot_name), bu_vls_cstr(&method_flag));
-	bu_vls_free(&method_flag);
-	bu_vls_free(&obot_name);
-	if (ret != BRLCAD_OK) {
+	if (obj_tessellate(gedp, dp, &s, NULL) != BRLCAD_OK) {
 	    bu_vls_free(&cache_dir);
 	    return BRLCAD_ERROR;
 	}
-
     }
 
     bu_vls_free(&cache_dir);
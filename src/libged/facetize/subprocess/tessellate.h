@@ -61,7 +61,7 @@ extern struct rt_pnts_internal *
 _tess_pnts_sample(const char *oname, struct db_i *dbip, tess_opts *s);
 
 extern int
-_brep_csg_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s);
+_brep_csg_tessellate(struct ged *gedp, struct directory *dp, tess_opts *s, const char *ofile);
 
 extern int
 _nmg_tessellate(struct rt_bot_internal **nbot, struct rt_db_internal *intern, tess_opts *s);
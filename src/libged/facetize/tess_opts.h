@@ -41,6 +41,10 @@
 #include "bg/spsr.h"
 #include "raytrace.h"
 
+// Line a facetize_process --worker subprocess writes to stdout, followed by
+// the job's return code, when it has finished an object
+#define FACETIZE_WORKER_DONE "FACETIZE_WORKER_DONE"
+
 class method_options_t {
     public:
 
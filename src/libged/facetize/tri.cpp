@@ -32,12 +32,18 @@
 #include <iostream>
 #include <fstream>
 #include <queue>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include <string.h>
 
 #include "manifold/manifold.h"
 
 #include "bu/app.h"
+#include "bu/file.h"
+#include "bu/parallel.h"
 #include "bu/path.h"
 #include "bu/snooze.h"
 #include "bu/time.h"
@@ -46,6 +52,29 @@
 #include "./tess_opts.h"
 #include "./subprocess.h"
 
+// Triangle counts of the Manifold meshes alive during a boolean evaluation.
+// The peak is what we report as the memory cost of an evaluation strategy.
+static std::atomic<size_t> bool_live_tris(0);
+static std::atomic<size_t> bool_peak_tris(0);
+
+static void
+bool_tris_add(manifold::Manifold *m)
+{
+    if (!m)
+	return;
+    size_t live = (bool_live_tris += m->NumTri());
+    size_t peak = bool_peak_tris.load();
+    while (live > peak && !bool_peak_tris.compare_exchange_weak(peak, live));
+}
+
+static void
+bool_tris_sub(manifold::Manifold *m)
+{
+    if (!m)
+	return;
+    bool_live_tris -= m->NumTri();
+}
+
 static int
 bot_to_manifold(void **out, struct db_tree_state *tsp, struct rt_db_internal *ip, int flip)
 {
@@ -108,6 +137,7 @@ bot_to_manifold(void **out, struct db_tree_state *tsp, struct rt_db_internal *ip
 
     // Passed - return the manifold
     (*out) = new manifold::Manifold(bot_manifold);
+    bool_tris_add((manifold::Manifold *)(*out));
     return 0;
 }
 
@@ -376,7 +406,8 @@ manifold_do_bool(
 	    result = new manifold::Manifold(bool_out);
     }
 
-    // Memory cleanup
+    // Memory cleanup - the inputs are counted as alive until the result exists
+    bool_tris_add(result);
     if (delete_left)
 	delete lm;
     if (delete_right)
@@ -384,11 +415,13 @@ manifold_do_bool(
 
     if (tl->tr_d.td_d) {
 	manifold::Manifold *m = (manifold::Manifold *)tl->tr_d.td_d;
+	bool_tris_sub(m);
 	delete m;
 	tl->tr_d.td_d = NULL;
     }
     if (tr->tr_d.td_d) {
 	manifold::Manifold *m = (manifold::Manifold *)tr->tr_d.td_d;
+	bool_tris_sub(m);
 	delete m;
 	tr->tr_d.td_d = NULL;
     }
@@ -403,6 +436,271 @@ manifold_do_bool(
     return 0;
 }
 
+// Build a balanced union tree over ops[lo, hi), reusing the union nodes of
+// the chain being replaced.
+static union tree *
+booltree_union_build(std::vector<union tree *> &ops, size_t lo, size_t hi, std::vector<union tree *> &unodes, size_t *ui)
+{
+    if (hi - lo == 1)
+	return ops[lo];
+    size_t mid = lo + (hi - lo) / 2;
+    union tree *tp = unodes[(*ui)++];
+    tp->tr_op = OP_UNION;
+    tp->tr_b.tb_regionp = REGION_NULL;
+    tp->tr_b.tb_left = booltree_union_build(ops, lo, mid, unodes, ui);
+    tp->tr_b.tb_right = booltree_union_build(ops, mid, hi, unodes, ui);
+    return tp;
+}
+
+// facetize_region_end accumulates regions into a left-deep union chain, and
+// combs with many members produce the same shape.  Evaluated as is, every
+// step re-processes an ever growing intermediate mesh and nothing can run
+// concurrently.  Union is associative and commutative, so rewrite each
+// maximal chain of unions as a balanced tree.  Half space leaves are kept on
+// the right of the top unions, since manifold_do_bool can't take them as a
+// left operand.
+static union tree *
+booltree_rebalance(union tree *tp)
+{
+    if (!tp)
+	return tp;
+
+    if (tp->tr_op == OP_INTERSECT || tp->tr_op == OP_SUBTRACT) {
+	tp->tr_b.tb_left = booltree_rebalance(tp->tr_b.tb_left);
+	tp->tr_b.tb_right = booltree_rebalance(tp->tr_b.tb_right);
+	return tp;
+    }
+    if (tp->tr_op != OP_UNION)
+	return tp;
+
+    // Collect the operands of the chain in their original order
+    std::vector<union tree *> ops, hspaces, unodes;
+    std::vector<union tree *> stack = {tp};
+    while (!stack.empty()) {
+	union tree *c = stack.back();
+	stack.pop_back();
+	if (c->tr_op == OP_UNION) {
+	    unodes.push_back(c);
+	    stack.push_back(c->tr_b.tb_right);
+	    stack.push_back(c->tr_b.tb_left);
+	    continue;
+	}
+	if (c->tr_op == OP_TESS && c->tr_d.td_i) {
+	    hspaces.push_back(c);
+	    continue;
+	}
+	ops.push_back(booltree_rebalance(c));
+    }
+
+    size_t ui = 0;
+    union tree *root = NULL;
+    size_t hi = 0;
+    if (ops.size()) {
+	root = booltree_union_build(ops, 0, ops.size(), unodes, &ui);
+    } else {
+	root = hspaces[0];
+	hi = 1;
+    }
+    for (; hi < hspaces.size(); hi++) {
+	union tree *u = unodes[ui++];
+	u->tr_op = OP_UNION;
+	u->tr_b.tb_regionp = REGION_NULL;
+	u->tr_b.tb_left = root;
+	u->tr_b.tb_right = hspaces[hi];
+	root = u;
+    }
+    return root;
+}
+
+// Drop whatever a leaf of an evaluated boolean is holding, without
+// touching the tree node itself.
+static void
+booltree_leaf_release(union tree *tp)
+{
+    if (tp->tr_op != OP_TESS)
+	return;
+    if (tp->tr_d.td_d) {
+	manifold::Manifold *m = (manifold::Manifold *)tp->tr_d.td_d;
+	bool_tris_sub(m);
+	delete m;
+	tp->tr_d.td_d = NULL;
+    }
+    if (tp->tr_d.td_i) {
+	struct rt_half_internal *hf_ip = (struct rt_half_internal *)tp->tr_d.td_i->idb_ptr;
+	BU_PUT(hf_ip, struct rt_half_internal);
+	BU_PUT(tp->tr_d.td_i, struct rt_db_internal);
+	tp->tr_d.td_i = NULL;
+    }
+}
+
+// rt_uniresource's tree free lists are shared by all the workers
+static void
+booltree_free(union tree *tp, std::mutex *tlock)
+{
+    std::lock_guard<std::mutex> guard(*tlock);
+    db_free_tree(tp, &rt_uniresource);
+}
+
+// Evaluate one boolean node whose children have both been reduced to either
+// an OP_TESS leaf or OP_NOP.  This is the per-node step of
+// rt_booltree_evaluate, with the node left as OP_TESS or OP_NOP.
+static void
+booltree_eval_node(struct _ged_facetize_state *s, union tree *tp, std::mutex *tlock)
+{
+    const char *op_str = NULL;
+    switch (tp->tr_op) {
+	case OP_UNION:
+	    op_str = " u ";
+	    break;
+	case OP_INTERSECT:
+	    op_str = " + ";
+	    break;
+	case OP_SUBTRACT:
+	    op_str = " - ";
+	    break;
+	default:
+	    bu_bomb("booltree_eval_node(): bad op\n");
+    }
+
+    union tree *tl = tp->tr_b.tb_left;
+    union tree *tr = tp->tr_b.tb_right;
+
+    if (tl->tr_op != OP_TESS || tr->tr_op != OP_TESS) {
+	// At most one side has geometry.  A union keeps either side, a
+	// subtraction only the left, an intersection nothing.
+	union tree *keep = NULL;
+	if (tl->tr_op == OP_TESS && tp->tr_op != OP_INTERSECT)
+	    keep = tl;
+	if (tr->tr_op == OP_TESS && tp->tr_op == OP_UNION)
+	    keep = tr;
+	if (keep) {
+	    // Hand the whole leaf over, as rt_booltree_evaluate does,
+	    // including a halfspace's internal (td_i)
+	    tp->tr_op = OP_TESS;
+	    tp->tr_d.td_name = keep->tr_d.td_name;
+	    tp->tr_d.td_r = keep->tr_d.td_r;
+	    tp->tr_d.td_d = keep->tr_d.td_d;
+	    tp->tr_d.td_i = keep->tr_d.td_i;
+	    keep->tr_d.td_name = NULL;
+	    keep->tr_d.td_r = NULL;
+	    keep->tr_d.td_d = NULL;
+	    keep->tr_d.td_i = NULL;
+	} else {
+	    tp->tr_op = OP_NOP;
+	}
+	booltree_leaf_release(tl);
+	booltree_leaf_release(tr);
+	booltree_free(tl, tlock);
+	booltree_free(tr, tlock);
+	return;
+    }
+
+    int b = manifold_do_bool(tp, tl, tr, tp->tr_op, NULL, NULL, (void *)s);
+    if (b) {
+	tp->tr_op = OP_NOP;
+    } else {
+	size_t rem = strlen(tl->tr_d.td_name) + 3 + strlen(tr->tr_d.td_name) + 2 + 1;
+	char *name = (char *)bu_calloc(rem, sizeof(char), "booltree_eval_node name");
+	snprintf(name, rem, "(%s%s%s)", tl->tr_d.td_name, op_str, tr->tr_d.td_name);
+	tp->tr_d.td_name = name;
+	tp->tr_d.td_r = NULL;
+	tp->tr_d.td_i = NULL;
+    }
+    booltree_leaf_release(tl);
+    booltree_leaf_release(tr);
+    booltree_free(tl, tlock);
+    booltree_free(tr, tlock);
+}
+
+struct booltree_job {
+    union tree *tp;
+    long parent;
+    int pending;
+};
+
+// Evaluate the boolean tree with a bounded pool of workers.  Every boolean
+// node depends only on its two children, so the tree is its own dependency
+// graph: a node becomes ready once both children are reduced, and nodes in
+// different subtrees are evaluated concurrently.  Which meshes are combined
+// with which is fixed by the tree, so the result does not depend on the
+// scheduling.  Ready nodes are taken newest first, finishing subtrees before
+// starting new ones to keep the number of live intermediate meshes down.
+static union tree *
+booltree_evaluate_parallel(struct _ged_facetize_state *s, union tree *root)
+{
+    std::vector<booltree_job> jobs;
+    std::vector<size_t> ready;
+    size_t remaining = 0;
+
+    std::vector<std::pair<union tree *, long>> stack = {{root, -1}};
+    while (!stack.empty()) {
+	std::pair<union tree *, long> c = stack.back();
+	stack.pop_back();
+	booltree_job j = {c.first, c.second, 0};
+	long ind = (long)jobs.size();
+	switch (c.first->tr_op) {
+	    case OP_UNION:
+	    case OP_INTERSECT:
+	    case OP_SUBTRACT:
+		j.pending = 2;
+		remaining++;
+		stack.push_back(std::make_pair(c.first->tr_b.tb_right, ind));
+		stack.push_back(std::make_pair(c.first->tr_b.tb_left, ind));
+		break;
+	    default:
+		break;
+	}
+	jobs.push_back(j);
+    }
+
+    // Leaves are already evaluated - release their parents
+    for (size_t i = jobs.size(); i > 0; i--) {
+	booltree_job &j = jobs[i-1];
+	if (j.pending || j.parent < 0)
+	    continue;
+	if (--jobs[j.parent].pending == 0)
+	    ready.push_back(j.parent);
+    }
+
+    std::mutex qlock;
+    std::mutex tlock;
+    std::condition_variable qcv;
+    auto worker = [&]() {
+	std::unique_lock<std::mutex> lk(qlock);
+	while (remaining) {
+	    if (ready.empty()) {
+		qcv.wait(lk);
+		continue;
+	    }
+	    size_t i = ready.back();
+	    ready.pop_back();
+	    lk.unlock();
+	    booltree_eval_node(s, jobs[i].tp, &tlock);
+	    lk.lock();
+	    remaining--;
+	    long p = jobs[i].parent;
+	    if (p >= 0 && --jobs[p].pending == 0) {
+		ready.push_back(p);
+		qcv.notify_one();
+	    }
+	    if (!remaining)
+		qcv.notify_all();
+	}
+    };
+
+    size_t ncpus = (size_t)bu_avail_cpus();
+    size_t nworkers = std::min(std::max(ncpus, (size_t)1), remaining);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < nworkers; i++)
+	workers.push_back(std::thread(worker));
+    for (size_t i = 0; i < workers.size(); i++)
+	workers[i].join();
+
+    if (root->tr_op != OP_TESS)
+	return TREE_NULL;
+    return root;
+}
+
 std::vector<std::string>
 tess_avail_methods()
 {
@@ -441,187 +739,250 @@ tess_avail_methods()
     return methods;
 }
 
-int
-tess_run(struct _ged_facetize_state *s, const char **tess_cmd, int tess_cmd_cnt, fastf_t max_time, int ocnt)
-{
-    if (!s || !tess_cmd || !tess_cmd[3])
-	return BRLCAD_ERROR;
+/* One long-lived facetize_process --worker subprocess and the job, if any,
+ * it is currently working on */
+struct tess_worker {
+    struct subprocess_s p;
+    bool running = false;
+    struct directory *dp = NULL;
+    std::string ofile;
+    std::string obuf;
+    int64_t start = 0;
+};
 
-    std::string wfile(tess_cmd[3]);
-    std::string wfilebak = wfile + std::string(".bak");
-    {
-	// Before the run, prepare a backup file
-	std::ifstream workfile(wfile, std::ios::binary);
-	std::ofstream bakfile(wfilebak, std::ios::binary);
-	if (!workfile.is_open() || !bakfile.is_open()) {
-	    bu_log("Unable to create backup file %s\n", wfilebak.c_str());
-	    return BRLCAD_ERROR;
-	}
-	bakfile << workfile.rdbuf();
-	workfile.close();
-	bakfile.close();
+static bool
+tess_worker_start(struct _ged_facetize_state *s, struct tess_worker *w, const char **cmd)
+{
+    if (subprocess_create(cmd, subprocess_option_no_window|subprocess_option_enable_async|subprocess_option_inherit_environment, &w->p)) {
+	facetize_log(s, 0, "Unable to create subprocess\n");
+	return false;
     }
+    w->running = true;
+    w->obuf.clear();
+    return true;
+}
 
-    // Record the actual command being use to trigger the subprocess
-    struct bu_vls cmd = BU_VLS_INIT_ZERO;
-    for (int i = 0; i < tess_cmd_cnt ; i++)
-	bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-    facetize_log(s, 2, "%s\n", bu_vls_cstr(&cmd));
-    bu_vls_free(&cmd);
+static void
+tess_worker_stop(struct tess_worker *w, bool kill)
+{
+    if (!w->running)
+	return;
+    if (kill)
+	subprocess_terminate(&w->p);
+    // Closing stdin tells a live worker we're done
+    int w_rc;
+    (void)subprocess_join(&w->p, &w_rc);
+    subprocess_destroy(&w->p);
+    w->running = false;
+}
 
-    // If we're not being verbose, just report how many objects we're working on
-    if (ocnt == 1)
-	facetize_log(s, 0, "Attempting to triangulate %s...", tess_cmd[tess_cmd_cnt-ocnt]);
-    if (ocnt > 1)
-	facetize_log(s, 0, "Attempting to triangulate %d solids...", ocnt);
+/* Pass along worker output, watching for the job completion line.  Returns
+ * the job's return code once it has finished, else -1. */
+static int
+tess_worker_poll(struct _ged_facetize_state *s, struct tess_worker *w)
+{
+    char buf[MAXPATHLEN*10];
+    unsigned n;
+    while ((n = subprocess_read_stderr(&w->p, buf, sizeof(buf) - 1)) > 0) {
+	buf[n] = '\0';
+	facetize_log(s, 1, "%s", buf);
+    }
+    while ((n = subprocess_read_stdout(&w->p, buf, sizeof(buf) - 1)) > 0)
+	w->obuf.append(buf, n);
+
+    int ret = -1;
+    size_t eol;
+    while (ret < 0 && (eol = w->obuf.find('\n')) != std::string::npos) {
+	std::string line = w->obuf.substr(0, eol);
+	w->obuf.erase(0, eol + 1);
+	if (line.compare(0, strlen(FACETIZE_WORKER_DONE), FACETIZE_WORKER_DONE) == 0) {
+	    ret = (atoi(line.c_str() + strlen(FACETIZE_WORKER_DONE)) == BRLCAD_OK) ? BRLCAD_OK : BRLCAD_ERROR;
+	} else {
+	    facetize_log(s, 1, "%s\n", line.c_str());
+	}
+    }
+    return ret;
+}
 
-    int64_t start = bu_gettime();
-    int64_t elapsed = 0;
-    fastf_t seconds = 0.0;
-    tess_cmd[tess_cmd_cnt] = NULL; // Make sure we're NULL terminated
-    struct subprocess_s p;
-    if (subprocess_create(tess_cmd, subprocess_option_no_window|subprocess_option_enable_async|subprocess_option_inherit_environment, &p)) {
-	// Unable to create subprocess??
-	facetize_log(s, 0, " FAILED.\n");
-	facetize_log(s, 0, "Unable to create subprocess\n");
+/* Copy everything a job wrote to its output file into the working
+ * database, replacing same-named objects */
+static int
+tess_journal_merge(struct db_i *wdbip, const char *ofile)
+{
+    // No output file means the job had nothing to write
+    if (!bu_file_exists(ofile, NULL))
+	return BRLCAD_OK;
 
+    struct db_i *jdbip = db_open(ofile, DB_OPEN_READONLY);
+    if (!jdbip)
+	return BRLCAD_ERROR;
+    if (db_dirbuild(jdbip) < 0) {
+	db_close(jdbip);
 	return BRLCAD_ERROR;
     }
-    while (subprocess_alive(&p)) {
-	std::this_thread::sleep_for(std::chrono::milliseconds(100));
-	elapsed = bu_gettime() - start;
-	seconds = elapsed / 1000000.0;
-
-	// Check for and pass along intermediate output
-	char curr_out[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stdout(&p, curr_out, MAXPATHLEN*10);
-	if (strlen(curr_out))
-	    facetize_log(s, 1, "%s", curr_out);
-	char curr_err[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stderr(&p, curr_err, MAXPATHLEN*10);
-	if (strlen(curr_err))
-	    facetize_log(s, 1, "%s", curr_err);
-
-	if (seconds > max_time) {
-	    // if we timeout, cleanup and return error
-	    subprocess_terminate(&p);
-
-	    facetize_log(s, 0, " FAILED.\n");
-
-	    facetize_log(s, 0, "tess_run subprocess killed %g %g\n", seconds, max_time);
-	    if (s->verbosity >= 0) {
-		char mraw[MAXPATHLEN*10] = {'\0'};
-		subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-		if (strlen(mraw))
-		    facetize_log(s, 0, "%s\n", mraw);
-		char mraw2[MAXPATHLEN*10] = {'\0'};
-		subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-		if (strlen(mraw2))
-		    facetize_log(s, 0, "%s\n", mraw2);
-	    }
-	    subprocess_destroy(&p);
-
-	    // Because we had to kill the process, there's no way of knowing
-	    // whether we interrupted I/O in a state that could result in a
-	    // corrupted .g file.  Restore the pre-run state of the .g file -
-	    // we may have to redo some work, but this at least ensures we
-	    // won't have strange garbage corrupting subsequent processing.
-	    std::ifstream bakfile(wfilebak, std::ios::binary);
-	    std::ofstream workfile(wfile, std::ios::binary);
-	    if (!workfile.is_open() || !bakfile.is_open())
-		return BRLCAD_ERROR;
-	    workfile << bakfile.rdbuf();
-	    workfile.close();
-	    bakfile.close();
-
 
-	    return BRLCAD_ERROR;
+    int ret = BRLCAD_OK;
+    struct directory *dp;
+    FOR_ALL_DIRECTORY_START(dp, jdbip) {
+	if (dp->d_major_type != DB5_MAJORTYPE_BRLCAD)
+	    continue;
+	struct rt_db_internal intern;
+	RT_DB_INTERNAL_INIT(&intern);
+	if (rt_db_get_internal(&intern, dp, jdbip, NULL, &rt_uniresource) < 0) {
+	    ret = BRLCAD_ERROR;
+	    continue;
 	}
-    }
-    int w_rc;
-    if (subprocess_join(&p, &w_rc)) {
-	// Unable to join??
-	facetize_log(s, 0, " FAILED.\n");
-	facetize_log(s, 0, "tess_run subprocess unable to join\n");
-	if (s->verbosity >= 0) {
-	    char mraw[MAXPATHLEN*10] = {'\0'};
-	    subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-	    if (strlen(mraw))
-		facetize_log(s, 0, "%s\n", mraw);
-	    char mraw2[MAXPATHLEN*10] = {'\0'};
-	    subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-	    if (strlen(mraw2))
-		facetize_log(s, 0, "%s\n", mraw2);
+	struct directory *odp = db_lookup(wdbip, dp->d_namep, LOOKUP_QUIET);
+	if (odp) {
+	    db_delete(wdbip, odp);
+	    db_dirdelete(wdbip, odp);
 	}
-	return BRLCAD_ERROR;
-    }
+	int flags = dp->d_flags & (RT_DIR_SOLID|RT_DIR_COMB|RT_DIR_REGION);
+	struct directory *ndp = db_diradd(wdbip, dp->d_namep, RT_DIR_PHONY_ADDR, 0, flags, (void *)&intern.idb_type);
+	if (ndp == RT_DIR_NULL || rt_db_put_internal(ndp, wdbip, &intern, &rt_uniresource) < 0) {
+	    rt_db_free_internal(&intern);
+	    ret = BRLCAD_ERROR;
+	}
+    } FOR_ALL_DIRECTORY_END;
 
-    bu_file_delete(wfilebak.c_str());
-
-    if (s->verbosity >= 0) {
-	char mraw[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stdout(&p, mraw, MAXPATHLEN*10);
-	if (strlen(mraw))
-	    facetize_log(s, 0, "%s\n", mraw);
-	char mraw2[MAXPATHLEN*10] = {'\0'};
-	subprocess_read_stderr(&p, mraw2, MAXPATHLEN*10);
-	if (strlen(mraw2))
-	    facetize_log(s, 0, "%s\n", mraw2);
-    }
+    db_close(jdbip);
+    return ret;
+}
 
-    // Needed to clean up file handles
-    subprocess_destroy(&p);
+/* Tessellate each of dps in its own job on a pool of worker subprocesses,
+ * one per processor, collecting the objects that fail or time out in
+ * bad_dps.
+ *
+ * Workers never write to the working file.  Each job's result goes to a
+ * small output file of its own which we merge once the job reports success,
+ * so a worker killed on timeout can only lose its current job - there is
+ * nothing in the working file to restore. */
+static int
+tess_pool_run(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &dps, const char **tess_cmd, int cmd_cnt, fastf_t max_time)
+{
+    if (!dps.size())
+	return 0;
 
-    if (w_rc == BRLCAD_OK) {
-	facetize_log(s, 0, " Success.\n");
-    } else {
-	facetize_log(s, 0, " FAILED.\n");
+    // Worker command - the same as for a single run, in worker mode and
+    // without any objects
+    const char *wcmd[MAXPATHLEN] = {NULL};
+    int wcnt = 0;
+    wcmd[wcnt++] = tess_cmd[0];
+    wcmd[wcnt++] = tess_cmd[1];
+    wcmd[wcnt++] = "--worker";
+    for (int i = 2; i < cmd_cnt; i++) {
+	if (tess_cmd[i])
+	    wcmd[wcnt++] = tess_cmd[i];
     }
+    wcmd[wcnt] = NULL;
 
-    return (w_rc ? BRLCAD_ERROR : BRLCAD_OK);
-}
+    // Record the actual command being use to trigger the subprocesses
+    struct bu_vls cmd = BU_VLS_INIT_ZERO;
+    for (int i = 0; i < wcnt; i++)
+	bu_vls_printf(&cmd, "%s ", wcmd[i]);
+    facetize_log(s, 2, "%s\n", bu_vls_cstr(&cmd));
+    bu_vls_free(&cmd);
 
-int
-bisect_run(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time, int ocnt);
+    struct db_i *wdbip = db_open(bu_vls_cstr(s->wfile), DB_OPEN_READWRITE);
+    if (!wdbip)
+	return (int)dps.size();
+    if (db_dirbuild(wdbip) < 0) {
+	db_close(wdbip);
+	return (int)dps.size();
+    }
 
-int
-bisect_failing_inputs(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time)
-{
-    std::vector<struct directory *> left_inputs;
-    std::vector<struct directory *> right_inputs;
-    for (size_t i = 0; i < inputs.size()/2; i++)
-	left_inputs.push_back(inputs[i]);
-    for (size_t i =  inputs.size()/2; i < inputs.size(); i++)
-	right_inputs.push_back(inputs[i]);
-
-    int lret = bisect_run(s, bad_dps, left_inputs, orig_cmd, cmd_cnt, max_time, left_inputs.size());
-    int rret = bisect_run(s, bad_dps, right_inputs, orig_cmd, cmd_cnt, max_time, right_inputs.size());
-    return lret + rret;
-}
+    size_t nworkers = bu_avail_cpus();
+    if (nworkers > dps.size())
+	nworkers = dps.size();
+    if (!nworkers)
+	nworkers = 1;
+    std::vector<tess_worker> workers(nworkers);
+
+    if (dps.size() == 1)
+	facetize_log(s, 0, "Attempting to triangulate %s...", dps[0]->d_namep);
+    else
+	facetize_log(s, 0, "Attempting to triangulate %zd solids (%zd workers)...", dps.size(), nworkers);
+
+    int err_cnt = 0;
+    size_t next = 0;
+    size_t jcnt = 0;
+    size_t busy = 0;
+    while (next < dps.size() || busy) {
+	bool progress = false;
+	for (size_t i = 0; i < workers.size(); i++) {
+	    struct tess_worker *w = &workers[i];
+
+	    // Hand out the next job
+	    if (!w->dp && next < dps.size()) {
+		if (!w->running || !subprocess_alive(&w->p)) {
+		    tess_worker_stop(w, false);
+		    if (!tess_worker_start(s, w, wcmd)) {
+			// If we can't get any workers going, give up on
+			// what's left
+			if (!busy) {
+			    for (; next < dps.size(); next++, err_cnt++)
+				bad_dps.push_back(dps[next]);
+			}
+			continue;
+		    }
+		}
+		w->dp = dps[next++];
+		struct bu_vls ofile = BU_VLS_INIT_ZERO;
+		bu_vls_sprintf(&ofile, "%s%cjob_%zd.g", s->wdir, BU_DIR_SEPARATOR, jcnt++);
+		w->ofile = std::string(bu_vls_cstr(&ofile));
+		bu_vls_free(&ofile);
+		bu_file_delete(w->ofile.c_str());
+		FILE *in = subprocess_stdin(&w->p);
+		fprintf(in, "%s\t%s\n", w->ofile.c_str(), w->dp->d_namep);
+		fflush(in);
+		w->start = bu_gettime();
+		busy++;
+		progress = true;
+	    }
+	    if (!w->dp)
+		continue;
 
-int
-bisect_run(struct _ged_facetize_state *s, std::vector<struct directory *> &bad_dps, std::vector<struct directory *> &inputs, const char **orig_cmd, int cmd_cnt, fastf_t max_time, int ocnt)
-{
-    const char *tess_cmd[MAXPATHLEN] = {NULL};
-    // The initial part of the re-run is the same.
-    for (int i = 0; i < cmd_cnt; i++) {
-	tess_cmd[i] = orig_cmd[i];
-    }
-    for (size_t i = 0; i < inputs.size(); i++) {
-	tess_cmd[cmd_cnt+i] = inputs[i]->d_namep;
-    }
+	    int jret = tess_worker_poll(s, w);
+	    if (jret < 0) {
+		fastf_t seconds = (bu_gettime() - w->start) / 1000000.0;
+		if (seconds > max_time) {
+		    facetize_log(s, 1, "%s: tessellation killed after %g seconds\n", w->dp->d_namep, seconds);
+		    tess_worker_stop(w, true);
+		} else if (subprocess_alive(&w->p)) {
+		    continue;
+		} else {
+		    // Crashed - collect anything it managed to tell us
+		    jret = tess_worker_poll(s, w);
+		    tess_worker_stop(w, false);
+		}
+	    }
 
-    int ret = tess_run(s, tess_cmd, cmd_cnt+inputs.size(), max_time, ocnt);
-    if (ret) {
-	if (inputs.size() > 1) {
-	    return bisect_failing_inputs(s, bad_dps, inputs, tess_cmd, cmd_cnt, max_time);
+	    // Job is finished, one way or the other
+	    if (jret == BRLCAD_OK && tess_journal_merge(wdbip, w->ofile.c_str()) != BRLCAD_OK)
+		jret = BRLCAD_ERROR;
+	    if (jret != BRLCAD_OK) {
+		facetize_log(s, 1, "%s: tessellation FAILED\n", w->dp->d_namep);
+		bad_dps.push_back(w->dp);
+		err_cnt++;
+	    }
+	    bu_file_delete(w->ofile.c_str());
+	    w->dp = NULL;
+	    busy--;
+	    progress = true;
 	}
-	bad_dps.push_back(inputs[0]);
-	return 1;
+	if (!progress)
+	    std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
-    return 0;
-}
 
+    for (size_t i = 0; i < workers.size(); i++)
+	tess_worker_stop(&workers[i], false);
+
+    db_close(wdbip);
+
+    facetize_log(s, 0, (err_cnt) ? " FAILED.\n" : " Success.\n");
+
+    return err_cnt;
+}
 
 
 class DpCompare
@@ -635,8 +996,6 @@ class DpCompare
 	}
 };
 
-#define CMD_LEN_MAX 8000
-
 int
 _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struct bu_ptbl *leaf_dps)
 {
@@ -702,7 +1061,6 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
 
     method_options_t *mo = (method_options_t*)s->method_opts;
     std::queue<std::string> method_flags;
-    std::queue<std::string> method_flags_bak;
     for (size_t i = 0; i < mo->methods.size(); i++) {
 	std::string cmethod = mo->methods[i];
 	if (std::find(avail_methods.begin(), avail_methods.end(), cmethod) != avail_methods.end()) {
@@ -724,8 +1082,6 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
 	}
     }
 
-    method_flags_bak = method_flags;
-
     // We want the subprocess to be using the same cache directory
     // as the parent
     char lcache[MAXPATHLEN] = {0};
@@ -753,14 +1109,17 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
     tess_cmd[ 8] = "--cache-dir";
     tess_cmd[ 9] = lcache;
     int cmd_fixed_cnt = 10;
-    while (!pq.empty()) {
-	int obj_cnt = 0;
 
-	// Starting a new round of object processing - reset method flags
-	method_flags = method_flags_bak;
-
-	// There are a number of methods that can be tried.  We try them in priority
-	// order, timing out if one of them goes too long.
+    // Each object is its own job, so a failure or timeout is pinned on the
+    // object responsible and only those objects go on to the next method.
+    std::vector<struct directory *> dps;
+    std::vector<struct directory *> bad_dps;
+    while (!pq.empty()) {
+	dps.push_back(pq.top());
+	pq.pop();
+    }
+    std::string method_first = (method_flags.size()) ? method_flags.front() : std::string();
+    while (dps.size() && method_flags.size()) {
 	mstrpp = method_flags.front();
 	method_flags.pop();
 	bu_vls_sprintf(&method_str, "%s", mstrpp.c_str());
@@ -768,160 +1127,68 @@ _ged_facetize_leaves_tri(struct _ged_facetize_state *s, struct db_i *dbip, struc
 	// Each method has its own default (or possibly user set) time limit
 	l_max_time = mo->max_time[mstrpp];
 	// Get defined options for this particular method
-	bu_vls_sprintf(&method_opts_str, "%s", mo->method_optstr(mstrpp, dbip).c_str());
+	if (mstrpp == method_first)
+	    bu_vls_sprintf(&method_opts_str, "%s", mo->method_optstr(mstrpp, dbip).c_str());
+	else
+	    bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
 	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
 
-	std::vector<struct directory *> dps;
-	std::vector<struct directory *> bad_dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (pq.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = pq.top();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
-	    obj_cnt++;
-	    pq.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
-	}
-	bu_vls_free(&cmd);
-
-	// We have the list of objects to feed the process - now, trigger
-	// the runs with as many methods as it takes to facetize all the
-	// primitives
-	int err_cnt = 0;
-	while (bu_vls_strlen(&method_str)) {
-	    if (BU_STR_EQUAL(bu_vls_cstr(&method_str), "NMG")) {
-		err_cnt = bisect_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time, obj_cnt);
-	    } else {
-		// If we're in fallback territory, process individually rather
-		// than doing the bisect - at least for now, those methods are
-		// much more expensive and likely to fail as compared to NMG.
-		for (size_t i = 0; i < dps.size(); i++) {
-		    tess_cmd[cmd_fixed_cnt] = dps[i]->d_namep;
-		    int tess_ret = tess_run(s, tess_cmd, cmd_fixed_cnt + 1, l_max_time, 1);
-		    if (tess_ret != BRLCAD_OK) {
-			bad_dps.push_back(dps[i]);
-			err_cnt++;
-		    }
-		}
-	    }
-
-	    // If we dealt successfully with everything, we're done
-	    if (!err_cnt)
-		break;
-
-	    if (method_flags.size()) {
-		// If we still have available methods to try, go another round
-		err_cnt = 0;
-		mstrpp = method_flags.front();
-		method_flags.pop();
-		bu_vls_sprintf(&method_str, "%s", mstrpp.c_str());
-		tess_cmd[method_ind] = bu_vls_cstr(&method_str);
-		// Each method has its own default (or possibly user set) time limit
-		l_max_time = mo->max_time[mstrpp];
-		// Get defined options for this particular method
-		bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
-		tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-		dps = bad_dps;
-		bad_dps.clear();
-	    } else {
-		// All done - nothing left to try
-		bu_vls_trunc(&method_str, 0);
-		tess_cmd[method_ind] = NULL;
-	    }
-	}
+	bad_dps.clear();
+	(void)tess_pool_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time);
 
-	if (err_cnt || bad_dps.size() > 0) {
-	    // If we tried all the active methods and still had failures, we have an
-	    // error.  We'll keep trying to process all the leaves, since we want to
-	    // get a full picture of what the issues with the conversion are, but
-	    // we need to record these as a full-on failure.
-	    for (size_t i = 0; i < bad_dps.size(); i++)
-		failed_dps.push_back(std::string(bad_dps[i]->d_namep));
-	}
+	// Whatever is left gets another try with the next method
+	dps = bad_dps;
     }
 
-    while (!q_dsp.empty()) {
+    // If we tried all the active methods and still had failures, we have an
+    // error.  We'll keep trying to process all the leaves, since we want to
+    // get a full picture of what the issues with the conversion are, but we
+    // need to record these as a full-on failure.
+    for (size_t i = 0; i < dps.size(); i++)
+	failed_dps.push_back(std::string(dps[i]->d_namep));
+
+    if (!q_dsp.empty()) {
 	bu_vls_sprintf(&method_str, "CM");
 	tess_cmd[method_ind] = bu_vls_cstr(&method_str);
 	mstrpp = std::string("CM");
 	l_max_time = mo->max_time[mstrpp];
 	bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
 	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-	std::vector<struct directory *> dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (q_dsp.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = q_dsp.front();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
+	dps.clear();
+	bad_dps.clear();
+	while (!q_dsp.empty()) {
+	    dps.push_back(q_dsp.front());
 	    q_dsp.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
-	}
-	bu_vls_free(&cmd);
-
-	// We have the list of objects to feed the process - now, trigger
-	// the runs with as many methods as it takes to facetize all the
-	// primitives
-	for (size_t i = 0; i < dps.size(); i++) {
-	    tess_cmd[cmd_fixed_cnt] = dps[i]->d_namep;
-	    int err_cnt = tess_run(s, tess_cmd, cmd_fixed_cnt + 1, l_max_time, 1);
-	    if (err_cnt)
-		failed_dps.push_back(std::string(dps[i]->d_namep));
 	}
+	(void)tess_pool_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time);
+	for (size_t i = 0; i < bad_dps.size(); i++)
+	    failed_dps.push_back(std::string(bad_dps[i]->d_namep));
     }
 
-    while (!q_pbot.empty()) {
+    if (!q_pbot.empty()) {
 	bu_vls_sprintf(&method_str, "NMG");
 	tess_cmd[method_ind] = bu_vls_cstr(&method_str);
 	mstrpp = std::string("NMG");
 	l_max_time = mo->plate_max_time;
 	bu_vls_sprintf(&method_opts_str, "\"%s\"", mo->method_optstr(mstrpp, dbip).c_str());
 	tess_cmd[method_opt_ind] = bu_vls_cstr(&method_opts_str);
-
-
-	std::vector<struct directory *> dps;
-	std::vector<struct directory *> bad_dps;
-	struct bu_vls cmd = BU_VLS_INIT_ZERO;
-	for (int i = 0; i < cmd_fixed_cnt; i++)
-	    bu_vls_printf(&cmd, "%s ", tess_cmd[i]);
-	int obj_cnt = 0;
-	while (bu_vls_strlen(&cmd) < CMD_LEN_MAX) {
-	    if (q_pbot.empty() || cmd_fixed_cnt+dps.size() == MAXPATHLEN)
-		break;
-	    struct directory *ldp = q_pbot.top();
-	    if ((bu_vls_strlen(&cmd) + strlen(ldp->d_namep)) > CMD_LEN_MAX) {
-		// This would be too long -  we've listed all we can
-		break;
-	    }
-	    obj_cnt++;
+	dps.clear();
+	bad_dps.clear();
+	while (!q_pbot.empty()) {
+	    dps.push_back(q_pbot.top());
 	    q_pbot.pop();
-	    dps.push_back(ldp);
-	    bu_vls_printf(&cmd, "%s ", ldp->d_namep);
 	}
-	bu_vls_free(&cmd);
-
-
-	int err_cnt = bisect_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time * dps.size(), obj_cnt);
-	if (err_cnt) {
+	if (tess_pool_run(s, bad_dps, dps, tess_cmd, cmd_fixed_cnt, l_max_time)) {
 	    // If we couldn't handle the plate mode conversion, we can't do the
 	    // boolean evaluation
 	    facetize_log(s, 0, "Plate mode conversion wasn't able to complete\n");
+	    bu_vls_free(&method_str);
+	    bu_vls_free(&method_opts_str);
 	    return BRLCAD_ERROR;
 	}
     }
+    bu_vls_free(&method_str);
+    bu_vls_free(&method_opts_str);
 
     if (failed_dps.size()) {
 	// As the parent process, we can know when we've run out of options
@@ -1052,8 +1319,21 @@ _ged_facetize_booleval_tri(struct _ged_facetize_state *s, struct db_i *dbip, str
 	return BRLCAD_OK;
     }
 
-    // Third stage is to execute the boolean operations
-    ftree = rt_booltree_evaluate(s->facetize_tree, vlfree, &wdbp->wdb_tol, &rt_uniresource, &manifold_do_bool, 0, (void *)s);
+    // Third stage is to execute the boolean operations.  By default the tree
+    // is rebalanced and evaluated in parallel - GED_FACETIZE_SERIAL_BOOL
+    // selects the original serial walk, to compare the two.
+    const char *sevar = getenv("GED_FACETIZE_SERIAL_BOOL");
+    bool serial = (sevar && atoi(sevar));
+    bool_peak_tris = bool_live_tris.load();
+    int64_t bool_start = bu_gettime();
+    if (serial) {
+	ftree = rt_booltree_evaluate(s->facetize_tree, vlfree, &wdbp->wdb_tol, &rt_uniresource, &manifold_do_bool, 0, (void *)s);
+    } else {
+	s->facetize_tree = booltree_rebalance(s->facetize_tree);
+	ftree = booltree_evaluate_parallel(s, s->facetize_tree);
+    }
+    facetize_log(s, 1, "%s boolean evaluation: %g seconds, peak of %zu live triangles\n",
+	    (serial) ? "Serial" : "Parallel", (double)(bu_gettime() - bool_start) / 1.0e6, bool_peak_tris.load());
     if (!ftree) {
 	return BRLCAD_ERROR;
     }
@@ -1082,6 +1362,7 @@ _ged_facetize_booleval_tri(struct _ged_facetize_state *s, struct db_i *dbip, str
 	    bot->vertices[j] = rmesh.vertProperties[j];
 	for (size_t j = 0; j < rmesh.triVerts.size(); j++)
 	    bot->faces[j] = rmesh.triVerts[j];
+	bool_tris_sub(om);
 	delete om;
 	ftree->tr_d.td_d = NULL;
 
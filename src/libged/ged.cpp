@@ -66,6 +66,8 @@ ged_close(struct ged *gedp)
 	return;
 
     if (gedp->dbip) {
+	/* ged_lod is ours - detach it before it goes away */
+	db_mesh_lod_context_set(gedp->dbip, NULL);
 	db_close(gedp->dbip);
 	gedp->dbip = NULL;
     }
@@ -379,6 +381,7 @@ ged_open(const char *dbtype, const char *filename, int existing_only)
     db_update_nref(gedp->dbip, &rt_uniresource);
 
     gedp->ged_lod = bv_mesh_lod_context_create(filename);
+    db_mesh_lod_context_set(gedp->dbip, gedp->ged_lod);
 
     return gedp;
 }
@@ -140,6 +140,7 @@ ged_opendb_core(struct ged *gedp, int argc, const char *argv[])
     // LoD context creation (DbiState initialization can use info
     // stored here, so do this first)
     gedp->ged_lod = bv_mesh_lod_context_create(argv[0]);
+    db_mesh_lod_context_set(gedp->dbip, gedp->ged_lod);
 
     // If enabled, set up the DbiState container for fast structure access
     if (gedp->new_cmd_forms)
@@ -53,7 +53,7 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
     struct bview *gvp;
     int print_help = 0;
     static const char *usage = "view lod [csg|mesh] [0|1]\n"
-	"view lod cache [clear [all_files] | exists] \n"
+	"view lod cache [clear [all_files] | exists | status | wait] \n"
 	"view lod scale [factor]\n"
 	"view lod point_scale [factor]\n"
 	"view lod curve_scale [factor]\n"
@@ -101,6 +101,8 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
     }
 
     if (BU_STR_EQUIV(argv[0], "1")) {
+	// Have any missing mesh LoD data built in the background
+	db_mesh_lod_start(gedp->dbip, 0);
 	if (!gvp->gv_s->adaptive_plot_mesh || !gvp->gv_s->adaptive_plot_csg) {
 	    gvp->gv_s->adaptive_plot_csg = 1;
 	    gvp->gv_s->adaptive_plot_mesh = 1;
@@ -154,6 +156,7 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 	    return BRLCAD_OK;
 	}
 	if (BU_STR_EQUAL(argv[1], "1")) {
+	    db_mesh_lod_start(gedp->dbip, 0);
 	    if (!gvp->gv_s->adaptive_plot_mesh) {
 		gvp->gv_s->adaptive_plot_mesh = 1;
 		int rac = 1;
@@ -184,8 +187,10 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 
 	    struct rt_wdb *wdbp = wdb_dbopen(gedp->dbip, RT_WDB_TYPE_DB_DEFAULT);
 
-	    // Clear any old cache in memory
-	    bv_mesh_lod_clear_cache(gedp->ged_lod, 0);
+	    // BoTs are processed by background workers while we do the
+	    // BReps, and only those whose content changed since they were
+	    // last cached are regenerated
+	    db_mesh_lod_start(gedp->dbip, 0);
 
 	    int done = 0;
 	    int total = 0;
@@ -194,8 +199,6 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 		for (dp = gedp->dbip->dbi_Head[i]; dp != RT_DIR_NULL; dp = dp->d_forw) {
 		    if (dp->d_addr == RT_DIR_PHONY_ADDR)
 			continue;
-		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT)
-			total++;
 		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BREP)
 			total++;
 		}
@@ -209,31 +212,6 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 
 		    unsigned long long key = 0;
 
-		    // No need to open up the internal unless it's a BoT or a BRep
-		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BOT) {
-			struct rt_db_internal dbintern;
-			RT_DB_INTERNAL_INIT(&dbintern);
-			struct rt_db_internal *ip = &dbintern;
-			int ret = rt_db_get_internal(ip, dp, gedp->dbip, NULL, &rt_uniresource);
-			if (ret < 0)
-			    continue;
-
-			if (ip->idb_minor_type != DB5_MINORTYPE_BRLCAD_BOT) {
-			    rt_db_free_internal(&dbintern);
-			    continue;
-			}
-			done++;
-			struct bu_vls pname = BU_VLS_INIT_ZERO;
-			bu_log("Caching BoT %s (%d of %d)\n", dp->d_namep, done, total);
-			bu_vls_free(&pname);
-			struct rt_bot_internal *bot = (struct rt_bot_internal *)ip->idb_ptr;
-			RT_BOT_CK_MAGIC(bot);
-			key = bv_mesh_lod_cache(gedp->ged_lod, (const point_t *)bot->vertices, bot->num_vertices, NULL, bot->faces, bot->num_faces, 0, 0.66);
-			if (key)
-			    bv_mesh_lod_key_put(gedp->ged_lod, dp->d_namep, key);
-			rt_db_free_internal(&dbintern);
-		    }
-
 		    if (dp->d_minor_type == DB5_MINORTYPE_BRLCAD_BREP) {
 			struct bu_external ext = BU_EXTERNAL_INIT_ZERO;
 			if (db_get_external(&ext, dp, gedp->dbip))
@@ -303,12 +281,35 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 
 		minutes = minutes % 60;
 		seconds = seconds %60;
-		bu_vls_printf(gedp->ged_result_str, "Caching complete (Elapsed time: %02d:%02d:%02d)\n", hours, minutes, seconds);
+		bu_vls_printf(gedp->ged_result_str, "BRep caching complete (Elapsed time: %02d:%02d:%02d)\n", hours, minutes, seconds);
 	    }
+	    int bot_done = 0;
+	    int bot_total = 0;
+	    if (db_mesh_lod_progress(gedp->dbip, &bot_done, &bot_total))
+		bu_vls_printf(gedp->ged_result_str, "BoT caching running in the background: %d of %d complete (\"view lod cache wait\" to block until finished)\n", bot_done, bot_total);
+	    else
+		bu_vls_printf(gedp->ged_result_str, "BoT caching complete: %d of %d\n", bot_done, bot_total);
 	    return BRLCAD_OK;
 	}
 	if (argc == 2) {
+	    if (BU_STR_EQUAL(argv[1], "status")) {
+		int bot_done = 0;
+		int bot_total = 0;
+		int running = db_mesh_lod_progress(gedp->dbip, &bot_done, &bot_total);
+		bu_vls_printf(gedp->ged_result_str, "%s: %d of %d BoTs\n", (running) ? "running" : "idle", bot_done, bot_total);
+		return BRLCAD_OK;
+	    }
+	    if (BU_STR_EQUAL(argv[1], "wait")) {
+		int bot_done = 0;
+		int bot_total = 0;
+		db_mesh_lod_wait(gedp->dbip);
+		(void)db_mesh_lod_progress(gedp->dbip, &bot_done, &bot_total);
+		bu_vls_printf(gedp->ged_result_str, "BoT caching complete: %d of %d\n", bot_done, bot_total);
+		return BRLCAD_OK;
+	    }
 	    if (BU_STR_EQUAL(argv[1], "clear")) {
+		// Don't let background workers write into what we're clearing
+		db_mesh_lod_cancel(gedp->dbip);
 		bv_mesh_lod_clear_cache(gedp->ged_lod, 0);
 		return BRLCAD_OK;
 	    } else if (BU_STR_EQUAL(argv[1], "exists")) {
@@ -332,6 +333,7 @@ _view_cmd_lod(void *bs, int argc, const char **argv)
 	}
 	if (argc == 3) {
 	    if (BU_STR_EQUAL(argv[1], "clear") && BU_STR_EQUAL(argv[2], "all_files")) {
+		db_mesh_lod_cancel(gedp->dbip);
 		bv_mesh_lod_clear_cache(NULL, 0);
 		return BRLCAD_OK;
 	    }
@@ -23,7 +23,7 @@
  *
  */
 
-#include "icv.h"
+#include "icv_private.h"
 #include "vmath.h"
 #include "bu/magic.h"
 #include "bu/malloc.h"
@@ -74,20 +74,7 @@ icv_data2uchar(const icv_image_t *bif)
     double_p = bif->data;
 
     if (ZERO(bif->gamma_corr)) {
-	while (size--) {
-	    long longval = lrint((*double_p)*255.0);
-
-	    if (longval > 255)
-		*char_p = 255;
-	    else if (longval < 0)
-		*char_p = 0;
-	    else
-		*char_p = (unsigned char)longval;
-
-	    char_p++;
-	    double_p++;
-	}
-
+	icv_double2uchar_run(double_p, char_p, size);
     } else {
 	float *rand_p;
 	double ex = 1.0/bif->gamma_corr;
@@ -44,7 +44,7 @@
  * FMT:filename as being preferred, but will attempt to guess based on
  * extension as well.
  */
-static bu_mime_image_t
+bu_mime_image_t
 icv_guess_file_format(const char *filename, struct bu_vls *trimmedname)
 {
     // If we have no filename, there's nothing to go on
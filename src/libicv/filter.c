@@ -27,6 +27,7 @@
 #include "bu/log.h"
 #include "bu/malloc.h"
 #include "icv.h"
+#include "icv_private.h"
 
 #include "vmath.h"
 
@@ -34,8 +35,8 @@
 
 /* private functions */
 
-static void
-get_kernel(ICV_FILTER filter_type, double *kern, double *offset)
+int
+icv_get_kernel(ICV_FILTER filter_type, double *kern, double *offset)
 {
     switch (filter_type) {
 	case ICV_FILTER_LOW_PASS :
@@ -82,13 +83,12 @@ get_kernel(ICV_FILTER filter_type, double *kern, double *offset)
 	    break;
 	default :
 	    bu_log("Filter Type not Implemented.\n");
-	    bu_free(kern, "Freeing Kernel, Wrong filter");
-	    kern = NULL;
+	    return -1;
     }
-    return;
+    return 0;
 }
 
-static void
+static int
 get_kernel3(ICV_FILTER3 filter_type, double *kern, double *offset)
 {
     switch (filter_type) {
@@ -154,10 +154,9 @@ get_kernel3(ICV_FILTER3 filter_type, double *kern, double *offset)
 	    break;
 	default :
 	    bu_log("Filter Type not Implemented.\n");
-	    bu_free(kern, "Freeing Kernel, Wrong filter");
-	    kern = NULL;
+	    return -1;
     }
-    return;
+    return 0;
 }
 
 /* end of private functions */
@@ -167,18 +166,12 @@ get_kernel3(ICV_FILTER3 filter_type, double *kern, double *offset)
 int
 icv_filter(icv_image_t *img, ICV_FILTER filter_type)
 {
-    double *kern = NULL, *kern_p = NULL;
-    double c_val;
-    double *out_data, *in_data, *data_p;
+    double kern[KERN_DEFAULT*KERN_DEFAULT];
     double offset = 0;
-    size_t k_dim = KERN_DEFAULT, k_dim_half, k_dim_half_ceil;
-    size_t size;
-    size_t h, w, k, i;
+    const double *rows[3];
+    double *out_data, *in_data;
     size_t widthstep;
-    size_t index, n_index; /**< index is the index of the pixel in
-			      * out image and n_index corresponds to
-			      * the nearby pixel in input image
-			      */
+    size_t h, r;
 
     /* TODO A new Functionality. Update the get_kernel function to
      * accommodate the generalized kernel length. This can be based
@@ -187,54 +180,24 @@ icv_filter(icv_image_t *img, ICV_FILTER filter_type)
 
     ICV_IMAGE_VAL_INT(img);
 
-    kern = (double *)bu_malloc(k_dim*k_dim*sizeof(double), "icv_filter : Kernel Allocation");
-    get_kernel(filter_type, kern, &offset);
-
-    if (!kern)
+    if (icv_get_kernel(filter_type, kern, &offset) < 0)
 	return -1;
 
     widthstep = img->width*img->channels;
 
     in_data = img->data;
-    size = img->height*img->width*img->channels;
     /* Replaces data pointer in place */
-    img->data = out_data = (double*)bu_malloc(size*sizeof(double), "icv_filter : out_image_data");
+    img->data = out_data = (double*)bu_malloc(img->height*widthstep*sizeof(double), "icv_filter : out_image_data");
 
-    /* Kernel Dimension is always considered to be odd*/
-    k_dim_half = k_dim/2*img->channels;
-    k_dim_half_ceil = (k_dim - k_dim/2)*img->channels;
-    index = 0;
+    /* Kernel row 0 applies to the row below.  Rows and columns
+     * outside the image are treated as zero (zero padding).
+     */
     for (h = 0; h < img->height; h++) {
-	VMOVEN(out_data, in_data+index, k_dim_half);
-	out_data+=k_dim_half;
-
-	for (w = 0; w < widthstep - k_dim*img->channels; w++) {
-	    c_val = 0;
-	    kern_p = kern;
-
-	    for (k = 0; k <= k_dim; k++) {
-		n_index = index + (k-(k_dim/2))*widthstep;
-		data_p = in_data + n_index;
-		for (i = 0; i<=k_dim; i++) {
-		    /* Ensures that the arguments are given a zero value for
-		     * out of bound pixels. Thus behaves similar to zero padding
-		     */
-		    if (n_index < size) {
-			c_val += (*kern_p++)*(*data_p);
-			data_p += img->channels;
-			/* Ensures out bound in image */
-			n_index += img->channels;
-		    }
-		}
-	    }
-	    *out_data = c_val + offset;
-	    out_data++;
-	    index++;
-	}
-	index = (h+1)*widthstep;
-	VMOVEN(out_data,in_data+index -k_dim_half_ceil*img->channels,k_dim_half_ceil*img->channels );
-	out_data+= k_dim_half_ceil;
+	for (r = 0; r < 3; r++)
+	    rows[r] = (h + r >= 1 && h + r - 1 < img->height) ? in_data + (h + r - 1)*widthstep : NULL;
+	icv_filter_row(kern, offset, rows, 1, img->width, img->channels, out_data + h*widthstep);
     }
+
     bu_free(in_data, "icv:filter Input Image Data");
     return 0;
 }
@@ -243,81 +206,43 @@ icv_image_t *
 icv_filter3(icv_image_t *old_img, icv_image_t *curr_img, icv_image_t *new_img, ICV_FILTER3 filter_type)
 {
     icv_image_t *out_img;
-    double *kern = NULL;
-    double *kern_old, *kern_curr, *kern_new;
-    double c_val;
-    double *out_data;
-    double *old_data, *curr_data, *new_data;
-    double *old_data_p, *curr_data_p, *new_data_p;
+    double kern[KERN_DEFAULT*KERN_DEFAULT*3];
     double offset = 0;
-    size_t k_dim = KERN_DEFAULT;
-    size_t size;
-    size_t s, k, i;
+    const double *rows[9];
+    const double *data[3];
     size_t widthstep;
-    size_t index, n_index; /**< index is the index of the pixel in
-			      * out image and n_index corresponds to
-			      * the nearby pixel in input image
-			      */
+    size_t h, f, r;
 
     ICV_IMAGE_VAL_PTR(old_img);
     ICV_IMAGE_VAL_PTR(curr_img);
     ICV_IMAGE_VAL_PTR(new_img);
 
-    if ((old_img->width == curr_img->width && curr_img->width == new_img->width) && \
-	(old_img->height == curr_img->height && curr_img->height == new_img->height) && \
-	(old_img->channels == curr_img->channels && curr_img->channels == new_img->channels)) {
+    if (!(old_img->width == curr_img->width && curr_img->width == new_img->width) || \
+	!(old_img->height == curr_img->height && curr_img->height == new_img->height) || \
+	!(old_img->channels == curr_img->channels && curr_img->channels == new_img->channels)) {
 	bu_log("icv_filter3 : Image Parameters not Equal");
 	return NULL;
     }
 
-    kern = (double *)bu_malloc(k_dim*k_dim*3*sizeof(double), "icv_filter3 : Kernel Allocation");
-    get_kernel3(filter_type, kern, &offset);
-
-    if (!kern)
+    if (get_kernel3(filter_type, kern, &offset) < 0)
 	return NULL;
 
     widthstep = old_img->width*old_img->channels;
 
-    old_data = old_img->data;
-    curr_data = curr_img->data;
-    new_data = new_img->data;
-
-    size = old_img->height*old_img->width*old_img->channels;
+    data[0] = old_img->data;
+    data[1] = curr_img->data;
+    data[2] = new_img->data;
 
     out_img = icv_create(old_img->width, old_img->height, old_img->color_space);
 
-    out_data = out_img->data;
-
-    index = 0;
-
-    for (s = 0; s <= size; s++) {
-	c_val = 0;
-	kern_old = kern;
-	kern_curr = kern + k_dim*k_dim-1;
-	kern_new = kern + 2*k_dim*k_dim-1;
-	for (k = 0; k <= k_dim; k++) {
-	    n_index = index + (k-(k_dim/2))*widthstep;
-	    old_data_p = old_data + n_index;
-	    curr_data_p = curr_data + n_index;
-	    new_data_p = new_data + n_index;
-	    for (i = 0; i<=k_dim; i++) {
-		/* Ensures that the arguments are given a zero value for
-		   out of bound pixels. Thus behaves similar to zero padding */
-		if (n_index < size) {
-		    c_val += (*kern_old++)*(*old_data_p);
-		    c_val += (*kern_curr++)*(*curr_data_p);
-		    c_val += (*kern_new++)*(*new_data_p);
-		    old_data_p += old_img->channels;
-		    curr_data_p += old_img->channels;
-		    new_data_p += old_img->channels;
-		    n_index += old_img->channels;
-		}
-	    }
-	}
-	index++;
-	*out_data++ = c_val + offset;
+    for (h = 0; h < old_img->height; h++) {
+	for (f = 0; f < 3; f++)
+	    for (r = 0; r < 3; r++)
+		rows[f*3 + r] = (h + r >= 1 && h + r - 1 < old_img->height) ? data[f] + (h + r - 1)*widthstep : NULL;
+	icv_filter_row(kern, offset, rows, 3, old_img->width, old_img->channels, out_img->data + h*widthstep);
     }
-    return 0;
+
+    return out_img;
 }
 
 
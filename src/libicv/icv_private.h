@@ -20,12 +20,26 @@
 
 #include "common.h"
 #include "bu/mime.h"
+#include "bu/vls.h"
 #include "bio.h" /* for O_BINARY */
 #include "icv.h"
 
 #ifndef ICV_PRIVATE_H
 #define ICV_PRIVATE_H
 
+/* defined in fileformat.c */
+extern bu_mime_image_t icv_guess_file_format(const char *filename, struct bu_vls *trimmedname);
+
+/* defined in filter.c */
+extern int icv_get_kernel(ICV_FILTER filter_type, double *kern, double *offset);
+
+/* defined in simd.c */
+extern void icv_filter_row(const double *kern, double offset, const double **rows, size_t nframes, size_t width, size_t channels, double *out);
+extern void icv_binterp_table(size_t out_width, size_t channels, double xstep, size_t *xoff, double *xdx);
+extern void icv_binterp_row(const double *low_r, const double *upp_r, const size_t *xoff, const double *xdx, double dy, size_t n, size_t channels, double *out);
+extern void icv_double2uchar_run(const double *in, unsigned char *out, size_t n);
+extern void icv_diff_count(const unsigned char *d1, const unsigned char *d2, size_t npix, size_t counts[3]);
+
 /* defined in bw.c */
 extern icv_image_t *bw_read(FILE *fp, size_t width, size_t height);
 extern int bw_write(icv_image_t *bif, FILE *fp);
@@ -41,6 +55,8 @@ extern int dpix_write(icv_image_t *bif, FILE *fp);
 /* defined in png.c */
 extern icv_image_t* png_read(FILE *fp);
 extern int png_write(icv_image_t *bif, FILE *fp);
+extern FILE *png_spool(FILE *fp, size_t *width, size_t *height);
+extern int png_unspool(FILE *spool, size_t width, size_t height, size_t channels, FILE *fp);
 
 /* defined in ppm.c */
 extern icv_image_t* ppm_read(FILE *fp);
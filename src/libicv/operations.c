@@ -28,7 +28,7 @@
 #include <math.h>
 #include <string.h>
 
-#include "icv.h"
+#include "icv_private.h"
 
 #include "bio.h"
 #include "bu/log.h"
@@ -321,33 +321,16 @@ icv_diff(
     size_t s2 = img2->width * img2->height;
     size_t smin = (s1 < s2) ? s1 : s2;
     size_t smax = (s1 > s2) ? s1 : s2;
-    for (size_t i = 0; i < smin; i++) {
-	int r1 = d1[i*3+0];
-	int g1 = d1[i*3+1];
-	int b1 = d1[i*3+2];
-	int r2 = d2[i*3+0];
-	int g2 = d2[i*3+1];
-	int b2 = d2[i*3+2];
-	int dcnt = 0;
-	dcnt += (r1 != r2) ? 1 : 0;
-	dcnt += (g1 != g2) ? 1 : 0;
-	dcnt += (b1 != b2) ? 1 : 0;
-	switch (dcnt) {
-	    case 0:
-		if (matching)
-		    (*matching)++;
-		break;
-	    case 1:
-		ret = 1;
-		if (off_by_1)
-		    (*off_by_1)++;
-		break;
-	    default:
-		ret = 1;
-		if (off_by_many)
-		    (*off_by_many)++;
-	}
-    }
+    size_t counts[3];
+    icv_diff_count(d1, d2, smin, counts);
+    if (matching)
+	(*matching) += (int)counts[0];
+    if (off_by_1)
+	(*off_by_1) += (int)counts[1];
+    if (off_by_many)
+	(*off_by_many) += (int)counts[2];
+    if (counts[1] || counts[2])
+	ret = 1;
     if (smin != smax) {
 	ret = 1;
 	if (off_by_many) {
@@ -376,8 +359,8 @@ icv_diffimg(icv_image_t *img1, icv_image_t *img2)
     // Have images
     unsigned char *d1 = icv_data2uchar(img1);
     unsigned char *d2 = icv_data2uchar(img2);
-    unsigned char *od = icv_data2uchar(img1);
     size_t s = img1->width * img1->height;
+    unsigned char *od = (unsigned char *)bu_malloc(s * 3, "diff image rgb");
     for (size_t i = 0; i < s; i++) {
 	int r1 = d1[i*3+0];
 	int g1 = d1[i*3+1];
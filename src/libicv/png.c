@@ -25,6 +25,7 @@
 
 #include "bio.h"
 
+#include "bu/app.h"
 #include "bu/str.h"
 #include "bu/file.h"
 #include "bu/log.h"
@@ -79,39 +80,36 @@ png_write(icv_image_t *bif, FILE *fp)
     return BRLCAD_OK;
 }
 
-icv_image_t *
-png_read(FILE *fp)
+/*
+ * Read the PNG header and configure libpng to deliver 8-bit RGB rows,
+ * the common setup for png_read() and png_spool().
+ */
+static int
+png_read_setup(FILE *fp, png_structp *png_pp, png_infop *info_pp, size_t *width, size_t *height)
 {
-    if (UNLIKELY(!fp))
-	return NULL;
-
     char header[8];
     if (fread(header, 8, 1, fp) != 1) {
 	bu_log("png-pix: ERROR: Failed while reading file header!!!\n");
-	return NULL;
+	return -1;
     }
 
     if (png_sig_cmp((png_bytep)header, 0, 8)) {
 	bu_log("png-pix: This is not a PNG file!!!\n");
-	return NULL;
+	return -1;
     }
 
     png_structp png_p = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png_p) {
 	bu_log("png-pix: png_create_read_struct() failed!!\n");
-	return NULL;
+	return -1;
     }
 
     png_infop info_p = png_create_info_struct(png_p);
     if (!info_p) {
 	bu_log("png-pix: png_create_info_struct() failed!!\n");
-	return NULL;
+	return -1;
     }
 
-    icv_image_t *bif;
-    BU_ALLOC(bif, struct icv_image);
-    ICV_IMAGE_INIT(bif);
-
     png_init_io(png_p, fp);
     png_set_sig_bytes(png_p, 8);
     png_read_info(png_p, info_p);
@@ -123,8 +121,8 @@ png_read(FILE *fp)
     int bit_depth = png_get_bit_depth(png_p, info_p);
     if (bit_depth == 16) png_set_strip_16(png_p);
 
-    bif->width = png_get_image_width(png_p, info_p);
-    bif->height = png_get_image_height(png_p, info_p);
+    *width = png_get_image_width(png_p, info_p);
+    *height = png_get_image_height(png_p, info_p);
 
     png_color_16p input_backgrd;
     if (png_get_bKGD(png_p, info_p, &input_backgrd)) {
@@ -141,6 +139,29 @@ png_read(FILE *fp)
 
     png_read_update_info(png_p, info_p);
 
+    *png_pp = png_p;
+    *info_pp = info_p;
+    return 0;
+}
+
+icv_image_t *
+png_read(FILE *fp)
+{
+    if (UNLIKELY(!fp))
+	return NULL;
+
+    png_structp png_p;
+    png_infop info_p;
+    size_t width, height;
+    if (png_read_setup(fp, &png_p, &info_p, &width, &height) < 0)
+	return NULL;
+
+    icv_image_t *bif;
+    BU_ALLOC(bif, struct icv_image);
+    ICV_IMAGE_INIT(bif);
+
+    bif->width = width;
+    bif->height = height;
 
     /* allocate memory for image */
     unsigned char *image = (unsigned char *)bu_calloc(1, bif->width*bif->height*3, "image");
@@ -163,6 +184,99 @@ png_read(FILE *fp)
 }
 
 
+FILE *
+png_spool(FILE *fp, size_t *width, size_t *height)
+{
+    if (UNLIKELY(!fp))
+	return NULL;
+
+    png_structp png_p;
+    png_infop info_p;
+    if (png_read_setup(fp, &png_p, &info_p, width, height) < 0)
+	return NULL;
+
+    /* png_read_row() on an interlaced file only yields complete rows
+     * after the last pass, which needs the whole image in memory */
+    if (png_get_interlace_type(png_p, info_p) != PNG_INTERLACE_NONE) {
+	bu_log("png_spool: interlaced PNG files cannot be streamed, use icv_read()\n");
+	png_destroy_read_struct(&png_p, &info_p, NULL);
+	return NULL;
+    }
+
+    FILE *spool = bu_temp_file(NULL, 0);
+    if (!spool) {
+	bu_log("png_spool: unable to create temporary file\n");
+	png_destroy_read_struct(&png_p, &info_p, NULL);
+	return NULL;
+    }
+
+    /* PNG rows arrive top-down, pix rows are stored bottom-up */
+    size_t rowbytes = *width * 3;
+    unsigned char *row = (unsigned char *)bu_malloc(rowbytes, "png_spool : row");
+    for (size_t i = 0; i < *height; i++) {
+	png_read_row(png_p, (png_bytep)row, NULL);
+	if (bu_fseek(spool, (b_off_t)((*height - 1 - i) * rowbytes), SEEK_SET) ||
+	    fwrite(row, 1, rowbytes, spool) != rowbytes) {
+	    bu_log("png_spool: Short Write\n");
+	    bu_free(row, "png_spool : row");
+	    png_destroy_read_struct(&png_p, &info_p, NULL);
+	    fclose(spool);
+	    return NULL;
+	}
+    }
+    bu_free(row, "png_spool : row");
+    png_destroy_read_struct(&png_p, &info_p, NULL);
+
+    rewind(spool);
+    return spool;
+}
+
+
+int
+png_unspool(FILE *spool, size_t width, size_t height, size_t channels, FILE *fp)
+{
+    if (UNLIKELY(!spool || !fp))
+	return BRLCAD_ERROR;
+
+    png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    if (UNLIKELY(png_ptr == NULL))
+	return BRLCAD_ERROR;
+
+    size_t rowbytes = width * channels;
+    unsigned char *row = (unsigned char *)bu_malloc(rowbytes, "png_unspool : row");
+
+    png_infop info_ptr = png_create_info_struct(png_ptr);
+    if (info_ptr == NULL || setjmp(png_jmpbuf(png_ptr))) {
+	png_destroy_write_struct(&png_ptr, info_ptr ? &info_ptr : NULL);
+	bu_free(row, "png_unspool : row");
+	bu_log("ERROR: Unable to create png header\n");
+	return BRLCAD_ERROR;
+    }
+
+    png_init_io(png_ptr, fp);
+    png_set_IHDR(png_ptr, info_ptr, (unsigned)width, (unsigned)height, 8,
+		 (channels == 1) ? PNG_COLOR_TYPE_GRAY : PNG_COLOR_TYPE_RGB,
+		 PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+		 PNG_FILTER_TYPE_DEFAULT);
+    png_write_info(png_ptr, info_ptr);
+    for (size_t i = height; i > 0; --i) {
+	if (bu_fseek(spool, (b_off_t)((i - 1) * rowbytes), SEEK_SET) ||
+	    fread(row, 1, rowbytes, spool) != rowbytes) {
+	    bu_log("png_unspool: Short Read\n");
+	    png_destroy_write_struct(&png_ptr, &info_ptr);
+	    bu_free(row, "png_unspool : row");
+	    return BRLCAD_ERROR;
+	}
+	png_write_row(png_ptr, (png_bytep)row);
+    }
+    png_write_end(png_ptr, info_ptr);
+
+    png_destroy_write_struct(&png_ptr, &info_ptr);
+    bu_free(row, "png_unspool : row");
+
+    return BRLCAD_OK;
+}
+
 /*
  * Local Variables:
  * mode: C
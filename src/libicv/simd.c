@@ -0,0 +1,308 @@
+/*                          S I M D . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libicv/simd.c
+ *
+ * Inner loops shared by the filter, resize, conversion and diff
+ * routines, each with a scalar version and an SSE2 version chosen at
+ * run time through bu_simd_level().
+ *
+ * The vector versions perform exactly the same IEEE operations, in
+ * the same order, as the scalar ones - only the number of elements
+ * handled per instruction differs - so results are bitwise identical.
+ * Keep it that way: no reassociation, no fused multiply-add.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "bu/simd.h"
+#include "icv_private.h"
+
+#if defined(__SSE2__) && defined(HAVE_EMMINTRIN_H) && defined(HAVE_EMMINTRIN)
+#  include <emmintrin.h>
+#  define ICV_HAVE_SSE2 1
+#endif
+
+static int icv_simd = -1;
+
+
+int
+icv_simd_level(int level)
+{
+    int avail = bu_simd_supported(BU_SIMD_SSE2) ? BU_SIMD_SSE2 : BU_SIMD_NONE;
+
+    /* never select loops the processor cannot run */
+    icv_simd = (level >= 0 && level < avail) ? level : avail;
+#ifndef ICV_HAVE_SSE2
+    icv_simd = BU_SIMD_NONE;
+#endif
+    return icv_simd;
+}
+
+
+static int
+use_sse2(void)
+{
+    if (icv_simd < 0)
+	(void)icv_simd_level(-1);
+    return icv_simd >= BU_SIMD_SSE2;
+}
+
+
+/*
+ * One output element of a (multi-frame) 3x3 convolution, skipping
+ * rows that are NULL and columns that fall outside the image.
+ */
+static double
+filter_elem(const double *kern, double offset, const double **rows, size_t nframes, size_t w, size_t ch, size_t x, size_t e)
+{
+    double c_val = 0;
+    size_t r, k, f;
+
+    for (r = 0; r < 3; r++) {
+	for (k = 0; k < 3; k++) {
+	    if ((k == 0 && x == 0) || (k == 2 && x + 1 >= w))
+		continue;
+	    for (f = 0; f < nframes; f++) {
+		const double *row = rows[f*3 + r];
+		if (!row)
+		    continue;
+		c_val += kern[f*9 + r*3 + k] * row[e + k*ch - ch];
+	    }
+	}
+    }
+    return c_val + offset;
+}
+
+
+void
+icv_filter_row(const double *kern, double offset, const double **rows, size_t nframes, size_t width, size_t channels, double *out)
+{
+    size_t ch = channels;
+    size_t e = 0;
+    size_t x;
+
+    if (!width)
+	return;
+
+    /* left edge column */
+    for (; e < ch && e < width*ch; e++)
+	out[e] = filter_elem(kern, offset, rows, nframes, width, ch, 0, e);
+
+#ifdef ICV_HAVE_SSE2
+    if (use_sse2() && width > 2) {
+	size_t end = (width - 1)*ch;
+	__m128d kv[27];
+	__m128d ov = _mm_set1_pd(offset);
+	size_t i;
+
+	for (i = 0; i < nframes*9; i++)
+	    kv[i] = _mm_set1_pd(kern[i]);
+
+	for (; e + 2 <= end; e += 2) {
+	    __m128d c_val = _mm_setzero_pd();
+	    size_t r, k, f;
+	    for (r = 0; r < 3; r++) {
+		for (k = 0; k < 3; k++) {
+		    for (f = 0; f < nframes; f++) {
+			const double *row = rows[f*3 + r];
+			if (!row)
+			    continue;
+			c_val = _mm_add_pd(c_val, _mm_mul_pd(kv[f*9 + r*3 + k], _mm_loadu_pd(row + e + k*ch - ch)));
+		    }
+		}
+	    }
+	    _mm_storeu_pd(out + e, _mm_add_pd(c_val, ov));
+	}
+    }
+#endif
+
+    /* whatever is left, including the right edge column */
+    for (; e < width*ch; e++) {
+	x = e / ch;
+	out[e] = filter_elem(kern, offset, rows, nframes, width, ch, x, e);
+    }
+}
+
+
+void
+icv_binterp_row(const double *low_r, const double *upp_r, const size_t *xoff, const double *xdx, double dy, size_t n, size_t channels, double *out)
+{
+    size_t ch = channels;
+    size_t e = 0;
+
+#ifdef ICV_HAVE_SSE2
+    if (use_sse2()) {
+	__m128d dyv = _mm_set1_pd(dy);
+	for (; e + 2 <= n; e += 2) {
+	    size_t o0 = xoff[e], o1 = xoff[e+1];
+	    __m128d dx = _mm_loadu_pd(xdx + e);
+	    __m128d l0, l1, u0, u1;
+	    if (o1 == o0 + 1) {
+		/* neighboring channels of one source pixel */
+		l0 = _mm_loadu_pd(low_r + o0);
+		l1 = _mm_loadu_pd(low_r + o0 + ch);
+		u0 = _mm_loadu_pd(upp_r + o0);
+		u1 = _mm_loadu_pd(upp_r + o0 + ch);
+	    } else {
+		l0 = _mm_loadh_pd(_mm_load_sd(low_r + o0), low_r + o1);
+		l1 = _mm_loadh_pd(_mm_load_sd(low_r + o0 + ch), low_r + o1 + ch);
+		u0 = _mm_loadh_pd(_mm_load_sd(upp_r + o0), upp_r + o1);
+		u1 = _mm_loadh_pd(_mm_load_sd(upp_r + o0 + ch), upp_r + o1 + ch);
+	    }
+	    __m128d mid1 = _mm_add_pd(l0, _mm_mul_pd(dx, _mm_sub_pd(l1, l0)));
+	    __m128d mid2 = _mm_add_pd(u0, _mm_mul_pd(dx, _mm_sub_pd(u1, u0)));
+	    _mm_storeu_pd(out + e, _mm_add_pd(mid1, _mm_mul_pd(dyv, _mm_sub_pd(mid2, mid1))));
+	}
+    }
+#endif
+
+    for (; e < n; e++) {
+	const double *low_c = low_r + xoff[e];
+	const double *upp_c = upp_r + xoff[e];
+	double dx = xdx[e];
+	double mid1 = low_c[0] + dx * (low_c[ch] - low_c[0]);
+	double mid2 = upp_c[0] + dx * (upp_c[ch] - upp_c[0]);
+	out[e] = mid1 + dy * (mid2 - mid1);
+    }
+}
+
+
+void
+icv_binterp_table(size_t out_width, size_t channels, double xstep, size_t *xoff, double *xdx)
+{
+    size_t i, c;
+
+    for (i = 0; i < out_width; i++) {
+	double x = i * xstep;
+	double dx = x - (int)x;
+	for (c = 0; c < channels; c++) {
+	    xoff[i*channels + c] = (size_t)(int)x * channels + c;
+	    xdx[i*channels + c] = dx;
+	}
+    }
+}
+
+
+void
+icv_double2uchar_run(const double *in, unsigned char *out, size_t n)
+{
+    size_t i = 0;
+
+#ifdef ICV_HAVE_SSE2
+    if (use_sse2()) {
+	/* Clamp before converting so out-of-range values cannot wrap.
+	 * The operand order keeps NaN flowing into the conversion,
+	 * which then yields INT_MIN and saturates to 0, as lrint()'s
+	 * LONG_MIN does in the scalar loop.  lrint() also returns
+	 * LONG_MIN for anything too large for a long, so those become
+	 * NaN first.
+	 */
+	__m128d scale = _mm_set1_pd(255.0);
+	__m128d hi = _mm_set1_pd(256.0);
+	__m128d lo = _mm_set1_pd(-1.0);
+	__m128d big = _mm_set1_pd(9223372036854775808.0);
+	for (; i + 8 <= n; i += 8) {
+	    __m128i q[4];
+	    int j;
+	    for (j = 0; j < 4; j++) {
+		__m128d v = _mm_mul_pd(_mm_loadu_pd(in + i + 2*j), scale);
+		v = _mm_or_pd(v, _mm_cmpge_pd(v, big));
+		v = _mm_max_pd(lo, _mm_min_pd(hi, v));
+		q[j] = _mm_cvtpd_epi32(v);
+	    }
+	    __m128i a = _mm_unpacklo_epi64(q[0], q[1]);
+	    __m128i b = _mm_unpacklo_epi64(q[2], q[3]);
+	    __m128i s = _mm_packs_epi32(a, b);
+	    _mm_storel_epi64((__m128i *)(out + i), _mm_packus_epi16(s, s));
+	}
+    }
+#endif
+
+    for (; i < n; i++) {
+	long longval = lrint(in[i]*255.0);
+
+	if (longval > 255)
+	    out[i] = 255;
+	else if (longval < 0)
+	    out[i] = 0;
+	else
+	    out[i] = (unsigned char)longval;
+    }
+}
+
+
+/* classify one RGB pixel pair: 0 match, 1 one channel off, 2 more */
+static int
+diff_class(const unsigned char *p1, const unsigned char *p2)
+{
+    int dcnt = 0;
+    dcnt += (p1[0] != p2[0]) ? 1 : 0;
+    dcnt += (p1[1] != p2[1]) ? 1 : 0;
+    dcnt += (p1[2] != p2[2]) ? 1 : 0;
+    return (dcnt > 2) ? 2 : dcnt;
+}
+
+
+void
+icv_diff_count(const unsigned char *d1, const unsigned char *d2, size_t npix, size_t counts[3])
+{
+    size_t i = 0;
+
+    counts[0] = counts[1] = counts[2] = 0;
+
+#ifdef ICV_HAVE_SSE2
+    if (use_sse2()) {
+	/* Rendered frames being regression tested are usually nearly
+	 * identical, so compare 16 pixels (48 bytes) at a time and only
+	 * classify pixels individually within blocks that differ. */
+	for (; i + 16 <= npix; i += 16) {
+	    const unsigned char *a = d1 + i*3;
+	    const unsigned char *b = d2 + i*3;
+	    __m128i e0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)a), _mm_loadu_si128((const __m128i *)b));
+	    __m128i e1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(a + 16)), _mm_loadu_si128((const __m128i *)(b + 16)));
+	    __m128i e2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(a + 32)), _mm_loadu_si128((const __m128i *)(b + 32)));
+	    if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(e0, e1), e2)) == 0xFFFF) {
+		counts[0] += 16;
+	    } else {
+		size_t j;
+		for (j = 0; j < 16; j++)
+		    counts[diff_class(a + j*3, b + j*3)]++;
+	    }
+	}
+    }
+#endif
+
+    for (; i < npix; i++)
+	counts[diff_class(d1 + i*3, d2 + i*3)]++;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
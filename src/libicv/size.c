@@ -31,7 +31,7 @@
 #include <stdio.h>
 #include <sys/stat.h>
 
-#include "icv.h"
+#include "icv_private.h"
 #include "vmath.h"
 #include "bu/log.h"
 #include "bu/malloc.h"
@@ -316,7 +316,7 @@ shrink_image(icv_image_t* bif, size_t factor)
 	    }
 
 	    for (py = 0; py < factor; py++) {
-		data_p = bif->data + (y+py)*widthstep;
+		data_p = bif->data + (y+py)*widthstep + x*bif->channels;
 		for (px = 0; px < factor; px++) {
 		    for (c = 0; c < bif->channels; c++) {
 			p[c] += *data_p++;
@@ -330,6 +330,7 @@ shrink_image(icv_image_t* bif, size_t factor)
 
     bif->width = (int)bif->width/factor;
     bif->height = (int)bif->height/factor;
+    bu_free(p, "shrink_image : Pixel Values Temp Buffer");
     bif->data = (double *)bu_realloc(bif->data, (size_t)(bif->width*bif->height*bif->channels)*sizeof(double), "shrink_image : Reallocation");
 
     return 0;
@@ -375,6 +376,7 @@ ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
     size_t widthstep;
     double *in_r, *in_c; /* Pointer to row and col of input buffers */
     double *out_data, *out_p;
+    size_t *xoff;
     xstep = (double)(bif->width-1) / (double)(out_width) - 1.0e-06;
     ystep = (double)(bif->height-1) / (double)(out_height) - 1.0e-06;
 
@@ -387,20 +389,34 @@ ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
 
     widthstep= bif->width*bif->channels;
 
+    /* the source column of each output column is the same on every
+     * row, so work it out once */
+    xoff = (size_t *)bu_malloc(out_width*sizeof(size_t), "ninterp : column offsets");
+    for (i = 0; i < out_width; i++) {
+	x = (int)(i*xstep);
+	xoff[i] = x*bif->channels;
+    }
+
     for (j = 0; j < out_height; j++) {
 	y = (int)(j*ystep);
 	in_r = bif->data + y*widthstep;
 
-	for (i = 0; i < out_width; i++) {
-	    x = (int)(i*xstep);
-
-	    in_c = in_r + x*bif->channels;
-
-	    VMOVEN(out_p, in_c, bif->channels);
-	    out_p += bif->channels;
+	if (bif->channels == 3) {
+	    for (i = 0; i < out_width; i++) {
+		in_c = in_r + xoff[i];
+		VMOVE(out_p, in_c);
+		out_p += 3;
+	    }
+	} else {
+	    for (i = 0; i < out_width; i++) {
+		in_c = in_r + xoff[i];
+		VMOVEN(out_p, in_c, bif->channels);
+		out_p += bif->channels;
+	    }
 	}
     }
 
+    bu_free(xoff, "ninterp : column offsets");
     bu_free(bif->data, "ninterp : in_data");
 
     bif->data = out_data;
@@ -416,14 +432,14 @@ ninterp(icv_image_t* bif, size_t out_width, size_t out_height)
 static int
 binterp(icv_image_t *bif, size_t out_width, size_t out_height)
 {
-    size_t i, j;
-    size_t c;
-    double x, y, dx, dy, mid1, mid2;
+    size_t j;
+    double y, dy;
     double xstep, ystep;
-    double *out_data, *out_p;
+    double *out_data;
     double *upp_r, *low_r; /* upper and lower row */
-    double *upp_c, *low_c;
-    size_t widthstep;
+    size_t widthstep, out_widthstep;
+    size_t *xoff;
+    double *xdx;
 
     xstep = (double)(bif->width - 1) / (double)out_width - 1.0e-6;
     ystep = (double)(bif->height -1) / (double)out_height - 1.0e-6;
@@ -433,10 +449,16 @@ binterp(icv_image_t *bif, size_t out_width, size_t out_height)
 	return -1;
     }
 
-    out_p = out_data = (double *)bu_malloc(out_width*out_height*bif->channels*sizeof(double), "binterp : out data");
+    out_widthstep = out_width*bif->channels;
+    out_data = (double *)bu_malloc(out_widthstep*out_height*sizeof(double), "binterp : out data");
 
     widthstep = bif->width*bif->channels;
 
+    /* per output element source offset and x weight, shared by all rows */
+    xoff = (size_t *)bu_malloc(out_widthstep*sizeof(size_t), "binterp : column offsets");
+    xdx = (double *)bu_malloc(out_widthstep*sizeof(double), "binterp : column weights");
+    icv_binterp_table(out_width, bif->channels, xstep, xoff, xdx);
+
     for (j = 0; j < out_height; j++) {
 	y = j*ystep;
 	dy = y - (int)y;
@@ -444,24 +466,10 @@ binterp(icv_image_t *bif, size_t out_width, size_t out_height)
 	low_r = bif->data + widthstep* (int)y;
 	upp_r = bif->data + widthstep* (int)(y+1);
 
-	for (i = 0; i < out_width; i++) {
-	    x = i*xstep;
-	    dx = x - (int)x;
-
-	    upp_c = upp_r + (int)x*bif->channels;
-	    low_c = low_r + (int)x*bif->channels;
-
-	    for (c = 0; c < bif->channels; c++) {
-		mid1 = low_c[0] + dx * ((double)low_c[bif->channels] - (double)low_c[0]);
-		mid2 = upp_c[0] + dx * ((double)upp_c[bif->channels] - (double)upp_c[0]);
-		*out_p = mid1 + dy * (mid2 - mid1);
-
-		out_p++;
-		upp_c++;
-		low_c++;
-	    }
-	}
+	icv_binterp_row(low_r, upp_r, xoff, xdx, dy, out_widthstep, bif->channels, out_data + j*out_widthstep);
     }
+    bu_free(xoff, "binterp : column offsets");
+    bu_free(xdx, "binterp : column weights");
     bu_free(bif->data, "binterp : Input Data");
     bif->data = out_data;
     bif->width = out_width;
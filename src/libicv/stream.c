@@ -0,0 +1,879 @@
+/*                        S T R E A M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file libicv/stream.c
+ *
+ * Band-at-a-time image pipelines.
+ *
+ * A stream is a chain of stages, each of which produces rows of its
+ * output on demand ("pull").  The sink asks the last stage for a band
+ * of rows; that stage works out which rows of its input it needs,
+ * pulls any it does not already hold into a sliding window, and then
+ * computes the band's rows in parallel.  Row requests only ever move
+ * upward through an image, so every window is a simple FIFO of rows
+ * and every source is read strictly sequentially.
+ *
+ * Each window holds roughly one band of its upstream stage's rows
+ * (plus whatever margin a filter needs), so peak memory is about
+ * band_rows * row size * number of stages, independent of height.
+ */
+
+#include "common.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "bio.h"
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/log.h"
+#include "bu/magic.h"
+#include "bu/malloc.h"
+#include "bu/parallel.h"
+#include "bu/vls.h"
+#include "vmath.h"
+#include "icv_private.h"
+
+#define STREAM_BAND_DEFAULT 64
+#define STREAM_ROW_CHUNK 4	/* rows handed to a thread at a time */
+
+typedef enum {
+    STAGE_SOURCE,
+    STAGE_FILTER,
+    STAGE_RESIZE,
+    STAGE_VAL,
+    STAGE_COMBINE
+} stage_type;
+
+struct icv_window {
+    double *data;	/* rows [lo, hi) of the upstream stage */
+    size_t lo, hi;
+    size_t cap;		/* rows allocated */
+};
+
+struct icv_stage {
+    stage_type type;
+    size_t width, height, channels;	/* of this stage's output */
+    size_t next;	/* next row to be pulled from this stage */
+    size_t step;	/* max output rows computed per chunk */
+    size_t ncpu;
+    struct icv_stage *in, *in2;
+    struct icv_window win, win2;
+
+    /* STAGE_SOURCE */
+    FILE *fp;
+    unsigned char *ubuf;
+    int warned;
+
+    /* STAGE_FILTER */
+    double kern[9];
+    double offset;
+
+    /* STAGE_RESIZE */
+    ICV_RESIZE_METHOD method;
+    size_t factor;
+    double xstep, ystep;
+    size_t *xoff;	/* binterp column tables */
+    double *xdx;
+
+    /* STAGE_VAL, STAGE_COMBINE */
+    ICV_STREAM_OP op;
+    double val;
+};
+
+struct icv_stream {
+    uint32_t magic;
+    struct icv_stage *head;	/* the last stage of the pipeline */
+    int written;
+};
+
+#define ICV_STREAM_VAL_INT(_s) if (!(_s) || (_s)->magic != ICV_STREAM_MAGIC || !(_s)->head) return -1
+
+
+static int stage_pull(struct icv_stage *st, size_t y, size_t n, double *out);
+
+
+static struct icv_stage *
+stage_create(stage_type type, struct icv_stage *in)
+{
+    struct icv_stage *st;
+    BU_GET(st, struct icv_stage);
+    memset(st, 0, sizeof(struct icv_stage));
+    st->type = type;
+    st->in = in;
+    if (in) {
+	st->width = in->width;
+	st->height = in->height;
+	st->channels = in->channels;
+    }
+    return st;
+}
+
+
+static void
+stage_destroy(struct icv_stage *st)
+{
+    if (!st)
+	return;
+    stage_destroy(st->in);
+    stage_destroy(st->in2);
+    if (st->win.data)
+	bu_free(st->win.data, "icv_stream window");
+    if (st->win2.data)
+	bu_free(st->win2.data, "icv_stream window");
+    if (st->ubuf)
+	bu_free(st->ubuf, "icv_stream row");
+    if (st->xoff)
+	bu_free(st->xoff, "icv_stream column offsets");
+    if (st->xdx)
+	bu_free(st->xdx, "icv_stream column weights");
+    if (st->fp && st->fp != stdin)
+	fclose(st->fp);
+    BU_PUT(st, struct icv_stage);
+}
+
+
+static double *
+window_row(const struct icv_window *win, const struct icv_stage *up, size_t y)
+{
+    return win->data + (y - win->lo) * up->width * up->channels;
+}
+
+
+/*
+ * Make rows [lo, hi) of 'up' available in 'win', discarding rows below
+ * lo and pulling new ones.  Requests must not move backward.
+ */
+static int
+window_fill(struct icv_window *win, struct icv_stage *up, size_t lo, size_t hi)
+{
+    size_t rowlen = up->width * up->channels;
+
+    if (hi > up->height)
+	hi = up->height;
+    if (lo > hi)
+	lo = hi;
+
+    if (win->cap < hi - lo || !win->cap) {
+	size_t ncap = (hi - lo) ? hi - lo : 1;
+	size_t keep = win->hi - win->lo;
+	if (ncap < keep)
+	    ncap = keep;
+	win->data = (double *)bu_realloc(win->data, ncap * rowlen * sizeof(double), "icv_stream window");
+	win->cap = ncap;
+    }
+
+    if (win->hi <= lo) {
+	/* nothing held is still needed; skip ahead */
+	win->lo = win->hi;
+	while (win->hi < lo) {
+	    size_t n = lo - win->hi;
+	    if (n > win->cap)
+		n = win->cap;
+	    if (stage_pull(up, win->hi, n, win->data) < 0)
+		return -1;
+	    win->hi += n;
+	}
+	win->lo = win->hi;
+    } else if (lo > win->lo) {
+	memmove(win->data, window_row(win, up, lo), (win->hi - lo) * rowlen * sizeof(double));
+	win->lo = lo;
+    }
+
+    if (hi - win->lo > win->cap) {
+	win->data = (double *)bu_realloc(win->data, (hi - win->lo) * rowlen * sizeof(double), "icv_stream window");
+	win->cap = hi - win->lo;
+    }
+
+    if (hi > win->hi) {
+	if (stage_pull(up, win->hi, hi - win->hi, window_row(win, up, win->hi)) < 0)
+	    return -1;
+	win->hi = hi;
+    }
+
+    return 0;
+}
+
+
+/* Range of input rows needed for output rows [y0, y1) */
+static void
+stage_input_range(const struct icv_stage *st, size_t y0, size_t y1, size_t *lo, size_t *hi)
+{
+    switch (st->type) {
+	case STAGE_FILTER:
+	    *lo = (y0 > 0) ? y0 - 1 : 0;
+	    *hi = y1 + 1;
+	    break;
+	case STAGE_RESIZE:
+	    switch (st->method) {
+		case ICV_RESIZE_UNDERSAMPLE:
+		    *lo = y0 * st->factor;
+		    *hi = (y1 - 1) * st->factor + 1;
+		    break;
+		case ICV_RESIZE_SHRINK:
+		    *lo = y0 * st->factor;
+		    *hi = y1 * st->factor;
+		    break;
+		case ICV_RESIZE_NINTERP:
+		    *lo = (size_t)(int)(y0 * st->ystep);
+		    *hi = (size_t)(int)((y1 - 1) * st->ystep) + 1;
+		    break;
+		default:
+		    *lo = (size_t)(int)(y0 * st->ystep);
+		    *hi = (size_t)(int)((y1 - 1) * st->ystep + 1) + 1;
+		    break;
+	    }
+	    break;
+	default:
+	    *lo = y0;
+	    *hi = y1;
+    }
+}
+
+
+static void
+filter_row(struct icv_stage *st, size_t y, double *out)
+{
+    const double *rows[3];
+    size_t r;
+
+    /* kernel row 0 applies to the row below */
+    for (r = 0; r < 3; r++)
+	rows[r] = (y + r >= 1 && y + r - 1 < st->height) ? window_row(&st->win, st->in, y + r - 1) : NULL;
+
+    icv_filter_row(st->kern, st->offset, rows, 1, st->width, st->channels, out);
+}
+
+
+/* The per-row equivalents of under_sample(), shrink_image(),
+ * ninterp() and binterp() in size.c.
+ */
+static void
+resize_row(struct icv_stage *st, size_t y, double *out)
+{
+    struct icv_stage *up = st->in;
+    size_t ch = st->channels;
+    size_t i, c, px, py;
+
+    switch (st->method) {
+	case ICV_RESIZE_UNDERSAMPLE: {
+	    const double *in_r = window_row(&st->win, up, y * st->factor);
+	    for (i = 0; i < st->width; i++, out += ch)
+		VMOVEN(out, in_r + i * st->factor * ch, ch);
+	    break;
+	}
+	case ICV_RESIZE_SHRINK: {
+	    size_t facsq = st->factor * st->factor;
+	    for (i = 0; i < st->width; i++) {
+		for (c = 0; c < ch; c++)
+		    out[c] = 0;
+		for (py = 0; py < st->factor; py++) {
+		    const double *data_p = window_row(&st->win, up, y * st->factor + py) + i * st->factor * ch;
+		    for (px = 0; px < st->factor; px++)
+			for (c = 0; c < ch; c++)
+			    out[c] += *data_p++;
+		}
+		for (c = 0; c < ch; c++)
+		    out[c] /= facsq;
+		out += ch;
+	    }
+	    break;
+	}
+	case ICV_RESIZE_NINTERP: {
+	    const double *in_r = window_row(&st->win, up, (size_t)(int)(y * st->ystep));
+	    for (i = 0; i < st->width; i++, out += ch)
+		VMOVEN(out, in_r + (size_t)(int)(i * st->xstep) * ch, ch);
+	    break;
+	}
+	default: {
+	    double yy = y * st->ystep;
+	    double dy = yy - (int)yy;
+	    const double *low_r = window_row(&st->win, up, (size_t)(int)yy);
+	    const double *upp_r = window_row(&st->win, up, (size_t)(int)(yy + 1));
+	    icv_binterp_row(low_r, upp_r, st->xoff, st->xdx, dy, st->width * ch, ch, out);
+	    break;
+	}
+    }
+}
+
+
+static double
+apply_op(ICV_STREAM_OP op, double a, double b)
+{
+    double v;
+    switch (op) {
+	case ICV_STREAM_OP_ADD:
+	    v = a + b;
+	    break;
+	case ICV_STREAM_OP_SUB:
+	    v = a - b;
+	    break;
+	case ICV_STREAM_OP_MULTIPLY:
+	    v = a * b;
+	    break;
+	case ICV_STREAM_OP_DIVIDE:
+	    v = a / b;
+	    break;
+	default:
+	    v = pow(a, b);
+    }
+    /* same as icv_sanitize() */
+    if (v > 1.0)
+	return 1.0;
+    if (v < 0)
+	return 0;
+    return v;
+}
+
+
+static void
+op_row(struct icv_stage *st, size_t y, double *out)
+{
+    size_t rowlen = st->width * st->channels;
+    const double *a = window_row(&st->win, st->in, y);
+    size_t i;
+
+    if (st->type == STAGE_COMBINE) {
+	const double *b = window_row(&st->win2, st->in2, y);
+	for (i = 0; i < rowlen; i++)
+	    out[i] = apply_op(st->op, a[i], b[i]);
+    } else {
+	for (i = 0; i < rowlen; i++)
+	    out[i] = apply_op(st->op, a[i], st->val);
+    }
+}
+
+
+static void
+stage_row(struct icv_stage *st, size_t y, double *out)
+{
+    switch (st->type) {
+	case STAGE_FILTER:
+	    filter_row(st, y, out);
+	    break;
+	case STAGE_RESIZE:
+	    resize_row(st, y, out);
+	    break;
+	default:
+	    op_row(st, y, out);
+    }
+}
+
+
+struct stream_task {
+    struct icv_stage *st;
+    size_t y, n;
+    size_t next;	/* next unclaimed row, guarded by BU_SEM_GENERAL */
+    double *out;
+};
+
+
+static void
+stream_worker(int UNUSED(cpu), void *data)
+{
+    struct stream_task *t = (struct stream_task *)data;
+    size_t rowlen = t->st->width * t->st->channels;
+
+    while (1) {
+	size_t i, end;
+
+	bu_semaphore_acquire(BU_SEM_GENERAL);
+	i = t->next;
+	t->next += STREAM_ROW_CHUNK;
+	bu_semaphore_release(BU_SEM_GENERAL);
+
+	if (i >= t->n)
+	    return;
+	end = (i + STREAM_ROW_CHUNK < t->n) ? i + STREAM_ROW_CHUNK : t->n;
+	for (; i < end; i++)
+	    stage_row(t->st, t->y + i, t->out + i * rowlen);
+    }
+}
+
+
+static int
+source_pull(struct icv_stage *st, size_t n, double *out)
+{
+    size_t rowbytes = st->width * st->channels;
+    size_t i, j;
+
+    for (i = 0; i < n; i++) {
+	size_t got = fread(st->ubuf, 1, rowbytes, st->fp);
+	if (got != rowbytes) {
+	    if (!st->warned) {
+		bu_log("icv_stream: short read at row %zu, padding with black\n", st->next + i);
+		st->warned = 1;
+	    }
+	    memset(st->ubuf + got, 0, rowbytes - got);
+	}
+	for (j = 0; j < rowbytes; j++)
+	    *out++ = ICV_CONV_8BIT(st->ubuf[j]);
+    }
+    return 0;
+}
+
+
+/*
+ * Produce output rows [y, y+n) of the stage into out.
+ */
+static int
+stage_pull(struct icv_stage *st, size_t y, size_t n, double *out)
+{
+    size_t rowlen = st->width * st->channels;
+
+    if (y != st->next || y + n > st->height) {
+	bu_log("icv_stream: out of order request for rows %zu-%zu\n", y, y + n);
+	return -1;
+    }
+
+    if (st->type == STAGE_SOURCE) {
+	if (source_pull(st, n, out) < 0)
+	    return -1;
+	st->next += n;
+	return 0;
+    }
+
+    while (n > 0) {
+	size_t cnt = (n < st->step) ? n : st->step;
+	size_t lo, hi;
+
+	stage_input_range(st, y, y + cnt, &lo, &hi);
+	if (window_fill(&st->win, st->in, lo, hi) < 0)
+	    return -1;
+	if (st->in2 && window_fill(&st->win2, st->in2, y, y + cnt) < 0)
+	    return -1;
+
+	struct stream_task t;
+	t.st = st;
+	t.y = y;
+	t.n = cnt;
+	t.next = 0;
+	t.out = out;
+	if (st->ncpu > 1 && cnt > STREAM_ROW_CHUNK) {
+	    bu_parallel(stream_worker, st->ncpu, &t);
+	} else {
+	    stream_worker(0, &t);
+	}
+
+	y += cnt;
+	n -= cnt;
+	out += cnt * rowlen;
+	st->next += cnt;
+    }
+
+    return 0;
+}
+
+
+/* Set up chunk sizes and thread counts before the first pull. */
+static void
+stage_prepare(struct icv_stage *st, size_t band, size_t ncpu)
+{
+    if (!st)
+	return;
+
+    st->ncpu = ncpu;
+    st->step = band;
+    if (st->type == STAGE_RESIZE) {
+	/* keep the input window near one band when shrinking */
+	size_t ratio = st->factor;
+	if (st->method == ICV_RESIZE_NINTERP || st->method == ICV_RESIZE_BINTERP)
+	    ratio = (st->ystep > 1.0) ? (size_t)ceil(st->ystep) : 1;
+	if (ratio > 1)
+	    st->step = (band / ratio) ? band / ratio : 1;
+    }
+
+    stage_prepare(st->in, band, ncpu);
+    stage_prepare(st->in2, band, ncpu);
+}
+
+
+static int
+stream_append(icv_stream_t *s, struct icv_stage *st)
+{
+    if (!st->width || !st->height) {
+	bu_log("icv_stream: stage would produce an empty image\n");
+	st->in = NULL;
+	stage_destroy(st);
+	return -1;
+    }
+    s->head = st;
+    return 0;
+}
+
+
+/* begin public functions */
+
+icv_stream_t *
+icv_stream_open(const char *filename, bu_mime_image_t format, size_t width, size_t height)
+{
+    struct bu_vls iname = BU_VLS_INIT_ZERO;
+    const char *ifname = filename;
+
+    if (format == BU_MIME_IMAGE_AUTO) {
+	format = icv_guess_file_format(filename, &iname);
+	if (filename)
+	    ifname = bu_vls_cstr(&iname);
+    }
+
+    if (format != BU_MIME_IMAGE_PIX && format != BU_MIME_IMAGE_BW && format != BU_MIME_IMAGE_PNG) {
+	bu_log("icv_stream_open: only pix, bw and png sources can be streamed\n");
+	bu_vls_free(&iname);
+	return NULL;
+    }
+
+    FILE *fp = (!ifname) ? stdin : fopen(ifname, "rb");
+    if (!fp) {
+	bu_log("ERROR: Cannot open file %s for reading\n", ifname);
+	bu_vls_free(&iname);
+	return NULL;
+    }
+    if (!ifname)
+	setmode(fileno(fp), O_BINARY);
+    bu_vls_free(&iname);
+
+    struct icv_stage *st = stage_create(STAGE_SOURCE, NULL);
+
+    if (format == BU_MIME_IMAGE_PNG) {
+	if (fp == stdin) {
+	    bu_log("icv_stream_open: PNG sources cannot be read from stdin\n");
+	    BU_PUT(st, struct icv_stage);
+	    return NULL;
+	}
+	st->fp = png_spool(fp, &width, &height);
+	fclose(fp);
+	if (!st->fp) {
+	    BU_PUT(st, struct icv_stage);
+	    return NULL;
+	}
+	st->channels = 3;
+    } else {
+	st->fp = fp;
+	st->channels = (format == BU_MIME_IMAGE_BW) ? 1 : 3;
+	if ((!width || !height) && fp != stdin) {
+	    b_off_t size = 0;
+	    if (!bu_fseek(fp, 0, SEEK_END))
+		size = bu_ftell(fp);
+	    rewind(fp);
+	    if (size <= 0 || !icv_image_size(NULL, 0, (size_t)size, format, &width, &height))
+		width = height = 0;
+	}
+    }
+
+    if (!width || !height) {
+	bu_log("icv_stream_open: image dimensions of %s are unknown\n", filename ? filename : "stdin");
+	stage_destroy(st);
+	return NULL;
+    }
+
+    st->width = width;
+    st->height = height;
+    st->ubuf = (unsigned char *)bu_malloc(width * st->channels, "icv_stream row");
+
+    icv_stream_t *s;
+    BU_GET(s, icv_stream_t);
+    s->magic = ICV_STREAM_MAGIC;
+    s->head = st;
+    s->written = 0;
+    return s;
+}
+
+
+size_t
+icv_stream_width(const icv_stream_t *s)
+{
+    return (s && s->head) ? s->head->width : 0;
+}
+
+
+size_t
+icv_stream_height(const icv_stream_t *s)
+{
+    return (s && s->head) ? s->head->height : 0;
+}
+
+
+size_t
+icv_stream_channels(const icv_stream_t *s)
+{
+    return (s && s->head) ? s->head->channels : 0;
+}
+
+
+int
+icv_stream_filter(icv_stream_t *s, ICV_FILTER filter_type)
+{
+    ICV_STREAM_VAL_INT(s);
+
+    struct icv_stage *st = stage_create(STAGE_FILTER, s->head);
+    if (icv_get_kernel(filter_type, st->kern, &st->offset) < 0) {
+	st->in = NULL;
+	stage_destroy(st);
+	return -1;
+    }
+    return stream_append(s, st);
+}
+
+
+int
+icv_stream_resize(icv_stream_t *s, ICV_RESIZE_METHOD method, size_t out_width, size_t out_height, size_t factor)
+{
+    ICV_STREAM_VAL_INT(s);
+
+    struct icv_stage *in = s->head;
+    struct icv_stage *st;
+
+    switch (method) {
+	case ICV_RESIZE_UNDERSAMPLE:
+	case ICV_RESIZE_SHRINK:
+	    if (UNLIKELY(factor < 1)) {
+		bu_log("Cannot shrink image to 0 factor, factor should be a positive value.");
+		return -1;
+	    }
+	    st = stage_create(STAGE_RESIZE, in);
+	    st->width = in->width / factor;
+	    st->height = in->height / factor;
+	    break;
+	case ICV_RESIZE_NINTERP:
+	case ICV_RESIZE_BINTERP:
+	    if (!out_width || !out_height)
+		return -1;
+	    st = stage_create(STAGE_RESIZE, in);
+	    st->xstep = (double)(in->width - 1) / (double)out_width - 1.0e-6;
+	    st->ystep = (double)(in->height - 1) / (double)out_height - 1.0e-6;
+	    if ((st->xstep < 1.0 && st->ystep > 1.0) || (st->xstep > 1.0 && st->ystep < 1.0)) {
+		bu_log("Operation unsupported.  Cannot stretch one dimension while compressing the other.\n");
+		st->in = NULL;
+		stage_destroy(st);
+		return -1;
+	    }
+	    st->width = out_width;
+	    st->height = out_height;
+	    if (method == ICV_RESIZE_BINTERP) {
+		st->xoff = (size_t *)bu_malloc(out_width * st->channels * sizeof(size_t), "icv_stream column offsets");
+		st->xdx = (double *)bu_malloc(out_width * st->channels * sizeof(double), "icv_stream column weights");
+		icv_binterp_table(out_width, st->channels, st->xstep, st->xoff, st->xdx);
+	    }
+	    break;
+	default:
+	    bu_log("icv_stream_resize : Invalid Option to resize");
+	    return -1;
+    }
+    st->method = method;
+    st->factor = factor;
+
+    return stream_append(s, st);
+}
+
+
+int
+icv_stream_val(icv_stream_t *s, ICV_STREAM_OP op, double val)
+{
+    ICV_STREAM_VAL_INT(s);
+
+    struct icv_stage *st = stage_create(STAGE_VAL, s->head);
+    st->op = op;
+    st->val = val;
+    return stream_append(s, st);
+}
+
+
+int
+icv_stream_combine(icv_stream_t *s, icv_stream_t *other, ICV_STREAM_OP op)
+{
+    ICV_STREAM_VAL_INT(s);
+    ICV_STREAM_VAL_INT(other);
+
+    if (s == other || s->written || other->written)
+	return -1;
+
+    if (s->head->width != other->head->width || s->head->height != other->head->height || s->head->channels != other->head->channels) {
+	bu_log("icv_stream_combine : Image Parameters not Equal");
+	return -1;
+    }
+
+    if (op == ICV_STREAM_OP_POW)
+	return -1;
+
+    struct icv_stage *st = stage_create(STAGE_COMBINE, s->head);
+    st->in2 = other->head;
+    st->op = op;
+    s->head = st;
+
+    other->head = NULL;
+    other->magic = 0;
+    BU_PUT(other, icv_stream_t);
+
+    return 0;
+}
+
+
+int
+icv_stream_write(icv_stream_t *s, const char *filename, bu_mime_image_t format, size_t band_rows, size_t ncpu)
+{
+    struct bu_vls oname = BU_VLS_INIT_ZERO;
+    const char *ofname = filename;
+    int ret = 0;
+
+    ICV_STREAM_VAL_INT(s);
+
+    if (s->written) {
+	bu_log("icv_stream_write: stream has already been written\n");
+	return -1;
+    }
+    s->written = 1;
+
+    if (format == BU_MIME_IMAGE_AUTO) {
+	format = icv_guess_file_format(filename, &oname);
+	if (filename)
+	    ofname = bu_vls_cstr(&oname);
+    }
+
+    struct icv_stage *head = s->head;
+    size_t w = head->width;
+    size_t h = head->height;
+    size_t ch = head->channels;
+    size_t och;
+
+    switch (format) {
+	case BU_MIME_IMAGE_BW:
+	    och = 1;
+	    break;
+	case BU_MIME_IMAGE_PNG:
+	    och = ch;
+	    break;
+	case BU_MIME_IMAGE_PIX:
+	    och = 3;
+	    break;
+	default:
+	    bu_log("icv_stream_write: only pix, bw and png output can be streamed\n");
+	    bu_vls_free(&oname);
+	    return -1;
+    }
+
+    if (!band_rows)
+	band_rows = STREAM_BAND_DEFAULT;
+    if (band_rows > h)
+	band_rows = h;
+    if (!ncpu)
+	ncpu = bu_avail_cpus();
+    if (ncpu > MAX_PSW)
+	ncpu = MAX_PSW;
+    stage_prepare(head, band_rows, ncpu);
+
+    FILE *fp = (ofname == NULL) ? stdout : fopen(ofname, "wb");
+    if (UNLIKELY(fp == NULL)) {
+	perror("fopen");
+	bu_log("ERROR: icv_stream_write failed to get a FILE pointer for %s\n", filename);
+	bu_vls_free(&oname);
+	return -1;
+    }
+    bu_vls_free(&oname);
+
+    /* PNG wants rows top-down, so stage them through a temp file */
+    FILE *dst = fp;
+    if (format == BU_MIME_IMAGE_PNG) {
+	dst = bu_temp_file(NULL, 0);
+	if (!dst) {
+	    bu_log("icv_stream_write: unable to create temporary file\n");
+	    if (fp != stdout)
+		fclose(fp);
+	    return -1;
+	}
+    }
+
+    double *band = (double *)bu_malloc(band_rows * w * ch * sizeof(double), "icv_stream band");
+    unsigned char *ubuf = (unsigned char *)bu_malloc(band_rows * w * och, "icv_stream band bytes");
+    double *mixed = NULL;
+    if (och < ch)
+	mixed = (double *)bu_malloc(band_rows * w * sizeof(double), "icv_stream gray band");
+
+    for (size_t y = 0; y < h && !ret; y += band_rows) {
+	size_t n = (h - y < band_rows) ? h - y : band_rows;
+	size_t npix = n * w;
+	const double *dp = band;
+
+	if (stage_pull(head, y, n, band) < 0) {
+	    ret = -1;
+	    break;
+	}
+
+	/* same conversion as icv_data2uchar(), with the color space
+	 * changes of icv_gray2rgb() and icv_rgb2gray() folded in */
+	if (ch == och) {
+	    icv_double2uchar_run(band, ubuf, npix * ch);
+	} else if (och == 1) {
+	    for (size_t i = 0; i < npix; i++, dp += ch)
+		mixed[i] = (dp[0] + dp[1] + dp[2]) / 3.0;
+	    icv_double2uchar_run(mixed, ubuf, npix);
+	} else {
+	    icv_double2uchar_run(band, ubuf, npix);
+	    for (size_t i = npix; i > 0; i--)
+		ubuf[3*i - 1] = ubuf[3*i - 2] = ubuf[3*i - 3] = ubuf[i - 1];
+	}
+
+	if (fwrite(ubuf, 1, npix * och, dst) != npix * och) {
+	    bu_log("icv_stream_write : Short Write\n");
+	    ret = -1;
+	}
+    }
+
+    bu_free(band, "icv_stream band");
+    bu_free(ubuf, "icv_stream band bytes");
+    if (mixed)
+	bu_free(mixed, "icv_stream gray band");
+
+    if (dst != fp) {
+	if (!ret) {
+	    fflush(dst);
+	    ret = png_unspool(dst, w, h, och, fp);
+	}
+	fclose(dst);
+    }
+
+    fflush(fp);
+    if (fp != stdout)
+	fclose(fp);
+
+    return ret;
+}
+
+
+int
+icv_stream_close(icv_stream_t *s)
+{
+    if (!s || s->magic != ICV_STREAM_MAGIC)
+	return -1;
+
+    stage_destroy(s->head);
+    s->magic = 0;
+    BU_PUT(s, icv_stream_t);
+    return 0;
+}
+
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,257 @@
+/*                  I C V _ S I M D _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file icv_simd_bench.c
+ *
+ * Micro-benchmarks for the vectorized libicv kernels.  Each kernel is
+ * run with the scalar loops and with the best available SIMD loops;
+ * the timings are reported and the outputs must match bit for bit.
+ * Returns non-zero if any output differs.
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/simd.h"
+#include "bu/time.h"
+#include "icv.h"
+
+static size_t width = 1024;
+static size_t height = 1024;
+static int iterations = 5;
+
+
+static icv_image_t *
+random_image(unsigned int seed, int exact)
+{
+    icv_image_t *img = icv_create(width, height, ICV_COLOR_SPACE_RGB);
+    size_t n = width * height * 3;
+    size_t i;
+
+    srand(seed);
+    for (i = 0; i < n; i++) {
+	/* 8-bit values, as read from a pix file, unless asked for
+	 * arbitrary doubles including a few out of range */
+	if (exact)
+	    img->data[i] = ICV_CONV_8BIT(rand() & 0xff);
+	else
+	    img->data[i] = (double)rand() / RAND_MAX * 1.2 - 0.1;
+    }
+    return img;
+}
+
+
+static icv_image_t *
+copy_image(const icv_image_t *src)
+{
+    icv_image_t *img = icv_create(src->width, src->height, src->color_space);
+    memcpy(img->data, src->data, src->width * src->height * src->channels * sizeof(double));
+    return img;
+}
+
+
+static int
+same_image(const icv_image_t *a, const icv_image_t *b)
+{
+    if (!a || !b || a->width != b->width || a->height != b->height || a->channels != b->channels)
+	return 0;
+    return !memcmp(a->data, b->data, a->width * a->height * a->channels * sizeof(double));
+}
+
+
+/* One benchmark: run it under a given SIMD level, return an output image */
+typedef icv_image_t *(*bench_func)(icv_image_t **in, int *result);
+
+static icv_image_t *
+bench_filter(icv_image_t **in, int *UNUSED(result))
+{
+    icv_image_t *img = copy_image(in[0]);
+    icv_filter(img, ICV_FILTER_LOW_PASS);
+    return img;
+}
+
+static icv_image_t *
+bench_filter3(icv_image_t **in, int *UNUSED(result))
+{
+    return icv_filter3(in[0], in[1], in[2], ICV_FILTER3_ANIMATION_SMEAR);
+}
+
+static icv_image_t *
+bench_binterp(icv_image_t **in, int *UNUSED(result))
+{
+    icv_image_t *img = copy_image(in[0]);
+    icv_resize(img, ICV_RESIZE_BINTERP, width * 3 / 2, height * 3 / 2, 0);
+    return img;
+}
+
+static icv_image_t *
+bench_ninterp(icv_image_t **in, int *UNUSED(result))
+{
+    icv_image_t *img = copy_image(in[0]);
+    icv_resize(img, ICV_RESIZE_NINTERP, width * 3 / 2, height * 3 / 2, 0);
+    return img;
+}
+
+static icv_image_t *
+bench_diff(icv_image_t **in, int *result)
+{
+    int matching = 0, off1 = 0, offmany = 0;
+    icv_diff(&matching, &off1, &offmany, in[0], in[3]);
+    result[0] = matching;
+    result[1] = off1;
+    result[2] = offmany;
+    return NULL;
+}
+
+static icv_image_t *
+bench_diffimg(icv_image_t **in, int *UNUSED(result))
+{
+    return icv_diffimg(in[0], in[3]);
+}
+
+static icv_image_t *
+bench_data2uchar(icv_image_t **in, int *UNUSED(result))
+{
+    unsigned char *d = icv_data2uchar(in[1]);
+    icv_image_t *img = icv_create(width, height, ICV_COLOR_SPACE_RGB);
+    size_t i;
+    for (i = 0; i < width * height * 3; i++)
+	img->data[i] = d[i];
+    bu_free(d, "uchar data");
+    return img;
+}
+
+struct bench {
+    const char *name;
+    bench_func func;
+} benches[] = {
+    {"icv_filter", bench_filter},
+    {"icv_filter3", bench_filter3},
+    {"binterp", bench_binterp},
+    {"ninterp", bench_ninterp},
+    {"icv_diff", bench_diff},
+    {"icv_diffimg", bench_diffimg},
+    {"icv_data2uchar", bench_data2uchar},
+    {NULL, NULL}
+};
+
+
+static double
+run(struct bench *b, icv_image_t **in, int level, icv_image_t **out, int *result)
+{
+    int64_t start;
+    int i;
+
+    icv_simd_level(level);
+    start = bu_gettime();
+    for (i = 0; i < iterations; i++) {
+	icv_image_t *img = b->func(in, result);
+	if (i < iterations - 1 && img)
+	    icv_destroy(img);
+	else
+	    *out = img;
+    }
+    return (double)(bu_gettime() - start) / 1.0e6 / iterations;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    icv_image_t *in[4];
+    struct bench *b;
+    int c;
+    int level;
+    int failed = 0;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "w:n:s:i:h?")) != -1) {
+	switch (c) {
+	    case 'w':
+		width = (size_t)atoi(bu_optarg);
+		break;
+	    case 'n':
+		height = (size_t)atoi(bu_optarg);
+		break;
+	    case 's':
+		width = height = (size_t)atoi(bu_optarg);
+		break;
+	    case 'i':
+		iterations = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-s squaresize] [-w width] [-n height] [-i iterations]\n", argv[0]);
+	}
+    }
+    if (width < 3 || height < 3 || iterations < 1)
+	bu_exit(1, "image must be at least 3x3 and iterations positive\n");
+
+    in[0] = random_image(1, 1);
+    in[1] = random_image(2, 0);
+    in[2] = random_image(3, 0);
+
+    /* a near-identical "next frame" for the diff benchmarks */
+    in[3] = copy_image(in[0]);
+    for (c = 0; c < 100; c++)
+	in[3]->data[((size_t)rand() % (width * height)) * 3] = ICV_CONV_8BIT(rand() & 0xff);
+
+    level = icv_simd_level(-1);
+    bu_log("%zux%zu RGB, %d iterations, SIMD level %d\n", width, height, iterations, level);
+    bu_log("%-16s %12s %12s %8s\n", "kernel", "scalar (s)", "simd (s)", "speedup");
+
+    for (b = benches; b->name; b++) {
+	icv_image_t *o1 = NULL, *o2 = NULL;
+	int r1[3] = {0, 0, 0}, r2[3] = {0, 0, 0};
+	double t1 = run(b, in, BU_SIMD_NONE, &o1, r1);
+	double t2 = run(b, in, level, &o2, r2);
+	int same = (o1 || o2) ? same_image(o1, o2) : !memcmp(r1, r2, sizeof(r1));
+
+	bu_log("%-16s %12.4f %12.4f %7.2fx%s\n", b->name, t1, t2, (t2 > 0) ? t1 / t2 : 0.0, same ? "" : "  MISMATCH");
+	if (!same)
+	    failed = 1;
+	if (o1)
+	    icv_destroy(o1);
+	if (o2)
+	    icv_destroy(o2);
+    }
+
+    icv_simd_level(-1);
+    for (c = 0; c < 4; c++)
+	icv_destroy(in[c]);
+
+    return failed;
+}
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,171 @@
+/*                    I C V _ S T R E A M . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file icv_stream.c
+ *
+ * tester function for the icv streaming api.  Stages are applied in
+ * the order filter, resize, constant, combine.
+ *
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+
+#include "bu/app.h"
+#include "bu/log.h"
+#include "bu/mime.h"
+#include "bu/getopt.h"
+#include "bu/str.h"
+#include "vmath.h"
+#include "icv.h"
+
+void usage(void)
+{
+    bu_log("[-s squaresize] [-w width] [-n height] \n\
+	    [-f lo|la|hi|hg|vg|b] [-S factor] [-r out_width x out_height]\n\
+	    [-m multiplier] [-A add_file]\n\
+	    [-B band_rows] [-P ncpu]\n\
+	    [-o out_file] file\n");
+}
+
+ICV_FILTER select_filter(char* uname)
+{
+    if (BU_STR_EQUAL(uname, "la"))
+	return ICV_FILTER_LAPLACIAN;
+    if (BU_STR_EQUAL(uname, "hi"))
+	return ICV_FILTER_HIGH_PASS;
+    if (BU_STR_EQUAL(uname, "hg"))
+	return ICV_FILTER_HORIZONTAL_GRAD;
+    if (BU_STR_EQUAL(uname, "vg"))
+	return ICV_FILTER_VERTICAL_GRAD;
+    if (BU_STR_EQUAL(uname, "b"))
+	return ICV_FILTER_BOXCAR_AVERAGE;
+    return ICV_FILTER_LOW_PASS;
+}
+
+int main(int argc, char* argv[])
+{
+    char *out_file = NULL;
+    char *in_file = NULL;
+    char *add_file = NULL;
+    int c;
+    int inx=0, iny=0;
+    int use_filter = 0;
+    size_t factor = 0;
+    size_t outx = 0, outy = 0;
+    double multiplier = 1.0;
+    size_t band = 0, ncpu = 0;
+    ICV_FILTER filter = ICV_FILTER_LOW_PASS;
+    icv_stream_t *s;
+
+    bu_setprogname(argv[0]);
+
+    if (argc<2) {
+	usage();
+	return 1;
+    }
+
+    while ((c = bu_getopt(argc, argv, "s:w:n:f:S:r:m:A:B:P:o:h?")) != -1) {
+	switch (c) {
+	    case 's':
+		inx = iny = atoi(bu_optarg);
+		break;
+	    case 'w':
+		inx = atoi(bu_optarg);
+		break;
+	    case 'n':
+		iny = atoi(bu_optarg);
+		break;
+	    case 'f':
+		filter = select_filter(bu_optarg);
+		use_filter = 1;
+		break;
+	    case 'S':
+		factor = (size_t)atoi(bu_optarg);
+		break;
+	    case 'r':
+		if (sscanf(bu_optarg, "%zux%zu", &outx, &outy) != 2) {
+		    usage();
+		    return 1;
+		}
+		break;
+	    case 'm':
+		multiplier = atof(bu_optarg);
+		break;
+	    case 'A':
+		add_file = bu_optarg;
+		break;
+	    case 'B':
+		band = (size_t)atoi(bu_optarg);
+		break;
+	    case 'P':
+		ncpu = (size_t)atoi(bu_optarg);
+		break;
+	    case 'o':
+		out_file = bu_optarg;
+		break;
+	    default:
+		usage();
+		return 1;
+	}
+    }
+    if (bu_optind >= argc) {
+	usage();
+	return 1;
+    }
+    in_file = argv[bu_optind];
+
+    s = icv_stream_open(in_file, BU_MIME_IMAGE_AUTO, inx, iny);
+    if (!s)
+	bu_exit(1, "ERROR: unable to open %s\n", in_file);
+
+    if (use_filter && icv_stream_filter(s, filter) < 0)
+	bu_exit(1, "ERROR: filter stage failed\n");
+    if (factor && icv_stream_resize(s, ICV_RESIZE_SHRINK, 0, 0, factor) < 0)
+	bu_exit(1, "ERROR: shrink stage failed\n");
+    if (outx && outy && icv_stream_resize(s, ICV_RESIZE_BINTERP, outx, outy, 0) < 0)
+	bu_exit(1, "ERROR: resize stage failed\n");
+    if (!EQUAL(multiplier, 1.0) && icv_stream_val(s, ICV_STREAM_OP_MULTIPLY, multiplier) < 0)
+	bu_exit(1, "ERROR: multiply stage failed\n");
+    if (add_file) {
+	icv_stream_t *other = icv_stream_open(add_file, BU_MIME_IMAGE_AUTO, icv_stream_width(s), icv_stream_height(s));
+	if (!other || icv_stream_combine(s, other, ICV_STREAM_OP_ADD) < 0)
+	    bu_exit(1, "ERROR: unable to add %s\n", add_file);
+    }
+
+    bu_log("writing %zux%zu image\n", icv_stream_width(s), icv_stream_height(s));
+    if (icv_stream_write(s, out_file, BU_MIME_IMAGE_AUTO, band, ncpu) < 0) {
+	icv_stream_close(s);
+	bu_exit(1, "ERROR: stream write failed\n");
+    }
+    icv_stream_close(s);
+
+    return 0;
+}
+
+/*
+ * Local Variables:
+ * tab-width: 8
+ * mode: C
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
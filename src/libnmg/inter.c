@@ -61,10 +61,12 @@
 
 #include "vmath.h"
 #include "bu/malloc.h"
+#include "bu/sort.h"
 #include "bn/mat.h"
 #include "bg/plane.h"
 #include "bv/plot3.h"
 #include "nmg.h"
+#include "./nmg_private.h"
 
 #define ISECT_NONE 0
 #define ISECT_SHARED_V 1
@@ -6384,12 +6386,279 @@ out:
 }
 
 
+/* shells with fewer faces than this are paired face by face */
+#define NMG_CRACK_BVH_MIN 32
+#define NMG_CRACK_BVH_LEAF 4
+#define NMG_CRACK_BVH_STACK 128
+
+
+struct nmg_crack_node {
+    point_t min_pt, max_pt;
+    size_t first, count;	/* leaf: span of nmg_crack_bvh.order */
+    size_t child;		/* interior: second child, the first is the next node */
+};
+
+
+/**
+ * Bounding volume hierarchy over the faces of a face table.  The face
+ * bounds are copied in at build time; crackshells refits them when
+ * nmg_face_bb() has run since, so queries always see the bounds the
+ * faces have at that moment.
+ */
+struct nmg_crack_bvh {
+    struct bu_ptbl *faces;
+    struct nmg_crack_node *nodes;
+    size_t nnodes;
+    size_t *order;		/* face table indices in leaf order */
+    fastf_t *bounds;		/* min and max of each face, by table index */
+    size_t gen;			/* nmg_face_bb_gen when bounds were copied */
+};
+
+
+static int
+nmg_crack_centroid_cmp(const void *a, const void *b, void *arg)
+{
+    const fastf_t *c = (const fastf_t *)arg;
+    fastf_t ca = c[*(const size_t *)a];
+    fastf_t cb = c[*(const size_t *)b];
+
+    if (ca < cb)
+	return -1;
+    if (ca > cb)
+	return 1;
+    /* keep the build deterministic */
+    if (*(const size_t *)a < *(const size_t *)b)
+	return -1;
+    if (*(const size_t *)a > *(const size_t *)b)
+	return 1;
+    return 0;
+}
+
+
+static int
+nmg_crack_index_cmp(const void *a, const void *b, void *UNUSED(arg))
+{
+    size_t ia = *(const size_t *)a;
+    size_t ib = *(const size_t *)b;
+
+    return (ia > ib) - (ia < ib);
+}
+
+
+/* recompute a node's bounds from its faces or its children */
+static void
+nmg_crack_node_bound(struct nmg_crack_bvh *bvh, size_t n)
+{
+    struct nmg_crack_node *node = &bvh->nodes[n];
+    size_t i;
+
+    if (node->count) {
+	VSETALL(node->min_pt, MAX_FASTF);
+	VSETALL(node->max_pt, -MAX_FASTF);
+	for (i = node->first; i < node->first + node->count; i++) {
+	    const fastf_t *b = &bvh->bounds[bvh->order[i] * 6];
+	    VMIN(node->min_pt, b);
+	    VMAX(node->max_pt, b + 3);
+	}
+	return;
+    }
+    VMOVE(node->min_pt, bvh->nodes[n + 1].min_pt);
+    VMOVE(node->max_pt, bvh->nodes[n + 1].max_pt);
+    VMIN(node->min_pt, bvh->nodes[node->child].min_pt);
+    VMAX(node->max_pt, bvh->nodes[node->child].max_pt);
+}
+
+
+/* split order[first, first + count) at the centroid median of its
+ * longest axis, returning the index of the subtree's root */
+static size_t
+nmg_crack_build(struct nmg_crack_bvh *bvh, fastf_t *centroids, size_t first, size_t count)
+{
+    size_t n = bvh->nnodes++;
+    struct nmg_crack_node *node = &bvh->nodes[n];
+    point_t cmin, cmax;
+    vect_t extent;
+    size_t i, half;
+    int axis = X;
+
+    node->first = first;
+    node->count = 0;
+    node->child = 0;
+    if (count <= NMG_CRACK_BVH_LEAF) {
+	node->count = count;
+	nmg_crack_node_bound(bvh, n);
+	return n;
+    }
+
+    VSETALL(cmin, MAX_FASTF);
+    VSETALL(cmax, -MAX_FASTF);
+    for (i = first; i < first + count; i++) {
+	const fastf_t *b = &bvh->bounds[bvh->order[i] * 6];
+	point_t c;
+	VADD2SCALE(c, b, b + 3, 0.5);
+	VMINMAX(cmin, cmax, c);
+    }
+    VSUB2(extent, cmax, cmin);
+    if (extent[Y] > extent[axis])
+	axis = Y;
+    if (extent[Z] > extent[axis])
+	axis = Z;
+
+    for (i = first; i < first + count; i++) {
+	const fastf_t *b = &bvh->bounds[bvh->order[i] * 6];
+	centroids[bvh->order[i]] = 0.5 * (b[axis] + b[axis + 3]);
+    }
+    bu_sort(&bvh->order[first], count, sizeof(size_t), nmg_crack_centroid_cmp, centroids);
+
+    half = count / 2;
+    (void)nmg_crack_build(bvh, centroids, first, half);
+    node->child = nmg_crack_build(bvh, centroids, first + half, count - half);
+    nmg_crack_node_bound(bvh, n);
+    return n;
+}
+
+
+static void
+nmg_crack_bvh_init(struct nmg_crack_bvh *bvh, struct bu_ptbl *faces)
+{
+    size_t i, nfaces = (size_t)BU_PTBL_LEN(faces);
+    fastf_t *centroids;
+
+    bvh->faces = faces;
+    bvh->nodes = (struct nmg_crack_node *)bu_malloc(2 * nfaces * sizeof(struct nmg_crack_node), "nmg_crack_bvh nodes");
+    bvh->nnodes = 0;
+    bvh->order = (size_t *)bu_malloc(nfaces * sizeof(size_t), "nmg_crack_bvh order");
+    bvh->bounds = (fastf_t *)bu_malloc(nfaces * 6 * sizeof(fastf_t), "nmg_crack_bvh bounds");
+    bvh->gen = nmg_face_bb_gen;
+
+    for (i = 0; i < nfaces; i++) {
+	const struct face *fp = (const struct face *)BU_PTBL_GET(faces, i);
+	VMOVE(&bvh->bounds[i * 6], fp->min_pt);
+	VMOVE(&bvh->bounds[i * 6 + 3], fp->max_pt);
+	bvh->order[i] = i;
+    }
+
+    centroids = (fastf_t *)bu_malloc(nfaces * sizeof(fastf_t), "nmg_crack_bvh centroids");
+    (void)nmg_crack_build(bvh, centroids, 0, nfaces);
+    bu_free(centroids, "nmg_crack_bvh centroids");
+}
+
+
+static void
+nmg_crack_bvh_free(struct nmg_crack_bvh *bvh)
+{
+    bu_free(bvh->nodes, "nmg_crack_bvh nodes");
+    bu_free(bvh->order, "nmg_crack_bvh order");
+    bu_free(bvh->bounds, "nmg_crack_bvh bounds");
+}
+
+
+/* bring the copied bounds up to date if any face bound may have moved */
+static void
+nmg_crack_bvh_refit(struct nmg_crack_bvh *bvh)
+{
+    size_t i, n, nfaces = (size_t)BU_PTBL_LEN(bvh->faces);
+    int changed = 0;
+
+    if (bvh->gen == nmg_face_bb_gen)
+	return;
+    bvh->gen = nmg_face_bb_gen;
+
+    for (i = 0; i < nfaces; i++) {
+	const struct face *fp = (const struct face *)BU_PTBL_GET(bvh->faces, i);
+	fastf_t *b = &bvh->bounds[i * 6];
+	if (VEQUAL(b, fp->min_pt) && VEQUAL(b + 3, fp->max_pt))
+	    continue;
+	VMOVE(b, fp->min_pt);
+	VMOVE(b + 3, fp->max_pt);
+	changed = 1;
+    }
+    if (!changed)
+	return;
+
+    /* children always follow their parent */
+    for (n = bvh->nnodes; n-- > 0;)
+	nmg_crack_node_bound(bvh, n);
+}
+
+
+/**
+ * Collect, in ascending order, the indices from 'first' on of the
+ * faces whose bounds are not disjoint from min_pt/max_pt by more than
+ * tol.
+ * These are exactly the faces nmg_isect_two_generic_faces() does not
+ * dismiss on its own bounding box test.  Returns the number found.
+ */
+static size_t
+nmg_crack_bvh_query(const struct nmg_crack_bvh *bvh, const point_t min_pt, const point_t max_pt, fastf_t tol, size_t first, size_t *found)
+{
+    size_t stack[NMG_CRACK_BVH_STACK];
+    size_t nfound = 0;
+    int top = 0;
+
+    stack[0] = 0;
+    while (top >= 0) {
+	const struct nmg_crack_node *node = &bvh->nodes[stack[top--]];
+	size_t i;
+
+	if (V3RPP_DISJOINT_TOL(node->min_pt, node->max_pt, min_pt, max_pt, tol))
+	    continue;
+
+	if (node->count) {
+	    for (i = node->first; i < node->first + node->count; i++) {
+		size_t j = bvh->order[i];
+		const fastf_t *b = &bvh->bounds[j * 6];
+		if (j >= first && !V3RPP_DISJOINT_TOL(b, b + 3, min_pt, max_pt, tol))
+		    found[nfound++] = j;
+	    }
+	    continue;
+	}
+
+	if (UNLIKELY(top + 2 >= NMG_CRACK_BVH_STACK))
+	    bu_bomb("nmg_crack_bvh_query(): stack size exceeded");
+	stack[++top] = node->child;
+	stack[++top] = (size_t)(node - bvh->nodes) + 1;
+    }
+
+    if (nfound > 1)
+	bu_sort(found, nfound, sizeof(size_t), nmg_crack_index_cmp, NULL);
+    return nfound;
+}
+
+
+/* intersect fu1 with the j'th face of the second shell's face table */
+static void
+nmg_crack_face_pair(struct faceuse *fu1, struct bu_ptbl *faces2, size_t j, const point_t isect_min_pt, const point_t isect_max_pt, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    struct face *fp2;
+    struct faceuse *fu2;
+
+    fp2 = (struct face *)BU_PTBL_GET(faces2, j);
+    NMG_CK_FACE(fp2);
+    fu2 = fp2->fu_p;
+    NMG_CK_FACEUSE(fu2);
+
+    if (fu2->orientation == OT_OPPOSITE) {
+	fu2 = fu2->fumate_p;
+    }
+    if (V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, isect_min_pt, isect_max_pt, tol->dist)) {
+	return;
+    }
+    nmg_isect_two_generic_faces(fu1, fu2, vlfree, tol);
+}
+
+
 /**
  * Split the components of two shells wherever they may intersect,
  * in preparation for performing boolean operations on the shells.
+ *
+ * Large shells find the faces of s2 that can meet each face of s1
+ * through a hierarchy over the s2 face bounds instead of trying every
+ * pair; the pairs are visited in the same order either way, so the
+ * result does not depend on which is used.
  */
-void
-nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol)
+static void
+crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol, int brute)
 {
     struct bu_ptbl faces1, faces2;
     struct bu_ptbl vert_list1, vert_list2;
@@ -6397,9 +6666,12 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
     struct edgeuse *eu1, *eu2;
     struct loopuse *lu1, *lu2;
     struct faceuse *fu1, *fu2;
-    struct face *fp1, *fp2;
+    struct face *fp1;
     struct shell_a *sa1, *sa2;
+    struct nmg_crack_bvh bvh;
+    size_t *found = NULL;
     size_t i, j;
+    int use_bvh;
     point_t isect_min_pt, isect_max_pt;
 
     if (UNLIKELY(nmg_debug & NMG_DEBUG_POLYSECT)) {
@@ -6464,6 +6736,16 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	nmg_vshell(&s2->r_p->s_hd, s2->r_p);
     }
 
+    /* the pairwise loop is kept for debugging, where every pair
+     * tried is reported */
+    use_bvh = BU_PTBL_LEN(&faces2) >= NMG_CRACK_BVH_MIN
+	&& !(nmg_debug & NMG_DEBUG_POLYSECT)
+	&& !brute;
+    if (use_bvh) {
+	nmg_crack_bvh_init(&bvh, &faces2);
+	found = (size_t *)bu_malloc(BU_PTBL_LEN(&faces2) * sizeof(size_t), "nmg_crackshells found");
+    }
+
     for (i = 0; i < (size_t)BU_PTBL_LEN(&faces1); i++) {
 	fp1 = (struct face *)BU_PTBL_GET(&faces1, i);
 	NMG_CK_FACE(fp1);
@@ -6477,19 +6759,28 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	    continue;
 	}
 
-	for (j = 0; j < (size_t)BU_PTBL_LEN(&faces2); j++) {
-	    fp2 = (struct face *)BU_PTBL_GET(&faces2, j);
-	    NMG_CK_FACE(fp2);
-	    fu2 = fp2->fu_p;
-	    NMG_CK_FACEUSE(fu2);
+	if (use_bvh) {
+	    size_t nfound, k;
+
+	    nmg_crack_bvh_refit(&bvh);
+	    nfound = nmg_crack_bvh_query(&bvh, fp1->min_pt, fp1->max_pt, tol->dist, 0, found);
+	    k = 0;
+	    while (k < nfound) {
+		j = found[k++];
+		nmg_crack_face_pair(fu1, &faces2, j, isect_min_pt, isect_max_pt, vlfree, tol);
 
-	    if (fu2->orientation == OT_OPPOSITE) {
-		fu2 = fu2->fumate_p;
+		/* cutting may have moved the bounds of fp1 or of faces
+		 * still to come, ask again for the ones after j */
+		if (bvh.gen != nmg_face_bb_gen) {
+		    nmg_crack_bvh_refit(&bvh);
+		    nfound = nmg_crack_bvh_query(&bvh, fp1->min_pt, fp1->max_pt, tol->dist, j + 1, found);
+		    k = 0;
+		}
 	    }
-	    if (V3RPP_DISJOINT_TOL(fp2->min_pt, fp2->max_pt, isect_min_pt, isect_max_pt, tol->dist)) {
-		continue;
+	} else {
+	    for (j = 0; j < (size_t)BU_PTBL_LEN(&faces2); j++) {
+		nmg_crack_face_pair(fu1, &faces2, j, isect_min_pt, isect_max_pt, vlfree, tol);
 	    }
-	    nmg_isect_two_generic_faces(fu1, fu2, vlfree, tol);
 	}
 
 	/*
@@ -6529,6 +6820,10 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 	}
     }
 
+    if (use_bvh) {
+	nmg_crack_bvh_free(&bvh);
+	bu_free(found, "nmg_crackshells found");
+    }
     bu_ptbl_free(&faces1);
     bu_ptbl_free(&faces2);
 
@@ -6602,6 +6897,20 @@ nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, cons
 }
 
 
+void
+nmg_crackshells(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    crackshells(s1, s2, vlfree, tol, 0);
+}
+
+
+void
+nmg_crackshells_brute(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    crackshells(s1, s2, vlfree, tol, 1);
+}
+
+
 int
 nmg_fu_touchingloops(const struct faceuse *fu)
 {
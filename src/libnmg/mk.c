@@ -2302,6 +2302,9 @@ nmg_face_g_snurb(struct faceuse *fu, int u_order, int v_order, int n_u_knots,
 }
 
 
+THREADLOCAL size_t nmg_face_bb_gen = 0;
+
+
 /**
  * Build the bounding box for a face
  */
@@ -2316,6 +2319,8 @@ nmg_face_bb(struct face *f, const struct bn_tol *tol)
     fu = f->fu_p;
     NMG_CK_FACEUSE(fu);
 
+    nmg_face_bb_gen++;
+
     f->max_pt[X] = f->max_pt[Y] = f->max_pt[Z] = -MAX_FASTF;
     f->min_pt[X] = f->min_pt[Y] = f->min_pt[Z] = MAX_FASTF;
 
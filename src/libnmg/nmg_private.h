@@ -50,6 +50,25 @@
 NMG_EXPORT extern int nmg_keg(struct edgeuse *eu);
 
 
+/**
+ * @brief Count of nmg_face_bb() calls made by this thread.
+ *
+ * A face's bounding box only changes through nmg_face_bb(), so callers
+ * that cache face bounds can compare this against the value they saw
+ * when they filled the cache to learn whether it may be stale.
+ */
+extern THREADLOCAL size_t nmg_face_bb_gen;
+
+
+/**
+ * @brief nmg_crackshells() trying every pair of faces rather than
+ * looking them up through the face hierarchy.
+ *
+ * The reference the hierarchy is checked against.
+ */
+NMG_EXPORT extern void nmg_crackshells_brute(struct shell *s1, struct shell *s2, struct bu_list *vlfree, const struct bn_tol *tol);
+
+
 /* Currently commented out */
 NMG_EXPORT extern double nmg_vu_angle_measure(struct vertexuse   *vu,
                                               vect_t x_dir,
@@ -0,0 +1,253 @@
+/*                  C R A C K S H E L L S . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file crackshells.c
+ *
+ * Cracks two overlapping tessellated spheres against each other twice,
+ * once trying every face pair (nmg_crackshells_brute()) and once
+ * through the face hierarchy, reports the time each took, and fails
+ * unless both leave the same vertices, edges and faces behind.
+ *
+ * Usage: nmg_test crackshells [segments]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/time.h"
+#include "nmg.h"
+
+#include "../nmg_private.h"
+
+
+/* a sphere of 2 * n * (n - 1) triangles as a shell of its own region */
+static void
+crackshells_sphere(struct model *m, const point_t center, fastf_t radius, int n, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    struct nmgregion *r;
+    struct shell *s;
+    struct vertex **verts;
+    int nverts = (n - 1) * n + 2;
+    int lat, lon;
+
+    r = nmg_mrsv(m);
+    s = BU_LIST_FIRST(shell, &r->s_hd);
+    verts = (struct vertex **)bu_calloc(nverts, sizeof(struct vertex *), "sphere verts");
+
+    /* rings of n vertices from north to south, then the two poles */
+    for (lat = 0; lat < n; lat++) {
+	for (lon = 0; lon < n; lon++) {
+	    int a, b, c, d;
+	    struct vertex **tri[3];
+
+	    if (lat == 0) {
+		a = nverts - 2;
+		c = lon;
+		d = (lon + 1) % n;
+		tri[0] = &verts[a];
+		tri[1] = &verts[c];
+		tri[2] = &verts[d];
+		(void)nmg_cmface(s, tri, 3);
+		continue;
+	    }
+	    if (lat == n - 1) {
+		a = (lat - 1) * n + lon;
+		b = (lat - 1) * n + (lon + 1) % n;
+		c = nverts - 1;
+		tri[0] = &verts[a];
+		tri[1] = &verts[c];
+		tri[2] = &verts[b];
+		(void)nmg_cmface(s, tri, 3);
+		continue;
+	    }
+	    a = (lat - 1) * n + lon;
+	    b = (lat - 1) * n + (lon + 1) % n;
+	    c = lat * n + lon;
+	    d = lat * n + (lon + 1) % n;
+	    tri[0] = &verts[a];
+	    tri[1] = &verts[c];
+	    tri[2] = &verts[d];
+	    (void)nmg_cmface(s, tri, 3);
+	    tri[0] = &verts[a];
+	    tri[1] = &verts[d];
+	    tri[2] = &verts[b];
+	    (void)nmg_cmface(s, tri, 3);
+	}
+    }
+
+    for (lat = 1; lat < n; lat++) {
+	fastf_t phi = M_PI * lat / n;
+	for (lon = 0; lon < n; lon++) {
+	    fastf_t theta = M_2PI * lon / n;
+	    point_t p;
+	    VSET(p, sin(phi) * cos(theta), sin(phi) * sin(theta), cos(phi));
+	    VJOIN1(p, center, radius, p);
+	    nmg_vertex_gv(verts[(lat - 1) * n + lon], p);
+	}
+    }
+    {
+	point_t p;
+	VSET(p, center[X], center[Y], center[Z] + radius);
+	nmg_vertex_gv(verts[nverts - 2], p);
+	VSET(p, center[X], center[Y], center[Z] - radius);
+	nmg_vertex_gv(verts[nverts - 1], p);
+    }
+    bu_free(verts, "sphere verts");
+
+    {
+	struct faceuse *fu;
+	for (BU_LIST_FOR(fu, faceuse, &s->fu_hd)) {
+	    if (fu->orientation != OT_SAME)
+		continue;
+	    nmg_calc_face_g(fu, vlfree);
+	}
+    }
+    nmg_edge_fuse(&s->l.magic, vlfree, tol);
+    nmg_region_a(r, tol);
+    nmg_fix_normals(s, vlfree, tol);
+}
+
+
+/* crack the first two shells of m, returning the elapsed seconds */
+static double
+crackshells_run(struct model *m, int brute, struct bu_list *vlfree, const struct bn_tol *tol)
+{
+    struct nmgregion *r1, *r2;
+    int64_t start;
+
+    r1 = BU_LIST_FIRST(nmgregion, &m->r_hd);
+    r2 = BU_LIST_PNEXT(nmgregion, r1);
+
+    start = bu_gettime();
+    if (brute)
+	nmg_crackshells_brute(BU_LIST_FIRST(shell, &r1->s_hd), BU_LIST_FIRST(shell, &r2->s_hd), vlfree, tol);
+    else
+	nmg_crackshells(BU_LIST_FIRST(shell, &r1->s_hd), BU_LIST_FIRST(shell, &r2->s_hd), vlfree, tol);
+    return (bu_gettime() - start) / 1000000.0;
+}
+
+
+static int
+crackshells_compare(struct model *m1, struct model *m2, struct bu_list *vlfree)
+{
+    struct bu_ptbl t1, t2;
+    int result = 0;
+    size_t i;
+
+    if (m1->maxindex != m2->maxindex) {
+	bu_log("Error maxindex of model. m1: %ld, m2: %ld\n", m1->maxindex, m2->maxindex);
+	result = -1;
+    }
+
+    nmg_vertex_tabulate(&t1, &m1->magic, vlfree);
+    nmg_vertex_tabulate(&t2, &m2->magic, vlfree);
+    if (BU_PTBL_LEN(&t1) != BU_PTBL_LEN(&t2)) {
+	bu_log("Error vertex count. m1: %zu, m2: %zu\n", (size_t)BU_PTBL_LEN(&t1), (size_t)BU_PTBL_LEN(&t2));
+	result = -1;
+    } else {
+	for (i = 0; i < (size_t)BU_PTBL_LEN(&t1); i++) {
+	    struct vertex *v1 = (struct vertex *)BU_PTBL_GET(&t1, i);
+	    struct vertex *v2 = (struct vertex *)BU_PTBL_GET(&t2, i);
+	    if (v1->index != v2->index || !VEQUAL(v1->vg_p->coord, v2->vg_p->coord)) {
+		bu_log("Error vertex %zu differs\n", i);
+		result = -1;
+		break;
+	    }
+	}
+    }
+    bu_ptbl_free(&t1);
+    bu_ptbl_free(&t2);
+
+    nmg_edge_tabulate(&t1, &m1->magic, vlfree);
+    nmg_edge_tabulate(&t2, &m2->magic, vlfree);
+    if (BU_PTBL_LEN(&t1) != BU_PTBL_LEN(&t2)) {
+	bu_log("Error edge count. m1: %zu, m2: %zu\n", (size_t)BU_PTBL_LEN(&t1), (size_t)BU_PTBL_LEN(&t2));
+	result = -1;
+    }
+    bu_ptbl_free(&t1);
+    bu_ptbl_free(&t2);
+
+    nmg_face_tabulate(&t1, &m1->magic, vlfree);
+    nmg_face_tabulate(&t2, &m2->magic, vlfree);
+    if (BU_PTBL_LEN(&t1) != BU_PTBL_LEN(&t2)) {
+	bu_log("Error face count. m1: %zu, m2: %zu\n", (size_t)BU_PTBL_LEN(&t1), (size_t)BU_PTBL_LEN(&t2));
+	result = -1;
+    }
+    bu_ptbl_free(&t1);
+    bu_ptbl_free(&t2);
+
+    return result;
+}
+
+
+int
+main(int argc, char **argv)
+{
+    struct bu_list vlfree;
+    struct bn_tol tol = BN_TOL_INIT_TOL;
+    struct model *m1, *m2;
+    point_t c1, c2;
+    double tbrute, tbvh;
+    int n = 24;
+    int result;
+
+    if (argc > 2)
+	bu_exit(1, "Usage: %s [segments]\n", argv[0]);
+    if (argc == 2)
+	n = atoi(argv[1]);
+    if (n < 4)
+	bu_exit(1, "Usage: %s [segments]\n", argv[0]);
+
+    BU_LIST_INIT(&vlfree);
+
+    VSET(c1, 0.0, 0.0, 0.0);
+    VSET(c2, 0.37, 0.21, 0.13);
+    m1 = nmg_mm();
+    crackshells_sphere(m1, c1, 1.0, n, &vlfree, &tol);
+    crackshells_sphere(m1, c2, 0.9, n, &vlfree, &tol);
+    m2 = nmg_clone_model(m1);
+
+    tbrute = crackshells_run(m1, 1, &vlfree, &tol);
+    tbvh = crackshells_run(m2, 0, &vlfree, &tol);
+
+    bu_log("%d faces per shell: every pair %.3fs, hierarchy %.3fs, %.2fx\n",
+	   2 * n * (n - 1), tbrute, tbvh, (tbvh > 0) ? tbrute / tbvh : 0.0);
+
+    result = crackshells_compare(m1, m2, &vlfree);
+
+    nmg_km(m1);
+    nmg_km(m2);
+
+    return (result < 0) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -46,6 +46,17 @@
 /** Heads linked list of lights */
 struct light_specific LightHead;
 
+/** Lights sampled at each shading point, 0 to test every light */
+int light_samples = 0;
+
+/* the lights in LightHead, for light_obs() to draw from */
+static struct light_specific **light_tab = NULL;
+static int light_ntab = 0;
+
+/* per cpu running sums of the light weights for light_obs_sample(),
+ * each light_ntab long and allocated on the cpu's first use */
+static double *light_wgt[MAX_PSW] = {NULL};
+
 /* local sp_hook functions */
 /* for light_print_tab and light_parse callbacks */
 static void aim_set(const struct bu_structparse *, const char *, void *, const char *, void *);
@@ -56,6 +67,7 @@ static int light_setup(struct region *rp, struct bu_vls *matparm, void **dpp, co
 static int light_render(struct application *ap, const struct partition *pp, struct shadework *swp, void *dp);
 static void light_print(register struct region *rp, void *dp);
 static void light_free(void *cp);
+static void light_wgt_free(void);
 
 
 /** callback registration table for this shader in optical_shader_init() */
@@ -770,14 +782,41 @@ light_init(struct application *ap)
 	    }
 	}
     }
-    if (nlights > SW_NLIGHTS) {
-	bu_log("Number of lights limited to %d\n", SW_NLIGHTS);
-	nlights = SW_NLIGHTS;
+    light_wgt_free();
+    light_tab = (struct light_specific **)bu_realloc(light_tab, (nlights + 1) * sizeof(struct light_specific *), "light table");
+    light_ntab = 0;
+    for (BU_LIST_FOR(lsp, light_specific, &(LightHead.l))) {
+	light_tab[light_ntab++] = lsp;
     }
+
+    if (light_samples > 0 && light_samples < nlights) {
+	bu_log("Lighting: sampling %d of %d lights at each hit\n",
+	       (light_samples < SW_NLIGHTS) ? light_samples : SW_NLIGHTS, nlights);
+    } else if (nlights > SW_NLIGHTS) {
+	bu_log("Lighting: sampling %d of %d lights at each hit, set light_samples to change\n",
+	       SW_NLIGHTS, nlights);
+    }
+    if (nlights > SW_NLIGHTS)
+	nlights = SW_NLIGHTS;
     return nlights;
 }
 
 
+/* release the light weights of every cpu, whose size follows light_ntab */
+static void
+light_wgt_free(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_PSW; i++) {
+	if (light_wgt[i]) {
+	    bu_free(light_wgt[i], "light weights");
+	    light_wgt[i] = NULL;
+	}
+    }
+}
+
+
 /**
  * Called from view_end().  Take care of releasing storage for any
  * lights which will not be cleaned up by mlib_free(): implicitly
@@ -789,6 +828,13 @@ light_cleanup(void)
 {
     register struct light_specific *lsp, *zaplsp;
 
+    if (light_tab) {
+	bu_free(light_tab, "light table");
+	light_tab = NULL;
+    }
+    light_ntab = 0;
+    light_wgt_free();
+
     if (!BU_LIST_IS_INITIALIZED(&(LightHead.l))) {
 	BU_LIST_INIT(&(LightHead.l));
 	return;
@@ -1434,6 +1480,146 @@ light_vis(struct light_obs_stuff *los, char *flags)
 }
 
 
+/**
+ * Set up los for shooting at los->lsp: a coordinate system about the
+ * light center with the hitpoint->light ray as one of the axes.
+ */
+static void
+light_obs_frame(struct light_obs_stuff *los)
+{
+    if (los->lsp->lt_infinite) {
+	VMOVE(los->to_light_center, los->lsp->lt_vec);
+    } else {
+	VSUB2(los->to_light_center, los->lsp->lt_pos, los->swp->sw_hit.hit_point);
+    }
+    VUNITIZE(los->to_light_center);
+    bn_vec_ortho(los->light_x, los->to_light_center);
+    VCROSS(los->light_y, los->to_light_center, los->light_x);
+}
+
+
+/**
+ * The light_obs() of scenes with more lights than are worth testing
+ * at every hit.  nsamples lights are drawn at random, with
+ * replacement, in proportion to how much each can light the hit
+ * point, and one visibility ray is shot per draw.  The fraction of
+ * each drawn light seen is divided by its chance of being drawn, so on
+ * average the lighting is what testing every light gives, and fewer
+ * samples trade more noise for speed.
+ */
+static void
+light_obs_sample(struct light_obs_stuff *los, char *flags, int flag_size, int have, int nsamples)
+{
+    struct shadework *swp = los->swp;
+    struct light_specific *lsp;
+    double *wgt;			/* running sum of the weights */
+    double total = 0.0;
+    int drawn[SW_NLIGHTS];		/* light_tab index of each slot */
+    int ndrawn[SW_NLIGHTS];		/* times each slot was drawn */
+    int nslots = 0;
+    int i, j, s;
+
+    wgt = light_wgt[los->ap->a_resource->re_cpu];
+    if (!wgt) {
+	wgt = (double *)bu_malloc(light_ntab * sizeof(double), "light weights");
+	light_wgt[los->ap->a_resource->re_cpu] = wgt;
+    }
+
+    /* weigh each light by its share of the light and how squarely it
+     * faces the surface, dropping the ones every light_obs() skips */
+    for (i = 0; i < light_ntab; i++) {
+	double w;
+	vect_t dir;
+
+	lsp = light_tab[i];
+	w = (lsp->lt_fraction > 0.001) ? lsp->lt_fraction : 0.001;
+	if (have & MFI_NORMAL) {
+	    double cosine;
+
+	    if (lsp->lt_infinite) {
+		VMOVE(dir, lsp->lt_vec);
+	    } else {
+		VSUB2(dir, lsp->lt_pos, swp->sw_hit.hit_point);
+	    }
+	    VUNITIZE(dir);
+	    cosine = VDOT(swp->sw_hit.hit_normal, dir);
+	    if (cosine < 0 && swp->sw_transmit <= 0)
+		w = 0.0;	/* backfacing, opaque */
+	    else
+		w *= (cosine > 0.1) ? cosine : 0.1;
+	}
+	total += w;
+	wgt[i] = total;
+    }
+
+    for (j = 0; j < SW_NLIGHTS; j++) {
+	swp->sw_visible[j] = (struct light_specific *)NULL;
+	swp->sw_lightfract[j] = 0.0;
+    }
+
+    for (s = 0; total > 0.0 && s < nsamples; s++) {
+	double u = (bn_rand_half(los->ap->a_resource->re_randptr) + 0.5) * total;
+	int lo = 0;
+	int hi = light_ntab - 1;
+
+	/* the first light whose running sum passes u, which is never
+	 * one weighed zero unless u is right at the end */
+	while (lo < hi) {
+	    int mid = (lo + hi) / 2;
+	    if (wgt[mid] <= u)
+		lo = mid + 1;
+	    else
+		hi = mid;
+	}
+	while (lo > 0 && wgt[lo] <= wgt[lo - 1])
+	    lo--;
+
+	for (j = 0; j < nslots && drawn[j] != lo; j++)
+	    ;
+	if (j == nslots) {
+	    drawn[nslots] = lo;
+	    ndrawn[nslots++] = 0;
+	}
+	ndrawn[j]++;
+    }
+
+    for (j = 0; j < nslots; j++) {
+	double prob;
+	int visibility = 0;
+	int vis_ray;
+
+	i = drawn[j];
+	prob = (wgt[i] - ((i > 0) ? wgt[i - 1] : 0.0)) / total;
+
+	los->lsp = light_tab[i];
+	los->inten = &swp->sw_intensity[3*j];
+	light_obs_frame(los);
+	VMOVE(&swp->sw_tolight[3*j], los->to_light_center);
+
+	if (flag_size > 0) {
+	    memset(flags, 0, flag_size * sizeof(char));
+	}
+	for (vis_ray = 0; vis_ray < ndrawn[j]; vis_ray++) {
+	    int lv;
+
+	    los->iter = vis_ray;
+	    lv = light_vis(los, flags);
+	    if (lv == 1) {
+		visibility++;
+	    } else if (lv == -1) {
+		/* no shadows, so no more rays */
+		visibility = ndrawn[j];
+		break;
+	    }
+	}
+	if (visibility) {
+	    swp->sw_visible[j] = los->lsp;
+	    swp->sw_lightfract[j] = (fastf_t)(visibility / (nsamples * prob));
+	}
+    }
+}
+
+
 /**
  * Determine the visibility of each light source in the scene from a
  * particular location.  It is up to the caller to apply
@@ -1460,6 +1646,7 @@ light_obs(struct application *ap, struct shadework *swp, int have)
     int vis_ray;
     int tot_vis_rays;
     int visibility;
+    int nsamples;
     struct light_obs_stuff los = {NULL, NULL, NULL, NULL, NULL, 0, VINIT_ZERO, VINIT_ZERO, VINIT_ZERO};
     static int rand_idx;
     int flag_size = 0;
@@ -1487,6 +1674,20 @@ light_obs(struct application *ap, struct shadework *swp, int have)
 	flags = (char *)bu_calloc(flag_size, sizeof(char), "callocate flags array");
     }
 
+    /* with more lights than are to be tested, draw a few of them */
+    nsamples = light_samples;
+    if (nsamples <= 0 && light_ntab > SW_NLIGHTS)
+	nsamples = SW_NLIGHTS;
+    if (nsamples > SW_NLIGHTS)
+	nsamples = SW_NLIGHTS;
+    if (nsamples > 0 && nsamples < light_ntab) {
+	light_obs_sample(&los, flags, flag_size, have, nsamples);
+	if (flags && flags != static_flags) {
+	    bu_free(flags, "free flags array");
+	}
+	return;
+    }
+
     /*
      * Determine light visibility
      *
@@ -1500,6 +1701,9 @@ light_obs(struct application *ap, struct shadework *swp, int have)
     for (BU_LIST_FOR(lsp, light_specific, &(LightHead.l))) {
 	RT_CK_LIGHT(lsp);
 
+	if (i >= SW_NLIGHTS)
+	    break;
+
 	if (optical_debug & OPTICAL_DEBUG_LIGHT)
 	    bu_log("computing for light %d\n", i);
 	swp->sw_lightfract[i] = 0.0;
@@ -1513,14 +1717,7 @@ light_obs(struct application *ap, struct shadework *swp, int have)
 	/* create a coordinate system about the light center with the
 	 * hitpoint->light ray as one of the axes
 	 */
-	if (lsp->lt_infinite) {
-	    VMOVE(los.to_light_center, lsp->lt_vec);
-	} else {
-	    VSUB2(los.to_light_center, lsp->lt_pos, swp->sw_hit.hit_point);
-	}
-	VUNITIZE(los.to_light_center);
-	bn_vec_ortho(los.light_x, los.to_light_center);
-	VCROSS(los.light_y, los.to_light_center, los.light_x);
+	light_obs_frame(&los);
 
 	/*
 	 * If we have a normal, test against light direction
@@ -283,6 +283,8 @@ viewshade(struct application *ap, const struct partition *pp, struct shadework *
 	i=0;
 	for (BU_LIST_FOR(lp, light_specific, &(LightHead.l))) {
 	    RT_CK_LIGHT(lp);
+	    if (i >= SW_NLIGHTS)
+		break;
 	    swp->sw_visible[i++] = lp;
 	}
 	for (; i < SW_NLIGHTS; i++) {
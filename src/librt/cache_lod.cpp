@@ -0,0 +1,477 @@
+/*                   C A C H E _ L O D . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2016-2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file cache_lod.cpp
+ *
+ * Caching of LoD drawing data
+ *
+ * Generation runs on a pool of background workers.  Each worker loads
+ * a BoT with its own resource and hands it to bv_mesh_lod_cache(),
+ * which hashes the mesh and only builds POP data for content it has
+ * not seen before, so re-running over an already cached database costs
+ * little more than reading the BoTs.  Memory is bounded by only
+ * starting an object when the estimated footprint of everything in
+ * flight stays below DB_MESH_LOD_MEM_BUDGET.
+ */
+
+#include "common.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* implementation headers */
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/parallel.h"
+#include "bu/path.h"
+#include "bu/process.h"
+#include "bu/time.h"
+#include "rt/db_instance.h"
+
+#include "./librt_private.h"
+
+/* Upper limit on the estimated memory of the BoTs being processed at
+ * once.  A single object larger than this is still processed, alone. */
+#define DB_MESH_LOD_MEM_BUDGET (1024ULL*1024ULL*1024ULL)
+
+/* POP generation holds the unpacked mesh plus per-level vertex and
+ * triangle sets - roughly this many times the on-disk size. */
+#define DB_MESH_LOD_MEM_FACTOR 8
+
+struct db_mesh_lod_job {
+    std::string name;
+    size_t mem;
+};
+
+struct db_mesh_lod_queue {
+    std::mutex m;
+    std::condition_variable work_cv;	// new work, freed memory or stop
+    std::condition_variable done_cv;	// a job finished
+    std::recursive_mutex dir_m;		// see db_mesh_lod_dir_lock()
+    std::deque<db_mesh_lod_job> jobs;
+    std::vector<std::thread> workers;
+    size_t mem_used = 0;
+    int active = 0;
+    int verbose = 0;
+    bool stop = false;
+};
+
+
+static struct bv_mesh_lod_context *
+mesh_lod_ctx(struct db_i *dbip)
+{
+    if (!dbip || !dbip->i)
+	return NULL;
+
+    // Set up the cache for file backed databases the first time it is
+    // needed
+    if (!dbip->i->mesh_c && dbip->dbi_filename) {
+	dbip->i->mesh_c = bv_mesh_lod_context_create(dbip->dbi_filename);
+	dbip->i->mesh_c_owned = 1;
+    }
+
+    return dbip->i->mesh_c;
+}
+
+
+/* Load the named BoT and make sure the cache holds LoD data for its
+ * current content, recording the resulting key under its name.  The
+ * previous key, if any, is returned in old_key.  If dir_m is given it
+ * is held while the directory entry is in use. */
+static int
+mesh_lod_generate(struct db_i *dbip, const char *name, std::recursive_mutex *dir_m, struct resource *resp, unsigned long long *key, unsigned long long *old_key)
+{
+    struct bv_mesh_lod_context *c = dbip->i->mesh_c;
+
+    *key = 0;
+    *old_key = bv_mesh_lod_key_get(c, name);
+
+    struct rt_db_internal dbintern;
+    RT_DB_INTERNAL_INIT(&dbintern);
+    struct rt_db_internal *ip = &dbintern;
+    if (dir_m)
+	dir_m->lock();
+    struct directory *dp = db_lookup(dbip, name, LOOKUP_QUIET);
+    if (dp == RT_DIR_NULL || dp->d_minor_type != DB5_MINORTYPE_BRLCAD_BOT) {
+	if (dir_m)
+	    dir_m->unlock();
+	return BRLCAD_ERROR;
+    }
+    int ret = rt_db_get_internal(ip, dp, dbip, NULL, resp);
+    if (dir_m)
+	dir_m->unlock();
+    if (ret < 0)
+	return BRLCAD_ERROR;
+    if (ip->idb_minor_type != DB5_MINORTYPE_BRLCAD_BOT) {
+	bu_log("Error processing %s - mismatch between d_minor_type and idb_minor_type (%c)\n", name, ip->idb_minor_type);
+	rt_db_free_internal(&dbintern);
+	return BRLCAD_ERROR;
+    }
+    struct rt_bot_internal *bot = (struct rt_bot_internal *)ip->idb_ptr;
+    RT_BOT_CK_MAGIC(bot);
+
+    // Data is keyed on the content hash - if this mesh was cached
+    // before, no new data is generated
+    *key = bv_mesh_lod_cache(c, (const point_t *)bot->vertices, bot->num_vertices, NULL, bot->faces, bot->num_faces, 0, 0.66);
+    rt_db_free_internal(&dbintern);
+    if (!*key) {
+	bu_log("Error processing %s - unable to generate LoD data\n", name);
+	return BRLCAD_ERROR;
+    }
+
+    if (*key != *old_key)
+	bv_mesh_lod_key_put(c, name, *key);
+
+    return BRLCAD_OK;
+}
+
+
+static void
+mesh_lod_worker(struct db_i *dbip, struct db_mesh_lod_queue *q, int cpu)
+{
+    struct resource *resp;
+    BU_GET(resp, struct resource);
+    rt_init_resource(resp, cpu, NULL);
+
+    std::unique_lock<std::mutex> lock(q->m);
+    while (true) {
+	// The front job starts once it fits in the memory budget, or
+	// when nothing else is running
+	q->work_cv.wait(lock, [q] {
+		return q->stop || (!q->jobs.empty() && (!q->mem_used || q->mem_used + q->jobs.front().mem <= DB_MESH_LOD_MEM_BUDGET));
+		});
+	if (q->stop)
+	    break;
+
+	db_mesh_lod_job job = q->jobs.front();
+	q->jobs.pop_front();
+	q->mem_used += job.mem;
+	q->active++;
+	lock.unlock();
+
+	if (q->verbose > 1)
+	    bu_log("Processing:  %s\n", job.name.c_str());
+
+	// The object may have been deleted or changed type since it
+	// was queued
+	unsigned long long key, old_key;
+	(void)mesh_lod_generate(dbip, job.name.c_str(), &q->dir_m, resp, &key, &old_key);
+
+	lock.lock();
+	q->mem_used -= job.mem;
+	q->active--;
+	dbip->i->mesh_c_completed++;
+	q->work_cv.notify_all();
+	q->done_cv.notify_all();
+    }
+    lock.unlock();
+
+    rt_clean_resource_basic(NULL, resp);
+    BU_PUT(resp, struct resource);
+}
+
+
+/* Stop the workers, abandoning whatever is still queued */
+static void
+mesh_lod_workers_stop(struct db_mesh_lod_queue *q)
+{
+    {
+	std::lock_guard<std::mutex> lock(q->m);
+	q->jobs.clear();
+	q->stop = true;
+    }
+    q->work_cv.notify_all();
+    for (size_t i = 0; i < q->workers.size(); i++)
+	q->workers[i].join();
+    q->workers.clear();
+    q->stop = false;
+}
+
+
+void
+db_mesh_lod_workers_destroy(struct db_i_internal *i)
+{
+    if (!i || !i->mesh_q)
+	return;
+    mesh_lod_workers_stop(i->mesh_q);
+    delete i->mesh_q;
+    i->mesh_q = NULL;
+}
+
+
+void
+db_mesh_lod_start(struct db_i *dbip, int verbose)
+{
+    if (!mesh_lod_ctx(dbip))
+	return;
+
+    if (!dbip->i->mesh_q)
+	dbip->i->mesh_q = new db_mesh_lod_queue;
+    struct db_mesh_lod_queue *q = dbip->i->mesh_q;
+
+    std::lock_guard<std::mutex> lock(q->m);
+
+    // Already running
+    if (!q->jobs.empty() || q->active)
+	return;
+
+    q->verbose = verbose;
+    dbip->i->mesh_c_completed = 0;
+    dbip->i->mesh_c_target = 0;
+    struct directory *dp;
+    for (int i = 0; i < RT_DBNHASH; i++) {
+	for (dp = dbip->dbi_Head[i]; dp != RT_DIR_NULL; dp = dp->d_forw) {
+	    if (dp->d_addr == RT_DIR_PHONY_ADDR)
+		continue;
+	    if (dp->d_minor_type != DB5_MINORTYPE_BRLCAD_BOT)
+		continue;
+	    db_mesh_lod_job job;
+	    job.name = std::string(dp->d_namep);
+	    job.mem = dp->d_len * DB_MESH_LOD_MEM_FACTOR;
+	    q->jobs.push_back(job);
+	    dbip->i->mesh_c_target++;
+	}
+    }
+
+    if (q->workers.empty()) {
+	// Leave a processor for the application
+	size_t ncpus = bu_avail_cpus();
+	size_t nworkers = (ncpus > 1) ? ncpus - 1 : 1;
+	if (nworkers > (size_t)MAX_PSW - 1)
+	    nworkers = (size_t)MAX_PSW - 1;
+	for (size_t i = 0; i < nworkers; i++)
+	    q->workers.push_back(std::thread(mesh_lod_worker, dbip, q, (int)i + 1));
+    }
+    q->work_cv.notify_all();
+}
+
+
+int
+db_mesh_lod_progress(struct db_i *dbip, int *completed, int *target)
+{
+    if (!dbip || !dbip->i)
+	return 0;
+
+    struct db_mesh_lod_queue *q = dbip->i->mesh_q;
+    if (!q) {
+	if (completed)
+	    (*completed) = dbip->i->mesh_c_completed;
+	if (target)
+	    (*target) = dbip->i->mesh_c_target;
+	return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(q->m);
+    if (completed)
+	(*completed) = dbip->i->mesh_c_completed;
+    if (target)
+	(*target) = dbip->i->mesh_c_target;
+    return (!q->jobs.empty() || q->active) ? 1 : 0;
+}
+
+
+int
+db_mesh_lod_prioritize(struct db_i *dbip, const char *name)
+{
+    if (!dbip || !dbip->i || !dbip->i->mesh_q || !name)
+	return 0;
+
+    struct db_mesh_lod_queue *q = dbip->i->mesh_q;
+    std::lock_guard<std::mutex> lock(q->m);
+    for (size_t i = 0; i < q->jobs.size(); i++) {
+	if (q->jobs[i].name != name)
+	    continue;
+	if (i) {
+	    db_mesh_lod_job job = q->jobs[i];
+	    q->jobs.erase(q->jobs.begin() + i);
+	    q->jobs.push_front(job);
+	}
+	return 1;
+    }
+
+    return 0;
+}
+
+
+void
+db_mesh_lod_wait(struct db_i *dbip)
+{
+    if (!dbip || !dbip->i || !dbip->i->mesh_q)
+	return;
+
+    struct db_mesh_lod_queue *q = dbip->i->mesh_q;
+    int64_t start = bu_gettime();
+    std::unique_lock<std::mutex> lock(q->m);
+    while (!q->jobs.empty() || q->active) {
+	q->done_cv.wait_for(lock, std::chrono::seconds(5));
+	if (q->verbose && (!q->jobs.empty() || q->active)) {
+	    fastf_t seconds = (bu_gettime() - start) / 1000000.0;
+	    bu_log("LoD cache processing (%g seconds): completed %d of %d BoTs\n", seconds, dbip->i->mesh_c_completed, dbip->i->mesh_c_target);
+	}
+    }
+}
+
+
+void
+db_mesh_lod_cancel(struct db_i *dbip)
+{
+    if (!dbip || !dbip->i || !dbip->i->mesh_q)
+	return;
+
+    mesh_lod_workers_stop(dbip->i->mesh_q);
+}
+
+
+void
+db_mesh_lod_init(struct db_i *dbip, int verbose)
+{
+    if (!mesh_lod_ctx(dbip))
+	return;
+
+    int64_t overall_start = bu_gettime();
+
+    db_mesh_lod_start(dbip, verbose);
+    db_mesh_lod_wait(dbip);
+
+    int64_t elapsed = bu_gettime() - overall_start;
+    int rseconds = elapsed / 1000000;
+    int rminutes = rseconds / 60;
+    int rhours = rminutes / 60;
+    rminutes = rminutes % 60;
+    rseconds = rseconds % 60;
+    bu_log("Mesh LoD caching complete (Elapsed time: %02d:%02d:%02d)\n", rhours, rminutes, rseconds);
+}
+
+
+void
+db_mesh_lod_dir_lock(struct db_i *dbip)
+{
+    if (!dbip || !dbip->i || !dbip->i->mesh_q)
+	return;
+    dbip->i->mesh_q->dir_m.lock();
+}
+
+
+void
+db_mesh_lod_dir_unlock(struct db_i *dbip)
+{
+    if (!dbip || !dbip->i || !dbip->i->mesh_q)
+	return;
+    dbip->i->mesh_q->dir_m.unlock();
+}
+
+
+void
+db_mesh_lod_context_set(struct db_i *dbip, struct bv_mesh_lod_context *c)
+{
+    if (!dbip || !dbip->i)
+	return;
+
+    db_mesh_lod_cancel(dbip);
+
+    if (dbip->i->mesh_c && dbip->i->mesh_c_owned)
+	bv_mesh_lod_context_destroy(dbip->i->mesh_c);
+    dbip->i->mesh_c = c;
+    dbip->i->mesh_c_owned = 0;
+}
+
+
+void
+db_mesh_lod_clear(struct db_i *dbip)
+{
+    if (!mesh_lod_ctx(dbip))
+	return;
+
+    bv_mesh_lod_clear_cache(dbip->i->mesh_c, 0);
+}
+
+
+int
+db_mesh_lod_update(struct db_i *dbip, const char *name)
+{
+    if (!mesh_lod_ctx(dbip))
+	return BRLCAD_ERROR;
+
+    // No-op
+    if (!name)
+	return BRLCAD_OK;
+
+    // If this isn't an active BoT, clear any stale name mapping and we're
+    // done.
+    struct directory *dp = db_lookup(dbip, name, LOOKUP_QUIET);
+    if (dp == RT_DIR_NULL || dp->d_minor_type != DB5_MINORTYPE_BRLCAD_BOT) {
+	unsigned long long key = bv_mesh_lod_key_get(dbip->i->mesh_c, name);
+	if (key) {
+	    bv_mesh_lod_clear_cache(dbip->i->mesh_c, key);
+	    bv_mesh_lod_key_put(dbip->i->mesh_c, name, 0);
+	}
+	return BRLCAD_OK;
+    }
+
+    unsigned long long key, old_key;
+    if (mesh_lod_generate(dbip, name, NULL, &rt_uniresource, &key, &old_key) != BRLCAD_OK)
+	return BRLCAD_ERROR;
+
+    // Content changed - drop the data for the old content
+    if (old_key && old_key != key)
+	bv_mesh_lod_clear_cache(dbip->i->mesh_c, old_key);
+
+    // Make sure we can retrieve the cached data
+    // TODO - may not really be necessary to verify this here once we're
+    // working - including during early stages for testing.
+    struct bv_mesh_lod *lod = bv_mesh_lod_create(dbip->i->mesh_c, key);
+    if (!lod) {
+	bu_log("Error processing %s - unable to retrieve LoD data\n", dp->d_namep);
+	return BRLCAD_ERROR;
+    }
+
+    bv_mesh_lod_destroy(lod);
+
+    return BRLCAD_OK;
+}
+
+
+struct bv_mesh_lod *
+db_mesh_lod_get(struct db_i *dbip, const char *name)
+{
+    if (!dbip || !dbip->i || !name || !dbip->i->mesh_c)
+	return NULL;
+
+    struct bv_mesh_lod *lod = NULL;
+
+    unsigned long long key = bv_mesh_lod_key_get(dbip->i->mesh_c, name);
+    if (key)
+	lod = bv_mesh_lod_create(dbip->i->mesh_c, key);
+
+    return lod;
+}
+
+// Local Variables:
+// tab-width: 8
+// mode: C++
+// c-basic-offset: 4
+// indent-tabs-mode: t
+// c-file-style: "stroustrup"
+// End:
+// ex: shiftwidth=4 tabstop=8
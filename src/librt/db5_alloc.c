@@ -35,6 +35,7 @@
 #include "vmath.h"
 #include "rt/db5.h"
 #include "raytrace.h"
+#include "librt_private.h"
 
 int
 db5_write_free(struct db_i *dbip, struct directory *dp, size_t length)
@@ -92,8 +93,8 @@ db5_write_free(struct db_i *dbip, struct directory *dp, size_t length)
 }
 
 
-int
-db5_realloc(struct db_i *dbip, struct directory *dp, struct bu_external *ep)
+static int
+db5_realloc_storage(struct db_i *dbip, struct directory *dp, struct bu_external *ep)
 {
     b_off_t baseaddr;
     size_t baselen;
@@ -232,6 +233,20 @@ db5_realloc(struct db_i *dbip, struct directory *dp, struct bu_external *ep)
 }
 
 
+int
+db5_realloc(struct db_i *dbip, struct directory *dp, struct bu_external *ep)
+{
+    int ret;
+
+    /* Background LoD generation may be reading from dp's storage */
+    db_mesh_lod_dir_lock(dbip);
+    ret = db5_realloc_storage(dbip, dp, ep);
+    db_mesh_lod_dir_unlock(dbip);
+
+    return ret;
+}
+
+
 /** @} */
 /*
  * Local Variables:
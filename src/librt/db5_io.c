@@ -764,23 +764,32 @@ db_put_external5(struct bu_external *ep, struct directory *dp, struct db_i *dbip
 	return -1;
     }
 
+    /* Background LoD generation must not read the object while it is
+     * being moved or rewritten */
+    db_mesh_lod_dir_lock(dbip);
+
     /* Second, obtain storage for final object */
     if (ep->ext_nbytes != dp->d_len || (size_t)dp->d_addr == (size_t)RT_DIR_PHONY_ADDR) {
 	if (db5_realloc(dbip, dp, ep) < 0) {
+	    db_mesh_lod_dir_unlock(dbip);
 	    bu_log("db_put_external(%s) db_realloc5() failed\n", dp->d_namep);
 	    return -5;
 	}
     }
     BU_ASSERT(ep->ext_nbytes == dp->d_len);
+    db_attr_index_changed(dbip, dp, 0);
 
     if (dp->d_flags & RT_DIR_INMEM) {
 	memcpy(dp->d_un.ptr, (char *)ep->ext_buf, ep->ext_nbytes);
+	db_mesh_lod_dir_unlock(dbip);
 	return 0;
     }
 
     if (db_write(dbip, (char *)ep->ext_buf, ep->ext_nbytes, dp->d_addr) < 0) {
+	db_mesh_lod_dir_unlock(dbip);
 	return -1;
     }
+    db_mesh_lod_dir_unlock(dbip);
 
     /* Made a change for real - do callback */
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
@@ -820,22 +829,30 @@ rt_db_put_internal5(
     }
     BU_CK_EXTERNAL(&ext);
 
+    /* As in db_put_external5() */
+    db_mesh_lod_dir_lock(dbip);
+
     if (ext.ext_nbytes != dp->d_len || dp->d_addr == RT_DIR_PHONY_ADDR) {
 	if (db5_realloc(dbip, dp, &ext) < 0) {
+	    db_mesh_lod_dir_unlock(dbip);
 	    bu_log("rt_db_put_internal5(%s) db_realloc5() failed\n", dp->d_namep);
 	    goto fail;
 	}
     }
     BU_ASSERT(ext.ext_nbytes == dp->d_len);
+    db_attr_index_changed(dbip, dp, 0);
 
     if (dp->d_flags & RT_DIR_INMEM) {
 	memcpy(dp->d_un.ptr, ext.ext_buf, ext.ext_nbytes);
+	db_mesh_lod_dir_unlock(dbip);
 	goto ok;
     }
 
     if (db_write(dbip, (char *)ext.ext_buf, ext.ext_nbytes, dp->d_addr) < 0) {
+	db_mesh_lod_dir_unlock(dbip);
 	goto fail;
     }
+    db_mesh_lod_dir_unlock(dbip);
 
     /* Made a change for real - do callback */
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
@@ -225,8 +225,12 @@ db_diradd5(
     dp->d_animate = NULL;
     dp->d_nref = 0;
     dp->d_uses = 0;
+    db_mesh_lod_dir_lock(dbip);
     dp->d_forw = *headp;
     *headp = dp;
+    db_mesh_lod_dir_unlock(dbip);
+
+    db_attr_index_changed(dbip, dp, 1);
 
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&dbip->dbi_changed_clbks); i++) {
@@ -315,8 +319,12 @@ db5_diradd(struct db_i *dbip,
     dp->d_animate = NULL;
     dp->d_nref = 0;
     dp->d_uses = 0;
+    db_mesh_lod_dir_lock(dbip);
     dp->d_forw = *headp;
     *headp = dp;
+    db_mesh_lod_dir_unlock(dbip);
+
+    db_attr_index_changed(dbip, dp, 1);
 
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&dbip->dbi_changed_clbks); i++) {
@@ -33,6 +33,7 @@
 #include "vmath.h"
 #include "rt/db4.h"
 #include "raytrace.h"
+#include "librt_private.h"
 
 
 /**
@@ -138,10 +139,14 @@ db_delete(struct db_i *dbip, struct directory *dp)
     if (RT_G_DEBUG&RT_DEBUG_DB) bu_log("db_delete(%s) %p, %p\n",
 				    dp->d_namep, (void *)dbip, (void *)dp);
 
+    /* Background LoD generation may be reading the object */
+    db_mesh_lod_dir_lock(dbip);
+
     if (dp->d_flags & RT_DIR_INMEM) {
 	bu_free(dp->d_un.ptr, "db_delete d_un.ptr");
 	dp->d_un.ptr = NULL;
 	dp->d_len = 0;
+	db_mesh_lod_dir_unlock(dbip);
 	return 0;
     }
 
@@ -157,6 +162,7 @@ db_delete(struct db_i *dbip, struct directory *dp)
 
     dp->d_len = 0;
     dp->d_addr = RT_DIR_PHONY_ADDR;
+    db_mesh_lod_dir_unlock(dbip);
     return i;
 }
 
@@ -0,0 +1,195 @@
+/*                D B _ A T T R _ I N D E X . C P P
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file db_attr_index.cpp
+ *
+ * In memory index of object attributes, from attribute name to value
+ * to the directory entries carrying it.
+ *
+ * The index is built the first time it is asked for, by reading the
+ * attributes of every object once.  Writes and directory changes only
+ * mark the objects involved, and those are read again the next time
+ * the index is consulted, so a burst of edits costs no more than the
+ * objects it touched.  Deleted objects are dropped immediately, since
+ * their directory entries are recycled.
+ */
+
+#include "common.h"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "bu/avs.h"
+#include "bu/parallel.h"
+#include "rt/db_instance.h"
+#include "rt/db_attr.h"
+#include "rt/directory.h"
+
+#include "./librt_private.h"
+
+typedef std::unordered_set<struct directory *> db_attr_objs;
+typedef std::unordered_map<std::string, db_attr_objs> db_attr_vals;
+
+struct db_attr_index {
+    /* name -> value -> objects */
+    std::unordered_map<std::string, db_attr_vals> names;
+
+    /* what each object was indexed under, to unindex it again */
+    std::unordered_map<struct directory *, std::vector<std::pair<std::string, std::string>>> objs;
+
+    /* objects to read again before the next lookup */
+    std::unordered_set<struct directory *> dirty;
+};
+
+
+static void
+attr_index_remove(struct db_attr_index *idx, struct directory *dp)
+{
+    auto o_it = idx->objs.find(dp);
+    if (o_it == idx->objs.end())
+	return;
+
+    for (auto &nv : o_it->second) {
+	auto n_it = idx->names.find(nv.first);
+	if (n_it == idx->names.end())
+	    continue;
+	auto v_it = n_it->second.find(nv.second);
+	if (v_it == n_it->second.end())
+	    continue;
+	v_it->second.erase(dp);
+	if (v_it->second.empty())
+	    n_it->second.erase(v_it);
+	if (n_it->second.empty())
+	    idx->names.erase(n_it);
+    }
+    idx->objs.erase(o_it);
+}
+
+
+static void
+attr_index_add(struct db_attr_index *idx, struct db_i *dbip, struct directory *dp)
+{
+    struct bu_attribute_value_set avs;
+    struct bu_attribute_value_pair *avpp;
+
+    /* objects that can't be read have no attributes to search on */
+    bu_avs_init_empty(&avs);
+    if (db5_get_attributes(dbip, &avs, dp) < 0) {
+	bu_avs_free(&avs);
+	return;
+    }
+
+    std::vector<std::pair<std::string, std::string>> &nvs = idx->objs[dp];
+    for (BU_AVS_FOR(avpp, &avs)) {
+	if (!avpp->name || !avpp->value)
+	    continue;
+	nvs.push_back(std::make_pair(std::string(avpp->name), std::string(avpp->value)));
+	idx->names[nvs.back().first][nvs.back().second].insert(dp);
+    }
+    bu_avs_free(&avs);
+}
+
+
+void
+db_attr_index_changed(struct db_i *dbip, struct directory *dp, int mode)
+{
+    if (!dbip || !dbip->i || !dp)
+	return;
+
+    bu_semaphore_acquire(BU_SEM_GENERAL);
+    dbip->i->attr_index_gen++;
+    struct db_attr_index *idx = dbip->i->attr_index;
+    if (!idx) {
+	bu_semaphore_release(BU_SEM_GENERAL);
+	return;
+    }
+    if (mode == 2) {
+	attr_index_remove(idx, dp);
+	idx->dirty.erase(dp);
+    } else {
+	idx->dirty.insert(dp);
+    }
+    bu_semaphore_release(BU_SEM_GENERAL);
+}
+
+
+void
+db_attr_index_destroy(struct db_i_internal *i)
+{
+    if (!i || !i->attr_index)
+	return;
+    delete i->attr_index;
+    i->attr_index = NULL;
+}
+
+
+int
+db_attr_index_find(struct bu_ptbl *objs, struct db_i *dbip, const char *name, int (*match)(const char *value, void *data), void *data)
+{
+    struct directory *dp;
+
+    if (!objs || !dbip || !dbip->i || !name)
+	return -1;
+
+    bu_semaphore_acquire(BU_SEM_GENERAL);
+
+    if (!dbip->i->attr_index) {
+	dbip->i->attr_index = new db_attr_index;
+	FOR_ALL_DIRECTORY_START(dp, dbip) {
+	    attr_index_add(dbip->i->attr_index, dbip, dp);
+	} FOR_ALL_DIRECTORY_END;
+    }
+
+    struct db_attr_index *idx = dbip->i->attr_index;
+    for (auto d_it = idx->dirty.begin(); d_it != idx->dirty.end(); d_it++) {
+	attr_index_remove(idx, *d_it);
+	attr_index_add(idx, dbip, *d_it);
+    }
+    idx->dirty.clear();
+
+    int cnt = 0;
+    auto n_it = idx->names.find(std::string(name));
+    if (n_it != idx->names.end()) {
+	for (auto &v : n_it->second) {
+	    if (match && !(*match)(v.first.c_str(), data))
+		continue;
+	    for (auto *vdp : v.second) {
+		bu_ptbl_ins(objs, (long *)vdp);
+		cnt++;
+	    }
+	}
+    }
+
+    bu_semaphore_release(BU_SEM_GENERAL);
+
+    return cnt;
+}
+
+
+// Local Variables:
+// tab-width: 8
+// mode: C++
+// c-basic-offset: 4
+// indent-tabs-mode: t
+// c-file-style: "stroustrup"
+// End:
+// ex: shiftwidth=4 tabstop=8
@@ -39,6 +39,8 @@
 #include "raytrace.h"
 #include "rt/db_diff.h"
 
+#include "./librt_private.h"
+
 /* Exposed as private function to librt, but not (currently) beyond librt -
  * see librt_private.h */
 int
@@ -286,7 +288,7 @@ struct diff_elements {
 };
 
 static void
-get_diff_components(struct diff_elements *el, const struct db_i *dbip, const struct directory *dp)
+get_diff_components(struct diff_elements *el, const struct db_i *dbip, const struct directory *dp, struct resource *resp)
 {
     el->name = NULL;
     el->idb_ptr = NULL;
@@ -326,7 +328,7 @@ get_diff_components(struct diff_elements *el, const struct db_i *dbip, const str
     /* Now deal with more normal objects */
     BU_GET(el->intern, struct rt_db_internal);
     RT_DB_INTERNAL_INIT(el->intern);
-    if (rt_db_get_internal(el->intern, dp, dbip, (fastf_t *)NULL, &rt_uniresource) < 0) {
+    if (rt_db_get_internal(el->intern, dp, dbip, (fastf_t *)NULL, resp) < 0) {
 	/* Arrgh - No internal representation */
 	rt_db_free_internal(el->intern);
 	BU_PUT(el->intern, struct rt_db_internal);
@@ -435,19 +437,27 @@ diff_dp_attr_unchgd(const char *attr_name, const char *attr_val, void *data)
     return avp->state;
 }
 
-int
-db_diff_dp(const struct db_i *left,
+/* compare left_dp and right_dp, importing through resp.  When same is
+ * set the two serialize to the same bytes, so only the left object is
+ * imported and compared against itself - unless it is a bin_params
+ * type, whose internals are compared with memcmp and so must come from
+ * two separate imports to give the same answer as a full comparison. */
+static int
+diff_dp(const struct db_i *left,
 	const struct db_i *right,
 	const struct directory *left_dp,
 	const struct directory *right_dp,
 	const struct bn_tol *diff_tol,
 	db_compare_criteria_t flags,
-	struct diff_result *ext_result)
+	struct diff_result *ext_result,
+	struct resource *resp,
+	int same)
 {
     int state = DIFF_EMPTY;
 
     struct diff_elements left_components;
     struct diff_elements right_components;
+    struct diff_elements *rc = &right_components;
 
     struct diff_result *result = NULL;
 
@@ -466,17 +476,23 @@ db_diff_dp(const struct db_i *left,
     if (left_dp) result->dp_left = left_dp;
     if (right_dp) result->dp_right = right_dp;
 
-    get_diff_components(&left_components, left, left_dp);
-    get_diff_components(&right_components, right, right_dp);
+    get_diff_components(&left_components, left, left_dp, resp);
+    if (left_components.bin_params)
+	same = 0;
+    if (same) {
+	rc = &left_components;
+    } else {
+	get_diff_components(&right_components, right, right_dp, resp);
+    }
 
     if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
 
-	result->param_state |= db_avs_diff(left_components.params, right_components.params, diff_tol, diff_dp_attr_add, diff_dp_attr_del, diff_dp_attr_chgd, diff_dp_attr_unchgd, (void *)(result->param_diffs));
+	result->param_state |= db_avs_diff(left_components.params, rc->params, diff_tol, diff_dp_attr_add, diff_dp_attr_del, diff_dp_attr_chgd, diff_dp_attr_unchgd, (void *)(result->param_diffs));
 	/*compare the idb_ptr memory, if the types are the same.*/
-	if (left_components.bin_params && right_components.bin_params && left_components.idb_ptr && right_components.idb_ptr) {
-	    if (left_components.intern->idb_minor_type == right_components.intern->idb_minor_type) {
+	if (left_components.bin_params && rc->bin_params && left_components.idb_ptr && rc->idb_ptr) {
+	    if (left_components.intern->idb_minor_type == rc->intern->idb_minor_type) {
 		int memsize = OBJ[left_components.intern->idb_type].ft_internal_size;
-		if (memcmp((void *)left_components.idb_ptr, (void *)right_components.idb_ptr, memsize)) {
+		if (memcmp((void *)left_components.idb_ptr, (void *)rc->idb_ptr, memsize)) {
 		    /* If we didn't pick up differences in the avs comparison, we need to use this result to flag a parameter difference */
 		    if (result->param_state == DIFF_UNCHANGED || result->param_state == DIFF_EMPTY) result->param_state |= DIFF_CHANGED;
 		} else {
@@ -487,11 +503,12 @@ db_diff_dp(const struct db_i *left,
     }
 
     if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-	result->attr_state |= db_avs_diff(left_components.attrs, right_components.attrs, diff_tol, diff_dp_attr_add, diff_dp_attr_del, diff_dp_attr_chgd, diff_dp_attr_unchgd, (void *)(result->attr_diffs));
+	result->attr_state |= db_avs_diff(left_components.attrs, rc->attrs, diff_tol, diff_dp_attr_add, diff_dp_attr_del, diff_dp_attr_chgd, diff_dp_attr_unchgd, (void *)(result->attr_diffs));
     }
 
     free_diff_components(&left_components);
-    free_diff_components(&right_components);
+    if (rc == &right_components)
+	free_diff_components(&right_components);
 
     state |= result->param_state;
     state |= result->attr_state;
@@ -505,89 +522,15 @@ db_diff_dp(const struct db_i *left,
 }
 
 int
-db_diff(const struct db_i *dbip1,
-	const struct db_i *dbip2,
+db_diff_dp(const struct db_i *left,
+	const struct db_i *right,
+	const struct directory *left_dp,
+	const struct directory *right_dp,
 	const struct bn_tol *diff_tol,
 	db_compare_criteria_t flags,
-	struct bu_ptbl *results)
+	struct diff_result *ext_result)
 {
-    int state = DIFF_EMPTY;
-    struct directory *dp1=RT_DIR_NULL, *dp2=RT_DIR_NULL;
-
-    /* look at all objects in this database */
-    FOR_ALL_DIRECTORY_START(dp1, dbip1) {
-	struct bu_external ext1 = BU_EXTERNAL_INIT_ZERO;
-	struct bu_external ext2 = BU_EXTERNAL_INIT_ZERO;
-	int extern_state = DIFF_UNCHANGED;
-	struct diff_result *result = NULL;
-	BU_GET(result, struct diff_result);
-	diff_init_result(result, diff_tol, dp1->d_namep);
-
-	/* determine the status of this object in the other database */
-	dp2 = db_lookup(dbip2, dp1->d_namep, 0);
-
-	/* If we're checking everything, we want a sanity check to make sure we spot it when the objects differ */
-	if (flags == DB_COMPARE_ALL && dp1 != RT_DIR_NULL && dp1->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY && dp2 != RT_DIR_NULL && dp2->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY) {
-	    if (db_get_external(&ext1, dp1, dbip1) || db_get_external(&ext2, dp2, dbip2)) {
-		bu_log("WARNING: Unexpected failure reading serialized data for %s and %s\n", dp1->d_namep, dp2->d_namep);
-	    } else {
-		if (db_diff_external(&ext1, &ext2)) {extern_state = DIFF_CHANGED;}
-	    }
-	    bu_free_external(&ext1);
-	    bu_free_external(&ext2);
-	}
-
-	/* Do internal diffs */
-	if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
-	    state |= db_diff_dp(dbip1, dbip2, dp1, dp2, diff_tol, DB_COMPARE_PARAM, result);
-	}
-	if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-	    state |= db_diff_dp(dbip1, dbip2, dp1, dp2, diff_tol, DB_COMPARE_ATTRS, result);
-	}
-	if (flags == DB_COMPARE_ALL && state == DIFF_UNCHANGED && extern_state == DIFF_CHANGED) {
-	    //bu_log("WARNING: internal and bu_external comparison disagree for %s and %s\n", dp1->d_namep, dp2->d_namep);
-	}
-
-	if (results) {
-	    bu_ptbl_ins(results, (long *)result);
-	} else {
-	    diff_free_result(result);
-	    BU_PUT(result, struct diff_result);
-	}
-
-    } FOR_ALL_DIRECTORY_END;
-
-    /* now look for objects in the other database that aren't here */
-    FOR_ALL_DIRECTORY_START(dp2, dbip2) {
-
-	/* determine the status of this object in the other database */
-	dp1 = db_lookup(dbip1, dp2->d_namep, 0);
-
-	/* By this point, any differences will be additions */
-	if (dp1 == RT_DIR_NULL) {
-	    struct diff_result *result;
-	    BU_GET(result, struct diff_result);
-	    diff_init_result(result, diff_tol, dp2->d_namep);
-
-	    /* Do internal diffs */
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
-		state |= db_diff_dp(dbip1, dbip2, dp1, dp2, diff_tol, DB_COMPARE_PARAM, result);
-	    }
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-		state |= db_diff_dp(dbip1, dbip2, dp1, dp2, diff_tol, DB_COMPARE_ATTRS, result);
-	    }
-
-	    if (results) {
-		bu_ptbl_ins(results, (long *)result);
-	    } else {
-		diff_free_result(result);
-		BU_PUT(result, struct diff_result);
-	    }
-	}
-
-    } FOR_ALL_DIRECTORY_END;
-
-    return state;
+    return diff_dp(left, right, left_dp, right_dp, diff_tol, flags, ext_result, &rt_uniresource, 0);
 }
 
 int
@@ -790,8 +733,16 @@ diff3_dp_attr_unchgd(const char *attr_name, const char *attr_val, void *data)
     return avp->state;
 }
 
-int
-db_diff3_dp(const struct db_i *left,
+/* which of the three objects serialize to the same bytes */
+#define DIFF3_SAME_LEFT 0x1	/* left and ancestor */
+#define DIFF3_SAME_RIGHT 0x2	/* right and ancestor */
+#define DIFF3_SAME_LR 0x4	/* left and right */
+
+/* compare three objects, importing through resp and only importing
+ * once each set of them that the same flags say are identical.  As in
+ * diff_dp(), bin_params types are always imported three times. */
+static int
+diff3_dp(const struct db_i *left,
 	const struct db_i *ancestor,
 	const struct db_i *right,
 	const struct directory *left_dp,
@@ -799,13 +750,18 @@ db_diff3_dp(const struct db_i *left,
 	const struct directory *right_dp,
 	const struct bn_tol *diff3_tol,
 	db_compare_criteria_t flags,
-	struct diff_result *ext_result)
+	struct diff_result *ext_result,
+	struct resource *resp,
+	int same)
 {
     int state = DIFF_EMPTY;
 
     struct diff_elements left_components;
     struct diff_elements ancestor_components;
     struct diff_elements right_components;
+    struct diff_elements *lc = &left_components;
+    struct diff_elements *ac = &ancestor_components;
+    struct diff_elements *rc = &right_components;
 
     struct diff_result *result = NULL;
 
@@ -826,23 +782,35 @@ db_diff3_dp(const struct db_i *left,
     if (ancestor_dp) result->dp_ancestor = ancestor_dp;
     if (right_dp) result->dp_right = right_dp;
 
-    get_diff_components(&left_components, left, left_dp);
-    get_diff_components(&ancestor_components, ancestor, ancestor_dp);
-    get_diff_components(&right_components, right, right_dp);
+    get_diff_components(&ancestor_components, ancestor, ancestor_dp, resp);
+    if (ancestor_components.bin_params)
+	same = 0;
+    if (same & DIFF3_SAME_LEFT) {
+	lc = ac;
+    } else {
+	get_diff_components(&left_components, left, left_dp, resp);
+    }
+    if (same & DIFF3_SAME_RIGHT) {
+	rc = ac;
+    } else if (same & DIFF3_SAME_LR) {
+	rc = lc;
+    } else {
+	get_diff_components(&right_components, right, right_dp, resp);
+    }
 
     if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
 
-	result->param_state |= db_avs_diff3(left_components.params, ancestor_components.params, right_components.params,
+	result->param_state |= db_avs_diff3(lc->params, ac->params, rc->params,
 		diff3_tol, diff3_dp_attr_add, diff3_dp_attr_del, diff3_dp_attr_chgd, diff3_dp_attr_conflict,
 		diff3_dp_attr_unchgd, (void *)(result->param_diffs));
 	/*compare the idb_ptr memory, if the types are the same.*/
-	if (left_components.bin_params && ancestor_components.bin_params && right_components.bin_params)
-	   if (left_components.idb_ptr && ancestor_components.idb_ptr && right_components.idb_ptr) {
-	    if ((left_components.intern->idb_minor_type == ancestor_components.intern->idb_minor_type) &&
-		    (left_components.intern->idb_minor_type == right_components.intern->idb_minor_type)) {
-		int memsize = OBJ[left_components.intern->idb_type].ft_internal_size;
-		if (memcmp((void *)left_components.idb_ptr, (void *)right_components.idb_ptr, memsize) &&
-			memcmp((void *)ancestor_components.idb_ptr, (void *)right_components.idb_ptr, memsize)) {
+	if (lc->bin_params && ac->bin_params && rc->bin_params)
+	   if (lc->idb_ptr && ac->idb_ptr && rc->idb_ptr) {
+	    if ((lc->intern->idb_minor_type == ac->intern->idb_minor_type) &&
+		    (lc->intern->idb_minor_type == rc->intern->idb_minor_type)) {
+		int memsize = OBJ[lc->intern->idb_type].ft_internal_size;
+		if (memcmp((void *)lc->idb_ptr, (void *)rc->idb_ptr, memsize) &&
+			memcmp((void *)ac->idb_ptr, (void *)rc->idb_ptr, memsize)) {
 		    /* If we didn't pick up differences in the avs comparison, we need to use this result to flag a parameter difference */
 		    if (result->param_state == DIFF_UNCHANGED || result->param_state == DIFF_EMPTY) result->param_state |= DIFF_CHANGED;
 		} else {
@@ -853,14 +821,16 @@ db_diff3_dp(const struct db_i *left,
     }
 
     if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-	result->param_state |= db_avs_diff3(left_components.attrs, ancestor_components.attrs, right_components.attrs,
+	result->param_state |= db_avs_diff3(lc->attrs, ac->attrs, rc->attrs,
 		diff3_tol, diff3_dp_attr_add, diff3_dp_attr_del, diff3_dp_attr_chgd, diff3_dp_attr_conflict,
 		diff3_dp_attr_unchgd, (void *)(result->attr_diffs));
     }
 
-    free_diff_components(&left_components);
     free_diff_components(&ancestor_components);
-    free_diff_components(&right_components);
+    if (lc == &left_components)
+	free_diff_components(&left_components);
+    if (rc == &right_components)
+	free_diff_components(&right_components);
 
     state |= result->param_state;
     state |= result->attr_state;
@@ -874,140 +844,308 @@ db_diff3_dp(const struct db_i *left,
 }
 
 int
-db_diff3(const struct db_i *dbip_left,
-	const struct db_i *dbip_ancestor,
-	const struct db_i *dbip_right,
+db_diff3_dp(const struct db_i *left,
+	const struct db_i *ancestor,
+	const struct db_i *right,
+	const struct directory *left_dp,
+	const struct directory *ancestor_dp,
+	const struct directory *right_dp,
 	const struct bn_tol *diff3_tol,
 	db_compare_criteria_t flags,
-	struct bu_ptbl *results)
+	struct diff_result *ext_result)
 {
-    int state = DIFF_EMPTY;
-    struct directory *dp_ancestor=RT_DIR_NULL, *dp_left=RT_DIR_NULL, *dp_right=RT_DIR_NULL;
+    return diff3_dp(left, ancestor, right, left_dp, ancestor_dp, right_dp, diff3_tol, flags, ext_result, &rt_uniresource, 0);
+}
 
-    /* Step 1: look at all objects in the ancestor database */
-    FOR_ALL_DIRECTORY_START(dp_ancestor, dbip_ancestor) {
-	struct bu_external ext_left = BU_EXTERNAL_INIT_ZERO;
-	struct bu_external ext_ancestor = BU_EXTERNAL_INIT_ZERO;
-	struct bu_external ext_right = BU_EXTERNAL_INIT_ZERO;
-	struct diff_result *result = NULL;
-	int ancestor_state = DIFF_EMPTY;
-	int extern_state = DIFF_UNCHANGED;
-	BU_GET(result, struct diff_result);
-	diff_init_result(result, diff3_tol, dp_ancestor->d_namep);
+/* objects handed to a thread at a time, and the fewest worth threading */
+#define DIFF_CHUNK 16
+#define DIFF_PARALLEL_MIN 256
+
+/* the objects of a database diff, compared in parallel and gathered
+ * back in the order they were added */
+struct diff_job {
+    const struct db_i *left;
+    const struct db_i *ancestor;	/* NULL for a two way diff */
+    const struct db_i *right;
+    const struct bn_tol *tol;
+    db_compare_criteria_t flags;
+    int fast;			/* skip importing identical externals */
+    size_t n;
+    size_t max;
+    const struct directory **dps;	/* left, ancestor and right of each */
+    struct diff_result **results;
+    int *states;
+    size_t next;		/* next chunk to hand out */
+};
 
-	dp_left = db_lookup(dbip_left, dp_ancestor->d_namep, 0);
-	dp_right = db_lookup(dbip_right, dp_ancestor->d_namep, 0);
 
-	/* If we're checking everything, we want a sanity check to make sure we spot it when the objects differ */
-	if (flags == DB_COMPARE_ALL &&
-		dp_left != RT_DIR_NULL && dp_left->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY &&
-		dp_ancestor != RT_DIR_NULL && dp_ancestor->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY &&
-		dp_right != RT_DIR_NULL && dp_right->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY) {
-	    if (db_get_external(&ext_left, dp_left, dbip_left) || db_get_external(&ext_ancestor, dp_ancestor, dbip_ancestor) || db_get_external(&ext_right, dp_right, dbip_right)) {
-		bu_log("WARNING: unexpected failure reading serialized data for %s and %s\n", dp_left->d_namep, dp_ancestor->d_namep);
-	    } else {
-		if (db_diff_external(&ext_left, &ext_right) || db_diff_external(&ext_left, &ext_ancestor)) {extern_state = DIFF_CHANGED;}
-	    }
-	    bu_free_external(&ext_left);
-	    bu_free_external(&ext_ancestor);
-	    bu_free_external(&ext_right);
-	}
+static void
+diff_job_init(struct diff_job *job, const struct db_i *left, const struct db_i *ancestor, const struct db_i *right, const struct bn_tol *tol, db_compare_criteria_t flags, int full)
+{
+    job->left = left;
+    job->ancestor = ancestor;
+    job->right = right;
+    job->tol = tol;
+    job->flags = flags;
+
+    /* the same bytes only import the same way from the same version */
+    job->fast = !full;
+    if (db_version(left) != db_version(right))
+	job->fast = 0;
+    if (ancestor && db_version(ancestor) != db_version(left))
+	job->fast = 0;
+
+    job->n = 0;
+    job->max = 0;
+    job->dps = NULL;
+    job->results = NULL;
+    job->states = NULL;
+    job->next = 0;
+}
 
-	/* Do internal diffs */
-	if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
-	    ancestor_state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, dp_ancestor, dp_right, diff3_tol, DB_COMPARE_PARAM, result);
-	}
-	if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-	    ancestor_state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, dp_ancestor, dp_right, diff3_tol, DB_COMPARE_ATTRS, result);
-	}
-	if (flags == DB_COMPARE_ALL && (ancestor_state == DIFF_UNCHANGED || ancestor_state == DIFF_EMPTY) && extern_state == DIFF_CHANGED) {
-	    //bu_log("WARNING: internal and bu_external comparison disagree\n");
-	}
 
-	if (results) {
-	    bu_ptbl_ins(results, (long *)result);
-	} else {
-	    diff_free_result(result);
-	    BU_PUT(result, struct diff_result);
+static void
+diff_job_add(struct diff_job *job, const struct directory *left_dp, const struct directory *ancestor_dp, const struct directory *right_dp)
+{
+    if (job->n == job->max) {
+	job->max = (job->max) ? job->max * 2 : 256;
+	job->dps = (const struct directory **)bu_realloc((void *)job->dps, job->max * 3 * sizeof(struct directory *), "diff job objects");
+    }
+    job->dps[3*job->n] = left_dp;
+    job->dps[3*job->n+1] = ancestor_dp;
+    job->dps[3*job->n+2] = right_dp;
+    job->n++;
+}
+
+
+/* whether two objects serialize to the same bytes, and so import to
+ * the same parameters and attributes */
+static int
+diff_same_external(const struct bu_external *ext1, const struct bu_external *ext2)
+{
+    if (!ext1->ext_buf || !ext2->ext_buf)
+	return 0;
+    return !db_diff_external(ext1, ext2);
+}
+
+
+static int
+diff_job_object(const struct diff_job *job, size_t i, struct diff_result *result, struct resource *resp)
+{
+    const struct directory **dp = &job->dps[3*i];
+    const struct db_i *dbips[3];
+    struct bu_external ext[3];
+    int k, same = 0;
+
+    dbips[0] = job->left;
+    dbips[1] = job->ancestor;
+    dbips[2] = job->right;
+
+    /* read each object's raw external once, and let the comparison
+     * skip importing the ones that match byte for byte */
+    for (k = 0; k < 3; k++) {
+	BU_EXTERNAL_INIT(&ext[k]);
+	if (job->fast && dp[k] && db_get_external(&ext[k], dp[k], dbips[k]) < 0)
+	    bu_free_external(&ext[k]);
+    }
+    if (!job->ancestor) {
+	same = diff_same_external(&ext[0], &ext[2]);
+    } else {
+	if (diff_same_external(&ext[0], &ext[1]))
+	    same |= DIFF3_SAME_LEFT;
+	if (diff_same_external(&ext[2], &ext[1]))
+	    same |= DIFF3_SAME_RIGHT;
+	if (diff_same_external(&ext[0], &ext[2]))
+	    same |= DIFF3_SAME_LR;
+    }
+    for (k = 0; k < 3; k++)
+	bu_free_external(&ext[k]);
+
+    if (!job->ancestor)
+	return diff_dp(job->left, job->right, dp[0], dp[2], job->tol, job->flags, result, resp, same);
+    return diff3_dp(job->left, job->ancestor, job->right, dp[0], dp[1], dp[2], job->tol, job->flags, result, resp, same);
+}
+
+
+static void
+diff_job_worker(int cpu, void *data)
+{
+    struct diff_job *job = (struct diff_job *)data;
+    struct resource *resp;
+
+    BU_GET(resp, struct resource);
+    rt_init_resource(resp, cpu, NULL);
+
+    while (1) {
+	size_t i, s, e;
+
+	bu_semaphore_acquire(BU_SEM_GENERAL);
+	s = job->next;
+	job->next += DIFF_CHUNK;
+	bu_semaphore_release(BU_SEM_GENERAL);
+	if (s >= job->n)
+	    break;
+	e = (s + DIFF_CHUNK < job->n) ? s + DIFF_CHUNK : job->n;
+
+	for (i = s; i < e; i++) {
+	    const struct directory **dp = &job->dps[3*i];
+	    const struct directory *named = (dp[1]) ? dp[1] : ((dp[0]) ? dp[0] : dp[2]);
+
+	    BU_GET(job->results[i], struct diff_result);
+	    diff_init_result(job->results[i], job->tol, named->d_namep);
+	    job->states[i] = diff_job_object(job, i, job->results[i], resp);
 	}
-	state |= ancestor_state;
+    }
 
-    } FOR_ALL_DIRECTORY_END;
+    rt_clean_resource_basic(NULL, resp);
+    BU_PUT(resp, struct resource);
+}
 
-    FOR_ALL_DIRECTORY_START(dp_left, dbip_left) {
-	dp_ancestor = db_lookup(dbip_ancestor, dp_left->d_namep, 0);
-	if (dp_ancestor == RT_DIR_NULL) {
-	    struct bu_external ext_left, ext_right;
-	    int left_state = DIFF_EMPTY;
-	    int extern_state = DIFF_UNCHANGED;
-	    struct diff_result *result;
-	    BU_GET(result, struct diff_result);
-	    diff_init_result(result, diff3_tol, dp_left->d_namep);
 
-	    dp_right = db_lookup(dbip_right, dp_left->d_namep, 0);
+/* compare every object of the job, then hand the results over in the
+ * order the objects were added so the output does not depend on the
+ * threading */
+static int
+diff_job_run(struct diff_job *job, struct bu_ptbl *results)
+{
+    int state = DIFF_EMPTY;
+    size_t i;
 
-	    /* If we're checking everything, we want a sanity check to make sure we spot it when the objects differ */
-	    if (flags == DB_COMPARE_ALL &&
-		    dp_left != RT_DIR_NULL && dp_left->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY &&
-		    dp_right != RT_DIR_NULL && dp_right->d_major_type != DB5_MAJORTYPE_ATTRIBUTE_ONLY) {
-		if (db_get_external(&ext_left, dp_left, dbip_left) || db_get_external(&ext_right, dp_right, dbip_right)) {
-		    bu_log("WARNING: Unexpected failure reading serialized data\n");
-		} else {
-		    if (db_diff_external(&ext_left, &ext_right)) {extern_state = DIFF_CHANGED;}
-		}
-		bu_free_external(&ext_left);
-		bu_free_external(&ext_right);
-	    }
+    if (job->n) {
+	job->results = (struct diff_result **)bu_calloc(job->n, sizeof(struct diff_result *), "diff job results");
+	job->states = (int *)bu_calloc(job->n, sizeof(int), "diff job states");
 
-	    /* Do internal diffs */
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
-		left_state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, NULL, dp_right, diff3_tol, DB_COMPARE_PARAM, result);
-	    }
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-		left_state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, NULL, dp_right, diff3_tol, DB_COMPARE_ATTRS, result);
-	    }
-	    if (flags == DB_COMPARE_ALL && (left_state == DIFF_UNCHANGED || left_state == DIFF_EMPTY) && extern_state == DIFF_CHANGED) {
-		//bu_log("WARNING: internal and bu_external comparison disagree");
-	    }
+	bu_parallel(diff_job_worker, (job->n < DIFF_PARALLEL_MIN) ? 1 : 0, job);
 
+	for (i = 0; i < job->n; i++) {
+	    state |= job->states[i];
 	    if (results) {
-		bu_ptbl_ins(results, (long *)result);
+		bu_ptbl_ins(results, (long *)job->results[i]);
 	    } else {
-		diff_free_result(result);
-		BU_PUT(result, struct diff_result);
+		diff_free_result(job->results[i]);
+		BU_PUT(job->results[i], struct diff_result);
 	    }
-
-	    state |= left_state;
 	}
 
+	bu_free(job->states, "diff job states");
+	bu_free(job->results, "diff job results");
+    }
+    if (job->dps)
+	bu_free((void *)job->dps, "diff job objects");
+
+    return state;
+}
+
+
+static int
+diff_dbs(const struct db_i *dbip1,
+	 const struct db_i *dbip2,
+	 const struct bn_tol *diff_tol,
+	 db_compare_criteria_t flags,
+	 struct bu_ptbl *results,
+	 int full)
+{
+    struct diff_job job;
+    struct directory *dp1=RT_DIR_NULL, *dp2=RT_DIR_NULL;
+
+    diff_job_init(&job, dbip1, NULL, dbip2, diff_tol, flags, full);
+
+    /* look at all objects in this database */
+    FOR_ALL_DIRECTORY_START(dp1, dbip1) {
+	/* determine the status of this object in the other database */
+	dp2 = db_lookup(dbip2, dp1->d_namep, 0);
+	diff_job_add(&job, dp1, RT_DIR_NULL, dp2);
     } FOR_ALL_DIRECTORY_END;
 
-    FOR_ALL_DIRECTORY_START(dp_right, dbip_right) {
-	dp_ancestor = db_lookup(dbip_ancestor, dp_right->d_namep, 0);
-	dp_left = db_lookup(dbip_left, dp_right->d_namep, 0);
-	if (dp_ancestor == RT_DIR_NULL && dp_left == RT_DIR_NULL) {
-	    struct diff_result *result;
-	    BU_GET(result, struct diff_result);
-	    diff_init_result(result, diff3_tol, dp_right->d_namep);
-
-	    /* Do internal diffs */
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_PARAM) {
-		state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, dp_ancestor, dp_right, diff3_tol, DB_COMPARE_PARAM, result);
-	    }
-	    if (flags == DB_COMPARE_ALL || flags & DB_COMPARE_ATTRS) {
-		state |= db_diff3_dp(dbip_left, dbip_ancestor, dbip_right, dp_left, dp_ancestor, dp_right, diff3_tol, DB_COMPARE_ATTRS, result);
-	    }
+    /* now look for objects in the other database that aren't here */
+    FOR_ALL_DIRECTORY_START(dp2, dbip2) {
+	/* By this point, any differences will be additions */
+	if (db_lookup(dbip1, dp2->d_namep, 0) == RT_DIR_NULL)
+	    diff_job_add(&job, RT_DIR_NULL, RT_DIR_NULL, dp2);
+    } FOR_ALL_DIRECTORY_END;
 
-	    if (results) {
-		bu_ptbl_ins(results, (long *)result);
-	    } else {
-		diff_free_result(result);
-		BU_PUT(result, struct diff_result);
-	    }
+    return diff_job_run(&job, results);
+}
+
+static int
+diff3_dbs(const struct db_i *dbip_left,
+	  const struct db_i *dbip_ancestor,
+	  const struct db_i *dbip_right,
+	  const struct bn_tol *diff3_tol,
+	  db_compare_criteria_t flags,
+	  struct bu_ptbl *results,
+	  int full)
+{
+    struct diff_job job;
+    struct directory *dp_ancestor=RT_DIR_NULL, *dp_left=RT_DIR_NULL, *dp_right=RT_DIR_NULL;
+
+    diff_job_init(&job, dbip_left, dbip_ancestor, dbip_right, diff3_tol, flags, full);
+
+    /* Step 1: look at all objects in the ancestor database */
+    FOR_ALL_DIRECTORY_START(dp_ancestor, dbip_ancestor) {
+	dp_left = db_lookup(dbip_left, dp_ancestor->d_namep, 0);
+	dp_right = db_lookup(dbip_right, dp_ancestor->d_namep, 0);
+	diff_job_add(&job, dp_left, dp_ancestor, dp_right);
+    } FOR_ALL_DIRECTORY_END;
+
+    /* Step 2: objects new in the left database, and perhaps the right */
+    FOR_ALL_DIRECTORY_START(dp_left, dbip_left) {
+	if (db_lookup(dbip_ancestor, dp_left->d_namep, 0) == RT_DIR_NULL) {
+	    dp_right = db_lookup(dbip_right, dp_left->d_namep, 0);
+	    diff_job_add(&job, dp_left, RT_DIR_NULL, dp_right);
 	}
     } FOR_ALL_DIRECTORY_END;
 
-    return state;
+    /* Step 3: objects new in the right database only */
+    FOR_ALL_DIRECTORY_START(dp_right, dbip_right) {
+	if (db_lookup(dbip_ancestor, dp_right->d_namep, 0) == RT_DIR_NULL &&
+		db_lookup(dbip_left, dp_right->d_namep, 0) == RT_DIR_NULL)
+	    diff_job_add(&job, RT_DIR_NULL, RT_DIR_NULL, dp_right);
+    } FOR_ALL_DIRECTORY_END;
+
+    return diff_job_run(&job, results);
+}
+
+int
+db_diff(const struct db_i *dbip1,
+	const struct db_i *dbip2,
+	const struct bn_tol *diff_tol,
+	db_compare_criteria_t flags,
+	struct bu_ptbl *results)
+{
+    return diff_dbs(dbip1, dbip2, diff_tol, flags, results, 0);
+}
+
+int
+db_diff_full(const struct db_i *dbip1,
+	     const struct db_i *dbip2,
+	     const struct bn_tol *diff_tol,
+	     db_compare_criteria_t flags,
+	     struct bu_ptbl *results)
+{
+    return diff_dbs(dbip1, dbip2, diff_tol, flags, results, 1);
+}
+
+int
+db_diff3(const struct db_i *dbip_left,
+	const struct db_i *dbip_ancestor,
+	const struct db_i *dbip_right,
+	const struct bn_tol *diff3_tol,
+	db_compare_criteria_t flags,
+	struct bu_ptbl *results)
+{
+    return diff3_dbs(dbip_left, dbip_ancestor, dbip_right, diff3_tol, flags, results, 0);
+}
+
+int
+db_diff3_full(const struct db_i *dbip_left,
+	      const struct db_i *dbip_ancestor,
+	      const struct db_i *dbip_right,
+	      const struct bn_tol *diff3_tol,
+	      db_compare_criteria_t flags,
+	      struct bu_ptbl *results)
+{
+    return diff3_dbs(dbip_left, dbip_ancestor, dbip_right, diff3_tol, flags, results, 1);
 }
 
 /*
@@ -293,9 +293,11 @@ db_diradd(struct db_i *dbip, const char *name, b_off_t laddr, size_t len, int fl
      */
     dp->d_flags = flags & ~(RT_DIR_INMEM);
     dp->d_len = len;
-    dp->d_forw = *headp;
     BU_LIST_INIT(&dp->d_use_hd);
+    db_mesh_lod_dir_lock(dbip);
+    dp->d_forw = *headp;
     *headp = dp;
+    db_mesh_lod_dir_unlock(dbip);
     dp->d_animate = NULL;
     dp->d_nref = 0;
     dp->d_uses = 0;
@@ -314,6 +316,8 @@ db_diradd(struct db_i *dbip, const char *name, b_off_t laddr, size_t len, int fl
 
     bu_vls_free(&local);
 
+    db_attr_index_changed(dbip, dp, 1);
+
     if (BU_PTBL_IS_INITIALIZED(&dbip->dbi_changed_clbks)) {
 	for (size_t i = 0; i < BU_PTBL_LEN(&dbip->dbi_changed_clbks); i++) {
 	    struct dbi_changed_clbk *cb = (struct dbi_changed_clbk *)BU_PTBL_GET(&dbip->dbi_changed_clbks, i);
@@ -336,6 +340,11 @@ db_dirdelete(struct db_i *dbip, struct directory *dp)
 
     headp = &(dbip->dbi_Head[db_dirhash(dp->d_namep)]);
 
+    db_attr_index_changed(dbip, dp, 2);
+
+    /* Background LoD generation may be reading this entry */
+    db_mesh_lod_dir_lock(dbip);
+
     if (dp->d_flags & RT_DIR_INMEM) {
 	if (dp->d_un.ptr != NULL)
 	    bu_free(dp->d_un.ptr, "db_dirdelete() inmem ptr");
@@ -359,6 +368,7 @@ db_dirdelete(struct db_i *dbip, struct directory *dp)
 	/* Put 'dp' back on the freelist */
 	dp->d_forw = rt_uniresource.re_directory_hd;
 	rt_uniresource.re_directory_hd = dp;
+	db_mesh_lod_dir_unlock(dbip);
 	return 0;
     }
     for (findp = *headp; findp != RT_DIR_NULL; findp = findp->d_forw) {
@@ -381,8 +391,10 @@ db_dirdelete(struct db_i *dbip, struct directory *dp)
 	/* Put 'dp' back on the freelist */
 	dp->d_forw = rt_uniresource.re_directory_hd;
 	rt_uniresource.re_directory_hd = dp;
+	db_mesh_lod_dir_unlock(dbip);
 	return 0;
     }
+    db_mesh_lod_dir_unlock(dbip);
     return -1;
 }
 
@@ -396,6 +408,9 @@ db_rename(struct db_i *dbip, struct directory *dp, const char *newname)
     RT_CK_DBI(dbip);
     RT_CK_DIR(dp);
 
+    /* Background LoD generation may be looking names up */
+    db_mesh_lod_dir_lock(dbip);
+
     /* Remove from linked list */
     headp = &(dbip->dbi_Head[db_dirhash(dp->d_namep)]);
     if (*headp == dp) {
@@ -409,6 +424,7 @@ db_rename(struct db_i *dbip, struct directory *dp, const char *newname)
 	    findp->d_forw = dp->d_forw;
 	    goto out;
 	}
+	db_mesh_lod_dir_unlock(dbip);
 	return -1;		/* ERROR: can't find */
     }
 
@@ -421,6 +437,7 @@ out:
     headp = &(dbip->dbi_Head[db_dirhash(newname)]);
     dp->d_forw = *headp;
     *headp = dp;
+    db_mesh_lod_dir_unlock(dbip);
     return 0;
 }
 
@@ -390,6 +390,12 @@ db_close(register struct db_i *dbip)
     }
     bu_semaphore_release(sem_uses);
 
+    /* Background LoD generation reads the directory - stop it first */
+    db_mesh_lod_workers_destroy(dbip->i);
+
+    /* Nothing is going to search the directory again */
+    db_attr_index_destroy(dbip->i);
+
     /* Free wdbp containers */
     if (dbip->dbi_wdbp) {
 	BU_LIST_DEQUEUE(&dbip->dbi_wdbp->l);
@@ -654,8 +660,9 @@ db_i_internal_destroy(struct db_i_internal *i)
     if (!i)
 	return;
 
-    if (i->mesh_c)
+    if (i->mesh_c && i->mesh_c_owned)
 	bv_mesh_lod_context_destroy(i->mesh_c);
+    db_attr_index_destroy(i);
 
     BU_PUT(i, struct db_i_internal);
 }
@@ -37,6 +37,7 @@
 #include "bv.h"
 #include "rt/db4.h"
 #include "raytrace.h"
+#include "rt/db_diff.h"
 
 /* approximation formula for the circumference of an ellipse */
 #define ELL_CIRCUMFERENCE(a, b) M_PI * ((a) + (b)) * \
@@ -73,9 +74,17 @@ struct db_i_internal {
 
     /* BoT level of detail cached data for drawing */
     struct bv_mesh_lod_context *mesh_c;
+    int mesh_c_owned;	/* set when mesh_c was created by librt */
     int mesh_c_completed;
     int mesh_c_target;
 
+    /* background LoD generation workers (cache_lod.cpp) */
+    struct db_mesh_lod_queue *mesh_q;
+
+    /* attribute name to value to object index (db_attr_index.cpp) */
+    struct db_attr_index *attr_index;
+    unsigned long attr_index_gen;	/* bumped on every change noted to the index */
+
     // TODO - really need to get the rt prep cache container
     // in here and add a pointer slot to it for rt_db_internal
     // so the librt point generation routines can take advantage
@@ -85,6 +94,34 @@ struct db_i_internal {
 struct db_i_internal * db_i_internal_create(void);
 void db_i_internal_destroy(struct db_i_internal *i);
 
+/* Stops and frees any background LoD generation workers */
+void db_mesh_lod_workers_destroy(struct db_i_internal *i);
+
+/* Held by background LoD workers while they look up and load an
+ * object, and by librt around anything that adds, frees, renames or
+ * moves a directory entry or rewrites its storage - db5_diradd(),
+ * db_diradd(), db_dirdelete(), db_rename(), db_delete(), db5_realloc()
+ * and the db_put_external5()/rt_db_put_internal5() writes.  The lock is
+ * recursive, so these may nest.  No-ops when no workers exist. */
+void db_mesh_lod_dir_lock(struct db_i *dbip);
+void db_mesh_lod_dir_unlock(struct db_i *dbip);
+
+/* db_attr_index.cpp */
+
+/* Note that dp was added (mode 1), modified (0) or is about to be
+ * deleted (2), as with the dbi_changed_clbks.  A no-op until the
+ * index has been built. */
+void db_attr_index_changed(struct db_i *dbip, struct directory *dp, int mode);
+
+/* Frees the attribute index, if any */
+void db_attr_index_destroy(struct db_i_internal *i);
+
+/* Adds to objs every object with an attribute called name whose value
+ * match accepts (every one if match is NULL), building or refreshing
+ * the index first.  Returns how many were added, or -1 if there is no
+ * index for dbip. */
+int db_attr_index_find(struct bu_ptbl *objs, struct db_i *dbip, const char *name, int (*match)(const char *value, void *data), void *data);
+
 
 /* Used by sketch extrude revolve */
 extern int curve_to_vlist(struct bu_list              *vlfree,
@@ -166,6 +203,12 @@ extern int cyclic_path(const struct db_full_path *fp, const char *test_name, lon
  */
 extern int tcl_list_to_avs(const char *tcl_list, struct bu_attribute_value_set *avs, int offset);
 
+/* db_diff() and db_diff3() importing and comparing every object, not
+ * skipping the ones whose stored bytes are identical.  The reference
+ * the shortcut is checked against (rt_diff_bench). */
+extern RT_EXPORT int db_diff_full(const struct db_i *dbip1, const struct db_i *dbip2, const struct bn_tol *diff_tol, db_compare_criteria_t flags, struct bu_ptbl *results);
+extern RT_EXPORT int db_diff3_full(const struct db_i *dbip_left, const struct db_i *dbip_ancestor, const struct db_i *dbip_right, const struct bn_tol *diff3_tol, db_compare_criteria_t flags, struct bu_ptbl *results);
+
 /* db_io.c */
 
 struct dbi_changed_clbk {
@@ -205,6 +248,27 @@ extern int db_read(const struct db_i *dbip, void *addr, size_t count, b_off_t of
  */
 extern RT_EXPORT long db5_size(struct db_i *dbip, struct directory *dp, int flags);
 
+/* primitives/dsp/dsp.c */
+
+/* rt_dsp_prep() bounding the terrain with the recursive dsp_bb tree
+ * rather than the min/max pyramid.  Kept as the reference the pyramid
+ * traversal is checked against (rt_dsp_bench). */
+extern RT_EXPORT int rt_dsp_prep_recursive(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip);
+
+/* primitives/vol/vol.c, primitives/ebm/ebm.c */
+
+/* rt_vol_prep() and rt_ebm_prep() without the sparse brick and tile
+ * packing, marching every voxel or pixel.  The references the sparse
+ * traversals are checked against (rt_vol_bench). */
+extern RT_EXPORT int rt_vol_prep_dense(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip);
+extern RT_EXPORT int rt_ebm_prep_dense(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip);
+
+/* primitives/metaball/metaball.c */
+
+/* rt_metaball_prep() without the point hierarchy, so every march step
+ * sums the whole field.  The reference for rt_metaball_bench. */
+extern RT_EXPORT int rt_metaball_prep_brute(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip);
+
 /* FIXME: should have gone away with v6.  needed now to pass the minor_type down during read */
 extern int rt_binunif_import5_minor_type(struct rt_db_internal *, const struct bu_external *, const mat_t, const struct db_i *, struct resource *, int);
 
@@ -260,6 +324,13 @@ extern void plot_ellipse(
 extern int _rt_tcl_list_to_int_array(const char *list, int **array, int *array_len);
 extern int _rt_tcl_list_to_fastf_array(const char *list, fastf_t **array, int *array_len);
 
+/* search.cpp */
+
+/* db_search() listing and evaluating every path in the calling thread,
+ * one at a time.  The reference the parallel search is checked against
+ * (rt_search_bench). */
+extern RT_EXPORT int db_search_serial(struct bu_ptbl *results, int flags, const char *filter, int path_c, struct directory **path_v, struct db_i *dbip, bu_clbk_t clbk, void *u1, void *u2);
+
 /* view.c */
 extern fastf_t solid_point_spacing(const struct bview *gvp, fastf_t solid_width);
 extern fastf_t view_avg_sample_spacing(const struct bview *gvp);
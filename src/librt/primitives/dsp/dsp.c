@@ -65,6 +65,7 @@
 
 /* private header */
 #include "./dsp.h"
+#include "../../librt_private.h"
 
 
 #define FULL_DSP_DEBUGGING 1
@@ -149,6 +150,41 @@ extern int rt_retrieve_binunif(struct rt_db_internal *intern,
 #define ZTOP 7
 
 
+/**
+ * One level of the flattened min/max pyramid.  Element (x, y) of level
+ * l covers DIM_BB_CHILDREN^l cells on a side, and its min and max
+ * elevations are mm[2*(y*dim[X]+x)] and mm[2*(y*dim[X]+x)+1].  Level
+ * 0 is the cells themselves, which are read straight from the
+ * elevations and not stored.
+ */
+struct dsp_mip {
+    unsigned int dim[2];
+    unsigned int size;		/* cells on a side of an element */
+    unsigned short *mm;
+};
+
+
+/**
+ * The planes of the two triangles on top of a cell, in the corner
+ * order permute_cell() produces, so that the ray only has to be
+ * intersected with them.
+ */
+struct dsp_cell_top {
+    plane_t pl[2];
+    int perm;
+};
+#define DSP_PERM_NONE 0	/* A B C D */
+#define DSP_PERM_ULlr 1	/* B A D C */
+#define DSP_PERM_BC 2	/* B D A C */
+
+/* cell tops are computed on first use a tile at a time, the tiles
+ * being the cells under one element of pyramid level 1
+ */
+#define DSP_TOP_TILE DIM_BB_CHILDREN
+/* beyond this many bytes of tiles, cell tops are no longer cached */
+#define DSP_TOPS_BUDGET (256*1024*1024)
+
+
 /**
  * per-solid ray tracing form of solid, including precomputed terms
  *
@@ -161,8 +197,13 @@ struct dsp_specific {
     int xsiz;
     int ysiz;
     int layers;
-    struct dsp_bb_layer *layer;
+    struct dsp_bb_layer *layer;	/* only from rt_dsp_prep_recursive() */
     struct dsp_bb *bb_array;
+    struct dsp_mip *mip;	/* layers levels, mip[0] unused */
+    unsigned short *mip_buf;
+    struct dsp_cell_top **tops;	/* tile table, entries NULL until used */
+    unsigned int tops_dim[2];
+    size_t tops_bytes;
 };
 
 
@@ -191,6 +232,10 @@ struct isect_stuff {
 
     int num_segs;
     int dmin, dmax;	/* for dsp_in_rpp, {X, Y, Z}MIN/MAX */
+
+    /* the cell top tile this ray last used, see dsp_cell_top_get() */
+    const struct dsp_cell_top *tile;
+    size_t tile_ind;
 };
 
 
@@ -830,6 +875,130 @@ dsp_layers(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_ma
 #endif
 }
 
+
+/**
+ * Build the flattened min/max pyramid used by rt_dsp_shot() in place
+ * of the dsp_bb tree: the same boxes as dsp_layers() computes, stored
+ * as min/max pairs in one contiguous buffer with the positions
+ * implied by the array indices.  Also sets up the empty tile table
+ * for the cell top planes.
+ */
+static void
+dsp_mip_build(struct dsp_specific *dsp, unsigned short *d_min, unsigned short *d_max)
+{
+    unsigned int x, y, i, j, l;
+    size_t tot = 0;
+    unsigned short dsp_min = 0xffff;
+    unsigned short dsp_max = 0;
+    unsigned short *mm;
+    unsigned int xs = dsp->xsiz;
+    unsigned int ys = dsp->ysiz;
+
+    /* same level structure as dsp_layers() */
+    dsp->layers = 1;
+    while (xs > 1 || ys > 1) {
+	xs = (xs + DIM_BB_CHILDREN - 1) / DIM_BB_CHILDREN;
+	ys = (ys + DIM_BB_CHILDREN - 1) / DIM_BB_CHILDREN;
+	if (!xs) xs = 1;
+	if (!ys) ys = 1;
+	tot += 2 * (size_t)xs * ys;
+	dsp->layers++;
+    }
+
+    dsp->mip = (struct dsp_mip *)bu_calloc(dsp->layers, sizeof(struct dsp_mip), "dsp_mip levels");
+    dsp->mip_buf = (tot) ? (unsigned short *)bu_malloc(tot * sizeof(unsigned short), "dsp_mip buf") : NULL;
+    dsp->mip[0].dim[X] = dsp->xsiz;
+    dsp->mip[0].dim[Y] = dsp->ysiz;
+    dsp->mip[0].size = 1;
+
+    mm = dsp->mip_buf;
+    for (l = 1; l < (unsigned int)dsp->layers; l++) {
+	struct dsp_mip *curr = &dsp->mip[l];
+	struct dsp_mip *prev = &dsp->mip[l-1];
+	curr->dim[X] = (prev->dim[X] + DIM_BB_CHILDREN - 1) / DIM_BB_CHILDREN;
+	curr->dim[Y] = (prev->dim[Y] + DIM_BB_CHILDREN - 1) / DIM_BB_CHILDREN;
+	if (!curr->dim[X]) curr->dim[X] = 1;
+	if (!curr->dim[Y]) curr->dim[Y] = 1;
+	curr->size = prev->size * DIM_BB_CHILDREN;
+	curr->mm = mm;
+	mm += 2 * (size_t)curr->dim[X] * curr->dim[Y];
+
+	for (y = 0; y < curr->dim[Y]; y++) {
+	    for (x = 0; x < curr->dim[X]; x++) {
+		unsigned short *e = &curr->mm[2*(y*curr->dim[X] + x)];
+		e[0] = 0xffff;
+		e[1] = 0;
+		if (l == 1) {
+		    /* from the elevations at the corners of the cells */
+		    unsigned int xlim = (x+1) * DIM_BB_CHILDREN;
+		    unsigned int ylim = (y+1) * DIM_BB_CHILDREN;
+		    V_MIN(xlim, (unsigned int)dsp->xsiz);
+		    V_MIN(ylim, (unsigned int)dsp->ysiz);
+		    for (j = y * DIM_BB_CHILDREN; j <= ylim; j++) {
+			for (i = x * DIM_BB_CHILDREN; i <= xlim; i++) {
+			    unsigned short elev = DSP(&dsp->dsp_i, i, j);
+			    V_MIN(e[0], elev);
+			    V_MAX(e[1], elev);
+			}
+		    }
+		} else {
+		    for (j = 0; j < DIM_BB_CHILDREN && y*DIM_BB_CHILDREN+j < prev->dim[Y]; j++) {
+			for (i = 0; i < DIM_BB_CHILDREN && x*DIM_BB_CHILDREN+i < prev->dim[X]; i++) {
+			    unsigned short *c = &prev->mm[2*((y*DIM_BB_CHILDREN+j)*prev->dim[X] + x*DIM_BB_CHILDREN+i)];
+			    V_MIN(e[0], c[0]);
+			    V_MAX(e[1], c[1]);
+			}
+		    }
+		}
+	    }
+	}
+    }
+
+    if (dsp->layers > 1) {
+	struct dsp_mip *top = &dsp->mip[dsp->layers-1];
+	dsp_min = top->mm[0];
+	dsp_max = top->mm[1];
+    } else {
+	for (j = 0; j <= (unsigned int)dsp->ysiz; j++) {
+	    for (i = 0; i <= (unsigned int)dsp->xsiz; i++) {
+		V_MIN(dsp_min, DSP(&dsp->dsp_i, i, j));
+		V_MAX(dsp_max, DSP(&dsp->dsp_i, i, j));
+	    }
+	}
+    }
+    *d_min = dsp_min;
+    *d_max = dsp_max;
+
+    dsp->tops_dim[X] = (dsp->xsiz + DSP_TOP_TILE - 1) / DSP_TOP_TILE;
+    dsp->tops_dim[Y] = (dsp->ysiz + DSP_TOP_TILE - 1) / DSP_TOP_TILE;
+    dsp->tops_bytes = 0;
+    dsp->tops = (struct dsp_cell_top **)bu_calloc((size_t)dsp->tops_dim[X] * dsp->tops_dim[Y] + 1,
+						  sizeof(struct dsp_cell_top *), "dsp cell top tiles");
+}
+
+
+static void
+dsp_mip_free(struct dsp_specific *dsp)
+{
+    size_t i;
+
+    if (dsp->tops) {
+	for (i = 0; i < (size_t)dsp->tops_dim[X] * dsp->tops_dim[Y]; i++) {
+	    if (dsp->tops[i])
+		bu_free(dsp->tops[i], "dsp cell top tile");
+	}
+	bu_free(dsp->tops, "dsp cell top tiles");
+	dsp->tops = NULL;
+    }
+    if (dsp->mip_buf)
+	bu_free(dsp->mip_buf, "dsp_mip buf");
+    if (dsp->mip)
+	bu_free(dsp->mip, "dsp_mip levels");
+    dsp->mip_buf = NULL;
+    dsp->mip = NULL;
+}
+
+
 /**
  * Calculate the bounding box for a dsp.
  */
@@ -886,8 +1055,9 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
     ds.ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
 
 
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(&ds, &dsp_min, &dsp_max);
+    /* only the overall min/max elevations are needed */
+    dsp_mip_build(&ds, &dsp_min, &dsp_max);
+    dsp_mip_free(&ds);
 
 
     /* record the distance to each of the bounding planes */
@@ -948,8 +1118,8 @@ rt_dsp_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
  * of the prep logic, the in-prep bbox calculations are left
  * in to avoid duplication rather than calling rt_dsp_bbox.
  */
-int
-rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static int
+dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip, int recurse)
 {
     struct rt_dsp_internal *dsp_ip;
     register struct dsp_specific *dsp;
@@ -995,6 +1165,7 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 
 
     BU_GET(dsp, struct dsp_specific);
+    memset(dsp, 0, sizeof(struct dsp_specific));
     stp->st_specific = (void *) dsp;
 
     /* this works ok, because the mapped file keeps track of the
@@ -1011,8 +1182,15 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     dsp->ysiz = dsp_ip->dsp_ycnt-1;	/* size is # cells or values-1 */
 
 
-    /* compute the multi-resolution bounding boxes */
-    dsp_layers(dsp, &dsp_min, &dsp_max);
+    /* compute the multi-resolution bounding boxes.  The dsp_bb tree
+     * walked recursively is kept for comparison, but it needs well over
+     * a hundred bytes per cell against two for the flattened pyramid.
+     */
+    if (recurse) {
+	dsp_layers(dsp, &dsp_min, &dsp_max);
+    } else {
+	dsp_mip_build(dsp, &dsp_min, &dsp_max);
+    }
 
 
     /* record the distance to each of the bounding planes */
@@ -1061,6 +1239,20 @@ rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 }
 
 
+int
+rt_dsp_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return dsp_prep(stp, ip, rtip, 0);
+}
+
+
+int
+rt_dsp_prep_recursive(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return dsp_prep(stp, ip, rtip, 1);
+}
+
+
 static void
 plot_seg(struct isect_stuff *isect,
 	 struct hit *in_hit,
@@ -1278,6 +1470,26 @@ add_seg(struct isect_stuff *isect,
 
 
 /**
+ * Compute the plane equation of the triangle A B C
+ */
+static void
+dsp_tri_plane(plane_t N, const point_t A, const point_t B, const point_t C)
+{
+    vect_t AB, AC;
+
+    VSUB2(AB, B, A);
+    VSUB2(AC, C, A);
+
+    VCROSS(N, AB, AC);
+    VUNITIZE(N);
+    N[H] = VDOT(N, A);
+}
+
+
+/**
+ * Intersect the ray with the triangle A B C, whose plane equation N
+ * is already known.
+ *
  * Side Effects:
  * dist and P may be set
  *
@@ -1291,12 +1503,12 @@ isect_ray_triangle(struct isect_stuff *isect,
 		   point_t A,
 		   point_t B,
 		   point_t C,
+		   const plane_t N,
 		   struct hit *hitp,
 		   fastf_t alphabbeta[])
 {
     point_t P;			/* plane intercept point */
     vect_t AB, AC, AP;
-    plane_t N;			/* Normal for plane of triangle */
     fastf_t NdotDir;
     fastf_t alpha, beta;	/* barycentric distances */
     fastf_t hitdist;		/* distance to ray/triangle intercept */
@@ -1323,11 +1535,6 @@ isect_ray_triangle(struct isect_stuff *isect,
     VSUB2(AB, B, A);
     VSUB2(AC, C, A);
 
-    /* Compute the plane equation of the triangle */
-    VCROSS(N, AB, AC);
-    VUNITIZE(N);
-    N[H] = VDOT(N, A);
-
 
     /* intersect ray with plane */
     NdotDir = VDOT(N, isect->r.r_dir);
@@ -1623,6 +1830,122 @@ permute_cell(point_t A,
 }
 
 
+/**
+ * Reorder the corners of a cell the way permute_cell() did when its
+ * top was computed.
+ */
+static void
+dsp_cell_permute(int perm, point_t A, point_t B, point_t C, point_t D)
+{
+    point_t tmp;
+
+    switch (perm) {
+	case DSP_PERM_ULlr:
+	    VMOVE(tmp, A);
+	    VMOVE(A, B);
+	    VMOVE(B, tmp);
+	    VMOVE(tmp, C);
+	    VMOVE(C, D);
+	    VMOVE(D, tmp);
+	    break;
+	case DSP_PERM_BC:
+	    VMOVE(tmp, A);
+	    VMOVE(A, B);
+	    VMOVE(B, D);
+	    VMOVE(D, C);
+	    VMOVE(C, tmp);
+	    break;
+	default:
+	    break;
+    }
+}
+
+
+static void
+dsp_cell_top_compute(struct dsp_specific *dsp, int x, int y, struct dsp_cell_top *top)
+{
+    point_t A, B, C, D;
+    struct dsp_rpp rpp;
+
+    VSET(A, x, y, DSP(&dsp->dsp_i, x, y));
+    VSET(B, x+1, y, DSP(&dsp->dsp_i, x+1, y));
+    VSET(D, x+1, y+1, DSP(&dsp->dsp_i, x+1, y+1));
+    VSET(C, x, y+1, DSP(&dsp->dsp_i, x, y+1));
+    VSET(rpp.dsp_min, x, y, 0);
+    VSET(rpp.dsp_max, x+1, y+1, 0);
+
+    top->perm = DSP_PERM_NONE;
+    if (permute_cell(A, B, C, D, dsp, &rpp) == DSP_CUT_DIR_ULlr)
+	top->perm = (dsp->dsp_i.dsp_cuttype == DSP_CUT_DIR_ULlr) ? DSP_PERM_ULlr : DSP_PERM_BC;
+
+    dsp_tri_plane(top->pl[0], B, D, A);
+    dsp_tri_plane(top->pl[1], C, A, D);
+}
+
+
+/**
+ * Return the top of cell (x, y).  Tops are computed and kept a tile
+ * at a time, the first time a ray reaches a tile.  Once the tiles
+ * exceed DSP_TOPS_BUDGET the top is computed into scratch instead.
+ *
+ * The tile table is only read under RT_SEM_MODEL, which orders the
+ * read after the writes that filled the tile in.  The ray remembers
+ * its last tile, so the lock is taken once per tile it crosses
+ * rather than once per cell.
+ */
+static const struct dsp_cell_top *
+dsp_cell_top_get(struct isect_stuff *isect, int x, int y, struct dsp_cell_top *scratch)
+{
+    struct dsp_specific *dsp = isect->dsp;
+    unsigned int tx = x / DSP_TOP_TILE;
+    unsigned int ty = y / DSP_TOP_TILE;
+    size_t ind = (size_t)ty * dsp->tops_dim[X] + tx;
+    struct dsp_cell_top **tp = &dsp->tops[ind];
+    struct dsp_cell_top *tile;
+    int full;
+
+    if (isect->tile && isect->tile_ind == ind)
+	return &isect->tile[(y % DSP_TOP_TILE) * DSP_TOP_TILE + (x % DSP_TOP_TILE)];
+
+    bu_semaphore_acquire(RT_SEM_MODEL);
+    tile = *tp;
+    full = (dsp->tops_bytes >= DSP_TOPS_BUDGET);
+    bu_semaphore_release(RT_SEM_MODEL);
+
+    if (!tile && !full) {
+	size_t bytes = DSP_TOP_TILE * DSP_TOP_TILE * sizeof(struct dsp_cell_top);
+	int i, j;
+
+	/* the tile is complete before it is published */
+	tile = (struct dsp_cell_top *)bu_malloc(bytes, "dsp cell top tile");
+	for (j = 0; j < DSP_TOP_TILE && (int)(ty * DSP_TOP_TILE) + j < dsp->ysiz; j++) {
+	    for (i = 0; i < DSP_TOP_TILE && (int)(tx * DSP_TOP_TILE) + i < dsp->xsiz; i++) {
+		dsp_cell_top_compute(dsp, tx * DSP_TOP_TILE + i, ty * DSP_TOP_TILE + j, &tile[j * DSP_TOP_TILE + i]);
+	    }
+	}
+
+	bu_semaphore_acquire(RT_SEM_MODEL);
+	if (*tp) {
+	    /* another thread got there first */
+	    bu_free(tile, "dsp cell top tile");
+	    tile = *tp;
+	} else {
+	    *tp = tile;
+	    dsp->tops_bytes += bytes;
+	}
+	bu_semaphore_release(RT_SEM_MODEL);
+    }
+
+    if (!tile) {
+	dsp_cell_top_compute(dsp, x, y, scratch);
+	return scratch;
+    }
+    isect->tile = tile;
+    isect->tile_ind = ind;
+    return &tile[(y % DSP_TOP_TILE) * DSP_TOP_TILE + (x % DSP_TOP_TILE)];
+}
+
+
 /**
  * determine if a point P is above/below the slope line on the
  * bounding box.  e.g.:
@@ -1744,6 +2067,7 @@ static int
 isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 {
     point_t A, B, C, D, P;
+    plane_t pl[2];		/* planes of the two top triangles */
     int x, y;
     vect2d_t ab_first = V2INIT_ZERO;
     vect2d_t ab_second = V2INIT_ZERO;
@@ -1855,9 +2179,19 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
     }
 
 
-    (void)permute_cell(A, B, C, D, isect->dsp, &dsp_bb->dspb_rpp);
+    if (isect->dsp->tops) {
+	struct dsp_cell_top scratch;
+	const struct dsp_cell_top *top = dsp_cell_top_get(isect, dsp_bb->dspb_rpp.dsp_min[X], dsp_bb->dspb_rpp.dsp_min[Y], &scratch);
+	dsp_cell_permute(top->perm, A, B, C, D);
+	HMOVE(pl[0], top->pl[0]);
+	HMOVE(pl[1], top->pl[1]);
+    } else {
+	(void)permute_cell(A, B, C, D, isect->dsp, &dsp_bb->dspb_rpp);
+	dsp_tri_plane(pl[0], B, D, A);
+	dsp_tri_plane(pl[1], C, A, D);
+    }
 
-    if ((cond=isect_ray_triangle(isect, B, D, A, &hits[1], ab_first)) > 0.0) {
+    if ((cond=isect_ray_triangle(isect, B, D, A, pl[0], &hits[1], ab_first)) > 0.0) {
 	/* hit triangle */
 
 	/* record cell */
@@ -1874,7 +2208,7 @@ isect_ray_cell_top(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 	dlog("  miss triangle 1 (alpha: %g beta:%g a+b: %g) cond:%d\n",
 	     ab_first[0], ab_first[1], ab_first[0] + ab_first[1], cond);
     }
-    if ((cond=isect_ray_triangle(isect, C, A, D, &hits[2], ab_second)) > 0.0) {
+    if ((cond=isect_ray_triangle(isect, C, A, D, pl[1], &hits[2], ab_second)) > 0.0) {
 	/* hit triangle */
 
 	/* record cell */
@@ -2515,6 +2849,226 @@ isect_ray_dsp_bb(struct isect_stuff *isect, struct dsp_bb *dsp_bb)
 }
 
 
+static int
+isect_ray_dsp_mip(struct isect_stuff *isect, int level, int x, int y);
+
+
+/**
+ * Step through the children of pyramid element (x, y) at the given
+ * level in the order the ray crosses them, as recurse_dsp_bb() does
+ * for a dsp_bb, with the children located by index arithmetic.
+ *
+ * Return
+ * 0 continue intersection calculations
+ * 1 Terminate intersection computation
+ */
+static int
+recurse_dsp_mip(struct isect_stuff *isect, int level, int x, int y,
+		point_t minpt, /* entry point of the element */
+		point_t bbmin) /* min point of the element (Z=0) */
+{
+    struct dsp_mip *ch = &isect->dsp->mip[level-1];
+    fastf_t tDX;		/* dist along ray to span 1 cell in X dir */
+    fastf_t tDY;		/* dist along ray to span 1 cell in Y dir */
+    fastf_t tX, tY;	/* dist from hit pt. to next cell boundary */
+    fastf_t curr_dist;
+    fastf_t out_dist;
+    int x0 = x * DIM_BB_CHILDREN;
+    int y0 = y * DIM_BB_CHILDREN;
+    int nx = DIM_BB_CHILDREN;
+    int ny = DIM_BB_CHILDREN;
+    int cs = ch->size;	/* cell X, Y dimension */
+    int cX, cY;		/* coordinates of current child */
+    int stepX, stepY;
+
+    /* the children may be cut short at the edges of the array */
+    V_MIN(nx, (int)ch->dim[X] - x0);
+    V_MIN(ny, (int)ch->dim[Y] - y0);
+
+    /* compute current cell */
+    cX = (minpt[X] - bbmin[X]) / cs;
+    cY = (minpt[Y] - bbmin[Y]) / cs;
+    if (cX >= nx) cX = nx - 1;
+    if (cY >= ny) cY = ny - 1;
+    if (cX < 0) cX = 0;
+    if (cY < 0) cY = 0;
+
+    tX = tY = curr_dist = isect->r.r_min;
+
+    if (isect->r.r_dir[X] < 0.0) {
+	stepX = -1;
+	tDX = -cs / isect->r.r_dir[X];
+	tX += ((bbmin[X] + (cX * cs)) - minpt[X]) / isect->r.r_dir[X];
+    } else {
+	stepX = 1;
+	tDX = cs / isect->r.r_dir[X];
+
+	if (isect->r.r_dir[X] > 0.0)
+	    tX += ((bbmin[X] + ((cX+1) * cs)) - minpt[X]) / isect->r.r_dir[X];
+	else
+	    tX = MAX_FASTF; /* infinite distance to next X boundary */
+    }
+
+    if (isect->r.r_dir[Y] < 0) {
+	stepY = -1;
+	tDY = -cs / isect->r.r_dir[Y];
+	tY += ((bbmin[Y] + (cY * cs)) - minpt[Y]) / isect->r.r_dir[Y];
+    } else {
+	stepY = 1;
+	tDY = cs / isect->r.r_dir[Y];
+
+	if (isect->r.r_dir[Y] > 0.0)
+	    tY += ((bbmin[Y] + ((cY+1) * cs)) - minpt[Y]) / isect->r.r_dir[Y];
+	else
+	    tY = MAX_FASTF;
+    }
+
+    /* factor in the tolerance to the out-distance */
+    out_dist = isect->r.r_max - isect->tol->dist;
+
+    do {
+	if (isect_ray_dsp_mip(isect, level-1, x0 + cX, y0 + cY))
+	    return 1;
+
+	/* figure out which cell is next */
+	if (tX < tY) {
+	    cX += stepX;
+	    curr_dist = tX;
+	    tX += tDX;
+	} else {
+	    cY += stepY;
+	    curr_dist = tY;
+	    tY += tDY;
+	}
+    } while (curr_dist < out_dist &&
+	     cX < nx && cX >= 0 &&
+	     cY < ny && cY >= 0);
+
+    return 0;
+}
+
+
+/**
+ * Intersect a ray with element (x, y) of the given level of the
+ * min/max pyramid.  This produces the same segments as
+ * isect_ray_dsp_bb() does for the matching dsp_bb.
+ *
+ * Return
+ * 0 continue intersection calculations
+ * 1 Terminate intersection computation
+ */
+static int
+isect_ray_dsp_mip(struct isect_stuff *isect, int level, int x, int y)
+{
+    struct dsp_specific *dsp = isect->dsp;
+    struct xray *r = &isect->r;
+    point_t bbmin, bbmax;
+    point_t minpt, maxpt;
+    unsigned short zmin, zmax;
+    int size = dsp->mip[level].size;
+    int xmax = (x + 1) * size;
+    int ymax = (y + 1) * size;
+
+    if (level) {
+	unsigned short *e = &dsp->mip[level].mm[2*(y * dsp->mip[level].dim[X] + x)];
+	zmin = e[0];
+	zmax = e[1];
+    } else {
+	unsigned short elev;
+	zmin = zmax = DSP(&dsp->dsp_i, x, y);
+	elev = DSP(&dsp->dsp_i, x+1, y);
+	V_MIN(zmin, elev);
+	V_MAX(zmax, elev);
+	elev = DSP(&dsp->dsp_i, x, y+1);
+	V_MIN(zmin, elev);
+	V_MAX(zmax, elev);
+	elev = DSP(&dsp->dsp_i, x+1, y+1);
+	V_MIN(zmin, elev);
+	V_MAX(zmax, elev);
+    }
+    V_MIN(xmax, dsp->xsiz);
+    V_MIN(ymax, dsp->ysiz);
+
+    if (RT_G_DEBUG & RT_DEBUG_HF)
+	bu_log("\nisect_ray_dsp_mip(level %d: %d, %d)\n", level, x, y);
+
+    /* check to see if we miss the RPP for this area entirely */
+    VSET(bbmin, x * size, y * size, 0.0);
+    VSET(bbmax, xmax, ymax, zmax);
+    if (!dsp_in_rpp(isect, bbmin, bbmax))
+	return 0;
+
+    VJOIN1(minpt, r->r_pt, r->r_min, r->r_dir);
+    VJOIN1(maxpt, r->r_pt, r->r_max, r->r_dir);
+
+    /* if both hits are UNDER the top of the "foundation" pillar, we
+     * can just add a segment for that range and return
+     */
+    if (minpt[Z] < zmin && maxpt[Z] < zmin) {
+	struct hit seg_in, seg_out;
+	VSETALL(seg_in.hit_vpriv, 0.0);
+	VSETALL(seg_out.hit_vpriv, 0.0);
+
+	seg_in.hit_magic = RT_HIT_MAGIC;
+	seg_in.hit_dist = r->r_min;
+	VMOVE(seg_in.hit_point, minpt);
+	VMOVE(seg_in.hit_normal, dsp_pl[isect->dmin]);
+	seg_in.hit_surfno = isect->dmin;
+
+	seg_out.hit_dist = r->r_max;
+	VMOVE(seg_out.hit_point, maxpt);
+	VMOVE(seg_out.hit_normal, dsp_pl[isect->dmax]);
+	seg_out.hit_surfno = isect->dmax;
+
+	return add_seg(isect, &seg_in, &seg_out, bbmin, bbmax, 0, 255, 255);
+    }
+
+    /* We might be going through the boundary, intersect the children */
+    if (level)
+	return recurse_dsp_mip(isect, level, x, y, minpt, bbmin);
+
+    /* the top of the cell.  isect_ray_cell_top() only looks at the
+     * extent of the dsp_bb it is given.
+     */
+    bbmin[Z] = zmin;
+    if (dsp_in_rpp(isect, bbmin, bbmax)) {
+	struct dsp_bb cell;
+	cell.magic = MAGIC_dsp_bb;
+	VSET(cell.dspb_rpp.dsp_min, x, y, zmin);
+	VSET(cell.dspb_rpp.dsp_max, x+1, y+1, zmax);
+	cell.dspb_subcell_size = 0;
+	cell.dspb_ch_dim[X] = cell.dspb_ch_dim[Y] = 0;
+	isect_ray_cell_top(isect, &cell);
+    }
+
+    /* the "foundation" pillar under the top */
+    bbmax[Z] = zmin;
+    bbmin[Z] = 0.0;
+    if (dsp_in_rpp(isect, bbmin, bbmax)) {
+	struct hit in_hit, out_hit;
+	VSETALL(in_hit.hit_vpriv, 0.0);
+	VSETALL(out_hit.hit_vpriv, 0.0);
+
+	VJOIN1(minpt, r->r_pt, r->r_min, r->r_dir);
+	VJOIN1(maxpt, r->r_pt, r->r_max, r->r_dir);
+
+	in_hit.hit_dist = r->r_min;
+	in_hit.hit_surfno = isect->dmin;
+	VMOVE(in_hit.hit_point, minpt);
+	VMOVE(in_hit.hit_normal, dsp_pl[isect->dmin]);
+
+	out_hit.hit_dist = r->r_max;
+	out_hit.hit_surfno = isect->dmax;
+	VMOVE(out_hit.hit_point, maxpt);
+	VMOVE(out_hit.hit_normal, dsp_pl[isect->dmax]);
+
+	return add_seg(isect, &in_hit, &out_hit, bbmin, bbmax, 255, 255, 0);
+    }
+
+    return 0;
+}
+
+
 /**
  * Intersect a ray with a dsp.
  * If an intersection occurs, a struct seg will be acquired
@@ -2563,6 +3117,8 @@ rt_dsp_shot(struct soltab *stp, register struct xray *rp, struct application *ap
     isect.dsp = (struct dsp_specific *)stp->st_specific;
     isect.tol = &ap->a_rt_i->rti_tol;
     isect.num_segs = 0;
+    isect.tile = NULL;
+    isect.tile_ind = 0;
 
     VINVDIR(isect.inv_dir, isect.r.r_dir);
     BU_LIST_INIT(&isect.seglist);
@@ -2583,19 +3139,25 @@ rt_dsp_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	       V3ARGS(isect.r.r_dir));
     }
 
-    /* We look at the topmost layer of the bounding-box tree and make
-     * sure that it has dimension 1.  Otherwise, something is wrong
-     */
-    if (isect.dsp->layer[isect.dsp->layers-1].dim[X] != 1 ||
-	isect.dsp->layer[isect.dsp->layers-1].dim[Y] != 1) {
-	bu_log("%s:%d how do i find the topmost layer?\n",
-	       __FILE__, __LINE__);
-	bu_bomb("");
-    }
-
+    if (isect.dsp->mip) {
+	/* intersect the ray with the min/max pyramid, from its single
+	 * top element down
+	 */
+	(void)isect_ray_dsp_mip(&isect, isect.dsp->layers-1, 0, 0);
+    } else {
+	/* We look at the topmost layer of the bounding-box tree and make
+	 * sure that it has dimension 1.  Otherwise, something is wrong
+	 */
+	if (isect.dsp->layer[isect.dsp->layers-1].dim[X] != 1 ||
+	    isect.dsp->layer[isect.dsp->layers-1].dim[Y] != 1) {
+	    bu_log("%s:%d how do i find the topmost layer?\n",
+		   __FILE__, __LINE__);
+	    bu_bomb("");
+	}
 
-    /* intersect the ray with the bounding rpps */
-    (void)isect_ray_dsp_bb(&isect, isect.dsp->layer[isect.dsp->layers-1].p);
+	/* intersect the ray with the bounding rpps */
+	(void)isect_ray_dsp_bb(&isect, isect.dsp->layer[isect.dsp->layers-1].p);
+    }
 
     /* if we missed it all, give up now */
     if (BU_LIST_IS_EMPTY(&isect.seglist))
@@ -3088,6 +3650,12 @@ rt_dsp_free(register struct soltab *stp)
 	    break;
     }
 
+    dsp_mip_free(dsp);
+    if (dsp->layer)
+	bu_free(dsp->layer, "dsp_bb_layers array");
+    if (dsp->bb_array)
+	bu_free(dsp->bb_array, "dsp_bb array");
+
     BU_PUT(dsp, struct dsp_specific);
 }
 
@@ -55,6 +55,9 @@ struct rt_ebm_specific {
     vect_t ebm_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t ebm_large;	/* local coords of XYZ max */
     mat_t ebm_mat;	/* model to ideal space */
+    uint32_t *ebm_tiles;	/* per tile: EMPTY, FULL or index into ebm_bits */
+    uint64_t *ebm_bits;	/* one word per mixed tile */
+    size_t ebm_tdim[2];	/* tiles along XY */
 };
 
 
@@ -321,6 +324,204 @@ rt_seg_planeclip(struct seg *out_hd, struct seg *in_hd, vect_t out_norm, fastf_t
 
 static int rt_ebm_normtab[3] = { NORM_XPOS, NORM_YPOS, NORM_ZPOS };
 
+/*
+ * Sparse tile storage.  At prep time the bitmap is split into
+ * EBM_TILE x EBM_TILE tiles.  Tiles that are entirely clear or entirely
+ * set are only flagged, and rt_ebm_dda() crosses them in a single step.
+ * Other tiles keep their pixels as the bits of one 64-bit word, so the
+ * march reads a compact copy instead of the padded byte-per-pixel
+ * bitmap.  rt_ebm_prep_dense() marches every pixel of the bitmap.
+ */
+#define EBM_TILE_SHIFT 3
+#define EBM_TILE (1<<EBM_TILE_SHIFT)
+#define EBM_TILE_EMPTY UINT32_MAX
+#define EBM_TILE_FULL (UINT32_MAX-1)
+#define EBM_TILE_OUTSIDE (UINT32_MAX-2)
+
+
+/* the tile holding a pixel, EBM_TILE_OUTSIDE if off the bitmap */
+static inline uint32_t
+ebm_tile_at(const struct rt_ebm_specific *ebmp, const size_t *igrid)
+{
+    if (igrid[X] >= ebmp->ebm_i.xdim || igrid[Y] >= ebmp->ebm_i.ydim)
+	return EBM_TILE_OUTSIDE;
+
+    return ebmp->ebm_tiles[(igrid[Y] >> EBM_TILE_SHIFT) * ebmp->ebm_tdim[X] + (igrid[X] >> EBM_TILE_SHIFT)];
+}
+
+
+/* whether a pixel of a mixed tile is set */
+static inline int
+ebm_tile_bit(const struct rt_ebm_specific *ebmp, uint32_t tile, const size_t *igrid)
+{
+    int b = ((igrid[Y] & (EBM_TILE-1)) << EBM_TILE_SHIFT) | (igrid[X] & (EBM_TILE-1));
+
+    return (ebmp->ebm_bits[tile] >> b) & 1;
+}
+
+
+/**
+ * Classify every tile of the bitmap and pack the mixed ones.  Returns
+ * the number of bytes used.
+ */
+static size_t
+ebm_tiles_build(struct rt_ebm_specific *ebmp)
+{
+    struct rt_ebm_internal *eip = &ebmp->ebm_i;
+    size_t ntiles, nmixed = 0, maxmixed = 64;
+    size_t tx, ty;
+    uint32_t *tile;
+
+    ebmp->ebm_tdim[X] = (eip->xdim + EBM_TILE - 1) >> EBM_TILE_SHIFT;
+    ebmp->ebm_tdim[Y] = (eip->ydim + EBM_TILE - 1) >> EBM_TILE_SHIFT;
+    ntiles = ebmp->ebm_tdim[X] * ebmp->ebm_tdim[Y];
+
+    ebmp->ebm_tiles = (uint32_t *)bu_malloc(ntiles * sizeof(uint32_t), "ebm tiles");
+    ebmp->ebm_bits = (uint64_t *)bu_malloc(maxmixed * sizeof(uint64_t), "ebm tile bits");
+
+    tile = ebmp->ebm_tiles;
+    for (ty = 0; ty < ebmp->ebm_tdim[Y]; ty++) {
+	for (tx = 0; tx < ebmp->ebm_tdim[X]; tx++) {
+	    size_t x, y;
+	    size_t x0 = tx << EBM_TILE_SHIFT;
+	    size_t y0 = ty << EBM_TILE_SHIFT;
+	    size_t x1 = FMIN(x0 + EBM_TILE, eip->xdim);
+	    size_t y1 = FMIN(y0 + EBM_TILE, eip->ydim);
+	    size_t in = 0;
+	    uint64_t bits = 0;
+
+	    /* pixels past the end of the bitmap stay clear, they are
+	     * never visited inside the bitmap's bounds */
+	    for (y = y0; y < y1; y++) {
+		for (x = x0; x < x1; x++) {
+		    if (*bit(eip, x, y) > 0) {
+			bits |= (uint64_t)1 << (((y - y0) << EBM_TILE_SHIFT) | (x - x0));
+			in++;
+		    }
+		}
+	    }
+
+	    if (!in) {
+		*tile++ = EBM_TILE_EMPTY;
+	    } else if (in == (x1 - x0) * (y1 - y0)) {
+		*tile++ = EBM_TILE_FULL;
+	    } else {
+		if (nmixed == maxmixed) {
+		    maxmixed *= 2;
+		    ebmp->ebm_bits = (uint64_t *)bu_realloc(ebmp->ebm_bits, maxmixed * sizeof(uint64_t), "ebm tile bits");
+		}
+		ebmp->ebm_bits[nmixed] = bits;
+		*tile++ = (uint32_t)nmixed++;
+	    }
+	}
+    }
+
+    if (nmixed)
+	ebmp->ebm_bits = (uint64_t *)bu_realloc(ebmp->ebm_bits, nmixed * sizeof(uint64_t), "ebm tile bits");
+    else {
+	bu_free(ebmp->ebm_bits, "ebm tile bits");
+	ebmp->ebm_bits = NULL;
+    }
+
+    return ntiles * sizeof(uint32_t) + nmixed * sizeof(uint64_t);
+}
+
+
+/**
+ * Find where the ray leaves the run of tiles, starting with the one
+ * holding igrid, that all share the uniform state tile, and on which
+ * axis.  last[] gets a pixel in the final tile of the run, and texit[]
+ * the grid line index of that tile's exit on each axis.
+ */
+static double
+ebm_tile_exit(const struct rt_ebm_specific *ebmp, const struct xray *rp, const vect_t invdir, uint32_t tile, const size_t *igrid, int *out_index, size_t *last, size_t *texit)
+{
+    const size_t dim[2] = {ebmp->ebm_i.xdim, ebmp->ebm_i.ydim};
+    double tt[2];
+    int i;
+
+    last[X] = igrid[X];
+    last[Y] = igrid[Y];
+    for (i = X; i <= Y; i++) {
+	size_t lo = igrid[i] & ~(size_t)(EBM_TILE-1);
+
+	if (ZERO(rp->r_dir[i])) {
+	    tt[i] = INFINITY;
+	    continue;
+	}
+	if (rp->r_dir[i] > 0)
+	    texit[i] = FMIN(lo + EBM_TILE, dim[i]);
+	else
+	    texit[i] = lo;
+	tt[i] = (ebmp->ebm_origin[i] + texit[i]*ebmp->ebm_cellsize[i] - rp->r_pt[i]) * invdir[i];
+    }
+
+    while (1) {
+	size_t next[2];
+
+	i = (tt[X] < tt[Y]) ? X : Y;
+
+	/* continue into the neighbor if it is in the same state */
+	next[X] = last[X];
+	next[Y] = last[Y];
+	next[i] = (rp->r_dir[i] > 0) ? texit[i] : texit[i] - 1;
+	if (ebm_tile_at(ebmp, next) != tile)
+	    break;
+
+	last[i] = next[i];
+	if (rp->r_dir[i] > 0)
+	    texit[i] = FMIN(texit[i] + EBM_TILE, dim[i]);
+	else
+	    texit[i] -= EBM_TILE;
+	tt[i] = (ebmp->ebm_origin[i] + texit[i]*ebmp->ebm_cellsize[i] - rp->r_pt[i]) * invdir[i];
+    }
+
+    *out_index = i;
+    return tt[i];
+}
+
+
+/**
+ * Restart the pixel march at t1, where the ray leaves the uniform tile
+ * holding last[] across out_index.  Along the other axis it is still
+ * within that tile.
+ */
+static void
+ebm_tile_step(const struct rt_ebm_specific *ebmp, const struct xray *rp, const vect_t invdir, const vect_t delta, double t1, int out_index, const size_t *last, const size_t *texit, size_t *igrid, vect_t t)
+{
+    const size_t dim[2] = {ebmp->ebm_i.xdim, ebmp->ebm_i.ydim};
+    int i;
+
+    for (i = X; i <= Y; i++) {
+	long j, lo, hi;
+
+	if (ZERO(rp->r_dir[i]))
+	    continue;
+
+	if (i == out_index) {
+	    igrid[i] = (rp->r_dir[i] > 0) ? texit[i] : texit[i] - 1;
+	    j = (rp->r_dir[i] > 0) ? (long)igrid[i] + 1 : (long)igrid[i];
+	    t[i] = (ebmp->ebm_origin[i] + j*ebmp->ebm_cellsize[i] - rp->r_pt[i]) * invdir[i];
+	    continue;
+	}
+
+	lo = (long)(last[i] & ~(size_t)(EBM_TILE-1));
+	hi = (long)FMIN((size_t)lo + EBM_TILE, dim[i]) - 1;
+	j = (long)floor((rp->r_pt[i] + t1*rp->r_dir[i] - ebmp->ebm_origin[i]) / ebmp->ebm_cellsize[i]);
+	CLAMP(j, lo, hi);
+	t[i] = (ebmp->ebm_origin[i] + (j + (rp->r_dir[i] > 0))*ebmp->ebm_cellsize[i] - rp->r_pt[i]) * invdir[i];
+
+	/* the pixel is found from a rounded point, make sure its exit
+	 * is still ahead */
+	while (t[i] < t1 && ((rp->r_dir[i] > 0) ? j < hi : j > lo)) {
+	    j += (rp->r_dir[i] > 0) ? 1 : -1;
+	    t[i] += delta[i];
+	}
+	igrid[i] = (size_t)j;
+    }
+}
+
+
 
 /**
  * Step through the 2-D array, in local coordinates ("ideal space").
@@ -469,18 +670,37 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
 
     while (t0 < tmax) {
 	int val;
+	size_t texit[2], last[2];
+	uint32_t tile = EBM_TILE_OUTSIDE;
 	struct seg *segp;
 
-	/* find minimum exit t value */
-	out_index = t[X] < t[Y] ? X : Y;
+	if (ebmp->ebm_tiles)
+	    tile = ebm_tile_at(ebmp, igrid);
 
-	t1 = t[out_index];
+	if (tile == EBM_TILE_EMPTY || tile == EBM_TILE_FULL) {
+	    /* Ray passes through uniform tiles, step across them */
+	    t1 = ebm_tile_exit(ebmp, rp, invdir, tile, igrid, &out_index, last, texit);
+	    val = (tile == EBM_TILE_FULL);
+	    if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("tile at [%zu %zu] from %g to %g, val=%d\n",
+					    igrid[X], igrid[Y],
+					    t0, t1, val);
+	} else {
+	    /* find minimum exit t value */
+	    out_index = t[X] < t[Y] ? X : Y;
 
-	/* Ray passes through cell igrid[XY] from t0 to t1 */
-	val = *bit(&ebmp->ebm_i, igrid[X], igrid[Y]);
-	if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("igrid [%zu %zu] from %g to %g, val=%d\n",
-					igrid[X], igrid[Y],
-					t0, t1, val);
+	    t1 = t[out_index];
+
+	    /* Ray passes through cell igrid[XY] from t0 to t1 */
+	    if (!ebmp->ebm_tiles)
+		val = *bit(&ebmp->ebm_i, igrid[X], igrid[Y]);
+	    else if (tile == EBM_TILE_OUTSIDE)
+		break;	/* only off the bitmap by roundoff, close at tmax */
+	    else
+		val = ebm_tile_bit(ebmp, tile, igrid);
+	    if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("igrid [%zu %zu] from %g to %g, val=%d\n",
+					    igrid[X], igrid[Y],
+					    t0, t1, val);
+	}
 	if (RT_G_DEBUG&RT_DEBUG_EBM)bu_log("Exit index is %s, t[X]=%g, t[Y]=%g\n",
 					out_index==X ? "X" : "Y", t[X], t[Y]);
 
@@ -553,6 +773,10 @@ rt_ebm_dda(register struct xray *rp, struct soltab *stp, struct application *ap,
 	/* Take next step */
 	t0 = t1;
 	in_index = out_index;
+	if (tile == EBM_TILE_EMPTY || tile == EBM_TILE_FULL) {
+	    ebm_tile_step(ebmp, rp, invdir, delta, t1, out_index, last, texit, igrid, t);
+	    continue;
+	}
 	t[out_index] += delta[out_index];
 	if (rp->r_dir[out_index] > 0) {
 	    igrid[out_index]++;
@@ -1144,8 +1368,8 @@ rt_ebm_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
  * A struct rt_ebm_specific is created, and its address is stored
  * in stp->st_specific for use by rt_ebm_shot().
  */
-int
-rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static int
+ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip, int dense)
 {
     struct rt_ebm_internal *eip;
     register struct rt_ebm_specific *ebmp;
@@ -1164,6 +1388,16 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     /* "steal" the bitmap storage */
     eip->mp = (struct bu_mapped_file *)0;	/* "steal" the mapped file */
 
+    ebmp->ebm_tiles = NULL;
+    ebmp->ebm_bits = NULL;
+    if ((ebmp->ebm_i.mp || ebmp->ebm_i.buf) && !dense) {
+	size_t tilebytes = ebm_tiles_build(ebmp);
+
+	if (RT_G_DEBUG&RT_DEBUG_EBM)
+	    bu_log("ebm %s: %zu bytes of tiles for a %zu byte bitmap\n", stp->st_name, tilebytes,
+		   (size_t)(eip->xdim+BIT_XWIDEN*2)*(eip->ydim+BIT_YWIDEN*2));
+    }
+
     /* build Xform matrix from model(world) to ideal(local) space */
     bn_mat_inv(ebmp->ebm_mat, eip->mat);
 
@@ -1197,6 +1431,20 @@ rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 }
 
 
+int
+rt_ebm_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return ebm_prep(stp, ip, rtip, 0);
+}
+
+
+int
+rt_ebm_prep_dense(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return ebm_prep(stp, ip, rtip, 1);
+}
+
+
 void
 rt_ebm_print(register const struct soltab *stp)
 {
@@ -1330,6 +1578,10 @@ rt_ebm_free(struct soltab *stp)
 	(struct rt_ebm_specific *)stp->st_specific;
 
     bu_close_mapped_file(ebmp->ebm_i.mp);
+    if (ebmp->ebm_tiles)
+	bu_free(ebmp->ebm_tiles, "ebm tiles");
+    if (ebmp->ebm_bits)
+	bu_free(ebmp->ebm_bits, "ebm tile bits");
 
     BU_PUT(ebmp, struct rt_ebm_specific);
 }
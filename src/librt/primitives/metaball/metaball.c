@@ -37,7 +37,12 @@
  * Ray-tracing is incredibly hackish. The ray is walked in a fairly
  * coarse matter until the point evaluation crosses the threshold
  * value, then a basic binary search is done to refine the
- * approximated hit point.
+ * approximated hit point.  With enough control points, prep builds a
+ * bounding volume hierarchy over them: bounds on the field over the
+ * next run of steps let the walk skip runs that cannot cross the
+ * threshold, and samples only sum the points their bounds can't
+ * settle.  The samples that are taken are the ones the plain walk
+ * takes.
  *
  * THIS PRIMITIVE IS INCOMPLETE AND SHOULD BE CONSIDERED EXPERIMENTAL.
  *
@@ -55,6 +60,7 @@
 
 #include "vmath.h"
 #include "bu/cv.h"
+#include "bu/sort.h"
 #include "nmg.h"
 #include "rt/db4.h"
 #include "rt/geom.h"
@@ -62,11 +68,70 @@
 #include "wdb.h"
 
 #include "metaball.h"
+#include "../../librt_private.h"
 
 #define SQ(a) ((a)*(a))
 
 #define PLOT_THE_BIG_BOUNDING_SPHERE 0
 
+/* control points per leaf of the prep-time hierarchy */
+#define METABALL_LEAF 8
+
+/* fewer control points than this are cheaper to sum than to bound */
+#define METABALL_MIN_PTS 64
+
+/* nodes a single field query may keep open at once */
+#define METABALL_HEAP 128
+
+/* longest run of march steps skipped with one bound */
+#define METABALL_RUN 64
+
+/* nodes a field query opens before it gives up on bounding */
+#define METABALL_OPEN 48
+
+/* relative slop on field bounds, covers summation order and rounding */
+#define METABALL_SLOP 1.0e-10
+
+
+/* a control point with the terms of its field contribution precomputed */
+struct metaball_pt {
+    point_t coord;
+    fastf_t w;		/* iso: |fldstr| * fldstr */
+    fastf_t k;		/* blob: sweat / fldstr^2 */
+    fastf_t sweat;
+};
+
+
+/*
+ * A node of the bounding volume hierarchy over the control points.
+ * pos and neg sum the positive and negative weights under the node for
+ * the iso field; for blobs pos sums exp(sweat) and kmin/kmax bound the
+ * falloff.  Children are stored next to each other, child is zero for
+ * a leaf.
+ */
+struct metaball_node {
+    point_t min, max;
+    fastf_t pos, neg;
+    fastf_t kmin, kmax;
+    size_t first, count;
+    size_t child;
+};
+
+
+struct metaball_specific {
+    struct rt_metaball_internal mb;
+    struct metaball_pt *pts;	/* NULL if the field is marched by brute force */
+    struct metaball_node *nodes;
+    size_t npts, nnodes;
+};
+
+
+struct metaball_bound {
+    size_t node;
+    fastf_t lo, hi;
+    fastf_t gap;	/* hi - lo, or INFINITY if the node is unbounded */
+};
+
 const char *metaballnames[] =
 {
     "Metaball",
@@ -179,14 +244,129 @@ rt_metaball_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const st
 }
 
 
+static int
+metaball_pt_cmp(const void *a, const void *b, void *arg)
+{
+    int axis = *(const int *)arg;
+    fastf_t ca = ((const struct metaball_pt *)a)->coord[axis];
+    fastf_t cb = ((const struct metaball_pt *)b)->coord[axis];
+
+    if (ca < cb)
+	return -1;
+    if (ca > cb)
+	return 1;
+    return 0;
+}
+
+
+/* fill in node n over count points from first, splitting at the median
+ * of its longest axis until the leaves are small enough */
+static void
+metaball_bvh_build(struct metaball_specific *ms, size_t n, size_t first, size_t count)
+{
+    struct metaball_node *node = &ms->nodes[n];
+    vect_t extent;
+    size_t i, left;
+    int axis;
+
+    node->first = first;
+    node->count = count;
+    node->child = 0;
+    node->pos = node->neg = 0.0;
+    node->kmin = INFINITY;
+    node->kmax = -INFINITY;
+    VSETALL(node->min, INFINITY);
+    VSETALL(node->max, -INFINITY);
+    for (i = first; i < first + count; i++) {
+	const struct metaball_pt *pt = &ms->pts[i];
+
+	VMIN(node->min, pt->coord);
+	VMAX(node->max, pt->coord);
+	if (ms->mb.method == METABALL_ISOPOTENTIAL) {
+	    if (pt->w > 0.0)
+		node->pos += pt->w;
+	    else
+		node->neg += pt->w;
+	} else {
+	    node->pos += exp(pt->sweat);
+	    V_MIN(node->kmin, pt->k);
+	    V_MAX(node->kmax, pt->k);
+	}
+    }
+
+    if (count <= METABALL_LEAF)
+	return;
+
+    VSUB2(extent, node->max, node->min);
+    axis = X;
+    if (extent[Y] > extent[axis])
+	axis = Y;
+    if (extent[Z] > extent[axis])
+	axis = Z;
+    bu_sort(&ms->pts[first], count, sizeof(struct metaball_pt), metaball_pt_cmp, &axis);
+
+    left = count / 2;
+    node->child = ms->nnodes;
+    ms->nnodes += 2;
+    metaball_bvh_build(ms, node->child, first, left);
+    metaball_bvh_build(ms, node->child + 1, first + left, count - left);
+}
+
+
+/*
+ * Build the hierarchy the ray march bounds the field with.  Only the
+ * iso and blob fields are bounded, and blobs only when every point's
+ * falloff is finite and non-negative; anything else, and metaballs
+ * with only a few points, are marched by brute force, as is every
+ * metaball prepped with rt_metaball_prep_brute().
+ */
+static void
+metaball_bvh_prep(struct metaball_specific *ms)
+{
+    struct wdb_metaball_pnt *mbpt;
+    size_t i = 0;
+
+    if (ms->mb.method != METABALL_ISOPOTENTIAL && ms->mb.method != METABALL_BLOB)
+	return;
+
+    for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &ms->mb.metaball_ctrl_head))
+	ms->npts++;
+    if (ms->npts < METABALL_MIN_PTS) {
+	ms->npts = 0;
+	return;
+    }
+
+    ms->pts = (struct metaball_pt *)bu_malloc(ms->npts * sizeof(struct metaball_pt), "metaball points");
+    for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &ms->mb.metaball_ctrl_head)) {
+	struct metaball_pt *pt = &ms->pts[i++];
+
+	VMOVE(pt->coord, mbpt->coord);
+	pt->w = fabs(mbpt->fldstr) * mbpt->fldstr;
+	pt->k = mbpt->sweat/(mbpt->fldstr*mbpt->fldstr);
+	pt->sweat = mbpt->sweat;
+	if (ms->mb.method == METABALL_BLOB && (!(pt->k >= 0.0) || isinf(pt->k) || isinf(exp(pt->sweat)))) {
+	    bu_free(ms->pts, "metaball points");
+	    ms->pts = NULL;
+	    ms->npts = 0;
+	    return;
+	}
+    }
+
+    ms->nodes = (struct metaball_node *)bu_malloc(2 * ms->npts * sizeof(struct metaball_node), "metaball nodes");
+    ms->nnodes = 1;
+    metaball_bvh_build(ms, 0, 0, ms->npts);
+}
+
+
 /**
  * prep and build bounding volumes... unfortunately, generating the
  * bounding sphere is too 'loose' (I think) and O(n^2).
  */
-int
-rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static int
+metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip, int brute)
 {
     struct rt_metaball_internal *mb, *nmb;
+    struct metaball_specific *ms;
     struct wdb_metaball_pnt *mbpt, *nmbpt;
     fastf_t minfstr = +INFINITY;
 
@@ -196,7 +376,8 @@ rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rti
     RT_METABALL_CK_MAGIC(mb);
 
     /* generate a copy of the metaball */
-    BU_ALLOC(nmb, struct rt_metaball_internal);
+    BU_ALLOC(ms, struct metaball_specific);
+    nmb = &ms->mb;
     nmb->magic = RT_METABALL_INTERNAL_MAGIC;
     BU_LIST_INIT(&nmb->metaball_ctrl_head);
     nmb->threshold = mb->threshold;
@@ -228,11 +409,27 @@ rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rti
     /* generate a bounding box around the sphere...
      * XXX this can be optimized greatly to reduce the BSP presence... */
     if (rt_metaball_bbox(ip, &(stp->st_min), &(stp->st_max), &rtip->rti_tol)) return 1;
-    stp->st_specific = (void *)nmb;
+    if (!brute)
+	metaball_bvh_prep(ms);
+    stp->st_specific = (void *)ms;
     return 0;
 }
 
 
+int
+rt_metaball_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return metaball_prep(stp, ip, rtip, 0);
+}
+
+
+int
+rt_metaball_prep_brute(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return metaball_prep(stp, ip, rtip, 1);
+}
+
+
 void
 rt_metaball_print(register const struct soltab *stp)
 {
@@ -240,7 +437,7 @@ rt_metaball_print(register const struct soltab *stp)
     struct rt_metaball_internal *mb;
     struct wdb_metaball_pnt *mbpt;
 
-    mb = (struct rt_metaball_internal *)stp->st_specific;
+    mb = &((struct metaball_specific *)stp->st_specific)->mb;
     RT_METABALL_CK_MAGIC(mb);
     for (BU_LIST_FOR(mbpt, wdb_metaball_pnt, &mb->metaball_ctrl_head)) ++metaball_count;
     bu_log("Metaball with %d points and a threshold of %g (%s rendering)\n", metaball_count, mb->threshold, rt_metaball_lookup_type_name(mb->method));
@@ -361,10 +558,279 @@ rt_metaball_find_intersection(point_t *intersect, const struct rt_metaball_inter
 }
 
 
+/*
+ * Bound the contribution of a node over the ball of radius rad around
+ * c.  Returns 0 if the iso field is unbounded there, i.e. the ball
+ * reaches into the node's box.
+ */
+static int
+metaball_node_bound(const struct metaball_specific *ms, const struct metaball_node *node, const point_t c, fastf_t rad, struct metaball_bound *b)
+{
+    fastf_t dmin = 0.0, dmax = 0.0;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+	fastf_t lo = node->min[i] - c[i];
+	fastf_t hi = c[i] - node->max[i];
+
+	if (lo > 0.0)
+	    dmin += lo * lo;
+	else if (hi > 0.0)
+	    dmin += hi * hi;
+	dmax += SQ(FMAX(fabs(lo), fabs(hi)));
+    }
+    if (rad > 0.0) {
+	dmin = sqrt(dmin) - rad;
+	dmin = (dmin > 0.0) ? dmin * dmin : 0.0;
+	dmax = SQ(sqrt(dmax) + rad);
+    }
+
+    if (ms->mb.method == METABALL_ISOPOTENTIAL) {
+	if (dmin <= 0.0) {
+	    b->lo = b->hi = 0.0;
+	    b->gap = INFINITY;
+	    return 0;
+	}
+	b->hi = node->pos / dmin + node->neg / dmax;
+	b->lo = node->pos / dmax + node->neg / dmin;
+    } else {
+	b->hi = node->pos * exp(-node->kmin * dmin);
+	b->lo = node->pos * exp(-node->kmax * dmax);
+    }
+    b->gap = b->hi - b->lo;
+    return 1;
+}
+
+
+/*
+ * Bound the contribution of the points under a node over the ball of
+ * radius rad around c, adding to *lo and *hi.  For a point query the
+ * terms are summed exactly as rt_metaball_point_value() sums them.
+ * Returns 0 if the ball reaches an iso point.
+ */
+static int
+metaball_leaf_bound(const struct metaball_specific *ms, const struct metaball_node *node, const point_t c, fastf_t rad, fastf_t *lo, fastf_t *hi, fastf_t *scale)
+{
+    size_t i;
+    vect_t v;
+
+    for (i = node->first; i < node->first + node->count; i++) {
+	const struct metaball_pt *pt = &ms->pts[i];
+	fastf_t dmin, dmax, tlo, thi;
+
+	VSUB2(v, pt->coord, c);
+	if (rad <= 0.0) {
+	    if (ms->mb.method == METABALL_ISOPOTENTIAL)
+		tlo = pt->w / MAGSQ(v);
+	    else
+		tlo = 1.0 / exp(pt->k * MAGSQ(v) - pt->sweat);
+	    *lo += tlo;
+	    *hi += tlo;
+	    *scale += fabs(tlo);
+	    continue;
+	}
+
+	dmin = sqrt(MAGSQ(v));
+	dmax = SQ(dmin + rad);
+	dmin = (dmin > rad) ? SQ(dmin - rad) : 0.0;
+	if (ms->mb.method == METABALL_ISOPOTENTIAL) {
+	    if (dmin <= 0.0)
+		return 0;
+	    thi = pt->w / ((pt->w > 0.0) ? dmin : dmax);
+	    tlo = pt->w / ((pt->w > 0.0) ? dmax : dmin);
+	} else {
+	    thi = 1.0 / exp(pt->k * dmin - pt->sweat);
+	    tlo = 1.0 / exp(pt->k * dmax - pt->sweat);
+	}
+	*lo += tlo;
+	*hi += thi;
+	*scale += fabs(tlo) + fabs(thi);
+    }
+    return 1;
+}
+
+
+static void
+metaball_heap_push(struct metaball_bound *heap, size_t *nheap, const struct metaball_bound *b)
+{
+    size_t i = (*nheap)++;
+
+    while (i > 0 && heap[(i - 1) / 2].gap < b->gap) {
+	heap[i] = heap[(i - 1) / 2];
+	i = (i - 1) / 2;
+    }
+    heap[i] = *b;
+}
+
+
+static void
+metaball_heap_pop(struct metaball_bound *heap, size_t *nheap, struct metaball_bound *b)
+{
+    struct metaball_bound last;
+    size_t i = 0, n;
+
+    *b = heap[0];
+    n = --(*nheap);
+    last = heap[n];
+    while (2 * i + 1 < n) {
+	size_t j = 2 * i + 1;
+	if (j + 1 < n && heap[j + 1].gap > heap[j].gap)
+	    j++;
+	if (heap[j].gap <= last.gap)
+	    break;
+	heap[i] = heap[j];
+	i = j;
+    }
+    if (n)
+	heap[i] = last;
+}
+
+
+/*
+ * Compare the field over the ball of radius rad around c against the
+ * threshold.  Nodes are opened widest bound first until the summed
+ * bounds fall on one side of it, returning -1 if the field is below
+ * the threshold throughout and 1 if it is above.  A point query
+ * (rad == 0) sums the points of any leaf it opens, so it always
+ * decides, and *val receives the exact field or a bound on the same
+ * side of the threshold as it.  A ball the bounds cannot decide
+ * returns 0.
+ */
+static int
+metaball_classify(const struct metaball_specific *ms, const point_t c, fastf_t rad, fastf_t *val)
+{
+    struct metaball_bound heap[METABALL_HEAP];
+    struct metaball_bound b;
+    size_t nheap = 0, nopen = 0, opened = 0;
+    fastf_t lo = 0.0, hi = 0.0;		/* nodes still in the heap */
+    fastf_t plo = 0.0, phi = 0.0;	/* points already summed */
+    fastf_t scale = 0.0;
+    fastf_t threshold = ms->mb.threshold;
+
+    b.node = 0;
+    if (metaball_node_bound(ms, &ms->nodes[0], c, rad, &b)) {
+	lo = b.lo;
+	hi = b.hi;
+	scale = fabs(b.lo) + fabs(b.hi);
+    } else {
+	nopen++;
+    }
+    metaball_heap_push(heap, &nheap, &b);
+
+    for (;;) {
+	const struct metaball_node *node;
+
+	if (!nheap) {
+	    /* a point query has summed every point */
+	    if (rad > 0.0 || !val)
+		return (phi < threshold) ? -1 : (plo > threshold) ? 1 : 0;
+	    *val = plo;
+	    return (plo < threshold) ? -1 : 1;
+	}
+	if (!nopen) {
+	    fastf_t slop = METABALL_SLOP * scale;
+	    if (phi + hi + slop < threshold) {
+		if (val)
+		    *val = phi + hi + slop;
+		return -1;
+	    }
+	    if (plo + lo - slop > threshold) {
+		if (val)
+		    *val = plo + lo - slop;
+		return 1;
+	    }
+	}
+
+	/* near the surface the bounds only close once most of the
+	 * points are summed, so stop paying for the heap and sum them */
+	if (++opened > METABALL_OPEN) {
+	    if (rad > 0.0)
+		return 0;
+	    plo = phi = 0.0;
+	    (void)metaball_leaf_bound(ms, &ms->nodes[0], c, 0.0, &plo, &phi, &scale);
+	    if (val)
+		*val = plo;
+	    return (plo < threshold) ? -1 : 1;
+	}
+
+	metaball_heap_pop(heap, &nheap, &b);
+	if (isinf(b.gap)) {
+	    nopen--;
+	} else {
+	    lo -= b.lo;
+	    hi -= b.hi;
+	}
+	node = &ms->nodes[b.node];
+
+	if (node->child && nheap + 2 <= METABALL_HEAP) {
+	    size_t i;
+	    for (i = node->child; i < node->child + 2; i++) {
+		b.node = i;
+		if (metaball_node_bound(ms, &ms->nodes[i], c, rad, &b)) {
+		    lo += b.lo;
+		    hi += b.hi;
+		    scale += fabs(b.lo) + fabs(b.hi);
+		} else {
+		    nopen++;
+		}
+		metaball_heap_push(heap, &nheap, &b);
+	    }
+	} else if (!metaball_leaf_bound(ms, node, c, rad, &plo, &phi, &scale)) {
+	    return 0;
+	}
+    }
+}
+
+
+/* the field at p, or a bound on it that compares the same against the
+ * threshold */
+static fastf_t
+metaball_sample(const struct metaball_specific *ms, const point_t *p)
+{
+    fastf_t val;
+
+    if (!ms->pts)
+	return rt_metaball_point_value(p, &ms->mb);
+    (void)metaball_classify(ms, *p, 0.0, &val);
+    return val;
+}
+
+
+/* rt_metaball_find_intersection() with its samples taken through the
+ * hierarchy, reusing the inside test of the end it keeps */
+static void
+metaball_find_intersection(point_t *intersect, const struct metaball_specific *ms, const point_t *a, const point_t *b, fastf_t step, const fastf_t finalstep)
+{
+    point_t pa, pb, mid;
+    fastf_t threshold = ms->mb.threshold;
+    int ina;
+
+    VMOVE(pa, *a);
+    VMOVE(pb, *b);
+    ina = metaball_sample(ms, a) >= threshold;
+    for (;;) {
+	int inmid;
+
+	VADD2(mid, pa, pb);
+	VSCALE(mid, mid, 0.5);
+	if (finalstep > step)
+	    break;
+	inmid = metaball_sample(ms, (const point_t *)&mid) >= threshold;
+	if (ina != inmid)
+	    VMOVE(pb, pa);
+	VMOVE(pa, mid);
+	ina = inmid;
+	step /= 2.0;
+    }
+    VMOVE(*intersect, mid);
+}
+
+
 int
 rt_metaball_shot(struct soltab *stp, register struct xray *rp, struct application *ap, struct seg *seghead)
 {
-    struct rt_metaball_internal *mb = (struct rt_metaball_internal *)stp->st_specific;
+    struct metaball_specific *ms = (struct metaball_specific *)stp->st_specific;
+    struct rt_metaball_internal *mb = &ms->mb;
     struct seg *segp = NULL;
     int retval = 0;
     fastf_t step, distleft;
@@ -386,7 +852,7 @@ rt_metaball_shot(struct soltab *stp, register struct xray *rp, struct applicatio
     VSCALE(inc, rp->r_dir, step); /* assume it's normalized and we want to creep at step */
 
     /* walk back out of the solid */
-    while (rt_metaball_point_value(cp, mb) >= mb->threshold) {
+    while (metaball_sample(ms, cp) >= mb->threshold) {
 #if SHOOTALGO == 2
 	fhin = -1;
 #endif
@@ -446,19 +912,46 @@ rt_metaball_shot(struct soltab *stp, register struct xray *rp, struct applicatio
 #elif SHOOTALGO == 3
     {
 	int mb_stat = 0, segsleft = abs(ap->a_onehit);
+	size_t run = 1;
 	point_t lastpoint;
 
 	while (distleft >= 0.0 || mb_stat == 1) {
+	    /* if the field stays on this side of the threshold over the
+	     * next run of steps, no sample in it can find a crossing, so
+	     * take them all without sampling.  The samples land where
+	     * single steps would have put them. */
+	    if (ms->pts) {
+		fastf_t half;
+		point_t mid;
+
+		if (mb_stat == 0 && (fastf_t)run * step > distleft + step)
+		    run = (size_t)(distleft / step) + 1;
+		half = 0.5 * run * step;
+		VJOIN1(mid, p, half, rp->r_dir);
+		if (metaball_classify(ms, mid, half * (1.0 + 1.0e-6), NULL) == (mb_stat ? 1 : -1)) {
+		    size_t i;
+		    for (i = 0; i < run; i++) {
+			distleft -= step;
+			VADD2(p, p, inc);
+		    }
+		    if (run < METABALL_RUN)
+			run *= 2;
+		    continue;
+		}
+		if (run > 1)
+		    run /= 2;
+	    }
+
 	    /* advance to the next point */
 	    distleft -= step;
 	    VMOVE(lastpoint, p);
 	    VADD2(p, p, inc);
 	    if (mb_stat == 1) {
-		if (rt_metaball_point_value(cp, mb) < mb->threshold) {
+		if (metaball_sample(ms, cp) < mb->threshold) {
 		    point_t intersect, delta;
 		    const point_t *pA = (const point_t *)&lastpoint;
 		    const point_t *pB = (const point_t *)&p;
-		    rt_metaball_find_intersection(&intersect, mb, pA, pB, step, mb->finalstep);
+		    metaball_find_intersection(&intersect, ms, pA, pB, step, mb->finalstep);
 		    VMOVE(segp->seg_out.hit_point, intersect);
 		    --segsleft;
 		    ++retval;
@@ -470,11 +963,11 @@ rt_metaball_shot(struct soltab *stp, register struct xray *rp, struct applicatio
 			return retval;
 		}
 	    } else {
-		if (rt_metaball_point_value(cp, mb) > mb->threshold) {
+		if (metaball_sample(ms, cp) > mb->threshold) {
 		    point_t intersect, delta;
 		    const point_t *pA = (const point_t *)&lastpoint;
 		    const point_t *pB = (const point_t *)&p;
-		    rt_metaball_find_intersection(&intersect, mb, pA, pB, step, mb->finalstep);
+		    metaball_find_intersection(&intersect, ms, pA, pB, step, mb->finalstep);
 		    RT_GET_SEG(segp, ap->a_resource);
 		    segp->seg_stp = stp;
 		    --segsleft;
@@ -542,7 +1035,7 @@ void
 rt_metaball_norm(register struct hit *hitp, struct soltab *stp, register struct xray *rp)
 {
     if (rp) RT_CK_RAY(rp);	/* unused. */
-    rt_metaball_norm_internal(&(hitp->hit_normal), &(hitp->hit_point), (struct rt_metaball_internal *)(stp->st_specific));
+    rt_metaball_norm_internal(&(hitp->hit_normal), &(hitp->hit_point), &((struct metaball_specific *)stp->st_specific)->mb);
     return;
 }
 
@@ -553,7 +1046,7 @@ rt_metaball_norm(register struct hit *hitp, struct soltab *stp, register struct
 void
 rt_metaball_curve(struct curvature *cvp, struct hit *hitp, struct soltab *stp)
 {
-    struct rt_metaball_internal *metaball = (struct rt_metaball_internal *)stp->st_specific;
+    struct metaball_specific *metaball = (struct metaball_specific *)stp->st_specific;
 
     if (!metaball || !cvp) return;
     if (hitp) RT_CK_HIT(hitp);
@@ -573,7 +1066,7 @@ rt_metaball_curve(struct curvature *cvp, struct hit *hitp, struct soltab *stp)
 void
 rt_metaball_uv(struct application *ap, struct soltab *stp, struct hit *hitp, struct uvcoord *uvp)
 {
-    struct rt_metaball_internal *metaball = (struct rt_metaball_internal *)stp->st_specific;
+    struct metaball_specific *metaball = (struct metaball_specific *)stp->st_specific;
     vect_t work, pprime;
     fastf_t r;
 
@@ -611,9 +1104,18 @@ rt_metaball_uv(struct application *ap, struct soltab *stp, struct hit *hitp, str
 void
 rt_metaball_free(register struct soltab *stp)
 {
-    struct rt_metaball_internal *metaball = (struct rt_metaball_internal *)stp->st_specific;
+    struct metaball_specific *metaball = (struct metaball_specific *)stp->st_specific;
+    struct wdb_metaball_pnt *mbpt;
 
-    bu_free((char *)metaball, "rt_metaball_internal");
+    while (BU_LIST_WHILE(mbpt, wdb_metaball_pnt, &metaball->mb.metaball_ctrl_head)) {
+	BU_LIST_DEQUEUE(&mbpt->l);
+	bu_free(mbpt, "wdb_metaball_pnt");
+    }
+    if (metaball->pts) {
+	bu_free(metaball->pts, "metaball points");
+	bu_free(metaball->nodes, "metaball nodes");
+    }
+    bu_free((char *)metaball, "metaball_specific");
 }
 
 
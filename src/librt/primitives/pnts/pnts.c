@@ -32,9 +32,41 @@
 #include "bu/cv.h"
 #include "bn.h"
 
+#include "bu/sort.h"
 #include "raytrace.h"
 #include "rt/geom.h"
 #include "vmath.h"
+#include "../../cut_hlbvh.h"
+
+#define PNTS_STACK_SIZE 256
+#define PNTS_MAX_PRIMS_IN_NODE 4
+
+/* each point is raytraced as a sphere, stored in BVH leaf order */
+struct pnts_sphere {
+    point_t v;
+    fastf_t r;
+    long id;		/* index of the point in the collection */
+};
+
+struct pnts_specific {
+    struct bvh_flat_node *root;
+    struct pnts_sphere *sph;
+    long count;
+};
+
+/* one sphere's span along a ray */
+struct pnts_span {
+    fastf_t in, out;
+    const struct pnts_sphere *sin, *sout;
+};
+
+typedef struct _pnts_span_da {
+    size_t count;
+    size_t capacity;
+    struct pnts_span *items;
+} pnts_span_da;
+
+THREADLOCAL pnts_span_da spans_per_cpu = {0, 0, NULL};
 
 
 extern int rt_ell_plot(struct bu_list *, struct rt_db_internal *, const struct bg_tess_tol *, const struct bn_tol *, const struct bview *);
@@ -171,17 +203,109 @@ rt_pnts_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
     return 0;
 }
 
+/* the radius a point is raytraced with, its own scale if it has one */
+static fastf_t
+_pnts_radius(const struct rt_pnts_internal *pnts, const struct pnt *point)
+{
+    fastf_t s = 0.0;
+
+    switch (pnts->type) {
+	case RT_PNT_TYPE_SCA:
+	    s = ((const struct pnt_scale *)point)->s;
+	    break;
+	case RT_PNT_TYPE_COL_SCA:
+	    s = ((const struct pnt_color_scale *)point)->s;
+	    break;
+	case RT_PNT_TYPE_SCA_NRM:
+	    s = ((const struct pnt_scale_normal *)point)->s;
+	    break;
+	case RT_PNT_TYPE_COL_SCA_NRM:
+	    s = ((const struct pnt_color_scale_normal *)point)->s;
+	    break;
+	default:
+	    break;
+    }
+    return (s > 0.0) ? s : pnts->scale;
+}
+
+
+/**
+ * Each point with a positive size becomes a sphere of that radius, and
+ * an HLBVH over the sphere bounds finds the ones a ray can hit.
+ */
 int
 rt_pnts_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 {
     struct rt_pnts_internal *pnts_ip;
+    struct pnts_specific *pnts;
+    struct pnt *point, *head;
+    struct bu_pool *pool;
+    struct bvh_build_node *build_root;
+    fastf_t *centroids, *bounds;
+    struct pnts_sphere *sph;
+    long *ordered = NULL;
+    long nodes_created = 0;
+    long i, n = 0, id = 0;
 
     RT_CK_DB_INTERNAL(ip);
     pnts_ip = (struct rt_pnts_internal *)ip->idb_ptr;
     RT_PNTS_CK_MAGIC(pnts_ip);
 
     if (rt_pnts_bbox(ip, &(stp->st_min), &(stp->st_max), &(rtip->rti_tol))) return 1;
+    if (pnts_ip->count <= 0 || !pnts_ip->point)
+	goto bound;
+
+    sph = (struct pnts_sphere *)bu_malloc(pnts_ip->count * sizeof(struct pnts_sphere), "pnts spheres");
+    head = (struct pnt *)pnts_ip->point;
+    for (BU_LIST_FOR(point, pnt, &head->l)) {
+	fastf_t r = _pnts_radius(pnts_ip, point);
+	if (r > 0.0) {
+	    VMOVE(sph[n].v, point->v);
+	    sph[n].r = r;
+	    sph[n].id = id;
+	    n++;
+	}
+	id++;
+    }
+    if (!n) {
+	/* nothing has a size, the points bound but are never hit */
+	bu_free(sph, "pnts spheres");
+	goto bound;
+    }
+
+    centroids = (fastf_t *)bu_malloc(n * sizeof(fastf_t) * 3, "pnts centroids");
+    bounds = (fastf_t *)bu_malloc(n * sizeof(fastf_t) * 6, "pnts bounds");
+    for (i = 0; i < n; i++) {
+	vect_t rad;
+	VSETALL(rad, sph[i].r);
+	VMOVE(&centroids[i*3], sph[i].v);
+	VSUB2(&bounds[i*6+0], sph[i].v, rad);
+	VADD2(&bounds[i*6+3], sph[i].v, rad);
+    }
 
+    pool = hlbvh_init_pool(n);
+    build_root = hlbvh_create(PNTS_MAX_PRIMS_IN_NODE, pool, centroids, bounds, &nodes_created, n, &ordered);
+    bu_free(centroids, "pnts centroids");
+    bu_free(bounds, "pnts bounds");
+
+    BU_GET(pnts, struct pnts_specific);
+    pnts->root = hlbvh_flatten(build_root, nodes_created);
+    bu_pool_delete(pool);
+
+    /* put the spheres in the order the leaves reference them */
+    pnts->sph = (struct pnts_sphere *)bu_malloc(n * sizeof(struct pnts_sphere), "pnts ordered spheres");
+    for (i = 0; i < n; i++)
+	pnts->sph[i] = sph[ordered[i]];
+    pnts->count = n;
+    bu_free(ordered, "pnts ordered");
+    bu_free(sph, "pnts spheres");
+    stp->st_specific = (void *)pnts;
+
+    /* the root bounds every sphere */
+    VMOVE(stp->st_min, &pnts->root->bounds[0]);
+    VMOVE(stp->st_max, &pnts->root->bounds[3]);
+
+bound:
     /* Compute bounding sphere which contains the bounding RPP.*/
     {
 	vect_t work;
@@ -200,6 +324,244 @@ rt_pnts_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     return 0;
 }
 
+
+/* append the span of every sphere the ray passes through */
+static void
+pnts_shot_hlbvh_flat(const struct pnts_specific *pnts, struct xray *rp, pnts_span_da *spans)
+{
+    const struct bvh_flat_node *stack_node[PNTS_STACK_SIZE];
+    unsigned char stack_child_index[PNTS_STACK_SIZE];
+    int stack_ind = 0;
+    vect_t inverse_r_dir;
+
+    stack_node[stack_ind] = pnts->root;
+    stack_child_index[stack_ind] = 0;
+    VINVDIR(inverse_r_dir, rp->r_dir);
+
+    while (stack_ind >= 0) {
+	const struct bvh_flat_node *node;
+
+	if (UNLIKELY(stack_ind >= PNTS_STACK_SIZE))
+	    bu_bomb("Stack size exceeded in pnts shot");
+	if (stack_child_index[stack_ind] >= 2) {
+	    stack_ind--;
+	    continue;
+	}
+	node = stack_node[stack_ind];
+
+	/* check bounds if it's the first time in this node */
+	if (!stack_child_index[stack_ind]) {
+	    point_t lows_t, highs_t, low_ts, high_ts;
+	    fastf_t high_t, low_t;
+
+	    VSUB2(lows_t, &node->bounds[0], rp->r_pt);
+	    VSUB2(highs_t, &node->bounds[3], rp->r_pt);
+	    VELMUL(lows_t, lows_t, inverse_r_dir);
+	    VELMUL(highs_t, highs_t, inverse_r_dir);
+	    VMOVE(low_ts, lows_t);
+	    VMOVE(high_ts, lows_t);
+	    VMINMAX(low_ts, high_ts, highs_t);
+
+	    high_t = FMIN(high_ts[0], FMIN(high_ts[1], high_ts[2]));
+	    low_t = FMAX(low_ts[0], FMAX(low_ts[1], low_ts[2]));
+	    if ((high_t < -1.0) | (low_t > high_t)) {
+		stack_ind--;
+		continue;
+	    }
+	}
+
+	if (node->n_primitives > 0) {
+	    long end = node->data.first_prim_offset + node->n_primitives;
+	    long i;
+
+	    for (i = node->data.first_prim_offset; i < end; i++) {
+		const struct pnts_sphere *sp = &pnts->sph[i];
+		vect_t ov;
+		fastf_t b, magsq_ov, root;
+
+		/* as rt_sph_shot() */
+		VSUB2(ov, sp->v, rp->r_pt);
+		b = VDOT(rp->r_dir, ov);
+		magsq_ov = MAGSQ(ov);
+		root = b*b - magsq_ov + sp->r*sp->r;
+		if (magsq_ov >= sp->r*sp->r && (b < 0 || root <= 0))
+		    continue;
+		root = sqrt(root);
+
+		if (spans->count >= spans->capacity) {
+		    spans->capacity = (spans->capacity) ? spans->capacity * 2 : 64;
+		    spans->items = (struct pnts_span *)bu_realloc(spans->items, spans->capacity * sizeof(struct pnts_span), "pnts spans");
+		}
+		spans->items[spans->count].in = b - root;
+		spans->items[spans->count].out = b + root;
+		spans->items[spans->count].sin = sp;
+		spans->items[spans->count].sout = sp;
+		spans->count++;
+	    }
+	    stack_ind--;
+	    continue;
+	}
+
+	/* not a leaf, visit the next child */
+	stack_node[stack_ind+1] = (stack_child_index[stack_ind]) ? node->data.other_child : node + 1;
+	stack_child_index[stack_ind] += 1;
+	stack_child_index[stack_ind+1] = 0;
+	stack_ind++;
+    }
+}
+
+
+static int
+pnts_span_cmp(const void *a, const void *b, void *UNUSED(arg))
+{
+    fastf_t ia = ((const struct pnts_span *)a)->in;
+    fastf_t ib = ((const struct pnts_span *)b)->in;
+
+    if (ia < ib)
+	return -1;
+    if (ia > ib)
+	return 1;
+    return 0;
+}
+
+
+static void
+pnts_add_seg(struct soltab *stp, struct application *ap, struct seg *seghead, const struct pnts_span *span)
+{
+    struct seg *segp;
+
+    RT_GET_SEG(segp, ap->a_resource);
+    segp->seg_stp = stp;
+    segp->seg_in.hit_dist = span->in;
+    segp->seg_in.hit_surfno = (int)span->sin->id;
+    segp->seg_in.hit_private = (void *)span->sin;
+    segp->seg_out.hit_dist = span->out;
+    segp->seg_out.hit_surfno = (int)span->sout->id;
+    segp->seg_out.hit_private = (void *)span->sout;
+    BU_LIST_INSERT(&(seghead->l), &(segp->l));
+}
+
+
+/**
+ * Intersect a ray with the point spheres.  Spheres that overlap along
+ * the ray are merged, so the segments are disjoint; hit_surfno is the
+ * index of the point in the collection.
+ *
+ * Returns -
+ * 0 MISS
+ * >0 HIT
+ */
+int
+rt_pnts_shot(struct soltab *stp, struct xray *rp, struct application *ap, struct seg *seghead)
+{
+    struct pnts_specific *pnts = (struct pnts_specific *)stp->st_specific;
+    pnts_span_da *spans = &spans_per_cpu;
+    struct pnts_span cur;
+    size_t i;
+    int nsegs = 0;
+
+    if (UNLIKELY(!pnts))
+	return 0;
+
+    spans->count = 0;
+    pnts_shot_hlbvh_flat(pnts, rp, spans);
+    if (!spans->count)
+	return 0;
+
+    bu_sort(spans->items, spans->count, sizeof(struct pnts_span), pnts_span_cmp, NULL);
+
+    cur = spans->items[0];
+    for (i = 1; i < spans->count; i++) {
+	const struct pnts_span *next = &spans->items[i];
+	if (next->in <= cur.out) {
+	    if (next->out > cur.out) {
+		cur.out = next->out;
+		cur.sout = next->sout;
+	    }
+	    continue;
+	}
+	pnts_add_seg(stp, ap, seghead, &cur);
+	nsegs++;
+	cur = *next;
+    }
+    pnts_add_seg(stp, ap, seghead, &cur);
+    nsegs++;
+
+    return 2 * nsegs;
+}
+
+
+/**
+ * Given ONE ray distance, return the normal and entry/exit point.
+ */
+void
+rt_pnts_norm(struct hit *hitp, struct soltab *UNUSED(stp), struct xray *rp)
+{
+    const struct pnts_sphere *sp = (const struct pnts_sphere *)hitp->hit_private;
+
+    VJOIN1(hitp->hit_point, rp->r_pt, hitp->hit_dist, rp->r_dir);
+    VSUB2(hitp->hit_normal, hitp->hit_point, sp->v);
+    VSCALE(hitp->hit_normal, hitp->hit_normal, 1.0 / sp->r);
+}
+
+
+/**
+ * Return the curvature of the point sphere that was hit.
+ */
+void
+rt_pnts_curve(struct curvature *cvp, struct hit *hitp, struct soltab *UNUSED(stp))
+{
+    const struct pnts_sphere *sp = (const struct pnts_sphere *)hitp->hit_private;
+
+    cvp->crv_c1 = cvp->crv_c2 = -1.0 / sp->r;
+
+    /* any tangent direction */
+    bn_vec_ortho(cvp->crv_pdir, hitp->hit_normal);
+}
+
+
+/**
+ * For a hit on a point sphere, return the (u, v) coordinates of the
+ * hit point on that sphere, 0 <= u, v <= 1.
+ *
+ * u = azimuth
+ * v = elevation
+ */
+void
+rt_pnts_uv(struct application *ap, struct soltab *UNUSED(stp), struct hit *hitp, struct uvcoord *uvp)
+{
+    const struct pnts_sphere *sp = (const struct pnts_sphere *)hitp->hit_private;
+    vect_t pprime;
+    fastf_t r;
+
+    VSUB2(pprime, hitp->hit_point, sp->v);
+    VSCALE(pprime, pprime, 1.0 / sp->r);
+
+    uvp->uv_u = bn_atan2(pprime[Y], pprime[X]) * M_1_2PI;
+    if (uvp->uv_u < 0)
+	uvp->uv_u += 1.0;
+    uvp->uv_v = bn_atan2(pprime[Z],
+			 sqrt(pprime[X] * pprime[X] + pprime[Y] * pprime[Y])) *
+	M_1_PI + 0.5;
+
+    /* approximation: r / (circumference, 2 * pi * radius) */
+    r = ap->a_rbeam + ap->a_diverge * hitp->hit_dist;
+    uvp->uv_du = uvp->uv_dv = M_1_2PI * r / sp->r;
+}
+
+
+void
+rt_pnts_free(struct soltab *stp)
+{
+    struct pnts_specific *pnts = (struct pnts_specific *)stp->st_specific;
+
+    if (!pnts)
+	return;
+    bu_free(pnts->root, "pnts bvh");
+    bu_free(pnts->sph, "pnts ordered spheres");
+    BU_PUT(pnts, struct pnts_specific);
+}
+
 /**
  * Export a pnts collection from the internal structure to the
  * database format
@@ -891,71 +1253,12 @@ rt_pnts_ifree(struct rt_db_internal *internal)
 void
 rt_pnts_print(register const struct soltab *stp)
 {
-    register struct rt_pnts_internal *pnts;
-
-    pnts = (struct rt_pnts_internal *)stp->st_specific;
-    RT_PNTS_CK_MAGIC(pnts);
-
-    switch (pnts->type) {
-	case RT_PNT_TYPE_PNT: {
-	    register struct pnt *point;
-	    for (BU_LIST_FOR(point, pnt, &(((struct pnt *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL: {
-	    register struct pnt_color *point;
-	    for (BU_LIST_FOR(point, pnt_color, &(((struct pnt_color *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_SCA: {
-	    register struct pnt_scale *point;
-	    for (BU_LIST_FOR(point, pnt_scale, &(((struct pnt_scale *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_NRM: {
-	    register struct pnt_normal *point;
-	    for (BU_LIST_FOR(point, pnt_normal, &(((struct pnt_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_SCA: {
-	    register struct pnt_color_scale *point;
-	    for (BU_LIST_FOR(point, pnt_color_scale, &(((struct pnt_color_scale *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_NRM: {
-	    register struct pnt_color_normal *point;
-	    for (BU_LIST_FOR(point, pnt_color_normal, &(((struct pnt_color_normal *)pnts->point)->l))) {
-	    }
+    register const struct pnts_specific *pnts =
+	(struct pnts_specific *)stp->st_specific;
 
-	    break;
-	}
-	case RT_PNT_TYPE_SCA_NRM: {
-	    register struct pnt_scale_normal *point;
-	    for (BU_LIST_FOR(point, pnt_scale_normal, &(((struct pnt_scale_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	case RT_PNT_TYPE_COL_SCA_NRM: {
-	    register struct pnt_color_scale_normal *point;
-	    for (BU_LIST_FOR(point, pnt_color_scale_normal, &(((struct pnt_color_scale_normal *)pnts->point)->l))) {
-	    }
-
-	    break;
-	}
-	default:
-	    bu_log("ERROR: unknown points primitive type (type=%d)\n", pnts->type);
-    }
+    if (!pnts)
+	return;
+    bu_log("%ld point spheres\n", pnts->count);
 }
 
 
@@ -43,6 +43,7 @@
 #include "raytrace.h"
 
 #include "../fixpt.h"
+#include "../../librt_private.h"
 
 
 /*
@@ -59,6 +60,9 @@ struct rt_vol_specific {
     mat_t vol_mat;	/* model to ideal space */
     vect_t vol_origin;	/* local coords of grid origin (0, 0, 0) for now */
     vect_t vol_large;	/* local coords of XYZ max */
+    uint32_t *vol_bricks;	/* per brick: EMPTY, FULL or index into vol_bits */
+    unsigned char *vol_bits;	/* VOL_BRICK_BYTES per mixed brick */
+    size_t vol_bdim[3];	/* bricks along XYZ */
 };
 #define VOL_NULL ((struct rt_vol_specific *)0)
 
@@ -118,6 +122,218 @@ extern int rt_binunif_describe(struct bu_vls  *str, const struct rt_db_internal
 
 static int rt_vol_normtab[3] = { NORM_XPOS, NORM_YPOS, NORM_ZPOS };
 
+/*
+ * Sparse brick storage.  At prep time the grid is split into
+ * VOL_BRICK^3 bricks.  Bricks whose voxels are all outside or all
+ * inside the lo..hi threshold are only flagged, and rt_vol_shot()
+ * crosses them in a single step.  Other bricks keep one bit per voxel,
+ * a byte per X row, so the byte-per-voxel map can be released.
+ * rt_vol_prep_dense() keeps the map and marches every voxel.
+ */
+#define VOL_BRICK_SHIFT 3
+#define VOL_BRICK (1<<VOL_BRICK_SHIFT)
+#define VOL_BRICK_BYTES (VOL_BRICK*VOL_BRICK)
+#define VOL_BRICK_EMPTY UINT32_MAX
+#define VOL_BRICK_FULL (UINT32_MAX-1)
+#define VOL_BRICK_OUTSIDE (UINT32_MAX-2)
+
+
+/* the brick holding a voxel, VOL_BRICK_OUTSIDE if off the grid */
+static inline uint32_t
+vol_brick_at(const struct rt_vol_specific *volp, const int *igrid)
+{
+    if (igrid[X] < 0 || igrid[Y] < 0 || igrid[Z] < 0
+	|| (size_t)igrid[X] >= volp->vol_i.xdim
+	|| (size_t)igrid[Y] >= volp->vol_i.ydim
+	|| (size_t)igrid[Z] >= volp->vol_i.zdim)
+	return VOL_BRICK_OUTSIDE;
+
+    return volp->vol_bricks[((igrid[Z] >> VOL_BRICK_SHIFT) * volp->vol_bdim[Y]
+			     + (igrid[Y] >> VOL_BRICK_SHIFT)) * volp->vol_bdim[X]
+			    + (igrid[X] >> VOL_BRICK_SHIFT)];
+}
+
+
+/* whether a voxel of a mixed brick is within the threshold */
+static inline int
+vol_brick_bit(const struct rt_vol_specific *volp, uint32_t brick, const int *igrid)
+{
+    const unsigned char *rows = volp->vol_bits + (size_t)brick * VOL_BRICK_BYTES;
+    int row = ((igrid[Z] & (VOL_BRICK-1)) << VOL_BRICK_SHIFT) | (igrid[Y] & (VOL_BRICK-1));
+
+    return (rows[row] >> (igrid[X] & (VOL_BRICK-1))) & 1;
+}
+
+
+/**
+ * Classify every brick of the stolen map and pack the mixed ones.
+ * Returns the number of bytes used.
+ */
+static size_t
+vol_bricks_build(struct rt_vol_specific *volp)
+{
+    struct rt_vol_internal *vip = &volp->vol_i;
+    unsigned char rows[VOL_BRICK_BYTES];
+    size_t nbricks, nmixed = 0, maxmixed = 64;
+    size_t bx, by, bz;
+    uint32_t *brick;
+
+    volp->vol_bdim[X] = (vip->xdim + VOL_BRICK - 1) >> VOL_BRICK_SHIFT;
+    volp->vol_bdim[Y] = (vip->ydim + VOL_BRICK - 1) >> VOL_BRICK_SHIFT;
+    volp->vol_bdim[Z] = (vip->zdim + VOL_BRICK - 1) >> VOL_BRICK_SHIFT;
+    nbricks = volp->vol_bdim[X] * volp->vol_bdim[Y] * volp->vol_bdim[Z];
+
+    volp->vol_bricks = (uint32_t *)bu_malloc(nbricks * sizeof(uint32_t), "vol bricks");
+    volp->vol_bits = (unsigned char *)bu_malloc(maxmixed * VOL_BRICK_BYTES, "vol brick bits");
+
+    brick = volp->vol_bricks;
+    for (bz = 0; bz < volp->vol_bdim[Z]; bz++) {
+	for (by = 0; by < volp->vol_bdim[Y]; by++) {
+	    for (bx = 0; bx < volp->vol_bdim[X]; bx++) {
+		size_t x, y, z;
+		size_t x0 = bx << VOL_BRICK_SHIFT;
+		size_t y0 = by << VOL_BRICK_SHIFT;
+		size_t z0 = bz << VOL_BRICK_SHIFT;
+		size_t x1 = FMIN(x0 + VOL_BRICK, vip->xdim);
+		size_t y1 = FMIN(y0 + VOL_BRICK, vip->ydim);
+		size_t z1 = FMIN(z0 + VOL_BRICK, vip->zdim);
+		size_t in = 0;
+
+		/* voxels past the end of the grid stay clear, they are
+		 * never visited inside the grid's bounds */
+		memset(rows, 0, sizeof(rows));
+		for (z = z0; z < z1; z++) {
+		    for (y = y0; y < y1; y++) {
+			unsigned char *row = &rows[((z - z0) << VOL_BRICK_SHIFT) | (y - y0)];
+			for (x = x0; x < x1; x++) {
+			    if (OK(vip, (size_t)VOL(vip, x, y, z))) {
+				*row |= 1 << (x - x0);
+				in++;
+			    }
+			}
+		    }
+		}
+
+		if (!in) {
+		    *brick++ = VOL_BRICK_EMPTY;
+		} else if (in == (x1 - x0) * (y1 - y0) * (z1 - z0)) {
+		    *brick++ = VOL_BRICK_FULL;
+		} else {
+		    if (nmixed == maxmixed) {
+			maxmixed *= 2;
+			volp->vol_bits = (unsigned char *)bu_realloc(volp->vol_bits, maxmixed * VOL_BRICK_BYTES, "vol brick bits");
+		    }
+		    memcpy(volp->vol_bits + nmixed * VOL_BRICK_BYTES, rows, VOL_BRICK_BYTES);
+		    *brick++ = (uint32_t)nmixed++;
+		}
+	    }
+	}
+    }
+
+    if (nmixed)
+	volp->vol_bits = (unsigned char *)bu_realloc(volp->vol_bits, nmixed * VOL_BRICK_BYTES, "vol brick bits");
+    else {
+	bu_free(volp->vol_bits, "vol brick bits");
+	volp->vol_bits = NULL;
+    }
+
+    return nbricks * sizeof(uint32_t) + nmixed * VOL_BRICK_BYTES;
+}
+
+
+/**
+ * Find where the ray leaves the run of bricks, starting with the one
+ * holding igrid, that all share the uniform state brick, and on which
+ * axis.  last[] gets a voxel in the final brick of the run, and bexit[]
+ * the grid plane index of that brick's exit on each axis.
+ */
+static double
+vol_brick_exit(const struct rt_vol_specific *volp, const struct xray *rp, const vect_t invdir, uint32_t brick, const int *igrid, int *out_axis, int *last, int *bexit)
+{
+    const size_t dim[3] = {volp->vol_i.xdim, volp->vol_i.ydim, volp->vol_i.zdim};
+    vect_t tb;
+    int i;
+
+    VMOVE(last, igrid);
+    for (i = X; i <= Z; i++) {
+	int b0 = igrid[i] & ~(VOL_BRICK-1);
+
+	if (ZERO(rp->r_dir[i])) {
+	    tb[i] = INFINITY;
+	    continue;
+	}
+	if (rp->r_dir[i] > 0)
+	    bexit[i] = (int)FMIN((size_t)b0 + VOL_BRICK, dim[i]);
+	else
+	    bexit[i] = b0;
+	tb[i] = (volp->vol_origin[i] + bexit[i]*volp->vol_i.cellsize[i] - rp->r_pt[i]) * invdir[i];
+    }
+
+    while (1) {
+	int next[3];
+
+	i = (tb[X] < tb[Y]) ? ((tb[Z] < tb[X]) ? Z : X) : ((tb[Z] < tb[Y]) ? Z : Y);
+
+	/* continue into the neighbor if it is in the same state */
+	VMOVE(next, last);
+	next[i] = (rp->r_dir[i] > 0) ? bexit[i] : bexit[i] - 1;
+	if (vol_brick_at(volp, next) != brick)
+	    break;
+
+	last[i] = next[i];
+	if (rp->r_dir[i] > 0)
+	    bexit[i] = (int)FMIN((size_t)bexit[i] + VOL_BRICK, dim[i]);
+	else
+	    bexit[i] -= VOL_BRICK;
+	tb[i] = (volp->vol_origin[i] + bexit[i]*volp->vol_i.cellsize[i] - rp->r_pt[i]) * invdir[i];
+    }
+
+    *out_axis = i;
+    return tb[i];
+}
+
+
+/**
+ * Restart the voxel march at t1, where the ray leaves the uniform brick
+ * holding last[] across out_axis.  Along the other axes it is still
+ * within that brick.
+ */
+static void
+vol_brick_step(const struct rt_vol_specific *volp, const struct xray *rp, const vect_t invdir, const vect_t delta, double t1, int out_axis, const int *last, const int *bexit, int *igrid, vect_t t)
+{
+    const size_t dim[3] = {volp->vol_i.xdim, volp->vol_i.ydim, volp->vol_i.zdim};
+    int i;
+
+    for (i = X; i <= Z; i++) {
+	int j, lo, hi;
+
+	if (ZERO(rp->r_dir[i]))
+	    continue;
+
+	if (i == out_axis) {
+	    igrid[i] = (rp->r_dir[i] > 0) ? bexit[i] : bexit[i] - 1;
+	    j = (rp->r_dir[i] > 0) ? igrid[i] + 1 : igrid[i];
+	    t[i] = (volp->vol_origin[i] + j*volp->vol_i.cellsize[i] - rp->r_pt[i]) * invdir[i];
+	    continue;
+	}
+
+	lo = last[i] & ~(VOL_BRICK-1);
+	hi = (int)FMIN((size_t)lo + VOL_BRICK, dim[i]) - 1;
+	j = (int)floor((rp->r_pt[i] + t1*rp->r_dir[i] - volp->vol_origin[i]) / volp->vol_i.cellsize[i]);
+	CLAMP(j, lo, hi);
+	t[i] = (volp->vol_origin[i] + (j + (rp->r_dir[i] > 0))*volp->vol_i.cellsize[i] - rp->r_pt[i]) * invdir[i];
+
+	/* the cell is found from a rounded point, make sure its exit is
+	 * still ahead */
+	while (t[i] < t1 && ((rp->r_dir[i] > 0) ? j < hi : j > lo)) {
+	    j += (rp->r_dir[i] > 0) ? 1 : -1;
+	    t[i] += delta[i];
+	}
+	igrid[i] = j;
+    }
+}
+
+
 /**
  * Transform the ray into local coordinates of the volume ("ideal space").
  * Step through the 3-D array, in local coordinates.
@@ -303,39 +519,58 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 
     while (t0 < tmax) {
 	int val;
+	int bexit[3], last[3];
+	uint32_t brick = VOL_BRICK_OUTSIDE;
 	struct seg *segp;
 
-	/* find minimum exit t value */
-	if (t[X] < t[Y]) {
-	    if (t[Z] < t[X]) {
-		out_axis = Z;
-		t1 = t[Z];
-	    } else {
-		out_axis = X;
-		t1 = t[X];
-	    }
+	if (volp->vol_bricks)
+	    brick = vol_brick_at(volp, igrid);
+
+	if (brick == VOL_BRICK_EMPTY || brick == VOL_BRICK_FULL) {
+	    /* Ray passes through uniform bricks, step across them */
+	    t1 = vol_brick_exit(volp, rp, invdir, brick, igrid, &out_axis, last, bexit);
+	    val = (brick == VOL_BRICK_FULL);
+	    if (RT_G_DEBUG&RT_DEBUG_VOL)bu_log("brick at [%d %d %d] from %g to %g, full=%d\n",
+					    igrid[X], igrid[Y], igrid[Z],
+					    t0, t1, val);
 	} else {
-	    if (t[Z] < t[Y]) {
-		out_axis = Z;
-		t1 = t[Z];
+	    /* find minimum exit t value */
+	    if (t[X] < t[Y]) {
+		if (t[Z] < t[X]) {
+		    out_axis = Z;
+		    t1 = t[Z];
+		} else {
+		    out_axis = X;
+		    t1 = t[X];
+		}
 	    } else {
-		out_axis = Y;
-		t1 = t[Y];
+		if (t[Z] < t[Y]) {
+		    out_axis = Z;
+		    t1 = t[Z];
+		} else {
+		    out_axis = Y;
+		    t1 = t[Y];
+		}
 	    }
-	}
 
-	/* Ray passes through cell igrid[XY] from t0 to t1 */
-	val = VOL(&volp->vol_i, igrid[X], igrid[Y], igrid[Z]);
-	if (RT_G_DEBUG&RT_DEBUG_VOL)bu_log("igrid [%d %d %d] from %g to %g, val=%d\n",
-					igrid[X], igrid[Y], igrid[Z],
-					t0, t1, val);
+	    /* Ray passes through cell igrid[XY] from t0 to t1 */
+	    if (!volp->vol_bricks)
+		val = OK(&volp->vol_i, (size_t)VOL(&volp->vol_i, igrid[X], igrid[Y], igrid[Z]));
+	    else if (brick == VOL_BRICK_OUTSIDE)
+		val = 0;
+	    else
+		val = vol_brick_bit(volp, brick, igrid);
+	    if (RT_G_DEBUG&RT_DEBUG_VOL)bu_log("igrid [%d %d %d] from %g to %g, in=%d\n",
+					    igrid[X], igrid[Y], igrid[Z],
+					    t0, t1, val);
+	}
 	if (RT_G_DEBUG&RT_DEBUG_VOL)bu_log("Exit axis is %s, t[]=(%g, %g, %g)\n",
 					out_axis==X ? "X" : (out_axis==Y?"Y":"Z"),
 					t[X], t[Y], t[Z]);
 
 	if (t1 <= t0) bu_log("ERROR vol t1=%g < t0=%g\n", t1, t0);
 	if (!inside) {
-	    if (OK(&volp->vol_i, (size_t)val)) {
+	    if (val) {
 		/* Handle the transition from vacuum to solid */
 		/* Start of segment (entering a full voxel) */
 		inside = 1;
@@ -361,7 +596,7 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 		/* Do nothing, marching through void */
 	    }
 	} else {
-	    if (OK(&volp->vol_i, (size_t)val)) {
+	    if (val) {
 		/* Do nothing, marching through solid */
 	    } else {
 		register struct seg *tail;
@@ -390,6 +625,10 @@ rt_vol_shot(struct soltab *stp, register struct xray *rp, struct application *ap
 	/* Take next step */
 	t0 = t1;
 	in_axis = out_axis;
+	if (brick == VOL_BRICK_EMPTY || brick == VOL_BRICK_FULL) {
+	    vol_brick_step(volp, rp, invdir, delta, t1, out_axis, last, bexit, igrid, t);
+	    continue;
+	}
 	t[out_axis] += delta[out_axis];
 	if (rp->r_dir[out_axis] > 0) {
 	    igrid[out_axis]++;
@@ -986,8 +1225,8 @@ rt_vol_bbox(struct rt_db_internal *ip, point_t *min, point_t *max, const struct
  * A struct rt_vol_specific is created, and its address is stored
  * in stp->st_specific for use by rt_vol_shot().
  */
-int
-rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+static int
+vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip, int dense)
 {
     struct rt_vol_internal *vip;
     register struct rt_vol_specific *volp;
@@ -1005,6 +1244,20 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
     BU_GET(volp, struct rt_vol_specific);
     volp->vol_i = *vip;		/* struct copy */
     vip->map = (unsigned char *)0;	/* "steal" the bitmap storage */
+    volp->vol_bricks = NULL;
+    volp->vol_bits = NULL;
+
+    /* pack the map into bricks and release it, unless asked to keep
+     * marching the dense map */
+    if (volp->vol_i.map && !dense) {
+	size_t mapbytes = (size_t)(vip->xdim+VOL_XWIDEN*2)*(vip->ydim+VOL_YWIDEN*2)*(vip->zdim+VOL_ZWIDEN*2);
+	size_t brickbytes = vol_bricks_build(volp);
+
+	if (RT_G_DEBUG&RT_DEBUG_VOL)
+	    bu_log("vol %s: %zu bytes of bricks replace a %zu byte map\n", stp->st_name, brickbytes, mapbytes);
+	bu_free((char *)volp->vol_i.map, "vol_map");
+	volp->vol_i.map = NULL;
+    }
 
     /* build Xform matrix from model(world) to ideal(local) space */
     bn_mat_inv(volp->vol_mat, vip->mat);
@@ -1037,6 +1290,20 @@ rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
 }
 
 
+int
+rt_vol_prep(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return vol_prep(stp, ip, rtip, 0);
+}
+
+
+int
+rt_vol_prep_dense(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    return vol_prep(stp, ip, rtip, 1);
+}
+
+
 void
 rt_vol_print(register const struct soltab *stp)
 {
@@ -1141,6 +1408,10 @@ rt_vol_free(struct soltab *stp)
 	bu_free((char *)volp->vol_i.map, "vol_map");
 	volp->vol_i.map = NULL; /* sanity */
     }
+    if (volp->vol_bricks)
+	bu_free(volp->vol_bricks, "vol bricks");
+    if (volp->vol_bits)
+	bu_free(volp->vol_bits, "vol brick bits");
     BU_PUT(volp, struct rt_vol_specific);
 }
 
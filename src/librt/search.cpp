@@ -84,6 +84,8 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <string.h>
 #include <stdlib.h>
@@ -148,6 +150,7 @@ struct list_client_data_t {
     struct db_i *dbip;
     struct bu_ptbl *full_paths;
     int flags;
+    struct resource *resp;
 };
 
 
@@ -252,7 +255,7 @@ db_fullpath_list(struct db_full_path *path, void *client_data)
 	struct rt_db_internal in;
 	struct rt_comb_internal *comb;
 
-	if (rt_db_get_internal(&in, dp, lcd->dbip, NULL, &rt_uniresource) < 0)
+	if (rt_db_get_internal(&in, dp, lcd->dbip, NULL, lcd->resp) < 0)
 	    return;
 
 	std::unordered_map<std::string, int> c_inst_map;
@@ -377,6 +380,7 @@ f_below(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, st
     db_dup_full_path(&parent_path, db_node->path);
     DB_FULL_PATH_POP(&parent_path);
     curr_node.path = &parent_path;
+    curr_node.resp = db_node->resp;
     distance = db_node->path->fp_len - parent_path.fp_len;
 
     while ((parent_path.fp_len > 0) && (state == 0) && !(db_node->flags & DB_SEARCH_FLAT)) {
@@ -430,6 +434,7 @@ f_above(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, st
 		curr_node.path = this_path;
 		curr_node.flags = db_node->flags;
 		curr_node.full_paths = full_paths;
+		curr_node.resp = db_node->resp;
 
 		state = find_execute_nested_plans(dbip, NULL, &curr_node, plan->p_un._bl_data[0]);
 		if (state)
@@ -684,93 +689,192 @@ string_to_name_and_val(const char *in, struct bu_vls *name, struct bu_vls *value
 }
 
 
+/* An -attr or -param filter, parsed once when the plan is formed
+ * rather than every time it is evaluated.
+ *
+ * Check for unescaped >, < or = characters.  If present, the attribute
+ * must not only be present but the value assigned to the attribute
+ * must satisfy the logical expression.  In the case where a > or < is
+ * used with a string argument the behavior will follow ASCII
+ * lexicographical order.  In the case of equality between strings,
+ * bu_path_match() is used to support pattern matching.
+ */
+struct db_search_attr {
+    struct bu_vls name;
+    struct bu_vls value;
+    int checkval;		/* 0 for presence, else as string_to_name_and_val() */
+    int strcomparison;		/* value is not all digits, compare as strings */
+    int numok;			/* value converted to num */
+    long num;
+
+    /* An attribute name without pattern characters can be looked up
+     * in the database's attribute index, once for the whole search.
+     * matches holds the objects that pass, for dbip as of gen. */
+    int exact;
+    struct db_i *dbip;
+    unsigned long gen;
+    std::unordered_set<struct directory *> *matches;
+};
+
+
+static struct db_search_attr *
+attr_compile(const char *pattern)
+{
+    struct db_search_attr *a;
+    const char *cp;
+    char *endp = NULL;
+    size_t i;
+
+    BU_GET(a, struct db_search_attr);
+    BU_VLS_INIT(&a->name);
+    BU_VLS_INIT(&a->value);
+    a->checkval = string_to_name_and_val(pattern, &a->name, &a->value);
+
+    /* Now that we have the value, check to see if it is all numbers.
+     * If so, use numerical comparison logic - otherwise use string
+     * logic.
+     */
+    a->strcomparison = 0;
+    for (i = 0; i < bu_vls_strlen(&a->value); i++) {
+	if (!(isdigit((int)(bu_vls_addr(&a->value)[i])))) {
+	    a->strcomparison = 1;
+	}
+    }
+    a->num = strtol(bu_vls_addr(&a->value), &endp, 10);
+    a->numok = (endp != bu_vls_addr(&a->value));
+
+    a->exact = 1;
+    for (cp = bu_vls_addr(&a->name); *cp; cp++) {
+	if (*cp == '*' || *cp == '?' || *cp == '[' || *cp == '\\') {
+	    a->exact = 0;
+	    break;
+	}
+    }
+    a->dbip = NULL;
+    a->gen = 0;
+    a->matches = NULL;
+
+    return a;
+}
+
+
+static void
+attr_free(struct db_search_attr *a)
+{
+    if (!a)
+	return;
+    bu_vls_free(&a->name);
+    bu_vls_free(&a->value);
+    delete a->matches;
+    BU_PUT(a, struct db_search_attr);
+}
+
+
+/* Whether an attribute value satisfies the filter's expression */
+static int
+attr_value_check(const struct db_search_attr *a, const char *avpp_value)
+{
+    const char *value = bu_vls_addr(&a->value);
+
+    if (a->checkval < 1)
+	return 1;
+
+    /* String based comparisons */
+    if (a->strcomparison == 1) {
+	switch (a->checkval) {
+	    case 1:
+		return !bu_path_match(value, avpp_value, 0);
+	    case 2:
+		return (bu_strcmp(value, avpp_value) < 0);
+	    case 3:
+		return (bu_strcmp(value, avpp_value) > 0);
+	    case 4:
+		return (!bu_path_match(value, avpp_value, 0)) || (bu_strcmp(value, avpp_value) < 0);
+	    case 5:
+		return (!bu_path_match(value, avpp_value, 0)) || (bu_strcmp(value, avpp_value) > 0);
+	    default:
+		return 0;
+	}
+    }
+
+    /* Numerical Comparisons */
+    if (a->checkval <= 5) {
+	char *avpp_val_buf = NULL;
+	const long avpp_val_conv = strtol(avpp_value, &avpp_val_buf, 10);
+
+	/* string did not convert to long */
+	if (!a->numok || avpp_value == avpp_val_buf)
+	    return 0;
+
+	if ((a->checkval == 1) && (a->num == avpp_val_conv))
+	    return 1;
+	if ((a->checkval == 2) && (a->num < avpp_val_conv))
+	    return 1;
+	if ((a->checkval == 3) && (a->num > avpp_val_conv))
+	    return 1;
+	if ((a->checkval == 4) && (a->num <= avpp_val_conv))
+	    return 1;
+	if ((a->checkval == 5) && (a->num >= avpp_val_conv))
+	    return 1;
+    }
+    return 0;
+}
+
+
+static int
+attr_index_match(const char *value, void *data)
+{
+    return attr_value_check((const struct db_search_attr *)data, value);
+}
+
+
 /* Check all attributes for a match to the requested attribute.
- * If an expression was supplied, check the value of any matches
- * to the attribute name in the logical expression before
+ * If an expression was supplied, check the value of the first
+ * match to the attribute name in the logical expression before
  * returning success
  */
 static int
-avs_check(const char *keystr, const char *value, int checkval, int strcomparison, struct bu_attribute_value_set *avs)
+avs_check(const struct db_search_attr *a, struct bu_attribute_value_set *avs)
 {
     struct bu_attribute_value_pair *avpp;
 
     for (BU_AVS_FOR(avpp, avs)) {
-	if (!bu_path_match(keystr, avpp->name, 0)) {
-	    if (checkval >= 1) {
+	if (!bu_path_match(bu_vls_addr(&a->name), avpp->name, 0))
+	    return attr_value_check(a, avpp->value);
+    }
+    return 0;
+}
 
-		/* String based comparisons */
-		if ((checkval == 1) && (strcomparison == 1)) {
-		    if (!bu_path_match(value, avpp->value, 0)) {
-			return 1;
-		    } else {
-			return 0;
-		    }
-		}
-		if ((checkval == 2) && (strcomparison == 1)) {
-		    if (bu_strcmp(value, avpp->value) < 0) {
-			return 1;
-		    } else {
-			return 0;
-		    }
-		}
-		if ((checkval == 3) && (strcomparison == 1)) {
-		    if (bu_strcmp(value, avpp->value) > 0) {
-			return 1;
-		    } else {
-			return 0;
-		    }
-		}
-		if ((checkval == 4) && (strcomparison == 1)) {
-		    if ((!bu_path_match(value, avpp->value, 0)) || (bu_strcmp(value, avpp->value) < 0)) {
-			return 1;
-		    } else {
-			return 0;
-		    }
-		}
-		if ((checkval == 5) && (strcomparison == 1)) {
-		    if ((!bu_path_match(value, avpp->value, 0)) || (bu_strcmp(value, avpp->value) > 0)) {
-			return 1;
-		    } else {
-			return 0;
-		    }
-		}
 
+/* Gather the objects passing an exactly named -attr filter from the
+ * attribute index, if there is one, returning whether it could */
+static int
+attr_indexed(struct db_search_attr *a, struct db_i *dbip)
+{
+    struct bu_ptbl objs = BU_PTBL_INIT_ZERO;
+    size_t i;
 
-		/* Numerical Comparisons */
-		if (strcomparison == 0 && checkval <= 5) {
-		    char* val_buf = NULL;
-		    char* avpp_val_buf = NULL;
-
-		    const long val_conv = strtol(value, &val_buf, 10);
-		    const long avpp_val_conv = strtol(avpp->value, &avpp_val_buf, 10);
-
-		    /* error checking */
-		    if (value == val_buf || avpp->value == avpp_val_buf)
-			return 0;   /* string did not convert to long */
-		    if (val_conv > LONG_MAX || 
-			val_conv < LONG_MIN || 
-			avpp_val_conv < LONG_MIN || 
-			avpp_val_conv > LONG_MAX)
-			return 0;   /* conversion is out of range for long */
-
-		    if ((checkval == 1) && (val_conv == avpp_val_conv))
-			return 1;
-		    if ((checkval == 2) && (val_conv < avpp_val_conv))
-			return 1;
-		    if ((checkval == 3) && (val_conv > avpp_val_conv))
-			return 1;
-		    if ((checkval == 4) && (val_conv <= avpp_val_conv))
-			return 1;
-		    if ((checkval == 5) && (val_conv >= avpp_val_conv))
-			return 1;
-		}
-		return 0;
-	    } else {
-		return 1;
-	    }
-	}
+    if (!a->exact || !dbip->i)
+	return 0;
+    if (a->matches && a->dbip == dbip && a->gen == dbip->i->attr_index_gen)
+	return 1;
+
+    bu_ptbl_init(&objs, 64, "attr matches");
+    if (db_attr_index_find(&objs, dbip, bu_vls_addr(&a->name), attr_index_match, (void *)a) < 0) {
+	bu_ptbl_free(&objs);
+	a->exact = 0;
+	return 0;
     }
-    return 0;
+    if (!a->matches)
+	a->matches = new std::unordered_set<struct directory *>;
+    a->matches->clear();
+    for (i = 0; i < BU_PTBL_LEN(&objs); i++)
+	a->matches->insert((struct directory *)BU_PTBL_GET(&objs, i));
+    bu_ptbl_free(&objs);
+
+    a->dbip = dbip;
+    a->gen = dbip->i->attr_index_gen;
+    return 1;
 }
 
 
@@ -783,39 +887,12 @@ avs_check(const char *keystr, const char *value, int checkval, int strcomparison
 static int
 f_objparam(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, struct bu_ptbl *UNUSED(results))
 {
-    struct bu_vls paramname = BU_VLS_INIT_ZERO;
-    struct bu_vls value = BU_VLS_INIT_ZERO;
     struct bu_vls s_tcl = BU_VLS_INIT_ZERO;
     struct rt_db_internal in;
     struct bu_attribute_value_set avs;
-    int checkval = 0;
-    int strcomparison = 0;
-    size_t i;
     struct directory *dp;
     int ret = 0;
 
-    /* Check for unescaped >, < or = characters.  If present, the
-     * attribute must not only be present but the value assigned to
-     * the attribute must satisfy the logical expression.  In the case
-     * where a > or < is used with a string argument the behavior will
-     * follow ASCII lexicographical order.  In the case of equality
-     * between strings, bu_path_match() is used to support pattern
-     * matching.
-     */
-
-    checkval = string_to_name_and_val(plan->p_un._attr_data, &paramname, &value);
-
-    /* Now that we have the value, check to see if it is all numbers.
-     * If so, use numerical comparison logic - otherwise use string
-     * logic.
-     */
-
-    for (i = 0; i < strlen(bu_vls_addr(&value)); i++) {
-	if (!(isdigit((int)(bu_vls_addr(&value)[i])))) {
-	    strcomparison = 1;
-	}
-    }
-
     /* Get parameters for object as an avs.
      */
 
@@ -826,7 +903,7 @@ f_objparam(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip,
     }
 
     RT_DB_INTERNAL_INIT(&in);
-    if (rt_db_get_internal(&in, dp, dbip, (fastf_t *)NULL, &rt_uniresource) < 0) {
+    if (rt_db_get_internal(&in, dp, dbip, (fastf_t *)NULL, db_node->resp) < 0) {
 	rt_db_free_internal(&in);
 	db_node->matched_filters = 0;
 	return 0;
@@ -848,10 +925,9 @@ f_objparam(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip,
 	return 0;
     }
 
-    ret = avs_check(bu_vls_addr(&paramname), bu_vls_addr(&value), checkval, strcomparison, &avs);
+    ret = avs_check(plan->p_un._attr_comp, &avs);
     bu_avs_free(&avs);
-    bu_vls_free(&paramname);
-    bu_vls_free(&value);
+    bu_vls_free(&s_tcl);
     if (!ret)
 	db_node->matched_filters = 0;
     return ret;
@@ -864,7 +940,7 @@ c_objparam(char *pattern, char ***UNUSED(ignored), int UNUSED(unused), struct db
     struct db_plan_t *newplan;
 
     newplan = palloc(N_ATTR, f_objparam, tbl);
-    newplan->p_un._attr_data = pattern;
+    newplan->p_un._attr_comp = attr_compile(pattern);
     (*resultplan) = newplan;
 
     return BRLCAD_OK;
@@ -880,57 +956,32 @@ c_objparam(char *pattern, char ***UNUSED(ignored), int UNUSED(unused), struct db
 static int
 f_attr(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, struct bu_ptbl *UNUSED(results))
 {
-    struct bu_vls attribname = BU_VLS_INIT_ZERO;
-    struct bu_vls value = BU_VLS_INIT_ZERO;
+    struct db_search_attr *a = plan->p_un._attr_comp;
     struct bu_attribute_value_set avs;
-    int checkval = 0;
-    int strcomparison = 0;
-    size_t i;
     struct directory *dp;
     int ret = 0;
 
-    /* Check for unescaped >, < or = characters.  If present, the
-     * attribute must not only be present but the value assigned to
-     * the attribute must satisfy the logical expression.  In the case
-     * where a > or < is used with a string argument the behavior will
-     * follow ASCII lexicographical order.  In the case of equality
-     * between strings, bu_path_match() is used to support pattern
-     * matching.
-     */
-
-    checkval = string_to_name_and_val(plan->p_un._attr_data, &attribname, &value);
-
-    /* Now that we have the value, check to see if it is all numbers.
-     * If so, use numerical comparison logic - otherwise use string
-     * logic.
-     */
-
-    for (i = 0; i < strlen(bu_vls_addr(&value)); i++) {
-	if (!(isdigit((int)(bu_vls_addr(&value)[i])))) {
-	    strcomparison = 1;
-	}
-    }
-
-    /* Get attributes for object.
-     */
-
     dp = DB_FULL_PATH_CUR_DIR(db_node->path);
     if (!dp) {
 	db_node->matched_filters = 0;
 	return 0;
     }
 
-    bu_avs_init_empty(&avs);
-    if (db5_get_attributes(dbip, &avs, dp) < 0) {
+    if (attr_indexed(a, dbip)) {
+	ret = (a->matches->find(dp) != a->matches->end());
+    } else {
+	/* Get attributes for object.
+	 */
+	bu_avs_init_empty(&avs);
+	if (db5_get_attributes(dbip, &avs, dp) < 0) {
+	    bu_avs_free(&avs);
+	    db_node->matched_filters = 0;
+	    return 0;
+	}
+	ret = avs_check(a, &avs);
 	bu_avs_free(&avs);
-	db_node->matched_filters = 0;
-	return 0;
     }
 
-    ret = avs_check(bu_vls_addr(&attribname), bu_vls_addr(&value), checkval, strcomparison, &avs);
-    bu_avs_free(&avs);
-    bu_vls_free(&attribname);
-    bu_vls_free(&value);
     if (!ret)
 	db_node->matched_filters = 0;
     return ret;
@@ -943,7 +994,7 @@ c_attr(char *pattern, char ***UNUSED(ignored), int UNUSED(unused), struct db_pla
     struct db_plan_t *newplan;
 
     newplan = palloc(N_ATTR, f_attr, tbl);
-    newplan->p_un._attr_data = pattern;
+    newplan->p_un._attr_comp = attr_compile(pattern);
     (*resultplan) = newplan;
     return BRLCAD_OK;
 }
@@ -1066,7 +1117,7 @@ f_type(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, str
 
     }
 
-    if (rt_db_get_internal(&intern, dp, dbip, (fastf_t *)NULL, &rt_uniresource) < 0)
+    if (rt_db_get_internal(&intern, dp, dbip, (fastf_t *)NULL, db_node->resp) < 0)
 	return 0;
     if (intern.idb_major_type != DB5_MAJORTYPE_BRLCAD) {
 	rt_db_free_internal(&intern);
@@ -1655,7 +1706,7 @@ f_matrix(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, s
 
 	if (dp->d_flags & RT_DIR_COMB) {
 	    struct rt_db_internal intern;
-	    if (rt_db_get_internal(&intern, dp, dbip, (fastf_t *)NULL, &rt_uniresource) > 0) {
+	    if (rt_db_get_internal(&intern, dp, dbip, (fastf_t *)NULL, db_node->resp) > 0) {
 		struct rt_comb_internal *comb = (struct rt_comb_internal *)intern.idb_ptr;
 		if (comb->tree != NULL) {
 		    child_matrix(comb->tree, cdp->d_namep, &mat);
@@ -1752,7 +1803,7 @@ f_nnodes(struct db_plan_t *plan, struct db_node_t *db_node, struct db_i *dbip, s
     }
 
     if (dp->d_flags & RT_DIR_COMB) {
-	rt_db_get_internal(&in, dp, dbip, (fastf_t *)NULL, &rt_uniresource);
+	rt_db_get_internal(&in, dp, dbip, (fastf_t *)NULL, db_node->resp);
 	comb = (struct rt_comb_internal *)in.idb_ptr;
 	if (comb->tree == NULL) {
 	    node_count = 0;
@@ -2535,6 +2586,9 @@ db_search_free_plan(struct db_plan_t *splan)
 	    if (N_EXEC == p->type) {
 		free_exec_plan(p);
 	    }
+	    if (N_ATTR == p->type) {
+		attr_free(p->p_un._attr_comp);
+	    }
 	    BU_PUT(p, struct db_plan_t);
 	}
     } else {
@@ -2544,6 +2598,9 @@ db_search_free_plan(struct db_plan_t *splan)
 	    if (N_EXEC == p->type) {
 		free_exec_plan(p);
 	    }
+	    if (N_ATTR == p->type) {
+		attr_free(p->p_un._attr_comp);
+	    }
 	    BU_PUT(p, struct db_plan_t);
 	    p = plan;
 	}
@@ -2568,8 +2625,244 @@ db_search_free(struct bu_ptbl *search_results)
 }
 
 
-int
-db_search(struct bu_ptbl *search_results,
+/* Paths are listed in parallel a top level subtree at a time, and
+ * evaluated SEARCH_CHUNK at a time once there are enough of them. */
+#define SEARCH_CHUNK 1024
+#define SEARCH_PARALLEL_MIN 4096
+
+/* The paths of one search start or one of its immediate children, in
+ * the order a serial walk would list them */
+struct search_unit {
+    struct db_full_path *path;	/* listed first, then what is below it */
+    int descend;
+    struct bu_ptbl paths;
+};
+
+struct search_state {
+    struct db_i *dbip;
+    int flags;
+    struct db_plan_t *plan;
+
+    struct search_unit *units;
+    size_t nunits;
+
+    /* every path to evaluate, and what is under evaluation: the paths
+     * themselves, or with dedupe one representative path per object */
+    struct bu_ptbl *full_paths;
+    struct db_full_path **evals;
+    size_t nevals;
+    int dedupe;
+
+    int have_results;		/* whether there is a results table to fill */
+    struct bu_ptbl *chunk_results;	/* f_print output of each chunk */
+    int *matched;		/* per evaluated path */
+    size_t *printed;		/* with dedupe, -print hits per object */
+
+    size_t next;
+    int pass;
+};
+
+
+/* Filters that look at more than the object at the end of the path:
+ * its place in the hierarchy, the path string, or a caller's -exec */
+static int
+search_path_dependent(struct bu_ptbl *plans)
+{
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(plans); i++) {
+	struct db_plan_t *p = (struct db_plan_t *)BU_PTBL_GET(plans, i);
+	switch (p->type) {
+	    case N_ABOVE:
+	    case N_BELOW:
+	    case N_BOOL:
+	    case N_DEPTH:
+	    case N_EXEC:
+	    case N_EXECDIR:
+	    case N_IREGEX:
+	    case N_MATRIX:
+	    case N_MAXDEPTH:
+	    case N_MINDEPTH:
+	    case N_OK:
+	    case N_PATH:
+	    case N_REGEX:
+		return 1;
+	    default:
+		break;
+	}
+    }
+    return 0;
+}
+
+
+static int
+search_has_exec(struct bu_ptbl *plans)
+{
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(plans); i++) {
+	struct db_plan_t *p = (struct db_plan_t *)BU_PTBL_GET(plans, i);
+	if (p->type == N_EXEC || p->type == N_EXECDIR || p->type == N_OK)
+	    return 1;
+    }
+    return 0;
+}
+
+
+/* Look up indexed -attr filters up front, so the threads only read
+ * the plan */
+static void
+search_prepare_plans(struct bu_ptbl *plans, struct db_i *dbip)
+{
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(plans); i++) {
+	struct db_plan_t *p = (struct db_plan_t *)BU_PTBL_GET(plans, i);
+	if (p->eval == f_attr)
+	    (void)attr_indexed(p->p_un._attr_comp, dbip);
+    }
+}
+
+
+/* traverse_func for listing only the immediate children of a path */
+static void
+search_list_none(struct db_full_path *UNUSED(path), void *UNUSED(client_data))
+{
+}
+
+
+/* Split the search below start_path into units: start_path itself,
+ * then a unit for each of its immediate children and their subtrees */
+static void
+search_add_units(std::vector<struct search_unit> &units, struct db_full_path *start_path, struct db_i *dbip, int flags)
+{
+    struct directory *dp = DB_FULL_PATH_CUR_DIR(start_path);
+    struct search_unit u;
+
+    u.path = start_path;
+    u.descend = 0;
+    units.push_back(u);
+
+    if (!dp || (flags & DB_SEARCH_FLAT) || !(dp->d_flags & RT_DIR_COMB))
+	return;
+
+    struct rt_db_internal in;
+    if (rt_db_get_internal(&in, dp, dbip, NULL, &rt_uniresource) < 0)
+	return;
+
+    struct bu_ptbl children = BU_PTBL_INIT_ZERO;
+    struct list_client_data_t lcd;
+    std::unordered_map<std::string, int> c_inst_map;
+    struct rt_comb_internal *comb = (struct rt_comb_internal *)in.idb_ptr;
+
+    bu_ptbl_init(&children, 8, "search children");
+    lcd.dbip = dbip;
+    lcd.full_paths = &children;
+    lcd.flags = flags;
+    lcd.resp = &rt_uniresource;
+    db_fullpath_list_subtree(start_path, OP_UNION, comb->tree, search_list_none, &c_inst_map, &lcd);
+    rt_db_free_internal(&in);
+
+    for (size_t i = 0; i < BU_PTBL_LEN(&children); i++) {
+	u.path = (struct db_full_path *)BU_PTBL_GET(&children, i);
+	/* cyclic paths were already reported while listing them */
+	u.descend = !db_full_path_cyclic(u.path, NULL, 0);
+	units.push_back(u);
+    }
+    bu_ptbl_free(&children);
+}
+
+
+static void
+search_worker(int cpu, void *data)
+{
+    struct search_state *st = (struct search_state *)data;
+    struct resource *resp;
+
+    struct bu_ptbl scratch = BU_PTBL_INIT_ZERO;
+
+    BU_GET(resp, struct resource);
+    rt_init_resource(resp, cpu, NULL);
+    bu_ptbl_init(&scratch, 8, "search scratch results");
+
+    while (1) {
+	size_t i, s, e, n;
+
+	n = (st->pass == 0) ? st->nunits : st->nevals;
+	bu_semaphore_acquire(BU_SEM_GENERAL);
+	s = st->next;
+	st->next += (st->pass == 0) ? 1 : SEARCH_CHUNK;
+	bu_semaphore_release(BU_SEM_GENERAL);
+	if (s >= n)
+	    break;
+
+	if (st->pass == 0) {
+	    /* list the paths of one unit */
+	    struct search_unit *u = &st->units[s];
+	    struct list_client_data_t lcd;
+
+	    bu_ptbl_ins(&u->paths, (long *)u->path);
+	    if (u->descend) {
+		lcd.dbip = st->dbip;
+		lcd.full_paths = &u->paths;
+		lcd.flags = st->flags;
+		lcd.resp = resp;
+		db_fullpath_list(u->path, (void *)&lcd);
+	    }
+	    continue;
+	}
+
+	/* evaluate one chunk of paths.  With dedupe, -print output goes
+	 * to scratch and is only counted, it is written out per path
+	 * once all the objects are done */
+	struct bu_ptbl *results = NULL;
+	if (st->have_results)
+	    results = (st->dedupe) ? &scratch : &st->chunk_results[s / SEARCH_CHUNK];
+	e = (s + SEARCH_CHUNK < n) ? s + SEARCH_CHUNK : n;
+	for (i = s; i < e; i++) {
+	    struct db_node_t curr_node;
+
+	    /* by convention, a top level node is "unioned" into the global database */
+	    curr_node.path = st->evals[i];
+	    curr_node.full_paths = (st->flags & DB_SEARCH_FLAT) ? NULL : st->full_paths;
+	    curr_node.flags = st->flags;
+	    curr_node.matched_filters = 1;
+	    curr_node.resp = resp;
+	    find_execute_plans(st->dbip, results, &curr_node, st->plan);
+	    st->matched[i] = curr_node.matched_filters;
+
+	    if (st->dedupe && results) {
+		st->printed[i] = BU_PTBL_LEN(results);
+		if (!(st->flags & DB_SEARCH_RETURN_UNIQ_DP)) {
+		    for (size_t j = 0; j < BU_PTBL_LEN(results); j++) {
+			struct db_full_path *fp = (struct db_full_path *)BU_PTBL_GET(results, j);
+			db_free_full_path(fp);
+			bu_free(fp, "free search path container");
+		    }
+		}
+		bu_ptbl_reset(results);
+	    }
+	}
+    }
+
+    bu_ptbl_free(&scratch);
+    rt_clean_resource_basic(NULL, resp);
+    BU_PUT(resp, struct resource);
+}
+
+
+static void
+search_run(struct search_state *st, int pass, int ncpu)
+{
+    st->pass = pass;
+    st->next = 0;
+    bu_parallel(search_worker, ncpu, st);
+}
+
+
+/* serial lists and evaluates every path in this thread, one at a time */
+static int
+search_db(struct bu_ptbl *search_results,
 	  int search_flags,
 	  const char *plan_str,
 	  int input_path_cnt,
@@ -2577,7 +2870,8 @@ db_search(struct bu_ptbl *search_results,
 	  struct db_i *dbip,
 	  bu_clbk_t clbk,
 	  void *u1,
-	  void *u2
+	  void *u2,
+	  int serial
 	  )
 {
     int i = 0;
@@ -2640,7 +2934,12 @@ db_search(struct bu_ptbl *search_results,
     /* execute the plan */
     {
 	struct bu_ptbl *full_paths = NULL;
-	struct list_client_data_t lcd;
+	struct search_state st;
+	std::vector<struct search_unit> units;
+	std::vector<struct db_full_path *> objs;
+	std::vector<size_t> obj_of;
+	int dp_results = (search_flags & (DB_SEARCH_FLAT | DB_SEARCH_RETURN_UNIQ_DP)) ? 1 : 0;
+	size_t j, k, nchunks = 0;
 
 	/* First, check if search_results is initialized - don't trust the caller to do it,
 	 * but it's fine if they did */
@@ -2650,19 +2949,10 @@ db_search(struct bu_ptbl *search_results,
 	    }
 	}
 
-	/* Build a set of all full paths under the supplied paths, including the starting
-	 * paths themselves */
-	if (!(search_flags & DB_SEARCH_FLAT)) {
-	    BU_ALLOC(full_paths, struct bu_ptbl);
-	    BU_PTBL_INIT(full_paths);
-	    lcd.dbip = dbip;
-	    lcd.full_paths = full_paths;
-	    lcd.flags = search_flags;
-	}
-
-	/* If we're doing a flat search, we can handle everything in this loop.
-	 * Otherwise, we're building a list of full paths to be handled in a
-	 * second pass. */
+	/* Split the supplied paths into units to be listed in parallel:
+	 * each starting path, then each of its immediate children with
+	 * everything below it.  For a flat search the starting paths are
+	 * all there is. */
 	for (i = 0; i < path_cnt; i++) {
 	    struct directory *curr_dp = paths[i];
 	    struct db_full_path *start_path = NULL;
@@ -2672,49 +2962,133 @@ db_search(struct bu_ptbl *search_results,
 	    }
 
 	    if ((search_flags & DB_SEARCH_HIDDEN) || !(curr_dp->d_flags & RT_DIR_HIDDEN)) {
-
 		BU_ALLOC(start_path, struct db_full_path);
 		db_full_path_init(start_path);
 		db_add_node_to_full_path(start_path, curr_dp);
+		/* by convention, a top level node is "unioned" into the global database */
 		DB_FULL_PATH_SET_CUR_BOOL(start_path, 2);
-
-		/* For a flat search, we don't need to build a table of paths -
-		 * just run the filters on the path */
-		if (search_flags & DB_SEARCH_FLAT) {
-		    struct db_node_t curr_node;
-		    /* by convention, a top level node is "unioned" into the global database */
-		    curr_node.path = start_path;
-		    curr_node.flags = search_flags;
-		    curr_node.matched_filters = 1;
-		    curr_node.full_paths = NULL;
-		    find_execute_plans(dbip, search_results, &curr_node, dbplan);
-		    result_cnt += curr_node.matched_filters;
-		    DB_FULL_PATH_POP(start_path);
-		} else {
-		    /* by convention, a top level node is "unioned" into the global database */
-		    bu_ptbl_ins(full_paths, (long *)start_path);
-		    /* Use the initial path to tree-walk and build a set of all paths below
-		     * start_path */
-		    db_fullpath_list(start_path, (void **)&lcd);
-		}
+		search_add_units(units, start_path, dbip, search_flags);
 	    }
 	}
 
-	if (!(search_flags & DB_SEARCH_FLAT)) {
-	    for (i = 0; i < (int)BU_PTBL_LEN(full_paths); i++) {
-		struct db_node_t curr_node;
-		curr_node.path = (struct db_full_path *)BU_PTBL_GET(full_paths, i);
-		curr_node.full_paths = full_paths;
-		curr_node.flags = search_flags;
-		curr_node.matched_filters = 1;
-		find_execute_plans(dbip, search_results, &curr_node, dbplan);
-		result_cnt += curr_node.matched_filters;
+	memset(&st, 0, sizeof(struct search_state));
+	st.dbip = dbip;
+	st.flags = search_flags;
+	st.plan = dbplan;
+	st.units = units.data();
+	st.nunits = units.size();
+
+	/* Build a set of all full paths under the supplied paths, including the starting
+	 * paths themselves, in the order a serial walk lists them */
+	BU_ALLOC(full_paths, struct bu_ptbl);
+	if (search_flags & DB_SEARCH_FLAT) {
+	    bu_ptbl_init(full_paths, (st.nunits) ? st.nunits : 1, "search paths");
+	    for (j = 0; j < st.nunits; j++)
+		bu_ptbl_ins(full_paths, (long *)st.units[j].path);
+	} else {
+	    size_t npaths = 0;
+	    for (j = 0; j < st.nunits; j++)
+		bu_ptbl_init(&st.units[j].paths, 8, "search unit paths");
+	    search_run(&st, 0, (serial || st.nunits < 2) ? 1 : 0);
+	    for (j = 0; j < st.nunits; j++)
+		npaths += BU_PTBL_LEN(&st.units[j].paths);
+	    bu_ptbl_init(full_paths, (npaths) ? npaths : 1, "search paths");
+	    for (j = 0; j < st.nunits; j++) {
+		for (k = 0; k < BU_PTBL_LEN(&st.units[j].paths); k++)
+		    bu_ptbl_ins(full_paths, BU_PTBL_GET(&st.units[j].paths, k));
+		bu_ptbl_free(&st.units[j].paths);
+	    }
+	}
+	st.full_paths = full_paths;
+
+	/* When nothing in the plan depends on where an object sits in the
+	 * hierarchy, every path to an object gives the same answer, so
+	 * each object is evaluated once on the first path to it */
+	st.dedupe = !serial && !(search_flags & DB_SEARCH_FLAT) && !search_path_dependent(&dbplans);
+	if (st.dedupe) {
+	    std::unordered_map<struct directory *, size_t> obj_ind;
+	    obj_of.resize(BU_PTBL_LEN(full_paths));
+	    for (j = 0; j < BU_PTBL_LEN(full_paths); j++) {
+		struct db_full_path *fp = (struct db_full_path *)BU_PTBL_GET(full_paths, j);
+		auto ins = obj_ind.insert(std::make_pair(DB_FULL_PATH_CUR_DIR(fp), objs.size()));
+		if (ins.second)
+		    objs.push_back(fp);
+		obj_of[j] = ins.first->second;
+	    }
+	    st.evals = objs.data();
+	    st.nevals = objs.size();
+	} else {
+	    st.evals = (struct db_full_path **)BU_PTBL_BASEADDR(full_paths);
+	    st.nevals = BU_PTBL_LEN(full_paths);
+	}
+
+	st.have_results = (search_results) ? 1 : 0;
+	if (st.nevals) {
+	    st.matched = (int *)bu_calloc(st.nevals, sizeof(int), "search matches");
+	    if (st.dedupe) {
+		st.printed = (size_t *)bu_calloc(st.nevals, sizeof(size_t), "search prints");
+	    } else if (st.have_results) {
+		nchunks = (st.nevals + SEARCH_CHUNK - 1) / SEARCH_CHUNK;
+		st.chunk_results = (struct bu_ptbl *)bu_calloc(nchunks, sizeof(struct bu_ptbl), "search chunk results");
+		for (j = 0; j < nchunks; j++)
+		    bu_ptbl_init(&st.chunk_results[j], 8, "search chunk results");
 	    }
 
-	    /* Done with the paths now - we have our answer */
-	    db_search_free(full_paths);
-	    bu_free(full_paths, "free search container");
+	    /* -exec hands paths to the caller's callback, one at a time */
+	    search_prepare_plans(&dbplans, dbip);
+	    search_run(&st, 1, (serial || st.nevals < SEARCH_PARALLEL_MIN || search_has_exec(&dbplans)) ? 1 : 0);
+	}
+
+	/* Gather the results in path order, so they don't depend on
+	 * the threading */
+	std::unordered_set<long *> seen;
+	if (search_results && dp_results) {
+	    for (j = 0; j < BU_PTBL_LEN(search_results); j++)
+		seen.insert(BU_PTBL_GET(search_results, j));
+	}
+	if (st.dedupe) {
+	    for (j = 0; j < BU_PTBL_LEN(full_paths); j++) {
+		size_t o = obj_of[j];
+		struct db_full_path *fp = (struct db_full_path *)BU_PTBL_GET(full_paths, j);
+
+		result_cnt += st.matched[o];
+		for (k = 0; search_results && k < st.printed[o]; k++) {
+		    if (dp_results) {
+			long *dbfp = (long *)DB_FULL_PATH_CUR_DIR(fp);
+			if (seen.insert(dbfp).second)
+			    bu_ptbl_ins(search_results, dbfp);
+		    } else {
+			struct db_full_path *new_entry;
+			BU_ALLOC(new_entry, struct db_full_path);
+			db_full_path_init(new_entry);
+			db_dup_full_path(new_entry, fp);
+			bu_ptbl_ins(search_results, (long *)new_entry);
+		    }
+		}
+	    }
+	} else {
+	    for (j = 0; j < st.nevals; j++)
+		result_cnt += st.matched[j];
+	    for (j = 0; j < nchunks; j++) {
+		for (k = 0; k < BU_PTBL_LEN(&st.chunk_results[j]); k++) {
+		    long *entry = BU_PTBL_GET(&st.chunk_results[j], k);
+		    if (!dp_results || seen.insert(entry).second)
+			bu_ptbl_ins(search_results, entry);
+		}
+		bu_ptbl_free(&st.chunk_results[j]);
+	    }
 	}
+
+	if (st.chunk_results)
+	    bu_free(st.chunk_results, "search chunk results");
+	if (st.printed)
+	    bu_free(st.printed, "search prints");
+	if (st.matched)
+	    bu_free(st.matched, "search matches");
+
+	/* Done with the paths now - we have our answer */
+	db_search_free(full_paths);
+	bu_free(full_paths, "free search container");
     }
 
     db_search_free_plan(dbplan);
@@ -2729,6 +3103,38 @@ db_search(struct bu_ptbl *search_results,
     return result_cnt;
 }
 
+
+int
+db_search(struct bu_ptbl *search_results,
+	  int search_flags,
+	  const char *plan_str,
+	  int input_path_cnt,
+	  struct directory **input_paths,
+	  struct db_i *dbip,
+	  bu_clbk_t clbk,
+	  void *u1,
+	  void *u2
+	  )
+{
+    return search_db(search_results, search_flags, plan_str, input_path_cnt, input_paths, dbip, clbk, u1, u2, 0);
+}
+
+
+int
+db_search_serial(struct bu_ptbl *search_results,
+		 int search_flags,
+		 const char *plan_str,
+		 int input_path_cnt,
+		 struct directory **input_paths,
+		 struct db_i *dbip,
+		 bu_clbk_t clbk,
+		 void *u1,
+		 void *u2
+		 )
+{
+    return search_db(search_results, search_flags, plan_str, input_path_cnt, input_paths, dbip, clbk, u1, u2, 1);
+}
+
 // Local Variables:
 // tab-width: 8
 // mode: C++
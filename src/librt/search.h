@@ -75,6 +75,7 @@ struct db_node_t {
     struct bu_ptbl *full_paths;
     int flags;
     int matched_filters;
+    struct resource *resp;	/* for loading objects in this thread */
 };
 
 /* search node type */
@@ -88,6 +89,8 @@ enum db_search_ntype {
 };
 
 
+struct db_search_attr;
+
 struct db_plan_t {
     struct db_plan_t *next;			/* next node */
     int (*eval)(struct db_plan_t *, struct db_node_t *, struct db_i *dbip, struct bu_ptbl *results);
@@ -128,6 +131,7 @@ struct db_plan_t {
 	char *_ci_data;			/* char pointer */
 	char *_path_data;		/* char pointer */
 	char *_attr_data;		/* char pointer */
+	struct db_search_attr *_attr_comp;	/* parsed -attr or -param filter */
 	char *_param_data;		/* char pointer */
 	char *_depth_data;		/* char pointer */
 	char *_node_data;		/* char pointer */
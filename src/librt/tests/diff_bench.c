@@ -0,0 +1,254 @@
+/*                    D I F F _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file diff_bench.c
+ *
+ * Writes three databases of spheres where a few objects change,
+ * disappear or appear from one to the next, runs db_diff() and
+ * db_diff3() over them once importing every object (db_diff_full(),
+ * db_diff3_full()) and once skipping the identical ones, reports
+ * the time each took, and fails unless both give the same results.
+ *
+ * Usage: rt_diff_bench [-n objects]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/str.h"
+#include "bu/time.h"
+#include "vmath.h"
+#include "raytrace.h"
+#include "rt/db_diff.h"
+#include "wdb.h"
+
+#include "../librt_private.h"
+
+static const char *diff_bench_files[3] = {
+    "rt_diff_bench_left.g",
+    "rt_diff_bench_ancestor.g",
+    "rt_diff_bench_right.g"
+};
+
+
+/* n spheres, where version 0 (the ancestor) is edited a little
+ * differently into versions 1 (left) and 2 (right) */
+static int
+diff_bench_write(const char *file, int n, int version)
+{
+    struct rt_wdb *wdbp;
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    int i;
+
+    bu_file_delete(file);
+    wdbp = wdb_fopen(file);
+    if (!wdbp)
+	return -1;
+
+    for (i = 0; i < n; i++) {
+	point_t c;
+	fastf_t r = 1.0 + (i % 7);
+
+	/* each side drops and resizes its own objects */
+	if (version && i % (40 + version) == 0)
+	    continue;
+	if (version && i % (10 + version) == 0)
+	    r += 0.5 * version;
+
+	bu_vls_sprintf(&name, "s%d.s", i);
+	VSET(c, i * 10.0, (i % 13) * 5.0, (i % 17) * 3.0);
+	if (mk_sph(wdbp, bu_vls_cstr(&name), c, r) < 0) {
+	    bu_vls_free(&name);
+	    wdb_close(wdbp);
+	    return -1;
+	}
+	if (i % 3 == 0)
+	    (void)db5_update_attribute(bu_vls_cstr(&name), "material", "steel", wdbp->dbip);
+	if (version == 2 && i % 29 == 0)
+	    (void)db5_update_attribute(bu_vls_cstr(&name), "material", "lead", wdbp->dbip);
+    }
+
+    /* and each adds a few of its own */
+    for (i = 0; version && i < n / 50 + 1; i++) {
+	point_t c;
+	bu_vls_sprintf(&name, "new%d_%d.s", version, i);
+	VSET(c, i * -10.0, 0.0, 0.0);
+	(void)mk_sph(wdbp, bu_vls_cstr(&name), c, 2.0);
+    }
+
+    bu_vls_free(&name);
+    wdb_close(wdbp);
+    return 0;
+}
+
+
+static int
+diff_bench_avps_equal(const struct bu_ptbl *t1, const struct bu_ptbl *t2)
+{
+    size_t i;
+
+    if (BU_PTBL_LEN(t1) != BU_PTBL_LEN(t2))
+	return 0;
+    for (i = 0; i < BU_PTBL_LEN(t1); i++) {
+	const struct diff_avp *a1 = (const struct diff_avp *)BU_PTBL_GET(t1, i);
+	const struct diff_avp *a2 = (const struct diff_avp *)BU_PTBL_GET(t2, i);
+	if (a1->state != a2->state || !BU_STR_EQUAL(a1->name, a2->name))
+	    return 0;
+	if (bu_strcmp(a1->left_value, a2->left_value)
+	    || bu_strcmp(a1->ancestor_value, a2->ancestor_value)
+	    || bu_strcmp(a1->right_value, a2->right_value))
+	    return 0;
+    }
+    return 1;
+}
+
+
+/* count the results that differ between t1 and t2 */
+static int
+diff_bench_compare(const struct bu_ptbl *t1, const struct bu_ptbl *t2)
+{
+    size_t i;
+    int bad = 0;
+
+    if (BU_PTBL_LEN(t1) != BU_PTBL_LEN(t2)) {
+	bu_log("%zu results, expected %zu\n", (size_t)BU_PTBL_LEN(t2), (size_t)BU_PTBL_LEN(t1));
+	return 1;
+    }
+    for (i = 0; i < BU_PTBL_LEN(t1); i++) {
+	const struct diff_result *r1 = (const struct diff_result *)BU_PTBL_GET(t1, i);
+	const struct diff_result *r2 = (const struct diff_result *)BU_PTBL_GET(t2, i);
+	if (!BU_STR_EQUAL(r1->obj_name, r2->obj_name)
+	    || r1->param_state != r2->param_state || r1->attr_state != r2->attr_state
+	    || !diff_bench_avps_equal(r1->param_diffs, r2->param_diffs)
+	    || !diff_bench_avps_equal(r1->attr_diffs, r2->attr_diffs)) {
+	    if (bad++ < 10)
+		bu_log("result %zu (%s) differs\n", i, r1->obj_name);
+	}
+    }
+    return bad;
+}
+
+
+static void
+diff_bench_free(struct bu_ptbl *results)
+{
+    size_t i;
+
+    for (i = 0; i < BU_PTBL_LEN(results); i++) {
+	struct diff_result *r = (struct diff_result *)BU_PTBL_GET(results, i);
+	diff_free_result(r);
+	BU_PUT(r, struct diff_result);
+    }
+    bu_ptbl_free(results);
+}
+
+
+/* run a two or three way diff, returning the elapsed seconds */
+static double
+diff_bench_run(struct db_i **dbips, int three, int full, const struct bn_tol *tol, struct bu_ptbl *results)
+{
+    int64_t start;
+
+    bu_ptbl_init(results, 64, "diff results");
+    start = bu_gettime();
+    if (three && full)
+	(void)db_diff3_full(dbips[0], dbips[1], dbips[2], tol, DB_COMPARE_ALL, results);
+    else if (three)
+	(void)db_diff3(dbips[0], dbips[1], dbips[2], tol, DB_COMPARE_ALL, results);
+    else if (full)
+	(void)db_diff_full(dbips[1], dbips[2], tol, DB_COMPARE_ALL, results);
+    else
+	(void)db_diff(dbips[1], dbips[2], tol, DB_COMPARE_ALL, results);
+    return (bu_gettime() - start) / 1000000.0;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct bn_tol tol = BN_TOL_INIT_TOL;
+    struct db_i *dbips[3];
+    int n = 20000;
+    int c, k, three;
+    int bad = 0;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "n:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		n = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n objects]\n", argv[0]);
+	}
+    }
+    if (n < 1)
+	bu_exit(1, "Usage: %s [-n objects]\n", argv[0]);
+
+    for (k = 0; k < 3; k++) {
+	if (diff_bench_write(diff_bench_files[k], n, (k == 1) ? 0 : ((k == 0) ? 1 : 2)) < 0)
+	    bu_exit(1, "unable to write %s\n", diff_bench_files[k]);
+	dbips[k] = db_open(diff_bench_files[k], DB_OPEN_READONLY);
+	if (dbips[k] == DBI_NULL || db_dirbuild(dbips[k]) < 0)
+	    bu_exit(1, "unable to open %s\n", diff_bench_files[k]);
+	rt_new_material_head(MATER_NULL);
+    }
+
+    for (three = 0; three < 2; three++) {
+	struct bu_ptbl full, fast;
+	double tfull, tfast;
+
+	tfull = diff_bench_run(dbips, three, 1, &tol, &full);
+	tfast = diff_bench_run(dbips, three, 0, &tol, &fast);
+
+	bu_log("%s, %d objects: every object %.3fs, skipping identical %.3fs, %.2fx\n",
+	       (three) ? "db_diff3" : "db_diff", n, tfull, tfast, (tfast > 0) ? tfull / tfast : 0.0);
+
+	bad += diff_bench_compare(&full, &fast);
+	diff_bench_free(&full);
+	diff_bench_free(&fast);
+    }
+
+    for (k = 0; k < 3; k++) {
+	db_close(dbips[k]);
+	bu_file_delete(diff_bench_files[k]);
+    }
+
+    if (bad)
+	bu_log("%d results differ\n", bad);
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,223 @@
+/*                     D S P _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file dsp_bench.c
+ *
+ * Shoots the same grazing and steep rays at a synthetic terrain DSP
+ * twice, once through the flattened min/max pyramid and once through
+ * the recursive dsp_bb tree kept as rt_dsp_prep_recursive(), reports
+ * the time each took, and fails if any ray's segments differ between
+ * the two.
+ *
+ * Usage: rt_dsp_bench [-n cells] [-r rays] [-c a|l|L]
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "vmath.h"
+#include "bn/randmt.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#include "../librt_private.h"
+#include "./shot_bench.h"
+
+#define DSP_BENCH_FILE "rt_dsp_bench.g"
+
+/* rolling hills plus a couple of ridges, so both the coarse and fine
+ * pyramid levels have something to reject and accept */
+static void
+dsp_bench_terrain(unsigned short *buf, int n)
+{
+    int x, y;
+
+    for (y = 0; y < n; y++) {
+	for (x = 0; x < n; x++) {
+	    double u = (double)x / n;
+	    double v = (double)y / n;
+	    double h = 0.5
+		+ 0.2 * sin(u * 13.0) * cos(v * 11.0)
+		+ 0.1 * sin((u + v) * 57.0)
+		+ 0.05 * cos(u * 211.0) * sin(v * 197.0);
+	    CLAMP(h, 0.0, 1.0);
+	    buf[y * n + x] = (unsigned short)(h * 65535.0);
+	}
+    }
+}
+
+
+static int
+dsp_bench_write(int n, char cut)
+{
+    struct rt_wdb *wdbp;
+    struct rt_dsp_internal *dsp;
+    unsigned short *buf;
+
+    wdbp = wdb_fopen(DSP_BENCH_FILE);
+    if (!wdbp) {
+	bu_log("unable to create %s\n", DSP_BENCH_FILE);
+	return -1;
+    }
+
+    buf = (unsigned short *)bu_malloc(sizeof(unsigned short) * n * n, "terrain");
+    dsp_bench_terrain(buf, n);
+    mk_binunif(wdbp, "terrain.data", buf, WDB_BINUNIF_UINT16, (long)n * n);
+    bu_free(buf, "terrain");
+
+    /* one unit per cell, full scale height of n/4 */
+    BU_ALLOC(dsp, struct rt_dsp_internal);
+    dsp->magic = RT_DSP_INTERNAL_MAGIC;
+    bu_vls_init(&dsp->dsp_name);
+    bu_vls_strcpy(&dsp->dsp_name, "terrain.data");
+    dsp->dsp_datasrc = RT_DSP_SRC_OBJ;
+    dsp->dsp_xcnt = n;
+    dsp->dsp_ycnt = n;
+    dsp->dsp_smooth = 0;
+    dsp->dsp_cuttype = cut;
+    MAT_IDN(dsp->dsp_stom);
+    dsp->dsp_stom[10] = (n / 4.0) / 65535.0;
+    bn_mat_inv(dsp->dsp_mtos, dsp->dsp_stom);
+
+    if (wdb_export(wdbp, "terrain.s", (void *)dsp, ID_DSP, 1.0) < 0) {
+	wdb_close(wdbp);
+	return -1;
+    }
+    wdb_close(wdbp);
+    return 0;
+}
+
+
+/* grazing rays skim the terrain nearly horizontally across its whole
+ * extent, steep rays come down from above */
+static void
+dsp_bench_rays(struct xray *rays, int nrays, int n, int steep)
+{
+    int i;
+
+    for (i = 0; i < nrays; i++) {
+	double a = bn_randmt() * M_2PI;
+	double px = bn_randmt() * n;
+	double py = bn_randmt() * n;
+
+	if (steep) {
+	    VSET(rays[i].r_pt, px, py, n);
+	    VSET(rays[i].r_dir, 0.3 * cos(a), 0.3 * sin(a), -1.0);
+	} else {
+	    double h = (0.3 + 0.4 * bn_randmt()) * n / 4.0;
+	    VSET(rays[i].r_pt, px - cos(a) * 2 * n, py - sin(a) * 2 * n, h);
+	    VSET(rays[i].r_dir, cos(a), sin(a), -0.02 * bn_randmt());
+	}
+	VUNITIZE(rays[i].r_dir);
+    }
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    int n = 1025;
+    int nrays = 100000;
+    char cut = DSP_CUT_DIR_ADAPT;
+    int c, steep;
+    int ret = 0;
+    size_t rsize;
+    struct xray *rays;
+    fastf_t *mip_res, *rec_res;
+
+    bu_setprogname(argv[0]);
+    bn_randmt_seed(5489);
+
+    while ((c = bu_getopt(argc, argv, "n:r:c:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		n = atoi(bu_optarg);
+		break;
+	    case 'r':
+		nrays = atoi(bu_optarg);
+		break;
+	    case 'c':
+		cut = bu_optarg[0];
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n cells] [-r rays] [-c a|l|L]\n", argv[0]);
+	}
+    }
+    if (n < 2 || nrays < 1 || (cut != DSP_CUT_DIR_ADAPT && cut != DSP_CUT_DIR_llUR && cut != DSP_CUT_DIR_ULlr))
+	bu_exit(1, "Usage: %s [-n cells] [-r rays] [-c a|l|L]\n", argv[0]);
+
+    if (dsp_bench_write(n, cut) < 0)
+	bu_exit(1, "unable to write the test terrain\n");
+
+    rays = (struct xray *)bu_calloc(nrays, sizeof(struct xray), "rays");
+    rsize = sizeof(fastf_t) * nrays * SHOT_BENCH_RES;
+    mip_res = (fastf_t *)bu_malloc(rsize, "pyramid results");
+    rec_res = (fastf_t *)bu_malloc(rsize, "recursive results");
+
+    bu_log("%d x %d terrain, %d rays, cut type %c\n", n, n, nrays, cut);
+    bu_log("%-10s %12s %12s %8s\n", "rays", "recursive", "pyramid", "speedup");
+
+    for (steep = 0; steep < 2; steep++) {
+	double trec, tmip;
+	int bad;
+
+	dsp_bench_rays(rays, nrays, n, steep);
+	trec = shot_bench_shoot(DSP_BENCH_FILE, "terrain.s", rt_dsp_prep_recursive, rays, nrays, rec_res, NULL);
+	tmip = shot_bench_shoot(DSP_BENCH_FILE, "terrain.s", NULL, rays, nrays, mip_res, NULL);
+	if (trec < 0 || tmip < 0) {
+	    bu_log("unable to prep %s\n", DSP_BENCH_FILE);
+	    ret = 1;
+	    break;
+	}
+
+	bad = shot_bench_diff(mip_res, rec_res, nrays, SMALL_FASTF);
+
+	bu_log("%-10s %11.3fs %11.3fs %7.2fx\n", (steep) ? "steep" : "grazing", trec, tmip, (tmip > 0) ? trec / tmip : 0.0);
+	if (bad) {
+	    bu_log("%d %s ray results differ between the traversals\n", bad, (steep) ? "steep" : "grazing");
+	    ret = 1;
+	}
+    }
+
+    bu_free(rec_res, "recursive results");
+    bu_free(mip_res, "pyramid results");
+    bu_free(rays, "rays");
+    bu_file_delete(DSP_BENCH_FILE);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
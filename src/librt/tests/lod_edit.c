@@ -0,0 +1,292 @@
+/*                      L O D _ E D I T . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file lod_edit.c
+ *
+ * Edits, grows, shrinks, renames, deletes and adds BoTs while
+ * db_mesh_lod_start() is generating LoD data for them in the
+ * background.  Growing an object moves its storage, so the workers
+ * must never read it half written or from its old offset.  Once the
+ * workers finish, every edited BoT is brought up to date with
+ * db_mesh_lod_update() and the cached data must match the object's
+ * current content.  Each mesh's bounding box encodes its position in
+ * the set and how often it was edited, so a stale or torn read shows
+ * up as a wrong box.
+ *
+ * Usage: rt_lod_edit [-n bots] [-s size]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/vls.h"
+#include "vmath.h"
+#include "bv/lod.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+static const char *lod_edit_file = "rt_lod_edit.g";
+
+#define LOD_EDIT_SPACING 1000.0
+#define LOD_EDIT_TOL 1.0e-6
+
+
+/* Write an n x n grid of vertices as BoT "name".  x is offset by the
+ * mesh's index and z climbs to height, so the bounding box is
+ * (id*spacing, 0, 0) - (id*spacing + n - 1, n - 1, height). */
+static int
+lod_edit_mesh(struct rt_wdb *wdbp, const char *name, int id, int n, fastf_t height)
+{
+    size_t vcnt = (size_t)n * n;
+    size_t fcnt = (size_t)(n - 1) * (n - 1) * 2;
+    fastf_t *v = (fastf_t *)bu_calloc(vcnt * 3, sizeof(fastf_t), "lod_edit verts");
+    int *f = (int *)bu_calloc(fcnt * 3, sizeof(int), "lod_edit faces");
+    int ret;
+
+    for (int i = 0; i < n; i++) {
+	for (int j = 0; j < n; j++) {
+	    fastf_t *p = &v[((size_t)i * n + j) * 3];
+	    p[X] = id * LOD_EDIT_SPACING + i;
+	    p[Y] = j;
+	    p[Z] = height * (fastf_t)(i * j) / (fastf_t)((n - 1) * (n - 1));
+	}
+    }
+    size_t fi = 0;
+    for (int i = 0; i < n - 1; i++) {
+	for (int j = 0; j < n - 1; j++) {
+	    int a = i * n + j;
+	    int b = a + n;
+	    f[fi++] = a; f[fi++] = b; f[fi++] = b + 1;
+	    f[fi++] = a; f[fi++] = b + 1; f[fi++] = a + 1;
+	}
+    }
+
+    ret = mk_bot(wdbp, name, RT_BOT_SURFACE, RT_BOT_UNORIENTED, 0, vcnt, fcnt, v, f, NULL, NULL);
+    bu_free(v, "lod_edit verts");
+    bu_free(f, "lod_edit faces");
+    return ret;
+}
+
+
+/* check the cached data for name against the box lod_edit_mesh() gave it */
+static int
+lod_edit_check(struct db_i *dbip, const char *name, int id, int n, fastf_t height)
+{
+    point_t bmin, bmax;
+    struct bv_mesh_lod *lod;
+    int ret = 0;
+
+    if (db_mesh_lod_update(dbip, name) != BRLCAD_OK) {
+	bu_log("%s: LoD update failed\n", name);
+	return 1;
+    }
+    lod = db_mesh_lod_get(dbip, name);
+    if (!lod) {
+	bu_log("%s: no LoD data\n", name);
+	return 1;
+    }
+
+    VSET(bmin, id * LOD_EDIT_SPACING, 0, 0);
+    VSET(bmax, id * LOD_EDIT_SPACING + n - 1, n - 1, height);
+    if (!VNEAR_EQUAL(lod->bmin, bmin, LOD_EDIT_TOL) || !VNEAR_EQUAL(lod->bmax, bmax, LOD_EDIT_TOL)) {
+	bu_log("%s: cached box (%g %g %g) (%g %g %g), expected (%g %g %g) (%g %g %g)\n", name,
+	       V3ARGS(lod->bmin), V3ARGS(lod->bmax), V3ARGS(bmin), V3ARGS(bmax));
+	ret = 1;
+    }
+
+    bv_mesh_lod_destroy(lod);
+    return ret;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    int c;
+    int nbots = 48;
+    int size = 60;
+    int edits = 0;
+    int bad = 0;
+    struct rt_wdb *wdbp;
+    struct db_i *dbip;
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    struct bu_vls nname = BU_VLS_INIT_ZERO;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "n:s:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		nbots = atoi(bu_optarg);
+		break;
+	    case 's':
+		size = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n bots] [-s size]\n", argv[0]);
+	}
+    }
+    if (nbots < 8 || size < 4)
+	bu_exit(1, "Usage: %s [-n bots] [-s size]\n", argv[0]);
+
+    /* per-mesh grid size and height, tracking the edits */
+    int *n = (int *)bu_calloc(nbots + 1, sizeof(int), "lod_edit n");
+    fastf_t *height = (fastf_t *)bu_calloc(nbots + 1, sizeof(fastf_t), "lod_edit height");
+    int *gone = (int *)bu_calloc(nbots + 1, sizeof(int), "lod_edit gone");
+
+    bu_file_delete(lod_edit_file);
+    wdbp = wdb_fopen(lod_edit_file);
+    if (!wdbp)
+	bu_exit(1, "unable to create %s\n", lod_edit_file);
+    dbip = wdbp->dbip;
+
+    for (int i = 0; i < nbots; i++) {
+	n[i] = size;
+	height[i] = 1;
+	bu_vls_sprintf(&name, "bot%d.s", i);
+	if (lod_edit_mesh(wdbp, bu_vls_cstr(&name), i, n[i], height[i]))
+	    bu_exit(1, "unable to write %s\n", bu_vls_cstr(&name));
+    }
+
+    /* Start from an empty cache so every BoT has to be generated */
+    db_mesh_lod_clear(dbip);
+    db_mesh_lod_start(dbip, 0);
+
+    /* Work through the meshes from the back of the queue while the
+     * workers take them from the front */
+    for (int i = nbots - 1; i >= 0; i--) {
+	int running = db_mesh_lod_progress(dbip, NULL, NULL);
+	struct directory *dp;
+
+	bu_vls_sprintf(&name, "bot%d.s", i);
+	switch (i % 4) {
+	    case 0:
+		/* grow, moving the object to new storage */
+		n[i] = size * 2;
+		height[i] += 1;
+		lod_edit_mesh(wdbp, bu_vls_cstr(&name), i, n[i], height[i]);
+		break;
+	    case 1:
+		/* shrink in place */
+		n[i] = size / 2;
+		height[i] += 2;
+		lod_edit_mesh(wdbp, bu_vls_cstr(&name), i, n[i], height[i]);
+		break;
+	    case 2:
+		/* delete every other one, rename the rest */
+		dp = db_lookup(dbip, bu_vls_cstr(&name), LOOKUP_QUIET);
+		if (dp == RT_DIR_NULL)
+		    bu_exit(1, "lost %s\n", bu_vls_cstr(&name));
+		if (i % 8 == 2) {
+		    if (db_delete(dbip, dp) || db_dirdelete(dbip, dp))
+			bu_exit(1, "unable to delete %s\n", bu_vls_cstr(&name));
+		    gone[i] = 1;
+		} else {
+		    struct rt_db_internal intern;
+		    bu_vls_sprintf(&nname, "renamed%d.s", i);
+		    if (db_rename(dbip, dp, bu_vls_cstr(&nname)))
+			bu_exit(1, "unable to rename %s\n", bu_vls_cstr(&name));
+		    /* rewrite it under its new name, as mv does */
+		    if (rt_db_get_internal(&intern, dp, dbip, NULL, &rt_uniresource) < 0
+			|| rt_db_put_internal(dp, dbip, &intern, &rt_uniresource) < 0)
+			bu_exit(1, "unable to rewrite %s\n", bu_vls_cstr(&nname));
+		}
+		break;
+	    default:
+		/* same size, new content */
+		height[i] += 3;
+		lod_edit_mesh(wdbp, bu_vls_cstr(&name), i, n[i], height[i]);
+		break;
+	}
+	if (running)
+	    edits++;
+    }
+
+    /* and a new one, likely landing in storage freed above */
+    n[nbots] = size;
+    height[nbots] = 5;
+    lod_edit_mesh(wdbp, "added.s", nbots, n[nbots], height[nbots]);
+
+    db_mesh_lod_wait(dbip);
+
+    if (!edits) {
+	bu_log("LoD generation finished before any edit was made - use a larger -n or -s\n");
+	bad++;
+    }
+
+    for (int i = 0; i < nbots; i++) {
+	if (gone[i])
+	    continue;
+	if (i % 4 == 2) {
+	    bu_vls_sprintf(&name, "renamed%d.s", i);
+	} else {
+	    bu_vls_sprintf(&name, "bot%d.s", i);
+	}
+	bad += lod_edit_check(dbip, bu_vls_cstr(&name), i, n[i], height[i]);
+    }
+    bad += lod_edit_check(dbip, "added.s", nbots, n[nbots], height[nbots]);
+
+    /* deleted objects must come back without LoD data */
+    for (int i = 0; i < nbots; i++) {
+	struct bv_mesh_lod *lod;
+	if (!gone[i])
+	    continue;
+	bu_vls_sprintf(&name, "bot%d.s", i);
+	db_mesh_lod_update(dbip, bu_vls_cstr(&name));
+	lod = db_mesh_lod_get(dbip, bu_vls_cstr(&name));
+	if (lod) {
+	    bu_log("%s: deleted but still has LoD data\n", bu_vls_cstr(&name));
+	    bv_mesh_lod_destroy(lod);
+	    bad++;
+	}
+    }
+
+    bu_log("%d of %d edits made while LoD generation was running\n", edits, nbots);
+
+    db_mesh_lod_clear(dbip);
+    wdb_close(wdbp);
+    bu_file_delete(lod_edit_file);
+    bu_vls_free(&name);
+    bu_vls_free(&nname);
+    bu_free(n, "lod_edit n");
+    bu_free(height, "lod_edit height");
+    bu_free(gone, "lod_edit gone");
+
+    if (bad)
+	bu_log("%d LoD checks failed\n", bad);
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,217 @@
+/*                M E T A B A L L _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file metaball_bench.c
+ *
+ * Shoots the same rays at an isopotential and a blob metaball with a
+ * cloud of control points, once summing every point at every march
+ * step (rt_metaball_prep_brute()) and once bounding the field through the
+ * point hierarchy, reports the time each took, and fails if any ray's
+ * partitions differ beyond the march's final step.
+ *
+ * Usage: rt_metaball_bench [-n points] [-r rays]
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "vmath.h"
+#include "bn/randmt.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#include "../librt_private.h"
+#include "./shot_bench.h"
+
+#define METABALL_BENCH_FILE "rt_metaball_bench.g"
+
+/* the march refines hits to fldstr/1e5, and every fldstr here is >= 1 */
+#define METABALL_BENCH_TOL 1.0e-4
+
+
+/* n points scattered so that the balls stay mostly apart, the iso
+ * field's slow falloff needs them further apart than the blobs do */
+static int
+metaball_bench_write(int n)
+{
+    struct rt_wdb *wdbp;
+    fastf_t *pts;
+    const fastf_t **verts;
+    int i, m;
+
+    wdbp = wdb_fopen(METABALL_BENCH_FILE);
+    if (!wdbp) {
+	bu_log("unable to create %s\n", METABALL_BENCH_FILE);
+	return -1;
+    }
+
+    pts = (fastf_t *)bu_malloc(sizeof(fastf_t) * 5 * n, "points");
+    verts = (const fastf_t **)bu_malloc(sizeof(fastf_t *) * n, "point pointers");
+    for (m = METABALL_ISOPOTENTIAL; m <= METABALL_BLOB; m++) {
+	double size = (m == METABALL_ISOPOTENTIAL) ? 8.0 * sqrt(n) : 10.0 * cbrt(n);
+
+	for (i = 0; i < n; i++) {
+	    fastf_t *p = &pts[5 * i];
+	    VSET(p, bn_randmt() * size, bn_randmt() * size, bn_randmt() * size);
+	    p[3] = (m == METABALL_ISOPOTENTIAL) ? 1.0 + 1.5 * bn_randmt() : 3.0 + 3.0 * bn_randmt();
+	    p[4] = 1.0 + 2.0 * bn_randmt();
+	    verts[i] = p;
+	}
+	if (mk_metaball(wdbp, (m == METABALL_ISOPOTENTIAL) ? "iso.s" : "blob.s", n, m, 1.0, verts) < 0) {
+	    bu_free(verts, "point pointers");
+	    bu_free(pts, "points");
+	    wdb_close(wdbp);
+	    return -1;
+	}
+    }
+    bu_free(verts, "point pointers");
+    bu_free(pts, "points");
+
+    wdb_close(wdbp);
+    return 0;
+}
+
+
+/* prep obj with ref, or its own prep if NULL, and shoot rays across
+ * its bounding sphere, returns the shot time or a negative value on
+ * failure */
+static double
+metaball_bench_shoot(const char *obj, shot_bench_prep_t ref, int nrays, fastf_t *res)
+{
+    struct rt_i *rtip;
+    struct soltab *stp;
+    struct xray *rays;
+    double elapsed;
+    int i;
+
+    rtip = shot_bench_prep(METABALL_BENCH_FILE, obj, ref, NULL);
+    if (!rtip)
+	return -1.0;
+    stp = rt_find_solid(rtip, obj);
+    if (!stp) {
+	rt_free_rti(rtip);
+	return -1.0;
+    }
+
+    /* the same rays for both preps */
+    bn_randmt_seed(9);
+    rays = (struct xray *)bu_calloc(nrays, sizeof(struct xray), "rays");
+    for (i = 0; i < nrays; i++) {
+	point_t p, q;
+	int k;
+
+	for (k = 0; k < 3; k++) {
+	    p[k] = stp->st_center[k] + stp->st_aradius * 0.7 * (2.0 * bn_randmt() - 1.0);
+	    q[k] = stp->st_center[k] + stp->st_aradius * 0.7 * (2.0 * bn_randmt() - 1.0);
+	}
+	VSUB2(rays[i].r_dir, q, p);
+	VUNITIZE(rays[i].r_dir);
+	VJOIN1(rays[i].r_pt, p, -2.0 * stp->st_aradius, rays[i].r_dir);
+    }
+    elapsed = shot_bench_fire(rtip, rays, nrays, res);
+
+    bu_free(rays, "rays");
+    rt_free_rti(rtip);
+    return elapsed;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    const char *objs[2] = {"iso.s", "blob.s"};
+    int n = 500;
+    int nrays = 2000;
+    int c, o;
+    int ret = 0;
+    fastf_t *brute_res, *bvh_res;
+
+    bu_setprogname(argv[0]);
+    bn_randmt_seed(5489);
+
+    while ((c = bu_getopt(argc, argv, "n:r:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		n = atoi(bu_optarg);
+		break;
+	    case 'r':
+		nrays = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n points] [-r rays]\n", argv[0]);
+	}
+    }
+    if (n < 1 || nrays < 1)
+	bu_exit(1, "Usage: %s [-n points] [-r rays]\n", argv[0]);
+
+    if (metaball_bench_write(n) < 0)
+	bu_exit(1, "unable to write the test metaballs\n");
+
+    brute_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "brute results");
+    bvh_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "hierarchy results");
+
+    bu_log("%d control points, %d rays\n", n, nrays);
+    bu_log("%-7s %10s %10s %8s\n", "", "brute", "bounded", "speedup");
+
+    for (o = 0; o < 2; o++) {
+	double tbrute, tbvh;
+	int bad;
+
+	tbrute = metaball_bench_shoot(objs[o], rt_metaball_prep_brute, nrays, brute_res);
+	tbvh = metaball_bench_shoot(objs[o], NULL, nrays, bvh_res);
+	if (tbrute < 0 || tbvh < 0) {
+	    bu_log("unable to prep %s\n", objs[o]);
+	    ret = 1;
+	    break;
+	}
+
+	bad = shot_bench_diff(brute_res, bvh_res, nrays, METABALL_BENCH_TOL);
+
+	bu_log("%-7s %9.3fs %9.3fs %7.2fx\n", objs[o], tbrute, tbvh, (tbvh > 0) ? tbrute / tbvh : 0.0);
+	if (bad) {
+	    bu_log("%d %s ray results differ between the brute and bounded marches\n", bad, objs[o]);
+	    ret = 1;
+	}
+    }
+
+    bu_free(bvh_res, "hierarchy results");
+    bu_free(brute_res, "brute results");
+    bu_file_delete(METABALL_BENCH_FILE);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,281 @@
+/*                    P N T S _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file pnts_bench.c
+ *
+ * Shoots the same rays at a cloud of scaled points and at a BoT with
+ * an octahedron standing in for each point, reports the rays per
+ * second of each, and fails if any pnts partition differs from the
+ * union of the point spheres along that ray.
+ *
+ * Usage: rt_pnts_bench [-n points] [-r rays]
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/sort.h"
+#include "vmath.h"
+#include "bn/randmt.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#include "./shot_bench.h"
+
+#define PNTS_BENCH_FILE "rt_pnts_bench.g"
+
+
+/* n points of random size, as a pnts and as a BoT of octahedra */
+static int
+pnts_bench_write(fastf_t *pts, int n)
+{
+    struct rt_wdb *wdbp;
+    struct rt_pnts_internal *pnts;
+    struct pnt_scale *head;
+    fastf_t *verts;
+    int *faces;
+    double size = 4.0 * cbrt(n);
+    int i, f;
+
+    /* the octahedron's faces, as offsets into its six vertices */
+    static const int oct[8][3] = {
+	{0, 2, 4}, {2, 1, 4}, {1, 3, 4}, {3, 0, 4},
+	{2, 0, 5}, {1, 2, 5}, {3, 1, 5}, {0, 3, 5}
+    };
+
+    wdbp = wdb_fopen(PNTS_BENCH_FILE);
+    if (!wdbp) {
+	bu_log("unable to create %s\n", PNTS_BENCH_FILE);
+	return -1;
+    }
+
+    BU_ALLOC(pnts, struct rt_pnts_internal);
+    pnts->magic = RT_PNTS_INTERNAL_MAGIC;
+    pnts->scale = 0.0;
+    pnts->type = RT_PNT_TYPE_SCA;
+    pnts->count = n;
+    BU_ALLOC(head, struct pnt_scale);
+    BU_LIST_INIT(&head->l);
+    pnts->point = head;
+
+    verts = (fastf_t *)bu_malloc(sizeof(fastf_t) * 18 * n, "octahedra vertices");
+    faces = (int *)bu_malloc(sizeof(int) * 24 * n, "octahedra faces");
+    for (i = 0; i < n; i++) {
+	struct pnt_scale *point;
+	fastf_t *p = &pts[4 * i];
+	fastf_t *v = &verts[18 * i];
+
+	VSET(p, bn_randmt() * size, bn_randmt() * size, bn_randmt() * size);
+	p[3] = 0.2 + 0.6 * bn_randmt();
+
+	BU_ALLOC(point, struct pnt_scale);
+	VMOVE(point->v, p);
+	point->s = p[3];
+	BU_LIST_PUSH(&head->l, &point->l);
+
+	VSET(&v[0], p[X] + p[3], p[Y], p[Z]);
+	VSET(&v[3], p[X] - p[3], p[Y], p[Z]);
+	VSET(&v[6], p[X], p[Y] + p[3], p[Z]);
+	VSET(&v[9], p[X], p[Y] - p[3], p[Z]);
+	VSET(&v[12], p[X], p[Y], p[Z] + p[3]);
+	VSET(&v[15], p[X], p[Y], p[Z] - p[3]);
+	for (f = 0; f < 8; f++) {
+	    faces[24*i + 3*f + 0] = 6*i + oct[f][0];
+	    faces[24*i + 3*f + 1] = 6*i + oct[f][1];
+	    faces[24*i + 3*f + 2] = 6*i + oct[f][2];
+	}
+    }
+
+    if (wdb_export(wdbp, "pnts.s", (void *)pnts, ID_PNTS, 1.0) < 0
+	|| mk_bot(wdbp, "bot.s", RT_BOT_SOLID, RT_BOT_CCW, 0, 6 * n, 8 * n, verts, faces, NULL, NULL) < 0) {
+	bu_free(faces, "octahedra faces");
+	bu_free(verts, "octahedra vertices");
+	wdb_close(wdbp);
+	return -1;
+    }
+    bu_free(faces, "octahedra faces");
+    bu_free(verts, "octahedra vertices");
+
+    wdb_close(wdbp);
+    return 0;
+}
+
+
+/* rays between random points inside the cloud */
+static void
+pnts_bench_rays(struct xray *rays, int nrays, int n)
+{
+    double size = 4.0 * cbrt(n);
+    int i;
+
+    for (i = 0; i < nrays; i++) {
+	point_t p, q;
+
+	VSET(p, bn_randmt() * size, bn_randmt() * size, bn_randmt() * size);
+	VSET(q, bn_randmt() * size, bn_randmt() * size, bn_randmt() * size);
+	VSUB2(rays[i].r_dir, q, p);
+	VUNITIZE(rays[i].r_dir);
+	VJOIN1(rays[i].r_pt, p, -2.0 * size, rays[i].r_dir);
+    }
+}
+
+
+static int
+pnts_bench_cmp(const void *a, const void *b, void *UNUSED(arg))
+{
+    const fastf_t *sa = (const fastf_t *)a;
+    const fastf_t *sb = (const fastf_t *)b;
+
+    if (sa[0] < sb[0])
+	return -1;
+    if (sa[0] > sb[0])
+	return 1;
+    return 0;
+}
+
+
+/* the partitions a ray should see, the union of the sphere spans */
+static void
+pnts_bench_expect(const fastf_t *pts, int n, const struct xray *rp, fastf_t *spans, fastf_t *res)
+{
+    int i, m = 0, k = 0;
+
+    for (i = 0; i < n; i++) {
+	const fastf_t *p = &pts[4 * i];
+	vect_t ov;
+	fastf_t b, root;
+
+	VSUB2(ov, p, rp->r_pt);
+	b = VDOT(rp->r_dir, ov);
+	root = b*b - MAGSQ(ov) + p[3]*p[3];
+	if (root <= 0)
+	    continue;
+	root = sqrt(root);
+	spans[2*m] = b - root;
+	spans[2*m+1] = b + root;
+	m++;
+    }
+    bu_sort(spans, m, 2 * sizeof(fastf_t), pnts_bench_cmp, NULL);
+
+    for (i = 0; i < m; i++) {
+	if (k && spans[2*i] <= res[2*k-1]) {
+	    if (spans[2*i+1] > res[2*k-1])
+		res[2*k-1] = spans[2*i+1];
+	    continue;
+	}
+	if (k == SHOT_BENCH_PARTS)
+	    break;
+	res[2*k] = spans[2*i];
+	res[2*k+1] = spans[2*i+1];
+	k++;
+    }
+    res[2*SHOT_BENCH_PARTS] = k;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    int n = 20000;
+    int nrays = 20000;
+    int c, i;
+    int ret = 0, bad = 0;
+    double ppnts, pbot, tpnts, tbot;
+    struct xray *rays;
+    fastf_t *pts, *spans, *pnts_res, *bot_res, *expect;
+
+    bu_setprogname(argv[0]);
+    bn_randmt_seed(5489);
+
+    while ((c = bu_getopt(argc, argv, "n:r:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		n = atoi(bu_optarg);
+		break;
+	    case 'r':
+		nrays = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n points] [-r rays]\n", argv[0]);
+	}
+    }
+    if (n < 1 || nrays < 1)
+	bu_exit(1, "Usage: %s [-n points] [-r rays]\n", argv[0]);
+
+    pts = (fastf_t *)bu_malloc(sizeof(fastf_t) * 4 * n, "points");
+    if (pnts_bench_write(pts, n) < 0)
+	bu_exit(1, "unable to write the test points\n");
+
+    rays = (struct xray *)bu_malloc(sizeof(struct xray) * nrays, "rays");
+    pnts_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "pnts results");
+    bot_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "bot results");
+    pnts_bench_rays(rays, nrays, n);
+
+    tpnts = shot_bench_shoot(PNTS_BENCH_FILE, "pnts.s", NULL, rays, nrays, pnts_res, &ppnts);
+    tbot = shot_bench_shoot(PNTS_BENCH_FILE, "bot.s", NULL, rays, nrays, bot_res, &pbot);
+    if (tpnts < 0 || tbot < 0)
+	bu_exit(1, "unable to prep %s\n", PNTS_BENCH_FILE);
+
+    bu_log("%d points, %d rays\n", n, nrays);
+    bu_log("%-6s %10s %10s %12s\n", "", "prep", "shot", "rays/s");
+    bu_log("%-6s %9.3fs %9.3fs %12.0f\n", "pnts", ppnts, tpnts, (tpnts > 0) ? nrays / tpnts : 0.0);
+    bu_log("%-6s %9.3fs %9.3fs %12.0f\n", "bot", pbot, tbot, (tbot > 0) ? nrays / tbot : 0.0);
+
+    spans = (fastf_t *)bu_malloc(sizeof(fastf_t) * 2 * n, "spans");
+    expect = (fastf_t *)bu_malloc(sizeof(fastf_t) * SHOT_BENCH_RES, "expected result");
+    for (i = 0; i < nrays; i++) {
+	memset(expect, 0, sizeof(fastf_t) * SHOT_BENCH_RES);
+	pnts_bench_expect(pts, n, &rays[i], spans, expect);
+	bad += shot_bench_diff(expect, &pnts_res[i * SHOT_BENCH_RES], 1, 1.0e-6);
+    }
+    if (bad) {
+	bu_log("%d pnts ray results differ from the union of the point spheres\n", bad);
+	ret = 1;
+    }
+
+    bu_free(expect, "expected result");
+    bu_free(spans, "spans");
+    bu_free(bot_res, "bot results");
+    bu_free(pnts_res, "pnts results");
+    bu_free(rays, "rays");
+    bu_free(pts, "points");
+    bu_file_delete(PNTS_BENCH_FILE);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
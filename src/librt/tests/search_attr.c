@@ -0,0 +1,457 @@
+/*                   S E A R C H _ A T T R . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file search_attr.c
+ *
+ * Checks that -attr filters answered from the attribute index agree
+ * with a full scan while objects and their attributes are edited,
+ * added, renamed and deleted between searches.  An attribute name
+ * holding a pattern character is never looked up in the index, so
+ * "-attr [m]aterial" scans every object the way "-attr material" did
+ * before there was an index.  -param filters, which always scan, are
+ * checked against the objects' parameters read directly.
+ *
+ * Both a file backed and an in-memory database are checked.
+ *
+ * Usage: rt_search_attr
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/log.h"
+#include "bu/str.h"
+#include "vmath.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+static const char *search_attr_file = "rt_search_attr.g";
+
+/* each indexed filter and the scanning filter it must agree with */
+static const char *search_attr_plans[][2] = {
+    {"-attr material", "-attr [m]aterial"},
+    {"-attr material=steel", "-attr [m]aterial=steel"},
+    {"-attr material=l*", "-attr [m]aterial=l*"},
+    {"-attr weight>10", "-attr [w]eight>10"},
+    {"-attr weight<=5", "-attr [w]eight<=5"},
+    {"-not -attr material", "-not -attr [m]aterial"},
+    {"-attr material=steel -or -attr weight=3", "-attr [m]aterial=steel -or -attr [w]eight=3"},
+    {"-type region -attr material=lead", "-type region -attr [m]aterial=lead"},
+    {"-attr material -not -attr material=lead", "-attr [m]aterial -not -attr [m]aterial=lead"},
+    {"-name r* -attr region_id>4", "-name r* -attr [r]egion_id>4"},
+    {NULL, NULL}
+};
+
+static const int search_attr_flags[] = {
+    0,
+    DB_SEARCH_RETURN_UNIQ_DP,
+    -1
+};
+
+static const char *search_attr_materials[] = {"steel", "lead", "wood"};
+
+
+static void
+search_attr_free(struct bu_ptbl *results, int flags)
+{
+    if (flags & DB_SEARCH_RETURN_UNIQ_DP)
+	bu_ptbl_free(results);
+    else
+	db_search_free(results);
+}
+
+
+/* count the indexed searches that differ from their full scans */
+static int
+search_attr_check_attr(struct db_i *dbip, const char *stage)
+{
+    int bad = 0;
+    int p, f;
+    size_t i;
+
+    for (p = 0; search_attr_plans[p][0]; p++) {
+	for (f = 0; search_attr_flags[f] >= 0; f++) {
+	    struct bu_ptbl ires, sres;
+	    int flags = search_attr_flags[f] | DB_SEARCH_QUIET;
+	    int iret, sret;
+
+	    bu_ptbl_init(&ires, 64, "indexed results");
+	    bu_ptbl_init(&sres, 64, "scanned results");
+	    iret = db_search(&ires, flags, search_attr_plans[p][0], 0, NULL, dbip, NULL, NULL, NULL);
+	    sret = db_search(&sres, flags, search_attr_plans[p][1], 0, NULL, dbip, NULL, NULL, NULL);
+
+	    if (iret != sret || BU_PTBL_LEN(&ires) != BU_PTBL_LEN(&sres)) {
+		bu_log("%s: \"%s\" flags %d: %d matches and %zu results, scan found %d and %zu\n",
+		       stage, search_attr_plans[p][0], flags, iret, (size_t)BU_PTBL_LEN(&ires), sret, (size_t)BU_PTBL_LEN(&sres));
+		bad++;
+	    } else {
+		for (i = 0; i < BU_PTBL_LEN(&ires); i++) {
+		    int same;
+		    if (flags & DB_SEARCH_RETURN_UNIQ_DP)
+			same = (BU_PTBL_GET(&ires, i) == BU_PTBL_GET(&sres, i));
+		    else
+			same = db_identical_full_paths((struct db_full_path *)BU_PTBL_GET(&ires, i),
+						       (struct db_full_path *)BU_PTBL_GET(&sres, i));
+		    if (!same) {
+			bu_log("%s: \"%s\" flags %d: result %zu differs from the scan\n",
+			       stage, search_attr_plans[p][0], flags, i);
+			bad++;
+			break;
+		    }
+		}
+	    }
+
+	    search_attr_free(&ires, flags);
+	    search_attr_free(&sres, flags);
+	}
+    }
+
+    return bad;
+}
+
+
+static int
+search_attr_dp_cmp(const void *a, const void *b)
+{
+    const struct directory *da = *(const struct directory **)a;
+    const struct directory *db = *(const struct directory **)b;
+    return bu_strcmp(da->d_namep, db->d_namep);
+}
+
+
+/* -param r_h=2 against every torus's r_h read through ft_get */
+static int
+search_attr_check_param(struct db_i *dbip, const char *stage)
+{
+    struct bu_ptbl res, expected;
+    struct bu_vls val = BU_VLS_INIT_ZERO;
+    struct directory *dp;
+    int bad = 0;
+
+    bu_ptbl_init(&expected, 64, "expected results");
+    FOR_ALL_DIRECTORY_START(dp, dbip) {
+	struct rt_db_internal intern;
+	if (dp->d_addr == RT_DIR_PHONY_ADDR || (dp->d_flags & RT_DIR_COMB))
+	    continue;
+	if (rt_db_get_internal(&intern, dp, dbip, NULL, &rt_uniresource) < 0)
+	    continue;
+	bu_vls_trunc(&val, 0);
+	if (intern.idb_meth->ft_get && intern.idb_meth->ft_get(&val, &intern, "r_h") == BRLCAD_OK
+	    && strtol(bu_vls_cstr(&val), NULL, 10) == 2)
+	    bu_ptbl_ins(&expected, (long *)dp);
+	rt_db_free_internal(&intern);
+    } FOR_ALL_DIRECTORY_END;
+    bu_vls_free(&val);
+
+    bu_ptbl_init(&res, 64, "param results");
+    (void)db_search(&res, DB_SEARCH_RETURN_UNIQ_DP | DB_SEARCH_QUIET, "-param r_h=2", 0, NULL, dbip, NULL, NULL, NULL);
+
+    if (BU_PTBL_LEN(&res) != BU_PTBL_LEN(&expected)) {
+	bu_log("%s: \"-param r_h=2\" found %zu objects, expected %zu\n", stage, (size_t)BU_PTBL_LEN(&res), (size_t)BU_PTBL_LEN(&expected));
+	bad++;
+    } else if (BU_PTBL_LEN(&res)) {
+	size_t i;
+	qsort(BU_PTBL_BASEADDR(&res), BU_PTBL_LEN(&res), sizeof(long *), search_attr_dp_cmp);
+	qsort(BU_PTBL_BASEADDR(&expected), BU_PTBL_LEN(&expected), sizeof(long *), search_attr_dp_cmp);
+	for (i = 0; i < BU_PTBL_LEN(&res); i++) {
+	    if (BU_PTBL_GET(&res, i) != BU_PTBL_GET(&expected, i)) {
+		bu_log("%s: \"-param r_h=2\" result %zu differs\n", stage, i);
+		bad++;
+		break;
+	    }
+	}
+    }
+
+    bu_ptbl_free(&res);
+    bu_ptbl_free(&expected);
+    return bad;
+}
+
+
+static int
+search_attr_check(struct db_i *dbip, const char *stage)
+{
+    return search_attr_check_attr(dbip, stage) + search_attr_check_param(dbip, stage);
+}
+
+
+static void
+search_attr_set(struct db_i *dbip, const char *name, const char *attr, int i)
+{
+    struct bu_vls v = BU_VLS_INIT_ZERO;
+    bu_vls_sprintf(&v, "%d", i);
+    (void)db5_update_attribute(name, attr, bu_vls_cstr(&v), dbip);
+    bu_vls_free(&v);
+}
+
+
+/* spheres with a material and weight, tori with alternating r_h, and
+ * regions of a sphere and a torus */
+static int
+search_attr_write(struct rt_wdb *wdbp, int first, int n)
+{
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    struct bu_vls mname = BU_VLS_INIT_ZERO;
+    int i;
+
+    for (i = first; i < first + n; i++) {
+	struct wmember head;
+	point_t c;
+	vect_t h;
+
+	VSET(c, i * 10.0, 0.0, 0.0);
+	VSET(h, 0.0, 0.0, 1.0);
+	bu_vls_sprintf(&mname, "s%d.s", i);
+	if (mk_sph(wdbp, bu_vls_cstr(&mname), c, 2.0) < 0)
+	    goto fail;
+	if (i % 4)
+	    (void)db5_update_attribute(bu_vls_cstr(&mname), "material", search_attr_materials[i % 3], wdbp->dbip);
+	search_attr_set(wdbp->dbip, bu_vls_cstr(&mname), "weight", i);
+
+	bu_vls_sprintf(&name, "t%d.s", i);
+	if (mk_tor(wdbp, bu_vls_cstr(&name), c, h, 5.0, (i % 2) ? 2.0 : 1.0) < 0)
+	    goto fail;
+
+	BU_LIST_INIT(&head.l);
+	(void)mk_addmember(bu_vls_cstr(&mname), &head.l, NULL, WMOP_UNION);
+	(void)mk_addmember(bu_vls_cstr(&name), &head.l, NULL, WMOP_UNION);
+	bu_vls_sprintf(&name, "r%d.r", i);
+	if (mk_lcomb(wdbp, bu_vls_cstr(&name), &head, 1, NULL, NULL, NULL, 0) < 0)
+	    goto fail;
+	if (i % 3 == 0)
+	    (void)db5_update_attribute(bu_vls_cstr(&name), "material", "lead", wdbp->dbip);
+    }
+
+    bu_vls_free(&mname);
+    bu_vls_free(&name);
+    return 0;
+
+fail:
+    bu_vls_free(&mname);
+    bu_vls_free(&name);
+    return -1;
+}
+
+
+static int
+search_attr_rename(struct db_i *dbip, const char *from, const char *to)
+{
+    struct rt_db_internal intern;
+    struct directory *dp = db_lookup(dbip, from, LOOKUP_QUIET);
+
+    if (dp == RT_DIR_NULL)
+	return -1;
+    if (rt_db_get_internal(&intern, dp, dbip, NULL, &rt_uniresource) < 0)
+	return -1;
+    if (db_rename(dbip, dp, to) < 0) {
+	rt_db_free_internal(&intern);
+	return -1;
+    }
+    /* the new name is written out with the object */
+    if (rt_db_put_internal(dp, dbip, &intern, &rt_uniresource) < 0)
+	return -1;
+    return 0;
+}
+
+
+static int
+search_attr_kill(struct db_i *dbip, const char *name)
+{
+    struct directory *dp = db_lookup(dbip, name, LOOKUP_QUIET);
+
+    if (dp == RT_DIR_NULL)
+	return -1;
+    if (db_delete(dbip, dp) < 0 || db_dirdelete(dbip, dp) < 0)
+	return -1;
+    return 0;
+}
+
+
+static int
+search_attr_set_rh(struct db_i *dbip, const char *name, fastf_t r_h)
+{
+    struct rt_db_internal intern;
+    struct rt_tor_internal *tor;
+    struct directory *dp = db_lookup(dbip, name, LOOKUP_QUIET);
+
+    if (dp == RT_DIR_NULL)
+	return -1;
+    if (rt_db_get_internal(&intern, dp, dbip, NULL, &rt_uniresource) < 0)
+	return -1;
+    tor = (struct rt_tor_internal *)intern.idb_ptr;
+    RT_TOR_CK_MAGIC(tor);
+    tor->r_h = r_h;
+    return (rt_db_put_internal(dp, dbip, &intern, &rt_uniresource) < 0) ? -1 : 0;
+}
+
+
+/* drop one attribute from an object, leaving the others */
+static int
+search_attr_remove(struct db_i *dbip, const char *name, const char *attr)
+{
+    struct bu_attribute_value_set avs;
+    struct directory *dp = db_lookup(dbip, name, LOOKUP_QUIET);
+    int ret;
+
+    if (dp == RT_DIR_NULL)
+	return -1;
+    bu_avs_init_empty(&avs);
+    if (db5_get_attributes(dbip, &avs, dp) < 0) {
+	bu_avs_free(&avs);
+	return -1;
+    }
+    (void)bu_avs_remove(&avs, attr);
+    ret = db5_replace_attributes(dp, &avs, dbip);
+    bu_avs_free(&avs);
+    return ret;
+}
+
+
+static int
+search_attr_run(struct db_i *dbip, struct rt_wdb *wdbp, const char *label)
+{
+    struct bu_vls stage = BU_VLS_INIT_ZERO;
+    int bad = 0;
+    int i;
+
+#define SEARCH_ATTR_STAGE(s) (bu_vls_sprintf(&stage, "%s %s", label, s), bu_vls_cstr(&stage))
+
+    if (search_attr_write(wdbp, 0, 40) < 0) {
+	bu_log("%s: unable to write objects\n", label);
+	return 1;
+    }
+    /* the first search builds the index */
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("initial"));
+
+    /* change, add and remove attribute values */
+    for (i = 0; i < 40; i += 3) {
+	struct bu_vls n = BU_VLS_INIT_ZERO;
+	bu_vls_sprintf(&n, "s%d.s", i);
+	(void)db5_update_attribute(bu_vls_cstr(&n), "material", search_attr_materials[(i + 1) % 3], dbip);
+	search_attr_set(dbip, bu_vls_cstr(&n), "weight", 40 - i);
+	bu_vls_sprintf(&n, "s%d.s", i + 1);
+	(void)search_attr_remove(dbip, bu_vls_cstr(&n), "material");
+	bu_vls_sprintf(&n, "r%d.r", i + 2);
+	(void)db5_update_attribute(bu_vls_cstr(&n), "material", "steel", dbip);
+	bu_vls_free(&n);
+    }
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("attribute edits"));
+
+    /* edit parameters, which rewrites the object with its attributes */
+    for (i = 0; i < 40; i += 5) {
+	struct bu_vls n = BU_VLS_INIT_ZERO;
+	bu_vls_sprintf(&n, "t%d.s", i);
+	(void)search_attr_set_rh(dbip, bu_vls_cstr(&n), (i % 2) ? 1.0 : 2.0);
+	bu_vls_free(&n);
+    }
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("parameter edits"));
+
+    /* new objects */
+    if (search_attr_write(wdbp, 40, 10) < 0)
+	bad++;
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("additions"));
+
+    /* renames */
+    if (search_attr_rename(dbip, "s2.s", "renamed_s2.s") < 0 || search_attr_rename(dbip, "r6.r", "renamed_r6.r") < 0 ||
+	search_attr_rename(dbip, "t7.s", "renamed_t7.s") < 0)
+	bad++;
+    (void)db5_update_attribute("renamed_s2.s", "material", "lead", dbip);
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("renames"));
+
+    /* deletions, whose directory entries the next additions reuse */
+    for (i = 10; i < 20; i++) {
+	struct bu_vls n = BU_VLS_INIT_ZERO;
+	bu_vls_sprintf(&n, "s%d.s", i);
+	if (search_attr_kill(dbip, bu_vls_cstr(&n)) < 0)
+	    bad++;
+	bu_vls_free(&n);
+    }
+    if (search_attr_kill(dbip, "renamed_s2.s") < 0)
+	bad++;
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("deletions"));
+
+    if (search_attr_write(wdbp, 50, 10) < 0)
+	bad++;
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("reused entries"));
+
+    /* an object deleted and written again under the same name */
+    if (search_attr_kill(dbip, "s30.s") < 0)
+	bad++;
+    else {
+	point_t c;
+	VSET(c, 0.0, 10.0, 0.0);
+	if (mk_sph(wdbp, "s30.s", c, 1.0) < 0)
+	    bad++;
+	search_attr_set(dbip, "s30.s", "weight", 99);
+    }
+    bad += search_attr_check(dbip, SEARCH_ATTR_STAGE("recreated"));
+
+    bu_vls_free(&stage);
+    return bad;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct rt_wdb *wdbp;
+    struct db_i *dbip;
+    int bad = 0;
+
+    bu_setprogname(argv[0]);
+
+    if (argc != 1)
+	bu_exit(1, "Usage: %s\n", argv[0]);
+
+    /* file backed */
+    bu_file_delete(search_attr_file);
+    wdbp = wdb_fopen(search_attr_file);
+    if (!wdbp)
+	bu_exit(1, "unable to create %s\n", search_attr_file);
+    bad += search_attr_run(wdbp->dbip, wdbp, "file");
+    wdb_close(wdbp);
+    bu_file_delete(search_attr_file);
+
+    /* in-memory */
+    dbip = db_open_inmem();
+    if (dbip == DBI_NULL)
+	bu_exit(1, "unable to open an in-memory database\n");
+    wdbp = wdb_dbopen(dbip, RT_WDB_TYPE_DB_INMEM);
+    bad += search_attr_run(dbip, wdbp, "inmem");
+    wdb_close(wdbp);
+
+    if (bad)
+	bu_log("%d checks failed\n", bad);
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,269 @@
+/*                  S E A R C H _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file search_bench.c
+ *
+ * Writes a database of instanced assemblies, runs a set of db_search()
+ * filters over it once walking and evaluating every path in one thread
+ * (db_search_serial()) and once in parallel, reports the time each
+ * took, and fails unless both give the same results in the same order.
+ *
+ * Usage: rt_search_bench [-n regions]
+ */
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/str.h"
+#include "bu/time.h"
+#include "vmath.h"
+#include "bn/mat.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#include "../librt_private.h"
+
+static const char *search_bench_file = "rt_search_bench.g";
+
+static const char *search_bench_plans[] = {
+    "-name *.s",
+    "-type region",
+    "-attr material=steel",
+    "-attr material -not -attr material=lead",
+    "-type comb -nnodes >2",
+    "-bool -",
+    "-below -name a*",
+    "-name *.r -above -name s1*.s",
+    "-mindepth 3 -name s*",
+    NULL
+};
+
+static const int search_bench_flags[] = {
+    0,
+    DB_SEARCH_RETURN_UNIQ_DP,
+    DB_SEARCH_FLAT,
+    -1
+};
+
+
+/* regions of two spheres less a third, each used by several of the
+ * assemblies, and a few tops that each use every assembly */
+static int
+search_bench_write(int nreg)
+{
+    struct rt_wdb *wdbp;
+    struct bu_vls name = BU_VLS_INIT_ZERO;
+    struct bu_vls mname = BU_VLS_INIT_ZERO;
+    int nasm = nreg / 25 + 1;
+    int i, k;
+
+    bu_file_delete(search_bench_file);
+    wdbp = wdb_fopen(search_bench_file);
+    if (!wdbp)
+	return -1;
+
+    for (i = 0; i < nreg; i++) {
+	struct wmember head;
+	BU_LIST_INIT(&head.l);
+
+	for (k = 0; k < 3; k++) {
+	    point_t c;
+	    bu_vls_sprintf(&mname, "s%d_%d.s", i, k);
+	    VSET(c, i * 10.0 + k, 0.0, 0.0);
+	    if (mk_sph(wdbp, bu_vls_cstr(&mname), c, 2.0 - k * 0.5) < 0)
+		goto fail;
+	    if (i % 4 == k)
+		(void)db5_update_attribute(bu_vls_cstr(&mname), "material", (i % 3) ? "steel" : "lead", wdbp->dbip);
+	    (void)mk_addmember(bu_vls_cstr(&mname), &head.l, NULL, (k == 2) ? WMOP_SUBTRACT : WMOP_UNION);
+	}
+	bu_vls_sprintf(&name, "r%d.r", i);
+	if (mk_lcomb(wdbp, bu_vls_cstr(&name), &head, 1, NULL, NULL, NULL, 0) < 0)
+	    goto fail;
+	if (i % 5 == 0)
+	    (void)db5_update_attribute(bu_vls_cstr(&name), "material", "steel", wdbp->dbip);
+    }
+
+    for (i = 0; i < nasm; i++) {
+	struct wmember head;
+	BU_LIST_INIT(&head.l);
+
+	for (k = 0; k < 50; k++) {
+	    mat_t m;
+	    MAT_IDN(m);
+	    MAT_DELTAS(m, 0.0, k * 5.0, i * 5.0);
+	    bu_vls_sprintf(&mname, "r%d.r", (i * 7 + k * 13) % nreg);
+	    (void)mk_addmember(bu_vls_cstr(&mname), &head.l, m, WMOP_UNION);
+	}
+	bu_vls_sprintf(&name, "a%d", i);
+	if (mk_lcomb(wdbp, bu_vls_cstr(&name), &head, 0, NULL, NULL, NULL, 0) < 0)
+	    goto fail;
+    }
+
+    for (i = 0; i < 4; i++) {
+	struct wmember head;
+	BU_LIST_INIT(&head.l);
+
+	for (k = 0; k < nasm; k++) {
+	    bu_vls_sprintf(&mname, "a%d", k);
+	    (void)mk_addmember(bu_vls_cstr(&mname), &head.l, NULL, WMOP_UNION);
+	}
+	bu_vls_sprintf(&name, "top%d", i);
+	if (mk_lcomb(wdbp, bu_vls_cstr(&name), &head, 0, NULL, NULL, NULL, 0) < 0)
+	    goto fail;
+    }
+
+    bu_vls_free(&mname);
+    bu_vls_free(&name);
+    wdb_close(wdbp);
+    return 0;
+
+fail:
+    bu_vls_free(&mname);
+    bu_vls_free(&name);
+    wdb_close(wdbp);
+    return -1;
+}
+
+
+static int
+search_bench_run(struct db_i *dbip, const char *plan, int flags, int serial, struct bu_ptbl *results, double *t)
+{
+    int64_t start;
+    int ret;
+
+    bu_ptbl_init(results, 64, "search results");
+    start = bu_gettime();
+    if (serial)
+	ret = db_search_serial(results, flags | DB_SEARCH_QUIET, plan, 0, NULL, dbip, NULL, NULL, NULL);
+    else
+	ret = db_search(results, flags | DB_SEARCH_QUIET, plan, 0, NULL, dbip, NULL, NULL, NULL);
+    *t += (bu_gettime() - start) / 1000000.0;
+    return ret;
+}
+
+
+static void
+search_bench_free(struct bu_ptbl *results, int flags)
+{
+    if (flags & (DB_SEARCH_FLAT | DB_SEARCH_RETURN_UNIQ_DP))
+	bu_ptbl_free(results);
+    else
+	db_search_free(results);
+}
+
+
+/* count how the parallel results differ from the serial ones */
+static int
+search_bench_compare(const char *plan, int flags, int sret, struct bu_ptbl *sres, int pret, struct bu_ptbl *pres)
+{
+    size_t i;
+
+    if (sret != pret || BU_PTBL_LEN(sres) != BU_PTBL_LEN(pres)) {
+	bu_log("\"%s\" flags %d: %d matches and %zu results, expected %d and %zu\n",
+	       plan, flags, pret, (size_t)BU_PTBL_LEN(pres), sret, (size_t)BU_PTBL_LEN(sres));
+	return 1;
+    }
+    for (i = 0; i < BU_PTBL_LEN(sres); i++) {
+	int same;
+	if (flags & (DB_SEARCH_FLAT | DB_SEARCH_RETURN_UNIQ_DP))
+	    same = (BU_PTBL_GET(sres, i) == BU_PTBL_GET(pres, i));
+	else
+	    same = db_identical_full_paths((struct db_full_path *)BU_PTBL_GET(sres, i),
+					   (struct db_full_path *)BU_PTBL_GET(pres, i));
+	if (!same) {
+	    bu_log("\"%s\" flags %d: result %zu differs\n", plan, flags, i);
+	    return 1;
+	}
+    }
+    return 0;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    struct db_i *dbip;
+    int nreg = 2000;
+    int c, p, f;
+    int bad = 0;
+
+    bu_setprogname(argv[0]);
+
+    while ((c = bu_getopt(argc, argv, "n:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		nreg = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n regions]\n", argv[0]);
+	}
+    }
+    if (nreg < 1)
+	bu_exit(1, "Usage: %s [-n regions]\n", argv[0]);
+
+    if (search_bench_write(nreg) < 0)
+	bu_exit(1, "unable to write %s\n", search_bench_file);
+    dbip = db_open(search_bench_file, DB_OPEN_READONLY);
+    if (dbip == DBI_NULL || db_dirbuild(dbip) < 0)
+	bu_exit(1, "unable to open %s\n", search_bench_file);
+
+    for (p = 0; search_bench_plans[p]; p++) {
+	double tserial = 0.0, tparallel = 0.0;
+
+	for (f = 0; search_bench_flags[f] >= 0; f++) {
+	    struct bu_ptbl sres, pres;
+	    int flags = search_bench_flags[f];
+	    int sret, pret;
+
+	    sret = search_bench_run(dbip, search_bench_plans[p], flags, 1, &sres, &tserial);
+	    pret = search_bench_run(dbip, search_bench_plans[p], flags, 0, &pres, &tparallel);
+
+	    bad += search_bench_compare(search_bench_plans[p], flags, sret, &sres, pret, &pres);
+	    search_bench_free(&sres, flags);
+	    search_bench_free(&pres, flags);
+	}
+
+	bu_log("\"%s\": serial %.3fs, parallel %.3fs, %.2fx\n", search_bench_plans[p],
+	       tserial, tparallel, (tparallel > 0) ? tserial / tparallel : 0.0);
+    }
+
+    db_close(dbip);
+    bu_file_delete(search_bench_file);
+
+    if (bad)
+	bu_log("%d searches differ\n", bad);
+    return (bad) ? 1 : 0;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
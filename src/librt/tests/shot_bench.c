@@ -0,0 +1,184 @@
+/*                    S H O T _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file shot_bench.c
+ *
+ * Scaffolding shared by the primitive shot benchmarks, see
+ * shot_bench.h.
+ */
+
+#include "common.h"
+
+#include <string.h>
+
+#include "bu/log.h"
+#include "bu/time.h"
+#include "vmath.h"
+#include "raytrace.h"
+
+#include "./shot_bench.h"
+
+
+static int
+shot_bench_hit(struct application *ap, struct partition *PartHeadp, struct seg *UNUSED(segs))
+{
+    fastf_t *d = (fastf_t *)ap->a_uptr;
+    struct partition *pp;
+    int i = 0;
+
+    for (pp = PartHeadp->pt_forw; pp != PartHeadp && i < SHOT_BENCH_PARTS; pp = pp->pt_forw, i++) {
+	d[2*i] = pp->pt_inhit->hit_dist;
+	d[2*i+1] = pp->pt_outhit->hit_dist;
+    }
+    d[2*SHOT_BENCH_PARTS] = i;
+    return 1;
+}
+
+
+static int
+shot_bench_miss(struct application *UNUSED(ap))
+{
+    return 0;
+}
+
+
+/* release each solid's prep and redo it with ref, or with its own
+ * ft_prep so both sides of a comparison are timed the same way */
+static int
+shot_bench_reprep(struct rt_i *rtip, shot_bench_prep_t ref)
+{
+    struct soltab *stp;
+    int ret = 0;
+
+    RT_VISIT_ALL_SOLTABS_START(stp, rtip) {
+	struct rt_db_internal intern;
+
+	if (ret || stp->st_aradius <= -1)
+	    continue;
+	if (rt_db_get_internal(&intern, stp->st_dp, rtip->rti_dbip, stp->st_matp, &rt_uniresource) < 0) {
+	    bu_log("%s: unable to reload\n", stp->st_dp->d_namep);
+	    ret = -1;
+	    continue;
+	}
+	stp->st_meth->ft_free(stp);
+	stp->st_specific = NULL;
+	if ((ref) ? ref(stp, &intern, rtip) : stp->st_meth->ft_prep(stp, &intern, rtip)) {
+	    bu_log("%s: prep failed\n", stp->st_dp->d_namep);
+	    ret = -1;
+	}
+	rt_db_free_internal(&intern);
+    } RT_VISIT_ALL_SOLTABS_END
+
+    return ret;
+}
+
+
+struct rt_i *
+shot_bench_prep(const char *file, const char *obj, shot_bench_prep_t ref, double *prep)
+{
+    struct rt_i *rtip;
+    int64_t start;
+
+    rtip = rt_dirbuild(file, NULL, 0);
+    if (!rtip)
+	return NULL;
+
+    if (rt_gettree(rtip, obj) < 0) {
+	rt_free_rti(rtip);
+	return NULL;
+    }
+    start = bu_gettime();
+    if (shot_bench_reprep(rtip, ref) < 0) {
+	rt_free_rti(rtip);
+	return NULL;
+    }
+    rt_prep_parallel(rtip, 1);
+    if (prep)
+	*prep = (bu_gettime() - start) / 1000000.0;
+
+    return rtip;
+}
+
+
+double
+shot_bench_fire(struct rt_i *rtip, const struct xray *rays, int nrays, fastf_t *res)
+{
+    struct application ap;
+    int64_t start;
+    int i;
+
+    RT_APPLICATION_INIT(&ap);
+    ap.a_rt_i = rtip;
+    ap.a_resource = &rt_uniresource;
+    ap.a_hit = shot_bench_hit;
+    ap.a_miss = shot_bench_miss;
+    ap.a_onehit = 0;
+
+    memset(res, 0, sizeof(fastf_t) * nrays * SHOT_BENCH_RES);
+    start = bu_gettime();
+    for (i = 0; i < nrays; i++) {
+	VMOVE(ap.a_ray.r_pt, rays[i].r_pt);
+	VMOVE(ap.a_ray.r_dir, rays[i].r_dir);
+	ap.a_uptr = (void *)&res[i * SHOT_BENCH_RES];
+	(void)rt_shootray(&ap);
+    }
+
+    return (bu_gettime() - start) / 1000000.0;
+}
+
+
+double
+shot_bench_shoot(const char *file, const char *obj, shot_bench_prep_t ref, const struct xray *rays, int nrays, fastf_t *res, double *prep)
+{
+    struct rt_i *rtip;
+    double elapsed;
+
+    rtip = shot_bench_prep(file, obj, ref, prep);
+    if (!rtip)
+	return -1.0;
+    elapsed = shot_bench_fire(rtip, rays, nrays, res);
+    rt_free_rti(rtip);
+
+    return elapsed;
+}
+
+
+int
+shot_bench_diff(const fastf_t *a, const fastf_t *b, int nrays, fastf_t tol)
+{
+    int i, bad = 0;
+
+    for (i = 0; i < nrays * SHOT_BENCH_RES; i++) {
+	if (!NEAR_EQUAL(a[i], b[i], tol))
+	    bad++;
+    }
+
+    return bad;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,78 @@
+/*                    S H O T _ B E N C H . H
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file shot_bench.h
+ *
+ * Scaffolding shared by the primitive shot benchmarks: prep a test
+ * object, optionally redoing the prep of its solids with a reference
+ * algorithm, fire a set of rays at it recording the partitions each
+ * ray sees, and compare two sets of those records.
+ */
+
+#ifndef LIBRT_TESTS_SHOT_BENCH_H
+#define LIBRT_TESTS_SHOT_BENCH_H
+
+#include "common.h"
+
+#include "vmath.h"
+#include "raytrace.h"
+
+/* each ray records the in/out distances of up to this many partitions,
+ * followed by the number of partitions recorded */
+#define SHOT_BENCH_PARTS 16
+#define SHOT_BENCH_RES (2 * SHOT_BENCH_PARTS + 1)
+
+/* an alternative ft_prep, e.g. rt_dsp_prep_recursive() */
+typedef int (*shot_bench_prep_t)(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip);
+
+/**
+ * Load obj from file and prep it.  Every solid is then released and
+ * prepped again from its internal form, with ref if it is non-NULL and
+ * with the solid's own ft_prep otherwise.  If prep is non-NULL it gets
+ * the seconds spent in that second prep plus rt_prep_parallel().
+ * Returns NULL on failure.
+ */
+extern struct rt_i *shot_bench_prep(const char *file, const char *obj, shot_bench_prep_t ref, double *prep);
+
+/**
+ * Fire the nrays rays at rtip, storing SHOT_BENCH_RES values per ray
+ * in res.  Returns the elapsed seconds.
+ */
+extern double shot_bench_fire(struct rt_i *rtip, const struct xray *rays, int nrays, fastf_t *res);
+
+/**
+ * shot_bench_prep() and shot_bench_fire() on a fresh rt_i, released
+ * afterwards.  Returns the shot time or a negative value on failure.
+ */
+extern double shot_bench_shoot(const char *file, const char *obj, shot_bench_prep_t ref, const struct xray *rays, int nrays, fastf_t *res, double *prep);
+
+/** Count the values of two nrays sets of records more than tol apart. */
+extern int shot_bench_diff(const fastf_t *a, const fastf_t *b, int nrays, fastf_t tol);
+
+#endif /* LIBRT_TESTS_SHOT_BENCH_H */
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -0,0 +1,238 @@
+/*                     V O L _ B E N C H . C
+ * BRL-CAD
+ *
+ * Copyright (c) 2025 United States Government as represented by
+ * the U.S. Army Research Laboratory.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * version 2.1 as published by the Free Software Foundation.
+ *
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this file; see the file named COPYING for more
+ * information.
+ */
+/** @file vol_bench.c
+ *
+ * Shoots the same rays at a mostly empty VOL, like a CT scan, and at an
+ * EBM, once marching every cell of the dense map (rt_vol_prep_dense(),
+ * rt_ebm_prep_dense()) and once skipping through the sparse bricks.  It
+ * reports the prep and shot times and the storage each uses, and fails
+ * if any ray's partitions differ.
+ *
+ * Usage: rt_vol_bench [-n cells] [-r rays]
+ */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "bu/app.h"
+#include "bu/file.h"
+#include "bu/getopt.h"
+#include "bu/log.h"
+#include "bu/malloc.h"
+#include "bu/str.h"
+#include "vmath.h"
+#include "bn/randmt.h"
+#include "raytrace.h"
+#include "wdb.h"
+
+#include "../librt_private.h"
+#include "./shot_bench.h"
+
+#define VOL_BENCH_FILE "rt_vol_bench.g"
+
+/* a few noisy blobs in an otherwise empty n^3 volume, and their
+ * footprint as an n x n bitmap */
+static int
+vol_bench_write(int n)
+{
+    struct rt_wdb *wdbp;
+    struct rt_ebm_internal *ebm;
+    unsigned char *vox, *pix;
+    vect_t cellsize;
+    mat_t mat;
+    int b, x, y, z;
+
+    wdbp = wdb_fopen(VOL_BENCH_FILE);
+    if (!wdbp) {
+	bu_log("unable to create %s\n", VOL_BENCH_FILE);
+	return -1;
+    }
+
+    vox = (unsigned char *)bu_calloc((size_t)n * n * n, 1, "voxels");
+    pix = (unsigned char *)bu_calloc((size_t)n * n, 1, "pixels");
+    for (b = 0; b < 8; b++) {
+	int cx = (int)(bn_randmt() * n);
+	int cy = (int)(bn_randmt() * n);
+	int cz = (int)(bn_randmt() * n);
+	int r = 2 + (int)(bn_randmt() * n / 10);
+
+	for (z = 0; z < n; z++) {
+	    for (y = 0; y < n; y++) {
+		for (x = 0; x < n; x++) {
+		    int d2 = (x-cx)*(x-cx) + (y-cy)*(y-cy) + (z-cz)*(z-cz);
+		    if (d2 >= r*r)
+			continue;
+		    vox[((size_t)z * n + y) * n + x] = (bn_randmt() < 0.1) ? 20 : 200;
+		    pix[(size_t)y * n + x] = 1;
+		}
+	    }
+	}
+    }
+    mk_binunif(wdbp, "vol.data", vox, WDB_BINUNIF_UINT8, (long)n * n * n);
+    mk_binunif(wdbp, "ebm.data", pix, WDB_BINUNIF_UINT8, (long)n * n);
+    bu_free(vox, "voxels");
+    bu_free(pix, "pixels");
+
+    MAT_IDN(mat);
+    VSETALL(cellsize, 1.0);
+    if (mk_vol(wdbp, "vol.s", RT_VOL_SRC_OBJ, "vol.data", n, n, n, 100, 255, cellsize, mat) < 0) {
+	wdb_close(wdbp);
+	return -1;
+    }
+
+    BU_ALLOC(ebm, struct rt_ebm_internal);
+    ebm->magic = RT_EBM_INTERNAL_MAGIC;
+    bu_strlcpy(ebm->name, "ebm.data", RT_EBM_NAME_LEN);
+    ebm->datasrc = RT_EBM_SRC_OBJ;
+    ebm->xdim = n;
+    ebm->ydim = n;
+    ebm->tallness = n;
+    MAT_COPY(ebm->mat, mat);
+    if (wdb_export(wdbp, "ebm.s", (void *)ebm, ID_EBM, 1.0) < 0) {
+	wdb_close(wdbp);
+	return -1;
+    }
+
+    wdb_close(wdbp);
+    return 0;
+}
+
+
+/* rays between random points on two faces of the grid's bounds */
+static void
+vol_bench_rays(struct xray *rays, int nrays, int n)
+{
+    int i;
+
+    for (i = 0; i < nrays; i++) {
+	point_t p, q;
+
+	if (i & 1) {
+	    VSET(p, -1, bn_randmt() * n, bn_randmt() * n);
+	    VSET(q, n + 1, bn_randmt() * n, bn_randmt() * n);
+	} else {
+	    VSET(p, bn_randmt() * n, bn_randmt() * n, -1);
+	    VSET(q, bn_randmt() * n, bn_randmt() * n, n + 1);
+	}
+	VMOVE(rays[i].r_pt, p);
+	VSUB2(rays[i].r_dir, q, p);
+	VUNITIZE(rays[i].r_dir);
+    }
+}
+
+
+/* the solid's own prep, reporting the brick storage it builds */
+static int
+vol_bench_prep_bricks(struct soltab *stp, struct rt_db_internal *ip, struct rt_i *rtip)
+{
+    int ret;
+
+    rt_debug |= RT_DEBUG_VOL | RT_DEBUG_EBM;
+    ret = stp->st_meth->ft_prep(stp, ip, rtip);
+    rt_debug &= ~(RT_DEBUG_VOL | RT_DEBUG_EBM);
+    return ret;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    const char *objs[2] = {"vol.s", "ebm.s"};
+    shot_bench_prep_t dense[2] = {rt_vol_prep_dense, rt_ebm_prep_dense};
+    int n = 256;
+    int nrays = 100000;
+    int c, o;
+    int ret = 0;
+    struct xray *rays;
+    fastf_t *dense_res, *brick_res;
+
+    bu_setprogname(argv[0]);
+    bn_randmt_seed(5489);
+
+    while ((c = bu_getopt(argc, argv, "n:r:h?")) != -1) {
+	switch (c) {
+	    case 'n':
+		n = atoi(bu_optarg);
+		break;
+	    case 'r':
+		nrays = atoi(bu_optarg);
+		break;
+	    default:
+		bu_exit(1, "Usage: %s [-n cells] [-r rays]\n", argv[0]);
+	}
+    }
+    if (n < 2 || nrays < 1)
+	bu_exit(1, "Usage: %s [-n cells] [-r rays]\n", argv[0]);
+
+    if (vol_bench_write(n) < 0)
+	bu_exit(1, "unable to write the test volume\n");
+
+    rays = (struct xray *)bu_malloc(sizeof(struct xray) * nrays, "rays");
+    dense_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "dense results");
+    brick_res = (fastf_t *)bu_malloc(sizeof(fastf_t) * nrays * SHOT_BENCH_RES, "brick results");
+    vol_bench_rays(rays, nrays, n);
+
+    bu_log("%d^3 volume, %d^2 bitmap, %d rays\n", n, n, nrays);
+    bu_log("dense map: %zu bytes VOL, %zu bytes EBM\n",
+	   (size_t)(n + 4) * (n + 4) * (n + 4), (size_t)(n + 4) * (n + 4));
+    bu_log("%-6s %10s %10s %10s %10s %8s\n", "", "prep", "dense", "prep", "bricks", "speedup");
+
+    for (o = 0; o < 2; o++) {
+	double pdense, pbrick, tdense, tbrick;
+	int bad;
+
+	tdense = shot_bench_shoot(VOL_BENCH_FILE, objs[o], dense[o], rays, nrays, dense_res, &pdense);
+	tbrick = shot_bench_shoot(VOL_BENCH_FILE, objs[o], vol_bench_prep_bricks, rays, nrays, brick_res, &pbrick);
+	if (tdense < 0 || tbrick < 0) {
+	    bu_log("unable to prep %s\n", objs[o]);
+	    ret = 1;
+	    break;
+	}
+
+	bad = shot_bench_diff(dense_res, brick_res, nrays, 1.0e-6);
+
+	bu_log("%-6s %9.3fs %9.3fs %9.3fs %9.3fs %7.2fx\n", objs[o], pdense, tdense, pbrick, tbrick, (tbrick > 0) ? tdense / tbrick : 0.0);
+	if (bad) {
+	    bu_log("%d %s ray results differ between the dense and brick marches\n", bad, objs[o]);
+	    ret = 1;
+	}
+    }
+
+    bu_free(brick_res, "brick results");
+    bu_free(dense_res, "dense results");
+    bu_free(rays, "rays");
+    bu_file_delete(VOL_BENCH_FILE);
+
+    return ret;
+}
+
+
+/*
+ * Local Variables:
+ * mode: C
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * c-file-style: "stroustrup"
+ * End:
+ * ex: shiftwidth=4 tabstop=8
+ */
@@ -58,12 +58,20 @@ qged_post_opendb_clbk(int UNUSED(ac), const char **UNUSED(av), void *UNUSED(gedp
     }
     QString fileName(a->mdl->gedp->dbip->dbi_filename);
     a->w->statusBar()->showMessage(fileName);
+
+    // Build any missing mesh LoD data in the background, so large BoTs
+    // can be drawn adaptively without blocking the GUI.  Objects drawn
+    // in the meantime are moved to the front of the queue.
+    db_mesh_lod_start(a->mdl->gedp->dbip, 0);
+    a->lod_timer->start(1000);
     return BRLCAD_OK;
 }
 
 int
-qged_pre_closedb_clbk(int UNUSED(ac), const char **UNUSED(av), void *UNUSED(gedp), void *UNUSED(ctx))
+qged_pre_closedb_clbk(int UNUSED(ac), const char **UNUSED(av), void *UNUSED(gedp), void *ctx)
 {
+    QgEdApp *a = (QgEdApp *)ctx;
+    a->lod_timer->stop();
     return BRLCAD_OK;
 }
 
@@ -244,6 +252,10 @@ QgEdApp::QgEdApp(int &argc, char *argv[], int swrast_mode, int quad_mode) :QAppl
 	bu_exit(EXIT_FAILURE, "OpenGL failed to initialize properly.  Recommend running qged with '-s' option to use fallback swrast rendering.");
     }
 
+    // Background LoD generation progress, started when a database is opened
+    lod_timer = new QTimer(this);
+    QObject::connect(lod_timer, &QTimer::timeout, this, &QgEdApp::lod_progress);
+
     // Assign QGED specific open/close db handlers to the gedp
     ged_clbk_set(mdl->gedp, "opendb", BU_CLBK_PRE, &qged_pre_opendb_clbk, (void *)qApp);
     ged_clbk_set(mdl->gedp, "opendb", BU_CLBK_POST, &qged_post_opendb_clbk, (void *)qApp);
@@ -311,6 +323,24 @@ QgEdApp::~QgEdApp() {
     // TODO - free rt_vlfree?
 }
 
+void
+QgEdApp::lod_progress()
+{
+    struct db_i *dbip = mdl->gedp->dbip;
+    int completed = 0;
+    int target = 0;
+    int running = db_mesh_lod_progress(dbip, &completed, &target);
+
+    if (running) {
+	w->statusBar()->showMessage(QString("Generating LoD data: %1 of %2 meshes").arg(completed).arg(target));
+	return;
+    }
+
+    lod_timer->stop();
+    if (dbip && target)
+	w->statusBar()->showMessage(QString("LoD data ready for %1 meshes").arg(target), 5000);
+}
+
 void
 QgEdApp::do_quad_view_change(QgView *cv)
 {
@@ -33,6 +33,7 @@
 #include <QMap>
 #include <QSet>
 #include <QModelIndex>
+#include <QTimer>
 
 #include "bv.h"
 #include "raytrace.h"
@@ -96,8 +97,13 @@ class QgEdApp : public QApplication
 	void run_qcmd(const QString &command);
 	void element_selected(QgToolPaletteElement *el);
 
+	// Polled while mesh LoD data is generated in the background after
+	// a database is opened, to report progress in the status bar
+	void lod_progress();
+
     public:
 	QgEdMainWindow *w = NULL;
+	QTimer *lod_timer = NULL;
 
     private:
 	std::vector<char *> tmp_av;
@@ -103,6 +103,8 @@ extern int gettimeofday(struct timeval *, void *);
 #define N_SERVER_ASSIGNMENTS	1		/* desired # of assignments */
 #define MIN_ASSIGNMENT_TIME	5		/* desired seconds/result */
 #define SERVER_CHECK_INTERVAL	(10*60)		/* seconds */
+#define RATE_HISTORY		8		/* # of pix/sec samples kept */
+#define SPECULATE_FACTOR	3.0		/* overdue multiple to re-issue */
 #ifndef RSH
 #  define RSH "/usr/ucb/rsh"
 #endif
@@ -214,6 +216,10 @@ struct servers {
     int sr_nsamp;	/* number of samples summed over */
     double sr_prep_cpu;	/* sum of cpu time for preps */
     double sr_l_percent;	/* last: percent of CPU */
+    double sr_rate_hist[RATE_HISTORY];	/* recent pix/elapsed_sec samples */
+    int sr_rate_n;	/* # of valid entries in sr_rate_hist */
+    int sr_rate_next;	/* next sr_rate_hist slot to overwrite */
+    int sr_nspec;	/* # of speculative assignments won */
 } servers[MAXSERVERS];
 
 
@@ -244,8 +250,12 @@ struct timeval last_server_check_time;
 struct list {
     struct bu_list l;
     struct frame *li_frame;
+    long li_fnum;	/* frame number, valid even after frame is gone */
     int li_start;
     int li_stop;
+    int li_flags;
+#define LI_SPECULATIVE	0x1	/* duplicate of a tardy assignment */
+#define LI_STALE	0x2	/* twin finished first, discard result */
 };
 
 
@@ -254,13 +264,14 @@ struct bu_list FreeList;
 #define LIST_NULL ((struct list*)0)
 #define LIST_MAGIC 0x4c494c49
 
-#define GET_LIST(p) if (BU_LIST_IS_EMPTY(&FreeList)) { \
-	BU_ALLOC((p), struct list); \
-	(p)->l.magic = LIST_MAGIC; \
-    } else { \
-	(p) = BU_LIST_FIRST(list, &FreeList); \
-	BU_LIST_DEQUEUE(&(p)->l); \
-    }
+#define GET_LIST(p) { if (BU_LIST_IS_EMPTY(&FreeList)) { \
+	    BU_ALLOC((p), struct list); \
+	    (p)->l.magic = LIST_MAGIC; \
+	} else { \
+	    (p) = BU_LIST_FIRST(list, &FreeList); \
+	    BU_LIST_DEQUEUE(&(p)->l); \
+	} \
+	(p)->li_flags = 0; }
 
 #define FREE_LIST(p) { BU_LIST_APPEND(&FreeList, &(p)->l); }
 
@@ -381,6 +392,7 @@ int rem_debug;		/* dispatcher debugging flag */
 #define OPT_LOAD 1	/* 10% per server per frame */
 #define OPT_MOVIE 2	/* one server per frame */
 int work_allocate_method = OPT_MOVIE;
+int speculate = 1;	/* re-issue overdue work to idle servers */
 char *allocate_method[] = {
     "Frame",
     "Load Averaging",
@@ -463,6 +475,35 @@ remrt_log(const char *msg)
 }
 
 
+/*
+ * Search the other servers for a live assignment covering the same
+ * pixel range of the same frame as 'lp', which is owned by 'sp'.
+ * Such twins exist only when an overdue assignment has been
+ * speculatively re-issued.
+ */
+static struct list *
+find_twin(struct servers *sp, struct list *lp)
+{
+    struct servers *osp;
+    struct list *olp;
+
+    if (lp->li_frame == FRAME_NULL) return LIST_NULL;
+
+    for (osp = &servers[0]; osp < &servers[MAXSERVERS]; osp++) {
+	if (osp == sp || osp->sr_pc == PKC_NULL) continue;
+	if (osp->sr_state == SRST_CLOSING) continue;
+	for (BU_LIST_FOR(olp, list, &osp->sr_work)) {
+	    if (olp->li_flags & LI_STALE) continue;
+	    if (olp->li_frame != lp->li_frame) continue;
+	    if (olp->li_start != lp->li_start ||
+		olp->li_stop != lp->li_stop) continue;
+	    return olp;
+	}
+    }
+    return LIST_NULL;
+}
+
+
 /*
  * Note that final connection closeout is handled in schedule(),
  * to prevent recursion problems.
@@ -510,9 +551,26 @@ drop_server(struct servers *sp, char *why)
 
     /* Need to requeue any work that was in progress */
     while (BU_LIST_WHILE(lp, list, &sp->sr_work)) {
+	struct list *twin;
+
+	BU_LIST_DEQUEUE(&lp->l);
+	if (lp->li_flags & LI_STALE) {
+	    /* Already finished elsewhere */
+	    FREE_LIST(lp);
+	    continue;
+	}
 	fr = lp->li_frame;
 	CHECK_FRAME(fr);
-	BU_LIST_DEQUEUE(&lp->l);
+	if ((twin = find_twin(sp, lp)) != LIST_NULL) {
+	    /* Another server is already computing this range */
+	    bu_log("%s fr%ld %d..%d left to speculative twin\n",
+		   stamp(),
+		   fr->fr_number,
+		   lp->li_start, lp->li_stop);
+	    twin->li_flags &= ~LI_SPECULATIVE;
+	    FREE_LIST(lp);
+	    continue;
+	}
 	bu_log("%s requeueing fr%ld %d..%d\n",
 	       stamp(),
 	       fr->fr_number,
@@ -849,6 +907,7 @@ prep_frame(struct frame *fr)
     BU_LIST_INIT(&fr->fr_todo);
     GET_LIST(lp);
     lp->li_frame = fr;
+    lp->li_fnum = fr->fr_number;
     lp->li_start = 0;
     lp->li_stop = fr->fr_width*fr->fr_height-1;	/* last pixel # */
     BU_LIST_INSERT(&fr->fr_todo, &lp->l);
@@ -938,6 +997,7 @@ list_remove(struct bu_list *lhp, int a, int b)
 		   b+1, lp->li_stop);
 	    GET_LIST(lp2);
 	    lp2->li_frame = lp->li_frame;
+	    lp2->li_fnum = lp->li_fnum;
 	    lp2->li_start = b+1;
 	    lp2->li_stop = lp->li_stop;
 	    lp->li_stop = a-1;
@@ -1284,13 +1344,18 @@ pr_list(struct bu_list *lhp)
     struct list *lp;
 
     for (BU_LIST_FOR(lp, list, lhp)) {
-	if (lp->li_frame == 0) {
+	if (lp->li_flags & LI_STALE) {
+	    bu_log("\t%d..%d frame %ld (stale)\n",
+		   lp->li_start, lp->li_stop,
+		   lp->li_fnum);
+	} else if (lp->li_frame == 0) {
 	    bu_log("\t%d..%d frame *NULL*??\n",
 		   lp->li_start, lp->li_stop);
 	} else {
-	    bu_log("\t%d..%d frame %ld\n",
+	    bu_log("\t%d..%d frame %ld%s\n",
 		   lp->li_start, lp->li_stop,
-		   lp->li_frame->fr_number);
+		   lp->li_frame->fr_number,
+		   (lp->li_flags & LI_SPECULATIVE) ? " (speculative)" : "");
 	}
     }
 }
@@ -1354,6 +1419,48 @@ server_q_len(struct servers *sp)
 }
 
 
+/*
+ * Add one pix/elapsed_sec sample to the server's throughput history.
+ */
+static void
+record_rate(struct servers *sp, double rate)
+{
+    sp->sr_rate_hist[sp->sr_rate_next] = rate;
+    sp->sr_rate_next = (sp->sr_rate_next + 1) % RATE_HISTORY;
+    if (sp->sr_rate_n < RATE_HISTORY)
+	sp->sr_rate_n++;
+}
+
+
+/*
+ * Estimate the throughput of a server in pixels per elapsed second.
+ * The median of the recent history is used, so that a single
+ * assignment that was delayed by network or local load does not
+ * shrink (or a single fast one grow) the next assignment very much.
+ * Until any history exists, fall back to the weighted average.
+ */
+static double
+server_rate(struct servers *sp)
+{
+    double sorted[RATE_HISTORY];
+    double t;
+    int i, j;
+
+    if (sp->sr_rate_n <= 0)
+	return sp->sr_w_elapsed;
+
+    for (i = 0; i < sp->sr_rate_n; i++) {
+	t = sp->sr_rate_hist[i];
+	for (j = i; j > 0 && sorted[j-1] > t; j--)
+	    sorted[j] = sorted[j-1];
+	sorted[j] = t;
+    }
+    if (sp->sr_rate_n & 1)
+	return sorted[sp->sr_rate_n/2];
+    return 0.5 * (sorted[sp->sr_rate_n/2 - 1] + sorted[sp->sr_rate_n/2]);
+}
+
+
 static void
 send_loglvl(struct servers *sp)
 {
@@ -1394,13 +1501,17 @@ static int
 all_servers_idle(void)
 {
     struct servers *sp;
+    struct list *lp;
 
     for (sp = &servers[0]; sp < &servers[MAXSERVERS]; sp++) {
 	if (sp->sr_pc == PKC_NULL) continue;
 	if (sp->sr_state != SRST_READY &&
 	    sp->sr_state != SRST_NEED_TREE) continue;
-	if (BU_LIST_IS_EMPTY(&sp->sr_work)) continue;
-	return 0;		/* nope, still more work */
+	for (BU_LIST_FOR(lp, list, &sp->sr_work)) {
+	    /* Results from a losing speculative twin don't count */
+	    if (lp->li_flags & LI_STALE) continue;
+	    return 0;		/* nope, still more work */
+	}
     }
     return 1;			/* All done */
 }
@@ -1666,9 +1777,23 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
      * has worked on before (perhaps due to work requeued when
      * a tardy server was dropped), yet we still must re-send the
      * viewpoint.
+     *
+     * A server with nothing outstanding may move on before its
+     * current frame is finished, either back to an earlier frame
+     * that has requeued work, or on to a later frame when nothing is
+     * left to hand out in the current one.  The latter lets the next
+     * frame's gettrees overlap the tail of the current frame being
+     * finished by the other servers.
      */
     if (sp->sr_curframe != fr) {
-	if (sp->sr_curframe != FRAME_NULL) return 3;
+	if (sp->sr_curframe != FRAME_NULL) {
+	    CHECK_FRAME(sp->sr_curframe);
+	    if (server_q_len(sp) > 0)
+		return 3;
+	    if (fr->fr_number > sp->sr_curframe->fr_number &&
+		BU_LIST_NON_EMPTY(&sp->sr_curframe->fr_todo))
+		return 3;
+	}
 	if (work_allocate_method==OPT_MOVIE) {
 	    struct servers *csp;
 	    for (csp = &servers[0]; csp < &servers[MAXSERVERS]; csp++) {
@@ -1693,7 +1818,7 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
     }
 
     /*
-     * Make this assignment size based on weighted average of
+     * Make this assignment size based on the recent history of
      * past behavior.  Using pixels/elapsed_sec metric takes into
      * account:
      * remote processor speed
@@ -1702,11 +1827,12 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
      * local processing delays
      */
     /* Base new assignment on desired result rate & measured speed */
-    lump = assignment_time() * sp->sr_w_elapsed;
+    lump = assignment_time() * server_rate(sp);
 
     /* If each frame has a dedicated server, make lumps big */
     if (work_allocate_method == OPT_MOVIE) {
-	lump = fr->fr_width * 2;	/* 2 scanlines at a whack */
+	if (lump < fr->fr_width * 2)
+	    lump = fr->fr_width * 2;	/* at least 2 scanlines at a whack */
     } else {
 	/* Limit growth in assignment size to 1.5X each assignment */
 	if (lump > 1.5*sp->sr_lump) lump = 1.5*sp->sr_lump;
@@ -1727,6 +1853,10 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
     if (maxlump < 1) maxlump = 1;
     maxlump *= fr->fr_width;
     if (lump > maxlump) lump=maxlump;
+
+    /* Hand out whole scanlines once a server is fast enough */
+    if (lump > fr->fr_width)
+	lump -= lump % fr->fr_width;
     sp->sr_lump = lump;
 
     lp = BU_LIST_FIRST(list, &fr->fr_todo);
@@ -1744,6 +1874,7 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
     /* Record newly allocated pixel range */
     GET_LIST(lp);
     lp->li_frame = fr;
+    lp->li_fnum = fr->fr_number;
     lp->li_start = a;
     lp->li_stop = b;
     BU_LIST_INSERT(&sp->sr_work, &lp->l);
@@ -1756,6 +1887,104 @@ task_server(struct servers *sp, struct frame *fr, struct timeval *nowp)
 }
 
 
+/*
+ * When there is no unassigned work left anywhere, idle servers would
+ * otherwise sit waiting on the slowest server to finish the tail of
+ * the run.  Instead, duplicate any assignment that has been
+ * outstanding for much longer than its owner's measured speed
+ * suggests onto an idle server.  Whichever copy comes back first is
+ * used; the other is marked LI_STALE and its pixels are discarded.
+ * Work lost when a server is dropped is requeued at the head of its
+ * frame by drop_server(), and is handed out again by task_server().
+ */
+static void
+speculate_tail(struct timeval *nowp)
+{
+    struct servers *sp;
+    struct servers *osp;
+    struct servers *victim;
+    struct list *lp;
+    struct list *olp;
+    struct list *best;
+    struct frame *fr;
+    double rate;
+    double expected;
+    double late;
+    double best_late;
+
+    for (fr = FrameHead.fr_forw; fr != &FrameHead; fr = fr->fr_forw) {
+	CHECK_FRAME(fr);
+	if (BU_LIST_NON_EMPTY(&fr->fr_todo))
+	    return;	/* real work still waiting */
+    }
+
+    for (sp = &servers[0]; sp < &servers[MAXSERVERS]; sp++) {
+	if (sp->sr_pc == PKC_NULL) continue;
+	if (sp->sr_state != SRST_READY) continue;
+	if (server_q_len(sp) > 0) continue;
+
+	/* Find the most overdue assignment without a twin */
+	best = LIST_NULL;
+	victim = SERVERS_NULL;
+	best_late = 0.0;
+	for (osp = &servers[0]; osp < &servers[MAXSERVERS]; osp++) {
+	    if (osp == sp || osp->sr_pc == PKC_NULL) continue;
+	    if (osp->sr_state != SRST_READY &&
+		osp->sr_state != SRST_NEED_TREE) continue;
+	    if (BU_LIST_IS_EMPTY(&osp->sr_work)) continue;
+	    if (osp->sr_sendtime.tv_sec <= 0) continue;
+
+	    /* Only the head of the queue is being worked on now */
+	    olp = BU_LIST_FIRST(list, &osp->sr_work);
+	    if (olp->li_flags & (LI_STALE|LI_SPECULATIVE)) continue;
+	    if (olp->li_frame == FRAME_NULL) continue;
+	    if (find_twin(osp, olp) != LIST_NULL) continue;
+
+	    rate = server_rate(osp);
+	    if (rate > 0.0)
+		expected = (olp->li_stop - olp->li_start + 1) / rate;
+	    else
+		expected = assignment_time();
+	    if (expected < MIN_ASSIGNMENT_TIME)
+		expected = MIN_ASSIGNMENT_TIME;
+
+	    late = tvdiff(nowp, &osp->sr_sendtime) / expected;
+	    if (late < SPECULATE_FACTOR || late <= best_late) continue;
+	    best_late = late;
+	    best = olp;
+	    victim = osp;
+	}
+	if (best == LIST_NULL)
+	    return;	/* nothing is overdue */
+
+	fr = best->li_frame;
+	CHECK_FRAME(fr);
+	if (sp->sr_curframe != fr) {
+	    /* Can't wait for a gettrees round trip here */
+	    if (fr->fr_needgettree) continue;
+	    sp->sr_curframe = fr;
+	    send_matrix(sp, fr);
+	    if (sp->sr_state != SRST_READY) continue;
+	}
+
+	bu_log("%s speculatively re-issuing fr%ld %d..%d from %s to %s\n",
+	       stamp(),
+	       fr->fr_number,
+	       best->li_start, best->li_stop,
+	       victim->sr_host->ht_name,
+	       sp->sr_host->ht_name);
+	GET_LIST(lp);
+	lp->li_frame = fr;
+	lp->li_fnum = fr->fr_number;
+	lp->li_start = best->li_start;
+	lp->li_stop = best->li_stop;
+	lp->li_flags = LI_SPECULATIVE;
+	BU_LIST_INSERT(&sp->sr_work, &lp->l);
+	send_do_lines(sp, lp->li_start, lp->li_stop, fr->fr_number);
+    }
+}
+
+
 /*
  * This routine is called by the main loop, after each batch of PKGs
  * have arrived.
@@ -1890,6 +2119,8 @@ top:
 	goto top;
     }
     /* No work remains to be assigned, or servers are stuffed full */
+    if (speculate)
+	speculate_tail(nowp);
 out:
     scheduler_going = 0;
     return;
@@ -2281,6 +2512,20 @@ cd_allocate(const int argc, const char **argv)
 }
 
 
+static int
+cd_speculate(const int argc, const char **argv)
+{
+    if (argc < 2) {
+	speculate = !speculate;
+    } else {
+	speculate = atoi(argv[1]);
+    }
+    bu_log("%s Speculative re-issue of overdue work is %s\n",
+	   stamp(), speculate ? "ON" : "Off");
+    return 0;
+}
+
+
 static int
 cd_restart(const int argc, const char **argv)
 {
@@ -2501,6 +2746,10 @@ cd_status(const int UNUSED(argc), const char **UNUSED(argv))
 	bu_log("\t r/s:  weighted=%gr/s missed = %d\n",
 	       sp->sr_w_rays,
 	       sp->sr_host->ht_rs_miss);
+	bu_log("\thist:  median=%gp/s over %d samples, speculative wins=%d\n",
+	       server_rate(sp),
+	       sp->sr_rate_n,
+	       sp->sr_nspec);
 
 	if (rem_debug)
 	    pr_list(&(sp->sr_work));
@@ -3162,6 +3411,7 @@ ph_pixels(struct pkg_conn *pc, char *buf)
     struct servers *sp;
     struct frame *fr;
     struct list *lp;
+    struct list *twin;
     struct line_info info;
     struct timeval tvnow;
     int npix;
@@ -3226,6 +3476,27 @@ ph_pixels(struct pkg_conn *pc, char *buf)
      * then the server is dropped.
      */
     lp = BU_LIST_FIRST(list, &sp->sr_work);
+
+    if (lp->li_flags & LI_STALE) {
+	/* A speculative twin already delivered these pixels */
+	if (info.li_frame != lp->li_fnum ||
+	    info.li_startpix != lp->li_start ||
+	    info.li_endpix != lp->li_stop) {
+	    drop_server(sp, "stale assignment mismatch");
+	    goto out;
+	}
+	if (sp->sr_l_elapsed > MIN_ELAPSED_TIME)
+	    record_rate(sp, (lp->li_stop - lp->li_start + 1) / sp->sr_l_elapsed);
+	if (rem_debug) {
+	    bu_log("%s %s discarding stale fr%ld %d..%d\n",
+		   stamp(), sp->sr_host->ht_name,
+		   lp->li_fnum, lp->li_start, lp->li_stop);
+	}
+	BU_LIST_DEQUEUE(&lp->l);
+	FREE_LIST(lp);
+	goto out;
+    }
+
     fr = lp->li_frame;
     CHECK_FRAME(fr);
 
@@ -3337,6 +3608,7 @@ ph_pixels(struct pkg_conn *pc, char *buf)
 	blend2 = 1 - blend1;
 
 	sp->sr_l_el_rate = npix / sp->sr_l_elapsed;
+	record_rate(sp, sp->sr_l_el_rate);
 	sp->sr_w_elapsed = blend1 * sp->sr_w_elapsed +
 	    blend2 * sp->sr_l_el_rate;
 	sp->sr_w_rays = blend1 * sp->sr_w_rays +
@@ -3348,6 +3620,14 @@ ph_pixels(struct pkg_conn *pc, char *buf)
 	sp->sr_nsamp++;
     }
 
+    /* Any speculative twin of this assignment is now redundant */
+    if ((twin = find_twin(sp, lp)) != LIST_NULL) {
+	if (lp->li_flags & LI_SPECULATIVE)
+	    sp->sr_nspec++;
+	twin->li_flags = (twin->li_flags & ~LI_SPECULATIVE) | LI_STALE;
+	twin->li_frame = FRAME_NULL;
+    }
+
     /* Remove from work list */
     list_remove(&(sp->sr_work), info.li_startpix, info.li_endpix);
 
@@ -3730,6 +4010,8 @@ struct command_tab cmd_tab[] = {
      cd_resume,	2, 2},
     {"allocteby", "allocateby", "Work allocation method",
      cd_allocate,	2, 2},
+    {"speculate", "[0|1]",	"set/toggle re-issue of overdue work",
+     cd_speculate,	1, 2},
     {"restart", "[host]",	"restart one or all hosts",
      cd_restart,	1, 2},
     {"go", "",		"start scheduling frames",
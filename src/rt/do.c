@@ -1175,6 +1175,7 @@ do_frame(int framenumber)
 	       rtip->rti_nrays,
 	       wallclock, ((double)(rtip->rti_nrays))/wallclock);
     }
+    adaptive_report(framenumber);
     if (bif != NULL) {
 	icv_write(bif, framename, BU_MIME_IMAGE_AUTO);
 	icv_destroy(bif);
@@ -138,6 +138,9 @@ extern vect_t dx_model;			/* view delta-X as model-space vect (width of pixel as
 extern vect_t dx_unit;			/* unit-len dir vector of pixel side-to-side */
 extern vect_t dy_model;			/* view delta-Y as model-space vect (height of pixel as vector) */
 extern vect_t dy_unit;			/* unit-len dir vector of pixel top-to-bottom */
+extern void (*view_defer)(int cpu, struct application *ap);	/* deferred shading, if any */
+extern int (*view_reuse)(struct application *ap);	/* pixels kept from the last frame, if any */
+extern double adaptive;			/* error accepted from a pixel's first samples, 0 for all */
 /** 'jitter' variable values **/
 #define JITTER_CELL 0x1			/* jitter position of ray in each cell */
 #define JITTER_FRAME 0x2		/* jitter position of entire frame */
@@ -166,6 +169,7 @@ extern int pix_start;			/* pixel to start at */
 extern void def_tree(struct rt_i *rtip);
 extern void do_prep(struct rt_i *rtip);
 extern void do_run(int a, int b);
+extern void adaptive_report(int framenumber);
 extern void do_ae(double azim, double elev);
 extern int old_way(FILE *fp);
 extern int do_frame(int framenumber);
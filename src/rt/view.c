@@ -143,6 +143,74 @@ int a_onehit = -1;
  */
 int a_no_booleans = -1;
 
+/**
+ * Set to 1 to shade the primary hits of each run of pixels together,
+ * grouped by shader, with -c 'set deferred=1'
+ */
+int deferred_shading = 0;
+
+/* a primary hit put aside to be shaded with the rest of its run */
+struct defer_hit {
+    struct application *ap;	/* the sample, which gets the color */
+    struct partition part;	/* copy of the partition to shade */
+    struct hit inhit;
+    struct hit outhit;
+    struct seg inseg;
+    struct seg outseg;
+    size_t seg_start;		/* the ray's finished segments, in segs */
+    size_t seg_count;
+    point_t ao_pt;		/* ambient occlusion ray start and frame */
+    vect_t ao_normal;
+    vect_t ao_u;
+    vect_t ao_v;
+    int ao_hits;		/* occluded ambient occlusion rays */
+};
+
+struct defer_queue {
+    struct application *ap;	/* the sample being shot */
+    struct defer_hit *hits;
+    size_t nhits;
+    size_t maxhits;
+    struct defer_hit **order;	/* hits grouped by shader */
+    size_t maxorder;
+    struct seg *segs;
+    size_t nsegs;
+    size_t maxsegs;
+};
+
+static struct defer_queue defer_queues[MAX_PSW];
+
+/**
+ * Set to N to reuse the pixels of one frame of an animation in the
+ * next ones, for up to N frames, with -c 'set reproject=N'
+ */
+int reproject_frames = 0;
+
+#define REPROJ_NONE	0	/* nothing known */
+#define REPROJ_WARPED	1	/* warped from the last frame */
+#define REPROJ_REUSED	2	/* warped and found still good */
+#define REPROJ_SHOT	3	/* shot this frame */
+
+/* what a pixel saw, kept for the next frame */
+struct reproj_pixel {
+    point_t hit;		/* model space hit point */
+    double dist;		/* from the eye in the current frame */
+    float normal[3];		/* at the hit point, zero if unknown */
+    float color[3];
+    struct region *regp;	/* NULL if there is nothing to reuse */
+    int age;			/* frames since it was shot */
+    int state;
+};
+
+static struct reproj_pixel *reproj_last_frame = NULL;
+static struct reproj_pixel *reproj_this_frame = NULL;
+static size_t reproj_npixels = 0;
+static size_t reproj_reused = 0;	/* pixels reused this frame */
+
+static void reproj_free(void);
+static void reproj_record(struct application *ap);
+static void reproj_report(void);
+
 /* Viewing module specific "set" variables:
  *
  * Note: The actual byte offsets will get set at run time in
@@ -164,6 +232,10 @@ struct bu_structparse view_parse[] = {
     {"%g", 1, "ambRadius", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%g", 1, "ambOffset", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"%d", 1, "ambSlow", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "deferred", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "light_samples", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%g", 1, "adaptive", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
+    {"%d", 1, "reproject", 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL},
     {"", 0, (char *)0, 0, BU_STRUCTPARSE_FUNC_NULL, NULL, NULL}
 };
 
@@ -195,6 +267,9 @@ view_pixel(struct application *ap)
     bu_semaphore_release(BU_SEM_SYSCALL);
 #endif
 
+    if (reproj_this_frame)
+	reproj_record(ap);
+
     if (ap->a_user == 0) {
 	/* Shot missed the model, don't dither */
 	r = ibackground[0];
@@ -566,6 +641,9 @@ view_end(struct application *ap)
 	}
     }
 
+    if (reproj_this_frame)
+	reproj_report();
+
     if (scanline) {
 	free_scanlines(height, scanline);
 	scanline = NULL;
@@ -676,6 +754,7 @@ void
 view_cleanup(struct rt_i *rtip)
 {
     struct region *regp;
+    size_t i;
 
     RT_CHECK_RTI(rtip);
     for (BU_LIST_FOR(regp, region, &(rtip->HeadRegion))) {
@@ -688,6 +767,17 @@ view_cleanup(struct rt_i *rtip)
     }
 
     light_cleanup();
+
+    for (i = 0; i < MAX_PSW; i++) {
+	struct defer_queue *dq = &defer_queues[i];
+	bu_free(dq->hits, "deferred hits");
+	bu_free(dq->order, "deferred order");
+	bu_free(dq->segs, "deferred segs");
+	memset(dq, 0, sizeof(struct defer_queue));
+    }
+
+    /* the regions are gone, and with them the last frame */
+    reproj_free();
 }
 
 
@@ -887,30 +977,19 @@ ao_raymiss(register struct application *ap)
 
 
 /*
- * Compute the ambient term using occlusion rays.
- * Scale the color based upon the occlusion
+ * Start point and coordinate system about the surface normal of the
+ * ambient occlusion rays for the hit on pp.
  */
-void
-ambientOcclusion(struct application *ap, struct partition *pp)
+static void
+ao_frame(const struct application *ap, const struct partition *pp, point_t pt, vect_t inormal, vect_t uAxis, vect_t vAxis)
 {
-    struct application amb_ap = *ap;
     struct soltab *stp;
     struct hit *hitp;
-    vect_t inormal;
-    vect_t vAxis;
-    vect_t uAxis;
-    int ao_samp;
-    vect_t origin = VINIT_ZERO;
-    double occlusionFactor;
-    int hitCount = 0;
 
     stp = pp->pt_inseg->seg_stp;
 
     hitp = pp->pt_inhit;
-    VJOIN1(amb_ap.a_ray.r_pt, ap->a_ray.r_pt, hitp->hit_dist, ap->a_ray.r_dir);
-    amb_ap.a_hit = ao_rayhit;
-    amb_ap.a_miss = ao_raymiss;
-    amb_ap.a_onehit = 4;  /* make sure we get at least two complete partitions.  The first may be "behind" the ray start */
+    VJOIN1(pt, ap->a_ray.r_pt, hitp->hit_dist, ap->a_ray.r_dir);
 
     RT_HIT_NORMAL(inormal, hitp, stp, &(ap->a_ray), pp->pt_inflip);
 
@@ -919,9 +998,9 @@ ambientOcclusion(struct application *ap, struct partition *pp)
      * is departing from.
      */
     if (ZERO(ambOffset)) {
-	VJOIN1(amb_ap.a_ray.r_pt, amb_ap.a_ray.r_pt, ap->a_rt_i->rti_tol.dist, inormal);
+	VJOIN1(pt, pt, ap->a_rt_i->rti_tol.dist, inormal);
     } else {
-	VJOIN1(amb_ap.a_ray.r_pt, amb_ap.a_ray.r_pt, ambOffset, inormal);
+	VJOIN1(pt, pt, ambOffset, inormal);
     }
 
     /* form a coordinate system at the hit point */
@@ -939,32 +1018,56 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 
     VUNITIZE(vAxis);
     VCROSS(uAxis, vAxis, inormal);
+}
 
-    for (ao_samp=0; ao_samp < ambSamples ; ao_samp++) {
-	vect_t randScale;
 
-	/* pick a random direction in the unit sphere */
-	do {
-	    /* less noisy but much slower */
-	    randScale[X] = (bn_randmt() - 0.5) * 2.0;
-	    randScale[Y] = (bn_randmt() - 0.5) * 2.0;
-	    randScale[Z] = bn_randmt();
-	} while (MAGSQ(randScale) > 1.0);
+/*
+ * Shoot one ambient occlusion ray from pt, returns 1 if it is
+ * occluded.
+ */
+static int
+ao_shoot(const struct application *ap, const point_t pt, const vect_t inormal, const vect_t uAxis, const vect_t vAxis)
+{
+    struct application amb_ap = *ap;
+    vect_t origin = VINIT_ZERO;
+    vect_t randScale;
 
-	VJOIN3(amb_ap.a_ray.r_dir, origin,
-	       randScale[X], uAxis,
-	       randScale[Y], vAxis,
-	       randScale[Z], inormal);
+    VMOVE(amb_ap.a_ray.r_pt, pt);
+    amb_ap.a_hit = ao_rayhit;
+    amb_ap.a_miss = ao_raymiss;
+    amb_ap.a_onehit = 4;  /* make sure we get at least two complete partitions.  The first may be "behind" the ray start */
 
-	VUNITIZE(amb_ap.a_ray.r_dir);
+    /* pick a random direction in the unit sphere */
+    do {
+	/* less noisy but much slower */
+	randScale[X] = (bn_randmt() - 0.5) * 2.0;
+	randScale[Y] = (bn_randmt() - 0.5) * 2.0;
+	randScale[Z] = bn_randmt();
+    } while (MAGSQ(randScale) > 1.0);
 
-	amb_ap.a_user = 0;
-	amb_ap.a_flag = 0;
+    VJOIN3(amb_ap.a_ray.r_dir, origin,
+	   randScale[X], uAxis,
+	   randScale[Y], vAxis,
+	   randScale[Z], inormal);
+
+    VUNITIZE(amb_ap.a_ray.r_dir);
+
+    amb_ap.a_user = 0;
+    amb_ap.a_flag = 0;
+
+    /* shoot in the direction and see what we hit */
+    rt_shootray(&amb_ap);
+    return amb_ap.a_flag;
+}
 
-	/* shoot in the direction and see what we hit */
-	rt_shootray(&amb_ap);
-	hitCount += amb_ap.a_flag;
-    }
+
+/*
+ * Scale the color based upon the occlusion
+ */
+static void
+ao_scale(struct application *ap, int hitCount)
+{
+    double occlusionFactor;
 
     occlusionFactor = 1.0 - (hitCount / (float)ambSamples);
 
@@ -975,16 +1078,38 @@ ambientOcclusion(struct application *ap, struct partition *pp)
 }
 
 
+/*
+ * Compute the ambient term using occlusion rays.
+ * Scale the color based upon the occlusion
+ */
+void
+ambientOcclusion(struct application *ap, struct partition *pp)
+{
+    point_t pt;
+    vect_t inormal;
+    vect_t vAxis;
+    vect_t uAxis;
+    int ao_samp;
+    int hitCount = 0;
+
+    ao_frame(ap, pp, pt, inormal, uAxis, vAxis);
+
+    for (ao_samp=0; ao_samp < ambSamples ; ao_samp++)
+	hitCount += ao_shoot(ap, pt, inormal, uAxis, vAxis);
+
+    ao_scale(ap, hitCount);
+}
+
+
 /**
- * Manage the coloring of whatever it was we just hit.  This can be a
- * recursive procedure.
+ * Find the partition colorview() shades, skipping slivers of the glass
+ * an internal ray is escaping and anything cut away.  Returns NULL when
+ * there is nothing to shade, after calling a_miss() if it was cut.
  */
-int
-colorview(struct application *ap, struct partition *PartHeadp, struct seg *finished_segs)
+static struct partition *
+colorview_front(struct application *ap, struct partition *PartHeadp)
 {
     struct partition *pp;
-    struct hit *hitp;
-    struct shadework sw;
 
     pp = PartHeadp->pt_forw;
     if (ap->a_flag == 1) {
@@ -1007,7 +1132,7 @@ colorview(struct application *ap, struct partition *PartHeadp, struct seg *finis
 
     if (pp == PartHeadp) {
 	bu_log("colorview:  no hit out front?\n");
-	return 0;
+	return NULL;
     }
 
     if (do_kut_plane) {
@@ -1016,15 +1141,13 @@ colorview(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	if (!pp || pp == PartHeadp) {
 	    /* we ignored everything, this is now a miss */
 	    ap->a_miss(ap);
-	    return 0;
+	    return NULL;
 	}
     }
 
-
     RT_CK_PT(pp);
-    hitp = pp->pt_inhit;
-    RT_CK_HIT(hitp);
-    RT_CK_RAY(hitp->hit_rayp);
+    RT_CK_HIT(pp->pt_inhit);
+    RT_CK_RAY(pp->pt_inhit->hit_rayp);
     ap->a_uptr = (void *)pp->pt_regionp;	/* note which region was shaded */
 
     if (OPTICAL_DEBUG&OPTICAL_DEBUG_HITS) {
@@ -1033,12 +1156,26 @@ colorview(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	       pp->pt_regionp->reg_name);
 	rt_pr_partition(ap->a_rt_i, pp);
     }
+
+    return pp;
+}
+
+
+/**
+ * Color hits that are not shaded: entries beyond infinity and an eye
+ * inside a solid.  Returns 1 if the hit on pp was colored.
+ */
+static int
+colorview_direct(struct application *ap, struct partition *pp)
+{
+    struct hit *hitp = pp->pt_inhit;
+
     if (hitp->hit_dist >= INFINITY) {
 	bu_log("colorview:  entry beyond infinity\n");
 	VSET(ap->a_color, .5, 0, 0);
 	ap->a_user = 1;		/* Signal view_pixel:  HIT */
 	ap->a_dist = hitp->hit_dist;
-	goto out;
+	return 1;
     }
 
     /* Check to see if eye is "inside" the solid It might only be
@@ -1066,7 +1203,7 @@ colorview(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	    }
 	    ap->a_user = 1;		/* Signal view_pixel:  HIT */
 	    ap->a_dist = hitp->hit_dist;
-	    goto out;
+	    return 1;
 	}
 	/* Push on to exit point, and trace on from there */
 	sub_ap = *ap;	/* struct copy */
@@ -1085,9 +1222,22 @@ colorview(struct application *ap, struct partition *PartHeadp, struct seg *finis
 	ap->a_user = 1;		/* Signal view_pixel: HIT */
 	ap->a_dist = f + sub_ap.a_dist;
 	ap->a_uptr = sub_ap.a_uptr;	/* which region */
-	goto out;
+	return 1;
     }
 
+    return 0;
+}
+
+
+/**
+ * Run the shader of the hit on pp.
+ */
+static void
+colorview_shade(struct application *ap, struct partition *pp, struct seg *finished_segs)
+{
+    struct hit *hitp = pp->pt_inhit;
+    struct shadework sw;
+
     /* Record the approach path */
     if (OPTICAL_DEBUG&OPTICAL_DEBUG_RAYWRITE && (hitp->hit_dist > 0.0001)) {
 	VJOIN1(hitp->hit_point, ap->a_ray.r_pt,
@@ -1165,7 +1315,21 @@ vdraw open iray;vdraw params c %2.2x%2.2x%2.2x;vdraw write n 0 %g %g %g;vdraw wr
     /* XXX This is always negative when eye is inside air solid */
     ap->a_dist = hitp->hit_dist;
 
-out:
+    /* the normal, for adaptive sampling to find edges by */
+    if (sw.sw_inputs & MFI_NORMAL)
+	VMOVE(ap->a_vvec, sw.sw_hit.hit_normal);
+}
+
+
+/**
+ * Apply the haze and, with ao, the ambient occlusion to the color of
+ * the hit on pp.
+ */
+static void
+colorview_out(struct application *ap, struct partition *pp, int ao)
+{
+    struct hit *hitp = pp->pt_inhit;
+
     /*
      * e ^(-density * distance)
      */
@@ -1178,8 +1342,7 @@ out:
 	VJOIN1(ap->a_color, ap->a_color, g, haze);
     }
 
-
-    if (ambSamples > 0)
+    if (ao && ambSamples > 0)
 	ambientOcclusion(ap, pp);
 
     RT_CK_REGION(ap->a_uptr);
@@ -1190,10 +1353,181 @@ out:
 	       pp->pt_regionp->reg_name);
 	VPRINT("color   ", ap->a_color);
     }
+}
+
+
+/**
+ * Manage the coloring of whatever it was we just hit.  This can be a
+ * recursive procedure.
+ */
+int
+colorview(struct application *ap, struct partition *PartHeadp, struct seg *finished_segs)
+{
+    struct partition *pp;
+
+    pp = colorview_front(ap, PartHeadp);
+    if (!pp)
+	return 0;
+
+    if (!colorview_direct(ap, pp))
+	colorview_shade(ap, pp, finished_segs);
+
+    colorview_out(ap, pp, 1);
+    return 1;
+}
+
+
+/* by shader, then in the order shot */
+static int
+defer_cmp(const void *a, const void *b)
+{
+    const struct defer_hit *ha = *(const struct defer_hit * const *)a;
+    const struct defer_hit *hb = *(const struct defer_hit * const *)b;
+    uintptr_t ma = (uintptr_t)ha->part.pt_regionp->reg_mfuncs;
+    uintptr_t mb = (uintptr_t)hb->part.pt_regionp->reg_mfuncs;
+
+    if (ma != mb)
+	return (ma < mb) ? -1 : 1;
+    if (ha != hb)
+	return (ha < hb) ? -1 : 1;
+    return 0;
+}
+
+
+/**
+ * a_hit() routine for deferred shading.  The primary ray of the sample
+ * being shot only gets the partition to shade picked out and copied
+ * aside, everything else is colored right away by colorview().
+ */
+static int
+colorview_defer(struct application *ap, struct partition *PartHeadp, struct seg *finished_segs)
+{
+    struct defer_queue *dq = &defer_queues[ap->a_resource->re_cpu];
+    struct defer_hit *dh;
+    struct partition *pp;
+    struct seg *segp;
+
+    if (ap != dq->ap)
+	return colorview(ap, PartHeadp, finished_segs);
+
+    pp = colorview_front(ap, PartHeadp);
+    if (!pp)
+	return 0;
+
+    if (colorview_direct(ap, pp)) {
+	colorview_out(ap, pp, 1);
+	return 1;
+    }
+
+    if (dq->nhits == dq->maxhits) {
+	dq->maxhits = (dq->maxhits) ? dq->maxhits * 2 : 256;
+	dq->hits = (struct defer_hit *)bu_realloc(dq->hits, dq->maxhits * sizeof(struct defer_hit), "deferred hits");
+    }
+    dh = &dq->hits[dq->nhits++];
+
+    /* the queue may move before it is shaded, so the pointers between
+     * the copies are only set up then */
+    memset(&dh->part, 0, sizeof(struct partition));
+    dh->ap = ap;
+    dh->part.pt_magic = PT_MAGIC;
+    dh->part.pt_regionp = pp->pt_regionp;
+    dh->part.pt_inflip = pp->pt_inflip;
+    dh->part.pt_outflip = pp->pt_outflip;
+    dh->inhit = *pp->pt_inhit;
+    dh->outhit = *pp->pt_outhit;
+    dh->inseg = *pp->pt_inseg;
+    dh->outseg = *pp->pt_outseg;
+
+    dh->seg_start = dq->nsegs;
+    dh->seg_count = 0;
+    if (finished_segs) {
+	for (BU_LIST_FOR(segp, seg, &(finished_segs->l))) {
+	    if (dq->nsegs == dq->maxsegs) {
+		dq->maxsegs = (dq->maxsegs) ? dq->maxsegs * 2 : 1024;
+		dq->segs = (struct seg *)bu_realloc(dq->segs, dq->maxsegs * sizeof(struct seg), "deferred segs");
+	    }
+	    dq->segs[dq->nsegs++] = *segp;
+	    dh->seg_count++;
+	}
+    }
+
+    ap->a_user = 1;		/* Signal view_pixel:  HIT */
+    ap->a_dist = pp->pt_inhit->hit_dist;
     return 1;
 }
 
 
+/**
+ * view_defer() for rt.  Shades the hits deferred since the last call
+ * one shader at a time, so each shader and its data stay in cache for
+ * a run of hits, then shoots their ambient occlusion rays a round at a
+ * time across all of them.
+ */
+static void
+defer_shade(int cpu, struct application *ap)
+{
+    struct defer_queue *dq = &defer_queues[cpu];
+    size_t i;
+
+    dq->ap = ap;
+    if (ap || !dq->nhits)
+	return;
+
+    if (dq->maxorder < dq->nhits) {
+	dq->maxorder = dq->maxhits;
+	dq->order = (struct defer_hit **)bu_realloc(dq->order, dq->maxorder * sizeof(struct defer_hit *), "deferred order");
+    }
+    for (i = 0; i < dq->nhits; i++)
+	dq->order[i] = &dq->hits[i];
+    qsort(dq->order, dq->nhits, sizeof(struct defer_hit *), defer_cmp);
+
+    for (i = 0; i < dq->nhits; i++) {
+	struct defer_hit *dh = dq->order[i];
+	struct partition head;
+	struct seg seghead;
+	size_t k;
+
+	/* a list of the one partition, hits pointing back at the ray */
+	head.pt_magic = PT_HD_MAGIC;
+	head.pt_forw = head.pt_back = &dh->part;
+	dh->part.pt_forw = dh->part.pt_back = &head;
+	dh->part.pt_inseg = &dh->inseg;
+	dh->part.pt_outseg = &dh->outseg;
+	dh->part.pt_inhit = &dh->inhit;
+	dh->part.pt_outhit = &dh->outhit;
+	dh->inhit.hit_rayp = dh->outhit.hit_rayp = &dh->ap->a_ray;
+
+	BU_LIST_INIT(&seghead.l);
+	for (k = 0; k < dh->seg_count; k++)
+	    BU_LIST_INSERT(&seghead.l, &dq->segs[dh->seg_start + k].l);
+
+	colorview_shade(dh->ap, &dh->part, &seghead);
+	colorview_out(dh->ap, &dh->part, 0);
+
+	if (ambSamples > 0) {
+	    ao_frame(dh->ap, &dh->part, dh->ao_pt, dh->ao_normal, dh->ao_u, dh->ao_v);
+	    dh->ao_hits = 0;
+	}
+    }
+
+    if (ambSamples > 0) {
+	int ao_samp;
+
+	for (ao_samp = 0; ao_samp < ambSamples; ao_samp++) {
+	    for (i = 0; i < dq->nhits; i++) {
+		struct defer_hit *dh = &dq->hits[i];
+		dh->ao_hits += ao_shoot(dh->ap, dh->ao_pt, dh->ao_normal, dh->ao_u, dh->ao_v);
+	    }
+	}
+	for (i = 0; i < dq->nhits; i++)
+	    ao_scale(dq->hits[i].ap, dq->hits[i].ao_hits);
+    }
+
+    dq->nhits = 0;
+    dq->nsegs = 0;
+}
+
+
 /**
  * a_hit() routine for simple lighting model.
  */
@@ -1486,6 +1820,249 @@ out:
 }
 
 
+/* neighbors further apart than this fraction of their distance, or
+ * with normals further apart than about 25 degrees, are an edge, and
+ * surfaces turned further than about 85 degrees from the eye are
+ * shaded again */
+#define REPROJ_DIST_TOL 0.05
+#define REPROJ_NORMAL_COS 0.9
+#define REPROJ_FACING 0.1
+
+static void
+reproj_free(void)
+{
+    if (reproj_last_frame)
+	bu_free(reproj_last_frame, "reprojection frame");
+    if (reproj_this_frame)
+	bu_free(reproj_this_frame, "reprojection frame");
+    reproj_last_frame = reproj_this_frame = NULL;
+    reproj_npixels = 0;
+    reproj_reused = 0;
+}
+
+
+/**
+ * Find where the model space point hit falls on the current screen,
+ * in pixels, and how far it is from the eye as an a_dist.  Returns 0
+ * if it is behind the eye.
+ */
+static int
+reproj_locate(const fastf_t *hit, double *x, double *y, double *dist)
+{
+    vect_t rel;
+
+    if (rt_perspective > 0.0) {
+	vect_t d, n;
+	point_t q;
+	double den;
+
+	/* through the eye onto the view plane */
+	VCROSS(n, dx_model, dy_model);
+	VSUB2(rel, viewbase_model, eye_model);
+	if (VDOT(rel, n) < 0.0)
+	    VREVERSE(n, n);
+	VSUB2(d, hit, eye_model);
+	den = VDOT(d, n);
+	if (den <= SMALL_FASTF)
+	    return 0;
+	VJOIN1(q, eye_model, VDOT(rel, n) / den, d);
+	VSUB2(rel, q, viewbase_model);
+	*dist = MAGNITUDE(d);
+    } else {
+	VSUB2(rel, hit, viewbase_model);
+	*dist = VDOT(rel, APP.a_ray.r_dir);
+	if (*dist <= 0.0)
+	    return 0;
+    }
+
+    *x = VDOT(rel, dx_model) / MAGSQ(dx_model);
+    *y = VDOT(rel, dy_model) / MAGSQ(dy_model);
+    return 1;
+}
+
+
+/**
+ * A pixel warped from the last frame may be reused if it still faces
+ * the eye and each of its neighbors was warped too, from the same
+ * region, about as far away and facing about the same way.  A
+ * neighbor nothing was warped to is a disocclusion, or something that
+ * was not on screen before.
+ */
+static int
+reproj_valid(size_t x, size_t y)
+{
+    static const int nx[4] = {-1, 1, 0, 0};
+    static const int ny[4] = {0, 0, -1, 1};
+    struct reproj_pixel *rp = &reproj_this_frame[y*width + x];
+    int has_normal;
+    int k;
+
+    if (rp->state != REPROJ_WARPED)
+	return 0;
+
+    has_normal = !ZERO(MAGSQ(rp->normal));
+    if (has_normal) {
+	vect_t toeye;
+
+	if (rt_perspective > 0.0) {
+	    VSUB2(toeye, eye_model, rp->hit);
+	    VUNITIZE(toeye);
+	} else {
+	    VREVERSE(toeye, APP.a_ray.r_dir);
+	}
+	if (VDOT(rp->normal, toeye) < REPROJ_FACING)
+	    return 0;
+    }
+
+    for (k = 0; k < 4; k++) {
+	struct reproj_pixel *np;
+
+	if ((x == 0 && nx[k] < 0) || (x == width-1 && nx[k] > 0)
+	    || (y == 0 && ny[k] < 0) || (y == height-1 && ny[k] > 0))
+	    continue;
+
+	np = &reproj_this_frame[(y + ny[k])*width + x + nx[k]];
+	if (np->state < REPROJ_WARPED || np->regp != rp->regp)
+	    return 0;
+	if (fabs(np->dist - rp->dist) > REPROJ_DIST_TOL * rp->dist)
+	    return 0;
+	if (has_normal && !ZERO(MAGSQ(np->normal))
+	    && VDOT(rp->normal, np->normal) < REPROJ_NORMAL_COS)
+	    return 0;
+    }
+    return 1;
+}
+
+
+/**
+ * Start a frame with reprojection: warp the hits of the last frame
+ * into the current view, keeping the nearest where several land on a
+ * pixel, and mark the ones reproj_valid() passes to be reused.
+ */
+static void
+reproj_begin(void)
+{
+    size_t npixels = width * height;
+    struct reproj_pixel *tmp;
+    size_t i, x, y;
+
+    if (npixels != reproj_npixels) {
+	reproj_free();
+	reproj_last_frame = (struct reproj_pixel *)bu_calloc(npixels, sizeof(struct reproj_pixel), "reprojection frame");
+	reproj_this_frame = (struct reproj_pixel *)bu_calloc(npixels, sizeof(struct reproj_pixel), "reprojection frame");
+	reproj_npixels = npixels;
+    }
+
+    tmp = reproj_last_frame;
+    reproj_last_frame = reproj_this_frame;
+    reproj_this_frame = tmp;
+    memset(reproj_this_frame, 0, npixels * sizeof(struct reproj_pixel));
+
+    for (i = 0; i < npixels; i++) {
+	struct reproj_pixel *ip = &reproj_last_frame[i];
+	struct reproj_pixel *op;
+	double fx, fy, dist;
+
+	if (ip->state < REPROJ_REUSED || !ip->regp)
+	    continue;
+	if (ip->age >= reproject_frames)
+	    continue;	/* too old, shade it again */
+	if (!reproj_locate(ip->hit, &fx, &fy, &dist))
+	    continue;
+
+	fx = floor(fx + 0.5);
+	fy = floor(fy + 0.5);
+	if (fx < 0.0 || fy < 0.0 || fx >= (double)width || fy >= (double)height)
+	    continue;
+
+	op = &reproj_this_frame[(size_t)fy*width + (size_t)fx];
+	if (op->state == REPROJ_WARPED && op->dist <= dist)
+	    continue;	/* something nearer is already here */
+	*op = *ip;		/* struct copy */
+	op->dist = dist;
+	op->age = ip->age + 1;
+	op->state = REPROJ_WARPED;
+    }
+
+    reproj_reused = 0;
+    for (y = 0; y < height; y++) {
+	for (x = 0; x < width; x++) {
+	    if (reproj_valid(x, y)) {
+		reproj_this_frame[y*width + x].state = REPROJ_REUSED;
+		reproj_reused++;
+	    }
+	}
+    }
+}
+
+
+/**
+ * view_reuse() for rt.  Fills in the pixel of ap from the last frame
+ * if reproj_begin() found it still good.
+ */
+static int
+reproj_reuse(struct application *ap)
+{
+    struct reproj_pixel *rp = &reproj_this_frame[ap->a_y*width + ap->a_x];
+
+    if (rp->state != REPROJ_REUSED)
+	return 0;
+
+    VMOVE(ap->a_color, rp->color);
+    VMOVE(ap->a_vvec, rp->normal);
+    ap->a_uptr = (void *)rp->regp;
+    ap->a_dist = rp->dist;
+    ap->a_user = 1;		/* Signal view_pixel:  HIT */
+    return 1;
+}
+
+
+/**
+ * Keep what the pixel just shot in ap saw, for the next frame.  Only
+ * hits on regions in front of the eye can be reused.
+ */
+static void
+reproj_record(struct application *ap)
+{
+    struct reproj_pixel *rp;
+
+    if (ap->a_x < 0 || ap->a_y < 0 || (size_t)ap->a_x >= width || (size_t)ap->a_y >= height)
+	return;
+
+    rp = &reproj_this_frame[ap->a_y*width + ap->a_x];
+    if (rp->state == REPROJ_REUSED)
+	return;
+
+    rp->state = REPROJ_SHOT;
+    rp->age = 0;
+    rp->regp = NULL;
+    if (ap->a_user == 0 || !ap->a_uptr || ap->a_uptr == (void *)&env_region
+	|| ap->a_dist < 0.0 || ap->a_dist >= INFINITY)
+	return;
+
+    rp->regp = (struct region *)ap->a_uptr;
+    VJOIN1(rp->hit, ap->a_ray.r_pt, ap->a_dist, ap->a_ray.r_dir);
+    rp->dist = ap->a_dist;
+    VMOVE(rp->normal, ap->a_vvec);
+    VMOVE(rp->color, ap->a_color);
+}
+
+
+static void
+reproj_report(void)
+{
+    size_t i, shot = 0;
+
+    for (i = 0; i < reproj_npixels; i++) {
+	if (reproj_this_frame[i].state == REPROJ_SHOT)
+	    shot++;
+    }
+    bu_log("Frame %2d: %10zu pixels reused from the last frame, %zu shot (%.1f%% reused)\n",
+	   curframe, reproj_reused, shot,
+	   (reproj_reused + shot) ? 100.0 * reproj_reused / (reproj_reused + shot) : 0.0);
+}
+
+
 void
 collect_soltabs(struct bu_ptbl *stp_list, union tree *tr)
 {
@@ -1749,6 +2326,22 @@ view_2init(struct application *ap, char *UNUSED(framename))
     }
     ap->a_rt_i->rti_nlights = light_init(ap);
 
+    view_defer = NULL;
+    if (deferred_shading && ap->a_hit == colorview) {
+	ap->a_hit = colorview_defer;
+	view_defer = defer_shade;
+    }
+
+    /* carry what still holds over from the last frame */
+    view_reuse = NULL;
+    if (reproject_frames > 0 && (ap->a_hit == colorview || ap->a_hit == colorview_defer)
+	&& !fullfloat_mode && !incr_mode && !full_incr_mode) {
+	reproj_begin();
+	view_reuse = reproj_reuse;
+    } else {
+	reproj_free();
+    }
+
 
     /* Now OK to delete invisible light regions.  Actually we just
      * remove the references to these regions from the soltab
@@ -1843,6 +2436,10 @@ application_init(void)
     view_parse[ 9].sp_offset = bu_byteoffset(ambRadius);
     view_parse[10].sp_offset = bu_byteoffset(ambOffset);
     view_parse[11].sp_offset = bu_byteoffset(ambSlow);
+    view_parse[12].sp_offset = bu_byteoffset(deferred_shading);
+    view_parse[13].sp_offset = bu_byteoffset(light_samples);
+    view_parse[14].sp_offset = bu_byteoffset(adaptive);
+    view_parse[15].sp_offset = bu_byteoffset(reproject_frames);
 
     option("", "-A #", "Set image brightness, ambient light intensity (default: 0.4)", 0);
     option("Raytrace", "-i", "Enable incremental (progressive-style) rendering", 1);
@@ -79,6 +79,59 @@ int last_pixel = 0;			/* last pixel number */
 
 int stop_worker = 0;
 
+/* samples shot before the deferred ones are shaded */
+#define DEFER_SAMPLES 256
+
+/**
+ * Set by view modules that can put off shading primary hits and shade
+ * them in batches.  Called with each sample's application before it is
+ * shot, then with NULL to shade every hit deferred since.
+ */
+void (*view_defer)(int cpu, struct application *ap) = NULL;
+
+/**
+ * Set by view modules that can reuse pixels of the last frame.
+ * Returns 1 after filling in the color and hit of ap's pixel, which
+ * is then output without shooting it.
+ */
+int (*view_reuse)(struct application *ap) = NULL;
+
+/**
+ * With hypersampling, the largest standard error of a pixel's mean
+ * color accepted from its first few samples before the rest are shot.
+ * Zero shoots every sample of every pixel.
+ */
+double adaptive = 0.0;
+
+/* samples whose normals are further apart than about 25 degrees
+ * straddle an edge */
+#define ADAPT_NORMAL_COS 0.9
+
+/* why a pixel was given every sample */
+#define ADAPT_NOISE 1
+#define ADAPT_REGION 2
+#define ADAPT_NORMAL 3
+
+/* running tally of the samples of one pixel */
+struct adapt_pixel {
+    int n;			/* samples so far */
+    vect_t sum;			/* of their colors */
+    vect_t sumsq;		/* of their squared colors */
+    void *region;		/* what the first one hit */
+    vect_t normal;		/* and its normal, if known */
+    int edge;			/* ADAPT_REGION or ADAPT_NORMAL once seen */
+    int why;			/* why it was given every sample, if it was */
+};
+
+/* per cpu totals for the frame, see adaptive_report() */
+static struct adapt_stats {
+    size_t pixels;		/* pixels shot */
+    size_t samples;		/* samples shot */
+    size_t refined[4];		/* pixels given every sample, by reason */
+    double err;			/* sum of the errors of the others */
+    double err_max;
+} adapt_stats[MAX_PSW];
+
 /**
  * For certain hypersample values there is a particular advantage to
  * subdividing the pixel and shooting a ray in each sub-pixel.  This
@@ -148,53 +201,43 @@ jitter_start_pnt(vect_t point, struct application *a, int samplenum, int pat_num
 }
 
 
-void
-do_pixel(int cpu, int pat_num, int pixelnum)
+/**
+ * Fill in a fresh copy of the global application struct for pixel
+ * pixelnum.  Returns 0 when the pixel is not to be shot: outside the
+ * sub grid, already reprojected, or taken from the pixel map or the
+ * last frame (which outputs it).
+ */
+static int
+pixel_setup(struct application *a, int cpu, int pixelnum)
 {
-    struct application a;
-    struct pixel_ext pe;
-    vect_t stereo_point;		/* Ref point on eye or view plane */
-    vect_t point;		/* Ref point on eye or view plane */
-    vect_t colorsum = {(fastf_t)0.0, (fastf_t)0.0, (fastf_t)0.0};
-    int samplenum = 0;
     static const double one_over_255 = 1.0 / 255.0;
     const int pindex = (pixelnum * sizeof(RGBpixel));
 
-    /* for stereo output */
-    vect_t left_eye_delta = VINIT_ZERO;
-
-    if (lightmodel == 8) {
-	/* Add timer here to start pixel-time for heat
-	 * graph, when asked.
-	 */
-	rt_prep_timer();
-    }
-
     /* Obtain fresh copy of global application struct */
-    a = APP;				/* struct copy */
-    a.a_resource = &resource[cpu];
+    *a = APP;				/* struct copy */
+    a->a_resource = &resource[cpu];
 
     if (incr_mode) {
 	register int i = 1<<incr_level;
-	a.a_y = pixelnum/i;
-	a.a_x = pixelnum - (a.a_y * i);
-	/* a.a_x = pixelnum%i; */
+	a->a_y = pixelnum/i;
+	a->a_x = pixelnum - (a->a_y * i);
+	/* a->a_x = pixelnum%i; */
 	if (incr_level != 0) {
 	    /* See if already done last pass */
-	    if (((a.a_x & 1) == 0) &&
-		((a.a_y & 1) == 0))
-		return;
+	    if (((a->a_x & 1) == 0) &&
+		((a->a_y & 1) == 0))
+		return 0;
 	}
-	a.a_x <<= (incr_nlevel-incr_level);
-	a.a_y <<= (incr_nlevel-incr_level);
+	a->a_x <<= (incr_nlevel-incr_level);
+	a->a_y <<= (incr_nlevel-incr_level);
     } else {
-	a.a_y = (int)(pixelnum/width);
-	a.a_x = (int)(pixelnum - (a.a_y * width));
-	/* a.a_x = pixelnum%width; */
+	a->a_y = (int)(pixelnum/width);
+	a->a_x = (int)(pixelnum - (a->a_y * width));
+	/* a->a_x = pixelnum%width; */
     }
 
     if (Query_one_pixel) {
-	if (a.a_x == query_x && a.a_y == query_y) {
+	if (a->a_x == query_x && a->a_y == query_y) {
 	    optical_debug = query_optical_debug;
 	    rt_debug = query_debug;
 	} else {
@@ -203,16 +246,16 @@ do_pixel(int cpu, int pat_num, int pixelnum)
     }
 
     if (sub_grid_mode) {
-	if (a.a_x < sub_xmin || a.a_x > sub_xmax)
-	    return;
-	if (a.a_y < sub_ymin || a.a_y > sub_ymax)
-	    return;
+	if (a->a_x < sub_xmin || a->a_x > sub_xmax)
+	    return 0;
+	if (a->a_y < sub_ymin || a->a_y > sub_ymax)
+	    return 0;
     }
     if (fullfloat_mode) {
 	register struct floatpixel *fp;
-	fp = &curr_float_frame[a.a_y*width + a.a_x];
+	fp = &curr_float_frame[a->a_y*width + a->a_x];
 	if (fp->ff_frame >= 0) {
-	    return;	/* pixel was reprojected */
+	    return 0;	/* pixel was reprojected */
 	}
     }
 
@@ -220,203 +263,321 @@ do_pixel(int cpu, int pat_num, int pixelnum)
      * rendered or not.
      */
     if (pixmap) {
-	a.a_user= 1;	/* Force Shot Hit */
+	a->a_user= 1;	/* Force Shot Hit */
 
 	if (pixmap[pindex + RED] + pixmap[pindex + GRN] + pixmap[pindex + BLU]) {
 	    /* non-black pixmap pixel */
 
-	    a.a_color[RED]= (double)(pixmap[pindex + RED]) * one_over_255;
-	    a.a_color[GRN]= (double)(pixmap[pindex + GRN]) * one_over_255;
-	    a.a_color[BLU]= (double)(pixmap[pindex + BLU]) * one_over_255;
+	    a->a_color[RED]= (double)(pixmap[pindex + RED]) * one_over_255;
+	    a->a_color[GRN]= (double)(pixmap[pindex + GRN]) * one_over_255;
+	    a->a_color[BLU]= (double)(pixmap[pindex + BLU]) * one_over_255;
 
 	    /* we're done */
-	    view_pixel(&a);
-	    if ((size_t)a.a_x == width-1) {
-		view_eol(&a);		/* End of scan line */
+	    view_pixel(a);
+	    if ((size_t)a->a_x == width-1) {
+		view_eol(a);		/* End of scan line */
 	    }
-	    return;
+	    return 0;
 	}
     }
 
-    /* our starting point, used for non-jitter */
-    VJOIN2 (point, viewbase_model, a.a_x, dx_model, a.a_y, dy_model);
+    /* or if the view module still has it from the last frame */
+    if (view_reuse && (*view_reuse)(a)) {
+	view_pixel(a);
+	if ((size_t)a->a_x == width-1) {
+	    view_eol(a);		/* End of scan line */
+	}
+	return 0;
+    }
 
     /* not tracing the corners of a prism by default */
-    a.a_pixelext=(struct pixel_ext *)NULL;
+    a->a_pixelext=(struct pixel_ext *)NULL;
 
-    /* black or no pixmap, so compute the pixel(s) */
+    return 1;
+}
 
-    /* LOOP BELOW IS UNROLLED ONE SAMPLE SINCE THAT'S THE COMMON CASE.
-     *
-     * XXX - If you edit the unrolled or non-unrolled section, be sure
-     * to edit the other section.
-     */
-    if (hypersample == 0) {
-	/* not hypersampling, so just do it */
 
-	/****************/
-	/* BEGIN UNROLL */
-	/****************/
+/**
+ * Aim and shoot sample samplenum of a's pixel, leaving its color in
+ * a->a_color.  point is the pixel's starting point, and is moved to
+ * the sample's when jittering.
+ */
+static void
+shoot_sample(struct application *a, struct pixel_ext *pe, vect_t point, int cpu, int pat_num, int samplenum)
+{
+    vect_t stereo_point;		/* Ref point on eye or view plane */
 
-	if (jitter & JITTER_CELL) {
-	    jitter_start_pnt(point, &a, samplenum, pat_num);
-	}
+    /* for stereo output */
+    vect_t left_eye_delta = VINIT_ZERO;
+
+    if (jitter & JITTER_CELL) {
+	jitter_start_pnt(point, a, samplenum, pat_num);
+    }
+
+    if (a->a_rt_i->rti_prismtrace) {
+	/* compute the four corners */
+	pe->magic = PIXEL_EXT_MAGIC;
+	VJOIN2(pe->corner[0].r_pt, viewbase_model, a->a_x, dx_model, a->a_y, dy_model);
+	VJOIN2(pe->corner[1].r_pt, viewbase_model, (a->a_x+1), dx_model, a->a_y, dy_model);
+	VJOIN2(pe->corner[2].r_pt, viewbase_model, (a->a_x+1), dx_model, (a->a_y+1), dy_model);
+	VJOIN2(pe->corner[3].r_pt, viewbase_model, a->a_x, dx_model, (a->a_y+1), dy_model);
+	a->a_pixelext = pe;
+    }
 
-	if (a.a_rt_i->rti_prismtrace) {
-	    /* compute the four corners */
-	    pe.magic = PIXEL_EXT_MAGIC;
-	    VJOIN2(pe.corner[0].r_pt, viewbase_model, a.a_x, dx_model, a.a_y, dy_model);
-	    VJOIN2(pe.corner[1].r_pt, viewbase_model, (a.a_x+1), dx_model, a.a_y, dy_model);
-	    VJOIN2(pe.corner[2].r_pt, viewbase_model, (a.a_x+1), dx_model, (a.a_y+1), dy_model);
-	    VJOIN2(pe.corner[3].r_pt, viewbase_model, a.a_x, dx_model, (a.a_y+1), dy_model);
-	    a.a_pixelext = &pe;
+    if (rt_perspective > 0.0) {
+	VSUB2(a->a_ray.r_dir, point, eye_model);
+	VUNITIZE(a->a_ray.r_dir);
+	VMOVE(a->a_ray.r_pt, eye_model);
+	if (a->a_rt_i->rti_prismtrace) {
+	    VSUB2(pe->corner[0].r_dir, pe->corner[0].r_pt, eye_model);
+	    VSUB2(pe->corner[1].r_dir, pe->corner[1].r_pt, eye_model);
+	    VSUB2(pe->corner[2].r_dir, pe->corner[2].r_pt, eye_model);
+	    VSUB2(pe->corner[3].r_dir, pe->corner[3].r_pt, eye_model);
 	}
+    } else {
+	VMOVE(a->a_ray.r_pt, point);
+	VMOVE(a->a_ray.r_dir, APP.a_ray.r_dir);
+
+	if (a->a_rt_i->rti_prismtrace) {
+	    VMOVE(pe->corner[0].r_dir, a->a_ray.r_dir);
+	    VMOVE(pe->corner[1].r_dir, a->a_ray.r_dir);
+	    VMOVE(pe->corner[2].r_dir, a->a_ray.r_dir);
+	    VMOVE(pe->corner[3].r_dir, a->a_ray.r_dir);
+	}
+    }
+    if (report_progress) {
+	report_progress = 0;
+	bu_log("\tframe %d, xy=%d, %d on cpu %d, samp=%d\n", curframe, a->a_x, a->a_y, cpu, samplenum);
+    }
+
+    a->a_level = 0;		/* recursion level */
+    a->a_purpose = "main ray";
+    (void)rt_shootray(a);
+
+    if (stereo) {
+	fastf_t right, left;
+	vect_t temp;
 
+	right = CRT_BLEND(a->a_color);
+
+	/* Move left 2.5 inches (63.5mm) */
+	VSET(temp, -63.5*2.0/viewsize, 0, 0);
+	MAT4X3VEC(left_eye_delta, view2model, temp);
+
+	VSUB2(stereo_point, point, left_eye_delta);
 	if (rt_perspective > 0.0) {
-	    VSUB2(a.a_ray.r_dir, point, eye_model);
-	    VUNITIZE(a.a_ray.r_dir);
-	    VMOVE(a.a_ray.r_pt, eye_model);
-	    if (a.a_rt_i->rti_prismtrace) {
-		VSUB2(pe.corner[0].r_dir, pe.corner[0].r_pt, eye_model);
-		VSUB2(pe.corner[1].r_dir, pe.corner[1].r_pt, eye_model);
-		VSUB2(pe.corner[2].r_dir, pe.corner[2].r_pt, eye_model);
-		VSUB2(pe.corner[3].r_dir, pe.corner[3].r_pt, eye_model);
-	    }
+	    VSUB2(a->a_ray.r_dir, stereo_point, eye_model);
+	    VUNITIZE(a->a_ray.r_dir);
+	    VADD2(a->a_ray.r_pt, eye_model, left_eye_delta);
 	} else {
-	    VMOVE(a.a_ray.r_pt, point);
-	    VMOVE(a.a_ray.r_dir, APP.a_ray.r_dir);
-
-	    if (a.a_rt_i->rti_prismtrace) {
-		VMOVE(pe.corner[0].r_dir, a.a_ray.r_dir);
-		VMOVE(pe.corner[1].r_dir, a.a_ray.r_dir);
-		VMOVE(pe.corner[2].r_dir, a.a_ray.r_dir);
-		VMOVE(pe.corner[3].r_dir, a.a_ray.r_dir);
-	    }
-	}
-	if (report_progress) {
-	    report_progress = 0;
-	    bu_log("\tframe %d, xy=%d, %d on cpu %d, samp=%d\n", curframe, a.a_x, a.a_y, cpu, samplenum);
+	    VMOVE(a->a_ray.r_pt, stereo_point);
 	}
+	a->a_level = 0;		/* recursion level */
+	a->a_purpose = "left eye ray";
+	(void)rt_shootray(a);
 
-	a.a_level = 0;		/* recursion level */
-	a.a_purpose = "main ray";
-	(void)rt_shootray(&a);
+	left = CRT_BLEND(a->a_color);
+	VSET(a->a_color, left, 0, right);
+    }
+}
 
-	if (stereo) {
-	    fastf_t right, left;
-	    vect_t temp;
 
-	    right = CRT_BLEND(a.a_color);
+/**
+ * The number of samples of a pixel shot before adaptive sampling
+ * decides whether it needs the rest, and the stride through the
+ * samples that spreads any leading run of them across the pixel.
+ * Over pt_pats' square patterns the first ones run down the diagonal.
+ */
+static int
+adapt_order(int nsamples, int *nbase)
+{
+    int k = (int)(sqrt((double)nsamples) + 0.5);
+    int stride = k + 1;
+    int d;
+
+    for (d = 2; d <= stride; d++) {
+	if (stride % d == 0 && nsamples % d == 0) {
+	    stride++;
+	    d = 1;
+	}
+    }
 
-	    /* Move left 2.5 inches (63.5mm) */
-	    VSET(temp, -63.5*2.0/viewsize, 0, 0);
-	    MAT4X3VEC(left_eye_delta, view2model, temp);
+    if (k < 2)
+	k = 2;
+    if (k > nsamples)
+	k = nsamples;
+    *nbase = k;
+    return stride;
+}
 
-	    VSUB2(stereo_point, point, left_eye_delta);
-	    if (rt_perspective > 0.0) {
-		VSUB2(a.a_ray.r_dir, stereo_point, eye_model);
-		VUNITIZE(a.a_ray.r_dir);
-		VADD2(a.a_ray.r_pt, eye_model, left_eye_delta);
-	    } else {
-		VMOVE(a.a_ray.r_pt, stereo_point);
-	    }
-	    a.a_level = 0;		/* recursion level */
-	    a.a_purpose = "left eye ray";
-	    (void)rt_shootray(&a);
 
-	    left = CRT_BLEND(a.a_color);
-	    VSET(a.a_color, left, 0, right);
+/**
+ * Add the sample just shot in a to the tally of its pixel.  The view
+ * module leaves the region hit in a_uptr and, if it has one, the
+ * surface normal in a_vvec.
+ */
+static void
+adapt_add(struct adapt_pixel *px, const struct application *a)
+{
+    if (px->n == 0) {
+	px->region = a->a_uptr;
+	VMOVE(px->normal, a->a_vvec);
+    } else if (!px->edge) {
+	if (a->a_uptr != px->region) {
+	    px->edge = ADAPT_REGION;
+	} else if (!ZERO(MAGSQ(px->normal)) && !ZERO(MAGSQ(a->a_vvec))
+		   && VDOT(px->normal, a->a_vvec) < ADAPT_NORMAL_COS) {
+	    px->edge = ADAPT_NORMAL;
 	}
-	VADD2(colorsum, colorsum, a.a_color);
+    }
 
-	/**************/
-	/* END UNROLL */
-	/**************/
+    VADD2(px->sum, px->sum, a->a_color);
+    px->sumsq[X] += a->a_color[X] * a->a_color[X];
+    px->sumsq[Y] += a->a_color[Y] * a->a_color[Y];
+    px->sumsq[Z] += a->a_color[Z] * a->a_color[Z];
+    px->n++;
+}
 
-    } else {
-	/* hypersampling, so iterate */
 
-	for (samplenum=0; samplenum<=hypersample; samplenum++) {
-	    /* shoot at a point based on the jitter pattern number */
+/**
+ * Returns 0 if the samples tallied in px are enough for their pixel,
+ * otherwise why it needs the rest.  err is set to the standard error
+ * of the mean of the noisiest color channel.
+ */
+static int
+adapt_check(const struct adapt_pixel *px, double *err)
+{
+    double var = 0.0;
+    int i;
 
-	    /**********************/
-	    /* BEGIN NON-UNROLLED */
-	    /**********************/
+    for (i = 0; i < 3; i++) {
+	double v = (px->sumsq[i] - px->sum[i] * px->sum[i] / px->n) / (px->n - 1);
+	if (v > var)
+	    var = v;
+    }
+    *err = sqrt(var / px->n);
 
-	    if (jitter & JITTER_CELL) {
-		jitter_start_pnt(point, &a, samplenum, pat_num);
-	    }
+    if (px->edge)
+	return px->edge;
+    return (*err > adaptive) ? ADAPT_NOISE : 0;
+}
 
-	    if (a.a_rt_i->rti_prismtrace) {
-		/* compute the four corners */
-		pe.magic = PIXEL_EXT_MAGIC;
-		VJOIN2(pe.corner[0].r_pt, viewbase_model, a.a_x, dx_model, a.a_y, dy_model);
-		VJOIN2(pe.corner[1].r_pt, viewbase_model, (a.a_x+1), dx_model, a.a_y, dy_model);
-		VJOIN2(pe.corner[2].r_pt, viewbase_model, (a.a_x+1), dx_model, (a.a_y+1), dy_model);
-		VJOIN2(pe.corner[3].r_pt, viewbase_model, a.a_x, dx_model, (a.a_y+1), dy_model);
-		a.a_pixelext = &pe;
-	    }
 
-	    if (rt_perspective > 0.0) {
-		VSUB2(a.a_ray.r_dir, point, eye_model);
-		VUNITIZE(a.a_ray.r_dir);
-		VMOVE(a.a_ray.r_pt, eye_model);
-		if (a.a_rt_i->rti_prismtrace) {
-		    VSUB2(pe.corner[0].r_dir, pe.corner[0].r_pt, eye_model);
-		    VSUB2(pe.corner[1].r_dir, pe.corner[1].r_pt, eye_model);
-		    VSUB2(pe.corner[2].r_dir, pe.corner[2].r_pt, eye_model);
-		    VSUB2(pe.corner[3].r_dir, pe.corner[3].r_pt, eye_model);
-		}
-	    } else {
-		VMOVE(a.a_ray.r_pt, point);
-		VMOVE(a.a_ray.r_dir, APP.a_ray.r_dir);
-
-		if (a.a_rt_i->rti_prismtrace) {
-		    VMOVE(pe.corner[0].r_dir, a.a_ray.r_dir);
-		    VMOVE(pe.corner[1].r_dir, a.a_ray.r_dir);
-		    VMOVE(pe.corner[2].r_dir, a.a_ray.r_dir);
-		    VMOVE(pe.corner[3].r_dir, a.a_ray.r_dir);
-		}
-	    }
-	    if (report_progress) {
-		report_progress = 0;
-		bu_log("\tframe %d, xy=%d, %d on cpu %d, samp=%d\n", curframe, a.a_x, a.a_y, cpu, samplenum);
-	    }
+static void
+adapt_count(int cpu, const struct adapt_pixel *px)
+{
+    struct adapt_stats *st = &adapt_stats[cpu];
+    double err;
 
-	    a.a_level = 0;		/* recursion level */
-	    a.a_purpose = "main ray";
-	    (void)rt_shootray(&a);
+    st->pixels++;
+    st->samples += px->n;
+    if (px->why) {
+	st->refined[px->why]++;
+    } else {
+	(void)adapt_check(px, &err);
+	st->err += err;
+	if (err > st->err_max)
+	    st->err_max = err;
+    }
+}
 
-	    if (stereo) {
-		fastf_t right, left;
-		vect_t temp;
 
-		right = CRT_BLEND(a.a_color);
+/**
+ * Log how many samples adaptive sampling spent on the frame just
+ * rendered, and how far the pixels it stopped early had converged,
+ * then clear the totals for the next frame.
+ */
+void
+adaptive_report(int framenumber)
+{
+    struct adapt_stats tot;
+    size_t budget, refined, converged;
+    int i, k;
+
+    memset(&tot, 0, sizeof(tot));
+    for (i = 0; i < MAX_PSW; i++) {
+	tot.pixels += adapt_stats[i].pixels;
+	tot.samples += adapt_stats[i].samples;
+	for (k = 0; k < 4; k++)
+	    tot.refined[k] += adapt_stats[i].refined[k];
+	tot.err += adapt_stats[i].err;
+	if (adapt_stats[i].err_max > tot.err_max)
+	    tot.err_max = adapt_stats[i].err_max;
+    }
+    memset(adapt_stats, 0, sizeof(adapt_stats));
+
+    if (tot.pixels == 0)
+	return;
+
+    budget = tot.pixels * (hypersample + 1);
+    refined = tot.refined[ADAPT_NOISE] + tot.refined[ADAPT_REGION] + tot.refined[ADAPT_NORMAL];
+    converged = tot.pixels - refined;
+
+    bu_log("Frame %2d: %10zu samples of %zu (%.1f%%), %.2f per pixel, adaptive=%g\n",
+	   framenumber, tot.samples, budget, 100.0 * tot.samples / budget,
+	   (double)tot.samples / tot.pixels, adaptive);
+    bu_log("Frame %2d: %10zu pixels refined: %zu noisy, %zu region edges, %zu normal edges\n",
+	   framenumber, refined, tot.refined[ADAPT_NOISE], tot.refined[ADAPT_REGION], tot.refined[ADAPT_NORMAL]);
+    if (converged)
+	bu_log("Frame %2d: %10zu pixels converged, standard error %g mean, %g max\n",
+	       framenumber, converged, tot.err / converged, tot.err_max);
+}
 
-		/* Move left 2.5 inches (63.5mm) */
-		VSET(temp, -63.5*2.0/viewsize, 0, 0);
-		MAT4X3VEC(left_eye_delta, view2model, temp);
 
-		VSUB2(stereo_point, point, left_eye_delta);
-		if (rt_perspective > 0.0) {
-		    VSUB2(a.a_ray.r_dir, stereo_point, eye_model);
-		    VUNITIZE(a.a_ray.r_dir);
-		    VADD2(a.a_ray.r_pt, eye_model, left_eye_delta);
-		} else {
-		    VMOVE(a.a_ray.r_pt, stereo_point);
-		}
-		a.a_level = 0;		/* recursion level */
-		a.a_purpose = "left eye ray";
-		(void)rt_shootray(&a);
+void
+do_pixel(int cpu, int pat_num, int pixelnum)
+{
+    struct application a;
+    struct pixel_ext pe;
+    vect_t point;		/* Ref point on eye or view plane */
+    vect_t colorsum = {(fastf_t)0.0, (fastf_t)0.0, (fastf_t)0.0};
+    int samplenum = 0;
 
-		left = CRT_BLEND(a.a_color);
-		VSET(a.a_color, left, 0, right);
-	    }
-	    VADD2(colorsum, colorsum, a.a_color);
+    if (lightmodel == 8) {
+	/* Add timer here to start pixel-time for heat
+	 * graph, when asked.
+	 */
+	rt_prep_timer();
+    }
+
+    if (!pixel_setup(&a, cpu, pixelnum))
+	return;
+
+    /* our starting point, used for non-jitter */
+    VJOIN2 (point, viewbase_model, a.a_x, dx_model, a.a_y, dy_model);
 
-	    /********************/
-	    /* END NON-UNROLLED */
-	    /********************/
+    /* black or no pixmap, so compute the pixel(s) */
+
+    if (hypersample == 0) {
+	/* not hypersampling, so just do it */
+	shoot_sample(&a, &pe, point, cpu, pat_num, samplenum);
+	VADD2(colorsum, colorsum, a.a_color);
+    } else if (adaptive > 0.0) {
+	/* a few samples, and the rest only if those disagree */
+	struct adapt_pixel px;
+	int nsamples = hypersample + 1;
+	int nbase, stride;
+	double err;
+
+	memset(&px, 0, sizeof(px));
+	stride = adapt_order(nsamples, &nbase);
+	for (samplenum = 0; samplenum < nsamples; samplenum++) {
+	    if (samplenum == nbase && !(px.why = adapt_check(&px, &err)))
+		break;
+	    a.a_uptr = NULL;
+	    VSETALL(a.a_vvec, 0.0);
+	    shoot_sample(&a, &pe, point, cpu, pat_num, (samplenum * stride) % nsamples);
+	    adapt_add(&px, &a);
+	}
+	adapt_count(cpu, &px);
+	VSCALE(a.a_color, px.sum, 1.0 / px.n);
+    } else {
+	/* hypersampling, so iterate */
+
+	for (samplenum=0; samplenum<=hypersample; samplenum++) {
+	    /* shoot at a point based on the jitter pattern number */
+	    shoot_sample(&a, &pe, point, cpu, pat_num, samplenum);
+	    VADD2(colorsum, colorsum, a.a_color);
 	} /* for samplenum <= hypersample */
 
 	{
@@ -425,7 +586,7 @@ do_pixel(int cpu, int pat_num, int pixelnum)
 	    f = 1.0 / (hypersample+1);
 	    VSCALE(a.a_color, colorsum, f);
 	}
-    } /* end unrolling else case */
+    }
 
     /* bu_log("2: [%d, %d] : [%.2f, %.2f, %.2f]\n", pixelnum%width, pixelnum/width, a.a_color[0], a.a_color[1], a.a_color[2]); */
 
@@ -451,6 +612,117 @@ do_pixel(int cpu, int pat_num, int pixelnum)
 }
 
 
+/**
+ * Shoot samples first to last, in stride order, of a's pixel into
+ * that pixel's run of samples, each one first handed to view_defer()
+ * so the view module may put off shading its primary hit.
+ */
+static void
+tile_shoot(int cpu, int pat_num, const struct application *a, struct application *samples, int first, int last, int stride)
+{
+    struct pixel_ext pe;
+    vect_t point;
+    int nsamples = hypersample + 1;
+    int j;
+
+    VJOIN2 (point, viewbase_model, a->a_x, dx_model, a->a_y, dy_model);
+    for (j = first; j < last; j++) {
+	int samplenum = (j * stride) % nsamples;
+	struct application *ap = &samples[samplenum];
+
+	*ap = *a;			/* struct copy */
+	ap->a_uptr = NULL;
+	VSETALL(ap->a_vvec, 0.0);
+	(*view_defer)(cpu, ap);
+	shoot_sample(ap, &pe, point, cpu, pat_num, samplenum);
+    }
+}
+
+
+/**
+ * Compute the npixels pixels in pixels[] with deferred shading.  Every
+ * sample of every pixel is shot, then view_defer() shades the lot and
+ * the pixels are output in order.  samples holds room for
+ * (hypersample + 1) * npixels applications.
+ *
+ * With adaptive sampling, adapt holds a tally for each pixel.  Only
+ * the first few samples of each pixel are shot and shaded at first,
+ * then the rest of those of the pixels that need them.
+ */
+static void
+do_tile(int cpu, int pat_num, int *pixels, int npixels, struct application *samples, struct adapt_pixel *adapt)
+{
+    int nsamples = hypersample + 1;
+    int nbase = nsamples;
+    int stride = 1;
+    int more = 0;
+    int i, j;
+
+    if (adapt)
+	stride = adapt_order(nsamples, &nbase);
+
+    for (i = 0; i < npixels; i++) {
+	struct application a;
+
+	if (!pixel_setup(&a, cpu, pixels[i])) {
+	    pixels[i] = -1;
+	    continue;
+	}
+	tile_shoot(cpu, pat_num, &a, &samples[i * nsamples], 0, nbase, stride);
+    }
+
+    /* shade whatever was deferred */
+    (*view_defer)(cpu, NULL);
+
+    for (i = 0; adapt && i < npixels; i++) {
+	double err;
+
+	if (pixels[i] < 0)
+	    continue;
+
+	memset(&adapt[i], 0, sizeof(struct adapt_pixel));
+	for (j = 0; j < nbase; j++)
+	    adapt_add(&adapt[i], &samples[i * nsamples + (j * stride) % nsamples]);
+	adapt[i].why = adapt_check(&adapt[i], &err);
+	if (nbase < nsamples && adapt[i].why) {
+	    struct application a = samples[i * nsamples];	/* struct copy */
+	    tile_shoot(cpu, pat_num, &a, &samples[i * nsamples], nbase, nsamples, stride);
+	    more = 1;
+	} else {
+	    adapt[i].why = 0;
+	}
+    }
+
+    if (more)
+	(*view_defer)(cpu, NULL);
+
+    for (i = 0; i < npixels; i++) {
+	struct application *ap = &samples[(i + 1) * nsamples - 1];
+	vect_t colorsum = VINIT_ZERO;
+
+	if (pixels[i] < 0)
+	    continue;
+
+	if (adapt) {
+	    for (j = nbase; adapt[i].why && j < nsamples; j++)
+		adapt_add(&adapt[i], &samples[i * nsamples + (j * stride) % nsamples]);
+	    adapt_count(cpu, &adapt[i]);
+	    ap = &samples[i * nsamples];
+	    VSCALE(ap->a_color, adapt[i].sum, 1.0 / adapt[i].n);
+	} else if (hypersample) {
+	    for (j = 0; j < nsamples; j++)
+		VADD2(colorsum, colorsum, samples[i * nsamples + j].a_color);
+	    VSCALE(ap->a_color, colorsum, 1.0 / nsamples);
+	}
+
+	view_pixel(ap);
+	if ((size_t)ap->a_x == width-1) {
+	    view_eol(ap);		/* End of scan line */
+	}
+    }
+}
+
+
 /**
  * Compute some pixels, and store them.
  *
@@ -551,10 +823,28 @@ pat_found:
     } else {
 	int from;
 	int to;
+	int *tile = NULL;
+	int ntile = 0;
+	int maxtile = 0;
+	struct application *samples = NULL;
+	struct adapt_pixel *adapt = NULL;
+
+	/* the view module shades in batches unless each pixel needs its
+	 * own results before the next is shot */
+	if (view_defer && !stereo && !APP.a_rt_i->rti_prismtrace
+	    && !Query_one_pixel && lightmodel != 8) {
+	    maxtile = DEFER_SAMPLES / (hypersample + 1);
+	    if (maxtile < 1)
+		maxtile = 1;
+	    tile = (int *)bu_malloc(maxtile * sizeof(int), "deferred pixels");
+	    samples = (struct application *)bu_malloc(maxtile * (hypersample + 1) * sizeof(struct application), "deferred samples");
+	    if (hypersample && adaptive > 0.0)
+		adapt = (struct adapt_pixel *)bu_malloc(maxtile * sizeof(struct adapt_pixel), "adaptive pixels");
+	}
 
 	while (1) {
 	    if (stop_worker)
-		return;
+		break;
 
 	    bu_semaphore_acquire(RT_SEM_WORKER);
 	    pixel_start = cur_pixel;
@@ -572,11 +862,32 @@ pat_found:
 	    /* bu_log("SPAN[%d -> %d] for %d pixels\n", pixel_start, pixel_start+per_processor_chunk, per_processor_chunk); */
 	    for (pixelnum = from; pixelnum != to; (from < to) ? pixelnum++ : pixelnum--) {
 		if (pixelnum > last_pixel || pixelnum < 0)
-		    return;
+		    break;
 
 		/* bu_log("    PIXEL[%d]\n", pixelnum); */
-		do_pixel(cpu, pat_num, pixelnum);
+		if (!tile) {
+		    do_pixel(cpu, pat_num, pixelnum);
+		    continue;
+		}
+		tile[ntile++] = pixelnum;
+		if (ntile == maxtile) {
+		    do_tile(cpu, pat_num, tile, ntile, samples, adapt);
+		    ntile = 0;
+		}
+	    }
+	    if (ntile) {
+		do_tile(cpu, pat_num, tile, ntile, samples, adapt);
+		ntile = 0;
 	    }
+	    if (pixelnum != to)
+		break;
+	}
+
+	if (tile) {
+	    if (adapt)
+		bu_free(adapt, "adaptive pixels");
+	    bu_free(samples, "deferred samples");
+	    bu_free(tile, "deferred pixels");
 	}
     }
 }
@@ -82,6 +82,21 @@ xform(point_t t, point_t pt)
 }
 
 
+/* the noise space points of row y, packed for the batch noise functions */
+static void
+xform_row(fastf_t *row, size_t y)
+{
+    point_t pt;
+    size_t x;
+
+    VSET(pt, 0.0, y, 0.0);
+    for (x = 0; x < xdim; x++) {
+	pt[X] = x;
+	xform(&row[3*x], pt);
+    }
+}
+
+
 /*
  * Tell user how to invoke this program, then exit
  */
@@ -115,21 +130,18 @@ usage(char *s)
 void
 func_fbm(unsigned short *buf)
 {
-    point_t pt;
+    fastf_t *row = (fastf_t *)bu_malloc(xdim * 3 * sizeof(fastf_t), "noise row");
+    double *vals = (double *)bu_malloc(xdim * sizeof(double), "noise values");
     size_t x, y;
-    vect_t t;
     double v;
 
     if (debug) bu_log("fbm\n");
 
-    pt[Z] = 0.0;
     for (y = 0; y < ydim; y++) {
-	pt[Y] = y;
+	xform_row(row, y);
+	bn_noise_fbm_n(vals, row, xdim, fbm_h, fbm_lacunarity, fbm_octaves);
 	for (x = 0; x < xdim; x++) {
-	    pt[X] = x;
-
-	    xform(t, pt);
-	    v = bn_noise_fbm(t, fbm_h, fbm_lacunarity, fbm_octaves);
+	    v = vals[x];
 	    if (v > 1.0 || v < -1.0)
 		if (debug) bu_log("clamping noise value %g \n", v);
 	    v = v * 0.5 + 0.5;
@@ -138,6 +150,9 @@ func_fbm(unsigned short *buf)
 	    buf[y*xdim + x] = 1.0 + 65534.0 * v;
 	}
     }
+
+    bu_free(vals, "noise values");
+    bu_free(row, "noise row");
 }
 
 
@@ -147,23 +162,18 @@ func_fbm(unsigned short *buf)
 void
 func_turb(unsigned short *buf)
 {
-    point_t pt;
+    fastf_t *row = (fastf_t *)bu_malloc(xdim * 3 * sizeof(fastf_t), "noise row");
+    double *vals = (double *)bu_malloc(xdim * sizeof(double), "noise values");
     size_t x, y;
-    vect_t t;
     double v;
 
     if (debug) bu_log("turb\n");
 
-    pt[Z] = 0.0;
     for (y = 0; y < ydim; y++) {
-	pt[Y] = y;
+	xform_row(row, y);
+	bn_noise_turb_n(vals, row, xdim, fbm_h, fbm_lacunarity, fbm_octaves);
 	for (x = 0; x < xdim; x++) {
-	    pt[X] = x;
-
-	    xform(t, pt);
-
-	    v = bn_noise_turb(t, fbm_h,
-			      fbm_lacunarity, fbm_octaves);
+	    v = vals[x];
 
 	    if (v > 1.0 || v < 0.0)
 		if (debug) bu_log("clamping noise value %g \n", v);
@@ -171,6 +181,9 @@ func_turb(unsigned short *buf)
 	    buf[y*xdim + x] = 1.0 + 65534.0 * v;
 	}
     }
+
+    bu_free(vals, "noise values");
+    bu_free(row, "noise row");
 }
 
 
@@ -180,23 +193,18 @@ func_turb(unsigned short *buf)
 void
 func_turb_up(unsigned short *buf)
 {
-    point_t pt;
+    fastf_t *row = (fastf_t *)bu_malloc(xdim * 3 * sizeof(fastf_t), "noise row");
+    double *vals = (double *)bu_malloc(xdim * sizeof(double), "noise values");
     size_t x, y;
-    vect_t t;
     double v;
 
     if (debug) bu_log("1.0 - turb\n");
 
-    pt[Z] = 0.0;
     for (y = 0; y < ydim; y++) {
-	pt[Y] = y;
+	xform_row(row, y);
+	bn_noise_turb_n(vals, row, xdim, fbm_h, fbm_lacunarity, fbm_octaves);
 	for (x = 0; x < xdim; x++) {
-	    pt[X] = x;
-
-	    xform(t, pt);
-
-	    v = bn_noise_turb(t, fbm_h,
-			      fbm_lacunarity, fbm_octaves);
+	    v = vals[x];
 	    CLAMP(v, 0.0, 1.0);
 	    v = 1.0 - v;
 
@@ -205,6 +213,9 @@ func_turb_up(unsigned short *buf)
 	    buf[y*xdim + x] = 1 + 65535.0 * v;
 	}
     }
+
+    bu_free(vals, "noise values");
+    bu_free(row, "noise row");
 }
 
 
@@ -214,9 +225,9 @@ func_turb_up(unsigned short *buf)
 void
 func_multi(unsigned short *buf)
 {
-    point_t pt;
+    fastf_t *row = (fastf_t *)bu_malloc(xdim * 3 * sizeof(fastf_t), "noise row");
+    double *vals = (double *)bu_malloc(xdim * sizeof(double), "noise values");
     size_t x, y;
-    vect_t t;
     double v;
     double min_V, max_V;
 
@@ -225,17 +236,11 @@ func_multi(unsigned short *buf)
     min_V = 10.0;
     max_V = -10.0;
 
-    pt[Z] = 0.0;
     for (y = 0; y < ydim; y++) {
-	pt[Y] = y;
+	xform_row(row, y);
+	bn_noise_mf_n(vals, row, xdim, fbm_h, fbm_lacunarity, fbm_octaves, fbm_offset);
 	for (x = 0; x < xdim; x++) {
-	    pt[X] = x;
-
-	    xform(t, pt);
-
-	    v = bn_noise_mf(t, fbm_h,
-			    fbm_lacunarity, fbm_octaves,
-			    fbm_offset);
+	    v = vals[x];
 
 	    v -= .3;
 	    v *= 0.8;
@@ -251,6 +256,8 @@ func_multi(unsigned short *buf)
     }
     if (debug) bu_log("min_V: %g   max_V: %g\n", min_V, max_V);
 
+    bu_free(vals, "noise values");
+    bu_free(row, "noise row");
 }
 
 
@@ -260,9 +267,9 @@ func_multi(unsigned short *buf)
 void
 func_ridged(unsigned short *buf)
 {
-    point_t pt;
+    fastf_t *row = (fastf_t *)bu_malloc(xdim * 3 * sizeof(fastf_t), "noise row");
+    double *vals = (double *)bu_malloc(xdim * sizeof(double), "noise values");
     size_t x, y;
-    vect_t t;
     double v;
     double lo, hi;
 
@@ -271,17 +278,11 @@ func_ridged(unsigned short *buf)
     lo = 10.0;
     hi = -10.0;
 
-    pt[Z] = 0.0;
     for (y = 0; y < ydim; y++) {
-	pt[Y] = y;
+	xform_row(row, y);
+	bn_noise_ridged_n(vals, row, xdim, fbm_h, fbm_lacunarity, fbm_octaves, fbm_offset);
 	for (x = 0; x < xdim; x++) {
-	    pt[X] = x;
-
-	    xform(t, pt);
-
-	    v = bn_noise_ridged(t, fbm_h,
-				fbm_lacunarity, fbm_octaves,
-				fbm_offset);
+	    v = vals[x];
 	    if (v < lo) lo = v;
 	    if (v > hi) hi = v;
 	    v *= 0.5;
@@ -292,6 +293,9 @@ func_ridged(unsigned short *buf)
 	    buf[y*xdim + x] = 1.0 + 65534.0 * v;
 	}
     }
+
+    bu_free(vals, "noise values");
+    bu_free(row, "noise row");
 }
 
 